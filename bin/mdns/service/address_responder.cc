@@ -18,6 +18,7 @@ void AddressResponder::Start(const std::string& host_full_name) {
   FXL_DCHECK(!host_full_name.empty());
 
   host_full_name_ = host_full_name;
+  SubscribeToName(host_full_name_);
 }
 
 void AddressResponder::ReceiveQuestion(const DnsQuestion& question,
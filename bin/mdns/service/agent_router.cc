@@ -0,0 +1,148 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/bin/mdns/service/agent_router.h"
+
+#include "garnet/bin/mdns/service/dns_reading.h"
+#include "garnet/bin/mdns/service/mdns_names.h"
+#include "lib/fxl/logging.h"
+
+namespace mdns {
+
+AgentRouter::AgentRouter() {}
+
+AgentRouter::~AgentRouter() {}
+
+void AgentRouter::AddAgent(MdnsAgent* agent) {
+  FXL_DCHECK(agent);
+  unsubscribed_agents_.insert(agent);
+}
+
+void AgentRouter::RemoveAgent(const MdnsAgent* agent) {
+  FXL_DCHECK(agent);
+  MdnsAgent* mutable_agent = const_cast<MdnsAgent*>(agent);
+  unsubscribed_agents_.erase(mutable_agent);
+
+  auto iter = keys_by_agent_.find(agent);
+  if (iter == keys_by_agent_.end()) {
+    return;
+  }
+
+  for (const Key& key : iter->second) {
+    auto subscriptions_iter = subscriptions_by_key_.find(key);
+    FXL_DCHECK(subscriptions_iter != subscriptions_by_key_.end());
+    subscriptions_iter->second.erase(mutable_agent);
+    if (subscriptions_iter->second.empty()) {
+      subscriptions_by_key_.erase(subscriptions_iter);
+    }
+  }
+
+  keys_by_agent_.erase(iter);
+}
+
+void AgentRouter::Subscribe(MdnsAgent* agent, const DnsName& name) {
+  FXL_DCHECK(agent);
+  FXL_DCHECK(name.key());
+
+  unsubscribed_agents_.erase(agent);
+  ++subscriptions_by_key_[name.key()][agent];
+  keys_by_agent_[agent].insert(name.key());
+}
+
+void AgentRouter::Unsubscribe(MdnsAgent* agent, const DnsName& name) {
+  FXL_DCHECK(agent);
+
+  auto iter = subscriptions_by_key_.find(name.key());
+  if (iter == subscriptions_by_key_.end()) {
+    return;
+  }
+
+  auto agent_iter = iter->second.find(agent);
+  if (agent_iter == iter->second.end()) {
+    return;
+  }
+
+  if (--agent_iter->second != 0) {
+    return;
+  }
+
+  iter->second.erase(agent_iter);
+  if (iter->second.empty()) {
+    subscriptions_by_key_.erase(iter);
+  }
+
+  // The agent keeps receiving only the names it's subscribed to, even if it
+  // has just unsubscribed from the last one.
+  auto keys_iter = keys_by_agent_.find(agent);
+  FXL_DCHECK(keys_iter != keys_by_agent_.end());
+  keys_iter->second.erase(name.key());
+}
+
+std::vector<MdnsAgent*> AgentRouter::AgentsForName(const DnsName& name) const {
+  std::vector<MdnsAgent*> agents(unsubscribed_agents_.begin(),
+                                 unsubscribed_agents_.end());
+  if (!name.key()) {
+    return agents;
+  }
+
+  // Subscribed agents are never in |unsubscribed_agents_|, so only the
+  // subscribers of the name and of its service may overlap.
+  const Subscriptions* name_subscriptions = nullptr;
+  auto iter = subscriptions_by_key_.find(name.key());
+  if (iter != subscriptions_by_key_.end()) {
+    name_subscriptions = &iter->second;
+    for (auto& pair : *name_subscriptions) {
+      agents.push_back(pair.first);
+    }
+  }
+
+  // Subtype names are also distributed to the subscribers of the service.
+  // Only names that some |DnsName| holds can have subscribers, so the
+  // service's key is looked up without constructing a |DnsName|.
+  std::string service_full_name =
+      MdnsNames::SubtypeServiceFullName(*name.key());
+  if (service_full_name.empty()) {
+    return agents;
+  }
+
+  Key service_key = DnsName::FindKey(service_full_name);
+  if (!service_key) {
+    return agents;
+  }
+
+  iter = subscriptions_by_key_.find(service_key);
+  if (iter == subscriptions_by_key_.end()) {
+    return agents;
+  }
+
+  for (auto& pair : iter->second) {
+    if (!name_subscriptions ||
+        name_subscriptions->find(pair.first) == name_subscriptions->end()) {
+      agents.push_back(pair.first);
+    }
+  }
+
+  return agents;
+}
+
+bool AgentRouter::IsNameOfInterest(const DnsMessageView& message,
+                                   size_t position) {
+  // Agents that never subscribed to a name receive everything.
+  if (has_unsubscribed_agents()) {
+    return true;
+  }
+
+  message.GetName(position, &inbound_name_);
+
+  // Names are subscribed to and renewed using |DnsName|s, so a name no
+  // |DnsName| holds is of no interest.
+  if (DnsName::FindKey(inbound_name_)) {
+    return true;
+  }
+
+  // Subtype names are distributed to the agents subscribed to the service.
+  return !MdnsNames::SubtypeServiceFullName(inbound_name_).empty();
+}
+
+}  // namespace mdns
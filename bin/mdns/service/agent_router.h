@@ -0,0 +1,80 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GARNET_BIN_MDNS_SERVICE_AGENT_ROUTER_H_
+#define GARNET_BIN_MDNS_SERVICE_AGENT_ROUTER_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "garnet/bin/mdns/service/dns_message.h"
+#include "lib/fxl/macros.h"
+
+namespace mdns {
+
+class DnsMessageView;
+class MdnsAgent;
+
+// Determines which agents receive the questions and resources with a given
+// name. See |MdnsAgent::SubscribeToName|.
+class AgentRouter {
+ public:
+  AgentRouter();
+
+  ~AgentRouter();
+
+  // Adds an agent, which receives everything until it subscribes to a name.
+  void AddAgent(MdnsAgent* agent);
+
+  // Removes an agent and all of its subscriptions.
+  void RemoveAgent(const MdnsAgent* agent);
+
+  // Directs questions and resources named |name| to |agent|.
+  void Subscribe(MdnsAgent* agent, const DnsName& name);
+
+  // Reverts one call to |Subscribe| with the same arguments.
+  void Unsubscribe(MdnsAgent* agent, const DnsName& name);
+
+  // Returns the agents to which questions and resources named |name| are
+  // distributed, each of them once. The result is a copy, because agents may
+  // subscribe or unsubscribe while receiving questions or resources.
+  std::vector<MdnsAgent*> AgentsForName(const DnsName& name) const;
+
+  // Indicates whether any agent receives everything.
+  bool has_unsubscribed_agents() const {
+    return !unsubscribed_agents_.empty();
+  }
+
+  // Determines whether the question or resource at |position| in |message|
+  // may be of interest to the resource renewer or any agent. Questions and
+  // resources that aren't needn't be decoded.
+  bool IsNameOfInterest(const DnsMessageView& message, size_t position);
+
+ private:
+  using Key = std::shared_ptr<const std::string>;
+
+  // Subscription counts of the agents subscribed to one name.
+  using Subscriptions = std::unordered_map<MdnsAgent*, size_t>;
+
+  // Subscriptions by the interned key of the name they're subscribed to.
+  std::unordered_map<Key, Subscriptions> subscriptions_by_key_;
+  // Keys of the names each subscribed agent is subscribed to.
+  std::unordered_map<const MdnsAgent*, std::unordered_set<Key>>
+      keys_by_agent_;
+  // Agents which never subscribed to a name and therefore receive all
+  // questions and resources.
+  std::unordered_set<MdnsAgent*> unsubscribed_agents_;
+  // Names of inbound questions and resources are read into this string to
+  // decide whether they're of interest.
+  std::string inbound_name_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(AgentRouter);
+};
+
+}  // namespace mdns
+
+#endif  // GARNET_BIN_MDNS_SERVICE_AGENT_ROUTER_H_
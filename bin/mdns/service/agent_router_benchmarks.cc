@@ -0,0 +1,189 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fbl/string_printf.h>
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+
+#include "garnet/bin/mdns/service/agent_router.h"
+#include "garnet/bin/mdns/service/dns_reading.h"
+#include "garnet/bin/mdns/service/dns_writing.h"
+#include "garnet/bin/mdns/service/mdns_agent.h"
+#include "garnet/bin/mdns/service/packet_writer.h"
+
+namespace mdns {
+namespace {
+
+// Responses received per run, as many as a busy network carries in a few
+// minutes. Every response announces one service instance.
+constexpr size_t kResponseCount = 3000;
+
+// Services are announced on the network by this many times as many hosts as
+// there are agents on this one, so most responses are of interest to nobody.
+constexpr size_t kServicesPerAgent = 4;
+
+class FakeHost : public MdnsAgent::Host {
+ public:
+  void PostTaskForTime(MdnsAgent* agent, fit::closure task,
+                       fxl::TimePoint target_time) override {}
+  void SendQuestion(std::shared_ptr<DnsQuestion> question) override {}
+  void SendResource(std::shared_ptr<DnsResource> resource,
+                    MdnsResourceSection section,
+                    const ReplyAddress& reply_address) override {}
+  void SendAddresses(MdnsResourceSection section,
+                     const ReplyAddress& reply_address) override {}
+  void Renew(const DnsResource& resource) override {}
+  void SubscribeToName(MdnsAgent* agent, const DnsName& name) override {}
+  void UnsubscribeFromName(MdnsAgent* agent, const DnsName& name) override {}
+  void RemoveAgent(const MdnsAgent* agent,
+                   const std::string& published_instance_full_name) override {}
+};
+
+// Counts the resources it receives, as a stand-in for an instance requestor.
+class CountingAgent : public MdnsAgent {
+ public:
+  explicit CountingAgent(Host* host) : MdnsAgent(host) {}
+
+  void ReceiveResource(const DnsResource& resource,
+                       MdnsResourceSection section) override {
+    ++resource_count_;
+  }
+
+  size_t resource_count() const { return resource_count_; }
+
+ private:
+  size_t resource_count_ = 0;
+};
+
+std::string ServiceName(size_t index) {
+  return fbl::StringPrintf("_service%zu._tcp.local.", index).c_str();
+}
+
+// Writes a response announcing instance |index| of service |service| the way
+// a responder does: a PTR answer and SRV, TXT and A additionals. Every other
+// response also carries a PTR for a subtype of the service.
+std::vector<uint8_t> WriteResponse(size_t index, size_t service) {
+  std::string service_name = ServiceName(service);
+  std::string instance_name =
+      fbl::StringPrintf("instance%zu.", index).c_str() + service_name;
+  std::string host_name = fbl::StringPrintf("host%zu.local.", index).c_str();
+
+  DnsMessage message;
+  message.header_.SetResponse(true);
+  message.header_.SetAuthoritativeAnswer(true);
+
+  auto ptr = std::make_shared<DnsResource>(service_name, DnsType::kPtr);
+  ptr->ptr_.pointer_domain_name_ = DnsName(instance_name);
+  message.answers_.push_back(ptr);
+
+  if (index % 2 == 0) {
+    auto subtype_ptr = std::make_shared<DnsResource>(
+        "_printer._sub." + service_name, DnsType::kPtr);
+    subtype_ptr->ptr_.pointer_domain_name_ = DnsName(instance_name);
+    message.answers_.push_back(subtype_ptr);
+  }
+
+  auto srv = std::make_shared<DnsResource>(instance_name, DnsType::kSrv);
+  srv->srv_.port_ = inet::IpPort::From_uint16_t(8000);
+  srv->srv_.target_ = DnsName(host_name);
+  message.additionals_.push_back(srv);
+
+  auto txt = std::make_shared<DnsResource>(instance_name, DnsType::kTxt);
+  txt->txt_.strings_.push_back("version=1");
+  message.additionals_.push_back(txt);
+
+  auto a = std::make_shared<DnsResource>(host_name, DnsType::kA);
+  a->a_.address_.address_ =
+      inet::IpAddress(192, 168, static_cast<uint8_t>(index / 256),
+                      static_cast<uint8_t>(index));
+  message.additionals_.push_back(a);
+
+  message.UpdateCounts();
+
+  PacketWriter writer;
+  writer << message;
+  return writer.GetResizedPacket();
+}
+
+// Delivers the resources at |positions| in |message| that may be of interest
+// to the agents |router| names for them, as |Mdns| does.
+size_t ReceiveResources(AgentRouter* router, const DnsMessageView& message,
+                        const std::vector<size_t>& positions,
+                        MdnsResourceSection section) {
+  size_t decoded = 0;
+  for (size_t position : positions) {
+    if (!router->IsNameOfInterest(message, position)) {
+      continue;
+    }
+
+    std::shared_ptr<DnsResource> resource = message.DecodeResource(position);
+    ++decoded;
+    for (MdnsAgent* agent : router->AgentsForName(resource->name_)) {
+      agent->ReceiveResource(*resource, section);
+    }
+  }
+  return decoded;
+}
+
+// Measures the time taken to parse |kResponseCount| responses and to decode
+// and deliver the resources of interest to |agent_count| agents, each of them
+// subscribed to one service. Only the names the agents subscribe to are
+// interned, so the resources of other services, instances and hosts are
+// skipped without being decoded.
+bool ReceiveResponsesTest(perftest::RepeatState* state, size_t agent_count) {
+  FakeHost host;
+  AgentRouter router;
+  std::vector<std::unique_ptr<CountingAgent>> agents;
+  std::vector<DnsName> service_names;
+  for (size_t i = 0; i < agent_count; ++i) {
+    agents.push_back(std::make_unique<CountingAgent>(&host));
+    service_names.emplace_back(ServiceName(i));
+    router.AddAgent(agents.back().get());
+    router.Subscribe(agents.back().get(), service_names.back());
+  }
+
+  std::vector<std::vector<uint8_t>> responses;
+  for (size_t i = 0; i < kResponseCount; ++i) {
+    responses.push_back(
+        WriteResponse(i, i % (agent_count * kServicesPerAgent)));
+  }
+
+  DnsMessageView message;
+  while (state->KeepRunning()) {
+    size_t decoded = 0;
+    for (auto& response : responses) {
+      ZX_ASSERT(message.Parse(response.data(), response.size()));
+      decoded += ReceiveResources(&router, message, message.answers(),
+                                  MdnsResourceSection::kAnswer);
+      decoded += ReceiveResources(&router, message, message.additionals(),
+                                  MdnsResourceSection::kAdditional);
+    }
+    // Only PTRs are decoded: those of subscribed services, and those of
+    // subtypes, which can't be ruled out without decoding them.
+    ZX_ASSERT(decoded > 0 && decoded < kResponseCount * 2);
+  }
+
+  ZX_ASSERT(agents.front()->resource_count() > 0);
+  return true;
+}
+
+void RegisterTests() {
+  for (size_t agent_count : {100, 500}) {
+    auto name = fbl::StringPrintf("Mdns/AgentRouter/ReceiveResponses/%zuagents",
+                                  agent_count);
+    perftest::RegisterTest(name.c_str(), ReceiveResponsesTest, agent_count);
+  }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
+}  // namespace mdns
+
+int main(int argc, char** argv) {
+  return perftest::PerfTestMain(argc, argv, "fuchsia.mdns_benchmarks");
+}
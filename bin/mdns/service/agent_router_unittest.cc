@@ -0,0 +1,157 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/bin/mdns/service/agent_router.h"
+
+#include <algorithm>
+
+#include "garnet/bin/mdns/service/mdns_agent.h"
+#include "gtest/gtest.h"
+
+namespace mdns {
+namespace {
+
+class FakeHost : public MdnsAgent::Host {
+ public:
+  void PostTaskForTime(MdnsAgent* agent, fit::closure task,
+                       fxl::TimePoint target_time) override {}
+  void SendQuestion(std::shared_ptr<DnsQuestion> question) override {}
+  void SendResource(std::shared_ptr<DnsResource> resource,
+                    MdnsResourceSection section,
+                    const ReplyAddress& reply_address) override {}
+  void SendAddresses(MdnsResourceSection section,
+                     const ReplyAddress& reply_address) override {}
+  void Renew(const DnsResource& resource) override {}
+  void SubscribeToName(MdnsAgent* agent, const DnsName& name) override {}
+  void UnsubscribeFromName(MdnsAgent* agent, const DnsName& name) override {}
+  void RemoveAgent(const MdnsAgent* agent,
+                   const std::string& published_instance_full_name) override {}
+};
+
+class FakeAgent : public MdnsAgent {
+ public:
+  explicit FakeAgent(Host* host) : MdnsAgent(host) {}
+};
+
+class AgentRouterTest : public ::testing::Test {
+ protected:
+  // Returns the number of times |agent| appears in |agents|.
+  static size_t Count(const std::vector<MdnsAgent*>& agents,
+                      const MdnsAgent& agent) {
+    return std::count(agents.begin(), agents.end(), &agent);
+  }
+
+  FakeHost host_;
+  FakeAgent a_{&host_};
+  FakeAgent b_{&host_};
+  FakeAgent c_{&host_};
+  AgentRouter router_;
+};
+
+// Tests that agents receive everything until they subscribe to a name, and
+// only the names they're subscribed to after that.
+TEST_F(AgentRouterTest, SubscribedAgentsOnlyReceiveTheirNames) {
+  DnsName host_name("host.local.");
+  DnsName other_name("other.local.");
+
+  router_.AddAgent(&a_);
+  router_.AddAgent(&b_);
+  EXPECT_TRUE(router_.has_unsubscribed_agents());
+
+  router_.Subscribe(&a_, host_name);
+  EXPECT_TRUE(router_.has_unsubscribed_agents());
+
+  auto agents = router_.AgentsForName(DnsName("HOST.local."));
+  EXPECT_EQ(2u, agents.size());
+  EXPECT_EQ(1u, Count(agents, a_));
+  EXPECT_EQ(1u, Count(agents, b_));
+
+  agents = router_.AgentsForName(other_name);
+  EXPECT_EQ(1u, agents.size());
+  EXPECT_EQ(1u, Count(agents, b_));
+
+  router_.Subscribe(&b_, other_name);
+  EXPECT_FALSE(router_.has_unsubscribed_agents());
+
+  agents = router_.AgentsForName(host_name);
+  EXPECT_EQ(1u, agents.size());
+  EXPECT_EQ(1u, Count(agents, a_));
+
+  EXPECT_TRUE(router_.AgentsForName(DnsName("nobody.local.")).empty());
+  EXPECT_TRUE(router_.AgentsForName(DnsName()).empty());
+}
+
+// Tests that subtype names are distributed to the subscribers of the service
+// as well as to the subscribers of the subtype, each of them once.
+TEST_F(AgentRouterTest, SubtypeNames) {
+  DnsName service_name("_foo._tcp.local.");
+  DnsName subtype_name("_bar._sub._foo._tcp.local.");
+
+  router_.AddAgent(&a_);
+  router_.AddAgent(&b_);
+  router_.AddAgent(&c_);
+  router_.Subscribe(&a_, service_name);
+  router_.Subscribe(&b_, service_name);
+  router_.Subscribe(&b_, subtype_name);
+  router_.Subscribe(&c_, subtype_name);
+
+  auto agents = router_.AgentsForName(subtype_name);
+  EXPECT_EQ(3u, agents.size());
+  EXPECT_EQ(1u, Count(agents, a_));
+  EXPECT_EQ(1u, Count(agents, b_));
+  EXPECT_EQ(1u, Count(agents, c_));
+
+  agents = router_.AgentsForName(service_name);
+  EXPECT_EQ(2u, agents.size());
+  EXPECT_EQ(0u, Count(agents, c_));
+
+  // Subtypes nobody subscribed to still reach the service's subscribers.
+  agents = router_.AgentsForName(DnsName("_baz._sub._foo._tcp.local."));
+  EXPECT_EQ(2u, agents.size());
+  EXPECT_EQ(1u, Count(agents, a_));
+  EXPECT_EQ(1u, Count(agents, b_));
+}
+
+// Tests that subscriptions are counted and that unsubscribing from the last
+// name doesn't make an agent receive everything again.
+TEST_F(AgentRouterTest, Unsubscribe) {
+  DnsName host_name("host.local.");
+
+  router_.AddAgent(&a_);
+  router_.Subscribe(&a_, host_name);
+  router_.Subscribe(&a_, host_name);
+
+  router_.Unsubscribe(&a_, host_name);
+  EXPECT_EQ(1u, router_.AgentsForName(host_name).size());
+
+  router_.Unsubscribe(&a_, host_name);
+  EXPECT_TRUE(router_.AgentsForName(host_name).empty());
+  EXPECT_FALSE(router_.has_unsubscribed_agents());
+
+  // Unsubscribing again is harmless.
+  router_.Unsubscribe(&a_, host_name);
+  EXPECT_TRUE(router_.AgentsForName(host_name).empty());
+}
+
+// Tests that removed agents receive nothing, whether they subscribed or not.
+TEST_F(AgentRouterTest, RemoveAgent) {
+  DnsName host_name("host.local.");
+  DnsName service_name("_foo._tcp.local.");
+
+  router_.AddAgent(&a_);
+  router_.AddAgent(&b_);
+  router_.Subscribe(&a_, host_name);
+  router_.Subscribe(&a_, service_name);
+
+  router_.RemoveAgent(&a_);
+  EXPECT_EQ(1u, router_.AgentsForName(host_name).size());
+  EXPECT_EQ(0u, Count(router_.AgentsForName(service_name), a_));
+
+  router_.RemoveAgent(&b_);
+  EXPECT_FALSE(router_.has_unsubscribed_agents());
+  EXPECT_TRUE(router_.AgentsForName(host_name).empty());
+}
+
+}  // namespace
+}  // namespace mdns
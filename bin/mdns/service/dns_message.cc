@@ -4,7 +4,91 @@
 
 #include "garnet/bin/mdns/service/dns_message.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace mdns {
+namespace {
+
+// The interning table isn't pruned until it reaches this size.
+static constexpr size_t kMinNameTablePruneSize = 256;
+
+// Interned lowercase names. mDNS runs on a single thread, so each thread has
+// its own table.
+using NameTable =
+    std::unordered_map<std::string, std::weak_ptr<const std::string>>;
+
+NameTable& GetNameTable() {
+  thread_local NameTable names;
+  return names;
+}
+
+// Copies |dotted_string| into |lowercase| in lowercase.
+void ToLowercase(const std::string& dotted_string, std::string* lowercase) {
+  lowercase->assign(dotted_string);
+  std::transform(lowercase->begin(), lowercase->end(), lowercase->begin(),
+                 [](char c) {
+                   return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+                 });
+}
+
+// Returns the interned lowercase form of |dotted_string|. Names no longer held
+// by any |DnsName| are pruned whenever the table has doubled in size since
+// the last pruning.
+std::shared_ptr<const std::string> InternName(
+    const std::string& dotted_string) {
+  NameTable& names = GetNameTable();
+  thread_local size_t prune_size = kMinNameTablePruneSize;
+
+  std::string lowercase;
+  ToLowercase(dotted_string, &lowercase);
+
+  std::weak_ptr<const std::string>& entry = names[lowercase];
+  std::shared_ptr<const std::string> key = entry.lock();
+  if (!key) {
+    key = std::make_shared<const std::string>(std::move(lowercase));
+    entry = key;
+  }
+
+  if (names.size() >= prune_size) {
+    for (auto iter = names.begin(); iter != names.end();) {
+      if (iter->second.expired()) {
+        iter = names.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+
+    prune_size = std::max(kMinNameTablePruneSize, 2 * names.size());
+  }
+
+  return key;
+}
+
+}  // namespace
+
+DnsName::DnsName(const std::string& dotted_string)
+    : dotted_string_(dotted_string) {
+  if (!dotted_string_.empty()) {
+    key_ = InternName(dotted_string_);
+  }
+}
+
+// static
+std::shared_ptr<const std::string> DnsName::FindKey(
+    const std::string& dotted_string) {
+  // Retains its storage, so lookups don't allocate.
+  thread_local std::string lowercase;
+  ToLowercase(dotted_string, &lowercase);
+
+  NameTable& names = GetNameTable();
+  auto iter = names.find(lowercase);
+  if (iter == names.end()) {
+    return nullptr;
+  }
+
+  return iter->second.lock();
+}
 
 void DnsHeader::SetResponse(bool value) {
   if (value) {
@@ -102,12 +102,29 @@ struct DnsClassAndFlag {
   bool flag_;
 };
 
-// Domain name.
+// Domain name. |dotted_string_| retains the case in which the name was
+// received or created. Because names compare case-insensitively (RFC 6762
+// section 16), each name also holds an interned lowercase copy of itself,
+// which all equal names share.
 struct DnsName {
   DnsName() {}
-  DnsName(const std::string dotted_string) : dotted_string_(dotted_string) {}
+  DnsName(const std::string& dotted_string);
+
+  // Returns the interned lowercase form of the name. Two names are equal
+  // regardless of case if and only if their keys are the same pointer. The
+  // key of an empty name is null.
+  const std::shared_ptr<const std::string>& key() const { return key_; }
+
+  // Returns the key a |DnsName| constructed from |dotted_string| would have if
+  // any |DnsName| currently holds that key, otherwise null. Unlike
+  // constructing a |DnsName|, this doesn't allocate.
+  static std::shared_ptr<const std::string> FindKey(
+      const std::string& dotted_string);
 
   std::string dotted_string_;
+
+ private:
+  std::shared_ptr<const std::string> key_;
 };
 
 // IPV4 address.
@@ -18,7 +18,7 @@ static constexpr size_t kMaxAnswers = 1024;
 static constexpr size_t kMaxAuthorities = 1024;
 static constexpr size_t kMaxAdditionals = 1024;
 
-void ReadNameLabels(PacketReader& reader, std::vector<char>& chars) {
+void ReadNameLabels(PacketReader& reader, std::string& chars) {
   size_t start_position_of_current_run = reader.bytes_consumed();
   size_t end_position_of_original_run = 0;
 
@@ -33,7 +33,7 @@ void ReadNameLabels(PacketReader& reader, std::vector<char>& chars) {
       reader >> label_size;
       offset |= label_size;
 
-      if (offset > start_position_of_current_run) {
+      if (offset >= start_position_of_current_run) {
         // This is an attempt to loop or point forward: bad in either case.
         reader.MarkUnhealthy();
         return;
@@ -62,7 +62,7 @@ void ReadNameLabels(PacketReader& reader, std::vector<char>& chars) {
 
     size_t old_size = chars.size();
     chars.resize(old_size + label_size + 1);
-    if (!reader.GetBytes(label_size, chars.data() + old_size)) {
+    if (!reader.GetBytes(label_size, &chars[old_size])) {
       break;
     }
 
@@ -75,15 +75,25 @@ void ReadNameLabels(PacketReader& reader, std::vector<char>& chars) {
   }
 }
 
+// Returns true if |count| records may be accepted in one section.
+bool CheckCount(uint16_t count, size_t max) {
+  if (count > max) {
+    FXL_DLOG(ERROR) << "Max record count exceeded; rejecting message.";
+    return false;
+  }
+
+  return true;
+}
+
 }  // namespace
 
 PacketReader& operator>>(PacketReader& reader, DnsName& value) {
-  std::vector<char> chars;
+  std::string dotted_string;
 
-  ReadNameLabels(reader, chars);
+  ReadNameLabels(reader, dotted_string);
 
   if (reader.healthy()) {
-    value.dotted_string_ = std::string(chars.data(), chars.size());
+    value = DnsName(dotted_string);
   }
 
   return reader;
@@ -353,4 +363,158 @@ PacketReader& operator>>(PacketReader& reader, DnsMessage& value) {
   return reader;
 }
 
+DnsMessageView::DnsMessageView() {}
+
+DnsMessageView::~DnsMessageView() {}
+
+bool DnsMessageView::Parse(const uint8_t* data, size_t size) {
+  FXL_DCHECK(data != nullptr || size == 0);
+
+  data_ = data;
+  size_ = size;
+  questions_.clear();
+  answers_.clear();
+  authorities_.clear();
+  additionals_.clear();
+
+  PacketReader reader(data, size);
+  reader >> header_;
+
+  if (!reader.healthy() ||
+      !CheckCount(header_.question_count_, kMaxQuestions) ||
+      !CheckCount(header_.answer_count_, kMaxAnswers) ||
+      !CheckCount(header_.authority_count_, kMaxAuthorities) ||
+      !CheckCount(header_.additional_count_, kMaxAdditionals)) {
+    return false;
+  }
+
+  for (uint16_t i = 0; reader.healthy() && i < header_.question_count_; ++i) {
+    questions_.push_back(reader.bytes_consumed());
+    SkipQuestion(reader);
+  }
+
+  SkipResources(reader, header_.answer_count_, &answers_);
+  SkipResources(reader, header_.authority_count_, &authorities_);
+  SkipResources(reader, header_.additional_count_, &additionals_);
+
+  return reader.complete();
+}
+
+void DnsMessageView::GetName(size_t position,
+                             std::string* dotted_string) const {
+  FXL_DCHECK(position < size_);
+  FXL_DCHECK(dotted_string);
+
+  PacketReader reader(data_, size_);
+  reader.SetBytesConsumed(position);
+  dotted_string->clear();
+  ReadNameLabels(reader, *dotted_string);
+  FXL_DCHECK(reader.healthy());
+}
+
+std::shared_ptr<DnsQuestion> DnsMessageView::DecodeQuestion(
+    size_t position) const {
+  FXL_DCHECK(position < size_);
+
+  PacketReader reader(data_, size_);
+  reader.SetBytesConsumed(position);
+  std::shared_ptr<DnsQuestion> question;
+  reader >> question;
+  FXL_DCHECK(reader.healthy());
+  return question;
+}
+
+std::shared_ptr<DnsResource> DnsMessageView::DecodeResource(
+    size_t position) const {
+  FXL_DCHECK(position < size_);
+
+  PacketReader reader(data_, size_);
+  reader.SetBytesConsumed(position);
+  std::shared_ptr<DnsResource> resource;
+  reader >> resource;
+  FXL_DCHECK(reader.healthy());
+  return resource;
+}
+
+std::unique_ptr<DnsMessage> DnsMessageView::Decode() const {
+  PacketReader reader(data_, size_);
+  std::unique_ptr<DnsMessage> message = std::make_unique<DnsMessage>();
+  reader >> *message;
+  return message;
+}
+
+void DnsMessageView::SkipQuestion(PacketReader& reader) {
+  uint16_t type_and_class[2];
+  ReadNameLabels(reader, scratch_);
+  reader.GetBytes(sizeof(type_and_class), type_and_class);
+  scratch_.clear();
+}
+
+void DnsMessageView::SkipResource(PacketReader& reader) {
+  DnsType type;
+  DnsClassAndFlag class_and_flag;
+  uint32_t time_to_live;
+  uint16_t data_size;
+  ReadNameLabels(reader, scratch_);
+  reader >> type >> class_and_flag >> time_to_live >> data_size;
+
+  if (!reader.healthy() || data_size > reader.bytes_remaining()) {
+    reader.MarkUnhealthy();
+    return;
+  }
+
+  // The data is checked to the extent decoding it would fail otherwise.
+  size_t data_end = reader.bytes_consumed() + data_size;
+  switch (type) {
+    case DnsType::kA:
+      reader.Bytes(sizeof(in_addr));
+      break;
+    case DnsType::kAaaa:
+      reader.Bytes(sizeof(in6_addr));
+      break;
+    case DnsType::kSrv:
+      reader.Bytes(3 * sizeof(uint16_t));
+      ReadNameLabels(reader, scratch_);
+      break;
+    case DnsType::kNs:
+    case DnsType::kCName:
+    case DnsType::kPtr:
+    case DnsType::kNSec:
+      ReadNameLabels(reader, scratch_);
+      break;
+    case DnsType::kTxt:
+      while (reader.healthy() && reader.bytes_consumed() < data_end) {
+        uint8_t length;
+        reader >> length;
+        if (length > data_end - reader.bytes_consumed()) {
+          reader.MarkUnhealthy();
+        } else {
+          reader.Bytes(length);
+        }
+      }
+      break;
+    default:
+      break;
+  }
+
+  scratch_.clear();
+
+  if (reader.bytes_consumed() > data_end) {
+    reader.MarkUnhealthy();
+    return;
+  }
+
+  reader.SetBytesConsumed(data_end);
+}
+
+void DnsMessageView::SkipResources(PacketReader& reader, uint16_t count,
+                                   std::vector<size_t>* positions) {
+  FXL_DCHECK(positions);
+
+  for (uint16_t i = 0; reader.healthy() && i < count; ++i) {
+    positions->push_back(reader.bytes_consumed());
+    SkipResource(reader);
+  }
+}
+
 }  // namespace mdns
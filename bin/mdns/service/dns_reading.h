@@ -6,6 +6,8 @@
 #define GARNET_BIN_MDNS_SERVICE_DNS_READING_H_
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "garnet/bin/mdns/service/dns_message.h"
 #include "garnet/bin/mdns/service/packet_reader.h"
@@ -43,6 +45,66 @@ PacketReader& operator>>(PacketReader& reader, DnsResourceDataNSec& value);
 PacketReader& operator>>(PacketReader& reader, DnsResource& value);
 PacketReader& operator>>(PacketReader& reader, DnsMessage& value);
 
+// Received message read in place. |Parse| validates the message and records
+// where each question and resource starts, but decodes nothing. Questions and
+// resources are decoded on demand, so the ones nobody is interested in cost no
+// allocations. The vectors holding the positions retain their storage from one
+// |Parse| to the next, so a view should be reused for successive messages.
+class DnsMessageView {
+ public:
+  DnsMessageView();
+
+  ~DnsMessageView();
+
+  // Parses the |size|-byte message at |data|, which must remain valid and
+  // unchanged while the view is in use. Returns false if the message is
+  // malformed, in which case the view must not be used.
+  bool Parse(const uint8_t* data, size_t size);
+
+  const DnsHeader& header() const { return header_; }
+
+  // Positions of the questions and resources in the message by section.
+  const std::vector<size_t>& questions() const { return questions_; }
+  const std::vector<size_t>& answers() const { return answers_; }
+  const std::vector<size_t>& authorities() const { return authorities_; }
+  const std::vector<size_t>& additionals() const { return additionals_; }
+
+  // Reads the name of the question or resource at |position| into
+  // |dotted_string|, reusing its storage.
+  void GetName(size_t position, std::string* dotted_string) const;
+
+  // Decodes the question at |position|.
+  std::shared_ptr<DnsQuestion> DecodeQuestion(size_t position) const;
+
+  // Decodes the resource at |position|.
+  std::shared_ptr<DnsResource> DecodeResource(size_t position) const;
+
+  // Decodes the entire message.
+  std::unique_ptr<DnsMessage> Decode() const;
+
+ private:
+  // Consumes a question, checking that it's well-formed.
+  void SkipQuestion(PacketReader& reader);
+
+  // Consumes a resource, checking that it's well-formed.
+  void SkipResource(PacketReader& reader);
+
+  // Consumes |count| resources, recording their positions in |positions|.
+  void SkipResources(PacketReader& reader, uint16_t count,
+                     std::vector<size_t>* positions);
+
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  DnsHeader header_;
+  std::vector<size_t> questions_;
+  std::vector<size_t> answers_;
+  std::vector<size_t> authorities_;
+  std::vector<size_t> additionals_;
+
+  // Names are read into this string to check them.
+  std::string scratch_;
+};
+
 }  // namespace mdns
 
 #endif  // GARNET_BIN_MDNS_SERVICE_DNS_READING_H_
@@ -0,0 +1,248 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/bin/mdns/service/dns_reading.h"
+
+#include <string.h>
+
+#include "garnet/bin/mdns/service/dns_writing.h"
+#include "garnet/bin/mdns/service/packet_writer.h"
+#include "gtest/gtest.h"
+
+namespace mdns {
+namespace {
+
+// Returns a response announcing a service instance, with a question thrown in.
+DnsMessage MakeMessage() {
+  DnsMessage message;
+  message.header_.SetResponse(true);
+  message.header_.SetAuthoritativeAnswer(true);
+
+  message.questions_.push_back(
+      std::make_shared<DnsQuestion>("_foo._tcp.local.", DnsType::kPtr));
+
+  auto ptr = std::make_shared<DnsResource>("_foo._tcp.local.", DnsType::kPtr);
+  ptr->ptr_.pointer_domain_name_ = DnsName("myfoo._foo._tcp.local.");
+  message.answers_.push_back(ptr);
+
+  auto srv =
+      std::make_shared<DnsResource>("myfoo._foo._tcp.local.", DnsType::kSrv);
+  srv->srv_.port_ = inet::IpPort::From_uint16_t(5353);
+  srv->srv_.target_ = DnsName("host.local.");
+  message.answers_.push_back(srv);
+
+  auto txt =
+      std::make_shared<DnsResource>("myfoo._foo._tcp.local.", DnsType::kTxt);
+  txt->txt_.strings_.push_back("color=blue");
+  txt->txt_.strings_.push_back("size=large");
+  message.authorities_.push_back(txt);
+
+  auto a = std::make_shared<DnsResource>("host.local.", DnsType::kA);
+  a->a_.address_.address_ = inet::IpAddress(192, 168, 1, 2);
+  message.additionals_.push_back(a);
+
+  auto aaaa = std::make_shared<DnsResource>("host.local.", DnsType::kAaaa);
+  aaaa->aaaa_.address_.address_ = inet::IpAddress(0xfe80, 0x1234);
+  message.additionals_.push_back(aaaa);
+
+  message.UpdateCounts();
+  return message;
+}
+
+// Returns true if |view| parses |packet|.
+bool Parses(const std::vector<uint8_t>& packet) {
+  DnsMessageView view;
+  return view.Parse(packet.data(), packet.size());
+}
+
+// Returns the position of the resource data size field of the first answer
+// in |packet|, which must hold the message returned by |MakeMessage|.
+size_t FirstAnswerDataSizePosition(const std::vector<uint8_t>& packet) {
+  DnsMessageView view;
+  EXPECT_TRUE(view.Parse(packet.data(), packet.size()));
+  // The first answer's name is a pointer to the question's name. The type,
+  // class and time to live follow.
+  return view.answers()[0] + sizeof(uint16_t) + 2 * sizeof(uint16_t) +
+         sizeof(uint32_t);
+}
+
+// Tests that decoding the parsed view produces the same message as reading
+// the packet eagerly.
+TEST(DnsMessageViewTest, MatchesEagerReading) {
+  std::vector<uint8_t> packet = PacketWriter::Write(MakeMessage());
+
+  DnsMessage eager;
+  PacketReader reader(packet);
+  reader >> eager;
+  ASSERT_TRUE(reader.complete());
+
+  DnsMessageView view;
+  ASSERT_TRUE(view.Parse(packet.data(), packet.size()));
+  EXPECT_EQ(eager.header_.flags_, view.header().flags_);
+  ASSERT_EQ(eager.questions_.size(), view.questions().size());
+  ASSERT_EQ(eager.answers_.size(), view.answers().size());
+  ASSERT_EQ(eager.authorities_.size(), view.authorities().size());
+  ASSERT_EQ(eager.additionals_.size(), view.additionals().size());
+
+  DnsMessage lazy;
+  lazy.header_ = view.header();
+  std::string name;
+  for (size_t position : view.questions()) {
+    lazy.questions_.push_back(view.DecodeQuestion(position));
+    view.GetName(position, &name);
+    EXPECT_EQ(lazy.questions_.back()->name_.dotted_string_, name);
+  }
+
+  auto decode_resources =
+      [&view, &name](const std::vector<size_t>& positions,
+                     std::vector<std::shared_ptr<DnsResource>>* resources) {
+        for (size_t position : positions) {
+          resources->push_back(view.DecodeResource(position));
+          view.GetName(position, &name);
+          EXPECT_EQ(resources->back()->name_.dotted_string_, name);
+        }
+      };
+  decode_resources(view.answers(), &lazy.answers_);
+  decode_resources(view.authorities(), &lazy.authorities_);
+  decode_resources(view.additionals(), &lazy.additionals_);
+
+  EXPECT_EQ(PacketWriter::Write(eager), PacketWriter::Write(lazy));
+  EXPECT_EQ(PacketWriter::Write(eager), PacketWriter::Write(*view.Decode()));
+
+  EXPECT_EQ(DnsName("myfoo._foo._tcp.local.").key(),
+            lazy.answers_[0]->ptr_.pointer_domain_name_.key());
+  EXPECT_EQ(inet::IpAddress(192, 168, 1, 2),
+            lazy.additionals_[0]->a_.address_.address_);
+}
+
+// Tests that a view parses successive messages, forgetting the previous one.
+TEST(DnsMessageViewTest, Reuse) {
+  std::vector<uint8_t> packet = PacketWriter::Write(MakeMessage());
+
+  DnsMessage query;
+  query.questions_.push_back(
+      std::make_shared<DnsQuestion>("host.local.", DnsType::kA));
+  query.UpdateCounts();
+  std::vector<uint8_t> query_packet = PacketWriter::Write(query);
+
+  DnsMessageView view;
+  ASSERT_TRUE(view.Parse(packet.data(), packet.size()));
+  ASSERT_TRUE(view.Parse(query_packet.data(), query_packet.size()));
+  EXPECT_EQ(1u, view.questions().size());
+  EXPECT_TRUE(view.answers().empty());
+  EXPECT_TRUE(view.authorities().empty());
+  EXPECT_TRUE(view.additionals().empty());
+
+  std::string name;
+  view.GetName(view.questions()[0], &name);
+  EXPECT_EQ("host.local.", name);
+}
+
+// Tests that every truncation of a message is rejected.
+TEST(DnsMessageViewTest, Truncated) {
+  std::vector<uint8_t> packet = PacketWriter::Write(MakeMessage());
+  ASSERT_TRUE(Parses(packet));
+
+  DnsMessageView view;
+  for (size_t size = 0; size < packet.size(); ++size) {
+    EXPECT_FALSE(view.Parse(packet.data(), size)) << "size " << size;
+  }
+}
+
+// Tests that trailing bytes after the last resource are rejected.
+TEST(DnsMessageViewTest, TrailingBytes) {
+  std::vector<uint8_t> packet = PacketWriter::Write(MakeMessage());
+  packet.push_back(0);
+  EXPECT_FALSE(Parses(packet));
+}
+
+// Tests that resources whose data size overruns the message are rejected.
+TEST(DnsMessageViewTest, DataSizeOverrun) {
+  std::vector<uint8_t> packet = PacketWriter::Write(MakeMessage());
+  size_t position = FirstAnswerDataSizePosition(packet);
+  packet[position] = 0xff;
+  packet[position + 1] = 0xff;
+  EXPECT_FALSE(Parses(packet));
+}
+
+// Tests that resources whose data doesn't fit the data size are rejected.
+TEST(DnsMessageViewTest, DataSizeTooSmall) {
+  DnsMessage message;
+  auto a = std::make_shared<DnsResource>("host.local.", DnsType::kA);
+  a->a_.address_.address_ = inet::IpAddress(192, 168, 1, 2);
+  message.answers_.push_back(a);
+  message.UpdateCounts();
+
+  std::vector<uint8_t> packet = PacketWriter::Write(message);
+  ASSERT_TRUE(Parses(packet));
+
+  // Claim two of the four address bytes are part of the next resource.
+  packet[packet.size() - sizeof(in_addr) - 1] = 2;
+  EXPECT_FALSE(Parses(packet));
+}
+
+// Tests that TXT strings overrunning the resource data are rejected.
+TEST(DnsMessageViewTest, TxtStringOverrun) {
+  DnsMessage message;
+  auto txt = std::make_shared<DnsResource>("myfoo._foo._tcp.local.",
+                                           DnsType::kTxt);
+  txt->txt_.strings_.push_back("color=blue");
+  message.answers_.push_back(txt);
+  message.UpdateCounts();
+
+  std::vector<uint8_t> packet = PacketWriter::Write(message);
+  ASSERT_TRUE(Parses(packet));
+
+  // The data is the string followed by an empty string.
+  size_t string_position = packet.size() - 1 - 1 - strlen("color=blue");
+  ASSERT_EQ(strlen("color=blue"), packet[string_position]);
+  packet[string_position] = strlen("color=blue") + 2;
+  EXPECT_FALSE(Parses(packet));
+}
+
+// Tests that names pointing forward or at themselves are rejected rather than
+// followed forever.
+TEST(DnsMessageViewTest, BadNamePointers) {
+  DnsMessage message;
+  message.questions_.push_back(
+      std::make_shared<DnsQuestion>("host.local.", DnsType::kA));
+  message.UpdateCounts();
+
+  std::vector<uint8_t> packet = PacketWriter::Write(message);
+  ASSERT_TRUE(Parses(packet));
+
+  // Replace the name with a pointer to itself.
+  size_t name_position = sizeof(DnsHeader);
+  packet[name_position] = 0xc0;
+  packet[name_position + 1] = name_position;
+  EXPECT_FALSE(Parses(packet));
+
+  // Point past the end of the name.
+  packet[name_position + 1] = name_position + 4;
+  EXPECT_FALSE(Parses(packet));
+}
+
+// Tests that labels longer than 63 bytes are rejected.
+TEST(DnsMessageViewTest, LabelTooLong) {
+  DnsMessage message;
+  message.questions_.push_back(
+      std::make_shared<DnsQuestion>("host.local.", DnsType::kA));
+  message.UpdateCounts();
+
+  std::vector<uint8_t> packet = PacketWriter::Write(message);
+  packet[sizeof(DnsHeader)] = 64;
+  EXPECT_FALSE(Parses(packet));
+}
+
+// Tests that excessive record counts are rejected before anything is read.
+TEST(DnsMessageViewTest, TooManyRecords) {
+  DnsHeader header;
+  header.answer_count_ = 1025;
+
+  std::vector<uint8_t> packet = PacketWriter::Write(header);
+  EXPECT_FALSE(Parses(packet));
+}
+
+}  // namespace
+}  // namespace mdns
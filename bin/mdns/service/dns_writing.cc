@@ -4,41 +4,77 @@
 
 #include "garnet/bin/mdns/service/dns_writing.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "lib/fxl/logging.h"
 
 namespace mdns {
+namespace {
 
-PacketWriter& operator<<(PacketWriter& writer, const DnsName& value) {
-  std::string s = value.dotted_string_;
-
-  while (!s.empty()) {
-    size_t position = writer.GetBookmarkPosition(s);
-    if (position != PacketWriter::npos) {
-      // Write a name offset.
-      uint16_t offset = static_cast<uint16_t>(position) | 0xc000;
-      writer << offset;
-      return writer;
-    }
+// Returns the index in |name| of the label that ends at index |end|.
+size_t LabelStart(const std::string& name, size_t end) {
+  FXL_DCHECK(end != 0);
+  size_t dot = name.rfind('.', end - 1);
+  return dot == std::string::npos ? 0 : dot + 1;
+}
 
-    writer.CreateBookmark(s);
+}  // namespace
 
-    size_t dot_pos = s.find('.');
+PacketWriter& operator<<(PacketWriter& writer, const DnsName& value) {
+  const std::string& name = value.dotted_string_;
 
-    if (dot_pos == std::string::npos) {
-      // There really should be a dot at the end, but there is not.
-      writer << static_cast<uint8_t>(s.size());
-      writer.PutBytes(s.size(), s.data());
+  // There really should be a dot at the end, but there may not be.
+  size_t size = name.size();
+  if (size != 0 && name[size - 1] == '.') {
+    --size;
+  }
+
+  // Find the longest suffix of the name that's already in the packet, working
+  // from the last label towards the first. |unmatched| is the size of the
+  // remaining prefix, excluding the dot that separates it from the suffix.
+  size_t suffix = PacketWriter::kEmptySuffix;
+  size_t unmatched = size;
+  while (unmatched != 0) {
+    size_t label_start = LabelStart(name, unmatched);
+    size_t child = writer.FindSuffix(suffix, name.data() + label_start,
+                                     unmatched - label_start);
+    if (child == PacketWriter::npos) {
       break;
     }
 
-    writer << static_cast<uint8_t>(dot_pos);
-    writer.PutBytes(dot_pos, s.data());
-    s = s.substr(dot_pos + 1);
+    suffix = child;
+    unmatched = label_start == 0 ? 0 : label_start - 1;
   }
 
-  return writer << static_cast<uint8_t>(0);
+  // Write the labels of the prefix. Each label is written over the dot that
+  // precedes it, so a label starting at index |i| of |name| is written at
+  // |name_position + i|.
+  size_t name_position = writer.position();
+  for (size_t label_start = 0; label_start < unmatched;) {
+    size_t label_end = std::min(name.find('.', label_start), unmatched);
+    writer << static_cast<uint8_t>(label_end - label_start);
+    writer.PutBytes(label_end - label_start, name.data() + label_start);
+    label_start = label_end + 1;
+  }
+
+  if (suffix == PacketWriter::kEmptySuffix) {
+    writer << static_cast<uint8_t>(0);
+  } else {
+    // Write a name offset.
+    uint16_t offset =
+        static_cast<uint16_t>(writer.SuffixPosition(suffix)) | 0xc000;
+    writer << offset;
+  }
+
+  // Make the new suffixes available to names written later.
+  while (unmatched != 0 && suffix != PacketWriter::npos) {
+    size_t label_start = LabelStart(name, unmatched);
+    suffix = writer.AddSuffix(suffix, name_position + label_start);
+    unmatched = label_start == 0 ? 0 : label_start - 1;
+  }
+
+  return writer;
 }
 
 PacketWriter& operator<<(PacketWriter& writer, const DnsV4Address& value) {
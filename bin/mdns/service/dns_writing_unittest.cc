@@ -0,0 +1,123 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/bin/mdns/service/dns_writing.h"
+
+#include <string.h>
+
+#include "garnet/bin/mdns/service/dns_reading.h"
+#include "garnet/bin/mdns/service/packet_writer.h"
+#include "gtest/gtest.h"
+
+namespace mdns {
+namespace {
+
+// Writes the length byte and characters of |label|.
+void WriteLabel(PacketWriter& writer, const char* label) {
+  writer << static_cast<uint8_t>(strlen(label));
+  writer.PutBytes(strlen(label), label);
+}
+
+// Tests that suffixes are found by parent and label, byte-wise.
+TEST(PacketWriterTest, FindSuffix) {
+  PacketWriter writer;
+  size_t local_position = writer.position();
+  WriteLabel(writer, "local");
+  size_t host_position = writer.position();
+  WriteLabel(writer, "host");
+
+  EXPECT_EQ(PacketWriter::npos,
+            writer.FindSuffix(PacketWriter::kEmptySuffix, "local", 5));
+
+  size_t local = writer.AddSuffix(PacketWriter::kEmptySuffix, local_position);
+  ASSERT_NE(PacketWriter::npos, local);
+  size_t host = writer.AddSuffix(local, host_position);
+  ASSERT_NE(PacketWriter::npos, host);
+
+  EXPECT_EQ(local, writer.FindSuffix(PacketWriter::kEmptySuffix, "local", 5));
+  EXPECT_EQ(host, writer.FindSuffix(local, "host", 4));
+  EXPECT_EQ(local_position, writer.SuffixPosition(local));
+  EXPECT_EQ(host_position, writer.SuffixPosition(host));
+
+  // Labels must match exactly, and under the right parent.
+  EXPECT_EQ(PacketWriter::npos,
+            writer.FindSuffix(PacketWriter::kEmptySuffix, "LOCAL", 5));
+  EXPECT_EQ(PacketWriter::npos, writer.FindSuffix(local, "hos", 3));
+  EXPECT_EQ(PacketWriter::npos,
+            writer.FindSuffix(PacketWriter::kEmptySuffix, "host", 4));
+
+  writer.Reset();
+  EXPECT_EQ(PacketWriter::npos,
+            writer.FindSuffix(PacketWriter::kEmptySuffix, "local", 5));
+}
+
+// Tests that suffixes out of reach of a name pointer aren't recorded.
+TEST(PacketWriterTest, AddSuffixOutOfReach) {
+  PacketWriter writer;
+  std::vector<uint8_t> padding(0x4000);
+  writer << padding;
+  size_t position = writer.position();
+  WriteLabel(writer, "local");
+
+  EXPECT_EQ(PacketWriter::npos,
+            writer.AddSuffix(PacketWriter::kEmptySuffix, position));
+  EXPECT_EQ(PacketWriter::npos,
+            writer.FindSuffix(PacketWriter::kEmptySuffix, "local", 5));
+}
+
+// Tests that names sharing suffixes are compressed and read back intact.
+TEST(DnsWritingTest, NameCompression) {
+  const std::vector<std::string> names = {
+      "myfoo._foo._tcp.local.", "_foo._tcp.local.", "host.local.",
+      "myfoo._foo._tcp.local.", "Host.local.",      "local.",
+  };
+
+  PacketWriter writer;
+  std::vector<size_t> positions;
+  for (auto& name : names) {
+    positions.push_back(writer.position());
+    writer << DnsName(name);
+  }
+  size_t size = writer.position();
+
+  // The first name is written in full, "_foo._tcp.local." and the repeated
+  // name are pointers, "host." and "Host." are one label plus a pointer and
+  // "local." is a pointer.
+  EXPECT_EQ(strlen("myfoo._foo._tcp.local.") + 1, positions[1]);
+  EXPECT_EQ(2u, positions[2] - positions[1]);
+  EXPECT_EQ(1 + strlen("host") + 2, positions[3] - positions[2]);
+  EXPECT_EQ(2u, positions[4] - positions[3]);
+  EXPECT_EQ(1 + strlen("Host") + 2, positions[5] - positions[4]);
+  EXPECT_EQ(2u, size - positions[5]);
+
+  PacketReader reader(writer.GetResizedPacket());
+  for (size_t i = 0; i < names.size(); ++i) {
+    EXPECT_EQ(positions[i], reader.bytes_consumed());
+    DnsName name;
+    reader >> name;
+    ASSERT_TRUE(reader.healthy());
+    EXPECT_EQ(names[i], name.dotted_string_);
+  }
+  EXPECT_TRUE(reader.complete());
+}
+
+// Tests that names written after a reset don't point into the previous
+// packet.
+TEST(DnsWritingTest, NameCompressionAfterReset) {
+  PacketWriter writer;
+  writer << DnsName("host.local.");
+  writer.Reset();
+
+  writer << DnsName("other.local.");
+  EXPECT_EQ(strlen("other.local.") + 1, writer.position());
+
+  PacketReader reader(writer.GetResizedPacket());
+  DnsName name;
+  reader >> name;
+  EXPECT_TRUE(reader.complete());
+  EXPECT_EQ("other.local.", name.dotted_string_);
+}
+
+}  // namespace
+}  // namespace mdns
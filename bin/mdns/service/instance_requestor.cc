@@ -39,6 +39,7 @@ void InstanceRequestor::RemoveSubscriber(Mdns::Subscriber* subscriber) {
 }
 
 void InstanceRequestor::Start(const std::string& host_full_name) {
+  SubscribeToName(service_full_name_);
   SendQuery();
 }
 
@@ -142,6 +143,7 @@ void InstanceRequestor::EndOfMessage() {
       ++iter;
     } else {
       // No instances reference this target. Get rid of it.
+      UnsubscribeFromName(iter->first);
       iter = target_infos_by_full_name_.erase(iter);
     }
   }
@@ -222,6 +224,7 @@ void InstanceRequestor::ReceivePtrResource(const DnsResource& resource,
                                                      InstanceInfo{});
     FXL_DCHECK(pair.second);
     pair.first->second.instance_name_ = instance_name;
+    SubscribeToName(instance_full_name);
   }
 
   Renew(resource);
@@ -242,6 +245,7 @@ void InstanceRequestor::ReceiveSrvResource(const DnsResource& resource,
     if (target_infos_by_full_name_.find(instance_info->target_) ==
         target_infos_by_full_name_.end()) {
       target_infos_by_full_name_.emplace(instance_info->target_, TargetInfo{});
+      SubscribeToName(instance_info->target_);
     }
   }
 
@@ -327,6 +331,7 @@ void InstanceRequestor::RemoveInstance(const std::string& instance_full_name) {
       subscriber->InstanceLost(service_name_, iter->second.instance_name_);
     }
 
+    UnsubscribeFromName(iter->first);
     instance_infos_by_full_name_.erase(iter);
   }
 }
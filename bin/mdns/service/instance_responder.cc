@@ -30,6 +30,10 @@ void InstanceResponder::Start(const std::string& host_full_name) {
 
   host_full_name_ = host_full_name;
 
+  // Subtype names are directed to subscribers of the service name.
+  SubscribeToName(MdnsNames::LocalServiceFullName(service_name_));
+  SubscribeToName(instance_full_name_);
+
   Reannounce();
 }
 
@@ -72,14 +72,21 @@ void Mdns::Start(std::unique_ptr<InterfaceMonitor> interface_monitor,
           StartAddressProbe(original_host_name_);
         }
       },
-      [this](std::unique_ptr<DnsMessage> message,
+      [this](const DnsMessageView& message,
              const ReplyAddress& reply_address) {
         if (verbose_) {
           FXL_LOG(INFO) << "Inbound message from " << reply_address << ":"
-                        << *message;
+                        << *message.Decode();
         }
 
-        for (auto& question : message->questions_) {
+        for (size_t position : message.questions()) {
+          if (!agent_router_.IsNameOfInterest(message, position)) {
+            continue;
+          }
+
+          std::shared_ptr<DnsQuestion> question =
+              message.DecodeQuestion(position);
+
           // We reply to questions using unicast if specifically requested in
           // the question or if the sender's port isn't 5353.
           ReceiveQuestion(*question, (question->unicast_response_ ||
@@ -89,17 +96,12 @@ void Mdns::Start(std::unique_ptr<InterfaceMonitor> interface_monitor,
                                          : MdnsAddresses::kV4MulticastReply);
         }
 
-        for (auto& resource : message->answers_) {
-          ReceiveResource(*resource, MdnsResourceSection::kAnswer);
-        }
-
-        for (auto& resource : message->authorities_) {
-          ReceiveResource(*resource, MdnsResourceSection::kAuthority);
-        }
-
-        for (auto& resource : message->additionals_) {
-          ReceiveResource(*resource, MdnsResourceSection::kAdditional);
-        }
+        ReceiveResources(message, message.answers(),
+                         MdnsResourceSection::kAnswer);
+        ReceiveResources(message, message.authorities(),
+                         MdnsResourceSection::kAuthority);
+        ReceiveResources(message, message.additionals(),
+                         MdnsResourceSection::kAdditional);
 
         resource_renewer_->EndOfMessage();
         DPROHIBIT_AGENT_REMOVAL();
@@ -211,7 +213,7 @@ void Mdns::StartAddressProbe(const std::string& host_name) {
 
   // We don't use |AddAgent| here, because agents added that way don't
   // actually participate until we're done probing for host name conflicts.
-  agents_.emplace(address_prober.get(), address_prober);
+  InsertAgent(address_prober);
   address_prober->Start(host_full_name_);
   SendMessages();
 }
@@ -248,8 +250,8 @@ void Mdns::SendResource(std::shared_ptr<DnsResource> resource,
     // separately so we don't create an empty outbound message.
     prohibit_agent_removal_ = true;
 
-    for (auto& pair : agents_) {
-      pair.second->ReceiveResource(*resource, MdnsResourceSection::kExpired);
+    for (MdnsAgent* agent : agent_router_.AgentsForName(resource->name_)) {
+      agent->ReceiveResource(*resource, MdnsResourceSection::kExpired);
     }
 
     prohibit_agent_removal_ = false;
@@ -289,6 +291,7 @@ void Mdns::RemoveAgent(const MdnsAgent* agent,
   FXL_DCHECK(!prohibit_agent_removal_);
 
   agents_.erase(agent);
+  agent_router_.RemoveAgent(agent);
 
   // Remove all pending tasks posted by this agent.
   std::priority_queue<TaskQueueEntry> temp;
@@ -312,9 +315,19 @@ void Mdns::RemoveAgent(const MdnsAgent* agent,
   SendMessages();
 }
 
+void Mdns::SubscribeToName(MdnsAgent* agent, const DnsName& name) {
+  FXL_DCHECK(agent);
+  FXL_DCHECK(agents_.find(agent) != agents_.end());
+  agent_router_.Subscribe(agent, name);
+}
+
+void Mdns::UnsubscribeFromName(MdnsAgent* agent, const DnsName& name) {
+  agent_router_.Unsubscribe(agent, name);
+}
+
 void Mdns::AddAgent(std::shared_ptr<MdnsAgent> agent) {
   if (state_ == State::kActive) {
-    agents_.emplace(agent.get(), agent);
+    InsertAgent(agent);
     FXL_DCHECK(!host_full_name_.empty());
     agent->Start(host_full_name_);
     SendMessages();
@@ -323,6 +336,11 @@ void Mdns::AddAgent(std::shared_ptr<MdnsAgent> agent) {
   }
 }
 
+void Mdns::InsertAgent(std::shared_ptr<MdnsAgent> agent) {
+  agent_router_.AddAgent(agent.get());
+  agents_.emplace(agent.get(), agent);
+}
+
 bool Mdns::ProbeAndAddInstanceResponder(
     const std::string& service_name, const std::string& instance_name,
     inet::IpPort port, std::shared_ptr<InstanceResponder> agent) {
@@ -384,12 +402,22 @@ void Mdns::SendMessages() {
   outbound_messages_by_reply_address_.clear();
 }
 
+void Mdns::ReceiveResources(const DnsMessageView& message,
+                            const std::vector<size_t>& positions,
+                            MdnsResourceSection section) {
+  for (size_t position : positions) {
+    if (agent_router_.IsNameOfInterest(message, position)) {
+      ReceiveResource(*message.DecodeResource(position), section);
+    }
+  }
+}
+
 void Mdns::ReceiveQuestion(const DnsQuestion& question,
                            const ReplyAddress& reply_address) {
   // Renewer doesn't need questions.
   DPROHIBIT_AGENT_REMOVAL();
-  for (auto& pair : agents_) {
-    pair.second->ReceiveQuestion(question, reply_address);
+  for (MdnsAgent* agent : agent_router_.AgentsForName(question.name_)) {
+    agent->ReceiveQuestion(question, reply_address);
   }
 
   DALLOW_AGENT_REMOVAL();
@@ -400,8 +428,8 @@ void Mdns::ReceiveResource(const DnsResource& resource,
   // Renewer is always first.
   resource_renewer_->ReceiveResource(resource, section);
   DPROHIBIT_AGENT_REMOVAL();
-  for (auto& pair : agents_) {
-    pair.second->ReceiveResource(resource, section);
+  for (MdnsAgent* agent : agent_router_.AgentsForName(resource.name_)) {
+    agent->ReceiveResource(resource, section);
   }
 
   DALLOW_AGENT_REMOVAL();
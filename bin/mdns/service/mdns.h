@@ -14,7 +14,9 @@
 #include <lib/async/dispatcher.h>
 #include <lib/fit/function.h>
 
+#include "garnet/bin/mdns/service/agent_router.h"
 #include "garnet/bin/mdns/service/dns_message.h"
+#include "garnet/bin/mdns/service/dns_reading.h"
 #include "garnet/bin/mdns/service/mdns_agent.h"
 #include "garnet/bin/mdns/service/mdns_transceiver.h"
 #include "garnet/lib/inet/socket_address.h"
@@ -245,9 +247,16 @@ class Mdns : public MdnsAgent::Host {
   void RemoveAgent(const MdnsAgent* agent,
                    const std::string& published_instance_full_name) override;
 
+  void SubscribeToName(MdnsAgent* agent, const DnsName& name) override;
+
+  void UnsubscribeFromName(MdnsAgent* agent, const DnsName& name) override;
+
   // Adds an agent and, if |started_|, starts it.
   void AddAgent(std::shared_ptr<MdnsAgent> agent);
 
+  // Adds an agent to |agents_| without starting it.
+  void InsertAgent(std::shared_ptr<MdnsAgent> agent);
+
   // Adds an instance responder.
   bool ProbeAndAddInstanceResponder(const std::string& service_name,
                                     const std::string& instance_name,
@@ -258,12 +267,19 @@ class Mdns : public MdnsAgent::Host {
   // clears |outbound_messages_by_reply_address_|.
   void SendMessages();
 
-  // Distributes questions to all the agents except the resource renewer.
+  // Decodes the resources at |positions| in |message| that may be of interest
+  // and distributes them.
+  void ReceiveResources(const DnsMessageView& message,
+                        const std::vector<size_t>& positions,
+                        MdnsResourceSection section);
+
+  // Distributes questions to the agents interested in the question's name.
+  // The resource renewer doesn't receive questions.
   void ReceiveQuestion(const DnsQuestion& question,
                        const ReplyAddress& reply_address);
 
-  // Distributes resources to all the agents, starting with the resource
-  // renewer.
+  // Distributes resources to the resource renewer and then to the agents
+  // interested in the resource's name.
   void ReceiveResource(const DnsResource& resource,
                        MdnsResourceSection section);
 
@@ -283,6 +299,7 @@ class Mdns : public MdnsAgent::Host {
       outbound_messages_by_reply_address_;
   std::vector<std::shared_ptr<MdnsAgent>> agents_awaiting_start_;
   std::unordered_map<const MdnsAgent*, std::shared_ptr<MdnsAgent>> agents_;
+  AgentRouter agent_router_;
   std::unordered_map<std::string, std::shared_ptr<InstanceRequestor>>
       instance_subscribers_by_service_name_;
   std::unordered_map<std::string, std::shared_ptr<InstanceResponder>>
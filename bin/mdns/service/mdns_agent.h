@@ -51,6 +51,14 @@ class MdnsAgent : public std::enable_shared_from_this<MdnsAgent> {
     // Registers the resource for renewal. See |MdnsAgent::Renew|.
     virtual void Renew(const DnsResource& resource) = 0;
 
+    // Directs received questions and resources named |name| to |agent|. See
+    // |MdnsAgent::SubscribeToName|.
+    virtual void SubscribeToName(MdnsAgent* agent, const DnsName& name) = 0;
+
+    // Reverts one call to |SubscribeToName| with the same arguments.
+    virtual void UnsubscribeFromName(MdnsAgent* agent,
+                                     const DnsName& name) = 0;
+
     // Removes the specified agent. |published_instance_full_name| is used for
     // instance publishers only and indicates the full name of a published
     // instance.
@@ -129,6 +137,22 @@ class MdnsAgent : public std::enable_shared_from_this<MdnsAgent> {
   // simply refrain from renewing the incoming records.
   void Renew(const DnsResource& resource) const { host_->Renew(resource); }
 
+  // Directs received questions and resources named |name|, compared without
+  // regard to case, to this agent. Names of subtypes of a service are also
+  // directed to agents subscribed to the service's full name. Once an
+  // agent has subscribed to a name, it only receives questions and resources
+  // for the names it's subscribed to. Agents which never subscribe receive
+  // all questions and resources. Subscriptions are counted, so a name
+  // subscribed to twice must be unsubscribed from twice.
+  void SubscribeToName(const std::string& name) {
+    host_->SubscribeToName(this, DnsName(name));
+  }
+
+  // Reverts one call to |SubscribeToName| for |name|.
+  void UnsubscribeFromName(const std::string& name) {
+    host_->UnsubscribeFromName(this, DnsName(name));
+  }
+
   // Removes this agent. |published_instance_full_name| is used for instance
   // publishers only and indicates the full name of a published instance.
   void RemoveSelf(const std::string& published_instance_full_name = "") const {
@@ -49,7 +49,7 @@ MdnsInterfaceTransceiver::MdnsInterfaceTransceiver(inet::IpAddress address,
       name_(name),
       index_(index),
       inbound_buffer_(kMaxPacketSize),
-      outbound_buffer_(kMaxPacketSize) {}
+      outbound_writer_(std::vector<uint8_t>(kMaxPacketSize)) {}
 
 MdnsInterfaceTransceiver::~MdnsInterfaceTransceiver() {}
 
@@ -107,12 +107,13 @@ void MdnsInterfaceTransceiver::SendMessage(DnsMessage* message,
   FixUpAddresses(&message->additionals_);
   message->UpdateCounts();
 
-  PacketWriter writer(std::move(outbound_buffer_));
-  writer << *message;
-  size_t packet_size = writer.position();
-  outbound_buffer_ = writer.GetPacket();
+  // |outbound_writer_| retains its buffer and name compression storage from
+  // one message to the next.
+  outbound_writer_.Reset();
+  outbound_writer_ << *message;
+  size_t packet_size = outbound_writer_.position();
 
-  ssize_t result = SendTo(outbound_buffer_.data(), packet_size, address);
+  ssize_t result = SendTo(outbound_writer_.data(), packet_size, address);
 
   ++messages_sent_;
   bytes_sent_ += packet_size;
@@ -194,14 +195,12 @@ void MdnsInterfaceTransceiver::InboundReady(zx_status_t status,
     return;
   }
 
-  PacketReader reader(inbound_buffer_);
-  reader.SetBytesRemaining(static_cast<size_t>(result));
-  std::unique_ptr<DnsMessage> message = std::make_unique<DnsMessage>();
-  reader >> *message.get();
-
-  if (reader.complete()) {
+  // The message is parsed in place. Its questions and resources are decoded
+  // only if someone is interested in them.
+  if (inbound_message_.Parse(inbound_buffer_.data(),
+                             static_cast<size_t>(result))) {
     FXL_DCHECK(inbound_message_callback_);
-    inbound_message_callback_(std::move(message), reply_address);
+    inbound_message_callback_(inbound_message_, reply_address);
   } else {
     inbound_buffer_.resize(result);
     FXL_LOG(ERROR) << "Couldn't parse message from " << reply_address << ", "
@@ -11,6 +11,8 @@
 #include <lib/fit/function.h>
 
 #include "garnet/bin/mdns/service/dns_message.h"
+#include "garnet/bin/mdns/service/dns_reading.h"
+#include "garnet/bin/mdns/service/packet_writer.h"
 #include "garnet/bin/mdns/service/reply_address.h"
 #include "garnet/lib/inet/ip_address.h"
 #include "garnet/lib/inet/socket_address.h"
@@ -27,7 +29,7 @@ class MdnsInterfaceTransceiver {
  public:
   // Callback to deliver inbound messages with reply address.
   using InboundMessageCallback =
-      fit::function<void(std::unique_ptr<DnsMessage>, const ReplyAddress&)>;
+      fit::function<void(const DnsMessageView&, const ReplyAddress&)>;
 
   // Creates the variant of |MdnsInterfaceTransceiver| appropriate for the
   // address family specified in |address|. |name| is the name of the interface,
@@ -121,7 +123,8 @@ class MdnsInterfaceTransceiver {
   fxl::UniqueFD socket_fd_;
   fsl::FDWaiter fd_waiter_;
   std::vector<uint8_t> inbound_buffer_;
-  std::vector<uint8_t> outbound_buffer_;
+  DnsMessageView inbound_message_;
+  PacketWriter outbound_writer_;
   InboundMessageCallback inbound_message_callback_;
   std::shared_ptr<DnsResource> address_resource_;
   std::shared_ptr<DnsResource> alternate_address_resource_;
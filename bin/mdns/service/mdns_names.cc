@@ -145,6 +145,16 @@ bool MdnsNames::MatchServiceName(const std::string& name,
   return true;
 }
 
+// static
+std::string MdnsNames::SubtypeServiceFullName(const std::string& name) {
+  size_t index = name.find(kSubtypeSeparator);
+  if (index == std::string::npos || index == 0) {
+    return "";
+  }
+
+  return name.substr(index + kSubtypeSeparator.size());
+}
+
 // static
 bool MdnsNames::IsValidHostName(const std::string& host_name) {
   return IsValidOtherName(host_name);
@@ -49,6 +49,11 @@ struct MdnsNames {
                                const std::string& service_name,
                                std::string* subtype_out);
 
+  // Returns the full name of the service of which |name| names a subtype. For
+  // example, produces "_foo._tcp.local." from "_bar._sub._foo._tcp.local.".
+  // Returns an empty string if |name| doesn't name a subtype.
+  static std::string SubtypeServiceFullName(const std::string& name);
+
   // Determines if |host_name| is a valid host name.
   static bool IsValidHostName(const std::string& host_name);
 
@@ -22,7 +22,7 @@ class MdnsTransceiver {
  public:
   using LinkChangeCallback = fit::closure;
   using InboundMessageCallback =
-      fit::function<void(std::unique_ptr<DnsMessage>, const ReplyAddress&)>;
+      fit::function<void(const DnsMessageView&, const ReplyAddress&)>;
 
   MdnsTransceiver();
 
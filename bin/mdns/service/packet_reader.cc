@@ -11,7 +11,15 @@
 namespace mdns {
 
 PacketReader::PacketReader(std::vector<uint8_t> packet)
-    : packet_(std::move(packet)), packet_size_(packet_.size()) {}
+    : packet_(std::move(packet)),
+      data_(packet_.data()),
+      size_(packet_.size()),
+      packet_size_(size_) {}
+
+PacketReader::PacketReader(const uint8_t* data, size_t size)
+    : data_(data), size_(size), packet_size_(size) {
+  FXL_DCHECK(data != nullptr || size == 0);
+}
 
 PacketReader::~PacketReader() {}
 
@@ -36,7 +44,7 @@ const uint8_t* PacketReader::Bytes(size_t count) {
     return nullptr;
   }
 
-  const uint8_t* result = packet_.data() + bytes_consumed_;
+  const uint8_t* result = data_ + bytes_consumed_;
   bytes_consumed_ += count;
   return result;
 }
@@ -52,7 +60,7 @@ bool PacketReader::SetBytesConsumed(size_t bytes_consumed) {
 }
 
 bool PacketReader::SetBytesRemaining(size_t bytes_remaining) {
-  if (bytes_remaining + bytes_consumed_ > packet_.size()) {
+  if (bytes_remaining + bytes_consumed_ > size_) {
     healthy_ = false;
     return false;
   }
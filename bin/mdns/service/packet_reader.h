@@ -7,6 +7,8 @@
 
 #include <vector>
 
+#include "lib/fxl/macros.h"
+
 namespace mdns {
 
 // Reads values from a binary packet buffer.
@@ -15,6 +17,10 @@ class PacketReader {
   // Constructs a packet reader.
   PacketReader(std::vector<uint8_t> packet);
 
+  // Constructs a packet reader that reads the |size| bytes at |data| in place.
+  // The bytes must remain valid and unchanged while the reader is in use.
+  PacketReader(const uint8_t* data, size_t size);
+
   ~PacketReader();
 
   // Determines whether this |PacketReader| has been successful so far.
@@ -68,8 +74,13 @@ class PacketReader {
  private:
   bool healthy_ = true;
   std::vector<uint8_t> packet_;
+  const uint8_t* data_;
+  size_t size_;
   size_t packet_size_;
   size_t bytes_consumed_ = 0;
+
+  // |data_| may point into |packet_|, which a copy wouldn't share.
+  FXL_DISALLOW_COPY_AND_ASSIGN(PacketReader);
 };
 
 }  // namespace mdns
@@ -10,23 +10,30 @@
 
 namespace mdns {
 
-PacketWriter::PacketWriter() {}
+namespace {
+
+// Name pointers are 14-bit offsets from the start of the packet.
+static constexpr size_t kMaxPointerPosition = 0x3fff;
+
+}  // namespace
+
+PacketWriter::PacketWriter() { ClearSuffixes(); }
 
 PacketWriter::PacketWriter(std::vector<uint8_t> packet)
-    : packet_(std::move(packet)) {}
+    : packet_(std::move(packet)) {
+  ClearSuffixes();
+}
 
 PacketWriter::~PacketWriter() {}
 
 std::vector<uint8_t> PacketWriter::GetResizedPacket() {
-  position_ = 0;
-  positions_by_label_.clear();
   packet_.resize(position_);
+  Reset();
   return std::move(packet_);
 }
 
 std::vector<uint8_t> PacketWriter::GetPacket() {
-  position_ = 0;
-  positions_by_label_.clear();
+  Reset();
   return std::move(packet_);
 }
 
@@ -46,17 +53,49 @@ void PacketWriter::PutBytes(size_t count, const void* source) {
   position_ += count;
 }
 
-void PacketWriter::CreateBookmark(const std::string& label) {
-  positions_by_label_.emplace(label, position_);
+void PacketWriter::Reset() {
+  position_ = 0;
+  ClearSuffixes();
+}
+
+size_t PacketWriter::FindSuffix(size_t parent, const char* label,
+                                size_t size) const {
+  FXL_DCHECK(parent < suffixes_.size());
+  FXL_DCHECK(label != nullptr || size == 0);
+
+  for (size_t child = suffixes_[parent].first_child_; child != npos;
+       child = suffixes_[child].next_sibling_) {
+    const uint8_t* written = packet_.data() + suffixes_[child].position_;
+    if (written[0] == size && std::memcmp(written + 1, label, size) == 0) {
+      return child;
+    }
+  }
+
+  return npos;
 }
 
-size_t PacketWriter::GetBookmarkPosition(const std::string& label) const {
-  auto iter = positions_by_label_.find(label);
-  if (iter == positions_by_label_.end()) {
+size_t PacketWriter::AddSuffix(size_t parent, size_t position) {
+  FXL_DCHECK(parent < suffixes_.size());
+  FXL_DCHECK(position < position_);
+
+  if (position > kMaxPointerPosition) {
     return npos;
   }
 
-  return iter->second;
+  size_t suffix = suffixes_.size();
+  suffixes_.push_back({position, npos, suffixes_[parent].first_child_});
+  suffixes_[parent].first_child_ = suffix;
+  return suffix;
+}
+
+size_t PacketWriter::SuffixPosition(size_t suffix) const {
+  FXL_DCHECK(suffix != kEmptySuffix && suffix < suffixes_.size());
+  return suffixes_[suffix].position_;
+}
+
+void PacketWriter::ClearSuffixes() {
+  suffixes_.clear();
+  suffixes_.push_back({0, npos, npos});
 }
 
 PacketWriter& PacketWriter::operator<<(bool value) {
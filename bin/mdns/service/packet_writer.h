@@ -6,8 +6,6 @@
 #define GARNET_BIN_MDNS_SERVICE_PACKET_WRITER_H_
 
 #include <limits>
-#include <string>
-#include <unordered_map>
 #include <vector>
 
 namespace mdns {
@@ -17,6 +15,9 @@ class PacketWriter {
  public:
   static constexpr size_t npos = std::numeric_limits<size_t>::max();
 
+  // Identifies the empty suffix. See |FindSuffix|.
+  static constexpr size_t kEmptySuffix = 0;
+
   template <typename T>
   static std::vector<uint8_t> Write(const T& t) {
     PacketWriter writer;
@@ -59,15 +60,31 @@ class PacketWriter {
   // method.
   std::vector<uint8_t> GetPacket();
 
+  // Resets this |PacketWriter| so it can write another packet into the same
+  // buffer. Unlike |GetPacket|, this retains both the buffer and the storage
+  // used to compress names, so a writer that's kept around writes packets
+  // without allocating once it has written the largest of them.
+  void Reset();
+
+  // Returns the written data. |position()| gives its size.
+  const uint8_t* data() const { return packet_.data(); }
+
   // Puts |count| bytes from |source| into the packet.
   void PutBytes(size_t count, const void* source);
 
-  // Creates a bookmark for the current position.
-  void CreateBookmark(const std::string& label);
+  // Finds the name suffix consisting of the |size|-byte label |label|
+  // followed by the suffix |parent|, which is |kEmptySuffix| for the last label
+  // of a name. Returns |npos| if that suffix hasn't been written into the
+  // packet. Labels compare byte-wise against the packet contents.
+  size_t FindSuffix(size_t parent, const char* label, size_t size) const;
 
-  // Gets the position for a bookmark (established by calling |CreateBookmark|).
-  // Returns |npos| if the bookmark isn't found.
-  size_t GetBookmarkPosition(const std::string& label) const;
+  // Records that a label was written at |position| followed by the suffix
+  // |parent|, returning the resulting suffix. Returns |npos| if |position| is
+  // out of reach of a name pointer.
+  size_t AddSuffix(size_t parent, size_t position);
+
+  // Returns the position at which |suffix| was written.
+  size_t SuffixPosition(size_t suffix) const;
 
   PacketWriter& operator<<(bool value);
   PacketWriter& operator<<(uint8_t value);
@@ -81,9 +98,21 @@ class PacketWriter {
   PacketWriter& operator<<(const std::vector<uint8_t>& value);
 
  private:
+  // Node in the trie of name suffixes written into the packet. A node's
+  // children are the suffixes that extend it by one label on the left. Labels
+  // aren't copied; |position_| locates the label's length byte in the packet.
+  struct Suffix {
+    size_t position_;
+    size_t first_child_;
+    size_t next_sibling_;
+  };
+
+  // Clears |suffixes_| down to the node for the empty suffix.
+  void ClearSuffixes();
+
   std::vector<uint8_t> packet_;
   size_t position_ = 0;
-  std::unordered_map<std::string, size_t> positions_by_label_;
+  std::vector<Suffix> suffixes_;
 };
 
 }  // namespace mdns
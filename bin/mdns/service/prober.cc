@@ -25,6 +25,7 @@ Prober::~Prober() {}
 void Prober::Start(const std::string& host_full_name) {
   FXL_DCHECK(!host_full_name.empty());
   host_full_name_ = host_full_name;
+  SubscribeToName(ResourceName());
 
   question_ = std::make_shared<DnsQuestion>(ResourceName(), DnsType::kAny);
   question_->unicast_response_ = true;
@@ -21,11 +21,11 @@ ResourceRenewer::~ResourceRenewer() {
 void ResourceRenewer::Renew(const DnsResource& resource) {
   FXL_DCHECK(resource.time_to_live_ != 0);
 
-  Entry key(resource.name_.dotted_string_, resource.type_);
+  Entry key(resource.name_, resource.type_);
   auto iter = entries_.find(&key);
 
   if (iter == entries_.end()) {
-    Entry* entry = new Entry(resource.name_.dotted_string_, resource.type_);
+    Entry* entry = new Entry(resource.name_, resource.type_);
     entry->SetFirstQuery(resource.time_to_live_);
 
     Schedule(entry);
@@ -45,7 +45,7 @@ void ResourceRenewer::ReceiveResource(const DnsResource& resource,
                                       MdnsResourceSection section) {
   FXL_DCHECK(section != MdnsResourceSection::kExpired);
 
-  Entry key(resource.name_.dotted_string_, resource.type_);
+  Entry key(resource.name_, resource.type_);
   auto iter = entries_.find(&key);
   if (iter != entries_.end()) {
     (*iter)->delete_ = true;
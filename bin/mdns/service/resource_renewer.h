@@ -61,9 +61,13 @@ class ResourceRenewer : public MdnsAgent {
     static constexpr uint32_t kQueryIntervalPerThousand = 50;
     static constexpr uint32_t kQueriesToAttempt = 4;
 
-    Entry(const std::string& name, DnsType type) : name_(name), type_(type) {}
+    Entry(const DnsName& name, DnsType type)
+        : name_(name.dotted_string_), key_(name.key()), type_(type) {}
 
     std::string name_;
+    // Keeps the name interned while it's being renewed. Inbound resources
+    // with names no |DnsName| holds aren't decoded.
+    std::shared_ptr<const std::string> key_;
     DnsType type_;
 
     fxl::TimePoint time_;
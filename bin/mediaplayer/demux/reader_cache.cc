@@ -4,16 +4,48 @@
 
 #include "garnet/bin/mediaplayer/demux/reader_cache.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "lib/async/cpp/task.h"
+#include "lib/async/cpp/time.h"
 #include "lib/async/default.h"
 #include "lib/fxl/logging.h"
 
 namespace media_player {
 namespace {
 
-// TODO(turnage): Intelligently choose this by observing read times from the
-// upstream reader and whether our reads block the demuxer.
-static constexpr size_t kChunkSize = 256 * 1024;
+static constexpr size_t kPageSize = SparseByteBuffer::kPageSize;
+
+// The capacity is never set below enough pages to give each cursor room for
+// read-ahead and backtrack.
+static constexpr size_t kMinCapacity = ReaderCache::kMaxCursors * 8 * kPageSize;
+
+// Upstream requests are sized to take about this long at the observed
+// bandwidth, so fast readers are asked for large ranges while slow readers
+// deliver the first bytes of a request promptly.
+static constexpr zx::duration kRequestDuration = zx::msec(500);
+static constexpr size_t kMaxRequestSize = 4 * 1024 * 1024;
+
+// Requests for a cursor are at most this many times the size of the data
+// already loaded ahead of it.
+static constexpr size_t kLeadRequestFactor = 2;
+
+// Each cursor loads ahead as far as the upstream reader can deliver in this
+// time. Loading further ahead of one cursor would only delay loads for the
+// others.
+static constexpr zx::duration kReadAheadDuration = zx::sec(5);
+static constexpr size_t kMinReadAhead = 4 * kPageSize;
+
+// Cursors that haven't been read from for this long are dropped when a new
+// cursor is needed.
+static constexpr zx::duration kCursorIdleTimeout = zx::sec(5);
+
+size_t PageStart(size_t position) { return position - position % kPageSize; }
+
+size_t PageEnd(size_t position) {
+  return PageStart(position + kPageSize - 1);
+}
 
 }  // namespace
 
@@ -24,7 +56,8 @@ std::shared_ptr<ReaderCache> ReaderCache::Create(
 }
 
 ReaderCache::ReaderCache(std::shared_ptr<Reader> upstream_reader)
-    : upstream_reader_(upstream_reader),
+    : load_is_complete_(async_get_default_dispatcher()),
+      upstream_reader_(upstream_reader),
       dispatcher_(async_get_default_dispatcher()) {
   upstream_reader_->Describe([this, upstream_reader](Result result, size_t size,
                                                      bool can_seek) {
@@ -33,7 +66,11 @@ ReaderCache::ReaderCache(std::shared_ptr<Reader> upstream_reader)
     last_result_ = result;
     buffer_.Initialize(size);
 
-    async::PostTask(dispatcher_, [this]() { MaybeStartLoadForPosition(0); });
+    async::PostTask(dispatcher_, [this]() {
+      // Demuxers start reading at the beginning of the asset.
+      UpdateCursors(0);
+      MaybeStartLoad();
+    });
 
     describe_is_complete_.Occur();
   });
@@ -58,7 +95,8 @@ void ReaderCache::ReadAt(size_t position, uint8_t* buffer, size_t bytes_to_read,
 
     size_t bytes_read = buffer_.ReadRange(position, bytes_to_read, buffer);
 
-    MaybeStartLoadForPosition(position);
+    UpdateCursors(position);
+    MaybeStartLoad();
 
     size_t remaining_bytes = upstream_size_ - position;
     if ((bytes_read == bytes_to_read) || (bytes_read == remaining_bytes)) {
@@ -66,92 +104,216 @@ void ReaderCache::ReadAt(size_t position, uint8_t* buffer, size_t bytes_to_read,
       return;
     }
 
+    // |load_is_complete_| posts its consequences, so this retry runs after
+    // the incident is reset. A failed load fails the read rather than
+    // retrying it forever.
     load_is_complete_.When([this, position, buffer, bytes_to_read,
                             callback = std::move(callback)]() mutable {
+      if (last_result_ != Result::kOk) {
+        callback(last_result_, 0);
+        return;
+      }
+
       ReadAt(position, buffer, bytes_to_read, std::move(callback));
     });
   });
 }
 
 void ReaderCache::SetCacheOptions(size_t capacity, size_t max_backtrack) {
-  capacity_ = capacity;
+  FXL_DCHECK(max_backtrack < capacity);
+  capacity_ = std::max(capacity, kMinCapacity);
   max_backtrack_ = max_backtrack;
 }
 
-void ReaderCache::MaybeStartLoadForPosition(size_t position) {
-  std::pair<size_t, size_t> cache_range = CalculateCacheRange(position);
-  load_position_ = cache_range.first;
+void ReaderCache::UpdateCursors(size_t position) {
+  zx::time now = async::Now(dispatcher_);
 
-  if (load_in_progress_) {
+  for (auto& cursor : cursors_) {
+    std::pair<size_t, size_t> range = CalculateCacheRange(cursor);
+    if (position >= range.first && position < range.first + range.second) {
+      cursor.position_ = position;
+      cursor.last_read_time_ = now;
+      return;
+    }
+  }
+
+  cursors_.erase(std::remove_if(cursors_.begin(), cursors_.end(),
+                                [now](const Cursor& cursor) {
+                                  return now - cursor.last_read_time_ >
+                                         kCursorIdleTimeout;
+                                }),
+                 cursors_.end());
+
+  if (cursors_.size() < kMaxCursors) {
+    cursors_.push_back({position, now});
     return;
   }
 
-  std::vector<SparseByteBuffer::Hole> holes_in_cache =
-      buffer_.FindOrCreateHolesInRange(cache_range.first, cache_range.second);
+  auto least_recent =
+      std::min_element(cursors_.begin(), cursors_.end(),
+                       [](const Cursor& a, const Cursor& b) {
+                         return a.last_read_time_ < b.last_read_time_;
+                       });
+  *least_recent = {position, now};
+}
 
-  if (holes_in_cache.empty()) {
+void ReaderCache::MaybeStartLoad() {
+  if (load_in_progress_ || cursors_.empty()) {
     return;
   }
 
-  load_in_progress_ = true;
-  size_t bytes_needed = 0;
-  for (auto& hole : holes_in_cache) {
-    bytes_needed += hole.size();
+  // Find the first hole ahead of the cursor with the least data loaded ahead
+  // of it.
+  cache_ranges_.clear();
+  std::pair<size_t, size_t> load_range(0, 0);
+  size_t least_lead = std::numeric_limits<size_t>::max();
+  for (auto& cursor : cursors_) {
+    std::pair<size_t, size_t> range = CalculateCacheRange(cursor);
+    cache_ranges_.push_back(range);
+
+    size_t start = PageStart(cursor.position_);
+    std::pair<size_t, size_t> gap = buffer_.FindFirstGapInRange(
+        start, range.first + range.second - start);
+    if (gap.second == 0) {
+      continue;
+    }
+
+    size_t lead =
+        gap.first > cursor.position_ ? gap.first - cursor.position_ : 0;
+    if (lead < least_lead) {
+      least_lead = lead;
+      load_range = gap;
+    }
   }
 
-  buffer_.CleanUpExcept(bytes_needed, cache_range.first, cache_range.second);
-  holes_in_cache =
-      buffer_.FindOrCreateHolesInRange(cache_range.first, cache_range.second);
+  if (load_range.second == 0) {
+    return;
+  }
 
-  FillHoles(holes_in_cache, cache_range.first, [this, cache_range]() {
-    load_in_progress_ = false;
-    load_is_complete_.Occur();
-    load_is_complete_.Reset();
-  });
+  // A cursor with little data ahead of it gets a short request, which arrives
+  // sooner. Requests for it grow as it gains a lead, as after a seek.
+  size_t load_size = std::min(
+      {load_range.second, RequestSize(),
+       std::max(kPageSize, PageEnd(least_lead * kLeadRequestFactor))});
+
+  // Make room by freeing pages outside all cache ranges.
+  if (buffer_.bytes_cached() + load_size > capacity_) {
+    buffer_.FreeRegionsOutside(buffer_.bytes_cached() + load_size - capacity_,
+                               cache_ranges_);
+    if (buffer_.bytes_cached() + load_size > capacity_) {
+      // Reads may be waiting for this load, so load at least the first page
+      // of the hole even if that exceeds the capacity. The cache shrinks back
+      // as cursors move on.
+      size_t room = capacity_ > buffer_.bytes_cached()
+                        ? capacity_ - buffer_.bytes_cached()
+                        : 0;
+      load_size = std::max(PageStart(room),
+                           std::min(load_size, PageEnd(load_range.first + 1) -
+                                                   load_range.first));
+    }
+  }
+
+  Load(load_range.first, load_size);
 }
 
-void ReaderCache::FillHoles(std::vector<SparseByteBuffer::Hole> holes,
-                            size_t load_position, fit::closure callback) {
-  std::vector<uint8_t> buffer(holes.back().size());
+void ReaderCache::Load(size_t position, size_t size) {
+  FXL_DCHECK(!load_in_progress_);
+  FXL_DCHECK(size != 0);
+
+  load_in_progress_ = true;
+  load_buffer_.resize(size);
+  zx::time start_time = async::Now(dispatcher_);
+
   upstream_reader_->ReadAt(
-      holes.back().position(), buffer.data(), holes.back().size(),
-      [this, holes, load_position, buffer = std::move(buffer),
-       callback = std::move(callback)](Result result,
-                                       size_t bytes_read) mutable {
+      position, load_buffer_.data(), size,
+      [this, position, start_time](Result result, size_t bytes_read) {
         last_result_ = result;
         if (result != Result::kOk) {
           FXL_LOG(ERROR) << "ReadAt failed!";
+        } else {
+          UpdateBandwidth(bytes_read, async::Now(dispatcher_) - start_time);
         }
-        buffer_.Fill(holes.back(), std::move(buffer));
 
-        holes.pop_back();
-        if (holes.empty()) {
-          callback();
-          return;
-        }
+        StorePages(position, bytes_read);
 
-        if (load_position != load_position_) {
-          FXL_LOG(INFO) << "Abandoning load for " << load_position
-                        << " to load " << load_position_;
-          callback();
-          return;
-        }
+        load_in_progress_ = false;
+        load_is_complete_.Occur();
+        load_is_complete_.Reset();
 
-        FillHoles(holes, load_position, std::move(callback));
+        // Keep loading ahead unless the upstream reader has stopped making
+        // progress, in which case the next |ReadAt| tries again.
+        if (result == Result::kOk && bytes_read != 0) {
+          MaybeStartLoad();
+        }
       });
 }
 
-std::pair<size_t, size_t> ReaderCache::CalculateCacheRange(size_t position) {
+void ReaderCache::StorePages(size_t position, size_t size) {
+  SparseByteBuffer::Hole hole = buffer_.null_hole();
+  for (size_t offset = 0; offset < size;) {
+    // The load started at the start of a page, except possibly when a
+    // previous load ended short of the end of a page.
+    size_t page_size = std::min(PageEnd(position + offset + 1) -
+                                    (position + offset),
+                                size - offset);
+    hole = buffer_.FindOrCreateHole(position + offset, hole);
+
+    std::vector<uint8_t> page = buffer_.AllocatePage();
+    page.assign(load_buffer_.data() + offset,
+                load_buffer_.data() + offset + page_size);
+    hole = buffer_.Fill(hole, std::move(page));
+
+    offset += page_size;
+  }
+}
+
+void ReaderCache::UpdateBandwidth(size_t bytes, zx::duration elapsed) {
+  if (bytes == 0) {
+    return;
+  }
+
+  uint64_t sample = bytes * ZX_SEC(1) /
+                    std::max(elapsed.get(), static_cast<zx_duration_t>(1));
+
+  // Weigh the latest sample equally with the history, so the estimate follows
+  // changing conditions quickly.
+  bytes_per_second_ =
+      bytes_per_second_ == 0 ? sample : (bytes_per_second_ + sample) / 2;
+}
+
+size_t ReaderCache::BytesIn(zx::duration duration) const {
+  return bytes_per_second_ / 1000 * duration.to_msecs();
+}
+
+size_t ReaderCache::ReadAheadSize() const {
+  return std::max(kMinReadAhead, PageEnd(BytesIn(kReadAheadDuration)));
+}
+
+size_t ReaderCache::RequestSize() const {
+  return std::max(kPageSize,
+                  std::min(PageStart(BytesIn(kRequestDuration)),
+                           kMaxRequestSize));
+}
+
+std::pair<size_t, size_t> ReaderCache::CalculateCacheRange(
+    const Cursor& cursor) const {
   if (upstream_size_ <= capacity_) {
     return {0, upstream_size_};
   }
 
-  size_t chunk_position = position - (position % kChunkSize);
-  size_t cache_start =
-      chunk_position > max_backtrack_ ? chunk_position - max_backtrack_ : 0;
+  FXL_DCHECK(!cursors_.empty());
+
+  // Leave two pages of slack per cursor for page alignment.
+  size_t budget = capacity_ / cursors_.size() - 2 * kPageSize;
+  size_t backtrack = std::min(max_backtrack_, budget / 2);
+  size_t read_ahead = std::min(ReadAheadSize(), budget - backtrack);
+
+  size_t cache_start = PageStart(
+      cursor.position_ > backtrack ? cursor.position_ - backtrack : 0);
+  size_t cache_end =
+      std::min(PageEnd(cursor.position_ + read_ahead), upstream_size_);
 
-  return {cache_start,
-          std::min(capacity_ - max_backtrack_, upstream_size_ - cache_start)};
+  return {cache_start, cache_end - cache_start};
 }
 
 }  // namespace media_player
@@ -6,6 +6,10 @@
 #define GARNET_BIN_MEDIAPLAYER_DEMUX_READER_CACHE_H_
 
 #include <memory>
+#include <utility>
+#include <vector>
+
+#include <lib/zx/time.h>
 
 #include "garnet/bin/mediaplayer/demux/reader.h"
 #include "garnet/bin/mediaplayer/demux/sparse_byte_buffer.h"
@@ -20,14 +24,25 @@ namespace media_player {
 //
 // ReaderCache is backed by a SparseByteBuffer which tracks holes (spans of the
 // asset that haven't been read) and regions (spans of the asset that have been
-// read). See SparseByteBuffer for details.
+// read). See SparseByteBuffer for details. Regions are stored in pages of
+// |SparseByteBuffer::kPageSize| bytes aligned to multiples of that size.
 //
 // ReaderCache will serve ReadAt requests from its in-memory cache, and maintain
 // its cache asynchronously using the upstream reader on a schedule determined
 // by the cache options (see SetCacheOptions).
+//
+// Demuxers read each active stream more or less sequentially, interleaving
+// reads from different parts of the asset. ReaderCache tracks up to
+// |kMaxCursors| read positions (cursors) and loads ahead of each of them,
+// always filling the cursor with the least data loaded ahead of it first. The
+// distance loaded ahead and the size of upstream requests adapt to the
+// bandwidth observed from the upstream reader.
 class ReaderCache : public Reader,
                     public std::enable_shared_from_this<ReaderCache> {
  public:
+  // Maximum number of read positions for which data is loaded ahead.
+  static constexpr size_t kMaxCursors = 4;
+
   static std::shared_ptr<ReaderCache> Create(
       std::shared_ptr<Reader> upstream_reader);
 
@@ -44,29 +59,61 @@ class ReaderCache : public Reader,
   // Configures the |ReaderCache| to respect the given memory budget. |capacity|
   // is the amount of memory |ReaderCache| is allowed to spend caching the
   // upstream |Reader|'s content. |max_backtrack| is the amount of memory that
-  // |ReaderCache| will maintain behind the |ReadAt| point (for skipping back).
-  // |max_backtrack| must be less than |capacity|.
+  // |ReaderCache| will maintain behind each cursor (for skipping back).
+  // |max_backtrack| must be less than |capacity|. The capacity is shared
+  // evenly among the cursors.
   void SetCacheOptions(size_t capacity, size_t max_backtrack);
 
+  // Returns the current estimate of the upstream reader's bandwidth in bytes
+  // per second, or zero if no estimate is available yet.
+  size_t bytes_per_second() const { return bytes_per_second_; }
+
  private:
+  // A position at which a demuxer is reading.
+  struct Cursor {
+    size_t position_;
+    zx::time last_read_time_;
+  };
+
+  // Moves the cursor whose cache range contains |position| to |position|.
+  // If there is no such cursor, adds one, replacing the least recently used
+  // cursor if there are already |kMaxCursors|.
+  void UpdateCursors(size_t position);
+
   // Loads if 1) No load is in progress already. 2) There are holes in the
-  // desired cache range for this position which require filling.
+  // desired cache range of some cursor.
   //
-  // Starts a load from the upstream |Reader| into our buffer over the given
-  // range. 1) Cleans up memory outside the desired range to pay for the new
-  // allocations. 2) Makes async calls for the upstream |Reader| to fill all the
-  // holes in the desired cache range. 3) Runs any |ReadAt| call queued on this
-  // reload.
-  void MaybeStartLoadForPosition(size_t position);
-
-  // Makes async calls to the upstream Reader to fill the given holes in our
-  // underlying buffer. Calls callback on completion.
-  void FillHoles(std::vector<SparseByteBuffer::Hole> holes,
-                 size_t load_position, fit::closure callback);
+  // Starts a load from the upstream |Reader| into the first hole ahead of the
+  // cursor with the least data loaded ahead of it. Frees regions outside the
+  // cache ranges of all cursors to pay for the new pages. If that doesn't make
+  // room, loads a single page anyway, so reads waiting for it don't stall.
+  void MaybeStartLoad();
+
+  // Reads |size| bytes at |position| from the upstream reader into pages.
+  // Starts another load when done.
+  void Load(size_t position, size_t size);
+
+  // Fills the holes in the |size| bytes at |position| with pages copied from
+  // |load_buffer_|.
+  void StorePages(size_t position, size_t size);
+
+  // Updates |bytes_per_second_| with an upstream read of |bytes| that took
+  // |elapsed|.
+  void UpdateBandwidth(size_t bytes, zx::duration elapsed);
+
+  // Returns the number of bytes the upstream reader is expected to deliver in
+  // |duration|.
+  size_t BytesIn(zx::duration duration) const;
+
+  // Returns the number of bytes to load ahead of each cursor.
+  size_t ReadAheadSize() const;
+
+  // Returns the number of bytes to request from the upstream reader at once.
+  size_t RequestSize() const;
 
   // Calculates the desired cache range according to our cache options around
-  // the requested read position.
-  std::pair<size_t, size_t> CalculateCacheRange(size_t position);
+  // |cursor|. The range is aligned to pages.
+  std::pair<size_t, size_t> CalculateCacheRange(const Cursor& cursor) const;
 
   // |buffer_| is the underlying storage for the cache.
   SparseByteBuffer buffer_;
@@ -86,8 +133,14 @@ class ReaderCache : public Reader,
 
   async_dispatcher_t* dispatcher_;
 
+  std::vector<Cursor> cursors_;
   bool load_in_progress_ = false;
-  size_t load_position_;
+  // Receives data from the upstream reader before it's copied into pages.
+  // Retains its storage from one load to the next.
+  std::vector<uint8_t> load_buffer_;
+  // Cache ranges of the cursors, retained to avoid reallocation.
+  std::vector<std::pair<size_t, size_t>> cache_ranges_;
+  size_t bytes_per_second_ = 0;
 };
 
 }  // namespace media_player
@@ -3,7 +3,7 @@
 // found in the LICENSE file.
 
 #include <algorithm>
-#include <iterator>
+#include <limits>
 
 #include "garnet/bin/mediaplayer/demux/sparse_byte_buffer.h"
 
@@ -38,10 +38,33 @@ void SparseByteBuffer::Initialize(size_t size) {
   holes_.clear();
   regions_.clear();
   size_ = size;
+  bytes_cached_ = 0;
   // Create one hole spanning the entire buffer.
   holes_[0] = size_;
 }
 
+std::vector<uint8_t> SparseByteBuffer::AllocatePage() {
+  if (free_pages_.empty()) {
+    std::vector<uint8_t> page;
+    page.reserve(kPageSize);
+    return page;
+  }
+
+  std::vector<uint8_t> page = std::move(free_pages_.back());
+  free_pages_.pop_back();
+  FXL_DCHECK(page.empty());
+  return page;
+}
+
+void SparseByteBuffer::RecyclePage(std::vector<uint8_t>&& buffer) {
+  if (buffer.capacity() != kPageSize || free_pages_.size() >= kMaxFreePages) {
+    return;
+  }
+
+  buffer.clear();
+  free_pages_.push_back(std::move(buffer));
+}
+
 size_t SparseByteBuffer::ReadRange(size_t start, size_t size,
                                    uint8_t* dest_buffer) {
   FXL_DCHECK(start < size_);
@@ -50,10 +73,13 @@ size_t SparseByteBuffer::ReadRange(size_t start, size_t size,
   size_t copied = 0;
   size_t end = start + size;
 
-  RegionsIter iter = regions_.lower_bound(start);
-  if (iter != regions_.begin()) {
-    --iter;
+  // Start with the last region that starts at or before |start|. If that
+  // region doesn't contain |start|, the loop below stops without copying.
+  RegionsIter iter = regions_.upper_bound(start);
+  if (iter == regions_.begin()) {
+    return 0;
   }
+  --iter;
 
   size_t last_region_end = iter->first;
   while (iter != regions_.end() && iter->first == last_region_end &&
@@ -165,6 +191,28 @@ SparseByteBuffer::Hole SparseByteBuffer::FindHoleContaining(size_t position) {
   return Hole(iter);
 }
 
+std::pair<size_t, size_t> SparseByteBuffer::FindFirstGapInRange(size_t start,
+                                                               size_t size) {
+  FXL_DCHECK(start < size_);
+
+  size_t end = std::min(start + size, size_);
+  HolesIter iter = holes_.upper_bound(start);
+  if (iter != holes_.begin()) {
+    // Check the hole before |start|, which may contain it.
+    --iter;
+    if (iter->first + iter->second <= start) {
+      ++iter;
+    }
+  }
+
+  if (iter == holes_.end() || iter->first >= end) {
+    return {end, 0};
+  }
+
+  size_t gap_start = std::max(iter->first, start);
+  return {gap_start, std::min(iter->first + iter->second, end) - gap_start};
+}
+
 std::vector<SparseByteBuffer::Hole> SparseByteBuffer::FindOrCreateHolesInRange(
     size_t start, size_t size) {
   FXL_DCHECK(start < size_);
@@ -215,6 +263,7 @@ SparseByteBuffer::Hole SparseByteBuffer::Fill(Hole hole,
 
   size_t buffer_size = buffer.size();
   size_t position = holes_iter->first;
+  bytes_cached_ += buffer_size;
 
   regions_.emplace(std::make_pair(position, std::move(buffer)));
 
@@ -307,6 +356,53 @@ size_t SparseByteBuffer::CleanUpExcept(size_t goal, size_t protected_start,
   return goal - to_free;
 }
 
+size_t SparseByteBuffer::FreeRegionsOutside(
+    size_t goal,
+    const std::vector<std::pair<size_t, size_t>>& protected_ranges) {
+  // Find the unprotected regions and their distances from the nearest
+  // protected range.
+  std::vector<std::pair<size_t, RegionsIter>> candidates;
+  for (RegionsIter iter = regions_.begin(); iter != regions_.end(); ++iter) {
+    size_t region_start = iter->first;
+    size_t region_end = iter->first + iter->second.size();
+    size_t distance = std::numeric_limits<size_t>::max();
+
+    for (auto& range : protected_ranges) {
+      size_t range_end = range.first + range.second;
+      if (region_end <= range.first) {
+        distance = std::min(distance, range.first - region_end);
+      } else if (region_start >= range_end) {
+        distance = std::min(distance, region_start - range_end);
+      } else {
+        distance = 0;
+        break;
+      }
+    }
+
+    if (distance != 0) {
+      candidates.emplace_back(distance, iter);
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const std::pair<size_t, RegionsIter>& a,
+               const std::pair<size_t, RegionsIter>& b) {
+              return a.first > b.first;
+            });
+
+  size_t freed = 0;
+  for (auto& candidate : candidates) {
+    if (freed >= goal) {
+      break;
+    }
+
+    freed += candidate.second->second.size();
+    Free(Region(candidate.second));
+  }
+
+  return freed;
+}
+
 SparseByteBuffer::Region SparseByteBuffer::ShrinkRegionFront(
     Region region, size_t shrink_amount) {
   FXL_DCHECK(region != null_region());
@@ -331,15 +427,19 @@ SparseByteBuffer::Region SparseByteBuffer::ShrinkRegionFront(
     holes_.emplace(region.position(), shrink_amount);
   }
 
+  // Move the remaining bytes to the front of the region's storage and re-key
+  // the region, keeping both the storage and the map node.
   size_t region_pos = region.position() + shrink_amount;
-  std::vector<uint8_t> buffer;
-  std::copy_n(region.iter_->second.begin() + shrink_amount,
-              region.size() - shrink_amount, std::back_inserter(buffer));
-  regions_.erase(region.iter_);
-  auto result = regions_.emplace(region_pos, buffer);
-  FXL_DCHECK(result.second);
+  std::vector<uint8_t>& buffer = region.iter_->second;
+  buffer.erase(buffer.begin(), buffer.begin() + shrink_amount);
+  bytes_cached_ -= shrink_amount;
+
+  auto node = regions_.extract(region.iter_);
+  node.key() = region_pos;
+  auto result = regions_.insert(std::move(node));
+  FXL_DCHECK(result.inserted);
 
-  return Region(result.first);
+  return Region(result.position);
 }
 
 SparseByteBuffer::Region SparseByteBuffer::ShrinkRegionBack(
@@ -365,6 +465,7 @@ SparseByteBuffer::Region SparseByteBuffer::ShrinkRegionBack(
   holes_.emplace(region.position() + region.size() - shrink_amount,
                  shrink_amount + hole_addendum);
   region.iter_->second.resize(region.size() - shrink_amount);
+  bytes_cached_ -= shrink_amount;
 
   return region;
 }
@@ -383,6 +484,8 @@ SparseByteBuffer::Hole SparseByteBuffer::Free(Region region) {
   size_t hole_position = region.position();
   size_t hole_size = region.size();
 
+  bytes_cached_ -= hole_size;
+  RecyclePage(std::move(region.iter_->second));
   regions_.erase(region.iter_);
 
   if (hole_after != null_hole() &&
@@ -6,12 +6,17 @@
 #define GARNET_BIN_MEDIAPLAYER_DEMUX_SPARSE_BYTE_BUFFER_H_
 
 #include <map>
+#include <utility>
 #include <vector>
 
 namespace media_player {
 
 class SparseByteBuffer {
  public:
+  // Capacity of the buffers returned by |AllocatePage|. The storage of freed
+  // regions with this capacity is retained for reuse.
+  static constexpr size_t kPageSize = 64 * 1024;
+
   struct Hole {
     Hole();
     Hole(const Hole& other);
@@ -60,6 +65,19 @@ class SparseByteBuffer {
   // Initialized the buffer.
   void Initialize(size_t size);
 
+  // Returns the number of bytes held in regions.
+  size_t bytes_cached() const { return bytes_cached_; }
+
+  // Returns an empty buffer with capacity |kPageSize| for use with |Fill|,
+  // reusing the storage of a freed region if one is available.
+  std::vector<uint8_t> AllocatePage();
+
+  // Returns the first gap (position and size) in the range of |size| bytes
+  // starting at |start|, clipped to the range. The returned size is zero if
+  // the range is entirely filled. Unlike |FindOrCreateHolesInRange|, this
+  // doesn't split holes.
+  std::pair<size_t, size_t> FindFirstGapInRange(size_t start, size_t size);
+
   // Reads a range of data from the SparseBuffer, which may span multiple
   // regions. Reading will begin at |start| in the SparseBuffer and stop when
   // |size| bytes have been copied into |dest_buffer| or a hole in the
@@ -105,8 +123,18 @@ class SparseByteBuffer {
   size_t CleanUpExcept(size_t goal, size_t protected_start,
                        size_t protected_size);
 
+  // Frees regions that don't intersect any of |protected_ranges| (positions
+  // and sizes) until |goal| bytes have been freed or nothing remains to free.
+  // Returns the bytes actually freed. Regions farther from the nearest
+  // protected range are freed first. Unlike |CleanUpExcept|, this never
+  // shrinks regions, so page-sized regions remain pages.
+  size_t FreeRegionsOutside(
+      size_t goal,
+      const std::vector<std::pair<size_t, size_t>>& protected_ranges);
+
   // Shrinks the front of a region (e.g. shrinking [{1, 2, 3}] by 1 yields
-  // [hole, {2, 3}]). This may require a copy. Returns an updated Region handle.
+  // [hole, {2, 3}]). The remaining bytes are moved within the region's
+  // storage. Returns an updated Region handle.
   // The handle is equal to null_region() if the region was shrunk by its whole
   // size and therefore freed.
   Region ShrinkRegionFront(Region region, size_t shrink_amount);
@@ -124,7 +152,15 @@ class SparseByteBuffer {
   using HolesIter = std::map<size_t, size_t>::iterator;
   using RegionsIter = std::map<size_t, std::vector<uint8_t>>::iterator;
 
+  // Limits the number of pages retained by |RecyclePage|.
+  static constexpr size_t kMaxFreePages = 16;
+
+  // Retains |buffer| for reuse by |AllocatePage| if it's a page.
+  void RecyclePage(std::vector<uint8_t>&& buffer);
+
   size_t size_ = 0u;
+  size_t bytes_cached_ = 0u;
+  std::vector<std::vector<uint8_t>> free_pages_;
   std::map<size_t, size_t> holes_;                  // Hole sizes by position.
   std::map<size_t, std::vector<uint8_t>> regions_;  // Buffers by position.
 };
@@ -0,0 +1,285 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/bin/mediaplayer/demux/reader_cache.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <lib/async/cpp/task.h>
+#include <lib/async/cpp/time.h>
+
+#include "gtest/gtest.h"
+#include "lib/gtest/test_loop_fixture.h"
+
+namespace media_player {
+namespace {
+
+static constexpr size_t kAssetSize = 64 * 1024 * 1024;
+static constexpr size_t kReadSize = 32 * 1024;
+
+// Reads that take longer than this on the fake clock are considered stalled.
+static constexpr zx::duration kReadTimeout = zx::sec(10);
+
+uint8_t ByteForPosition(size_t position) {
+  return static_cast<uint8_t>(position ^ (position >> 8) ^ (position >> 16) ^
+                              (position >> 24));
+}
+
+// Reader which serves a synthetic asset over a simulated connection with fixed
+// latency and bandwidth. Requests are served one at a time in the order they
+// were made.
+class ThrottledReader : public Reader {
+ public:
+  ThrottledReader(async_dispatcher_t* dispatcher, zx::duration latency,
+                  size_t bytes_per_second)
+      : dispatcher_(dispatcher),
+        latency_(latency),
+        bytes_per_second_(bytes_per_second) {}
+
+  size_t request_count() const { return request_count_; }
+
+  size_t bytes_requested() const { return bytes_requested_; }
+
+  size_t first_request_size() const { return first_request_size_; }
+
+  size_t max_request_size() const { return max_request_size_; }
+
+  // Makes all subsequent requests fail.
+  void Fail() { fail_ = true; }
+
+  // Reader implementation.
+  void Describe(DescribeCallback callback) override {
+    callback(Result::kOk, kAssetSize, true);
+  }
+
+  void ReadAt(size_t position, uint8_t* buffer, size_t bytes_to_read,
+              ReadAtCallback callback) override {
+    if (fail_) {
+      async::PostTask(dispatcher_, [callback = std::move(callback)]() {
+        callback(Result::kUnknownError, 0);
+      });
+      return;
+    }
+
+    size_t bytes_read = std::min(bytes_to_read, kAssetSize - position);
+    if (request_count_++ == 0) {
+      first_request_size_ = bytes_read;
+    }
+    bytes_requested_ += bytes_read;
+    max_request_size_ = std::max(max_request_size_, bytes_read);
+
+    busy_until_ = std::max(busy_until_, async::Now(dispatcher_)) + latency_ +
+                  zx::nsec(bytes_read * ZX_SEC(1) / bytes_per_second_);
+
+    async::PostTaskForTime(
+        dispatcher_,
+        [position, buffer, bytes_read, callback = std::move(callback)]() {
+          for (size_t i = 0; i < bytes_read; ++i) {
+            buffer[i] = ByteForPosition(position + i);
+          }
+
+          callback(Result::kOk, bytes_read);
+        },
+        busy_until_);
+  }
+
+ private:
+  async_dispatcher_t* dispatcher_;
+  zx::duration latency_;
+  size_t bytes_per_second_;
+  zx::time busy_until_;
+  size_t request_count_ = 0;
+  size_t bytes_requested_ = 0;
+  size_t first_request_size_ = 0;
+  size_t max_request_size_ = 0;
+  bool fail_ = false;
+};
+
+class ReaderCacheTest : public ::gtest::TestLoopFixture {
+ protected:
+  // Creates the cache over a reader with the given characteristics.
+  void CreateCache(zx::duration latency, size_t bytes_per_second) {
+    upstream_ = std::make_shared<ThrottledReader>(dispatcher(), latency,
+                                                  bytes_per_second);
+    under_test_ = ReaderCache::Create(upstream_);
+  }
+
+  // A read through the cache. Shared with the read's callback, so a stalled
+  // read doesn't refer to a destroyed buffer if it completes later.
+  struct PendingRead {
+    std::vector<uint8_t> buffer;
+    bool done = false;
+    Result result = Result::kOk;
+    size_t bytes_read = 0;
+  };
+
+  // Reads through the cache, running the loop until the read completes or
+  // |kReadTimeout| passes on the fake clock.
+  std::shared_ptr<PendingRead> StartRead(size_t position, size_t size) {
+    auto read = std::make_shared<PendingRead>();
+    read->buffer.resize(size);
+
+    under_test_->ReadAt(position, read->buffer.data(), size,
+                        [read](Result result, size_t bytes_read) {
+                          read->result = result;
+                          read->bytes_read = bytes_read;
+                          read->done = true;
+                        });
+
+    RunLoopUntilIdle();
+    zx::time deadline = Now() + kReadTimeout;
+    while (!read->done && Now() < deadline) {
+      RunLoopFor(zx::msec(1));
+    }
+
+    return read;
+  }
+
+  // Reads through the cache, checks the data and returns how long the read
+  // took on the fake clock.
+  zx::duration Read(size_t position, size_t size = kReadSize) {
+    zx::time start = Now();
+    std::shared_ptr<PendingRead> read = StartRead(position, size);
+    if (!read->done) {
+      ADD_FAILURE() << "Read at position " << position << " stalled";
+      return Now() - start;
+    }
+
+    EXPECT_EQ(Result::kOk, read->result);
+    EXPECT_EQ(size, read->bytes_read);
+
+    const std::vector<uint8_t>& buffer = read->buffer;
+    for (size_t i = 0; i < size; ++i) {
+      if (buffer[i] != ByteForPosition(position + i)) {
+        ADD_FAILURE() << "Wrong data at position " << position + i;
+        break;
+      }
+    }
+
+    return Now() - start;
+  }
+
+  // Records |value| in the test's results.
+  void Report(const std::string& name, zx::duration value) {
+    RecordProperty(name + "_ms", static_cast<int>(value.to_msecs()));
+  }
+
+  std::shared_ptr<ThrottledReader> upstream_;
+  std::shared_ptr<ReaderCache> under_test_;
+};
+
+// The first read is served by a small request rather than waiting for a whole
+// cache range to load.
+TEST_F(ReaderCacheTest, StartupLatency) {
+  CreateCache(zx::msec(50), 2 * 1024 * 1024);
+
+  zx::duration startup = Read(0);
+  Report("startup_latency", startup);
+
+  // One page at 2MB/s takes about 31ms on top of the latency.
+  EXPECT_LT(startup, zx::msec(100));
+  EXPECT_EQ(SparseByteBuffer::kPageSize, upstream_->first_request_size());
+}
+
+// Request sizes grow with the observed bandwidth.
+TEST_F(ReaderCacheTest, AdaptRequestSize) {
+  CreateCache(zx::msec(20), 16 * 1024 * 1024);
+  under_test_->SetCacheOptions(32 * 1024 * 1024, 0);
+
+  for (size_t position = 0; position < 8 * 1024 * 1024;
+       position += kReadSize) {
+    Read(position);
+  }
+
+  EXPECT_GT(under_test_->bytes_per_second(), 4u * 1024 * 1024);
+  EXPECT_GT(upstream_->max_request_size(), 1024u * 1024);
+}
+
+// A seek far from the current position is served without waiting for the
+// read-ahead of the old position to complete.
+TEST_F(ReaderCacheTest, SeekLatency) {
+  CreateCache(zx::msec(50), 4 * 1024 * 1024);
+  under_test_->SetCacheOptions(8 * 1024 * 1024, 1024 * 1024);
+
+  for (size_t position = 0; position < 2 * 1024 * 1024;
+       position += kReadSize) {
+    Read(position);
+    RunLoopFor(zx::msec(5));
+  }
+
+  zx::duration seek = Read(kAssetSize / 2);
+  Report("seek_latency", seek);
+
+  // At most one request of about 500ms may be in progress when seeking.
+  EXPECT_LT(seek, zx::msec(700));
+
+  // Reading continues smoothly after the seek.
+  zx::duration stall;
+  for (size_t position = kAssetSize / 2 + kReadSize;
+       position < kAssetSize / 2 + 4 * 1024 * 1024; position += kReadSize) {
+    stall = std::max(stall, Read(position));
+    RunLoopFor(zx::msec(20));
+  }
+
+  Report("post_seek_stall", stall);
+  EXPECT_LT(stall, zx::msec(100));
+}
+
+// Two streams read from distant parts of an asset that doesn't fit in the
+// cache, as when audio and video are far apart in an interleaved file. Each
+// stream gets its own read-ahead, and data isn't loaded repeatedly.
+TEST_F(ReaderCacheTest, InterleavedStreams) {
+  static constexpr size_t kVideoStart = 32 * 1024 * 1024;
+  static constexpr size_t kStreamBytes = 8 * 1024 * 1024;
+
+  CreateCache(zx::msec(20), 8 * 1024 * 1024);
+  under_test_->SetCacheOptions(4 * 1024 * 1024, 256 * 1024);
+
+  zx::duration total_wait;
+  for (size_t offset = 0; offset < kStreamBytes; offset += kReadSize) {
+    total_wait = total_wait + Read(offset);
+    total_wait = total_wait + Read(kVideoStart + offset);
+    RunLoopFor(zx::msec(10));
+  }
+
+  Report("interleaved_wait", total_wait);
+  RecordProperty("interleaved_requests",
+                 static_cast<int>(upstream_->request_count()));
+
+  // Without separate cursors, every switch between the streams would reload
+  // the cache.
+  EXPECT_LT(upstream_->bytes_requested(), 2 * kStreamBytes + 8 * 1024 * 1024);
+  EXPECT_LT(upstream_->request_count(), 2 * kStreamBytes / kReadSize);
+}
+
+// A read waiting for a load that fails completes with the error instead of
+// waiting for the cache to load the data.
+TEST_F(ReaderCacheTest, UpstreamFailure) {
+  CreateCache(zx::msec(20), 8 * 1024 * 1024);
+  Read(0);
+
+  upstream_->Fail();
+  std::shared_ptr<PendingRead> read = StartRead(kAssetSize / 2, kReadSize);
+  ASSERT_TRUE(read->done);
+  EXPECT_EQ(Result::kUnknownError, read->result);
+  EXPECT_EQ(0u, read->bytes_read);
+}
+
+// Reads keep completing when more streams than cursors share the smallest
+// capacity, so nearly every load has to free pages first.
+TEST_F(ReaderCacheTest, FullCache) {
+  CreateCache(zx::msec(5), 32 * 1024 * 1024);
+  under_test_->SetCacheOptions(1, 0);
+
+  for (size_t offset = 0; offset < 2 * 1024 * 1024; offset += kReadSize) {
+    for (size_t cursor = 0; cursor <= ReaderCache::kMaxCursors; ++cursor) {
+      Read(cursor * (kAssetSize / (ReaderCache::kMaxCursors + 1)) + offset);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace media_player
@@ -545,5 +545,88 @@ TEST(SparseByteBufferTest, ShrinkRegionBack) {
   }
 }
 
+TEST(SparseByteBufferTest, FindFirstGapInRange) {
+  SparseByteBuffer under_test = BufferWithRegions({{0, 10}, {20, 10}});
+
+  // Range starting in a region.
+  EXPECT_EQ(std::make_pair(size_t(10), size_t(10)),
+            under_test.FindFirstGapInRange(5, 100));
+
+  // Range starting in a hole.
+  EXPECT_EQ(std::make_pair(size_t(12), size_t(8)),
+            under_test.FindFirstGapInRange(12, 100));
+
+  // Gap clipped to the range.
+  EXPECT_EQ(std::make_pair(size_t(10), size_t(5)),
+            under_test.FindFirstGapInRange(0, 15));
+  EXPECT_EQ(std::make_pair(size_t(30), kSize - 30),
+            under_test.FindFirstGapInRange(25, kSize));
+
+  // Range entirely filled.
+  EXPECT_EQ(0u, under_test.FindFirstGapInRange(20, 10).second);
+
+  // No holes were split.
+  ExpectHole(&under_test, 10, 10, under_test.FindHoleContaining(15));
+}
+
+TEST(SparseByteBufferTest, FreeRegionsOutside) {
+  {
+    // Regions farthest from the protected ranges go first.
+    SparseByteBuffer under_test =
+        BufferWithRegions({{0, 10}, {100, 10}, {500, 10}, {900, 10}});
+    EXPECT_EQ(40u, under_test.bytes_cached());
+    EXPECT_EQ(20u, under_test.FreeRegionsOutside(15, {{100, 10}, {450, 100}}));
+    EXPECT_EQ(20u, under_test.bytes_cached());
+    ExpectRegion(&under_test, 100, 10,
+                 under_test.FindRegionContaining(100, under_test.null_region()));
+    ExpectRegion(&under_test, 500, 10,
+                 under_test.FindRegionContaining(500, under_test.null_region()));
+    ExpectHole(&under_test, 0, 100, under_test.FindHoleContaining(0));
+    ExpectHole(&under_test, 510, kSize - 510,
+               under_test.FindHoleContaining(900));
+  }
+
+  {
+    // Regions intersecting protected ranges are never freed.
+    SparseByteBuffer under_test = BufferWithRegions({{0, 10}, {10, 10}});
+    EXPECT_EQ(0u, under_test.FreeRegionsOutside(20, {{5, 10}}));
+    EXPECT_EQ(20u, under_test.bytes_cached());
+  }
+
+  {
+    // Without protected ranges, everything may be freed.
+    SparseByteBuffer under_test = BufferWithRegions({{0, 10}, {10, 10}});
+    EXPECT_EQ(20u, under_test.FreeRegionsOutside(kSize, {}));
+    ExpectHole(&under_test, 0, kSize, under_test.FindHoleContaining(0));
+  }
+}
+
+TEST(SparseByteBufferTest, ReusePages) {
+  SparseByteBuffer under_test;
+  under_test.Initialize(kSize);
+
+  std::vector<uint8_t> page = under_test.AllocatePage();
+  EXPECT_TRUE(page.empty());
+  EXPECT_EQ(SparseByteBuffer::kPageSize, page.capacity());
+  page.assign(100, 1);
+  const uint8_t* storage = page.data();
+  under_test.Fill(under_test.FindOrCreateHole(0, under_test.null_hole()),
+                  std::move(page));
+  EXPECT_EQ(100u, under_test.bytes_cached());
+
+  // Shrinking keeps the storage.
+  SparseByteBuffer::Region region = under_test.ShrinkRegionFront(
+      under_test.FindRegionContaining(0, under_test.null_region()), 10);
+  EXPECT_EQ(storage, region.data());
+  EXPECT_EQ(90u, under_test.bytes_cached());
+
+  // Freeing the region makes its storage available again.
+  under_test.Free(region);
+  EXPECT_EQ(0u, under_test.bytes_cached());
+  page = under_test.AllocatePage();
+  EXPECT_TRUE(page.empty());
+  EXPECT_EQ(storage, page.data());
+}
+
 }  // namespace
 }  // namespace media_player
@@ -39,6 +39,12 @@ void FfmpegDecoderFactory::CreateDecoder(
     return;
   }
 
+  if (av_codec_context->codec_type == AVMEDIA_TYPE_VIDEO) {
+    // Threading takes effect only if it's configured before the codec is
+    // opened.
+    FfmpegVideoDecoder::ConfigureThreading(av_codec_context.get());
+  }
+
   int r = avcodec_open2(av_codec_context.get(), ffmpeg_decoder, nullptr);
   if (r < 0) {
     FXL_LOG(ERROR) << "couldn't open the decoder " << r;
@@ -5,8 +5,11 @@
 #include "garnet/bin/mediaplayer/ffmpeg/ffmpeg_video_decoder.h"
 
 #include <lib/sync/completion.h>
+#include <trace/event.h>
+#include <zircon/syscalls.h>
 #include <algorithm>
 #include "garnet/bin/mediaplayer/ffmpeg/ffmpeg_formatting.h"
+#include "garnet/bin/mediaplayer/graph/formatting.h"
 #include "lib/fxl/logging.h"
 #include "lib/media/timeline/timeline.h"
 #include "lib/media/timeline/timeline_rate.h"
@@ -27,16 +30,30 @@ std::shared_ptr<Decoder> FfmpegVideoDecoder::Create(
   return std::make_shared<FfmpegVideoDecoder>(std::move(av_codec_context));
 }
 
+// static
+void FfmpegVideoDecoder::ConfigureThreading(AVCodecContext* av_codec_context) {
+  FXL_DCHECK(av_codec_context);
+  FXL_DCHECK(!avcodec_is_open(av_codec_context));
+
+  // Use a thread per CPU. ffmpeg uses FF_THREAD_FRAME, which assigns entire
+  // frames to threads, if the codec supports it. Otherwise, it uses
+  // FF_THREAD_SLICE, which has the threads share the slices of each frame, if
+  // the codec supports that.
+  av_codec_context->thread_count = std::clamp(
+      static_cast<int>(zx_system_get_num_cpus()), 1, kMaxThreadCount);
+  av_codec_context->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+}
+
 FfmpegVideoDecoder::FfmpegVideoDecoder(AvCodecContextPtr av_codec_context)
     : FfmpegDecoderBase(std::move(av_codec_context)) {
   FXL_DCHECK(context());
 
-  // Turn on multi-proc decoding by allowing the decoder to use three threads
-  // (the calling thread and the two specified here). FF_THREAD_FRAME means
-  // that threads are assigned an entire frame.
-  // TODO(dalesat): Consider using FF_THREAD_SLICE.
-  context()->thread_count = 2;
-  context()->thread_type = FF_THREAD_FRAME;
+  output_max_payload_count_ = kOutputMaxPayloadCount;
+  if (context()->active_thread_type & FF_THREAD_FRAME) {
+    output_max_payload_count_ += context()->thread_count;
+  }
+
+  frame_buffer_pool_ = FrameBufferPool::Create(output_max_payload_count_);
 
   frame_layout_.Update(*context());
 }
@@ -52,7 +69,7 @@ void FfmpegVideoDecoder::ConfigureConnectors() {
 
   if (has_size()) {
     configured_output_buffer_size_ = frame_layout_.buffer_size();
-    stage()->ConfigureOutputToUseLocalMemory(0, kOutputMaxPayloadCount,
+    stage()->ConfigureOutputToUseLocalMemory(0, output_max_payload_count_,
                                              configured_output_buffer_size_);
   } else {
     stage()->ConfigureOutputDeferred();
@@ -72,6 +89,10 @@ void FfmpegVideoDecoder::OnNewInputPacket(const PacketPtr& packet) {
   // We put the pts here so it can be recovered later in CreateOutputPacket.
   // Ffmpeg deals with the frame ordering issues.
   context()->reordered_opaque = packet->pts();
+
+  // Ended in |CreateOutputPacket|. Frames the decoder drops never end.
+  TRACE_ASYNC_BEGIN("motown", "DecodeVideoFrame", packet->pts(), "keyframe",
+                    packet->keyframe());
 }
 
 int FfmpegVideoDecoder::BuildAVFrame(const AVCodecContext& av_codec_context,
@@ -129,26 +150,32 @@ int FfmpegVideoDecoder::BuildAVFrame(const AVCodecContext& av_codec_context,
   if (has_size() && configured_output_buffer_size_ < buffer_size) {
     configured_output_buffer_size_ = buffer_size;
 
+    // Recycled buffers are too small and come from the old configuration.
+    frame_buffer_pool_->Clear();
+
     // We need to configure the output, but that has to happen on the graph
     // thread. Do that and block until it's done.
     sync_completion completion;
     stage()->PostTask([this, buffer_size, &completion]() {
       stage()->ConfigureOutputToUseLocalMemory(
-          0,                       // max_aggregate_payload_size
-          kOutputMaxPayloadCount,  // max_payload_count
-          buffer_size);            // max_payload_size
+          0,                          // max_aggregate_payload_size
+          output_max_payload_count_,  // max_payload_count
+          buffer_size);               // max_payload_size
       sync_completion_signal(&completion);
     });
 
     sync_completion_wait(&completion, ZX_TIME_INFINITE);
   }
 
-  fbl::RefPtr<PayloadBuffer> payload_buffer =
-      stage()->AllocatePayloadBuffer(frame_layout_.buffer_size());
+  // Recycled buffers are already zeroed or hold an earlier frame, which
+  // ffmpeg tolerates just as it does with its own buffer pools.
+  fbl::RefPtr<PayloadBuffer> payload_buffer = frame_buffer_pool_->Get(
+      buffer_size,
+      [this](uint64_t size) { return stage()->AllocatePayloadBuffer(size); });
 
   if (!payload_buffer) {
     FXL_LOG(ERROR) << "failed to allocate payload buffer of size "
-                   << frame_layout_.buffer_size();
+                   << buffer_size;
     return -1;
   }
 
@@ -157,9 +184,6 @@ int FfmpegVideoDecoder::BuildAVFrame(const AVCodecContext& av_codec_context,
   FXL_DCHECK(PayloadBuffer::IsAligned(payload_buffer->data()));
   FXL_DCHECK(PayloadBuffer::kByteAlignment >= kFrameBufferAlign);
 
-  // Decoders require a zeroed buffer.
-  std::memset(payload_buffer->data(), 0, frame_layout_.buffer_size());
-
   FXL_DCHECK(frame_layout_.line_stride().size() ==
              frame_layout_.plane_offset().size());
 
@@ -190,6 +214,8 @@ PacketPtr FfmpegVideoDecoder::CreateOutputPacket(
   // Recover the pts deposited in Decode.
   set_next_pts(av_frame.reordered_opaque);
 
+  TRACE_ASYNC_END("motown", "DecodeVideoFrame", av_frame.reordered_opaque);
+
   PacketPtr packet = Packet::Create(
       av_frame.reordered_opaque, pts_rate(), av_frame.key_frame, false,
       frame_layout_.buffer_size(), std::move(payload_buffer));
@@ -201,6 +227,16 @@ PacketPtr FfmpegVideoDecoder::CreateOutputPacket(
   return packet;
 }
 
+void FfmpegVideoDecoder::Dump(std::ostream& os) const {
+  FfmpegDecoderBase::Dump(os);
+
+  os << fostr::Indent;
+  os << fostr::NewLine
+     << "frame buffers:     " << frame_buffer_pool_->allocation_count()
+     << " allocated, " << frame_buffer_pool_->reuse_count() << " reused";
+  os << fostr::Outdent;
+}
+
 const char* FfmpegVideoDecoder::label() const { return "video_decoder"; }
 
 }  // namespace media_player
@@ -7,6 +7,7 @@
 
 #include "garnet/bin/mediaplayer/ffmpeg/ffmpeg_decoder_base.h"
 #include "garnet/bin/mediaplayer/ffmpeg/ffmpeg_video_frame_layout.h"
+#include "garnet/bin/mediaplayer/ffmpeg/frame_buffer_pool.h"
 #include "lib/media/timeline/timeline_rate.h"
 
 namespace media_player {
@@ -16,6 +17,10 @@ class FfmpegVideoDecoder : public FfmpegDecoderBase {
  public:
   static std::shared_ptr<Decoder> Create(AvCodecContextPtr av_codec_context);
 
+  // Configures multithreaded decoding for |av_codec_context|. This must be
+  // done before the codec context is opened.
+  static void ConfigureThreading(AVCodecContext* av_codec_context);
+
   FfmpegVideoDecoder(AvCodecContextPtr av_codec_context);
 
   ~FfmpegVideoDecoder() override;
@@ -23,6 +28,8 @@ class FfmpegVideoDecoder : public FfmpegDecoderBase {
   // AsyncNode implementation.
   void ConfigureConnectors() override;
 
+  void Dump(std::ostream& os) const override;
+
  protected:
   // FfmpegDecoderBase overrides.
   void OnNewInputPacket(const PacketPtr& packet) override;
@@ -41,6 +48,9 @@ class FfmpegVideoDecoder : public FfmpegDecoderBase {
   // operations.
   static const int kFrameBufferAlign = 32;
 
+  // Decoding on more threads than this yields little benefit.
+  static constexpr int kMaxThreadCount = 16;
+
   // Indicates whether the decoder has a non-zero coded size.
   bool has_size() const {
     return coded_size_.width() != 0 && coded_size_.height() != 0;
@@ -53,8 +63,13 @@ class FfmpegVideoDecoder : public FfmpegDecoderBase {
   bool first_frame_ = true;
   AVColorSpace colorspace_;
   VideoStreamType::Extent coded_size_;
-  
+
   size_t configured_output_buffer_size_ = 0;
+
+  // Frame threading keeps a frame in progress on each thread, so the output
+  // needs more payloads than with slice threading.
+  uint32_t output_max_payload_count_;
+  std::shared_ptr<FrameBufferPool> frame_buffer_pool_;
 };
 
 }  // namespace media_player
@@ -0,0 +1,136 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/bin/mediaplayer/ffmpeg/frame_buffer_pool.h"
+
+#include <cstring>
+
+#include <trace/event.h>
+#include "lib/fxl/logging.h"
+
+namespace media_player {
+
+// static
+std::shared_ptr<FrameBufferPool> FrameBufferPool::Create(
+    size_t max_free_buffers) {
+  return std::make_shared<FrameBufferPool>(max_free_buffers);
+}
+
+FrameBufferPool::FrameBufferPool(size_t max_free_buffers)
+    : max_free_buffers_(max_free_buffers) {}
+
+FrameBufferPool::~FrameBufferPool() {}
+
+fbl::RefPtr<PayloadBuffer> FrameBufferPool::Get(
+    uint64_t size, const AllocateCallback& allocate) {
+  FXL_DCHECK(size != 0);
+  FXL_DCHECK(allocate);
+
+  fbl::RefPtr<PayloadBuffer> buffer;
+
+  // Buffers are released outside the lock, because releasing them calls into
+  // the allocator.
+  std::vector<fbl::RefPtr<PayloadBuffer>> discarded;
+
+  {
+    std::lock_guard<std::mutex> locker(mutex_);
+    if (size != buffer_size_) {
+      discarded.swap(free_buffers_);
+      buffer_size_ = size;
+    }
+
+    if (!free_buffers_.empty()) {
+      buffer = std::move(free_buffers_.back());
+      free_buffers_.pop_back();
+      ++reuse_count_;
+    }
+  }
+
+  if (buffer) {
+    return Wrap(std::move(buffer), size);
+  }
+
+  TRACE_DURATION("motown", "AllocateFrameBuffer", "size", size);
+
+  buffer = allocate(size);
+  if (!buffer) {
+    return nullptr;
+  }
+
+  FXL_DCHECK(buffer->size() >= size);
+
+  // Decoders require a zeroed buffer. Like ffmpeg's own buffer pools, we zero
+  // buffers only when they're allocated, not each time they're reused.
+  std::memset(buffer->data(), 0, size);
+
+  {
+    std::lock_guard<std::mutex> locker(mutex_);
+    ++allocation_count_;
+  }
+
+  return Wrap(std::move(buffer), size);
+}
+
+void FrameBufferPool::Clear() {
+  std::vector<fbl::RefPtr<PayloadBuffer>> discarded;
+
+  std::lock_guard<std::mutex> locker(mutex_);
+  discarded.swap(free_buffers_);
+  buffer_size_ = 0;
+}
+
+size_t FrameBufferPool::allocation_count() const {
+  std::lock_guard<std::mutex> locker(mutex_);
+  return allocation_count_;
+}
+
+size_t FrameBufferPool::reuse_count() const {
+  std::lock_guard<std::mutex> locker(mutex_);
+  return reuse_count_;
+}
+
+void FrameBufferPool::Recycle(fbl::RefPtr<PayloadBuffer> buffer,
+                              uint64_t size) {
+  FXL_DCHECK(buffer);
+
+  std::lock_guard<std::mutex> locker(mutex_);
+  if (size == buffer_size_ && free_buffers_.size() < max_free_buffers_) {
+    free_buffers_.push_back(std::move(buffer));
+    return;
+  }
+
+  // Otherwise, |buffer| is released when this method returns, after |locker|
+  // has released the lock.
+}
+
+fbl::RefPtr<PayloadBuffer> FrameBufferPool::Wrap(
+    fbl::RefPtr<PayloadBuffer> buffer, uint64_t size) {
+  FXL_DCHECK(buffer);
+
+  void* data = buffer->data();
+  fbl::RefPtr<PayloadVmo> vmo = fbl::WrapRefPtr(buffer->vmo());
+  uint64_t offset = buffer->offset();
+  uint32_t id = buffer->id();
+  uint64_t buffer_config = buffer->buffer_config();
+
+  // The recycler holds a reference to the pool, so the pool outlives the
+  // buffers it hands out.
+  PayloadBuffer::Recycler recycler =
+      [pool = shared_from_this(),
+       buffer = std::move(buffer)](PayloadBuffer* wrapper) mutable {
+        pool->Recycle(std::move(buffer), wrapper->size());
+      };
+
+  fbl::RefPtr<PayloadBuffer> wrapper =
+      vmo ? PayloadBuffer::Create(size, data, std::move(vmo), offset,
+                                  std::move(recycler))
+          : PayloadBuffer::Create(size, data, std::move(recycler));
+
+  wrapper->SetId(id);
+  wrapper->SetBufferConfig(buffer_config);
+
+  return wrapper;
+}
+
+}  // namespace media_player
@@ -0,0 +1,80 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GARNET_BIN_MEDIAPLAYER_FFMPEG_FRAME_BUFFER_POOL_H_
+#define GARNET_BIN_MEDIAPLAYER_FFMPEG_FRAME_BUFFER_POOL_H_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <fbl/ref_ptr.h>
+#include <lib/fit/function.h>
+
+#include "garnet/bin/mediaplayer/graph/payloads/payload_buffer.h"
+#include "lib/fxl/synchronization/thread_annotations.h"
+
+namespace media_player {
+
+// Recycles payload buffers for decoded video frames.
+//
+// Buffers come from the output's allocator, so decoders write frames directly
+// into the buffers (possibly in VMOs) that travel downstream. The buffers
+// handed out by |Get| are wrappers around the allocated buffers. When the last
+// reference to a wrapper is dropped, the allocated buffer returns to the pool
+// rather than to the allocator, and the next frame of the same size reuses it
+// without allocating or zeroing.
+//
+// This class is thread-safe. Buffers are requested on decoder threads and
+// released on arbitrary threads.
+class FrameBufferPool : public std::enable_shared_from_this<FrameBufferPool> {
+ public:
+  using AllocateCallback = fit::function<fbl::RefPtr<PayloadBuffer>(uint64_t)>;
+
+  // Creates a pool that keeps at most |max_free_buffers| buffers that aren't
+  // in use.
+  static std::shared_ptr<FrameBufferPool> Create(size_t max_free_buffers);
+
+  FrameBufferPool(size_t max_free_buffers);
+
+  ~FrameBufferPool();
+
+  // Returns a buffer of |size| bytes. Recycled buffers are used if available.
+  // Otherwise, |allocate| is called, and the new buffer is zeroed, as ffmpeg
+  // requires. Returns nullptr if |allocate| fails. Changing |size| discards
+  // the recycled buffers.
+  fbl::RefPtr<PayloadBuffer> Get(uint64_t size,
+                                 const AllocateCallback& allocate);
+
+  // Discards the recycled buffers. Buffers currently in use are discarded when
+  // they're released.
+  void Clear();
+
+  // Returns the number of buffers obtained from allocators.
+  size_t allocation_count() const;
+
+  // Returns the number of buffers that were reused.
+  size_t reuse_count() const;
+
+ private:
+  // Returns |buffer| to the pool, if it's still of the current size.
+  void Recycle(fbl::RefPtr<PayloadBuffer> buffer, uint64_t size);
+
+  // Creates a buffer of |size| bytes that shares memory with |buffer| and
+  // recycles |buffer| when released.
+  fbl::RefPtr<PayloadBuffer> Wrap(fbl::RefPtr<PayloadBuffer> buffer,
+                                  uint64_t size);
+
+  const size_t max_free_buffers_;
+
+  mutable std::mutex mutex_;
+  uint64_t buffer_size_ FXL_GUARDED_BY(mutex_) = 0;
+  std::vector<fbl::RefPtr<PayloadBuffer>> free_buffers_ FXL_GUARDED_BY(mutex_);
+  size_t allocation_count_ FXL_GUARDED_BY(mutex_) = 0;
+  size_t reuse_count_ FXL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace media_player
+
+#endif  // GARNET_BIN_MEDIAPLAYER_FFMPEG_FRAME_BUFFER_POOL_H_
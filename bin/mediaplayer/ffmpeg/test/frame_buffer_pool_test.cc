@@ -0,0 +1,154 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/bin/mediaplayer/ffmpeg/frame_buffer_pool.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace media_player {
+namespace {
+
+static constexpr uint64_t kFrameSize = 4096;
+static constexpr size_t kMaxFreeBuffers = 4;
+
+// Allocates buffers with malloc and counts those that haven't been released.
+class CountingAllocator {
+ public:
+  FrameBufferPool::AllocateCallback callback() {
+    return [this](uint64_t size) {
+      auto buffer = PayloadBuffer::CreateWithMalloc(size);
+      // Dirty the buffer, so the test can tell that the pool zeroes it.
+      std::memset(buffer->data(), 0xff, size);
+      ++live_count_;
+      buffer->AfterRecycling([this](PayloadBuffer*) { --live_count_; });
+      return buffer;
+    };
+  }
+
+  size_t live_count() const { return live_count_; }
+
+ private:
+  std::atomic<size_t> live_count_{0};
+};
+
+// Returns true if the |size| bytes at |data| are all |value|.
+bool AllBytesAre(const void* data, uint64_t size, uint8_t value) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  for (uint64_t i = 0; i < size; ++i) {
+    if (bytes[i] != value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Tests that released buffers are reused without being zeroed again, and that
+// changing the size discards them.
+TEST(FrameBufferPoolTest, ReuseReleasedBuffers) {
+  CountingAllocator allocator;
+  auto allocate = allocator.callback();
+  auto pool = FrameBufferPool::Create(kMaxFreeBuffers);
+
+  auto buffer = pool->Get(kFrameSize, allocate);
+  ASSERT_TRUE(buffer);
+  EXPECT_EQ(kFrameSize, buffer->size());
+  EXPECT_TRUE(AllBytesAre(buffer->data(), kFrameSize, 0));
+  EXPECT_EQ(1u, pool->allocation_count());
+  EXPECT_EQ(0u, pool->reuse_count());
+
+  void* data = buffer->data();
+  std::memset(data, 0x55, kFrameSize);
+  buffer = nullptr;
+  EXPECT_EQ(1u, allocator.live_count());
+
+  buffer = pool->Get(kFrameSize, allocate);
+  ASSERT_TRUE(buffer);
+  EXPECT_EQ(data, buffer->data());
+  EXPECT_TRUE(AllBytesAre(buffer->data(), kFrameSize, 0x55));
+  EXPECT_EQ(1u, pool->allocation_count());
+  EXPECT_EQ(1u, pool->reuse_count());
+
+  // At most |kMaxFreeBuffers| buffers are kept.
+  std::vector<fbl::RefPtr<PayloadBuffer>> buffers;
+  for (size_t i = 0; i < kMaxFreeBuffers + 2; ++i) {
+    buffers.push_back(pool->Get(kFrameSize, allocate));
+  }
+  buffers.clear();
+  buffer = nullptr;
+  EXPECT_EQ(kMaxFreeBuffers, allocator.live_count());
+
+  // Buffers of another size are allocated, and the recycled ones discarded.
+  buffer = pool->Get(kFrameSize * 2, allocate);
+  ASSERT_TRUE(buffer);
+  EXPECT_EQ(kFrameSize * 2, buffer->size());
+  EXPECT_EQ(1u, allocator.live_count());
+
+  buffer = nullptr;
+  pool->Clear();
+  EXPECT_EQ(0u, allocator.live_count());
+}
+
+// Tests that buffers may outlive the last reference to their pool.
+TEST(FrameBufferPoolTest, ReleaseAfterPoolDestroyed) {
+  CountingAllocator allocator;
+  auto pool = FrameBufferPool::Create(kMaxFreeBuffers);
+  std::weak_ptr<FrameBufferPool> weak_pool = pool;
+
+  auto buffer = pool->Get(kFrameSize, allocator.callback());
+  ASSERT_TRUE(buffer);
+  pool = nullptr;
+
+  // The buffer keeps the pool alive, and then goes back to it.
+  EXPECT_FALSE(weak_pool.expired());
+  buffer = nullptr;
+
+  EXPECT_TRUE(weak_pool.expired());
+  EXPECT_EQ(0u, allocator.live_count());
+}
+
+// Tests that buffers acquired concurrently are distinct, and that released
+// buffers are reused across threads.
+TEST(FrameBufferPoolTest, AcquireFromThreads) {
+  static constexpr size_t kThreadCount = kMaxFreeBuffers;
+  static constexpr size_t kIterations = 1000;
+
+  CountingAllocator allocator;
+  auto pool = FrameBufferPool::Create(kMaxFreeBuffers);
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreadCount; ++t) {
+    threads.emplace_back([&pool, &allocator, t] {
+      auto allocate = allocator.callback();
+      const uint8_t tag = static_cast<uint8_t>(t + 1);
+      for (size_t i = 0; i < kIterations; ++i) {
+        auto buffer = pool->Get(kFrameSize, allocate);
+        ASSERT_TRUE(buffer);
+        std::memset(buffer->data(), tag, kFrameSize);
+        std::this_thread::yield();
+        ASSERT_TRUE(AllBytesAre(buffer->data(), kFrameSize, tag));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(kThreadCount * kIterations,
+            pool->allocation_count() + pool->reuse_count());
+  // No more buffers are in use at once than there are threads, and the pool
+  // keeps that many, so no buffer is allocated twice.
+  EXPECT_LE(pool->allocation_count(), kThreadCount);
+  EXPECT_EQ(pool->allocation_count(), allocator.live_count());
+
+  pool = nullptr;
+  EXPECT_EQ(0u, allocator.live_count());
+}
+
+}  // namespace
+}  // namespace media_player
@@ -0,0 +1,203 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Decodes local media files as fast as possible without rendering them and
+// reports the decode rate for each stream. Run under 'trace record' with the
+// "motown" category to see the decode time of each video frame.
+
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <lib/async-loop/cpp/loop.h>
+#include <trace-provider/provider.h>
+
+#include "garnet/bin/mediaplayer/demux/file_reader.h"
+#include "garnet/bin/mediaplayer/demux/reader_cache.h"
+#include "garnet/bin/mediaplayer/ffmpeg/ffmpeg_decoder_factory.h"
+#include "garnet/bin/mediaplayer/ffmpeg/ffmpeg_demux.h"
+#include "garnet/bin/mediaplayer/graph/graph.h"
+#include "lib/fxl/command_line.h"
+#include "lib/fxl/files/unique_fd.h"
+#include "lib/fxl/logging.h"
+#include "lib/fxl/strings/string_number_conversions.h"
+#include "lib/media/timeline/timeline.h"
+
+namespace media_player {
+namespace {
+
+constexpr char kIterationsOption[] = "iterations";
+
+// Sink that discards packets as soon as they arrive.
+class NullSink : public AsyncNode {
+ public:
+  NullSink(fit::closure end_of_stream_callback)
+      : end_of_stream_callback_(std::move(end_of_stream_callback)) {
+    FXL_DCHECK(end_of_stream_callback_);
+  }
+
+  ~NullSink() override {}
+
+  // Returns the number of non-empty packets received.
+  size_t frame_count() const { return frame_count_; }
+
+  // AsyncNode implementation.
+  const char* label() const override { return "null_sink"; }
+
+  void ConfigureConnectors() override {
+    if (stage()->ConfigureInputToUseLocalMemory(
+            0,     // max_aggregate_payload_size
+            1)) {  // max_payload_count
+      stage()->RequestInputPacket();
+    }
+  }
+
+  void OnInputConnectionReady(size_t input_index) override {
+    FXL_DCHECK(input_index == 0);
+    stage()->RequestInputPacket();
+  }
+
+  void FlushInput(bool hold_frame, size_t input_index,
+                  fit::closure callback) override {
+    FXL_DCHECK(input_index == 0);
+    callback();
+  }
+
+  void PutInputPacket(PacketPtr packet, size_t input_index) override {
+    FXL_DCHECK(packet);
+    FXL_DCHECK(input_index == 0);
+
+    if (packet->size() != 0) {
+      ++frame_count_;
+    }
+
+    if (packet->end_of_stream()) {
+      end_of_stream_callback_();
+      return;
+    }
+
+    stage()->RequestInputPacket();
+  }
+
+ private:
+  fit::closure end_of_stream_callback_;
+  size_t frame_count_ = 0;
+};
+
+// Decodes every stream of the file at |path|, printing the decode rates.
+// Returns false if the file couldn't be decoded.
+bool DecodeFile(async::Loop* loop, const std::string& path) {
+  FXL_DCHECK(loop);
+
+  fxl::UniqueFD fd(open(path.c_str(), O_RDONLY));
+  if (!fd.is_valid()) {
+    FXL_LOG(ERROR) << "Failed to open " << path;
+    return false;
+  }
+
+  int64_t start_time = media::Timeline::local_now();
+
+  std::shared_ptr<Demux> demux = FfmpegDemux::Create(
+      ReaderCache::Create(std::make_shared<FileReader>(std::move(fd))));
+
+  Result init_result = Result::kUnknownError;
+  demux->WhenInitialized([loop, &init_result](Result result) {
+    init_result = result;
+    loop->Quit();
+  });
+
+  loop->Run();
+  loop->ResetQuit();
+
+  if (init_result != Result::kOk || demux->streams().empty()) {
+    FXL_LOG(ERROR) << "Failed to demux " << path;
+    return false;
+  }
+
+  Graph graph(loop->dispatcher());
+  NodeRef demux_node = graph.Add(demux);
+  std::unique_ptr<DecoderFactory> decoder_factory =
+      FfmpegDecoderFactory::Create(nullptr);
+
+  std::vector<std::shared_ptr<NullSink>> sinks;
+  size_t streams_remaining = demux->streams().size();
+  for (auto& stream : demux->streams()) {
+    auto sink = std::make_shared<NullSink>([loop, &streams_remaining]() {
+      if (--streams_remaining == 0) {
+        loop->Quit();
+      }
+    });
+
+    sinks.push_back(sink);
+
+    // The ffmpeg factory calls back synchronously.
+    std::shared_ptr<Decoder> decoder;
+    decoder_factory->CreateDecoder(
+        *stream->stream_type(),
+        [&decoder](std::shared_ptr<Decoder> result) { decoder = result; });
+
+    OutputRef output = demux_node.output(stream->index());
+    if (decoder) {
+      graph.ConnectNodes(graph.ConnectOutputToNode(output, graph.Add(decoder)),
+                         graph.Add(sink));
+    } else {
+      // Streams the demux delivers uncompressed go straight to the sink.
+      graph.ConnectOutputToNode(output, graph.Add(sink));
+    }
+  }
+
+  loop->Run();
+  loop->ResetQuit();
+
+  double seconds = (media::Timeline::local_now() - start_time) /
+                   static_cast<double>(ZX_SEC(1));
+
+  std::cout << path << ": " << seconds << " seconds\n";
+  for (size_t index = 0; index < sinks.size(); ++index) {
+    size_t frames = sinks[index]->frame_count();
+    std::cout << "    stream " << index << ": " << frames << " frames, "
+              << frames / seconds << " frames/second\n";
+  }
+
+  graph.RemoveNodesConnectedToNode(demux_node);
+
+  return true;
+}
+
+}  // namespace
+}  // namespace media_player
+
+int main(int argc, const char** argv) {
+  fxl::CommandLine command_line = fxl::CommandLineFromArgcArgv(argc, argv);
+
+  uint32_t iterations = 1;
+  std::string iterations_string;
+  if (command_line.GetOptionValue(media_player::kIterationsOption,
+                                  &iterations_string) &&
+      !fxl::StringToNumberWithError(iterations_string, &iterations)) {
+    iterations = 0;
+  }
+
+  if (iterations == 0 || command_line.positional_args().empty()) {
+    std::cerr << "usage: " << command_line.argv0()
+              << " [--iterations=<count>] <file>...\n";
+    return 1;
+  }
+
+  async::Loop loop(&kAsyncLoopConfigAttachToThread);
+  trace::TraceProvider trace_provider(loop.dispatcher());
+
+  int result = 0;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    for (const std::string& path : command_line.positional_args()) {
+      if (!media_player::DecodeFile(&loop, path)) {
+        result = 1;
+      }
+    }
+  }
+
+  return result;
+}
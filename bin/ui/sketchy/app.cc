@@ -6,14 +6,16 @@
 
 namespace sketchy_service {
 
-App::App(async::Loop* loop, escher::EscherWeakPtr weak_escher)
+App::App(async::Loop* loop, escher::EscherWeakPtr weak_escher,
+         const TessellatorConfig& tessellator_config)
     : loop_(loop),
       context_(component::StartupContext::CreateFromStartupInfo()),
       scenic_(
           context_->ConnectToEnvironmentService<fuchsia::ui::scenic::Scenic>()),
       session_(std::make_unique<scenic::Session>(scenic_.get())),
       canvas_(std::make_unique<CanvasImpl>(loop_, session_.get(),
-                                           std::move(weak_escher))) {
+                                           std::move(weak_escher),
+                                           tessellator_config)) {
   context_->outgoing().AddPublicService(bindings_.GetHandler(canvas_.get()));
 
   session_->set_error_handler([this] {
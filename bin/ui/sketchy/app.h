@@ -17,7 +17,8 @@ namespace sketchy_service {
 
 class App {
  public:
-  App(async::Loop* loop, escher::EscherWeakPtr escher);
+  App(async::Loop* loop, escher::EscherWeakPtr escher,
+      const TessellatorConfig& tessellator_config);
 
  private:
   async::Loop* const loop_;
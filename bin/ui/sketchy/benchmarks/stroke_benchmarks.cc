@@ -0,0 +1,94 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <fbl/string_printf.h>
+#include <perftest/perftest.h>
+
+#include "garnet/bin/ui/sketchy/stroke/cpu_stroke_tessellator.h"
+#include "garnet/bin/ui/sketchy/stroke/divided_stroke_path.h"
+#include "garnet/bin/ui/sketchy/stroke/stroke_fitter.h"
+
+namespace {
+
+using namespace sketchy_service;
+
+// Same as the constants of Stroke.
+constexpr float kStrokeHalfWidth = 30.f;
+constexpr float kPixelsPerDivision = 4;
+
+// Number of sampled points that arrive between two frames.
+constexpr size_t kPointsPerExtend = 8;
+
+// Returns the points of a spiral, as sampled from a touch screen.
+std::vector<glm::vec2> NewSampledPoints(size_t count) {
+  std::vector<glm::vec2> points;
+  for (size_t i = 0; i < count; ++i) {
+    const float angle = 0.05f * i;
+    const float radius = 100.f + 0.5f * i;
+    points.push_back(
+        glm::vec2(radius * std::cos(angle), radius * std::sin(angle)));
+  }
+  return points;
+}
+
+// Measures the time taken to turn sampled points into a stroke mesh, as the
+// service does when the sketchy tessellator runs on the CPU: the points are
+// fitted into a path a few at a time, and the whole path is then tessellated.
+bool StrokeTest(perftest::RepeatState* state, size_t point_count,
+                uint32_t thread_count) {
+  state->DeclareStep("fit");
+  state->DeclareStep("tessellate");
+
+  const std::vector<glm::vec2> points = NewSampledPoints(point_count);
+  CpuStrokeTessellator tessellator(thread_count);
+  std::vector<StrokeVertex> vertices;
+  std::vector<uint32_t> indices;
+
+  while (state->KeepRunning()) {
+    DividedStrokePath stable_path(kStrokeHalfWidth, kPixelsPerDivision);
+    DividedStrokePath unstable_path(kStrokeHalfWidth, kPixelsPerDivision);
+    StrokeFitter fitter(points.front());
+    for (size_t i = 1; i < points.size(); i += kPointsPerExtend) {
+      const size_t end = std::min(i + kPointsPerExtend, points.size());
+      fitter.Extend(std::vector<glm::vec2>(points.begin() + i,
+                                           points.begin() + end));
+      StrokePath delta_path;
+      unstable_path.Reset();
+      if (fitter.FitAndPop(&delta_path)) {
+        stable_path.Extend(delta_path);
+      } else {
+        unstable_path.Extend(delta_path);
+      }
+    }
+    state->NextStep();
+
+    vertices.resize(stable_path.vertex_count() + unstable_path.vertex_count());
+    indices.resize(stable_path.index_count() + unstable_path.index_count());
+    tessellator.Tessellate(stable_path, unstable_path, kStrokeHalfWidth, 0,
+                           vertices.data(), indices.data());
+  }
+  return true;
+}
+
+void RegisterTests() {
+  for (size_t point_count : {100, 1000, 10000}) {
+    for (uint32_t thread_count : {0, 3}) {
+      auto name = fbl::StringPrintf("Sketchy/Stroke/%zupoints/%uthreads",
+                                    point_count, thread_count);
+      perftest::RegisterTest(name.c_str(), StrokeTest, point_count,
+                             thread_count);
+    }
+  }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  return perftest::PerfTestMain(argc, argv, "fuchsia.sketchy_benchmarks");
+}
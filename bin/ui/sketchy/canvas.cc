@@ -12,11 +12,12 @@
 namespace sketchy_service {
 
 CanvasImpl::CanvasImpl(async::Loop* loop, scenic::Session* session,
-                       escher::EscherWeakPtr weak_escher)
+                       escher::EscherWeakPtr weak_escher,
+                       const TessellatorConfig& tessellator_config)
     : loop_(loop),
       session_(session),
       shared_buffer_pool_(session, weak_escher),
-      stroke_manager_(std::move(weak_escher)) {}
+      stroke_manager_(std::move(weak_escher), tessellator_config) {}
 
 void CanvasImpl::Init(
     fidl::InterfaceHandle<::fuchsia::ui::sketchy::CanvasListener> listener) {
@@ -126,8 +127,10 @@ bool CanvasImpl::ApplyCreateResourceCmd(
 bool CanvasImpl::CreateStroke(ResourceId id,
                               ::fuchsia::ui::sketchy::Stroke stroke) {
   return resource_map_.AddResource(
-      id, fxl::MakeRefCounted<Stroke>(stroke_manager_.stroke_tessellator(),
-                                      shared_buffer_pool_.factory()));
+      id, fxl::MakeRefCounted<Stroke>(
+              stroke_manager_.stroke_tessellator(),
+              stroke_manager_.cpu_stroke_tessellator(),
+              shared_buffer_pool_.factory()));
 }
 
 bool CanvasImpl::CreateStrokeGroup(
@@ -24,7 +24,8 @@ namespace sketchy_service {
 class CanvasImpl final : public ::fuchsia::ui::sketchy::Canvas {
  public:
   CanvasImpl(async::Loop* loop, scenic::Session* session,
-             escher::EscherWeakPtr escher);
+             escher::EscherWeakPtr escher,
+             const TessellatorConfig& tessellator_config);
 
   // |::fuchsia::ui::sketchy::Canvas|
   void Init(::fidl::InterfaceHandle<::fuchsia::ui::sketchy::CanvasListener>
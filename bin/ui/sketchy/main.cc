@@ -9,8 +9,49 @@
 #include "lib/component/cpp/startup_context.h"
 #include "lib/escher/escher.h"
 #include "lib/escher/escher_process_init.h"
+#include "lib/fxl/command_line.h"
+#include "lib/fxl/log_settings_command_line.h"
+#include "lib/fxl/strings/string_number_conversions.h"
+
+namespace {
+
+// Reads the tessellator selection from the command line:
+//   --tessellator=gpu|cpu      Where strokes are tessellated; defaults to gpu.
+//   --tessellator_threads=N    Worker threads of the cpu tessellator.
+bool ParseTessellatorConfig(const fxl::CommandLine& command_line,
+                            sketchy_service::TessellatorConfig* config) {
+  std::string type =
+      command_line.GetOptionValueWithDefault("tessellator", "gpu");
+  if (type == "gpu") {
+    config->type = sketchy_service::TessellatorConfig::Type::kGpu;
+  } else if (type == "cpu") {
+    config->type = sketchy_service::TessellatorConfig::Type::kCpu;
+  } else {
+    FXL_LOG(ERROR) << "Unknown tessellator: " << type;
+    return false;
+  }
+
+  std::string thread_count;
+  if (command_line.GetOptionValue("tessellator_threads", &thread_count) &&
+      !fxl::StringToNumberWithError(thread_count,
+                                    &config->cpu_thread_count)) {
+    FXL_LOG(ERROR) << "Invalid tessellator_threads: " << thread_count;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
 
 int main(int argc, const char** argv) {
+  auto command_line = fxl::CommandLineFromArgcArgv(argc, argv);
+  if (!fxl::SetLogSettingsFromCommandLine(command_line))
+    return 1;
+
+  sketchy_service::TessellatorConfig tessellator_config;
+  if (!ParseTessellatorConfig(command_line, &tessellator_config))
+    return 1;
+
   escher::GlslangInitializeProcess();
   {
     // Only enable Vulkan validation layers when in debug mode.
@@ -39,7 +80,7 @@ int main(int argc, const char** argv) {
     async::Loop loop(&kAsyncLoopConfigAttachToThread);
     trace::TraceProvider trace_provider(loop.dispatcher());
 
-    sketchy_service::App app(&loop, escher.GetWeakPtr());
+    sketchy_service::App app(&loop, escher.GetWeakPtr(), tessellator_config);
     loop.Run();
   }
   escher::GlslangFinalizeProcess();
@@ -6,6 +6,7 @@
 
 #include "garnet/bin/ui/sketchy/buffer/shared_buffer_pool.h"
 #include "lib/escher/escher.h"
+#include "lib/escher/impl/command_buffer.h"
 
 namespace {
 
@@ -29,8 +30,10 @@ const ResourceTypeInfo Stroke::kTypeInfo("Stroke", ResourceType::kStroke,
                                          ResourceType::kResource);
 
 Stroke::Stroke(StrokeTessellator* tessellator,
+               CpuStrokeTessellator* cpu_tessellator,
                escher::BufferFactory* buffer_factory)
     : tessellator_(tessellator),
+      cpu_tessellator_(cpu_tessellator),
       stable_path_(kStrokeHalfWidth, kPixelsPerDivision),
       delta_stable_path_(kStrokeHalfWidth, kPixelsPerDivision),
       stroke_info_buffer_(buffer_factory->NewBuffer(
@@ -41,7 +44,9 @@ Stroke::Stroke(StrokeTessellator* tessellator,
       re_params_buffer_(buffer_factory),
       division_counts_buffer_(buffer_factory),
       cumulative_division_counts_buffer_(buffer_factory),
-      division_segment_index_buffer_(buffer_factory) {}
+      division_segment_index_buffer_(buffer_factory) {
+  FXL_DCHECK(!tessellator_ != !cpu_tessellator_);
+}
 
 bool Stroke::SetPath(std::unique_ptr<StrokePath> path) {
   if (fitter_) {
@@ -110,6 +115,11 @@ void Stroke::TessellateAndMerge(Frame* frame, MeshBuffer* mesh_buffer) {
     return;
   }
 
+  if (cpu_tessellator_) {
+    TessellateOnCpuAndMerge(frame, mesh_buffer, delta_unstable_path);
+    return;
+  }
+
   auto command = frame->command();
   auto buffer_factory = frame->shared_buffer_pool()->factory();
   auto profiler = frame->profiler();
@@ -180,6 +190,48 @@ void Stroke::TessellateAndMerge(Frame* frame, MeshBuffer* mesh_buffer) {
   is_path_updated_ = false;
 }
 
+void Stroke::TessellateOnCpuAndMerge(
+    Frame* frame, MeshBuffer* mesh_buffer,
+    const DividedStrokePath& delta_unstable_path) {
+  // The whole stroke is tessellated every frame, so there are no buffers of
+  // the path to keep up to date.
+  if (!delta_stable_path_.empty()) {
+    stable_path_.Extend(delta_stable_path_.path());
+    delta_stable_path_.Reset();
+  }
+  is_path_updated_ = false;
+
+  uint32_t base_vertex_index = mesh_buffer->vertex_count();
+  auto pair = mesh_buffer->Reserve(
+      frame, stable_path_.vertex_count() + delta_unstable_path.vertex_count(),
+      stable_path_.index_count() + delta_unstable_path.index_count(),
+      escher::BoundingBox()
+          .Join(stable_path_.bbox())
+          .Join(delta_unstable_path.bbox()));
+  const auto& vertex_range = pair.first;
+  const auto& index_range = pair.second;
+
+  // TODO(SCN-269): Use the staging buffer pool once there is one.
+  auto staging_buffer = frame->shared_buffer_pool()->factory()->NewBuffer(
+      vertex_range.size + index_range.size,
+      vk::BufferUsageFlagBits::eTransferSrc,
+      vk::MemoryPropertyFlagBits::eHostVisible |
+          vk::MemoryPropertyFlagBits::eHostCoherent);
+  uint8_t* host_ptr = staging_buffer->host_ptr();
+  cpu_tessellator_->Tessellate(
+      stable_path_, delta_unstable_path, kStrokeHalfWidth, base_vertex_index,
+      reinterpret_cast<StrokeVertex*>(host_ptr),
+      reinterpret_cast<uint32_t*>(host_ptr + vertex_range.size));
+
+  auto command = frame->command();
+  command->CopyBuffer(staging_buffer,
+                      mesh_buffer->vertex_buffer()->escher_buffer(),
+                      {0, vertex_range.offset, vertex_range.size});
+  command->CopyBuffer(
+      staging_buffer, mesh_buffer->index_buffer()->escher_buffer(),
+      {vertex_range.size, index_range.offset, index_range.size});
+}
+
 void Stroke::AppendPathToBuffers(escher::impl::CommandBuffer* command,
                                  escher::BufferFactory* buffer_factory,
                                  const DividedStrokePath& path,
@@ -9,6 +9,7 @@
 #include "garnet/bin/ui/sketchy/buffer/mesh_buffer.h"
 #include "garnet/bin/ui/sketchy/frame.h"
 #include "garnet/bin/ui/sketchy/resources/resource.h"
+#include "garnet/bin/ui/sketchy/stroke/cpu_stroke_tessellator.h"
 #include "garnet/bin/ui/sketchy/stroke/divided_stroke_path.h"
 #include "garnet/bin/ui/sketchy/stroke/stroke_fitter.h"
 #include "garnet/bin/ui/sketchy/stroke/stroke_path.h"
@@ -26,7 +27,9 @@ class Stroke final : public Resource {
   static const ResourceTypeInfo kTypeInfo;
   const ResourceTypeInfo& type_info() const override { return kTypeInfo; }
 
-  Stroke(StrokeTessellator* tessellator, escher::BufferFactory* buffer_factory);
+  // Exactly one of |tessellator| and |cpu_tessellator| must be non-null.
+  Stroke(StrokeTessellator* tessellator, CpuStrokeTessellator* cpu_tessellator,
+         escher::BufferFactory* buffer_factory);
   bool SetPath(std::unique_ptr<StrokePath> path);
 
   bool Begin(glm::vec2 pt);
@@ -46,8 +49,14 @@ class Stroke final : public Resource {
                            escher::BufferFactory* buffer_factory,
                            const DividedStrokePath& path, bool is_stable);
 
+  // Tessellates the stroke with |cpu_tessellator_| into a staging buffer, and
+  // records the command to copy the mesh into |mesh_buffer|.
+  void TessellateOnCpuAndMerge(Frame* frame, MeshBuffer* mesh_buffer,
+                               const DividedStrokePath& delta_unstable_path);
+
   // TODO(SCN-269): Document how tessellator and fitter work together.
   StrokeTessellator* const tessellator_;
+  CpuStrokeTessellator* const cpu_tessellator_;
   std::unique_ptr<StrokeFitter> fitter_;
 
   // The stable part of the path that is taken from the fitter. Will be updated
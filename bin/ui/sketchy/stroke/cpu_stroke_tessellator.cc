@@ -0,0 +1,194 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/bin/ui/sketchy/stroke/cpu_stroke_tessellator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include <lib/async/cpp/task.h>
+
+#include "lib/escher/util/trace_macros.h"
+#include "lib/fxl/logging.h"
+
+namespace {
+
+// Divisions are handed out to the threads in chunks of this many.  Strokes
+// with no more divisions than this are tessellated on the calling thread.
+constexpr uint32_t kDivisionsPerChunk = 1024;
+
+// The helpers below use the same arithmetic as the kernel of
+// StrokeTessellator.  They are inlined into the loop over divisions, which has
+// no branches so that the compiler can vectorize it.
+inline float ReParamDivision(const sketchy_service::CubicBezier1f& bezier1f,
+                             float t) {
+  const float t_rest = 1 - t;
+  const float tmp3_0 = bezier1f.pts[0] * t_rest + bezier1f.pts[1] * t;
+  const float tmp3_1 = bezier1f.pts[1] * t_rest + bezier1f.pts[2] * t;
+  const float tmp3_2 = bezier1f.pts[2] * t_rest + bezier1f.pts[3] * t;
+  const float tmp2_0 = tmp3_0 * t_rest + tmp3_1 * t;
+  const float tmp2_1 = tmp3_1 * t_rest + tmp3_2 * t;
+  return tmp2_0 * t_rest + tmp2_1 * t;
+}
+
+inline void EvaluateDivisionPointAndNormal(
+    const sketchy_service::CubicBezier2f& bezier2f, float t, glm::vec2* point,
+    glm::vec2* normal) {
+  const float t_rest = 1 - t;
+  const glm::vec2 tmp3_0 = bezier2f.pts[0] * t_rest + bezier2f.pts[1] * t;
+  const glm::vec2 tmp3_1 = bezier2f.pts[1] * t_rest + bezier2f.pts[2] * t;
+  const glm::vec2 tmp3_2 = bezier2f.pts[2] * t_rest + bezier2f.pts[3] * t;
+  const glm::vec2 tmp2_0 = tmp3_0 * t_rest + tmp3_1 * t;
+  const glm::vec2 tmp2_1 = tmp3_1 * t_rest + tmp3_2 * t;
+  *point = tmp2_0 * t_rest + tmp2_1 * t;
+  const glm::vec2 tangent = glm::normalize(tmp2_1 - tmp2_0);
+  *normal = glm::vec2(-tangent.y, tangent.x);
+}
+
+}  // namespace
+
+namespace sketchy_service {
+
+static_assert(sizeof(StrokeVertex) == 4 * sizeof(float),
+              "StrokeVertex must match the layout of the kernel's Vertex.");
+
+CpuStrokeTessellator::CpuStrokeTessellator(uint32_t thread_count)
+    : thread_count_(thread_count) {
+  if (thread_count_ > 0) {
+    loop_ = std::make_unique<async::Loop>(&kAsyncLoopConfigNoAttachToThread);
+    for (uint32_t i = 0; i < thread_count_; ++i) {
+      loop_->StartThread("sketchy-tessellator");
+    }
+  }
+}
+
+CpuStrokeTessellator::~CpuStrokeTessellator() = default;
+
+void CpuStrokeTessellator::Tessellate(const DividedStrokePath& path,
+                                      const DividedStrokePath& trailing_path,
+                                      float half_width,
+                                      uint32_t base_vertex_index,
+                                      StrokeVertex* vertices,
+                                      uint32_t* indices) {
+  const uint32_t division_count =
+      path.division_count() + trailing_path.division_count();
+  TRACE_DURATION("gfx", "sketchy_service::CpuStrokeTessellator::Tessellate",
+                 "divisions", division_count);
+  if (division_count == 0) {
+    return;
+  }
+
+  segments_.clear();
+  AppendSegments(path, 0);
+  AppendSegments(trailing_path, path.division_count());
+
+  const uint32_t chunk_count =
+      (division_count + kDivisionsPerChunk - 1) / kDivisionsPerChunk;
+  std::atomic<uint32_t> next_chunk(0);
+
+  // Each thread takes the next chunk until none remain.
+  auto tessellate_chunks = [&] {
+    for (uint32_t chunk = next_chunk++; chunk < chunk_count;
+         chunk = next_chunk++) {
+      const uint32_t begin = chunk * kDivisionsPerChunk;
+      const uint32_t end = std::min(begin + kDivisionsPerChunk, division_count);
+      TessellateDivisions(begin, end, division_count, half_width,
+                          base_vertex_index, vertices, indices);
+    }
+  };
+
+  // The calling thread does its share of the work too.
+  const uint32_t task_count = std::min(thread_count_, chunk_count - 1);
+  std::mutex mutex;
+  std::condition_variable tasks_done;
+  uint32_t pending_task_count = task_count;
+  for (uint32_t i = 0; i < task_count; ++i) {
+    async::PostTask(loop_->dispatcher(), [&] {
+      tessellate_chunks();
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--pending_task_count == 0) {
+        tasks_done.notify_one();
+      }
+    });
+  }
+
+  tessellate_chunks();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  tasks_done.wait(lock,
+                  [&pending_task_count] { return pending_task_count == 0; });
+}
+
+void CpuStrokeTessellator::AppendSegments(const DividedStrokePath& path,
+                                          uint32_t division_offset) {
+  const auto& control_points = path.path().control_points();
+  const auto& re_params = path.path().re_params();
+  const auto& division_counts = path.division_counts();
+  const auto& cumulative_division_counts = path.cumulative_division_counts();
+  FXL_DCHECK(control_points.size() == division_counts.size());
+  for (size_t i = 0; i < division_counts.size(); ++i) {
+    segments_.push_back({&control_points[i], &re_params[i],
+                         division_offset + cumulative_division_counts[i],
+                         division_counts[i]});
+  }
+}
+
+void CpuStrokeTessellator::TessellateDivisions(
+    uint32_t begin, uint32_t end, uint32_t division_count, float half_width,
+    uint32_t base_vertex_index, StrokeVertex* vertices,
+    uint32_t* indices) const {
+  // Find the segment that contains the first division.
+  auto segment = std::upper_bound(segments_.begin(), segments_.end(), begin,
+                                  [](uint32_t division, const Segment& s) {
+                                    return division < s.division_offset;
+                                  });
+  FXL_DCHECK(segment != segments_.begin());
+  --segment;
+
+  for (uint32_t division = begin; division < end; ++segment) {
+    FXL_DCHECK(segment != segments_.end());
+    const CubicBezier2f control_points = *segment->control_points;
+    const CubicBezier1f re_params = *segment->re_params;
+    const uint32_t division_offset = segment->division_offset;
+    const float segment_division_count = segment->division_count;
+    const uint32_t segment_end =
+        std::min(end, division_offset + segment->division_count);
+
+    for (uint32_t i = division; i < segment_end; ++i) {
+      const float t_before_re_param =
+          float(i - division_offset) / segment_division_count;
+      const float t = ReParamDivision(re_params, t_before_re_param);
+      const float progress = float(i) / division_count;
+
+      vec2 point, normal;
+      EvaluateDivisionPointAndNormal(control_points, t, &point, &normal);
+      StrokeVertex* vertex = vertices + i * 2;
+      vertex[0].pos = point + normal * half_width;
+      vertex[0].uv = vec2(progress, 0);
+      vertex[1].pos = point - normal * half_width;
+      vertex[1].uv = vec2(progress, 0);
+    }
+    division = segment_end;
+  }
+
+  const uint32_t last_division = division_count - 1;
+  for (uint32_t i = begin; i < std::min(end, last_division); ++i) {
+    uint32_t* index = indices + i * 6;
+    const uint32_t vertex_index = base_vertex_index + i * 2;
+    index[0] = vertex_index;
+    index[1] = vertex_index + 1;
+    index[2] = vertex_index + 3;
+    index[3] = vertex_index;
+    index[4] = vertex_index + 3;
+    index[5] = vertex_index + 2;
+  }
+  if (end == division_count) {
+    // There're no corresponding vertices, so drop the last division.
+    std::fill(indices + last_division * 6, indices + division_count * 6, 0);
+  }
+}
+
+}  // namespace sketchy_service
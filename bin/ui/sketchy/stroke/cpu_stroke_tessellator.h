@@ -0,0 +1,73 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GARNET_BIN_UI_SKETCHY_STROKE_CPU_STROKE_TESSELLATOR_H_
+#define GARNET_BIN_UI_SKETCHY_STROKE_CPU_STROKE_TESSELLATOR_H_
+
+#include <memory>
+#include <vector>
+
+#include <lib/async-loop/cpp/loop.h>
+
+#include "garnet/bin/ui/sketchy/stroke/divided_stroke_path.h"
+#include "garnet/public/lib/fxl/macros.h"
+
+namespace sketchy_service {
+
+// Layout of the vertices that both tessellators write into a MeshBuffer.
+struct StrokeVertex {
+  vec2 pos;
+  vec2 uv;
+};
+
+// Tessellates strokes on the CPU, producing the same vertices and indices as
+// the compute kernel of StrokeTessellator.  Long strokes are split into chunks
+// of divisions, which are tessellated concurrently by the worker threads and
+// the calling thread.
+class CpuStrokeTessellator final {
+ public:
+  // Starts |thread_count| worker threads.  With zero, strokes are tessellated
+  // on the calling thread only.
+  explicit CpuStrokeTessellator(uint32_t thread_count);
+  ~CpuStrokeTessellator();
+
+  // Tessellates |path| followed by |trailing_path|, as the kernel does with
+  // the buffers of a Stroke.  |vertices| must have room for the vertex counts
+  // of both paths, and |indices| for their index counts.  The indices refer to
+  // vertices starting at |base_vertex_index|.
+  void Tessellate(const DividedStrokePath& path,
+                  const DividedStrokePath& trailing_path, float half_width,
+                  uint32_t base_vertex_index, StrokeVertex* vertices,
+                  uint32_t* indices);
+
+  uint32_t thread_count() const { return thread_count_; }
+
+ private:
+  struct Segment {
+    const CubicBezier2f* control_points;
+    const CubicBezier1f* re_params;
+    // Index of the first division of the segment within the whole stroke.
+    uint32_t division_offset;
+    uint32_t division_count;
+  };
+
+  void AppendSegments(const DividedStrokePath& path, uint32_t division_offset);
+
+  // Tessellates divisions [begin, end) of a stroke with |division_count|
+  // divisions.
+  void TessellateDivisions(uint32_t begin, uint32_t end,
+                           uint32_t division_count, float half_width,
+                           uint32_t base_vertex_index, StrokeVertex* vertices,
+                           uint32_t* indices) const;
+
+  const uint32_t thread_count_;
+  std::unique_ptr<async::Loop> loop_;
+  std::vector<Segment> segments_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(CpuStrokeTessellator);
+};
+
+}  // namespace sketchy_service
+
+#endif  // GARNET_BIN_UI_SKETCHY_STROKE_CPU_STROKE_TESSELLATOR_H_
@@ -39,6 +39,12 @@ class DividedStrokePath final {
   uint32_t vertex_count() const { return vertex_count_; }
   uint32_t index_count() const { return index_count_; }
   const escher::BoundingBox& bbox() const { return bbox_; }
+  const std::vector<uint32_t>& division_counts() const {
+    return division_counts_;
+  }
+  const std::vector<uint32_t>& cumulative_division_counts() const {
+    return cumulative_division_counts_;
+  }
   const void* control_points_data() const {
     return path_->control_points().data();
   }
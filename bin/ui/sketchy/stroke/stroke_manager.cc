@@ -7,8 +7,19 @@
 
 namespace sketchy_service {
 
-StrokeManager::StrokeManager(escher::EscherWeakPtr weak_escher)
-    : stroke_tessellator_(std::move(weak_escher)) {}
+StrokeManager::StrokeManager(escher::EscherWeakPtr weak_escher,
+                             const TessellatorConfig& tessellator_config) {
+  switch (tessellator_config.type) {
+    case TessellatorConfig::Type::kGpu:
+      stroke_tessellator_ =
+          std::make_unique<StrokeTessellator>(std::move(weak_escher));
+      break;
+    case TessellatorConfig::Type::kCpu:
+      cpu_stroke_tessellator_ = std::make_unique<CpuStrokeTessellator>(
+          tessellator_config.cpu_thread_count);
+      break;
+  }
+}
 
 bool StrokeManager::AddNewGroup(StrokeGroupPtr group) {
   group->SetNeedsReTessellation();
@@ -9,14 +9,25 @@
 #include "garnet/bin/ui/sketchy/resources/import_node.h"
 #include "garnet/bin/ui/sketchy/resources/stroke.h"
 #include "garnet/bin/ui/sketchy/resources/stroke_group.h"
+#include "garnet/bin/ui/sketchy/stroke/cpu_stroke_tessellator.h"
 #include "garnet/bin/ui/sketchy/stroke/stroke_tessellator.h"
 
 namespace sketchy_service {
 
+// Selects how strokes are tessellated.
+struct TessellatorConfig {
+  enum class Type { kGpu, kCpu };
+
+  Type type = Type::kGpu;
+  // Number of worker threads used by the CPU tessellator.
+  uint32_t cpu_thread_count = 0;
+};
+
 // Manages strokes and stroke groups.
 class StrokeManager {
  public:
-  explicit StrokeManager(escher::EscherWeakPtr escher);
+  StrokeManager(escher::EscherWeakPtr escher,
+                const TessellatorConfig& tessellator_config);
 
   bool AddNewGroup(StrokeGroupPtr group);
   bool AddStrokeToGroup(StrokePtr stroke, StrokeGroupPtr group);
@@ -35,13 +46,18 @@ class StrokeManager {
 
   void Update(Frame* frame);
 
-  StrokeTessellator* stroke_tessellator() { return &stroke_tessellator_; }
+  // Exactly one of the tessellators exists, depending on the configuration.
+  StrokeTessellator* stroke_tessellator() { return stroke_tessellator_.get(); }
+  CpuStrokeTessellator* cpu_stroke_tessellator() {
+    return cpu_stroke_tessellator_.get();
+  }
 
  private:
   std::map<StrokePtr, StrokeGroupPtr> stroke_to_group_map_;
   std::set<StrokeGroupPtr> dirty_stroke_groups_;
   // TODO(MZ-269): Only have a tessellator per app.
-  StrokeTessellator stroke_tessellator_;
+  std::unique_ptr<StrokeTessellator> stroke_tessellator_;
+  std::unique_ptr<CpuStrokeTessellator> cpu_stroke_tessellator_;
 };
 
 }  // namespace sketchy_service
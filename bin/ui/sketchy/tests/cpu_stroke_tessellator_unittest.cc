@@ -0,0 +1,185 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/bin/ui/sketchy/stroke/cpu_stroke_tessellator.h"
+
+#include <vector>
+
+#include "garnet/bin/ui/sketchy/stroke/divided_stroke_path.h"
+#include "garnet/bin/ui/sketchy/stroke/stroke_path.h"
+#include "gtest/gtest.h"
+
+namespace sketchy_service {
+namespace test {
+
+constexpr float kHalfWidth = 5.f;
+// Positions are evaluated on an arc-length re-parameterization that is only
+// approximate.
+constexpr float kPositionTolerance = 0.5f;
+constexpr uint32_t kSentinel = 0xdeadbeef;
+
+// Returns a straight cubic from |begin| to |end| with evenly spaced control
+// points, whose points move at a constant speed.
+CubicBezier2f StraightCubic(vec2 begin, vec2 end) {
+  return CubicBezier2f{{begin, begin + (end - begin) / 3.f,
+                        begin + (end - begin) * 2.f / 3.f, end}};
+}
+
+// Appends the straight cubics from |x_begin| to |x_end| along the x axis, each
+// |segment_length| long, to |path|.
+void ExtendAlongX(DividedStrokePath* path, float x_begin, float x_end,
+                  float segment_length) {
+  StrokePath delta_path;
+  for (float x = x_begin; x < x_end; x += segment_length) {
+    delta_path.ExtendWithCurve(
+        StraightCubic(vec2(x, 0.f), vec2(x + segment_length, 0.f)));
+  }
+  path->Extend(delta_path);
+}
+
+struct Mesh {
+  std::vector<StrokeVertex> vertices;
+  std::vector<uint32_t> indices;
+};
+
+Mesh Tessellate(uint32_t thread_count, const DividedStrokePath& path,
+                const DividedStrokePath& trailing_path,
+                uint32_t base_vertex_index = 0) {
+  Mesh mesh;
+  mesh.vertices.resize(path.vertex_count() + trailing_path.vertex_count(),
+                       {vec2(kSentinel), vec2(kSentinel)});
+  mesh.indices.resize(path.index_count() + trailing_path.index_count(),
+                      kSentinel);
+  CpuStrokeTessellator tessellator(thread_count);
+  tessellator.Tessellate(path, trailing_path, kHalfWidth, base_vertex_index,
+                         mesh.vertices.data(), mesh.indices.data());
+  return mesh;
+}
+
+// Expects two triangles per division that join the division's vertices to
+// the next division's, except for the last division, whose indices are zero.
+void ExpectIndexPattern(const Mesh& mesh, uint32_t base_vertex_index) {
+  const uint32_t division_count = mesh.vertices.size() / 2;
+  ASSERT_EQ(division_count * 6, mesh.indices.size());
+  for (uint32_t i = 0; i + 1 < division_count; ++i) {
+    const uint32_t* index = mesh.indices.data() + i * 6;
+    const uint32_t vertex_index = base_vertex_index + i * 2;
+    EXPECT_EQ(vertex_index, index[0]) << "division " << i;
+    EXPECT_EQ(vertex_index + 1, index[1]) << "division " << i;
+    EXPECT_EQ(vertex_index + 3, index[2]) << "division " << i;
+    EXPECT_EQ(vertex_index, index[3]) << "division " << i;
+    EXPECT_EQ(vertex_index + 3, index[4]) << "division " << i;
+    EXPECT_EQ(vertex_index + 2, index[5]) << "division " << i;
+  }
+  for (uint32_t i = (division_count - 1) * 6; i < division_count * 6; ++i) {
+    EXPECT_EQ(0u, mesh.indices[i]);
+  }
+}
+
+TEST(CpuStrokeTessellatorTest, StraightCubic) {
+  // 40 pixels at 10.5 pixels per division make 3 divisions.
+  DividedStrokePath path(kHalfWidth, 10.5f);
+  ExtendAlongX(&path, 0.f, 40.f, 40.f);
+  DividedStrokePath trailing_path(kHalfWidth, 10.5f);
+  ASSERT_EQ(3u, path.division_count());
+
+  constexpr uint32_t kBaseVertexIndex = 100;
+  Mesh mesh = Tessellate(0, path, trailing_path, kBaseVertexIndex);
+  ASSERT_EQ(6u, mesh.vertices.size());
+
+  // Each division has a vertex on either side of the line, |kHalfWidth| away.
+  for (uint32_t i = 0; i < 3; ++i) {
+    const float x = 40.f * i / 3;
+    const StrokeVertex* vertex = mesh.vertices.data() + i * 2;
+    EXPECT_NEAR(x, vertex[0].pos.x, kPositionTolerance);
+    EXPECT_FLOAT_EQ(kHalfWidth, vertex[0].pos.y);
+    EXPECT_NEAR(x, vertex[1].pos.x, kPositionTolerance);
+    EXPECT_FLOAT_EQ(-kHalfWidth, vertex[1].pos.y);
+    EXPECT_FLOAT_EQ(i / 3.f, vertex[0].uv.x);
+    EXPECT_FLOAT_EQ(0.f, vertex[0].uv.y);
+    EXPECT_FLOAT_EQ(i / 3.f, vertex[1].uv.x);
+    EXPECT_FLOAT_EQ(0.f, vertex[1].uv.y);
+  }
+
+  ExpectIndexPattern(mesh, kBaseVertexIndex);
+}
+
+// Tessellates a stroke of several chunks, whose boundaries fall in the middle
+// of segments, with and without worker threads. The stroke continues into
+// its trailing path in the middle of a chunk.
+TEST(CpuStrokeTessellatorTest, ChunksOnThreads) {
+  // 1000 pixels at 1.3 pixels per division make 769 divisions per segment.
+  constexpr float kSegmentLength = 1000.f;
+  constexpr uint32_t kDivisionsPerSegment = 769;
+  DividedStrokePath path(kHalfWidth, 1.3f);
+  ExtendAlongX(&path, 0.f, 3 * kSegmentLength, kSegmentLength);
+  DividedStrokePath trailing_path(kHalfWidth, 1.3f);
+  ExtendAlongX(&trailing_path, 3 * kSegmentLength, 5 * kSegmentLength,
+               kSegmentLength);
+  const uint32_t division_count =
+      path.division_count() + trailing_path.division_count();
+  ASSERT_EQ(5 * kDivisionsPerSegment, division_count);
+
+  Mesh mesh = Tessellate(0, path, trailing_path);
+  for (uint32_t i = 0; i < division_count; ++i) {
+    const uint32_t segment = i / kDivisionsPerSegment;
+    const float x = kSegmentLength * segment +
+                    kSegmentLength * (i % kDivisionsPerSegment) /
+                        kDivisionsPerSegment;
+    const StrokeVertex* vertex = mesh.vertices.data() + i * 2;
+    ASSERT_NEAR(x, vertex[0].pos.x, kPositionTolerance) << "division " << i;
+    ASSERT_FLOAT_EQ(kHalfWidth, vertex[0].pos.y) << "division " << i;
+    ASSERT_NEAR(x, vertex[1].pos.x, kPositionTolerance) << "division " << i;
+    ASSERT_FLOAT_EQ(-kHalfWidth, vertex[1].pos.y) << "division " << i;
+    ASSERT_EQ(float(i) / division_count, vertex[0].uv.x) << "division " << i;
+    ASSERT_EQ(float(i) / division_count, vertex[1].uv.x) << "division " << i;
+  }
+  ExpectIndexPattern(mesh, 0);
+
+  // Threads compute the same values, whichever chunks they take.
+  for (uint32_t thread_count : {1, 3, 8}) {
+    Mesh threaded_mesh = Tessellate(thread_count, path, trailing_path);
+    for (uint32_t i = 0; i < mesh.vertices.size(); ++i) {
+      ASSERT_EQ(mesh.vertices[i].pos, threaded_mesh.vertices[i].pos)
+          << thread_count << " threads, vertex " << i;
+      ASSERT_EQ(mesh.vertices[i].uv, threaded_mesh.vertices[i].uv)
+          << thread_count << " threads, vertex " << i;
+    }
+    EXPECT_EQ(mesh.indices, threaded_mesh.indices)
+        << thread_count << " threads";
+  }
+}
+
+// Tests that paths without divisions contribute nothing.
+TEST(CpuStrokeTessellatorTest, EmptyPaths) {
+  DividedStrokePath empty_path(kHalfWidth, 10.5f);
+  DividedStrokePath path(kHalfWidth, 10.5f);
+  ExtendAlongX(&path, 0.f, 40.f, 40.f);
+
+  // An empty path followed by a trailing path gives the mesh of the trailing
+  // path on its own.
+  Mesh mesh = Tessellate(0, path, empty_path);
+  Mesh trailing_mesh = Tessellate(0, empty_path, path);
+  ASSERT_EQ(mesh.vertices.size(), trailing_mesh.vertices.size());
+  for (uint32_t i = 0; i < mesh.vertices.size(); ++i) {
+    EXPECT_EQ(mesh.vertices[i].pos, trailing_mesh.vertices[i].pos);
+    EXPECT_EQ(mesh.vertices[i].uv, trailing_mesh.vertices[i].uv);
+  }
+  EXPECT_EQ(mesh.indices, trailing_mesh.indices);
+
+  // Without any divisions, nothing is written.
+  std::vector<StrokeVertex> vertices(2, {vec2(kSentinel), vec2(kSentinel)});
+  std::vector<uint32_t> indices(6, kSentinel);
+  CpuStrokeTessellator tessellator(3);
+  tessellator.Tessellate(empty_path, empty_path, kHalfWidth, 0,
+                         vertices.data(), indices.data());
+  for (const auto& vertex : vertices) {
+    EXPECT_EQ(vec2(kSentinel), vertex.pos);
+    EXPECT_EQ(vec2(kSentinel), vertex.uv);
+  }
+  EXPECT_EQ(std::vector<uint32_t>(6, kSentinel), indices);
+}
+
+}  // namespace test
+}  // namespace sketchy_service
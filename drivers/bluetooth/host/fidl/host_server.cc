@@ -33,6 +33,15 @@ using fuchsia::bluetooth::control::AdapterState;
 using fuchsia::bluetooth::control::RemoteDevice;
 using fuchsia::bluetooth::host::BondingData;
 
+namespace {
+
+// The minimum interval between OnDeviceUpdated events for the same device.
+// Devices that are actively advertising are updated with every scan result;
+// this bounds the event rate that a dense environment generates.
+constexpr zx::duration kDeviceUpdatedInterval = zx::msec(100);
+
+}  // namespace
+
 HostServer::HostServer(zx::channel channel,
                        fxl::WeakPtr<::btlib::gap::Adapter> adapter,
                        fbl::RefPtr<GattHost> gatt_host)
@@ -46,6 +55,8 @@ HostServer::HostServer(zx::channel channel,
   ZX_DEBUG_ASSERT(gatt_host_);
 
   auto self = weak_ptr_factory_.GetWeakPtr();
+  adapter->remote_device_cache()->set_device_updated_interval(
+      kDeviceUpdatedInterval);
   adapter->remote_device_cache()->set_device_updated_callback(
       [self](const auto& device) {
         if (self) {
@@ -14,12 +14,14 @@ namespace btlib {
 namespace att {
 namespace {
 
-bool StartLessThan(const AttributeGrouping& grp, const Handle handle) {
-  return grp.start_handle() < handle;
+bool StartLessThan(const std::unique_ptr<AttributeGrouping>& grp,
+                   const Handle handle) {
+  return grp->start_handle() < handle;
 }
 
-bool EndLessThan(const AttributeGrouping& grp, const Handle handle) {
-  return grp.end_handle() < handle;
+bool EndLessThan(const std::unique_ptr<AttributeGrouping>& grp,
+                 const Handle handle) {
+  return grp->end_handle() < handle;
 }
 
 }  // namespace
@@ -36,7 +38,7 @@ Database::Iterator::Iterator(GroupingList* list,
   if (type)
     type_filter_ = *type;
 
-  // Initialize the iterator by performing a binary search over the attributes.
+  // Initialize the iterator by performing a binary search over the groupings.
   // If we were asked to iterate over groupings only, then look strictly within
   // the range. Otherwise we allow the first grouping to partially overlap the
   // range.
@@ -47,30 +49,30 @@ Database::Iterator::Iterator(GroupingList* list,
     return;
 
   // If the first grouping is out of range then the iterator is done.
-  if (grp_iter_->start_handle() > end) {
+  if ((*grp_iter_)->start_handle() > end) {
     MarkEnd();
     return;
   }
 
-  if (start_ > grp_iter_->start_handle()) {
-    attr_offset_ = start_ - grp_iter_->start_handle();
+  if (start_ > (*grp_iter_)->start_handle()) {
+    attr_offset_ = start_ - (*grp_iter_)->start_handle();
   }
 
   // If the first is inactive or if it doesn't match the current filter then
   // skip ahead.
-  if (!grp_iter_->active() ||
+  if (!(*grp_iter_)->active() ||
       (type_filter_ &&
-       grp_iter_->attributes()[attr_offset_].type() != *type_filter_)) {
+       (*grp_iter_)->attributes()[attr_offset_].type() != *type_filter_)) {
     Advance();
   }
 }
 
 const Attribute* Database::Iterator::get() const {
-  if (AtEnd() || !grp_iter_->active())
+  if (AtEnd() || !(*grp_iter_)->active())
     return nullptr;
 
-  ZX_DEBUG_ASSERT(attr_offset_ < grp_iter_->attributes().size());
-  return &grp_iter_->attributes()[attr_offset_];
+  ZX_DEBUG_ASSERT(attr_offset_ < (*grp_iter_)->attributes().size());
+  return &(*grp_iter_)->attributes()[attr_offset_];
 }
 
 void Database::Iterator::Advance() {
@@ -78,17 +80,18 @@ void Database::Iterator::Advance() {
     return;
 
   do {
-    if (!grp_only_ && grp_iter_->active()) {
+    if (!grp_only_ && (*grp_iter_)->active()) {
       // If this grouping has more attributes to look at.
-      if (attr_offset_ < grp_iter_->attributes().size() - 1) {
-        size_t end_offset = grp_iter_->end_handle() - grp_iter_->start_handle();
-        ZX_DEBUG_ASSERT(end_offset < grp_iter_->attributes().size());
+      if (attr_offset_ < (*grp_iter_)->attributes().size() - 1) {
+        const auto& grp = *grp_iter_;
+        size_t end_offset = grp->end_handle() - grp->start_handle();
+        ZX_DEBUG_ASSERT(end_offset < (*grp_iter_)->attributes().size());
 
         // Advance.
         attr_offset_++;
 
         for (; attr_offset_ <= end_offset; ++attr_offset_) {
-          const auto& attr = grp_iter_->attributes()[attr_offset_];
+          const auto& attr = (*grp_iter_)->attributes()[attr_offset_];
 
           // If |end_| is within this grouping and we go past it, the iterator
           // is done.
@@ -116,18 +119,18 @@ void Database::Iterator::Advance() {
     if (AtEnd())
       return;
 
-    if (grp_iter_->start_handle() > end_) {
+    if ((*grp_iter_)->start_handle() > end_) {
       MarkEnd();
       return;
     }
 
-    if (!grp_iter_->active() || !grp_iter_->complete())
+    if (!(*grp_iter_)->active() || !(*grp_iter_)->complete())
       continue;
 
     // If there is no filter then we're done. Otherwise, loop until an
     // attribute is found that matches the filter. (NOTE: the group type is the
     // type of the first attribute).
-    if (!type_filter_ || (*type_filter_ == grp_iter_->group_type()))
+    if (!type_filter_ || (*type_filter_ == (*grp_iter_)->group_type()))
       return;
   } while (true);
 }
@@ -163,13 +166,13 @@ AttributeGrouping* Database::NewGrouping(const common::UUID& group_type,
 
     start_handle = range_start_;
     pos = groupings_.end();
-  } else if (groupings_.front().start_handle() - range_start_ > attr_count) {
+  } else if (groupings_.front()->start_handle() - range_start_ > attr_count) {
     // There is room at the head of the list.
     start_handle = range_start_;
     pos = groupings_.begin();
-  } else if (range_end_ - groupings_.back().end_handle() > attr_count) {
+  } else if (range_end_ - groupings_.back()->end_handle() > attr_count) {
     // There is room at the tail end of the list.
-    start_handle = groupings_.back().end_handle() + 1;
+    start_handle = groupings_.back()->end_handle() + 1;
     pos = groupings_.end();
   } else {
     // Linearly search for a gap that fits the new grouping.
@@ -181,7 +184,7 @@ AttributeGrouping* Database::NewGrouping(const common::UUID& group_type,
     pos++;
 
     for (; pos != groupings_.end(); ++pos, ++prev) {
-      size_t next_avail = pos->start_handle() - prev->end_handle() - 1;
+      size_t next_avail = (*pos)->start_handle() - (*prev)->end_handle() - 1;
       if (attr_count < next_avail)
         break;
     }
@@ -191,21 +194,22 @@ AttributeGrouping* Database::NewGrouping(const common::UUID& group_type,
       return nullptr;
     }
 
-    start_handle = prev->end_handle() + 1;
+    start_handle = (*prev)->end_handle() + 1;
   }
 
-  auto iter =
-      groupings_.emplace(pos, group_type, start_handle, attr_count, decl_value);
+  auto iter = groupings_.emplace(
+      pos, std::make_unique<AttributeGrouping>(group_type, start_handle,
+                                               attr_count, decl_value));
   ZX_DEBUG_ASSERT(iter != groupings_.end());
 
-  return &*iter;
+  return iter->get();
 }
 
 bool Database::RemoveGrouping(Handle start_handle) {
   auto iter = std::lower_bound(groupings_.begin(), groupings_.end(),
                                start_handle, StartLessThan);
 
-  if (iter == groupings_.end() || iter->start_handle() != start_handle)
+  if (iter == groupings_.end() || (*iter)->start_handle() != start_handle)
     return false;
 
   groupings_.erase(iter);
@@ -219,16 +223,17 @@ const Attribute* Database::FindAttribute(Handle handle) {
   // Do a binary search to find the grouping that this handle is in.
   auto iter = std::lower_bound(groupings_.begin(), groupings_.end(), handle,
                                EndLessThan);
-  if (iter == groupings_.end() || iter->start_handle() > handle)
+  if (iter == groupings_.end() || (*iter)->start_handle() > handle)
     return nullptr;
 
-  if (!iter->active() || !iter->complete())
+  const auto& grp = *iter;
+  if (!grp->active() || !grp->complete())
     return nullptr;
 
-  size_t index = handle - iter->start_handle();
-  ZX_DEBUG_ASSERT(index < iter->attributes().size());
+  size_t index = handle - grp->start_handle();
+  ZX_DEBUG_ASSERT(index < grp->attributes().size());
 
-  return &iter->attributes()[index];
+  return &grp->attributes()[index];
 }
 
 }  // namespace att
@@ -5,8 +5,8 @@
 #ifndef GARNET_DRIVERS_BLUETOOTH_LIB_ATT_DATABASE_H_
 #define GARNET_DRIVERS_BLUETOOTH_LIB_ATT_DATABASE_H_
 
-#include <list>
 #include <memory>
+#include <vector>
 
 #include "garnet/drivers/bluetooth/lib/att/att.h"
 #include "garnet/drivers/bluetooth/lib/att/attribute.h"
@@ -33,7 +33,7 @@ namespace att {
 // This class is not thread-safe. The constructor/destructor and all public
 // methods must be called on the same thread.
 class Database final : public fxl::RefCountedThreadSafe<Database> {
-  using GroupingList = std::list<AttributeGrouping>;
+  using GroupingList = std::vector<std::unique_ptr<AttributeGrouping>>;
 
  public:
   // This type allows iteration over the attributes in a database. An iterator
@@ -125,7 +125,7 @@ class Database final : public fxl::RefCountedThreadSafe<Database> {
   // false if no such grouping was found.
   bool RemoveGrouping(Handle start_handle);
 
-  const std::list<AttributeGrouping>& groupings() const { return groupings_; }
+  const GroupingList& groupings() const { return groupings_; }
 
   // Finds and returns the attribute with the given handle. Returns nullptr if
   // the attribute cannot be found or is part of a grouping that is inactive
@@ -141,13 +141,14 @@ class Database final : public fxl::RefCountedThreadSafe<Database> {
   Handle range_start_;
   Handle range_end_;
 
-  // The list of groupings is sorted by handle where each grouping maps to a
+  // The array of groupings is sorted by handle where each grouping maps to a
   // non-overlapping handle range. Successive groupings don't necessarily
   // represent contiguous handle ranges as any grouping can be removed.
   //
-  // Note: This uses a std::list because fbl::lower_bound doesn't work with a
-  // common::LinkedList (aka fbl::DoublyLinkedList). This is only marginally
-  // less space efficient.
+  // The groupings are individually allocated so that pointers returned by
+  // NewGrouping() (and the back-pointers held by each Attribute) remain valid
+  // as other groupings are inserted and removed. Keeping the pointers in a
+  // contiguous array allows handle lookups to use a binary search.
   GroupingList groupings_;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(Database);
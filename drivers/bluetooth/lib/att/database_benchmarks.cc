@@ -0,0 +1,103 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "database.h"
+
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+
+namespace btlib {
+namespace att {
+namespace {
+
+constexpr common::UUID kTestType1((uint16_t)1);
+constexpr common::UUID kTestType2((uint16_t)2);
+constexpr common::UUID kTestType3((uint16_t)3);
+
+const auto kTestValue = common::CreateStaticByteBuffer('x', 'x');
+
+// A database with |kGroupingCount| active groupings, each made up of a
+// declaration and |kAttrsPerGrouping| attributes, which is as large as a busy
+// GATT server's.
+constexpr size_t kGroupingCount = 2000;
+constexpr size_t kAttrsPerGrouping = 4;
+
+fxl::RefPtr<Database> NewDatabase() {
+  auto db = Database::Create();
+  for (size_t i = 0; i < kGroupingCount; i++) {
+    auto* grp = db->NewGrouping(kTestType1, kAttrsPerGrouping, kTestValue);
+    ZX_ASSERT(grp);
+    for (size_t j = 0; j < kAttrsPerGrouping; j++) {
+      grp->AddAttribute(j % 2 ? kTestType2 : kTestType3);
+    }
+    grp->set_active(true);
+  }
+  return db;
+}
+
+// Measures the time taken to look up a single attribute by handle.
+bool FindAttributeTest(perftest::RepeatState* state) {
+  auto db = NewDatabase();
+  const Handle last_handle = db->groupings().back()->end_handle();
+
+  Handle handle = kHandleMin;
+  while (state->KeepRunning()) {
+    ZX_ASSERT(db->FindAttribute(handle));
+    handle = handle == last_handle ? kHandleMin : handle + 1;
+  }
+  return true;
+}
+
+// Measures the time taken to visit every attribute of a type over the whole
+// database, one attribute per iterator, as the Read By Type requests of a
+// client discovering characteristics would.
+bool IterateByTypeTest(perftest::RepeatState* state) {
+  auto db = NewDatabase();
+  const Handle last_handle = db->groupings().back()->end_handle();
+
+  while (state->KeepRunning()) {
+    size_t visited = 0;
+    Handle next = kHandleMin;
+    while (next <= last_handle) {
+      auto iter = db->GetIterator(next, kHandleMax, &kTestType2);
+      if (iter.AtEnd())
+        break;
+      next = iter.get()->handle() + 1;
+      visited++;
+    }
+    ZX_ASSERT(visited == kGroupingCount * kAttrsPerGrouping / 2);
+  }
+  return true;
+}
+
+// Measures the time taken to visit every group declaration, as a Read By Group
+// Type request over the whole database would.
+bool IterateGroupsTest(perftest::RepeatState* state) {
+  auto db = NewDatabase();
+
+  while (state->KeepRunning()) {
+    size_t visited = 0;
+    auto iter = db->GetIterator(kHandleMin, kHandleMax, &kTestType1,
+                                true /* groups_only */);
+    for (; !iter.AtEnd(); iter.Advance()) {
+      visited++;
+    }
+    ZX_ASSERT(visited == kGroupingCount);
+  }
+  return true;
+}
+
+void RegisterTests() {
+  perftest::RegisterTest("Bluetooth/ATT/Database/FindAttribute",
+                         FindAttributeTest);
+  perftest::RegisterTest("Bluetooth/ATT/Database/IterateByType",
+                         IterateByTypeTest);
+  perftest::RegisterTest("Bluetooth/ATT/Database/IterateGroups",
+                         IterateGroupsTest);
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
+}  // namespace att
+}  // namespace btlib
@@ -4,6 +4,9 @@
 
 #include "socket_channel_relay.h"
 
+#include <string.h>
+
+#include <memory>
 #include <utility>
 
 #include <lib/async/default.h>
@@ -23,6 +26,7 @@ SocketChannelRelay::SocketChannelRelay(zx::socket socket,
       channel_(channel),
       dispatcher_(async_get_default_dispatcher()),
       deactivation_cb_(std::move(deactivation_cb)),
+      tx_read_buffer_(channel_->tx_mtu() + 1),
       weak_ptr_factory_(this) {
   ZX_DEBUG_ASSERT(dispatcher_);
   ZX_DEBUG_ASSERT(socket_);
@@ -191,19 +195,17 @@ void SocketChannelRelay::OnChannelClosed() {
 }
 
 bool SocketChannelRelay::CopyFromSocketToChannel() {
-  // Subtle: we make the read buffer larger than the TX MTU, so that we can
-  // detect truncated datagrams.
-  const size_t read_buf_size = channel_->tx_mtu() + 1;
+  const size_t read_buf_size = tx_read_buffer_.size();
 
   // TODO(NET-1390): Consider yielding occasionally. As-is, we run the risk of
   // starving other SocketChannelRelays on the same |dispatcher| (and anyone
   // else on |dispatcher|), if a misbehaving process spams its L2CAP socket. And
   // even if starvation isn't an issue, latency/jitter might be.
   zx_status_t read_res;
-  uint8_t read_buf[read_buf_size];
   do {
     size_t n_bytes_read = 0;
-    read_res = socket_.read(0, read_buf, read_buf_size, &n_bytes_read);
+    read_res = socket_.read(0, tx_read_buffer_.mutable_data(), read_buf_size,
+                            &n_bytes_read);
     ZX_DEBUG_ASSERT_MSG(read_res == ZX_OK || read_res == ZX_ERR_SHOULD_WAIT ||
                             read_res == ZX_ERR_PEER_CLOSED,
                         "%s", zx_status_get_string(read_res));
@@ -227,11 +229,18 @@ bool SocketChannelRelay::CopyFromSocketToChannel() {
       return false;
     }
 
+    // The SDU gets a buffer of its own, of exactly its size, as it may stay
+    // queued for a while. It is not zero-filled, since the datagram is copied
+    // over it right away.
+    //
     // TODO(NET-1391): For low latency and low jitter, IWBN to avoid allocating
     // dynamic memory on every read.
+    std::unique_ptr<uint8_t[]> sdu_buf(new uint8_t[n_bytes_read]);
+    memcpy(sdu_buf.get(), tx_read_buffer_.data(), n_bytes_read);
+    copy_stats_.tx_bytes += n_bytes_read;
     bool write_success =
         channel_->Send(std::make_unique<common::DynamicByteBuffer>(
-            common::BufferView(read_buf, n_bytes_read)));
+            n_bytes_read, std::move(sdu_buf)));
     if (!write_success) {
       bt_log(DEBUG, "l2cap", "Failed to write %zu bytes to channel %u",
              n_bytes_read, channel_->id());
@@ -254,28 +263,23 @@ void SocketChannelRelay::ServiceSocketWriteQueue() {
     ZX_DEBUG_ASSERT(socket_write_queue_.front().length());
 
     const l2cap::SDU& sdu = socket_write_queue_.front();
-    const bool read_success = l2cap::PDU::Reader(&sdu).ReadNext(
-        sdu.length(), [&](const common::ByteBuffer& pdu) {
-          size_t n_bytes_written = 0;
-          write_res =
-              socket_.write(0, pdu.data(), pdu.size(), &n_bytes_written);
-          ZX_DEBUG_ASSERT_MSG(write_res == ZX_OK ||
-                                  write_res == ZX_ERR_SHOULD_WAIT ||
-                                  write_res == ZX_ERR_PEER_CLOSED,
-                              "%s", zx_status_get_string(write_res));
-          if (write_res != ZX_OK) {
-            ZX_DEBUG_ASSERT(n_bytes_written == 0);
-            bt_log(SPEW, "l2cap",
-                   "Failed to write %zu bytes to socket for channel %u: %s",
-                   pdu.size(), channel_->id(), zx_status_get_string(write_res));
-            return;
-          }
-          ZX_DEBUG_ASSERT_MSG(n_bytes_written == pdu.size(),
-                              "(n_bytes_written=%zu, pdu.size()=%zu)",
-                              n_bytes_written, pdu.size());
-          socket_write_queue_.pop_front();
-        });
-    ZX_DEBUG_ASSERT(read_success);
+    const common::BufferView pdu = ViewSdu(sdu);
+    size_t n_bytes_written = 0;
+    write_res = socket_.write(0, pdu.data(), pdu.size(), &n_bytes_written);
+    ZX_DEBUG_ASSERT_MSG(write_res == ZX_OK || write_res == ZX_ERR_SHOULD_WAIT ||
+                            write_res == ZX_ERR_PEER_CLOSED,
+                        "%s", zx_status_get_string(write_res));
+    if (write_res != ZX_OK) {
+      ZX_DEBUG_ASSERT(n_bytes_written == 0);
+      bt_log(SPEW, "l2cap",
+             "Failed to write %zu bytes to socket for channel %u: %s",
+             pdu.size(), channel_->id(), zx_status_get_string(write_res));
+      break;
+    }
+    ZX_DEBUG_ASSERT_MSG(n_bytes_written == pdu.size(),
+                        "(n_bytes_written=%zu, pdu.size()=%zu)",
+                        n_bytes_written, pdu.size());
+    socket_write_queue_.pop_front();
   } while (write_res == ZX_OK && !socket_write_queue_.empty());
 
   if (!socket_write_queue_.empty() && write_res == ZX_ERR_SHOULD_WAIT) {
@@ -307,6 +311,25 @@ void SocketChannelRelay::ServiceSocketWriteQueue() {
   }
 }
 
+common::BufferView SocketChannelRelay::ViewSdu(const l2cap::SDU& sdu) {
+  // An SDU that arrived in a single ACL data fragment is written to the socket
+  // directly out of that fragment.
+  if (sdu.fragment_count() == 1) {
+    return sdu.ViewFirstFragment(sdu.length());
+  }
+
+  // Otherwise, the fragments have to be gathered, as each SDU must be written
+  // to the socket in a single operation to preserve SDU boundaries. The gather
+  // buffer is reused across SDUs and only grows.
+  if (rx_gather_buffer_.size() < sdu.length()) {
+    rx_gather_buffer_ = common::DynamicByteBuffer(sdu.length());
+  }
+  const size_t n_bytes_copied = sdu.Copy(&rx_gather_buffer_);
+  ZX_DEBUG_ASSERT(n_bytes_copied == sdu.length());
+  copy_stats_.rx_bytes += n_bytes_copied;
+  return rx_gather_buffer_.view(0, n_bytes_copied);
+}
+
 void SocketChannelRelay::BindWait(zx_signals_t trigger, const char* wait_name,
                                   async::Wait* wait,
                                   fit::function<void(zx_status_t)> handler) {
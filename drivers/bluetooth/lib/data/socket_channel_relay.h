@@ -14,6 +14,7 @@
 #include "lib/fxl/synchronization/thread_checker.h"
 #include "lib/zx/socket.h"
 
+#include "garnet/drivers/bluetooth/lib/common/byte_buffer.h"
 #include "garnet/drivers/bluetooth/lib/l2cap/channel.h"
 
 namespace btlib {
@@ -30,6 +31,15 @@ class SocketChannelRelay final {
  public:
   using DeactivationCallback = fit::function<void(l2cap::ChannelId)>;
 
+  // Bytes copied in user space by the relay itself, in each direction. Copies
+  // made by the socket and by the L2CAP layer are not included.
+  struct CopyStats {
+    // Datagrams read from the socket, copied into SDUs of their own size.
+    size_t tx_bytes = 0;
+    // Fragmented SDUs, gathered before being written to the socket.
+    size_t rx_bytes = 0;
+  };
+
   // Creates a SocketChannelRelay which executes on |dispatcher|. Note that
   // |dispatcher| must be single-threaded.
   //
@@ -63,6 +73,8 @@ class SocketChannelRelay final {
   // of |this| directly.
   __WARN_UNUSED_RESULT bool Activate();
 
+  const CopyStats& copy_stats_for_testing() const { return copy_stats_; }
+
  private:
   enum class RelayState {
     kActivating,
@@ -104,6 +116,11 @@ class SocketChannelRelay final {
   // Copies any data pending in |socket_write_queue_| to |socket_|.
   void ServiceSocketWriteQueue();
 
+  // Returns a contiguous view of the payload of |sdu|, gathering its fragments
+  // into |rx_gather_buffer_| if necessary. The view is valid until the next
+  // call.
+  common::BufferView ViewSdu(const l2cap::SDU& sdu);
+
   // Binds an async::Wait to a |handler|, but does not enable the wait.
   // The handler will be wrapped in code that verifies that |this| has not begun
   // destruction.
@@ -139,6 +156,16 @@ class SocketChannelRelay final {
   // TODO(NET-1476): We should set an upper bound on the size of this queue.
   std::deque<l2cap::SDU> socket_write_queue_;
 
+  // Holds the payload of a fragmented SDU while it is written to |socket_|.
+  common::DynamicByteBuffer rx_gather_buffer_;
+
+  // Receives each datagram read from |socket_|, before it is copied into an
+  // SDU of its size. Subtle: the buffer is larger than the TX MTU, so that we
+  // can detect truncated datagrams.
+  common::DynamicByteBuffer tx_read_buffer_;
+
+  CopyStats copy_stats_;
+
   const fxl::ThreadChecker thread_checker_;
   fxl::WeakPtrFactory<SocketChannelRelay> weak_ptr_factory_;  // Keep last.
 
@@ -346,6 +346,30 @@ TEST_F(DATA_SocketChannelRelayRxTest,
       kExpectedMessage2, ReadDatagramFromSocket(kExpectedMessage2.size())));
 }
 
+TEST_F(DATA_SocketChannelRelayRxTest,
+       FragmentedSdusFromChannelAreCopiedToSocketPreservingSduBoundaries) {
+  // Large enough to span several ACL data fragments.
+  common::DynamicByteBuffer large_sdu(4000);
+  for (size_t i = 0; i < large_sdu.size(); i++) {
+    large_sdu[i] = static_cast<uint8_t>(i);
+  }
+  common::DynamicByteBuffer small_sdu(1500);
+  small_sdu.Fill('s');
+
+  ASSERT_TRUE(relay()->Activate());
+  channel()->Receive(large_sdu);
+  channel()->Receive(small_sdu);
+  channel()->Receive(large_sdu);
+  RunLoopUntilIdle();
+
+  EXPECT_TRUE(common::ContainersEqual(
+      large_sdu, ReadDatagramFromSocket(large_sdu.size())));
+  EXPECT_TRUE(common::ContainersEqual(
+      small_sdu, ReadDatagramFromSocket(small_sdu.size())));
+  EXPECT_TRUE(common::ContainersEqual(
+      large_sdu, ReadDatagramFromSocket(large_sdu.size())));
+}
+
 TEST_F(DATA_SocketChannelRelayRxTest,
        SduFromChannelIsCopiedToSocketWhenSocketUnblocks) {
   size_t n_junk_bytes = StuffSocket();
@@ -628,6 +652,37 @@ TEST_F(DATA_SocketChannelRelayTxTest,
   EXPECT_TRUE(common::ContainersEqual(kExpectedMessage, *sdus[2]));
 }
 
+TEST_F(DATA_SocketChannelRelayTxTest, SdusFromSocketAreAllocatedAtTheirSize) {
+  const auto kExpectedMessage =
+      common::CreateStaticByteBuffer('h', 'e', 'l', 'l', 'o');
+  const size_t kNumMessages = 3;
+  ASSERT_TRUE(relay()->Activate());
+
+  for (size_t i = 0; i < kNumMessages; ++i) {
+    size_t n_bytes_written = 0;
+    const auto write_res = remote_socket()->write(
+        0, kExpectedMessage.data(), kExpectedMessage.size(), &n_bytes_written);
+    ASSERT_EQ(ZX_OK, write_res);
+    ASSERT_EQ(kExpectedMessage.size(), n_bytes_written);
+  }
+
+  RunLoopUntilIdle();
+
+  // Each SDU is of its own size, rather than of the size of the read buffer.
+  const auto& sdus = sent_to_channel();
+  ASSERT_EQ(kNumMessages, sdus.size());
+  for (const auto& sdu : sdus) {
+    ASSERT_TRUE(sdu);
+    EXPECT_EQ(kExpectedMessage.size(), sdu->size());
+    EXPECT_TRUE(common::ContainersEqual(kExpectedMessage, *sdu));
+  }
+
+  // Each datagram is copied once, from the read buffer into its SDU.
+  EXPECT_EQ(kNumMessages * kExpectedMessage.size(),
+            relay()->copy_stats_for_testing().tx_bytes);
+  EXPECT_EQ(0u, relay()->copy_stats_for_testing().rx_bytes);
+}
+
 TEST_F(DATA_SocketChannelRelayTxTest, OversizedSduIsDropped) {
   const size_t kMessageBufSize = channel()->tx_mtu() * 5;
   common::DynamicByteBuffer large_message(kMessageBufSize);
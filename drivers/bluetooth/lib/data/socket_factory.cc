@@ -63,5 +63,14 @@ zx::socket SocketFactory::MakeSocketForChannel(
   return remote_socket;
 }
 
+const internal::SocketChannelRelay::CopyStats*
+SocketFactory::relay_copy_stats_for_testing(l2cap::ChannelId channel_id) const {
+  auto iter = channel_to_relay_.find(channel_id);
+  if (iter == channel_to_relay_.end()) {
+    return nullptr;
+  }
+  return &iter->second->copy_stats_for_testing();
+}
+
 }  // namespace data
 }  // namespace btlib
@@ -55,6 +55,11 @@ class SocketFactory {
   // Returns the new socket on success, and an invalid socket otherwise.
   zx::socket MakeSocketForChannel(fbl::RefPtr<l2cap::Channel> channel);
 
+  // Returns the copy stats of the relay for |channel_id|, or nullptr if the
+  // channel is not bound to a socket.
+  const internal::SocketChannelRelay::CopyStats* relay_copy_stats_for_testing(
+      l2cap::ChannelId channel_id) const;
+
  private:
   const fxl::ThreadChecker thread_checker_;
 
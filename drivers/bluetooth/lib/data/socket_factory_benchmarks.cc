@@ -0,0 +1,156 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "socket_factory.h"
+
+#include <algorithm>
+#include <memory>
+
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+
+#include "garnet/drivers/bluetooth/lib/l2cap/channel_manager.h"
+#include "garnet/drivers/bluetooth/lib/testing/fake_controller_harness.h"
+#include "garnet/drivers/bluetooth/lib/testing/fake_device.h"
+#include "lib/fxl/macros.h"
+
+namespace btlib {
+namespace data {
+namespace {
+
+constexpr size_t kLEMTU = 251;
+constexpr size_t kLENumPackets = 8;
+
+// FakeController assigns connection handles starting at 1.
+constexpr hci::ConnectionHandle kHandle = 0x0001;
+
+// Connects a fake LE device and relays its SMP channel, which the fake device
+// ignores, to a socket through the SocketFactory.
+class DataPath final {
+ public:
+  DataPath()
+      : harness_(hci::DataBufferInfo(),
+                 hci::DataBufferInfo(kLEMTU, kLENumPackets)) {
+    const common::DeviceAddress kAddress(common::DeviceAddress::Type::kLEPublic,
+                                         "00:00:00:00:00:01");
+    harness_.test_device()->AddDevice(
+        std::make_unique<testing::FakeDevice>(kAddress));
+    harness_.test_device()->ConnectLowEnergy(kAddress);
+    harness_.RunLoopUntilIdle();
+
+    chanmgr_ = std::make_unique<l2cap::ChannelManager>(harness_.transport(),
+                                                       harness_.dispatcher());
+    chanmgr_->RegisterLE(kHandle, hci::Connection::Role::kMaster, [](auto) {},
+                         [] {}, harness_.dispatcher());
+    channel_ = chanmgr_->OpenFixedChannel(kHandle, l2cap::kLESMPChannelId);
+    ZX_ASSERT(channel_);
+
+    socket_ = socket_factory_.MakeSocketForChannel(channel_);
+    ZX_ASSERT(socket_);
+  }
+
+  ~DataPath() {
+    socket_.reset();
+    channel_ = nullptr;
+    chanmgr_ = nullptr;
+  }
+
+  // Sends |frame| to the host in fragments of up to |kLEMTU| bytes.
+  void SendFragmented(const common::ByteBuffer& frame) {
+    for (size_t offset = 0; offset < frame.size(); offset += kLEMTU) {
+      const size_t size = std::min(kLEMTU, frame.size() - offset);
+      common::DynamicByteBuffer packet(sizeof(hci::ACLDataHeader) + size);
+      common::MutablePacketView<hci::ACLDataHeader> acl(&packet, size);
+      const uint16_t pbf = offset ? 0x1000 : 0x0000;
+      acl.mutable_header()->handle_and_flags = htole16(kHandle | pbf);
+      acl.mutable_header()->data_total_length =
+          htole16(static_cast<uint16_t>(size));
+      acl.mutable_payload_data().Write(frame.view(offset, size));
+      harness_.test_device()->SendACLDataChannelPacket(packet);
+    }
+  }
+
+  testing::FakeControllerHarness* harness() { return &harness_; }
+  l2cap::Channel* channel() const { return channel_.get(); }
+  const zx::socket& socket() const { return socket_; }
+
+ private:
+  testing::FakeControllerHarness harness_;
+  std::unique_ptr<l2cap::ChannelManager> chanmgr_;
+  fbl::RefPtr<l2cap::Channel> channel_;
+  SocketFactory socket_factory_;
+  zx::socket socket_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(DataPath);
+};
+
+// Measures the time taken to write an SDU to the socket and deliver it to the
+// controller.
+bool SocketToControllerTest(perftest::RepeatState* state) {
+  // The fake device does not recombine fragments, so stick to SDUs that fit in
+  // a single ACL data packet.
+  constexpr size_t kSduSize = kLEMTU - sizeof(l2cap::BasicHeader);
+  state->SetBytesProcessedPerRun(kSduSize);
+
+  DataPath path;
+  common::DynamicByteBuffer sdu(kSduSize);
+  sdu.Fill('d');
+
+  size_t received = 0;
+  path.harness()->test_device()->SetDataCallback(
+      [&received](const common::ByteBuffer& packet) {
+        received += packet.size() - sizeof(hci::ACLDataHeader) -
+                    sizeof(l2cap::BasicHeader);
+      },
+      path.harness()->dispatcher());
+
+  while (state->KeepRunning()) {
+    received = 0;
+    size_t n_bytes_written = 0;
+    ZX_ASSERT(path.socket().write(0, sdu.data(), sdu.size(),
+                                  &n_bytes_written) == ZX_OK);
+    ZX_ASSERT(n_bytes_written == sdu.size());
+    path.harness()->RunLoopUntilIdle();
+    ZX_ASSERT(received == kSduSize);
+  }
+  return true;
+}
+
+// Measures the time taken to deliver an SDU that spans several ACL data
+// fragments from the controller and read it from the socket.
+bool ControllerToSocketTest(perftest::RepeatState* state) {
+  DataPath path;
+  const size_t sdu_size = path.channel()->rx_mtu();
+  state->SetBytesProcessedPerRun(sdu_size);
+
+  common::DynamicByteBuffer frame(sizeof(l2cap::BasicHeader) + sdu_size);
+  common::MutablePacketView<l2cap::BasicHeader> bframe(&frame, sdu_size);
+  bframe.mutable_header()->length = htole16(static_cast<uint16_t>(sdu_size));
+  bframe.mutable_header()->channel_id = htole16(l2cap::kLESMPChannelId);
+  bframe.mutable_payload_data().Fill('d');
+
+  common::DynamicByteBuffer read_buf(sdu_size);
+  while (state->KeepRunning()) {
+    path.SendFragmented(frame);
+    path.harness()->RunLoopUntilIdle();
+
+    size_t n_bytes_read = 0;
+    ZX_ASSERT(path.socket().read(0, read_buf.mutable_data(), read_buf.size(),
+                                 &n_bytes_read) == ZX_OK);
+    ZX_ASSERT(n_bytes_read == sdu_size);
+  }
+  return true;
+}
+
+void RegisterTests() {
+  perftest::RegisterTest("Bluetooth/Data/SocketToController",
+                         SocketToControllerTest);
+  perftest::RegisterTest("Bluetooth/Data/ControllerToSocket",
+                         ControllerToSocketTest);
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
+}  // namespace data
+}  // namespace btlib
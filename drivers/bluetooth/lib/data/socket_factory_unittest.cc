@@ -4,13 +4,20 @@
 
 #include "socket_factory.h"
 
+#include <algorithm>
 #include <memory>
 
 #include <lib/async-loop/cpp/loop.h>
+#include <zircon/assert.h>
 
 #include "gtest/gtest.h"
 
+#include "garnet/drivers/bluetooth/lib/common/test_helpers.h"
+#include "garnet/drivers/bluetooth/lib/l2cap/channel_manager.h"
 #include "garnet/drivers/bluetooth/lib/l2cap/fake_channel.h"
+#include "garnet/drivers/bluetooth/lib/testing/fake_controller.h"
+#include "garnet/drivers/bluetooth/lib/testing/fake_controller_test.h"
+#include "garnet/drivers/bluetooth/lib/testing/fake_device.h"
 
 namespace btlib {
 namespace data {
@@ -95,6 +102,177 @@ TEST_F(DATA_SocketFactoryTest, DestructionAfterDeactivatingRelayDoesNotCrash) {
   // |socket_factory| is destroyed implicitly.
 }
 
+using FakeControllerTestingBase =
+    ::btlib::testing::FakeControllerTest<::btlib::testing::FakeController>;
+
+// Streams SDUs between a socket and a FakeController, through the
+// SocketFactory, the L2CAP layer and the ACL data channel.
+class DATA_SocketFactoryDataPathTest : public FakeControllerTestingBase {
+ public:
+  DATA_SocketFactoryDataPathTest() = default;
+  ~DATA_SocketFactoryDataPathTest() override = default;
+
+ protected:
+  static constexpr size_t kLEMTU = 251;
+  static constexpr size_t kLENumPackets = 8;
+  static constexpr size_t kSduCount = 20;
+
+  void SetUp() override {
+    FakeControllerTestingBase::SetUp();
+    InitializeACLDataChannel(hci::DataBufferInfo(),
+                             hci::DataBufferInfo(kLEMTU, kLENumPackets));
+    chanmgr_ = std::make_unique<l2cap::ChannelManager>(transport(),
+                                                       dispatcher());
+    StartTestDevice();
+
+    const common::DeviceAddress kAddress(common::DeviceAddress::Type::kLEPublic,
+                                         "00:00:00:00:00:01");
+    test_device()->AddDevice(
+        std::make_unique<::btlib::testing::FakeDevice>(kAddress));
+    test_device()->ConnectLowEnergy(kAddress);
+    RunLoopUntilIdle();
+
+    // FakeController assigns connection handles starting at 1. The fake device
+    // ignores SMP traffic, which makes the SMP channel a convenient sink.
+    chanmgr_->RegisterLE(kHandle, hci::Connection::Role::kMaster, [](auto) {},
+                         [] {}, dispatcher());
+    channel_ = chanmgr_->OpenFixedChannel(kHandle, l2cap::kLESMPChannelId);
+    ASSERT_TRUE(channel_);
+
+    socket_factory_ = std::make_unique<SocketFactory>();
+    socket_ = socket_factory_->MakeSocketForChannel(channel_);
+    ASSERT_TRUE(socket_);
+  }
+
+  void TearDown() override {
+    socket_.reset();
+    socket_factory_ = nullptr;
+    channel_ = nullptr;
+    chanmgr_ = nullptr;
+    FakeControllerTestingBase::TearDown();
+  }
+
+  // Sends |frame| to the host in fragments of up to |kLEMTU| bytes.
+  void SendFragmented(const common::ByteBuffer& frame) {
+    for (size_t offset = 0; offset < frame.size(); offset += kLEMTU) {
+      const size_t size = std::min(kLEMTU, frame.size() - offset);
+      common::DynamicByteBuffer packet(sizeof(hci::ACLDataHeader) + size);
+      common::MutablePacketView<hci::ACLDataHeader> acl(&packet, size);
+      const uint16_t pbf = offset ? 0x1000 : 0x0000;
+      acl.mutable_header()->handle_and_flags = htole16(kHandle | pbf);
+      acl.mutable_header()->data_total_length =
+          htole16(static_cast<uint16_t>(size));
+      acl.mutable_payload_data().Write(frame.view(offset, size));
+      test_device()->SendACLDataChannelPacket(packet);
+    }
+  }
+
+  l2cap::Channel* channel() const { return channel_.get(); }
+  const zx::socket& socket() const { return socket_; }
+
+  const internal::SocketChannelRelay::CopyStats& copy_stats() const {
+    auto stats =
+        socket_factory_->relay_copy_stats_for_testing(l2cap::kLESMPChannelId);
+    ZX_ASSERT(stats);
+    return *stats;
+  }
+
+ private:
+  static constexpr hci::ConnectionHandle kHandle = 0x0001;
+
+  std::unique_ptr<l2cap::ChannelManager> chanmgr_;
+  fbl::RefPtr<l2cap::Channel> channel_;
+  std::unique_ptr<SocketFactory> socket_factory_;
+  zx::socket socket_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(DATA_SocketFactoryDataPathTest);
+};
+
+TEST_F(DATA_SocketFactoryDataPathTest, SocketToController) {
+  // The fake device does not recombine fragments, so stick to SDUs that fit in
+  // a single ACL data packet.
+  constexpr size_t kSduSize = kLEMTU - sizeof(l2cap::BasicHeader);
+  common::DynamicByteBuffer sdu(kSduSize);
+  sdu.Fill('d');
+
+  size_t received = 0;
+  test_device()->SetDataCallback(
+      [&received](const common::ByteBuffer& packet) {
+        received += packet.size() - sizeof(hci::ACLDataHeader) -
+                    sizeof(l2cap::BasicHeader);
+      },
+      dispatcher());
+
+  for (size_t i = 0; i < kSduCount; i++) {
+    size_t n_bytes_written = 0;
+    ASSERT_EQ(ZX_OK,
+              socket().write(0, sdu.data(), sdu.size(), &n_bytes_written));
+    ASSERT_EQ(sdu.size(), n_bytes_written);
+    RunLoopUntilIdle();
+  }
+
+  EXPECT_EQ(kSduCount * kSduSize, received);
+
+  // The relay copies each SDU once, out of its read buffer.
+  EXPECT_EQ(kSduCount * kSduSize, copy_stats().tx_bytes);
+  EXPECT_EQ(0u, copy_stats().rx_bytes);
+}
+
+TEST_F(DATA_SocketFactoryDataPathTest, ControllerToSocket) {
+  // Each SDU spans several ACL data fragments.
+  const size_t sdu_size = channel()->rx_mtu();
+  common::DynamicByteBuffer frame(sizeof(l2cap::BasicHeader) + sdu_size);
+  common::MutablePacketView<l2cap::BasicHeader> bframe(&frame, sdu_size);
+  bframe.mutable_header()->length = htole16(static_cast<uint16_t>(sdu_size));
+  bframe.mutable_header()->channel_id = htole16(l2cap::kLESMPChannelId);
+  for (size_t i = 0; i < sdu_size; i++) {
+    bframe.mutable_payload_bytes()[i] = static_cast<uint8_t>(i);
+  }
+
+  common::DynamicByteBuffer read_buf(sdu_size);
+  for (size_t i = 0; i < kSduCount; i++) {
+    SendFragmented(frame);
+    RunLoopUntilIdle();
+
+    size_t n_bytes_read = 0;
+    read_buf.SetToZeros();
+    ASSERT_EQ(ZX_OK, socket().read(0, read_buf.mutable_data(), read_buf.size(),
+                                   &n_bytes_read));
+    ASSERT_EQ(sdu_size, n_bytes_read);
+    EXPECT_TRUE(common::ContainersEqual(bframe.payload_data(), read_buf));
+  }
+
+  // The fragments of each SDU are gathered once, to write the SDU to the
+  // socket in a single operation.
+  EXPECT_EQ(kSduCount * sdu_size, copy_stats().rx_bytes);
+  EXPECT_EQ(0u, copy_stats().tx_bytes);
+}
+
+TEST_F(DATA_SocketFactoryDataPathTest, UnfragmentedSdusAreNotCopied) {
+  constexpr size_t kSduSize = kLEMTU - sizeof(l2cap::BasicHeader);
+  common::DynamicByteBuffer frame(sizeof(l2cap::BasicHeader) + kSduSize);
+  common::MutablePacketView<l2cap::BasicHeader> bframe(&frame, kSduSize);
+  bframe.mutable_header()->length = htole16(static_cast<uint16_t>(kSduSize));
+  bframe.mutable_header()->channel_id = htole16(l2cap::kLESMPChannelId);
+  bframe.mutable_payload_data().Fill('d');
+
+  common::DynamicByteBuffer read_buf(kSduSize);
+  for (size_t i = 0; i < kSduCount; i++) {
+    SendFragmented(frame);
+    RunLoopUntilIdle();
+
+    size_t n_bytes_read = 0;
+    ASSERT_EQ(ZX_OK, socket().read(0, read_buf.mutable_data(), read_buf.size(),
+                                   &n_bytes_read));
+    ASSERT_EQ(kSduSize, n_bytes_read);
+    EXPECT_TRUE(common::ContainersEqual(bframe.payload_data(), read_buf));
+  }
+
+  // SDUs which arrive in a single ACL data packet are written to the socket
+  // straight out of that packet.
+  EXPECT_EQ(0u, copy_stats().rx_bytes);
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace btlib
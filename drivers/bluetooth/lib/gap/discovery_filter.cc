@@ -6,6 +6,9 @@
 
 #include <endian.h>
 
+#include <algorithm>
+#include <limits>
+
 #include "garnet/drivers/bluetooth/lib/common/byte_buffer.h"
 #include "garnet/drivers/bluetooth/lib/gap/advertising_data.h"
 #include "garnet/drivers/bluetooth/lib/hci/low_energy_scanner.h"
@@ -14,55 +17,45 @@ namespace btlib {
 namespace gap {
 namespace {
 
-bool MatchUuids(const std::vector<common::UUID>& uuids,
-                const common::BufferView& data,
-                size_t uuid_size) {
-  if (data.size() % uuid_size) {
-    bt_log(WARN, "gap", "malformed service UUIDs list");
-    return false;
-  }
+template <typename T>
+bool Contains(const std::vector<T>& values, T value) {
+  return std::find(values.begin(), values.end(), value) != values.end();
+}
 
-  size_t uuid_count = data.size() / uuid_size;
-  for (size_t i = 0; i < uuid_count; i++) {
-    const common::BufferView uuid_bytes(data.data() + i * uuid_size, uuid_size);
-    for (const auto& uuid : uuids) {
-      if (uuid.CompareBytes(uuid_bytes))
-        return true;
-    }
+// Returns the size of the UUIDs in a service UUID list field of type |type|,
+// or 0 if fields of |type| aren't service UUID lists.
+size_t ServiceUuidElemSize(DataType type) {
+  switch (type) {
+    case DataType::kIncomplete16BitServiceUuids:
+    case DataType::kComplete16BitServiceUuids:
+      return k16BitUuidElemSize;
+    case DataType::kIncomplete32BitServiceUuids:
+    case DataType::kComplete32BitServiceUuids:
+      return k32BitUuidElemSize;
+    case DataType::kIncomplete128BitServiceUuids:
+    case DataType::kComplete128BitServiceUuids:
+      return k128BitUuidElemSize;
+    default:
+      return 0;
   }
-
-  return false;
 }
 
-}  // namespace
-
-void DiscoveryFilter::SetGeneralDiscoveryFlags() {
-  set_flags(static_cast<uint8_t>(AdvFlag::kLEGeneralDiscoverableMode) |
-            static_cast<uint8_t>(AdvFlag::kLELimitedDiscoverableMode));
+// Returns the Company Identifier Code of a manufacturer-specific data field.
+uint16_t ManufacturerCode(const common::BufferView& data) {
+  return le16toh(*reinterpret_cast<const uint16_t*>(data.data()));
 }
 
-bool DiscoveryFilter::MatchLowEnergyResult(
-    const common::ByteBuffer& advertising_data,
-    bool connectable,
-    int8_t rssi) const {
-  // No need to iterate over |advertising_data| for the |connectable_| filter.
-  if (connectable_ && *connectable_ != connectable)
-    return false;
-
-  // If a pathloss filter is not set then apply the RSSI filter before iterating
-  // over |advertising_data|. (An RSSI value of kRSSIInvalid means that RSSI is
-  // not available, which we check for here).
-  bool rssi_ok = !rssi_ || (rssi != hci::kRSSIInvalid && rssi >= *rssi_);
-  if (!pathloss_ && !rssi_ok)
-    return false;
+}  // namespace
 
-  // Filters that require iterating over advertising data.
-  bool flags_ok = !flags_;
-  bool service_uuids_ok = service_uuids_.empty();
-  bool name_ok = name_substring_.empty();
-  bool manufacturer_ok = !manufacturer_code_;
-  bool pathloss_ok = !pathloss_;
-  bool tx_power_found = false;
+bool AdvertisingDataFields::Parse(const common::ByteBuffer& advertising_data) {
+  flags.Reset();
+  tx_power.Reset();
+  complete_name = common::BufferView();
+  shortened_name = common::BufferView();
+  manufacturer_code_count = 0;
+  service_uuid_list_count = 0;
+  this->advertising_data = advertising_data.view();
+  overflowed = false;
 
   AdvertisingDataReader reader(advertising_data);
   if (advertising_data.size() && !reader.is_valid())
@@ -72,104 +65,160 @@ bool DiscoveryFilter::MatchLowEnergyResult(
   common::BufferView data;
   while (reader.GetNextField(&type, &data)) {
     switch (type) {
-      case DataType::kFlags: {
-        if (flags_ok)
-          break;
-
+      case DataType::kFlags:
         // The Flags field may be zero or more octets long for potential future
         // extension. We only care about the first octet.
         if (data.size() < kFlagsSizeMin) {
           bt_log(WARN, "gap", "malformed flags field");
           break;
         }
-
-        // We check if all bits in |flags_| are present in the data.
-        uint8_t masked_flags = data[0] & *flags_;
-        flags_ok =
-            all_flags_required_ ? (masked_flags == *flags_) : !!masked_flags;
-
+        if (!flags)
+          flags = data[0];
         break;
-      }
-      case DataType::kTxPowerLevel: {
-        if (pathloss_ok)
-          break;
-
+      case DataType::kTxPowerLevel:
         if (data.size() != kTxPowerLevelSize) {
           bt_log(WARN, "gap", "malformed tx-power level");
           break;
         }
-
-        tx_power_found = true;
-
-        // An RSSI value of kRSSIInvalid means that RSSI is not available.
-        if (rssi == hci::kRSSIInvalid)
-          break;
-
-        int8_t tx_power_lvl = static_cast<int8_t>(*data.data());
-        if (tx_power_lvl < rssi) {
-          bt_log(WARN, "gap", "reported tx-power level is less than the RSSI");
-          break;
-        }
-
-        int8_t pathloss = tx_power_lvl - rssi;
-        pathloss_ok = (pathloss <= *pathloss_);
+        if (!tx_power)
+          tx_power = static_cast<int8_t>(data[0]);
         break;
-      }
       case DataType::kCompleteLocalName:
-      case DataType::kShortenedLocalName: {
-        if (name_ok)
-          break;
-
-        auto name = data.AsString();
-        name_ok = (name.find(name_substring_) != fxl::StringView::npos);
+        complete_name = data;
+        break;
+      case DataType::kShortenedLocalName:
+        shortened_name = data;
         break;
-      }
       case DataType::kManufacturerSpecificData:
-        if (manufacturer_ok)
-          break;
-
         // The first two octets of the manufacturer specific data field contains
         // the Company Identifier Code.
         if (data.size() < kManufacturerSpecificDataSizeMin) {
           bt_log(WARN, "gap", "malformed manufacturer-specific data");
           break;
         }
-
-        manufacturer_ok =
-            (le16toh(*reinterpret_cast<const uint16_t*>(data.data())) ==
-             *manufacturer_code_);
-        break;
-      case DataType::kIncomplete16BitServiceUuids:
-      case DataType::kComplete16BitServiceUuids:
-        if (!service_uuids_ok) {
-          service_uuids_ok =
-              MatchUuids(service_uuids_, data, k16BitUuidElemSize);
-        }
-        break;
-      case DataType::kIncomplete32BitServiceUuids:
-      case DataType::kComplete32BitServiceUuids:
-        if (!service_uuids_ok) {
-          service_uuids_ok =
-              MatchUuids(service_uuids_, data, k32BitUuidElemSize);
-        }
-        break;
-      case DataType::kIncomplete128BitServiceUuids:
-      case DataType::kComplete128BitServiceUuids:
-        if (!service_uuids_ok) {
-          service_uuids_ok =
-              MatchUuids(service_uuids_, data, k128BitUuidElemSize);
+        if (manufacturer_code_count < manufacturer_codes.size()) {
+          manufacturer_codes[manufacturer_code_count++] =
+              ManufacturerCode(data);
+        } else {
+          overflowed = true;
         }
         break;
       default:
         break;
     }
+
+    size_t uuid_size = ServiceUuidElemSize(type);
+    if (!uuid_size)
+      continue;
+
+    if (data.size() % uuid_size) {
+      bt_log(WARN, "gap", "malformed service UUIDs list");
+      continue;
+    }
+    if (service_uuid_list_count < service_uuids.size()) {
+      service_uuids[service_uuid_list_count++] = {data, uuid_size};
+    } else {
+      overflowed = true;
+    }
+  }
+
+  return true;
+}
+
+void DiscoveryFilter::set_service_uuids(
+    const std::vector<common::UUID>& service_uuids) {
+  service_uuids_ = service_uuids;
+  service_uuids16_.clear();
+  service_uuids32_.clear();
+
+  for (const auto& uuid : service_uuids_) {
+    // SIG-assigned UUIDs store their 32-bit value in the most significant
+    // octets of the Base UUID.
+    uint32_t value32 =
+        le32toh(*reinterpret_cast<const uint32_t*>(uuid.value().data() + 12));
+    if (uuid != value32)
+      continue;
+
+    service_uuids32_.push_back(value32);
+    if (value32 <= std::numeric_limits<uint16_t>::max()) {
+      service_uuids16_.push_back(static_cast<uint16_t>(value32));
+    }
+  }
+}
+
+void DiscoveryFilter::SetGeneralDiscoveryFlags() {
+  set_flags(static_cast<uint8_t>(AdvFlag::kLEGeneralDiscoverableMode) |
+            static_cast<uint8_t>(AdvFlag::kLELimitedDiscoverableMode));
+}
+
+bool DiscoveryFilter::MatchLowEnergyResult(
+    const common::ByteBuffer& advertising_data,
+    bool connectable,
+    int8_t rssi) const {
+  AdvertisingDataFields fields;
+  if (!fields.Parse(advertising_data))
+    return false;
+  return MatchLowEnergyResult(fields, connectable, rssi);
+}
+
+bool DiscoveryFilter::MatchLowEnergyResult(const AdvertisingDataFields& fields,
+                                           bool connectable,
+                                           int8_t rssi) const {
+  if (connectable_ && *connectable_ != connectable)
+    return false;
+
+  // If a pathloss filter is not set then apply the RSSI filter before looking
+  // at advertising data. (An RSSI value of kRSSIInvalid means that RSSI is not
+  // available, which we check for here).
+  bool rssi_ok = !rssi_ || (rssi != hci::kRSSIInvalid && rssi >= *rssi_);
+  if (!pathloss_ && !rssi_ok)
+    return false;
+
+  if (flags_) {
+    if (!fields.flags)
+      return false;
+
+    // We check if all bits in |flags_| are present in the data.
+    uint8_t masked_flags = *fields.flags & *flags_;
+    bool flags_ok =
+        all_flags_required_ ? (masked_flags == *flags_) : !!masked_flags;
+    if (!flags_ok)
+      return false;
+  }
+
+  if (!name_substring_.empty()) {
+    bool name_ok = false;
+    for (const auto& name : {fields.complete_name, fields.shortened_name}) {
+      if (name.size() &&
+          name.AsString().find(name_substring_) != fxl::StringView::npos) {
+        name_ok = true;
+        break;
+      }
+    }
+    if (!name_ok)
+      return false;
   }
 
-  // If the pathloss filter failed, then fall back to RSSI if requested.
-  if (!pathloss_ok) {
+  if (manufacturer_code_ && !MatchManufacturerCode(fields))
+    return false;
+
+  if (!service_uuids_.empty() && !MatchServiceUuids(fields))
+    return false;
+
+  if (pathloss_) {
+    // An RSSI value of kRSSIInvalid means that RSSI is not available.
+    if (fields.tx_power && rssi != hci::kRSSIInvalid) {
+      if (*fields.tx_power < rssi) {
+        bt_log(WARN, "gap", "reported tx-power level is less than the RSSI");
+      } else if (static_cast<int8_t>(*fields.tx_power - rssi) <= *pathloss_) {
+        return true;
+      }
+    }
+
     // No match if the Tx Power Level was provided and the computed pathloss
-    // value was not within the threshold.
-    if (tx_power_found)
+    // value was not within the threshold. Otherwise fall back to RSSI if
+    // requested.
+    if (fields.tx_power)
       return false;
 
     // If no RSSI filter was set OR if one was set but it didn't match the scan
@@ -178,11 +227,89 @@ bool DiscoveryFilter::MatchLowEnergyResult(
       return false;
   }
 
-  return flags_ok && service_uuids_ok && name_ok && manufacturer_ok;
+  return true;
+}
+
+bool DiscoveryFilter::MatchServiceUuids(
+    const AdvertisingDataFields& fields) const {
+  for (size_t i = 0; i < fields.service_uuid_list_count; i++) {
+    if (MatchServiceUuidList(fields.service_uuids[i]))
+      return true;
+  }
+  if (!fields.overflowed)
+    return false;
+
+  // Some lists weren't retained, so look through all of them.
+  AdvertisingDataReader reader(fields.advertising_data);
+  DataType type;
+  common::BufferView data;
+  while (reader.GetNextField(&type, &data)) {
+    size_t uuid_size = ServiceUuidElemSize(type);
+    if (uuid_size && !(data.size() % uuid_size) &&
+        MatchServiceUuidList({data, uuid_size}))
+      return true;
+  }
+  return false;
+}
+
+bool DiscoveryFilter::MatchServiceUuidList(
+    const AdvertisingDataFields::ServiceUuidList& list) const {
+  const uint8_t* elem = list.data.data();
+  const uint8_t* end = elem + list.data.size();
+  for (; elem != end; elem += list.elem_size) {
+    switch (list.elem_size) {
+      case k16BitUuidElemSize: {
+        uint16_t value = le16toh(*reinterpret_cast<const uint16_t*>(elem));
+        if (Contains(service_uuids16_, value))
+          return true;
+        break;
+      }
+      case k32BitUuidElemSize: {
+        uint32_t value = le32toh(*reinterpret_cast<const uint32_t*>(elem));
+        if (Contains(service_uuids32_, value))
+          return true;
+        break;
+      }
+      default: {
+        const auto& value = *reinterpret_cast<const common::UInt128*>(elem);
+        for (const auto& uuid : service_uuids_) {
+          if (uuid == value)
+            return true;
+        }
+        break;
+      }
+    }
+  }
+  return false;
+}
+
+bool DiscoveryFilter::MatchManufacturerCode(
+    const AdvertisingDataFields& fields) const {
+  auto codes_end =
+      fields.manufacturer_codes.begin() + fields.manufacturer_code_count;
+  if (std::find(fields.manufacturer_codes.begin(), codes_end,
+                *manufacturer_code_) != codes_end)
+    return true;
+  if (!fields.overflowed)
+    return false;
+
+  // Some codes weren't retained, so look through all of them.
+  AdvertisingDataReader reader(fields.advertising_data);
+  DataType type;
+  common::BufferView data;
+  while (reader.GetNextField(&type, &data)) {
+    if (type == DataType::kManufacturerSpecificData &&
+        data.size() >= kManufacturerSpecificDataSizeMin &&
+        ManufacturerCode(data) == *manufacturer_code_)
+      return true;
+  }
+  return false;
 }
 
 void DiscoveryFilter::Reset() {
   service_uuids_.clear();
+  service_uuids16_.clear();
+  service_uuids32_.clear();
   name_substring_.clear();
   connectable_.Reset();
   manufacturer_code_.Reset();
@@ -5,23 +5,62 @@
 #ifndef GARNET_DRIVERS_BLUETOOTH_LIB_GAP_DISCOVERY_FILTER_H_
 #define GARNET_DRIVERS_BLUETOOTH_LIB_GAP_DISCOVERY_FILTER_H_
 
+#include <array>
 #include <string>
 #include <vector>
 
+#include "garnet/drivers/bluetooth/lib/common/byte_buffer.h"
 #include "garnet/drivers/bluetooth/lib/common/optional.h"
 #include "garnet/drivers/bluetooth/lib/common/uuid.h"
 #include "garnet/drivers/bluetooth/lib/hci/hci_constants.h"
 
 namespace btlib {
 
-namespace common {
-class ByteBuffer;
-}  // namespace common
-
 namespace gap {
 
 class RemoteDevice;
 
+// The subset of LE advertising data fields that DiscoveryFilter operates on.
+// Parsing a scan result once into this structure allows it to be matched
+// against the filters of any number of discovery sessions without walking the
+// advertising data again for each of them.
+//
+// Parse() does not allocate. The views stored here point into the buffer that
+// was parsed, which must outlive this object.
+struct AdvertisingDataFields final {
+  // The maximum number of service UUID lists and manufacturer-specific data
+  // fields that are retained. If there are more fields of these types,
+  // |overflowed| is set and matching walks |advertising_data| for them.
+  static constexpr size_t kMaxServiceUuidLists = 6;
+  static constexpr size_t kMaxManufacturerCodes = 4;
+
+  struct ServiceUuidList {
+    common::BufferView data;
+    size_t elem_size;
+  };
+
+  // Parses |advertising_data|. Returns false if the data is malformed, in
+  // which case the contents of this structure should not be used. Malformed
+  // individual fields are logged and skipped.
+  bool Parse(const common::ByteBuffer& advertising_data);
+
+  common::Optional<uint8_t> flags;
+  common::Optional<int8_t> tx_power;
+  common::BufferView complete_name;
+  common::BufferView shortened_name;
+
+  std::array<uint16_t, kMaxManufacturerCodes> manufacturer_codes;
+  size_t manufacturer_code_count = 0;
+
+  std::array<ServiceUuidList, kMaxServiceUuidLists> service_uuids;
+  size_t service_uuid_list_count = 0;
+
+  // The data that was parsed, and whether some of its service UUID lists or
+  // manufacturer codes didn't fit in the arrays above.
+  common::BufferView advertising_data;
+  bool overflowed = false;
+};
+
 // A DiscoveryFilter allows clients of discovery procedures to filter results
 // based on certain parameters, such as service UUIDs that might be present in
 // EIR or advertising data, or based on available proximity information, to name
@@ -49,9 +88,7 @@ class DiscoveryFilter final {
   //
   // Passing an empty value for |service_uuids| effectively disables this
   // filter.
-  void set_service_uuids(const std::vector<common::UUID>& service_uuids) {
-    service_uuids_ = service_uuids;
-  }
+  void set_service_uuids(const std::vector<common::UUID>& service_uuids);
 
   // Sets a string to be matched against the device name. A scan result
   // satisifes this filter if part of the complete or shortened device name
@@ -108,11 +145,37 @@ class DiscoveryFilter final {
                             bool connectable,
                             int8_t rssi) const;
 
+  // Same as above but operates on advertising data that has already been
+  // parsed. This is preferred when the same scan result is matched against
+  // several filters.
+  bool MatchLowEnergyResult(const AdvertisingDataFields& fields,
+                            bool connectable,
+                            int8_t rssi) const;
+
   // Clears all the fields of this filter.
   void Reset();
 
  private:
+  // Returns true if any of the service UUIDs in |fields| is one of
+  // |service_uuids_|.
+  bool MatchServiceUuids(const AdvertisingDataFields& fields) const;
+
+  // Returns true if any of the UUIDs in |list| is one of |service_uuids_|.
+  bool MatchServiceUuidList(
+      const AdvertisingDataFields::ServiceUuidList& list) const;
+
+  // Returns true if |fields| contain |manufacturer_code_|.
+  bool MatchManufacturerCode(const AdvertisingDataFields& fields) const;
+
   std::vector<common::UUID> service_uuids_;
+
+  // The values of the SIG-assigned UUIDs in |service_uuids_| that can be
+  // represented in 16 or 32 bits. These are computed when the filter is set so
+  // that the 16-bit and 32-bit UUID lists in advertising data can be matched
+  // without constructing a UUID for each element.
+  std::vector<uint16_t> service_uuids16_;
+  std::vector<uint32_t> service_uuids32_;
+
   std::string name_substring_;
   common::Optional<uint8_t> flags_;
   bool all_flags_required_;
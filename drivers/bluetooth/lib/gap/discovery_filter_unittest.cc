@@ -560,6 +560,39 @@ TEST(GAP_DiscoveryFilterTest, ManufacturerCode) {
       filter.MatchLowEnergyResult(kInvalidData1, false, hci::kRSSIInvalid));
 }
 
+// Tests that fields beyond those retained by AdvertisingDataFields still
+// match.
+TEST(GAP_DiscoveryFilterTest, FieldsBeyondRetainedCount) {
+  // Six empty service UUID lists and four manufacturer-specific data fields
+  // that don't match, followed by one of each that does.
+  const auto kData = common::CreateStaticByteBuffer(
+      0x01, 0x02, 0x01, 0x02, 0x01, 0x02, 0x01, 0x02, 0x01, 0x02, 0x01, 0x02,
+      0x03, 0x03, 0x0d, 0x18,
+      0x03, 0xFF, 0x4C, 0x00, 0x03, 0xFF, 0x4C, 0x00, 0x03, 0xFF, 0x4C, 0x00,
+      0x03, 0xFF, 0x4C, 0x00,
+      0x03, 0xFF, 0xE0, 0x00);
+
+  AdvertisingDataFields fields;
+  ASSERT_TRUE(fields.Parse(kData));
+  EXPECT_TRUE(fields.overflowed);
+  EXPECT_EQ(AdvertisingDataFields::kMaxServiceUuidLists,
+            fields.service_uuid_list_count);
+  EXPECT_EQ(AdvertisingDataFields::kMaxManufacturerCodes,
+            fields.manufacturer_code_count);
+
+  DiscoveryFilter filter;
+  filter.set_service_uuids({common::UUID(uint16_t(0x180d))});
+  EXPECT_TRUE(filter.MatchLowEnergyResult(fields, false, hci::kRSSIInvalid));
+  filter.set_service_uuids({common::UUID(uint16_t(0x180f))});
+  EXPECT_FALSE(filter.MatchLowEnergyResult(fields, false, hci::kRSSIInvalid));
+
+  filter.Reset();
+  filter.set_manufacturer_code(0x00E0);
+  EXPECT_TRUE(filter.MatchLowEnergyResult(fields, false, hci::kRSSIInvalid));
+  filter.set_manufacturer_code(0x0075);
+  EXPECT_FALSE(filter.MatchLowEnergyResult(fields, false, hci::kRSSIInvalid));
+}
+
 TEST(GAP_DiscoveryFilterTest, Combined) {
   constexpr int8_t kMatchingPathlossThreshold = 70;
   constexpr int8_t kNotMatchingPathlossThreshold = 69;
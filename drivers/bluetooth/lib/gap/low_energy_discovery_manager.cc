@@ -14,6 +14,23 @@
 
 namespace btlib {
 namespace gap {
+namespace {
+
+// Returns a FNV-1a hash of the contents of an advertising report.
+size_t HashScanResult(bool connectable, const common::ByteBuffer& data) {
+  size_t hash = 14695981039346656037ull;
+  auto mix = [&hash](uint8_t byte) {
+    hash ^= byte;
+    hash *= 1099511628211ull;
+  };
+  mix(connectable);
+  for (uint8_t byte : data) {
+    mix(byte);
+  }
+  return hash;
+}
+
+}  // namespace
 
 LowEnergyDiscoverySession::LowEnergyDiscoverySession(
     fxl::WeakPtr<LowEnergyDiscoveryManager> manager)
@@ -32,10 +49,15 @@ void LowEnergyDiscoverySession::SetResultCallback(
   device_found_callback_ = std::move(callback);
   if (!manager_)
     return;
-  for (const auto& cached_device_id : manager_->cached_scan_results()) {
-    auto device = manager_->device_cache()->FindDeviceById(cached_device_id);
+  AdvertisingDataFields fields;
+  for (const auto& iter : manager_->cached_scan_results()) {
+    auto device =
+        manager_->device_cache()->FindDeviceById(iter.second.device_id);
     ZX_DEBUG_ASSERT(device);
-    NotifyDiscoveryResult(*device);
+    ZX_DEBUG_ASSERT(device->le());
+    if (fields.Parse(device->le()->advertising_data())) {
+      NotifyDiscoveryResult(*device, fields);
+    }
   }
 }
 
@@ -49,11 +71,11 @@ void LowEnergyDiscoverySession::Stop() {
 }
 
 void LowEnergyDiscoverySession::NotifyDiscoveryResult(
-    const RemoteDevice& device) const {
+    const RemoteDevice& device, const AdvertisingDataFields& fields) const {
   ZX_DEBUG_ASSERT(device.le());
   if (device_found_callback_ &&
-      filter_.MatchLowEnergyResult(device.le()->advertising_data(),
-                                   device.connectable(), device.rssi())) {
+      filter_.MatchLowEnergyResult(fields, device.connectable(),
+                                   device.rssi())) {
     device_found_callback_(device);
   }
 }
@@ -188,16 +210,45 @@ void LowEnergyDiscoveryManager::OnDeviceFound(
     return;
   }
 
+  size_t data_hash = HashScanResult(result.connectable, data);
+  auto iter = cached_scan_results_.find(result.address);
   auto device = device_cache_->FindDeviceByAddress(result.address);
+
+  // A report that repeats the contents last seen from the device in this scan
+  // period only refreshes its RSSI and expiration; sessions have already been
+  // notified of it.
+  if (device && iter != cached_scan_results_.end() &&
+      iter->second.data_hash == data_hash &&
+      iter->second.device_id == device->identifier()) {
+    device->MutLe().SetAdvertisingRssi(result.rssi);
+    return;
+  }
+
   if (!device) {
     device = device_cache_->NewDevice(result.address, result.connectable);
   }
   device->MutLe().SetAdvertisingData(result.rssi, data);
 
-  cached_scan_results_.insert(device->identifier());
+  if (iter == cached_scan_results_.end()) {
+    cached_scan_results_.emplace(
+        result.address, CachedScanResult{device->identifier(), data_hash});
+  } else {
+    // The entry may be stale if the device was removed from the cache and
+    // re-created during this scan period.
+    if (iter->second.device_id != device->identifier()) {
+      iter->second.device_id = device->identifier();
+    }
+    iter->second.data_hash = data_hash;
+  }
+
+  // Parse the advertising data once for all sessions. Malformed data does not
+  // satisfy any filter.
+  AdvertisingDataFields fields;
+  if (!fields.Parse(data))
+    return;
 
   for (const auto& session : sessions_) {
-    session->NotifyDiscoveryResult(*device);
+    session->NotifyDiscoveryResult(*device, fields);
   }
 }
 
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <queue>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <lib/async/dispatcher.h>
@@ -152,7 +153,9 @@ class LowEnergyDiscoverySession final {
       fxl::WeakPtr<LowEnergyDiscoveryManager> manager);
 
   // Called by LowEnergyDiscoveryManager on newly discovered scan results.
-  void NotifyDiscoveryResult(const RemoteDevice& device) const;
+  // |fields| must have been parsed from the advertising data of |device|.
+  void NotifyDiscoveryResult(const RemoteDevice& device,
+                             const AdvertisingDataFields& fields) const;
 
   // Marks this session as inactive and notifies the error handler.
   void NotifyError();
@@ -211,7 +214,16 @@ class LowEnergyDiscoveryManager final : public hci::LowEnergyScanner::Delegate {
 
   const RemoteDeviceCache* device_cache() const { return device_cache_; }
 
-  const std::unordered_set<std::string>& cached_scan_results() const {
+  // An entry in the scan result cache. |data_hash| identifies the contents of
+  // the most recently processed report from the device.
+  struct CachedScanResult {
+    std::string device_id;
+    size_t data_hash;
+  };
+  using ScanResultCache =
+      std::unordered_map<common::DeviceAddress, CachedScanResult>;
+
+  const ScanResultCache& cached_scan_results() const {
     return cached_scan_results_;
   }
 
@@ -262,13 +274,19 @@ class LowEnergyDiscoveryManager final : public hci::LowEnergyScanner::Delegate {
   // started on the insertion of the first element.
   std::unordered_set<LowEnergyDiscoverySession*> sessions_;
 
-  // Identifiers for the cached scan results for the current scan period during
-  // device discovery. The minimum (and default) scan period is 10.24 seconds
-  // when performing LE discovery. This can cause a long wait for a discovery
-  // session that joined in the middle of a scan period and duplicate filtering
-  // is enabled. We maintain this cache to immediately notify new sessions of
-  // the currently cached results for this period.
-  std::unordered_set<std::string> cached_scan_results_;
+  // The cached scan results for the current scan period during device
+  // discovery, keyed by advertiser address. The minimum (and default) scan
+  // period is 10.24 seconds when performing LE discovery. This can cause a long
+  // wait for a discovery session that joined in the middle of a scan period
+  // and duplicate filtering is enabled. We maintain this cache to immediately
+  // notify new sessions of the currently cached results for this period.
+  //
+  // The cache also serves as a host-side duplicate filter: a report that
+  // carries the same data as the last one seen from its advertiser during this
+  // scan period is dropped. Controllers track a limited number of advertisers
+  // for duplicate filtering and in dense environments will report the same
+  // advertisement repeatedly.
+  ScanResultCache cached_scan_results_;
 
   // The value (in ms) that we use for the duration of each scan period.
   int64_t scan_period_ = kLEGeneralDiscoveryScanMinMs;
@@ -0,0 +1,158 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/drivers/bluetooth/lib/gap/low_energy_discovery_manager.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include <lib/zx/time.h>
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+
+#include "garnet/drivers/bluetooth/lib/gap/remote_device_cache.h"
+#include "garnet/drivers/bluetooth/lib/hci/hci.h"
+#include "garnet/drivers/bluetooth/lib/testing/fake_controller_harness.h"
+
+namespace btlib {
+namespace gap {
+namespace {
+
+constexpr size_t kAdvertiserCount = 1000;
+constexpr size_t kReportsPerSecond = 10000;
+constexpr size_t kReportsPerEvent = 7;
+constexpr zx::duration kTick = zx::msec(10);
+constexpr size_t kReportsPerTick = kReportsPerSecond / 100;
+
+// Appends a non-connectable advertising report from |address| to the LE
+// Advertising Report subevent parameters in |params|, of which the first
+// |*size| bytes are in use. Pass 0 in |*size| to start a new subevent.
+void AppendAdvertisingReport(const common::DeviceAddress& address,
+                             const common::ByteBuffer& data,
+                             int8_t rssi,
+                             common::MutableByteBuffer* params,
+                             size_t* size) {
+  if (*size == 0) {
+    (*params)[0] = 0;  // num_reports
+    *size = sizeof(hci::LEAdvertisingReportSubeventParams);
+  }
+  ZX_DEBUG_ASSERT(*size + sizeof(hci::LEAdvertisingReportData) + data.size() +
+                      sizeof(rssi) <=
+                  params->size());
+
+  auto report = reinterpret_cast<hci::LEAdvertisingReportData*>(
+      params->mutable_data() + *size);
+  report->event_type = hci::LEAdvertisingEventType::kAdvNonConnInd;
+  report->address_type = hci::LEAddressType::kPublic;
+  report->address = address.value();
+  report->length_data = data.size();
+  data.Copy(params, *size + sizeof(*report));
+  (*params)[*size + sizeof(*report) + data.size()] = rssi;
+
+  (*params)[0]++;
+  *size += sizeof(*report) + data.size() + sizeof(rssi);
+}
+
+// Each advertiser changes the contents of its advertisement once a second.
+auto MakeAdvertisingData(size_t advertiser, size_t second) {
+  char name[8];
+  snprintf(name, sizeof(name), "Dev%04zu", advertiser);
+  uint16_t uuid = (advertiser % 2) ? 0x180d : 0x180f;
+  return common::CreateStaticByteBuffer(
+      // Flags
+      0x02, 0x01, 0x02,
+
+      // Complete 16-bit service UUIDs
+      0x03, 0x03, uuid & 0xff, uuid >> 8,
+
+      // Manufacturer specific data
+      0x05, 0xff, 0xe0, 0x00, static_cast<uint8_t>(second),
+      static_cast<uint8_t>(advertiser),
+
+      // Complete local name
+      0x08, 0x09, name[0], name[1], name[2], name[3], name[4], name[5],
+      name[6]);
+}
+
+// Simulates a dense advertising environment in which the controller delivers
+// reports from |kAdvertiserCount| advertisers at |kReportsPerSecond| without
+// duplicate filtering, to several discovery sessions with different filters.
+// Each run processes the reports of one 10 ms tick.
+bool DenseAdvertisingTest(perftest::RepeatState* state) {
+  testing::FakeControllerHarness harness(hci::DataBufferInfo(),
+                                         hci::DataBufferInfo());
+  testing::FakeController::Settings settings;
+  settings.ApplyLegacyLEConfig();
+  harness.test_device()->set_settings(settings);
+
+  RemoteDeviceCache device_cache;
+  device_cache.set_device_updated_interval(zx::msec(100));
+  device_cache.set_device_updated_callback([](const auto&) {});
+  LowEnergyDiscoveryManager discovery_manager(Mode::kLegacy,
+                                              harness.transport(),
+                                              &device_cache);
+
+  // Run several sessions with different filters, as multiple clients would.
+  std::vector<std::unique_ptr<LowEnergyDiscoverySession>> sessions;
+  for (size_t i = 0; i < 5; i++) {
+    discovery_manager.StartDiscovery([&sessions](auto session) {
+      ZX_ASSERT(session);
+      session->SetResultCallback([](const auto&) {});
+      sessions.push_back(std::move(session));
+    });
+    harness.RunLoopUntilIdle();
+  }
+  ZX_ASSERT(sessions.size() == 5);
+  sessions[1]->filter()->SetGeneralDiscoveryFlags();
+  sessions[2]->filter()->set_service_uuids(
+      {common::UUID(uint16_t{0x180d}), common::UUID(uint16_t{0x1812})});
+  sessions[3]->filter()->set_name_substring("7");
+  sessions[4]->filter()->set_manufacturer_code(0x00e0);
+  sessions[4]->filter()->set_rssi(-60);
+
+  common::StaticByteBuffer<hci::kMaxEventPacketPayloadSize> params;
+  size_t report_count = 0;
+  while (state->KeepRunning()) {
+    size_t size = 0;
+    for (size_t i = 0; i < kReportsPerTick; i++, report_count++) {
+      size_t advertiser = report_count % kAdvertiserCount;
+      common::DeviceAddress address(
+          common::DeviceAddress::Type::kLEPublic,
+          common::DeviceAddressBytes({static_cast<uint8_t>(advertiser),
+                                      static_cast<uint8_t>(advertiser >> 8),
+                                      0x00, 0x00, 0x00, 0x00}));
+      int8_t rssi = -40 - static_cast<int8_t>((report_count / 7) % 40);
+      AppendAdvertisingReport(
+          address,
+          MakeAdvertisingData(advertiser, report_count / kReportsPerSecond),
+          rssi, &params, &size);
+
+      if (params[0] == kReportsPerEvent || i == kReportsPerTick - 1) {
+        harness.test_device()->SendLEMetaEvent(
+            hci::kLEAdvertisingReportSubeventCode, params.view(0, size));
+        size = 0;
+      }
+    }
+    harness.RunLoopUntilIdle();
+
+    // Let the coalesced device updates and the scan period timer fire.
+    harness.RunLoopFor(kTick);
+  }
+
+  sessions.clear();
+  harness.RunLoopUntilIdle();
+  return true;
+}
+
+void RegisterTests() {
+  perftest::RegisterTest("Bluetooth/GAP/LowEnergyDiscoveryManager/"
+                         "DenseAdvertising",
+                         DenseAdvertisingTest);
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
+}  // namespace gap
+}  // namespace btlib
@@ -7,10 +7,12 @@
 #include <unordered_set>
 #include <vector>
 
+#include <lib/zx/time.h>
 #include <zircon/assert.h>
 
 #include "garnet/drivers/bluetooth/lib/gap/remote_device.h"
 #include "garnet/drivers/bluetooth/lib/gap/remote_device_cache.h"
+#include "garnet/drivers/bluetooth/lib/hci/hci.h"
 #include "garnet/drivers/bluetooth/lib/testing/fake_controller.h"
 #include "garnet/drivers/bluetooth/lib/testing/fake_controller_test.h"
 #include "garnet/drivers/bluetooth/lib/testing/fake_device.h"
@@ -36,6 +38,35 @@ const common::DeviceAddress kAddress3(common::DeviceAddress::Type::kLEPublic,
 
 constexpr int64_t kTestScanPeriodMs = 10000;
 
+// Appends a non-connectable advertising report from |address| to the LE
+// Advertising Report subevent parameters in |params|, of which the first
+// |*size| bytes are in use. Pass 0 in |*size| to start a new subevent.
+void AppendAdvertisingReport(const common::DeviceAddress& address,
+                             const common::ByteBuffer& data,
+                             int8_t rssi,
+                             common::MutableByteBuffer* params,
+                             size_t* size) {
+  if (*size == 0) {
+    (*params)[0] = 0;  // num_reports
+    *size = sizeof(hci::LEAdvertisingReportSubeventParams);
+  }
+  ZX_DEBUG_ASSERT(*size + sizeof(hci::LEAdvertisingReportData) + data.size() +
+                      sizeof(rssi) <=
+                  params->size());
+
+  auto report = reinterpret_cast<hci::LEAdvertisingReportData*>(
+      params->mutable_data() + *size);
+  report->event_type = hci::LEAdvertisingEventType::kAdvNonConnInd;
+  report->address_type = hci::LEAddressType::kPublic;
+  report->address = address.value();
+  report->length_data = data.size();
+  data.Copy(params, *size + sizeof(*report));
+  (*params)[*size + sizeof(*report) + data.size()] = rssi;
+
+  (*params)[0]++;
+  *size += sizeof(*report) + data.size() + sizeof(rssi);
+}
+
 class LowEnergyDiscoveryManagerTest : public TestingBase {
  public:
   LowEnergyDiscoveryManagerTest() = default;
@@ -770,6 +801,57 @@ TEST_F(GAP_LowEnergyDiscoveryManagerTest,
 #undef EXPECT_CONTAINS
 }
 
+TEST_F(GAP_LowEnergyDiscoveryManagerTest, DuplicateReportsAreFiltered) {
+  discovery_manager()->set_scan_period(kTestScanPeriodMs);
+
+  int result_count = 0;
+  auto session = StartDiscoverySession();
+  session->SetResultCallback([&](const auto&) { result_count++; });
+
+  const auto kAdvData0 = common::CreateStaticByteBuffer(0x02, 0x01, 0x02);
+  const auto kAdvData1 = common::CreateStaticByteBuffer(0x02, 0x01, 0x06);
+  common::StaticByteBuffer<hci::kMaxEventPacketPayloadSize> params;
+  auto send_report = [&](const common::DeviceAddress& address,
+                         const common::ByteBuffer& data, int8_t rssi = -50) {
+    size_t size = 0;
+    AppendAdvertisingReport(address, data, rssi, &params, &size);
+    test_device()->SendLEMetaEvent(hci::kLEAdvertisingReportSubeventCode,
+                                   params.view(0, size));
+    RunLoopUntilIdle();
+  };
+
+  send_report(kAddress0, kAdvData0);
+  EXPECT_EQ(1, result_count);
+
+  // A report with the same contents from the same advertiser is dropped.
+  send_report(kAddress0, kAdvData0);
+  EXPECT_EQ(1, result_count);
+
+  // It still updates the RSSI of the device.
+  int update_count = 0;
+  device_cache()->set_device_updated_callback(
+      [&](const auto&) { update_count++; });
+  send_report(kAddress0, kAdvData0, -60);
+  EXPECT_EQ(1, result_count);
+  EXPECT_EQ(1, update_count);
+  auto* device = device_cache()->FindDeviceByAddress(kAddress0);
+  ASSERT_TRUE(device);
+  EXPECT_EQ(-60, device->rssi());
+
+  // Another advertiser or new contents are reported.
+  send_report(kAddress1, kAdvData0);
+  EXPECT_EQ(2, result_count);
+  send_report(kAddress0, kAdvData1);
+  EXPECT_EQ(3, result_count);
+  send_report(kAddress0, kAdvData0);
+  EXPECT_EQ(4, result_count);
+
+  // The cache is cleared at the end of the scan period.
+  RunLoopFor(zx::msec(kTestScanPeriodMs));
+  send_report(kAddress0, kAdvData0);
+  EXPECT_EQ(5, result_count);
+}
+
 TEST_F(GAP_LowEnergyDiscoveryManagerTest, DirectedConnectableEvent) {
   auto fake_dev = std::make_unique<FakeDevice>(kAddress0, true, false);
   fake_dev->enable_directed_advertising(true);
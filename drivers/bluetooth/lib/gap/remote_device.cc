@@ -71,7 +71,7 @@ void RemoteDevice::LowEnergyData::SetAdvertisingData(
       // connection parameters.
       // TODO(NET-607): SetName should be a no-op if a name was obtained via
       // the name discovery procedure.
-      if (dev_->SetNameInternal(data.ToString())) {
+      if (dev_->SetNameInternal(data.AsString())) {
         notify_listeners = true;
       }
     }
@@ -83,6 +83,14 @@ void RemoteDevice::LowEnergyData::SetAdvertisingData(
   }
 }
 
+void RemoteDevice::LowEnergyData::SetAdvertisingRssi(int8_t rssi) {
+  // Prolong this device's expiration in case it is temporary.
+  dev_->UpdateExpiry();
+  if (dev_->SetRssiInternal(rssi)) {
+    dev_->NotifyListeners();
+  }
+}
+
 void RemoteDevice::LowEnergyData::SetConnectionState(ConnectionState state) {
   ZX_DEBUG_ASSERT(dev_->connectable() ||
                   state == ConnectionState::kNotConnected);
@@ -252,7 +260,7 @@ bool RemoteDevice::BrEdrData::SetEirData(const common::ByteBuffer& eir) {
       // TODO(armansito): Parse more fields.
       // TODO(armansito): SetName should be a no-op if a name was obtained via
       // the name discovery procedure.
-      changed = dev_->SetNameInternal(data.ToString());
+      changed = dev_->SetNameInternal(data.AsString());
     }
   }
   return changed;
@@ -340,9 +348,9 @@ bool RemoteDevice::SetRssiInternal(int8_t rssi) {
   return false;
 }
 
-bool RemoteDevice::SetNameInternal(const std::string& name) {
-  if (!name_ || *name_ != name) {
-    name_ = name;
+bool RemoteDevice::SetNameInternal(fxl::StringView name) {
+  if (!name_ || fxl::StringView(*name_) != name) {
+    name_ = name.ToString();
     return true;
   }
   return false;
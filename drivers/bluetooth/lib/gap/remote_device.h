@@ -17,6 +17,7 @@
 #include "garnet/drivers/bluetooth/lib/hci/lmp_feature_set.h"
 #include "garnet/drivers/bluetooth/lib/sm/pairing_state.h"
 #include "lib/fxl/macros.h"
+#include "lib/fxl/strings/string_view.h"
 
 namespace btlib {
 namespace gap {
@@ -92,6 +93,11 @@ class RemoteDevice final {
     // during an active scan.
     void SetAdvertisingData(int8_t rssi, const common::ByteBuffer& data);
 
+    // Updates the RSSI for an advertisement whose data is the same as the
+    // current advertising data. Like SetAdvertisingData(), this prolongs the
+    // device's expiration and notifies listeners if the RSSI changed.
+    void SetAdvertisingRssi(int8_t rssi);
+
     // Updates the connection state and notifies listeners if necessary.
     void SetConnectionState(ConnectionState state);
 
@@ -344,7 +350,7 @@ class RemoteDevice final {
   // listeners.
   // TODO(armansito): Add similarly styled internal setters so that we can batch
   // more updates.
-  bool SetNameInternal(const std::string& name);
+  bool SetNameInternal(fxl::StringView name);
 
   // Marks this device as non-temporary. This operation may fail due to one of
   // the conditions described above the |temporary()| method.
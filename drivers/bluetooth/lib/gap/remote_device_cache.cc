@@ -10,6 +10,7 @@
 #include "garnet/drivers/bluetooth/lib/gap/remote_device.h"
 #include "garnet/drivers/bluetooth/lib/hci/connection.h"
 #include "garnet/drivers/bluetooth/lib/hci/low_energy_scanner.h"
+#include "lib/async/cpp/time.h"
 #include "lib/async/default.h"
 #include "lib/fxl/random/uuid.h"
 
@@ -34,7 +35,8 @@ RemoteDevice* RemoteDeviceCache::NewDevice(const common::DeviceAddress& address,
   devices_.emplace(
       std::piecewise_construct, std::forward_as_tuple(device->identifier()),
       std::forward_as_tuple(std::unique_ptr<RemoteDevice>(device),
-                            [this, device] { RemoveDevice(device); }));
+                            [this, device] { RemoveDevice(device); },
+                            [this, device] { SendDeviceUpdated(device); }));
 
   address_map_[device->address()] = device->identifier();
   UpdateExpiry(*device);
@@ -93,7 +95,8 @@ bool RemoteDeviceCache::AddBondedDevice(const std::string& identifier,
   devices_.emplace(
       std::piecewise_construct, std::forward_as_tuple(device->identifier()),
       std::forward_as_tuple(std::unique_ptr<RemoteDevice>(device),
-                            [this, device] { RemoveDevice(device); }));
+                            [this, device] { RemoveDevice(device); },
+                            [this, device] { SendDeviceUpdated(device); }));
   address_map_[device->address()] = device->identifier();
 
   device->MutLe().SetBondData(bond_data);
@@ -187,10 +190,46 @@ void RemoteDeviceCache::NotifyDeviceBonded(const RemoteDevice& device) {
 }
 
 void RemoteDeviceCache::NotifyDeviceUpdated(const RemoteDevice& device) {
-  ZX_DEBUG_ASSERT(devices_.find(device.identifier()) != devices_.end());
-  ZX_DEBUG_ASSERT(devices_.at(device.identifier()).device() == &device);
-  if (device_updated_callback_)
+  auto device_record_iter = devices_.find(device.identifier());
+  ZX_DEBUG_ASSERT(device_record_iter != devices_.end());
+
+  auto& device_record = device_record_iter->second;
+  ZX_DEBUG_ASSERT(device_record.device() == &device);
+
+  if (!device_updated_callback_)
+    return;
+
+  if (device_updated_interval_ <= zx::duration()) {
     device_updated_callback_(device);
+    return;
+  }
+
+  // A deferred notification is already pending; it will report the latest
+  // state of |device| when it runs.
+  if (device_record.update_task()->is_pending())
+    return;
+
+  auto* dispatcher = async_get_default_dispatcher();
+  if (async::Now(dispatcher) >= device_record.next_update_time()) {
+    SendDeviceUpdated(device_record.device());
+    return;
+  }
+
+  const auto schedule_res = device_record.update_task()->PostForTime(
+      dispatcher, device_record.next_update_time());
+  ZX_DEBUG_ASSERT(schedule_res == ZX_OK || schedule_res == ZX_ERR_BAD_STATE);
+}
+
+void RemoteDeviceCache::SendDeviceUpdated(RemoteDevice* device) {
+  ZX_DEBUG_ASSERT(device);
+
+  auto device_record_iter = devices_.find(device->identifier());
+  ZX_DEBUG_ASSERT(device_record_iter != devices_.end());
+  device_record_iter->second.set_next_update_time(
+      async::Now(async_get_default_dispatcher()) + device_updated_interval_);
+
+  if (device_updated_callback_)
+    device_updated_callback_(*device);
 }
 
 void RemoteDeviceCache::UpdateExpiry(const RemoteDevice& device) {
@@ -8,6 +8,7 @@
 #include <unordered_map>
 
 #include <lib/async/cpp/task.h>
+#include <lib/zx/time.h>
 
 #include "garnet/drivers/bluetooth/lib/common/device_address.h"
 #include "garnet/drivers/bluetooth/lib/gap/remote_device.h"
@@ -103,6 +104,19 @@ class RemoteDeviceCache final {
     device_updated_callback_ = std::move(callback);
   }
 
+  // Limits the rate at which the device updated callback is invoked for each
+  // device to once per |interval|. Updates that occur within |interval| of the
+  // last notification for the same device are coalesced into a single
+  // notification that is delivered when the interval elapses. This bounds the
+  // cost of frequently changing devices, such as advertisers whose RSSI is
+  // updated with every scan result.
+  //
+  // An |interval| of zero (the default) notifies every update synchronously.
+  void set_device_updated_interval(zx::duration interval) {
+    ZX_DEBUG_ASSERT(thread_checker_.IsCreationThreadCurrent());
+    device_updated_interval_ = interval;
+  }
+
   // When set, |callback| will be invoked whenever a device is
   // removed.
   void set_device_removed_callback(DeviceIdCallback callback) {
@@ -130,9 +144,11 @@ class RemoteDeviceCache final {
   class RemoteDeviceRecord final {
    public:
     RemoteDeviceRecord(std::unique_ptr<RemoteDevice> device,
-                       fbl::Closure remove_device_callback)
+                       fbl::Closure remove_device_callback,
+                       fbl::Closure notify_updated_callback)
         : device_(std::move(device)),
-          removal_task_(std::move(remove_device_callback)) {}
+          removal_task_(std::move(remove_device_callback)),
+          update_task_(std::move(notify_updated_callback)) {}
 
     // The copy and move ctors cannot be implicitly defined, since
     // async::TaskClosure does not support those operations. Nor is any
@@ -146,15 +162,30 @@ class RemoteDeviceCache final {
     // cancel |remove_device_callback|.
     async::TaskClosure* removal_task() { return &removal_task_; }
 
+    // Returns a pointer to update_task_, which is used to deliver a deferred
+    // device updated notification when updates are rate limited.
+    async::TaskClosure* update_task() { return &update_task_; }
+
+    // The earliest time at which the device updated callback may be invoked
+    // again for this device when updates are rate limited.
+    zx::time next_update_time() const { return next_update_time_; }
+    void set_next_update_time(zx::time time) { next_update_time_ = time; }
+
    private:
     std::unique_ptr<RemoteDevice> device_;
     async::TaskClosure removal_task_;
+    async::TaskClosure update_task_;
+    zx::time next_update_time_;
   };
 
   // Notifies interested parties that |device| has seen a significant change.
   // |device| must already exist in the cache.
   void NotifyDeviceUpdated(const RemoteDevice& device);
 
+  // Invokes the device updated callback for |device| and records when it may
+  // be invoked again.
+  void SendDeviceUpdated(RemoteDevice* device);
+
   // Updates the expiration time for |device|, if a temporary. Cancels expiry,
   // if a non-temporary. Pre-conditions:
   // - |device| must already exist in the cache
@@ -183,6 +214,7 @@ class RemoteDeviceCache final {
   std::unordered_map<common::DeviceAddress, std::string> address_map_;
 
   DeviceCallback device_updated_callback_;
+  zx::duration device_updated_interval_;
   DeviceIdCallback device_removed_callback_;
   DeviceCallback device_bonded_callback_;
 
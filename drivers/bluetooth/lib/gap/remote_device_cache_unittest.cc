@@ -714,6 +714,45 @@ TEST_F(GAP_RemoteDeviceCacheTest_UpdateCallbackTest,
   EXPECT_FALSE(was_called());
 }
 
+TEST_F(GAP_RemoteDeviceCacheTest_UpdateCallbackTest,
+       UpdatesWithinIntervalAreCoalesced) {
+  constexpr zx::duration kInterval = zx::msec(100);
+  int update_count = 0;
+  int8_t last_rssi = hci::kRSSIInvalid;
+  cache()->set_device_updated_interval(kInterval);
+  cache()->set_device_updated_callback([&](const auto& updated_dev) {
+    update_count++;
+    last_rssi = updated_dev.rssi();
+  });
+
+  // The first update is delivered immediately.
+  device()->MutLe().SetAdvertisingData(1, kAdvData);
+  EXPECT_EQ(1, update_count);
+  EXPECT_EQ(1, last_rssi);
+
+  // Updates within the interval are deferred and coalesced.
+  device()->MutLe().SetAdvertisingData(2, kAdvData);
+  device()->MutLe().SetAdvertisingData(3, kAdvData);
+  EXPECT_EQ(1, update_count);
+
+  RunLoopFor(kInterval - zx::msec(1));
+  EXPECT_EQ(1, update_count);
+
+  // The deferred notification reports the latest state.
+  RunLoopFor(zx::msec(1));
+  EXPECT_EQ(2, update_count);
+  EXPECT_EQ(3, last_rssi);
+
+  // Nothing changed since then.
+  RunLoopFor(kInterval * 2);
+  EXPECT_EQ(2, update_count);
+
+  // The interval has elapsed so this update is delivered immediately.
+  device()->MutLe().SetAdvertisingData(4, kAdvData);
+  EXPECT_EQ(3, update_count);
+  EXPECT_EQ(4, last_rssi);
+}
+
 class GAP_RemoteDeviceCacheTest_ExpirationTest
     : public GAP_RemoteDeviceCacheTest {
  public:
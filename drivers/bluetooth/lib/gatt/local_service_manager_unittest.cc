@@ -70,28 +70,28 @@ TEST(GATT_LocalServiceManagerTest, EmptyService) {
 
   auto iter = mgr.database()->groupings().begin();
 
-  EXPECT_TRUE(iter->complete());
-  EXPECT_EQ(1u, iter->attributes().size());
-  EXPECT_TRUE(iter->active());
-  EXPECT_EQ(0x0001, iter->start_handle());
-  EXPECT_EQ(0x0001, iter->end_handle());
-  EXPECT_EQ(types::kPrimaryService, iter->group_type());
+  EXPECT_TRUE((*iter)->complete());
+  EXPECT_EQ(1u, (*iter)->attributes().size());
+  EXPECT_TRUE((*iter)->active());
+  EXPECT_EQ(0x0001, (*iter)->start_handle());
+  EXPECT_EQ(0x0001, (*iter)->end_handle());
+  EXPECT_EQ(types::kPrimaryService, (*iter)->group_type());
   EXPECT_TRUE(common::ContainersEqual(
-      common::CreateStaticByteBuffer(0xad, 0xde), iter->decl_value()));
+      common::CreateStaticByteBuffer(0xad, 0xde), (*iter)->decl_value()));
 
   iter++;
 
-  EXPECT_TRUE(iter->complete());
-  EXPECT_EQ(1u, iter->attributes().size());
-  EXPECT_TRUE(iter->active());
-  EXPECT_EQ(0x0002, iter->start_handle());
-  EXPECT_EQ(0x0002, iter->end_handle());
-  EXPECT_EQ(types::kSecondaryService, iter->group_type());
+  EXPECT_TRUE((*iter)->complete());
+  EXPECT_EQ(1u, (*iter)->attributes().size());
+  EXPECT_TRUE((*iter)->active());
+  EXPECT_EQ(0x0002, (*iter)->start_handle());
+  EXPECT_EQ(0x0002, (*iter)->end_handle());
+  EXPECT_EQ(types::kSecondaryService, (*iter)->group_type());
   EXPECT_TRUE(common::ContainersEqual(
       common::CreateStaticByteBuffer(0xFB, 0x34, 0x9B, 0x5F, 0x80, 0x00, 0x00,
                                      0x80, 0x00, 0x10, 0x00, 0x00, 0xef, 0xbe,
                                      0xad, 0xde),
-      iter->decl_value()));
+      (*iter)->decl_value()));
 }
 
 TEST(GATT_LocalServiceManagerTest, UnregisterService) {
@@ -130,7 +130,7 @@ TEST(GATT_LocalServiceManagerTest, RegisterCharacteristic) {
   EXPECT_NE(0u, id1);
 
   ASSERT_EQ(1u, mgr.database()->groupings().size());
-  const auto& grouping = mgr.database()->groupings().front();
+  const auto& grouping = *mgr.database()->groupings().front();
   EXPECT_TRUE(grouping.complete());
 
   const auto& attrs = grouping.attributes();
@@ -182,7 +182,7 @@ TEST(GATT_LocalServiceManagerTest, RegisterCharacteristic32) {
   EXPECT_NE(0u, id1);
 
   ASSERT_EQ(1u, mgr.database()->groupings().size());
-  const auto& grouping = mgr.database()->groupings().front();
+  const auto& grouping = *mgr.database()->groupings().front();
   EXPECT_TRUE(grouping.complete());
 
   const auto& attrs = grouping.attributes();
@@ -236,7 +236,7 @@ TEST(GATT_LocalServiceManagerTest, RegisterCharacteristic128) {
   EXPECT_NE(0u, id1);
 
   ASSERT_EQ(1u, mgr.database()->groupings().size());
-  const auto& grouping = mgr.database()->groupings().front();
+  const auto& grouping = *mgr.database()->groupings().front();
   EXPECT_TRUE(grouping.complete());
 
   const auto& attrs = grouping.attributes();
@@ -288,7 +288,7 @@ TEST(GATT_LocalServiceManagerTest, ExtPropSetSuccess) {
 
   ASSERT_TRUE(RegisterService(&mgr, std::move(service)));
   ASSERT_NE(0u, mgr.database()->groupings().size());
-  const auto& grouping = mgr.database()->groupings().front();
+  const auto& grouping = *mgr.database()->groupings().front();
   const auto& attrs = grouping.attributes();
   ASSERT_EQ(4u, attrs.size());
   EXPECT_EQ(types::kCharacteristicExtProperties, attrs[3].type());
@@ -343,7 +343,7 @@ TEST(GATT_LocalServiceManagerTest, RegisterCharacteristicSorted) {
   EXPECT_NE(0u, id1);
 
   ASSERT_EQ(1u, mgr.database()->groupings().size());
-  const auto& grouping = mgr.database()->groupings().front();
+  const auto& grouping = *mgr.database()->groupings().front();
   EXPECT_TRUE(grouping.complete());
 
   const auto& attrs = grouping.attributes();
@@ -377,7 +377,7 @@ TEST(GATT_LocalServiceManagerTest, RegisterDescriptor) {
 
   EXPECT_NE(0u, RegisterService(&mgr, std::move(service)));
   ASSERT_EQ(1u, mgr.database()->groupings().size());
-  const auto& grouping = mgr.database()->groupings().front();
+  const auto& grouping = *mgr.database()->groupings().front();
   EXPECT_TRUE(grouping.complete());
 
   const auto& attrs = grouping.attributes();
@@ -5,6 +5,8 @@
 #ifndef GARNET_DRIVERS_BLUETOOTH_LIB_GATT_SERVER_H_
 #define GARNET_DRIVERS_BLUETOOTH_LIB_GATT_SERVER_H_
 
+#include <list>
+
 #include "garnet/drivers/bluetooth/lib/att/bearer.h"
 #include "garnet/drivers/bluetooth/lib/common/uuid.h"
 
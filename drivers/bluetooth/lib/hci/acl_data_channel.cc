@@ -6,6 +6,8 @@
 
 #include <endian.h>
 
+#include <algorithm>
+
 #include <lib/async/default.h>
 #include <zircon/assert.h>
 #include <zircon/status.h>
@@ -18,6 +20,13 @@
 
 namespace btlib {
 namespace hci {
+namespace {
+
+// The factor by which the round-robin quantum of a link is scaled while it has
+// high priority data queued.
+constexpr size_t kHighPriorityQuantumFactor = 4;
+
+}  // namespace
 
 DataBufferInfo::DataBufferInfo(size_t max_data_length, size_t max_num_packets)
     : max_data_length_(max_data_length), max_num_packets_(max_num_packets) {}
@@ -115,7 +124,8 @@ void ACLDataChannel::ShutDown() {
 
   {
     std::lock_guard<std::mutex> lock(send_mutex_);
-    send_queue_.clear();
+    link_queues_.clear();
+    active_links_.clear();
   }
 
   io_dispatcher_ = nullptr;
@@ -131,7 +141,8 @@ void ACLDataChannel::SetDataRxHandler(DataReceivedCallback rx_callback,
 }
 
 bool ACLDataChannel::SendPacket(ACLDataPacketPtr data_packet,
-                                Connection::LinkType ll_type) {
+                                Connection::LinkType ll_type,
+                                PacketPriority priority) {
   if (!is_initialized_) {
     bt_log(TRACE, "hci", "cannot send packets while uninitialized");
     return false;
@@ -146,7 +157,7 @@ bool ACLDataChannel::SendPacket(ACLDataPacketPtr data_packet,
 
   std::lock_guard<std::mutex> lock(send_mutex_);
 
-  send_queue_.emplace_back(QueuedDataPacket(ll_type, std::move(data_packet)));
+  EnqueuePacketLocked(std::move(data_packet), ll_type, priority);
 
   TrySendNextQueuedPacketsLocked();
 
@@ -154,7 +165,8 @@ bool ACLDataChannel::SendPacket(ACLDataPacketPtr data_packet,
 }
 
 bool ACLDataChannel::SendPackets(common::LinkedList<ACLDataPacket> packets,
-                                 Connection::LinkType ll_type) {
+                                 Connection::LinkType ll_type,
+                                 PacketPriority priority) {
   if (!is_initialized_) {
     bt_log(TRACE, "hci", "cannot send packets while uninitialized");
     return false;
@@ -176,7 +188,7 @@ bool ACLDataChannel::SendPackets(common::LinkedList<ACLDataPacket> packets,
   std::lock_guard<std::mutex> lock(send_mutex_);
 
   while (!packets.is_empty()) {
-    send_queue_.emplace_back(QueuedDataPacket(ll_type, packets.pop_front()));
+    EnqueuePacketLocked(packets.pop_front(), ll_type, priority);
   }
 
   TrySendNextQueuedPacketsLocked();
@@ -186,11 +198,23 @@ bool ACLDataChannel::SendPackets(common::LinkedList<ACLDataPacket> packets,
 
 bool ACLDataChannel::ClearLinkState(hci::ConnectionHandle handle) {
   std::lock_guard<std::mutex> lock(send_mutex_);
+
+  // Drop any packets that are still queued for the link.
+  bool had_queued_packets = false;
+  auto queue_iter = link_queues_.find(handle);
+  if (queue_iter != link_queues_.end()) {
+    had_queued_packets = !queue_iter->second.is_empty();
+    link_queues_.erase(queue_iter);
+    active_links_.erase(
+        std::remove(active_links_.begin(), active_links_.end(), handle),
+        active_links_.end());
+  }
+
   auto iter = pending_links_.find(handle);
   if (iter == pending_links_.end()) {
     bt_log(TRACE, "hci", "no pending packets on connection (handle: %#.4x)",
            handle);
-    return false;
+    return had_queued_packets;
   }
 
   const PendingPacketData& data = iter->second;
@@ -222,6 +246,72 @@ size_t ACLDataChannel::GetBufferMTU(Connection::LinkType ll_type) const {
   return GetLEBufferInfo().max_data_length();
 }
 
+size_t ACLDataChannel::GetQuantum(const LinkQueue& link) const {
+  // A quantum of at least one MTU guarantees that every link can send at least
+  // one packet per turn.
+  size_t quantum = GetBufferMTU(link.ll_type);
+  if (!link.high_priority.is_empty())
+    quantum *= kHighPriorityQuantumFactor;
+  return quantum;
+}
+
+common::LinkedList<ACLDataPacket>* ACLDataChannel::LinkQueue::next_queue() {
+  if (!low_priority.is_empty() &&
+      low_priority.front().packet_boundary_flag() ==
+          ACLPacketBoundaryFlag::kContinuingFragment) {
+    return &low_priority;
+  }
+  return high_priority.is_empty() ? &low_priority : &high_priority;
+}
+
+void ACLDataChannel::EnqueuePacketLocked(ACLDataPacketPtr packet,
+                                         Connection::LinkType ll_type,
+                                         PacketPriority priority) {
+  const ConnectionHandle handle = packet->connection_handle();
+  auto iter = link_queues_.find(handle);
+  if (iter == link_queues_.end()) {
+    iter = link_queues_.emplace(handle, LinkQueue(ll_type)).first;
+  }
+
+  LinkQueue& link = iter->second;
+  ZX_DEBUG_ASSERT(link.ll_type == ll_type);
+
+  const bool was_empty = link.is_empty();
+  if (priority == PacketPriority::kHigh) {
+    link.high_priority.push_back(std::move(packet));
+  } else {
+    link.low_priority.push_back(std::move(packet));
+  }
+
+  // A link that becomes active joins the end of the round-robin order with a
+  // fresh quantum.
+  if (was_empty) {
+    link.deficit = GetQuantum(link);
+    active_links_.push_back(handle);
+  }
+}
+
+bool ACLDataChannel::WritePacketLocked(const ACLDataPacket& packet,
+                                       Connection::LinkType ll_type) {
+  auto packet_bytes = packet.view().data();
+  zx_status_t status =
+      channel_.write(0, packet_bytes.data(), packet_bytes.size(), nullptr, 0);
+  if (status < 0) {
+    bt_log(ERROR, "hci",
+           "failed to send data packet to HCI driver (%s) - dropping packet",
+           zx_status_get_string(status));
+    return false;
+  }
+
+  auto iter = pending_links_.find(packet.connection_handle());
+  if (iter == pending_links_.end()) {
+    pending_links_[packet.connection_handle()] = PendingPacketData(ll_type);
+  } else {
+    iter->second.count++;
+  }
+  return true;
+}
+
 void ACLDataChannel::NumberOfCompletedPacketsCallback(
     const EventPacket& event) {
   ZX_DEBUG_ASSERT(async_get_default_dispatcher() == io_dispatcher_);
@@ -287,65 +377,70 @@ void ACLDataChannel::TrySendNextQueuedPacketsLocked() {
   size_t avail_bredr_packets = GetNumFreeBREDRPacketsLocked();
   size_t avail_le_packets = GetNumFreeLEPacketsLocked();
 
-  // Based on what we know about controller buffer availability, we process
-  // packets that are currently in |send_queue_|. The packets that can be sent
-  // are added to |to_send|. Packets that cannot be sent remain in
-  // |send_queue_|.
-  DataPacketQueue to_send;
-  for (auto iter = send_queue_.begin(); iter != send_queue_.end();) {
-    if (!avail_bredr_packets && !avail_le_packets)
-      break;
-
-    if (send_queue_.front().ll_type == Connection::LinkType::kACL &&
-        avail_bredr_packets) {
-      --avail_bredr_packets;
-    } else if (send_queue_.front().ll_type == Connection::LinkType::kLE &&
-               avail_le_packets) {
-      --avail_le_packets;
-    } else {
-      // Cannot send packet yet, so skip it.
-      ++iter;
-      continue;
-    }
-
-    to_send.push_back(std::move(*iter));
-    send_queue_.erase(iter++);
-  }
-
-  if (to_send.empty())
-    return;
+  // LE packets count against the BR/EDR buffer if the controller does not have
+  // a dedicated LE buffer.
+  auto avail_packets = [&](Connection::LinkType ll_type) -> size_t& {
+    if (ll_type == Connection::LinkType::kACL || !le_buffer_info_.IsAvailable())
+      return avail_bredr_packets;
+    return avail_le_packets;
+  };
 
+  // Serve the active links in deficit round-robin order: during its turn, a
+  // link sends packets for as long as its deficit covers their payload size,
+  // and its deficit is replenished by a quantum at the start of its next turn.
+  // Links whose controller buffer is full are skipped but keep their place in
+  // the order, so that no link loses its turn to a link of the other type.
   size_t bredr_packets_sent = 0;
   size_t le_packets_sent = 0;
-  while (!to_send.empty()) {
-    const QueuedDataPacket& packet = to_send.front();
-
-    auto packet_bytes = packet.packet->view().data();
-    zx_status_t status =
-        channel_.write(0, packet_bytes.data(), packet_bytes.size(), nullptr, 0);
-    if (status < 0) {
-      bt_log(ERROR, "hci",
-             "failed to send data packet to HCI driver (%s) - dropping packet",
-             zx_status_get_string(status));
-      to_send.pop_front();
+  size_t index = 0;
+  while (index < active_links_.size()) {
+    const ConnectionHandle handle = active_links_[index];
+    auto iter = link_queues_.find(handle);
+    ZX_DEBUG_ASSERT(iter != link_queues_.end());
+    LinkQueue& link = iter->second;
+    size_t& avail = avail_packets(link.ll_type);
+
+    if (!avail) {
+      index++;
       continue;
     }
 
-    if (packet.ll_type == Connection::LinkType::kACL) {
-      ++bredr_packets_sent;
-    } else {
-      ++le_packets_sent;
+    while (avail && !link.is_empty()) {
+      auto* queue = link.next_queue();
+      const size_t cost = queue->front().view().payload_size();
+      if (cost > link.deficit)
+        break;
+
+      auto packet = queue->pop_front();
+      link.deficit -= cost;
+      if (!WritePacketLocked(*packet, link.ll_type))
+        continue;
+
+      avail--;
+      if (link.ll_type == Connection::LinkType::kACL) {
+        ++bredr_packets_sent;
+      } else {
+        ++le_packets_sent;
+      }
     }
 
-    auto iter = pending_links_.find(packet.packet->connection_handle());
-    if (iter == pending_links_.end()) {
-      pending_links_[packet.packet->connection_handle()] =
-          PendingPacketData(packet.ll_type);
-    } else {
-      iter->second.count++;
+    if (link.is_empty()) {
+      link.deficit = 0u;
+      active_links_.erase(active_links_.begin() + index);
+      continue;
+    }
+
+    // If the buffer ran out mid-turn, the link keeps its place and its
+    // remaining deficit, and resumes its turn once buffer space frees up.
+    if (!avail) {
+      index++;
+      continue;
     }
 
-    to_send.pop_front();
+    // The link's turn is over and it moves to the end of the order.
+    link.deficit += GetQuantum(link);
+    active_links_.erase(active_links_.begin() + index);
+    active_links_.push_back(handle);
   }
 
   IncrementTotalNumPacketsLocked(bredr_packets_sent);
@@ -5,9 +5,8 @@
 #ifndef GARNET_DRIVERS_BLUETOOTH_LIB_HCI_ACL_DATA_CHANNEL_H_
 #define GARNET_DRIVERS_BLUETOOTH_LIB_HCI_ACL_DATA_CHANNEL_H_
 
-#include <list>
+#include <deque>
 #include <mutex>
-#include <queue>
 #include <unordered_map>
 
 #include <lib/async/cpp/wait.h>
@@ -68,8 +67,21 @@ class DataBufferInfo {
 //
 // This currently only supports the Packet-based Data Flow Control as defined in
 // Core Spec v5.0, Vol 2, Part E, Section 4.1.1.
+//
+// Outbound packets are queued separately for each logical link and links are
+// served in deficit round-robin order, so that a bulk transfer on one link
+// cannot starve the others of controller buffers.
 class ACLDataChannel final {
  public:
+  // The priority of outbound data, as determined by the L2CAP channel that it
+  // is sent on. High priority PDUs are sent ahead of low priority PDUs on the
+  // same link, and links with high priority data queued get a larger share of
+  // the controller buffers.
+  enum class PacketPriority {
+    kHigh,
+    kLow,
+  };
+
   ACLDataChannel(Transport* transport, zx::channel hci_acl_channel);
   ~ACLDataChannel();
 
@@ -114,7 +126,8 @@ class ACLDataChannel final {
   //
   // |data_packet| is passed by value, meaning that ACLDataChannel will take
   // ownership of it. |data_packet| must represent a valid ACL data packet.
-  bool SendPacket(ACLDataPacketPtr data_packet, Connection::LinkType ll_type);
+  bool SendPacket(ACLDataPacketPtr data_packet, Connection::LinkType ll_type,
+                  PacketPriority priority = PacketPriority::kLow);
 
   // Queues the given list of ACL data packets to be sent to the controller. The
   // behavior is identical to that of SendPacket() with the guarantee that all
@@ -123,16 +136,17 @@ class ACLDataChannel final {
   // Takes ownership of the contents of |packets|. Returns false if |packets|
   // contains an element that exceeds the MTU for |ll_type| or it is empty.
   bool SendPackets(common::LinkedList<ACLDataPacket> packets,
-                   Connection::LinkType ll_type);
+                   Connection::LinkType ll_type,
+                   PacketPriority priority = PacketPriority::kLow);
 
   // Cleans up all outgoing data buffering state related to the logical link
-  // with the given |handle|. This must be called upon disconnection of a link
-  // to ensure that ACL flow-control works correctly.
+  // with the given |handle|, dropping any packets that are queued for it. This
+  // must be called upon disconnection of a link to ensure that ACL flow-control
+  // works correctly. Returns false if there was no state for |handle|.
   //
   // TODO(armansito): This doesn't fix things for subsequent data packets on
-  // this |handle| (either already queued by ACLDataChannel or waiting to be
-  // sent in an async task). Support enabling/disabling data flow with separate
-  // packet queues for each link so that we can drop packets for closed links.
+  // this |handle| that are waiting to be sent in an async task. Support
+  // enabling/disabling data flow for each link so that we can drop those too.
   // This is also needed to correctly pause TX data flow during encryption pause
   // (NET-1169).
   bool ClearLinkState(hci::ConnectionHandle handle);
@@ -150,22 +164,48 @@ class ACLDataChannel final {
   const DataBufferInfo& GetLEBufferInfo() const;
 
  private:
-  // Represents a queued ACL data packet.
-  struct QueuedDataPacket {
-    QueuedDataPacket(Connection::LinkType ll_type, ACLDataPacketPtr packet)
-        : ll_type(ll_type), packet(std::move(packet)) {}
+  // The packets of a single logical link that are waiting to be sent to the
+  // controller. Packets are linked through their own (slab-allocated) storage,
+  // so queueing a packet does not allocate.
+  struct LinkQueue {
+    explicit LinkQueue(Connection::LinkType ll_type) : ll_type(ll_type) {}
 
-    QueuedDataPacket() = default;
-    QueuedDataPacket(QueuedDataPacket&& other) = default;
-    QueuedDataPacket& operator=(QueuedDataPacket&& other) = default;
+    bool is_empty() const {
+      return high_priority.is_empty() && low_priority.is_empty();
+    }
+
+    // Returns the queue that the next packet must be taken from. A PDU that
+    // has been partially sent must be completed before any other PDU can be
+    // sent on the link, as the controller reassembles fragments per link.
+    common::LinkedList<ACLDataPacket>* next_queue();
 
     Connection::LinkType ll_type;
-    ACLDataPacketPtr packet;
+    common::LinkedList<ACLDataPacket> high_priority;
+    common::LinkedList<ACLDataPacket> low_priority;
+
+    // The number of payload bytes that this link may still send during its
+    // current round-robin turn.
+    size_t deficit = 0u;
   };
 
   // Returns the data buffer MTU for the given connection.
   size_t GetBufferMTU(Connection::LinkType ll_type) const;
 
+  // Returns the number of payload bytes added to the deficit of |link| at the
+  // start of each of its round-robin turns.
+  size_t GetQuantum(const LinkQueue& link) const;
+
+  // Adds |packet| to the queue of its link.
+  void EnqueuePacketLocked(ACLDataPacketPtr packet,
+                           Connection::LinkType ll_type,
+                           PacketPriority priority) __TA_REQUIRES(send_mutex_);
+
+  // Writes |packet| to the HCI channel and records it as pending on its link.
+  // Returns false if the packet could not be written and was dropped.
+  bool WritePacketLocked(const ACLDataPacket& packet,
+                         Connection::LinkType ll_type)
+      __TA_REQUIRES(send_mutex_);
+
   // Handler for the HCI Number of Completed Packets Event, used for
   // packet-based data flow control.
   void NumberOfCompletedPacketsCallback(const EventPacket& event);
@@ -254,17 +294,15 @@ class ACLDataChannel final {
   size_t num_sent_packets_ __TA_GUARDED(send_mutex_);
   size_t le_num_sent_packets_ __TA_GUARDED(send_mutex_);
 
-  // The ACL data packet queue contains the data packets that are waiting to be
-  // sent to the controller.
-  // TODO(armansito): Use priority_queue based on L2CAP channel priority.
-  // TODO(NET-1211): Keep a separate queue for each open connection. Benefits:
-  //   * Helps address the packet-prioritization TODO above.
-  //   * Also: having separate queues, which know their own
-  //     Connection::LinkType, would let us replace std::list<QueuedDataPacket>
-  //     with common::LinkedList<ACLDataPacket> which has a more efficient
-  //     memory layout.
-  using DataPacketQueue = std::list<QueuedDataPacket>;
-  DataPacketQueue send_queue_ __TA_GUARDED(send_mutex_);
+  // The data packets that are waiting to be sent to the controller, queued
+  // separately for each logical link.
+  std::unordered_map<ConnectionHandle, LinkQueue> link_queues_
+      __TA_GUARDED(send_mutex_);
+
+  // The links that have packets queued, in the order in which they will be
+  // served. The first link with buffer space available is the one whose turn
+  // it currently is.
+  std::deque<ConnectionHandle> active_links_ __TA_GUARDED(send_mutex_);
 
   // Stores the link type of connections on which we have a pending packet that
   // has been sent to the controller. Entries are removed on the HCI Number Of
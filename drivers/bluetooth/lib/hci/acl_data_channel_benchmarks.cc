@@ -0,0 +1,94 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/drivers/bluetooth/lib/hci/acl_data_channel.h"
+
+#include <fbl/string_printf.h>
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+
+#include "garnet/drivers/bluetooth/lib/hci/connection.h"
+#include "garnet/drivers/bluetooth/lib/testing/fake_controller_harness.h"
+#include "garnet/drivers/bluetooth/lib/testing/fake_device.h"
+#include "lib/fxl/strings/string_printf.h"
+
+namespace btlib {
+namespace hci {
+namespace {
+
+constexpr size_t kLEMTU = 251;
+constexpr size_t kLENumPackets = 4;
+constexpr size_t kPacketsPerLink = 100;
+
+// L2CAP channel used for the test traffic, which the fake devices ignore.
+constexpr uint16_t kBulkChannelId = 0x0040;
+
+// Returns a single-fragment B-frame that fills the LE buffer MTU on |handle|.
+ACLDataPacketPtr NewPDU(ConnectionHandle handle) {
+  auto packet =
+      ACLDataPacket::New(handle, ACLPacketBoundaryFlag::kFirstNonFlushable,
+                         ACLBroadcastFlag::kPointToPoint, kLEMTU);
+  auto payload = packet->mutable_view()->mutable_payload_data();
+  payload.Fill(0);
+  payload[0] = static_cast<uint8_t>(kLEMTU - 4);
+  payload[2] = static_cast<uint8_t>(kBulkChannelId & 0xFF);
+  payload[3] = static_cast<uint8_t>(kBulkChannelId >> 8);
+  return packet;
+}
+
+// Measures the time taken to send |kPacketsPerLink| packets on each of
+// |link_count| links through the ACL send scheduler, to a FakeController that
+// acknowledges every packet as soon as it receives it.
+bool SendTest(perftest::RepeatState* state, size_t link_count) {
+  state->SetBytesProcessedPerRun(link_count * kPacketsPerLink * kLEMTU);
+
+  testing::FakeControllerHarness harness(DataBufferInfo(),
+                                         DataBufferInfo(kLEMTU, kLENumPackets));
+
+  // Connect one fake device per link. FakeController assigns connection
+  // handles in increasing order, starting at 1.
+  for (size_t i = 0; i < link_count; i++) {
+    common::DeviceAddress addr(
+        common::DeviceAddress::Type::kLEPublic,
+        fxl::StringPrintf("00:00:00:00:00:%.2zx", i + 1));
+    harness.test_device()->AddDevice(
+        std::make_unique<testing::FakeDevice>(addr));
+    harness.test_device()->ConnectLowEnergy(addr);
+  }
+  harness.RunLoopUntilIdle();
+
+  size_t received = 0;
+  harness.test_device()->SetDataCallback(
+      [&received](const common::ByteBuffer&) { received++; },
+      harness.dispatcher());
+
+  while (state->KeepRunning()) {
+    received = 0;
+    for (ConnectionHandle handle = 1; handle <= link_count; handle++) {
+      common::LinkedList<ACLDataPacket> packets;
+      for (size_t i = 0; i < kPacketsPerLink; i++) {
+        packets.push_back(NewPDU(handle));
+      }
+      ZX_ASSERT(harness.acl_data_channel()->SendPackets(
+          std::move(packets), Connection::LinkType::kLE));
+    }
+    harness.RunLoopUntilIdle();
+    ZX_ASSERT(received == link_count * kPacketsPerLink);
+  }
+  return true;
+}
+
+void RegisterTests() {
+  for (size_t link_count : {1, 4, 16}) {
+    auto name =
+        fbl::StringPrintf("Bluetooth/HCI/ACLDataChannel/Send/%zulinks",
+                          link_count);
+    perftest::RegisterTest(name.c_str(), SendTest, link_count);
+  }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
+}  // namespace hci
+}  // namespace btlib
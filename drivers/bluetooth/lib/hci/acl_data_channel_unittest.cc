@@ -4,7 +4,9 @@
 
 #include "garnet/drivers/bluetooth/lib/hci/acl_data_channel.h"
 
+#include <algorithm>
 #include <unordered_map>
+#include <vector>
 
 #include <lib/async/cpp/task.h>
 #include <zircon/assert.h>
@@ -12,8 +14,11 @@
 #include "garnet/drivers/bluetooth/lib/hci/connection.h"
 #include "garnet/drivers/bluetooth/lib/hci/defaults.h"
 #include "garnet/drivers/bluetooth/lib/hci/transport.h"
+#include "garnet/drivers/bluetooth/lib/testing/fake_controller.h"
 #include "garnet/drivers/bluetooth/lib/testing/fake_controller_test.h"
+#include "garnet/drivers/bluetooth/lib/testing/fake_device.h"
 #include "garnet/drivers/bluetooth/lib/testing/test_controller.h"
+#include "lib/fxl/strings/string_printf.h"
 
 namespace btlib {
 namespace hci {
@@ -40,6 +45,23 @@ class ACLDataChannelTest : public TestingBase {
 
 using HCI_ACLDataChannelTest = ACLDataChannelTest;
 
+// Returns the connection handle of the ACL data packet in |bytes|.
+ConnectionHandle PacketHandle(const common::ByteBuffer& bytes) {
+  ZX_DEBUG_ASSERT(bytes.size() >= sizeof(ACLDataHeader));
+  return le16toh(bytes.As<ACLDataHeader>().handle_and_flags) & 0xFFF;
+}
+
+// Returns a Number Of Completed Packets event that reports a single packet as
+// completed on |handle|.
+common::DynamicByteBuffer CompletedPacketEvent(ConnectionHandle handle) {
+  return common::DynamicByteBuffer(common::CreateStaticByteBuffer(
+      0x13, 0x05,  // Event header
+      0x01,        // Number of handles
+      static_cast<uint8_t>(handle & 0xFF), static_cast<uint8_t>(handle >> 8),
+      0x01, 0x00  // 1 packet
+      ));
+}
+
 TEST_F(HCI_ACLDataChannelTest, VerifyMTUs) {
   const DataBufferInfo kBREDRBufferInfo(1024, 50);
   const DataBufferInfo kLEBufferInfo(64, 16);
@@ -614,6 +636,137 @@ TEST_F(HCI_ACLDataChannelTest, ClearLinkState) {
   ASSERT_EQ(3, packet_count);
 }
 
+TEST_F(HCI_ACLDataChannelTest, ClearLinkStateDropsQueuedPackets) {
+  constexpr size_t kMaxMTU = 1024;
+  constexpr size_t kMaxNumPackets = 1;
+  constexpr ConnectionHandle kHandle1 = 1;
+  constexpr ConnectionHandle kHandle2 = 2;
+
+  InitializeACLDataChannel(DataBufferInfo(kMaxMTU, kMaxNumPackets),
+                           DataBufferInfo());
+
+  std::vector<ConnectionHandle> received;
+  test_device()->SetDataCallback(
+      [&](const auto& bytes) { received.push_back(PacketHandle(bytes)); },
+      dispatcher());
+
+  // The first packet fills up the buffer and the others get queued.
+  for (auto handle : {kHandle1, kHandle1, kHandle1, kHandle2}) {
+    ASSERT_TRUE(acl_data_channel()->SendPacket(
+        ACLDataPacket::New(handle, ACLPacketBoundaryFlag::kFirstNonFlushable,
+                           ACLBroadcastFlag::kPointToPoint, 1),
+        Connection::LinkType::kLE));
+  }
+  RunLoopUntilIdle();
+  ASSERT_EQ(1u, received.size());
+
+  // Clearing |kHandle1| frees up its buffer slot and drops its queued packets,
+  // so the packet on |kHandle2| should go out next.
+  EXPECT_TRUE(acl_data_channel()->ClearLinkState(kHandle1));
+  RunLoopUntilIdle();
+  ASSERT_EQ(2u, received.size());
+  EXPECT_EQ(kHandle2, received[1]);
+
+  test_device()->SendCommandChannelPacket(CompletedPacketEvent(kHandle2));
+  RunLoopUntilIdle();
+  EXPECT_EQ(2u, received.size());
+
+  // There is no state left for |kHandle1|.
+  EXPECT_FALSE(acl_data_channel()->ClearLinkState(kHandle1));
+}
+
+TEST_F(HCI_ACLDataChannelTest, HighPriorityPacketsBypassQueuedPackets) {
+  constexpr size_t kMaxMTU = 1024;
+  constexpr size_t kMaxNumPackets = 1;
+  constexpr ConnectionHandle kHandle = 1;
+
+  InitializeACLDataChannel(DataBufferInfo(kMaxMTU, kMaxNumPackets),
+                           DataBufferInfo());
+
+  std::vector<uint8_t> received;
+  test_device()->SetDataCallback(
+      [&](const common::ByteBuffer& bytes) {
+        common::PacketView<ACLDataHeader> packet(
+            &bytes, bytes.size() - sizeof(ACLDataHeader));
+        received.push_back(packet.payload_bytes()[0]);
+      },
+      dispatcher());
+
+  auto send = [this](uint8_t id, ACLPacketBoundaryFlag pbf,
+                     ACLDataChannel::PacketPriority priority) {
+    auto packet = ACLDataPacket::New(kHandle, pbf,
+                                     ACLBroadcastFlag::kPointToPoint, 1);
+    packet->mutable_view()->mutable_payload_bytes()[0] = id;
+    EXPECT_TRUE(acl_data_channel()->SendPacket(
+        std::move(packet), Connection::LinkType::kLE, priority));
+  };
+
+  // A low priority PDU in two fragments, followed by a single-fragment low
+  // priority PDU and a high priority PDU.
+  send(1, ACLPacketBoundaryFlag::kFirstNonFlushable,
+       ACLDataChannel::PacketPriority::kLow);
+  send(2, ACLPacketBoundaryFlag::kContinuingFragment,
+       ACLDataChannel::PacketPriority::kLow);
+  send(3, ACLPacketBoundaryFlag::kFirstNonFlushable,
+       ACLDataChannel::PacketPriority::kLow);
+  send(4, ACLPacketBoundaryFlag::kFirstNonFlushable,
+       ACLDataChannel::PacketPriority::kHigh);
+
+  for (int i = 0; i < 4; i++) {
+    RunLoopUntilIdle();
+    test_device()->SendCommandChannelPacket(CompletedPacketEvent(kHandle));
+  }
+  RunLoopUntilIdle();
+
+  // The high priority PDU must not be interleaved with the fragments of the
+  // PDU that was already in flight but must go out ahead of the rest.
+  EXPECT_EQ((std::vector<uint8_t>{1, 2, 4, 3}), received);
+}
+
+TEST_F(HCI_ACLDataChannelTest, RoundRobinBetweenLinks) {
+  constexpr size_t kMaxMTU = 10;
+  constexpr size_t kMaxNumPackets = 1;
+  constexpr ConnectionHandle kHandle1 = 1;
+  constexpr ConnectionHandle kHandle2 = 2;
+
+  InitializeACLDataChannel(DataBufferInfo(kMaxMTU, kMaxNumPackets),
+                           DataBufferInfo());
+
+  std::vector<ConnectionHandle> received;
+  test_device()->SetDataCallback(
+      [&](const auto& bytes) { received.push_back(PacketHandle(bytes)); },
+      dispatcher());
+
+  auto send = [this](ConnectionHandle handle, size_t count) {
+    common::LinkedList<ACLDataPacket> packets;
+    for (size_t i = 0; i < count; i++) {
+      packets.push_back(ACLDataPacket::New(
+          handle, ACLPacketBoundaryFlag::kFirstNonFlushable,
+          ACLBroadcastFlag::kPointToPoint, kMaxMTU));
+    }
+    EXPECT_TRUE(acl_data_channel()->SendPackets(std::move(packets),
+                                                Connection::LinkType::kACL));
+  };
+
+  // |kHandle1| queues up a burst before |kHandle2| has anything to send.
+  send(kHandle1, 4);
+  send(kHandle2, 2);
+
+  for (int i = 0; i < 6; i++) {
+    RunLoopUntilIdle();
+    test_device()->SendCommandChannelPacket(
+        CompletedPacketEvent(received.back()));
+  }
+  RunLoopUntilIdle();
+
+  // Each turn covers a single packet. Once both links have data queued they
+  // take turns, and |kHandle1| sends the rest of its burst once |kHandle2| is
+  // done.
+  EXPECT_EQ((std::vector<ConnectionHandle>{kHandle1, kHandle2, kHandle1,
+                                           kHandle2, kHandle1, kHandle1}),
+            received);
+}
+
 TEST_F(HCI_ACLDataChannelTest, ReceiveData) {
   constexpr size_t kMaxMTU = 5;
   constexpr size_t kMaxNumPackets = 5;
@@ -699,6 +852,128 @@ TEST_F(HCI_ACLDataChannelTest, TransportClosedCallbackBothChannels) {
   EXPECT_EQ(1, closed_cb_count);
 }
 
+// Checks the fairness and latency of the ACL send scheduler against a
+// FakeController that acknowledges every packet as soon as it receives it.
+using FakeControllerTestingBase =
+    ::btlib::testing::FakeControllerTest<::btlib::testing::FakeController>;
+
+class HCI_ACLDataChannelSchedulerTest : public FakeControllerTestingBase {
+ public:
+  HCI_ACLDataChannelSchedulerTest() = default;
+  ~HCI_ACLDataChannelSchedulerTest() override = default;
+
+ protected:
+  static constexpr size_t kLEMTU = 251;
+  static constexpr size_t kLENumPackets = 4;
+  static constexpr size_t kBulkLinkCount = 3;
+  static constexpr size_t kBulkPacketsPerLink = 50;
+
+  // L2CAP channels used for the test traffic. The fake devices ignore both.
+  static constexpr uint16_t kBulkChannelId = 0x0040;
+  static constexpr uint16_t kLESignalingChannelId = 0x0005;
+
+  void SetUp() override {
+    FakeControllerTestingBase::SetUp();
+    StartTestDevice();
+    InitializeACLDataChannel(DataBufferInfo(),
+                             DataBufferInfo(kLEMTU, kLENumPackets));
+
+    // Connect one fake device per link. FakeController assigns connection
+    // handles in increasing order, starting at 1.
+    for (size_t i = 0; i <= kBulkLinkCount; i++) {
+      common::DeviceAddress addr(
+          common::DeviceAddress::Type::kLEPublic,
+          fxl::StringPrintf("00:00:00:00:00:%.2zx", i + 1));
+      test_device()->AddDevice(std::make_unique<testing::FakeDevice>(addr));
+      test_device()->ConnectLowEnergy(addr);
+    }
+    RunLoopUntilIdle();
+
+    test_device()->SetDataCallback(
+        [this](const common::ByteBuffer& bytes) {
+          received_.push_back(PacketHandle(bytes));
+        },
+        dispatcher());
+  }
+
+  // Returns a single-fragment B-frame of |size| bytes on |handle|.
+  static ACLDataPacketPtr NewPDU(ConnectionHandle handle, uint16_t channel_id,
+                                 size_t size) {
+    ZX_DEBUG_ASSERT(size >= 4 && size <= kLEMTU);
+    auto packet = ACLDataPacket::New(
+        handle, ACLPacketBoundaryFlag::kFirstNonFlushable,
+        ACLBroadcastFlag::kPointToPoint, size);
+    auto payload = packet->mutable_view()->mutable_payload_data();
+    payload.Fill(0);
+    payload[0] = static_cast<uint8_t>(size - 4);
+    payload[2] = static_cast<uint8_t>(channel_id & 0xFF);
+    payload[3] = static_cast<uint8_t>(channel_id >> 8);
+    return packet;
+  }
+
+  void QueueBulk(ConnectionHandle handle, size_t count) {
+    common::LinkedList<ACLDataPacket> packets;
+    for (size_t i = 0; i < count; i++) {
+      packets.push_back(NewPDU(handle, kBulkChannelId, kLEMTU));
+    }
+    EXPECT_TRUE(acl_data_channel()->SendPackets(std::move(packets),
+                                                Connection::LinkType::kLE));
+  }
+
+  // Returns the number of packets that reached the controller before the
+  // first one on |handle|.
+  size_t PacketsBefore(ConnectionHandle handle) const {
+    auto iter = std::find(received_.begin(), received_.end(), handle);
+    EXPECT_NE(received_.end(), iter);
+    return iter - received_.begin();
+  }
+
+  const std::vector<ConnectionHandle>& received() const { return received_; }
+
+ private:
+  std::vector<ConnectionHandle> received_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(HCI_ACLDataChannelSchedulerTest);
+};
+
+TEST_F(HCI_ACLDataChannelSchedulerTest, FairnessAndLatency) {
+  constexpr ConnectionHandle kInteractiveHandle = kBulkLinkCount + 1;
+  constexpr size_t kTotalBulkPackets = kBulkLinkCount * kBulkPacketsPerLink;
+
+  // Saturate the controller with bulk data on every bulk link, then send a
+  // small signaling PDU on an otherwise idle link.
+  for (ConnectionHandle handle = 1; handle <= kBulkLinkCount; handle++) {
+    QueueBulk(handle, kBulkPacketsPerLink);
+  }
+  EXPECT_TRUE(acl_data_channel()->SendPacket(
+      NewPDU(kInteractiveHandle, kLESignalingChannelId, 16),
+      Connection::LinkType::kLE, ACLDataChannel::PacketPriority::kHigh));
+
+  RunLoopUntilIdle();
+
+  ASSERT_EQ(kTotalBulkPackets + 1, received().size());
+
+  // With a single FIFO the interactive PDU would have waited behind all of the
+  // bulk data. Now it only waits for the packets that were in flight and for
+  // one turn of each bulk link.
+  const size_t interactive_wait = PacketsBefore(kInteractiveHandle);
+  EXPECT_LE(interactive_wait, kLENumPackets + kBulkLinkCount * 2);
+
+  // Every bulk link gets an equal share of the controller buffer while all of
+  // them are backlogged.
+  const size_t window = kTotalBulkPackets / 2;
+  size_t share[kBulkLinkCount + 1] = {};
+  for (size_t i = 0; i < window; i++) {
+    share[received()[i]]++;
+  }
+  size_t min_share = window, max_share = 0;
+  for (ConnectionHandle handle = 1; handle <= kBulkLinkCount; handle++) {
+    min_share = std::min(min_share, share[handle]);
+    max_share = std::max(max_share, share[handle]);
+  }
+  EXPECT_LE(max_share - min_share, kLENumPackets);
+}
+
 }  // namespace
 }  // namespace hci
 }  // namespace btlib
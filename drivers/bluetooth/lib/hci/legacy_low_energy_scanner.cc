@@ -289,7 +289,12 @@ void LegacyLowEnergyScanner::OnAdvertisingReportEvent(
       continue;
     }
 
-    auto iter = pending_results_.emplace(address, PendingScanResult()).first;
+    // Look up the entry before inserting so that advertisers that are already
+    // pending do not cost a map node allocation for every report.
+    auto iter = pending_results_.find(address);
+    if (iter == pending_results_.end()) {
+      iter = pending_results_.emplace(address, PendingScanResult()).first;
+    }
     auto& pending = iter->second;
 
     // We overwrite the pending result entry with the most recent report, even
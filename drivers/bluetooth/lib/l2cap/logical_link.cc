@@ -34,6 +34,21 @@ constexpr bool IsValidLEFixedChannel(ChannelId id) {
   return false;
 }
 
+// Signaling and SMP traffic is latency sensitive and small, so it is allowed to
+// bypass bulk data that is queued on the same link.
+constexpr hci::ACLDataChannel::PacketPriority ChannelPriority(ChannelId id) {
+  switch (id) {
+    case kSignalingChannelId:
+    case kLESignalingChannelId:
+    case kSMPChannelId:
+    case kLESMPChannelId:
+      return hci::ACLDataChannel::PacketPriority::kHigh;
+    default:
+      break;
+  }
+  return hci::ACLDataChannel::PacketPriority::kLow;
+}
+
 constexpr bool IsValidBREDRFixedChannel(ChannelId id) {
   switch (id) {
     case kSignalingChannelId:
@@ -247,7 +262,8 @@ void LogicalLink::SendBasicFrame(ChannelId id,
   auto fragments = pdu.ReleaseFragments();
 
   ZX_DEBUG_ASSERT(!fragments.is_empty());
-  hci_->acl_data_channel()->SendPackets(std::move(fragments), type_);
+  hci_->acl_data_channel()->SendPackets(std::move(fragments), type_,
+                                        ChannelPriority(id));
 }
 
 void LogicalLink::set_error_callback(fit::closure callback,
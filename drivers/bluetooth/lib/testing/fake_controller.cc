@@ -180,7 +180,8 @@ FakeController::FakeController()
       scan_state_cb_dispatcher_(nullptr),
       advertising_state_cb_dispatcher_(nullptr),
       conn_state_cb_dispatcher_(nullptr),
-      le_conn_params_cb_dispatcher_(nullptr) {}
+      le_conn_params_cb_dispatcher_(nullptr),
+      data_cb_dispatcher_(nullptr) {}
 
 FakeController::~FakeController() { Stop(); }
 
@@ -239,6 +240,15 @@ void FakeController::SetLEConnectionParametersCallback(
   le_conn_params_cb_dispatcher_ = dispatcher;
 }
 
+void FakeController::SetDataCallback(DataCallback callback,
+                                     async_dispatcher_t* dispatcher) {
+  ZX_DEBUG_ASSERT(callback);
+  ZX_DEBUG_ASSERT(dispatcher);
+
+  data_cb_ = std::move(callback);
+  data_cb_dispatcher_ = dispatcher;
+}
+
 FakeDevice* FakeController::FindDeviceByAddress(
     const common::DeviceAddress& addr) {
   for (auto& dev : devices_) {
@@ -1232,6 +1242,15 @@ void FakeController::OnACLDataPacketReceived(
   }
 
   SendNumberOfCompletedPacketsEvent(handle, 1);
+
+  if (data_cb_) {
+    ZX_DEBUG_ASSERT(data_cb_dispatcher_);
+    common::DynamicByteBuffer packet_copy(acl_data_packet);
+    async::PostTask(data_cb_dispatcher_,
+                    [packet_copy = std::move(packet_copy),
+                     cb = data_cb_.share()]() mutable { cb(packet_copy); });
+  }
+
   dev->OnRxL2CAP(handle, acl_data_packet.view(sizeof(hci::ACLDataHeader)));
 }
 
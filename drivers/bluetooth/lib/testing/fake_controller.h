@@ -163,6 +163,11 @@ class FakeController : public FakeControllerBase,
       LEConnectionParametersCallback callback,
       async_dispatcher_t* dispatcher);
 
+  // Sets a callback to be invoked with a copy of every ACL data packet that is
+  // sent to a connected fake device.
+  using DataCallback = fit::function<void(const common::ByteBuffer& packet)>;
+  void SetDataCallback(DataCallback callback, async_dispatcher_t* dispatcher);
+
   // Sends a HCI event with the given parameters.
   void SendEvent(hci::EventCode event_code, const common::ByteBuffer& payload);
 
@@ -326,6 +331,9 @@ class FakeController : public FakeControllerBase,
   LEConnectionParametersCallback le_conn_params_cb_;
   async_dispatcher_t* le_conn_params_cb_dispatcher_;
 
+  DataCallback data_cb_;
+  async_dispatcher_t* data_cb_dispatcher_;
+
   FXL_DISALLOW_COPY_AND_ASSIGN(FakeController);
 };
 
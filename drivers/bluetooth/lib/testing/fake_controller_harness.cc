@@ -0,0 +1,46 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/drivers/bluetooth/lib/testing/fake_controller_harness.h"
+
+#include <zircon/assert.h>
+
+#include "garnet/drivers/bluetooth/lib/hci/device_wrapper.h"
+
+namespace btlib {
+namespace testing {
+
+FakeControllerHarness::FakeControllerHarness(
+    const hci::DataBufferInfo& bredr_buffer_info,
+    const hci::DataBufferInfo& le_buffer_info) {
+  zx::channel cmd0, cmd1;
+  zx::channel acl0, acl1;
+  zx_status_t status = zx::channel::create(0, &cmd0, &cmd1);
+  ZX_ASSERT(status == ZX_OK);
+  status = zx::channel::create(0, &acl0, &acl1);
+  ZX_ASSERT(status == ZX_OK);
+
+  test_device_ = std::make_unique<FakeController>();
+  transport_ = hci::Transport::Create(std::make_unique<hci::DummyDeviceWrapper>(
+      std::move(cmd0), std::move(acl0)));
+  ZX_ASSERT(transport_->Initialize(dispatcher()));
+  ZX_ASSERT(
+      transport_->InitializeACLDataChannel(bredr_buffer_info, le_buffer_info));
+
+  test_device_->StartCmdChannel(std::move(cmd1));
+  test_device_->StartAclChannel(std::move(acl1));
+}
+
+FakeControllerHarness::~FakeControllerHarness() {
+  if (transport_->IsInitialized()) {
+    transport_->ShutDown();
+  }
+  RunLoopUntilIdle();
+
+  transport_ = nullptr;
+  test_device_ = nullptr;
+}
+
+}  // namespace testing
+}  // namespace btlib
@@ -0,0 +1,57 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GARNET_DRIVERS_BLUETOOTH_LIB_TESTING_FAKE_CONTROLLER_HARNESS_H_
+#define GARNET_DRIVERS_BLUETOOTH_LIB_TESTING_FAKE_CONTROLLER_HARNESS_H_
+
+#include <memory>
+
+#include <lib/async-testutils/test_loop.h>
+
+#include "garnet/drivers/bluetooth/lib/hci/acl_data_channel.h"
+#include "garnet/drivers/bluetooth/lib/hci/transport.h"
+#include "garnet/drivers/bluetooth/lib/testing/fake_controller.h"
+#include "lib/fxl/macros.h"
+
+namespace btlib {
+namespace testing {
+
+// FakeControllerHarness sets up the same HCI transport and FakeController as
+// FakeControllerTest<FakeController>, on a test loop, for code that does not
+// run under gtest such as benchmarks. The FakeController is started and the
+// ACL data channel initialized with the given buffer information.
+class FakeControllerHarness final {
+ public:
+  FakeControllerHarness(const hci::DataBufferInfo& bredr_buffer_info,
+                        const hci::DataBufferInfo& le_buffer_info);
+  ~FakeControllerHarness();
+
+  async_dispatcher_t* dispatcher() { return loop_.dispatcher(); }
+
+  // Dispatches all waits and tasks that are due, as
+  // TestLoopFixture::RunLoopUntilIdle() does.
+  bool RunLoopUntilIdle() { return loop_.RunUntilIdle(); }
+
+  // Dispatches all waits and tasks due within |duration|, advancing the fake
+  // clock, as TestLoopFixture::RunLoopFor() does.
+  bool RunLoopFor(zx::duration duration) { return loop_.RunFor(duration); }
+
+  FakeController* test_device() const { return test_device_.get(); }
+  fxl::RefPtr<hci::Transport> transport() const { return transport_; }
+  hci::ACLDataChannel* acl_data_channel() const {
+    return transport_->acl_data_channel();
+  }
+
+ private:
+  async::TestLoop loop_;
+  std::unique_ptr<FakeController> test_device_;
+  fxl::RefPtr<hci::Transport> transport_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(FakeControllerHarness);
+};
+
+}  // namespace testing
+}  // namespace btlib
+
+#endif  // GARNET_DRIVERS_BLUETOOTH_LIB_TESTING_FAKE_CONTROLLER_HARNESS_H_
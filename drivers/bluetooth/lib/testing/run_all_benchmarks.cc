@@ -0,0 +1,19 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <perftest/perftest.h>
+
+#include <ddk/driver.h>
+
+#include "garnet/drivers/bluetooth/lib/common/log.h"
+
+BT_DECLARE_FAKE_DRIVER();
+
+int main(int argc, char** argv) {
+  // Set all library log messages to use printf instead ddk logging, and keep
+  // them out of the way of the results.
+  btlib::common::UsePrintf(btlib::common::LogSeverity::ERROR);
+
+  return perftest::PerfTestMain(argc, argv, "fuchsia.bluetooth");
+}
@@ -26,7 +26,7 @@ void msd_connection_close(msd_connection_t* connection)
     delete MsdArmAbiConnection::cast(connection);
 }
 
-msd_context_t* msd_connection_create_context(msd_connection_t* abi_connection)
+msd_context_t* msd_connection_create_context(msd_connection_t* abi_connection, uint32_t priority)
 {
     auto connection = MsdArmAbiConnection::cast(abi_connection);
     auto context = std::make_unique<MsdArmContext>(connection->ptr());
@@ -252,7 +252,7 @@ private:
             new MagmaSystemConnection(system_dev_, MsdConnectionUniquePtr(msd_connection_t)));
         if (!connection_)
             return DRETP(nullptr, "failed to connect to msd device");
-        connection_->CreateContext(ctx_id);
+        connection_->CreateContext(ctx_id, MAGMA_CONTEXT_PRIORITY_MEDIUM);
         auto ctx = connection_->LookupContext(ctx_id);
         if (!ctx)
             return DRETP(nullptr, "failed to create context");
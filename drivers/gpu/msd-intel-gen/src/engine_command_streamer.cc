@@ -495,7 +495,7 @@ RenderEngineCommandStreamer::Create(EngineCommandStreamer::Owner* owner)
 RenderEngineCommandStreamer::RenderEngineCommandStreamer(EngineCommandStreamer::Owner* owner)
     : EngineCommandStreamer(owner, RENDER_COMMAND_STREAMER, kRenderEngineMmioBase)
 {
-    scheduler_ = Scheduler::CreateFifoScheduler();
+    scheduler_ = Scheduler::CreatePriorityScheduler();
 }
 
 bool RenderEngineCommandStreamer::RenderInit(std::shared_ptr<MsdIntelContext> context,
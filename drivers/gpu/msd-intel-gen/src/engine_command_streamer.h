@@ -111,6 +111,8 @@ public:
     // to safe the result and this method must be called from the device thread
     std::vector<MappedBatch*> GetInflightBatches();
 
+    Scheduler* scheduler() { return scheduler_.get(); }
+
 private:
     RenderEngineCommandStreamer(EngineCommandStreamer::Owner* owner);
 
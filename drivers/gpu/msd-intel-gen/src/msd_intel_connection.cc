@@ -6,19 +6,21 @@
 #include "magma_util/dlog.h"
 #include "msd_intel_semaphore.h"
 #include "ppgtt.h"
+#include "scheduler.h"
 
 void msd_connection_close(msd_connection_t* connection)
 {
     delete MsdIntelAbiConnection::cast(connection);
 }
 
-msd_context_t* msd_connection_create_context(msd_connection_t* abi_connection)
+msd_context_t* msd_connection_create_context(msd_connection_t* abi_connection, uint32_t priority)
 {
     auto connection = MsdIntelAbiConnection::cast(abi_connection)->ptr();
 
     // Backing store creation deferred until context is used.
-    return new MsdIntelAbiContext(
-        std::make_unique<ClientContext>(connection, connection->per_process_gtt()));
+    auto context = std::make_unique<ClientContext>(connection, connection->per_process_gtt());
+    context->set_priority(Scheduler::PriorityFromMagmaPriority(priority));
+    return new MsdIntelAbiContext(std::move(context));
 }
 
 void msd_connection_set_notification_callback(struct msd_connection_t* connection,
@@ -70,6 +70,9 @@ public:
 
     std::shared_ptr<AddressSpace> exec_address_space() { return address_space_; }
 
+    ContextPriority priority() { return priority_; }
+    void set_priority(ContextPriority priority) { priority_ = priority; }
+
 private:
     struct PerEngineState {
         std::shared_ptr<MsdIntelBuffer> context_buffer;
@@ -80,6 +83,7 @@ private:
     std::map<EngineCommandStreamerId, PerEngineState> state_map_;
     std::queue<std::unique_ptr<MappedBatch>> pending_batch_queue_;
     std::shared_ptr<AddressSpace> address_space_;
+    ContextPriority priority_ = CONTEXT_PRIORITY_MEDIUM;
 
     friend class TestContext;
 };
@@ -62,6 +62,7 @@ public:
             uint32_t sequence_number;
             uint64_t active_head_pointer;
             std::vector<MappedBatch*> inflight_batches;
+            std::vector<Scheduler::ContextStats> context_stats;
         } render_cs;
 
         bool fault_present;
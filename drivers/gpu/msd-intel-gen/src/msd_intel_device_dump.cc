@@ -296,6 +296,7 @@ void MsdIntelDevice::Dump(DumpState* dump_out)
         global_context_->hardware_status_page(render_engine_cs_->id())->read_sequence_number();
     dump_out->render_cs.active_head_pointer = render_engine_cs_->GetActiveHeadPointer();
     dump_out->render_cs.inflight_batches = render_engine_cs_->GetInflightBatches();
+    dump_out->render_cs.context_stats = render_engine_cs_->scheduler()->GetContextStats();
 
     DumpFault(dump_out, registers::AllEngineFault::read(register_io_.get()));
 
@@ -503,6 +504,26 @@ void MsdIntelDevice::FormatDump(DumpState& dump_state, std::string& dump_out)
         }
     }
 
+    if (!dump_state.render_cs.context_stats.empty()) {
+        dump_out.append("Contexts:\n");
+        for (auto& stats : dump_state.render_cs.context_stats) {
+            using std::chrono::microseconds;
+            using std::chrono::duration_cast;
+            fmt = "  Context %p, connection client_id %lu, priority %u, command buffers %lu, "
+                  "gpu time %ld us, queue latency p50 %ld us p90 %ld us p99 %ld us\n";
+            int64_t gpu_time_us = duration_cast<microseconds>(stats.gpu_time).count();
+            int64_t p50_us = duration_cast<microseconds>(stats.queue_latency_p50).count();
+            int64_t p90_us = duration_cast<microseconds>(stats.queue_latency_p90).count();
+            int64_t p99_us = duration_cast<microseconds>(stats.queue_latency_p99).count();
+            size = std::snprintf(nullptr, 0, fmt, stats.context, stats.client_id, stats.priority,
+                                 stats.command_buffer_count, gpu_time_us, p50_us, p90_us, p99_us);
+            std::vector<char> buf(size + 1);
+            std::snprintf(&buf[0], buf.size(), fmt, stats.context, stats.client_id, stats.priority,
+                          stats.command_buffer_count, gpu_time_us, p50_us, p90_us, p99_us);
+            dump_out.append(&buf[0]);
+        }
+    }
+
 #if MSD_INTEL_ENABLE_MAPPING_CACHE
     dump_out.append("mapping cache: ENABLED\n");
 #else
@@ -3,8 +3,8 @@
 // found in the LICENSE file.
 
 #include "ppgtt.h"
+#include "magma_util/free_list_allocator.h"
 #include "magma_util/macros.h"
-#include "magma_util/simple_allocator.h"
 #include "platform_buffer.h"
 #include "registers.h"
 
@@ -148,7 +148,7 @@ bool PerProcessGtt::Init()
 
     uint64_t start = 0;
 
-    allocator_ = magma::SimpleAllocator::Create(start, Size());
+    allocator_ = magma::FreeListAllocator::Create(start, Size());
     if (!allocator_)
         return DRETF(false, "failed to create allocator");
 
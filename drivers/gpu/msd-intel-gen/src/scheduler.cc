@@ -6,6 +6,9 @@
 #include "msd_intel_connection.h"
 #include "msd_intel_context.h"
 #include "platform_trace.h"
+#include <algorithm>
+#include <deque>
+#include <map>
 
 class FifoScheduler : public Scheduler {
 public:
@@ -75,7 +78,288 @@ void FifoScheduler::CommandBufferCompleted(std::shared_ptr<MsdIntelContext> cont
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+class PriorityScheduler : public Scheduler {
+public:
+    PriorityScheduler(std::function<Clock::time_point()> now) : now_(std::move(now)) {}
+
+    void CommandBufferQueued(std::weak_ptr<MsdIntelContext> context) override;
+    void CommandBufferCompleted(std::shared_ptr<MsdIntelContext> context) override;
+
+    std::shared_ptr<MsdIntelContext> ScheduleContext() override;
+
+    std::vector<ContextStats> GetContextStats() override;
+
+    // The longest a context keeps the engine while others have work.
+    static constexpr Clock::duration kTimeslice = std::chrono::milliseconds(5);
+
+    // Bounds the work queued on the engine ahead of a context of higher priority.
+    static constexpr uint32_t kMaxInflightCommandBuffers = 8;
+
+    static constexpr uint32_t kLatencySampleCount = 256;
+
+private:
+    struct ContextState {
+        std::weak_ptr<MsdIntelContext> context;
+        // The time each pending command buffer was queued.
+        std::deque<Clock::time_point> queue_times;
+        // GPU time divided by the priority weight. The runnable context with the least virtual
+        // time is scheduled next.
+        Clock::duration virtual_time{};
+        Clock::duration gpu_time{};
+        uint64_t command_buffer_count = 0;
+        std::vector<Clock::duration> latency_samples;
+        uint32_t next_latency_sample = 0;
+    };
+
+    static uint32_t weight(ContextPriority priority);
+
+    // Returns true if a context of higher priority than |priority| has work.
+    bool HigherPriorityRunnable(ContextPriority priority);
+    bool CanContinue(Clock::time_point now);
+
+    std::shared_ptr<MsdIntelContext> Dispatch(Clock::time_point now);
+    void ChargeCurrent(Clock::time_point now);
+    void EndSlice();
+
+    std::function<Clock::time_point()> now_;
+    std::map<MsdIntelContext*, ContextState> contexts_;
+    std::shared_ptr<MsdIntelContext> current_context_;
+    ContextState* current_state_ = nullptr;
+    uint32_t current_count_{};
+    Clock::time_point slice_start_;
+    Clock::time_point last_charge_;
+    Clock::duration min_virtual_time_{};
+    uint64_t nonce_;
+};
+
+constexpr Scheduler::Clock::duration PriorityScheduler::kTimeslice;
+
+uint32_t PriorityScheduler::weight(ContextPriority priority)
+{
+    switch (priority) {
+        case CONTEXT_PRIORITY_LOW:
+            return 1;
+        case CONTEXT_PRIORITY_MEDIUM:
+            return 2;
+        case CONTEXT_PRIORITY_HIGH:
+            return 4;
+        case CONTEXT_PRIORITY_REALTIME:
+            return 8;
+    }
+    DASSERT(false);
+    return 1;
+}
+
+void PriorityScheduler::CommandBufferQueued(std::weak_ptr<MsdIntelContext> weak_context)
+{
+    auto context = weak_context.lock();
+    if (!context)
+        return;
+
+    ContextState& state = contexts_[context.get()];
+    if (state.context.lock() != context) {
+        // A new context, possibly at the address of one that has been destroyed.
+        state = ContextState();
+        state.context = context;
+        state.virtual_time = min_virtual_time_;
+    } else if (state.queue_times.empty() && &state != current_state_) {
+        // Idle time doesn't earn credit over contexts that kept the engine busy.
+        state.virtual_time = std::max(state.virtual_time, min_virtual_time_);
+    }
+
+    state.queue_times.push_back(now_());
+}
+
+bool PriorityScheduler::HigherPriorityRunnable(ContextPriority priority)
+{
+    for (auto& pair : contexts_) {
+        ContextState& state = pair.second;
+        if (state.queue_times.empty())
+            continue;
+        auto context = state.context.lock();
+        if (context && !context->killed() && context->priority() > priority)
+            return true;
+    }
+    return false;
+}
+
+bool PriorityScheduler::CanContinue(Clock::time_point now)
+{
+    DASSERT(current_context_);
+    return !current_context_->killed() && !current_state_->queue_times.empty() &&
+           current_count_ < kMaxInflightCommandBuffers && now - slice_start_ < kTimeslice &&
+           !HigherPriorityRunnable(current_context_->priority());
+}
+
+std::shared_ptr<MsdIntelContext> PriorityScheduler::ScheduleContext()
+{
+    Clock::time_point now = now_();
+
+    if (current_context_) {
+        if (CanContinue(now))
+            return Dispatch(now);
+
+        // Contexts are switched only when the engine is idle.
+        if (current_count_ > 0)
+            return nullptr;
+
+        EndSlice();
+    }
+
+    ContextState* next = nullptr;
+    std::shared_ptr<MsdIntelContext> next_context;
+
+    for (auto iter = contexts_.begin(); iter != contexts_.end();) {
+        ContextState& state = iter->second;
+        auto context = state.context.lock();
+        if (!context) {
+            iter = contexts_.erase(iter);
+            continue;
+        }
+        ++iter;
+
+        if (context->killed()) {
+            DLOG("context killed");
+            state.queue_times.clear();
+            continue;
+        }
+
+        if (state.queue_times.empty())
+            continue;
+
+        if (!next || state.virtual_time < next->virtual_time ||
+            (state.virtual_time == next->virtual_time &&
+             context->priority() > next_context->priority())) {
+            next = &state;
+            next_context = std::move(context);
+        }
+    }
+
+    if (!next)
+        return nullptr;
+
+    min_virtual_time_ = std::max(min_virtual_time_, next->virtual_time);
+
+    current_context_ = std::move(next_context);
+    current_state_ = next;
+    slice_start_ = now;
+
+    auto connection = current_context_->connection().lock();
+    uint64_t id = connection ? connection->client_id() : 0;
+    nonce_ = TRACE_NONCE();
+    TRACE_ASYNC_BEGIN("magma", "Context Exec", nonce_, "id", id, "priority",
+                      static_cast<uint32_t>(current_context_->priority()));
+
+    return Dispatch(now);
+}
+
+std::shared_ptr<MsdIntelContext> PriorityScheduler::Dispatch(Clock::time_point now)
+{
+    DASSERT(current_state_);
+    DASSERT(!current_state_->queue_times.empty());
+
+    Clock::duration latency = now - current_state_->queue_times.front();
+    current_state_->queue_times.pop_front();
+
+    if (current_state_->latency_samples.size() < kLatencySampleCount) {
+        current_state_->latency_samples.push_back(latency);
+    } else {
+        current_state_->latency_samples[current_state_->next_latency_sample] = latency;
+        current_state_->next_latency_sample =
+            (current_state_->next_latency_sample + 1) % kLatencySampleCount;
+    }
+
+    current_state_->command_buffer_count++;
+
+    if (current_count_++ == 0)
+        last_charge_ = now;
+
+    return current_context_;
+}
+
+void PriorityScheduler::ChargeCurrent(Clock::time_point now)
+{
+    Clock::duration elapsed = now - last_charge_;
+    last_charge_ = now;
+
+    current_state_->gpu_time += elapsed;
+    current_state_->virtual_time += elapsed / weight(current_context_->priority());
+}
+
+void PriorityScheduler::CommandBufferCompleted(std::shared_ptr<MsdIntelContext> context)
+{
+    DASSERT(current_count_);
+    DASSERT(context == current_context_);
+
+    ChargeCurrent(now_());
+
+    if (--current_count_ > 0)
+        return;
+
+    // Keep the rest of the timeslice only if there's work to use it.
+    if (current_context_->killed() || current_state_->queue_times.empty())
+        EndSlice();
+}
+
+void PriorityScheduler::EndSlice()
+{
+    DASSERT(current_context_);
+    DASSERT(current_count_ == 0);
+    TRACE_ASYNC_END("magma", "Context Exec", nonce_);
+    current_context_.reset();
+    current_state_ = nullptr;
+}
+
+static Scheduler::Clock::duration Percentile(std::vector<Scheduler::Clock::duration> samples,
+                                             uint32_t percent)
+{
+    if (samples.empty())
+        return Scheduler::Clock::duration::zero();
+    // Nearest rank.
+    auto nth = samples.begin() + (samples.size() * percent + 99) / 100 - 1;
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+std::vector<Scheduler::ContextStats> PriorityScheduler::GetContextStats()
+{
+    std::vector<ContextStats> stats;
+    for (auto& pair : contexts_) {
+        ContextState& state = pair.second;
+        auto context = state.context.lock();
+        if (!context)
+            continue;
+
+        auto connection = context->connection().lock();
+        stats.push_back({context.get(), connection ? connection->client_id() : 0,
+                         context->priority(), state.command_buffer_count, state.gpu_time,
+                         Percentile(state.latency_samples, 50),
+                         Percentile(state.latency_samples, 90),
+                         Percentile(state.latency_samples, 99)});
+    }
+    return stats;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ContextPriority Scheduler::PriorityFromMagmaPriority(uint32_t magma_priority)
+{
+    if (magma_priority >= MAGMA_CONTEXT_PRIORITY_REALTIME)
+        return CONTEXT_PRIORITY_REALTIME;
+    if (magma_priority >= MAGMA_CONTEXT_PRIORITY_HIGH)
+        return CONTEXT_PRIORITY_HIGH;
+    if (magma_priority >= MAGMA_CONTEXT_PRIORITY_MEDIUM)
+        return CONTEXT_PRIORITY_MEDIUM;
+    return CONTEXT_PRIORITY_LOW;
+}
+
 std::unique_ptr<Scheduler> Scheduler::CreateFifoScheduler()
 {
     return std::make_unique<FifoScheduler>();
 }
+
+std::unique_ptr<Scheduler>
+Scheduler::CreatePriorityScheduler(std::function<Clock::time_point()> now)
+{
+    return std::make_unique<PriorityScheduler>(std::move(now));
+}
@@ -5,13 +5,33 @@
 #ifndef SCHEDULER_H
 #define SCHEDULER_H
 
+#include "types.h"
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <vector>
 
 class MsdIntelContext;
 class CommandBuffer;
 
 class Scheduler {
 public:
+    using Clock = std::chrono::steady_clock;
+
+    struct ContextStats {
+        MsdIntelContext* context;
+        uint64_t client_id;
+        ContextPriority priority;
+        uint64_t command_buffer_count;
+        // Time the engine spent executing the context's command buffers.
+        Clock::duration gpu_time;
+        // Percentiles of the time from a command buffer being queued to being scheduled, over
+        // recent command buffers.
+        Clock::duration queue_latency_p50;
+        Clock::duration queue_latency_p90;
+        Clock::duration queue_latency_p99;
+    };
+
     virtual ~Scheduler() = default;
 
     // Notifies the scheduler that a command buffer has been scheduled on the given context.
@@ -23,7 +43,19 @@ public:
     // Selects the context whose command buffer will be executed next.
     virtual std::shared_ptr<MsdIntelContext> ScheduleContext() = 0;
 
+    // Returns the accounting for each live context, if the scheduler keeps any.
+    virtual std::vector<ContextStats> GetContextStats() { return {}; }
+
+    // Maps a MAGMA_CONTEXT_PRIORITY_* value onto a context priority.
+    static ContextPriority PriorityFromMagmaPriority(uint32_t magma_priority);
+
     static std::unique_ptr<Scheduler> CreateFifoScheduler();
+
+    // Shares the engine between contexts in proportion to the weight of their priorities. A
+    // context keeps the engine for up to a timeslice, and gives it up early when a context of
+    // higher priority has work. Context switches happen only between command buffers.
+    static std::unique_ptr<Scheduler>
+    CreatePriorityScheduler(std::function<Clock::time_point()> now = Clock::now);
 };
 
 #endif // SCHEDULER_H
@@ -30,4 +30,12 @@ enum EngineCommandStreamerId {
     RENDER_COMMAND_STREAMER,
 };
 
+// Ordered from lowest to highest.
+enum ContextPriority {
+    CONTEXT_PRIORITY_LOW,
+    CONTEXT_PRIORITY_MEDIUM,
+    CONTEXT_PRIORITY_HIGH,
+    CONTEXT_PRIORITY_REALTIME,
+};
+
 #endif // TYPES_H
@@ -4,6 +4,7 @@
 
 #include "mock/mock_bus_mapper.h"
 #include "msd_intel_connection.h"
+#include "msd_intel_context.h"
 #include "gtest/gtest.h"
 
 class TestMsdIntelConnection : public MsdIntelConnection::Owner {
@@ -30,6 +31,23 @@ public:
         connection->SendNotification(test_buffer_ids_);
     }
 
+    void CreateContextPriority()
+    {
+        auto abi_connection = std::make_unique<MsdIntelAbiConnection>(
+            std::shared_ptr<MsdIntelConnection>(MsdIntelConnection::Create(this, 0)));
+
+        msd_context_t* abi_context = msd_connection_create_context(abi_connection.get(), 0);
+        ASSERT_NE(abi_context, nullptr);
+        EXPECT_EQ(CONTEXT_PRIORITY_LOW, MsdIntelAbiContext::cast(abi_context)->ptr()->priority());
+        msd_context_destroy(abi_context);
+
+        abi_context =
+            msd_connection_create_context(abi_connection.get(), MAGMA_CONTEXT_PRIORITY_HIGH);
+        ASSERT_NE(abi_context, nullptr);
+        EXPECT_EQ(CONTEXT_PRIORITY_HIGH, MsdIntelAbiContext::cast(abi_context)->ptr()->priority());
+        msd_context_destroy(abi_context);
+    }
+
     static void CallbackStatic(void* token, msd_notification_t* notification)
     {
         reinterpret_cast<TestMsdIntelConnection*>(token)->Callback(notification);
@@ -76,3 +94,8 @@ private:
 };
 
 TEST(MsdIntelConnection, Notification) { TestMsdIntelConnection().Notification(); }
+
+TEST(MsdIntelConnection, CreateContextPriority)
+{
+    TestMsdIntelConnection().CreateContextPriority();
+}
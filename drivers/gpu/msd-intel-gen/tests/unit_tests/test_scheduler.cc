@@ -74,7 +74,132 @@ public:
         EXPECT_EQ(nullptr, context);
     }
 
+    void Queue(Scheduler* scheduler, uint32_t index)
+    {
+        context_[index]->pending_batch_queue().push(std::make_unique<MockMappedBatch>());
+        scheduler->CommandBufferQueued(context_[index]);
+    }
+
+    void Priority()
+    {
+        auto scheduler = Scheduler::CreatePriorityScheduler([this]() { return now_; });
+
+        EXPECT_EQ(nullptr, scheduler->ScheduleContext());
+
+        context_[0]->set_priority(CONTEXT_PRIORITY_LOW);
+        context_[1]->set_priority(CONTEXT_PRIORITY_HIGH);
+
+        Queue(scheduler.get(), 0);
+        Queue(scheduler.get(), 0);
+
+        EXPECT_EQ(context_[0], scheduler->ScheduleContext());
+        EXPECT_EQ(context_[0], scheduler->ScheduleContext());
+        EXPECT_EQ(nullptr, scheduler->ScheduleContext());
+
+        Queue(scheduler.get(), 0);
+        Queue(scheduler.get(), 1);
+
+        // The low priority context gives way, but its inflight work isn't preempted.
+        EXPECT_EQ(nullptr, scheduler->ScheduleContext());
+
+        now_ += std::chrono::milliseconds(1);
+        scheduler->CommandBufferCompleted(context_[0]);
+        EXPECT_EQ(nullptr, scheduler->ScheduleContext());
+
+        now_ += std::chrono::milliseconds(1);
+        scheduler->CommandBufferCompleted(context_[0]);
+        EXPECT_EQ(context_[1], scheduler->ScheduleContext());
+        EXPECT_EQ(nullptr, scheduler->ScheduleContext());
+
+        now_ += std::chrono::milliseconds(1);
+        scheduler->CommandBufferCompleted(context_[1]);
+        EXPECT_EQ(context_[0], scheduler->ScheduleContext());
+
+        now_ += std::chrono::milliseconds(1);
+        scheduler->CommandBufferCompleted(context_[0]);
+        EXPECT_EQ(nullptr, scheduler->ScheduleContext());
+
+        auto stats = scheduler->GetContextStats();
+        ASSERT_EQ(2u, stats.size());
+        for (auto& context_stats : stats) {
+            if (context_stats.context == context_[0].get()) {
+                EXPECT_EQ(CONTEXT_PRIORITY_LOW, context_stats.priority);
+                EXPECT_EQ(3u, context_stats.command_buffer_count);
+                EXPECT_EQ(std::chrono::milliseconds(3), context_stats.gpu_time);
+                EXPECT_EQ(std::chrono::milliseconds(0), context_stats.queue_latency_p50);
+                EXPECT_EQ(std::chrono::milliseconds(3), context_stats.queue_latency_p99);
+            } else {
+                EXPECT_EQ(context_[1].get(), context_stats.context);
+                EXPECT_EQ(1u, context_stats.command_buffer_count);
+                EXPECT_EQ(std::chrono::milliseconds(1), context_stats.gpu_time);
+                EXPECT_EQ(std::chrono::milliseconds(2), context_stats.queue_latency_p50);
+            }
+        }
+    }
+
+    void Timeslice()
+    {
+        auto scheduler = Scheduler::CreatePriorityScheduler([this]() { return now_; });
+
+        Queue(scheduler.get(), 0);
+        EXPECT_EQ(context_[0], scheduler->ScheduleContext());
+
+        Queue(scheduler.get(), 0);
+        Queue(scheduler.get(), 1);
+
+        // Context 0 keeps the engine while its timeslice lasts.
+        now_ += std::chrono::milliseconds(1);
+        scheduler->CommandBufferCompleted(context_[0]);
+        EXPECT_EQ(context_[0], scheduler->ScheduleContext());
+
+        Queue(scheduler.get(), 0);
+
+        now_ += std::chrono::milliseconds(10);
+        scheduler->CommandBufferCompleted(context_[0]);
+        EXPECT_EQ(context_[1], scheduler->ScheduleContext());
+
+        now_ += std::chrono::milliseconds(1);
+        scheduler->CommandBufferCompleted(context_[1]);
+        EXPECT_EQ(context_[0], scheduler->ScheduleContext());
+        scheduler->CommandBufferCompleted(context_[0]);
+        EXPECT_EQ(nullptr, scheduler->ScheduleContext());
+    }
+
+    void WeightedShare()
+    {
+        auto scheduler = Scheduler::CreatePriorityScheduler([this]() { return now_; });
+
+        context_[0]->set_priority(CONTEXT_PRIORITY_MEDIUM);
+        context_[1]->set_priority(CONTEXT_PRIORITY_REALTIME);
+
+        // Both contexts always have work. Each command buffer takes a full timeslice.
+        constexpr uint32_t kCommandBufferCount = 100;
+        Queue(scheduler.get(), 0);
+        Queue(scheduler.get(), 1);
+
+        for (uint32_t i = 0; i < kCommandBufferCount; i++) {
+            auto context = scheduler->ScheduleContext();
+            ASSERT_NE(nullptr, context);
+            Queue(scheduler.get(), context == context_[0] ? 0 : 1);
+
+            now_ += std::chrono::milliseconds(10);
+            scheduler->CommandBufferCompleted(context);
+        }
+
+        uint64_t count[2] = {};
+        for (auto& context_stats : scheduler->GetContextStats()) {
+            count[context_stats.context == context_[0].get() ? 0 : 1] =
+                context_stats.command_buffer_count;
+        }
+
+        // Realtime weighs four times medium.
+        EXPECT_EQ(kCommandBufferCount, count[0] + count[1]);
+        EXPECT_EQ(20u, count[0]);
+        EXPECT_EQ(80u, count[1]);
+    }
+
 private:
+    Scheduler::Clock::time_point now_;
     std::weak_ptr<MsdIntelConnection> connection_;
     std::shared_ptr<MsdIntelContext> context_[kNumContext];
 };
@@ -84,3 +209,33 @@ TEST(Scheduler, Fifo)
     TestScheduler test;
     test.Fifo();
 }
+
+TEST(Scheduler, Priority)
+{
+    TestScheduler test;
+    test.Priority();
+}
+
+TEST(Scheduler, Timeslice)
+{
+    TestScheduler test;
+    test.Timeslice();
+}
+
+TEST(Scheduler, WeightedShare)
+{
+    TestScheduler test;
+    test.WeightedShare();
+}
+
+TEST(Scheduler, MagmaPriority)
+{
+    EXPECT_EQ(CONTEXT_PRIORITY_LOW,
+              Scheduler::PriorityFromMagmaPriority(MAGMA_CONTEXT_PRIORITY_LOW));
+    EXPECT_EQ(CONTEXT_PRIORITY_MEDIUM,
+              Scheduler::PriorityFromMagmaPriority(MAGMA_CONTEXT_PRIORITY_MEDIUM));
+    EXPECT_EQ(CONTEXT_PRIORITY_HIGH,
+              Scheduler::PriorityFromMagmaPriority(MAGMA_CONTEXT_PRIORITY_HIGH));
+    EXPECT_EQ(CONTEXT_PRIORITY_REALTIME,
+              Scheduler::PriorityFromMagmaPriority(MAGMA_CONTEXT_PRIORITY_REALTIME));
+}
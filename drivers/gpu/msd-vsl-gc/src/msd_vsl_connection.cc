@@ -12,7 +12,7 @@ void msd_connection_close(msd_connection_t* connection)
     delete MsdVslAbiConnection::cast(connection);
 }
 
-msd_context_t* msd_connection_create_context(msd_connection_t* abi_connection)
+msd_context_t* msd_connection_create_context(msd_connection_t* abi_connection, uint32_t priority)
 {
     return new MsdVslAbiContext(std::make_shared<MsdVslContext>(
         MsdVslAbiConnection::cast(abi_connection)->ptr()->address_space()));
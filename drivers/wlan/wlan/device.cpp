@@ -135,6 +135,7 @@ zx_status_t Device::Bind() __TA_NO_THREAD_SAFETY_ANALYSIS {
     state_->set_address(common::MacAddr(wlanmac_info_.ifc_info.mac_addr));
 
     fbl::unique_ptr<Mlme> mlme;
+    BufferPoolConfig pool_config;
 
     // mac_role is a bitfield, but only a single value is supported for an interface
     switch (wlanmac_info_.ifc_info.mac_role) {
@@ -145,16 +146,21 @@ zx_status_t Device::Bind() __TA_NO_THREAD_SAFETY_ANALYSIS {
     case WLAN_MAC_ROLE_AP:
         infof("Initialize an AP MLME.\n");
         mlme.reset(new ApMlme(this));
+        // An AP buffers data frames for each of its dozing clients.
+        pool_config.large_slabs = 2 * kLargeSlabs;
         break;
     case WLAN_MAC_ROLE_MESH:
         infof("Initialize a mesh MLME.\n");
         mlme.reset(new MeshMlme(this));
+        // A mesh node forwards frames on behalf of its peers.
+        pool_config.large_slabs = 2 * kLargeSlabs;
         break;
     default:
         errorf("unsupported MAC role: %u\n", wlanmac_info_.ifc_info.mac_role);
         return ZX_ERR_NOT_SUPPORTED;
     }
     ZX_DEBUG_ASSERT(mlme != nullptr);
+    RaiseBufferPoolConfig(pool_config);
     status = mlme->Init();
     if (status != ZX_OK) {
         errorf("could not initialize MLME: %d\n", status);
@@ -640,7 +646,7 @@ void Device::MainLoop() {
 
 void Device::ProcessChannelPacketLocked(const zx_port_packet_t& pkt) {
     for (size_t i = 0; i < pkt.signal.count; ++i) {
-        auto buffer = LargeBufferAllocator::New();
+        auto buffer = LargeBufferPool::New();
         if (buffer == nullptr) {
             errorf("no free buffers available!\n");
             // TODO: reply on the channel
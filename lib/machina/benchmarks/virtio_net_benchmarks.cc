@@ -0,0 +1,188 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include <lib/async-loop/cpp/loop.h>
+#include <perftest/perftest.h>
+#include <virtio/virtio.h>
+#include <zircon/assert.h>
+#include <zircon/ethernet/c/fidl.h>
+
+#include "garnet/lib/machina/phys_mem_fake.h"
+#include "garnet/lib/machina/virtio_net.h"
+#include "garnet/lib/machina/virtio_queue_fake.h"
+
+namespace machina {
+namespace {
+
+constexpr uint16_t kVirtioNetQueueSize = 8;
+constexpr size_t kPacketSize = 1514;
+// Number of packets looped in each run.
+constexpr size_t kPacketsPerRun = 64;
+
+class VirtioNetFake : public VirtioNet {
+ public:
+  VirtioNetFake(const PhysMem& phys_mem, async_dispatcher_t* dispatcher)
+      : VirtioNet(phys_mem, dispatcher) {}
+
+  using VirtioNet::InitIoBuffer;
+  using VirtioNet::Ready;
+  using VirtioNet::WaitOnFifos;
+};
+
+// A guest that sends packets on the TX queue of a virtio-net device, and an
+// Ethernet device that loops each of them back to the RX queue.
+class Loopback {
+ public:
+  Loopback()
+      : loop_(&kAsyncLoopConfigNoAttachToThread),
+        net_(phys_mem_, loop_.dispatcher()),
+        rx_queue_(net_.rx_queue(), kVirtioNetQueueSize),
+        tx_queue_(net_.tx_queue(), kVirtioNetQueueSize),
+        rx_bufs_(kVirtioNetQueueSize),
+        tx_bufs_(kVirtioNetQueueSize) {
+    zircon_ethernet_Fifos fifos;
+    ZX_ASSERT(zx_fifo_create(kVirtioNetQueueSize,
+                             sizeof(zircon_ethernet_FifoEntry), 0, &fifos.rx,
+                             &fifo_[0]) == ZX_OK);
+    ZX_ASSERT(zx_fifo_create(kVirtioNetQueueSize,
+                             sizeof(zircon_ethernet_FifoEntry), 0, &fifos.tx,
+                             &fifo_[1]) == ZX_OK);
+    fifos.rx_depth = kVirtioNetQueueSize;
+    fifos.tx_depth = kVirtioNetQueueSize;
+    ZX_ASSERT(net_.InitIoBuffer(kVirtioNetQueueSize * 2, 2048) == ZX_OK);
+    ZX_ASSERT(net_.WaitOnFifos(fifos) == ZX_OK);
+    ZX_ASSERT(net_.Ready(VIRTIO_F_RING_EVENT_IDX) == ZX_OK);
+
+    // Post all RX buffers, and create all TX descriptors without posting them.
+    for (auto& buf : rx_bufs_) {
+      ZX_ASSERT(rx_queue_.BuildDescriptor()
+                    .AppendWritable(&buf, sizeof(buf))
+                    .Build() == ZX_OK);
+    }
+    for (auto& buf : tx_bufs_) {
+      uint16_t desc;
+      ZX_ASSERT(tx_queue_.WriteDescriptor(&buf, sizeof(buf), 0, &desc) ==
+                ZX_OK);
+      tx_free_.push_back(desc);
+    }
+  }
+
+  ~Loopback() {
+    zx_handle_close(fifo_[0]);
+    zx_handle_close(fifo_[1]);
+  }
+
+  // Loops |count| packets from the TX queue to the RX queue.
+  void Run(size_t count) {
+    size_t sent = 0;
+    size_t received = 0;
+    while (received < count) {
+      // The guest sends as many packets as it has free buffers for.
+      bool notify = false;
+      while (!tx_free_.empty() && sent < count) {
+        tx_queue_.WriteToAvail(tx_free_.back());
+        tx_free_.pop_back();
+        sent++;
+        notify = true;
+      }
+      if (notify) {
+        ZX_ASSERT(tx_queue_.queue()->Notify() == ZX_OK);
+      }
+      loop_.RunUntilIdle();
+
+      // The Ethernet device loops each transmitted packet into a receive
+      // buffer, and completes both.
+      size_t n = 0;
+      zx_status_t status = zx_fifo_read(fifo_[0], sizeof(entries_[0]),
+                                        entries_, countof(entries_), &n);
+      ZX_ASSERT(status == ZX_OK || status == ZX_ERR_SHOULD_WAIT);
+      rx_entries_.insert(rx_entries_.end(), entries_, entries_ + n);
+      n = 0;
+      if (!rx_entries_.empty()) {
+        status = zx_fifo_read(fifo_[1], sizeof(entries_[0]), entries_,
+                              std::min(countof(entries_), rx_entries_.size()),
+                              &n);
+        ZX_ASSERT(status == ZX_OK || status == ZX_ERR_SHOULD_WAIT);
+      }
+      if (n > 0) {
+        ZX_ASSERT(zx_fifo_write(fifo_[1], sizeof(entries_[0]), entries_, n,
+                                nullptr) == ZX_OK);
+        for (size_t i = 0; i < n; i++) {
+          rx_entries_[i].length = entries_[i].length;
+        }
+        ZX_ASSERT(zx_fifo_write(fifo_[0], sizeof(entries_[0]),
+                                &rx_entries_[0], n, nullptr) == ZX_OK);
+        rx_entries_.erase(rx_entries_.begin(), rx_entries_.begin() + n);
+      }
+      loop_.RunUntilIdle();
+
+      // The guest reclaims completed buffers, and reposts its RX buffers. It
+      // then asks to be interrupted on the next used buffer of each queue.
+      while (tx_queue_.HasUsed()) {
+        tx_free_.push_back(tx_queue_.NextUsed().id);
+      }
+      notify = false;
+      while (rx_queue_.HasUsed()) {
+        rx_queue_.WriteToAvail(rx_queue_.NextUsed().id);
+        received++;
+        notify = true;
+      }
+      if (notify) {
+        ZX_ASSERT(rx_queue_.queue()->Notify() == ZX_OK);
+      }
+      for (VirtioQueueFake* queue : {&rx_queue_, &tx_queue_}) {
+        *const_cast<uint16_t*>(queue->ring()->used_event) =
+            queue->ring()->used->idx;
+      }
+    }
+  }
+
+ private:
+  struct Buffer {
+    virtio_net_hdr_t hdr;
+    uint8_t data[kPacketSize];
+  } __PACKED;
+
+  async::Loop loop_;
+  PhysMemFake phys_mem_;
+  VirtioNetFake net_;
+  VirtioQueueFake rx_queue_;
+  VirtioQueueFake tx_queue_;
+  std::vector<Buffer> rx_bufs_;
+  std::vector<Buffer> tx_bufs_;
+  std::vector<uint16_t> tx_free_;
+  // Fifo endpoints to simulate ethernet device activity.
+  zx_handle_t fifo_[2];
+  // Receive buffers that the Ethernet device has not yet filled.
+  std::deque<zircon_ethernet_FifoEntry> rx_entries_;
+  zircon_ethernet_FifoEntry entries_[kVirtioNetQueueSize];
+};
+
+// Measures the rate at which packets can be looped from the TX queue, through
+// a fake Ethernet device, and back to the RX queue.
+bool LoopbackTest(perftest::RepeatState* state) {
+  state->SetBytesProcessedPerRun(kPacketsPerRun * kPacketSize);
+
+  Loopback loopback;
+  while (state->KeepRunning()) {
+    loopback.Run(kPacketsPerRun);
+  }
+  return true;
+}
+
+void RegisterTests() {
+  perftest::RegisterTest("Machina/VirtioNet/Loopback", LoopbackTest);
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
+}  // namespace machina
+
+int main(int argc, char** argv) {
+  return perftest::PerfTestMain(argc, argv, "fuchsia.machina_benchmarks");
+}
@@ -143,35 +143,30 @@ zx_status_t VirtioQueue::ReadDesc(uint16_t desc_index, VirtioDescriptor* out) {
 }
 
 zx_status_t VirtioQueue::Return(uint16_t index, uint32_t len, uint8_t actions) {
+  VirtioUsedElem elem = {.index = index, .len = len};
+  return ReturnBatch(&elem, 1, actions);
+}
+
+zx_status_t VirtioQueue::ReturnBatch(const VirtioUsedElem* elems, size_t count,
+                                     uint8_t actions) {
+  if (count == 0) {
+    return ZX_OK;
+  }
+
   bool needs_interrupt = false;
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    volatile struct vring_used_elem* used =
-        &ring_.used->ring[RingIndexLocked(ring_.used->idx)];
-
-    used->id = index;
-    used->len = len;
-    ring_.used->idx++;
-
-    // Virtio 1.0 Section 2.4.7.2: Virtqueue Interrupt Suppression
-    if (!use_event_index_) {
-      // If the VIRTIO_F_EVENT_IDX feature bit is not negotiated:
-      //  - The device MUST ignore the used_event value.
-      //  - After the device writes a descriptor index into the used ring:
-      //    - If flags is 1, the device SHOULD NOT send an interrupt.
-      //    - If flags is 0, the device MUST send an interrupt.
-      needs_interrupt = ring_.used->flags == 0;
-    } else if (ring_.used_event) {
-      // Otherwise, if the VIRTIO_F_EVENT_IDX feature bit is negotiated:
-      //
-      //  - The device MUST ignore the lower bit of flags.
-      //  - After the device writes a descriptor index into the used ring:
-      //    - If the idx field in the used ring (which determined where that
-      //      descriptor index was placed) was equal to used_event, the device
-      //      MUST send an interrupt.
-      //    - Otherwise the device SHOULD NOT send an interrupt.
-      needs_interrupt = ring_.used->idx == (*ring_.used_event + 1);
+    const uint16_t old_idx = ring_.used->idx;
+    for (size_t i = 0; i < count; i++) {
+      volatile struct vring_used_elem* used =
+          &ring_.used->ring[RingIndexLocked(old_idx + i)];
+      used->id = elems[i].index;
+      used->len = elems[i].len;
     }
+
+    // Publish the whole batch to the driver with a single index update.
+    ring_.used->idx = static_cast<uint16_t>(old_idx + count);
+    needs_interrupt = NeedsInterruptLocked(old_idx);
   }
 
   if (needs_interrupt) {
@@ -180,6 +175,36 @@ zx_status_t VirtioQueue::Return(uint16_t index, uint32_t len, uint8_t actions) {
   return ZX_OK;
 }
 
+bool VirtioQueue::NeedsInterruptLocked(uint16_t old_idx) const {
+  // Virtio 1.0 Section 2.4.7.2: Virtqueue Interrupt Suppression
+  if (!use_event_index_) {
+    // If the VIRTIO_F_EVENT_IDX feature bit is not negotiated:
+    //  - The device MUST ignore the used_event value.
+    //  - After the device writes a descriptor index into the used ring:
+    //    - If flags is 1, the device SHOULD NOT send an interrupt.
+    //    - If flags is 0, the device MUST send an interrupt.
+    return ring_.used->flags == 0;
+  }
+  if (ring_.used_event == nullptr) {
+    return false;
+  }
+  // Otherwise, if the VIRTIO_F_EVENT_IDX feature bit is negotiated:
+  //
+  //  - The device MUST ignore the lower bit of flags.
+  //  - After the device writes a descriptor index into the used ring:
+  //    - If the idx field in the used ring (which determined where that
+  //      descriptor index was placed) was equal to used_event, the device
+  //      MUST send an interrupt.
+  //    - Otherwise the device SHOULD NOT send an interrupt.
+  //
+  // When several descriptors are returned at once, we interrupt if used_event
+  // was passed by any of them. All arithmetic is modulo 2^16.
+  const uint16_t new_idx = ring_.used->idx;
+  const uint16_t used_event = *ring_.used_event;
+  return static_cast<uint16_t>(new_idx - used_event - 1) <
+         static_cast<uint16_t>(new_idx - old_idx);
+}
+
 VirtioChain::VirtioChain(VirtioQueue* queue, uint16_t head)
     : queue_(queue), head_(head), next_(head), has_next_(true) {}
 
@@ -55,6 +55,14 @@ struct VirtioDescriptor {
   bool writable;
 };
 
+// A descriptor chain to be returned to the used ring as part of a batch.
+struct VirtioUsedElem {
+  // Index of the head descriptor of the chain.
+  uint16_t index;
+  // Number of bytes written to the chain.
+  uint32_t len;
+};
+
 class VirtioQueue {
  public:
   // The signal asserted when there are available descriptors in the queue.
@@ -149,6 +157,15 @@ class VirtioQueue {
   zx_status_t Return(uint16_t index, uint32_t len,
                      uint8_t actions = SET_QUEUE | TRY_INTERRUPT);
 
+  // Return a batch of descriptors to the used ring.
+  //
+  // All elements of |elems| are written to the used ring before the used index
+  // is published, and at most one interrupt is sent for the whole batch. If
+  // |VIRTIO_F_EVENT_IDX| has been negotiated, the interrupt is only sent if
+  // the driver's used_event falls within the batch.
+  zx_status_t ReturnBatch(const VirtioUsedElem* elems, size_t count,
+                          uint8_t actions = SET_QUEUE | TRY_INTERRUPT);
+
   // Reads a single descriptor from the queue.
   //
   // This method should only be called using descriptor indices acquired with
@@ -183,6 +200,10 @@ class VirtioQueue {
   zx_status_t NextAvailLocked(uint16_t* index) __TA_REQUIRES(mutex_);
   bool HasAvailLocked() const __TA_REQUIRES(mutex_);
 
+  // Returns whether the driver should be interrupted after the used index has
+  // been advanced from |old_idx|.
+  bool NeedsInterruptLocked(uint16_t old_idx) const __TA_REQUIRES(mutex_);
+
   // Returns a circular index into a Virtio ring.
   uint32_t RingIndexLocked(uint32_t index) const __TA_REQUIRES(mutex_);
 
@@ -6,12 +6,14 @@
 
 #include <fcntl.h>
 #include <string.h>
+#include <algorithm>
 #include <atomic>
 
 #include <fbl/unique_fd.h>
 #include <lib/fdio/util.h>
 #include <trace-engine/types.h>
 #include <trace/event.h>
+#include <virtio/virtio.h>
 #include <zircon/ethernet/c/fidl.h>
 #include <zx/fifo.h>
 
@@ -21,6 +23,40 @@ namespace machina {
 
 constexpr size_t kMaxPacketSize = 2048;
 
+// Features we support in addition to the MAC address.
+//
+// VIRTIO_NET_F_MRG_RXBUF lets the driver post single-buffer receive chains
+// that are sized independently of the header. Each packet we receive always
+// fits in one such buffer, as it is posted to the Ethernet device with its own
+// length.
+//
+// VIRTIO_NET_F_CSUM allows the driver to hand us packets with a partial
+// checksum, which we complete while copying them into the IO buffer.
+//
+// VIRTIO_F_RING_EVENT_IDX allows us to suppress notifications and interrupts
+// while processing descriptors in batches.
+//
+// TODO(abdulla): Support VIRTIO_NET_F_STATUS via GetStatus.
+constexpr uint32_t kVirtioNetFeatures =
+    VIRTIO_NET_F_MAC | VIRTIO_NET_F_MRG_RXBUF | VIRTIO_NET_F_CSUM |
+    VIRTIO_F_RING_EVENT_IDX;
+
+// Computes the one's complement sum of |len| bytes at |data|, as used by the
+// Internet checksum (RFC 1071).
+static uint16_t InternetChecksum(const uint8_t* data, size_t len) {
+  uint32_t sum = 0;
+  for (; len > 1; data += 2, len -= 2) {
+    sum += static_cast<uint32_t>(data[0]) << 8 | data[1];
+  }
+  if (len > 0) {
+    sum += static_cast<uint32_t>(data[0]) << 8;
+  }
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return static_cast<uint16_t>(~sum);
+}
+
 VirtioNet::Stream::Stream(const PhysMem& phys_mem,
                           async_dispatcher_t* dispatcher, VirtioQueue* queue,
                           std::atomic<trace_async_id_t>* trace_flow_id,
@@ -38,6 +74,7 @@ zx_status_t VirtioNet::Stream::Start(zx_handle_t fifo, size_t fifo_max_entries,
   fifo_ = fifo;
   rx_ = rx;
   fifo_entries_.resize(fifo_max_entries);
+  used_elems_.reserve(fifo_max_entries);
   fifo_num_entries_ = 0;
   fifo_entries_write_index_ = 0;
 
@@ -117,7 +154,12 @@ void VirtioNet::Stream::OnQueueReady(zx_status_t status, uint16_t index) {
       return;
     }
 
-    if (packet_length > kMaxPacketSize) {
+    if (rx_) {
+      // Receive buffers may be larger than any packet we will deliver, in
+      // particular when VIRTIO_NET_F_MRG_RXBUF is negotiated. Only offer the
+      // Ethernet device as much as fits in an IO buffer.
+      packet_length = std::min<uintptr_t>(packet_length, kMaxPacketSize);
+    } else if (packet_length > kMaxPacketSize) {
       FXL_LOG(ERROR) << "Packet may not be longer than " << kMaxPacketSize;
       return;
     }
@@ -133,7 +175,8 @@ void VirtioNet::Stream::OnQueueReady(zx_status_t status, uint16_t index) {
       // Section 5.1.6.4.1 Device Requirements: Processing of Incoming Packets
 
       // If VIRTIO_NET_F_MRG_RXBUF has not been negotiated, the device MUST
-      // set num_buffers to 1.
+      // set num_buffers to 1. If it has, we still only ever use one buffer per
+      // packet, as the buffer we post to the Ethernet device is sized to fit.
       header->num_buffers = 1;
 
       // If none of the VIRTIO_NET_F_GUEST_TSO4, TSO6 or UFO options have been
@@ -145,12 +188,18 @@ void VirtioNet::Stream::OnQueueReady(zx_status_t status, uint16_t index) {
       // driver.
       header->flags = 0;
     } else {
-      status =
-          io_buf_->vmo().write(phys_mem_.as<void>(packet_offset, packet_length),
-                               io_offset, packet_length);
-      if (status != ZX_OK) {
-        FXL_LOG(ERROR) << "Failed to write to Ethernet VMO";
-        return;
+      uint8_t* dest = io_buf_->data(io_offset);
+      memcpy(dest, phys_mem_.as<void>(packet_offset, packet_length),
+             packet_length);
+      if ((features_.load() & VIRTIO_NET_F_CSUM) &&
+          (header->flags & VIRTIO_NET_HDR_F_NEEDS_CSUM)) {
+        status = CompleteChecksum(header, packet_length, dest);
+        if (status != ZX_OK) {
+          // Drop the malformed packet, but keep processing the queue.
+          io_buf_->Free(io_offset);
+          queue_->Return(index, 0);
+          continue;
+        }
       }
     }
 
@@ -164,12 +213,45 @@ void VirtioNet::Stream::OnQueueReady(zx_status_t status, uint16_t index) {
   } while (fifo_num_entries_ < fifo_entries_.size() &&
            queue_->NextAvail(&index) == ZX_OK);
 
+  if (fifo_num_entries_ == 0) {
+    status = WaitOnQueue();
+    if (status != ZX_OK) {
+      FXL_LOG(INFO) << "Failed to wait on queue: " << status;
+    }
+    return;
+  }
   status = WaitOnFifoWritable();
   if (status != ZX_OK) {
     FXL_LOG(INFO) << "Failed to wait on fifo writable: " << status;
   }
 }
 
+zx_status_t VirtioNet::Stream::CompleteChecksum(const virtio_net_hdr_t* header,
+                                                uintptr_t packet_length,
+                                                uint8_t* dest) {
+  // Section 5.1.6.2: Packet Transmission
+  //
+  // If flags has VIRTIO_NET_HDR_F_NEEDS_CSUM set, the checksum must be
+  // computed over the packet from csum_start to the end of the packet, and
+  // stored at offset csum_offset from csum_start. The driver has already
+  // stored the pseudo-header checksum in that location.
+  const size_t csum_start = header->csum_start;
+  const size_t csum_pos = csum_start + header->csum_offset;
+  if (csum_start >= packet_length ||
+      csum_pos + sizeof(uint16_t) > packet_length) {
+    FXL_LOG(ERROR) << "Packet checksum is outside of the packet";
+    return ZX_ERR_OUT_OF_RANGE;
+  }
+
+  // We sum our own copy of the packet, as the guest may change its buffer
+  // underneath us.
+  const uint16_t csum =
+      InternetChecksum(dest + csum_start, packet_length - csum_start);
+  dest[csum_pos] = static_cast<uint8_t>(csum >> 8);
+  dest[csum_pos + 1] = static_cast<uint8_t>(csum);
+  return ZX_OK;
+}
+
 zx_status_t VirtioNet::Stream::WaitOnFifoWritable() {
   return fifo_writable_wait_.Begin(dispatcher_);
 }
@@ -252,8 +334,9 @@ void VirtioNet::Stream::OnFifoReadable(async_dispatcher_t* dispatcher,
     return;
   }
 
+  used_elems_.clear();
   for (size_t i = 0; i < num_entries_read; i++) {
-    auto head = reinterpret_cast<uintptr_t>(entries[i].cookie);
+    auto head = static_cast<uint16_t>(entries[i].cookie);
     auto io_offset = entries[i].offset;
     if (rx_) {
       // Reread the original descriptor so we can perform the copy. A malicious
@@ -262,28 +345,38 @@ void VirtioNet::Stream::OnFifoReadable(async_dispatcher_t* dispatcher,
       uintptr_t packet_offset;
       uintptr_t packet_length;
       if (ReadPacketInfo(head, &packet_offset, &packet_length) == nullptr) {
-        return;
+        break;
       }
       // entries[i].length is the actual size of the packet received by the
       // ethdriver and to minimize copying we use this in preference to
       // packet_length. As packet_length was what we originally gave as our
-      // buffer size to the Ethernet FIFO we are guaranteed that
-      // entries[i].length <= packet_length.
-      status = io_buf_->vmo().read(
-          phys_mem_.as<void>(packet_offset, entries[i].length), io_offset,
-          entries[i].length);
-      if (status != ZX_OK) {
-        FXL_LOG(ERROR) << "Failed to read from Ethernet VMO";
-        return;
+      // buffer size to the Ethernet FIFO, entries[i].length <= packet_length
+      // unless the guest has since shrunk the buffer.
+      if (entries[i].length > packet_length ||
+          entries[i].length > io_buf_->elem_size()) {
+        FXL_LOG(ERROR) << "Received packet does not fit in the buffer";
+        break;
       }
+      memcpy(phys_mem_.as<void>(packet_offset, entries[i].length),
+             io_buf_->data(io_offset), entries[i].length);
     }
     io_buf_->Free(io_offset);
-    auto length = entries[i].length + sizeof(virtio_net_hdr_t);
-    status = queue_->Return(head, length);
-    if (status != ZX_OK) {
-      FXL_LOG(ERROR) << "Failed to return descriptor to the queue " << status;
-      return;
-    }
+    used_elems_.push_back({
+        .index = head,
+        .len = static_cast<uint32_t>(entries[i].length +
+                                     sizeof(virtio_net_hdr_t)),
+    });
+  }
+
+  // Return all completed descriptors with a single update of the used ring,
+  // and at most one interrupt.
+  status = queue_->ReturnBatch(used_elems_.data(), used_elems_.size());
+  if (status != ZX_OK) {
+    FXL_LOG(ERROR) << "Failed to return descriptors to the queue " << status;
+    return;
+  }
+  if (used_elems_.size() != num_entries_read) {
+    return;
   }
 
   status = wait->Begin(dispatcher);
@@ -299,6 +392,11 @@ zx_status_t VirtioNet::IoBuffer::Init(size_t count, size_t elem_size) {
     FXL_LOG(ERROR) << "Failed to create VMO for buffer";
     return status;
   }
+  status = mapper_.Map(vmo_, 0, vmo_size, ZX_VM_PERM_READ | ZX_VM_PERM_WRITE);
+  if (status != ZX_OK) {
+    FXL_LOG(ERROR) << "Failed to map VMO for buffer";
+    return status;
+  }
 
   elem_size_ = elem_size;
 
@@ -327,8 +425,8 @@ void VirtioNet::IoBuffer::Free(uintptr_t offset) {
 }
 
 VirtioNet::VirtioNet(const PhysMem& phys_mem, async_dispatcher_t* dispatcher)
-    // TODO(abdulla): Support VIRTIO_NET_F_STATUS via GetStatus.
-    : VirtioInprocessDevice(phys_mem, VIRTIO_NET_F_MAC),
+    : VirtioInprocessDevice(phys_mem, kVirtioNetFeatures, noop_config_device,
+                            fit::bind_member(this, &VirtioNet::Ready)),
       rx_stream_(phys_mem, dispatcher, rx_queue(), rx_trace_flow_id(),
                  &io_buf_),
       tx_stream_(phys_mem, dispatcher, tx_queue(), tx_trace_flow_id(),
@@ -342,6 +440,15 @@ VirtioNet::~VirtioNet() {
   zx_handle_close(fifos_.rx);
 }
 
+zx_status_t VirtioNet::Ready(uint32_t negotiated_features) {
+  const bool use_event_index = negotiated_features & VIRTIO_F_RING_EVENT_IDX;
+  rx_queue()->set_use_event_index(use_event_index);
+  tx_queue()->set_use_event_index(use_event_index);
+  rx_stream_.set_features(negotiated_features);
+  tx_stream_.set_features(negotiated_features);
+  return ZX_OK;
+}
+
 zx_status_t VirtioNet::InitIoBuffer(size_t count, size_t elem_size) {
   return io_buf_.Init(count, elem_size);
 }
@@ -10,6 +10,7 @@
 
 #include <fbl/unique_fd.h>
 #include <lib/async/cpp/wait.h>
+#include <lib/fzl/vmo-mapper.h>
 #include <lib/zx/channel.h>
 #include <trace-engine/types.h>
 #include <virtio/net.h>
@@ -49,7 +50,10 @@ class VirtioNet
   // the ethdriver. This is protected to allow for a mock VirtioNet to be easily
   // constructed for testing without needing a fully mocked ethernet driver.
   zx_status_t InitIoBuffer(size_t count, size_t elem_size);
+  const zx::vmo& io_buffer_vmo() { return io_buf_.vmo(); }
   zx_status_t WaitOnFifos(const zircon_ethernet_Fifos& fifos);
+  // Invoked once the driver has completed feature negotiation.
+  zx_status_t Ready(uint32_t negotiated_features);
 
  private:
   // Ethernet control plane.
@@ -70,6 +74,13 @@ class VirtioNet
 
     zx::vmo& vmo() { return vmo_; }
 
+    // Returns a pointer to the buffer at |offset| within our mapping of the
+    // VMO, so that packets can be copied without a syscall per packet.
+    uint8_t* data(uintptr_t offset) {
+      return static_cast<uint8_t*>(mapper_.start()) + offset;
+    }
+    size_t elem_size() const { return elem_size_; }
+
     zx_status_t Init(size_t count, size_t elem_size);
     zx_status_t Allocate(uintptr_t* offset);
     void Free(uintptr_t offset);
@@ -78,6 +89,7 @@ class VirtioNet
     std::vector<uint16_t> free_list_;
     size_t elem_size_;
     zx::vmo vmo_;
+    fzl::VmoMapper mapper_;
   };
 
   // A single data stream (either RX or TX).
@@ -88,6 +100,9 @@ class VirtioNet
            IoBuffer* iobufs);
     zx_status_t Start(zx_handle_t fifo, size_t fifo_num_entries, bool rx);
 
+    // Updates the set of features negotiated with the driver.
+    void set_features(uint32_t features) { features_.store(features); }
+
    private:
     // Move buffers from VirtioQueue -> FIFO.
     zx_status_t WaitOnQueue();
@@ -104,6 +119,11 @@ class VirtioNet
     virtio_net_hdr_t* ReadPacketInfo(uint16_t index, uintptr_t* offset,
                                      uintptr_t* length);
 
+    // Completes a checksum that the driver has left partially computed, as
+    // allowed by VIRTIO_NET_F_CSUM.
+    zx_status_t CompleteChecksum(const virtio_net_hdr_t* header,
+                                 uintptr_t packet_length, uint8_t* dest);
+
     const PhysMem& phys_mem_;
     async_dispatcher_t* dispatcher_;
     VirtioQueue* queue_;
@@ -111,6 +131,8 @@ class VirtioNet
     zx_handle_t fifo_ = ZX_HANDLE_INVALID;
     bool rx_ = false;
     IoBuffer* io_buf_;
+    // Features negotiated with the driver, set once the device is ready.
+    std::atomic<uint32_t> features_{0};
 
     std::vector<zircon_ethernet_FifoEntry> fifo_entries_;
     // Number of entries in |fifo_entries_| that have not yet been written
@@ -121,6 +143,10 @@ class VirtioNet
     // to be written.
     size_t fifo_entries_write_index_ = 0;
 
+    // Descriptors completed by the Ethernet device, returned to the queue in
+    // a single batch for each read from the fifo.
+    std::vector<VirtioUsedElem> used_elems_;
+
     VirtioQueueWaiter queue_wait_;
     async::WaitMethod<Stream, &Stream::OnFifoWritable> fifo_writable_wait_{
         this};
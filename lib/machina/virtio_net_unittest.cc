@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <virtio/virtio.h>
 #include <zircon/ethernet/c/fidl.h>
 
 #include "garnet/lib/machina/phys_mem_fake.h"
@@ -19,6 +20,9 @@ class VirtioNetFake : public VirtioNet {
   VirtioNetFake(const PhysMem& phys_mem, async_dispatcher_t* dispatcher)
       : VirtioNet(phys_mem, dispatcher) {}
 
+  using VirtioNet::io_buffer_vmo;
+  using VirtioNet::Ready;
+
   void SetUp(const zircon_ethernet_Fifos& fifos) {
     ASSERT_EQ(InitIoBuffer(kVirtioNetQueueSize * 2, 2048), ZX_OK);
     ASSERT_EQ(WaitOnFifos(fifos), ZX_OK);
@@ -29,7 +33,8 @@ class VirtioNetTest : public ::gtest::TestLoopFixture {
  public:
   VirtioNetTest()
       : net_(phys_mem_, dispatcher()),
-        queue_(net_.rx_queue(), kVirtioNetQueueSize) {}
+        queue_(net_.rx_queue(), kVirtioNetQueueSize),
+        tx_queue_(net_.tx_queue(), kVirtioNetQueueSize) {}
 
   void SetUp() override {
     ASSERT_EQ(zx_fifo_create(kVirtioNetQueueSize, sizeof(zircon_ethernet_FifoEntry), 0,
@@ -47,6 +52,7 @@ class VirtioNetTest : public ::gtest::TestLoopFixture {
   PhysMemFake phys_mem_;
   VirtioNetFake net_;
   VirtioQueueFake queue_;
+  VirtioQueueFake tx_queue_;
   // Fifo endpoints to provide to the net device.
   zircon_ethernet_Fifos fifos_;
   // Fifo endpoints to simulate ethernet device activity.
@@ -133,5 +139,43 @@ TEST_F(VirtioNetTest, PeerClosed) {
   RunLoopUntilIdle();
 }
 
+TEST_F(VirtioNetTest, CompletesTxChecksum) {
+  ASSERT_EQ(net_.Ready(VIRTIO_NET_F_CSUM), ZX_OK);
+
+  struct {
+    virtio_net_hdr_t hdr;
+    uint8_t data[8];
+  } __PACKED packet = {
+      .hdr =
+          {
+              .flags = VIRTIO_NET_HDR_F_NEEDS_CSUM,
+              .csum_start = 2,
+              .csum_offset = 4,
+          },
+      .data = {0x00, 0x00, 0x12, 0x34, 0x56, 0x78, 0x00, 0x00},
+  };
+  ASSERT_EQ(
+      tx_queue_.BuildDescriptor().AppendReadable(&packet, sizeof(packet)).Build(),
+      ZX_OK);
+  RunLoopUntilIdle();
+
+  size_t count;
+  zircon_ethernet_FifoEntry entry[fifos_.tx_depth];
+  ASSERT_EQ(ZX_OK, zx_fifo_read(fifo_[1], sizeof(entry[0]), entry,
+                                countof(entry), &count));
+  ASSERT_EQ(1u, count);
+  ASSERT_EQ(sizeof(packet.data), entry[0].length);
+
+  // The checksum over bytes [2, 8) is stored at byte 6, and the guest buffer
+  // is left untouched.
+  uint8_t data[sizeof(packet.data)];
+  ASSERT_EQ(ZX_OK,
+            net_.io_buffer_vmo().read(data, entry[0].offset, sizeof(data)));
+  EXPECT_EQ(0x97, data[6]);
+  EXPECT_EQ(0x53, data[7]);
+  EXPECT_EQ(0x00, packet.data[6]);
+  EXPECT_EQ(0x00, packet.data[7]);
+}
+
 }  // namespace
 }  // namespace machina
@@ -36,5 +36,40 @@ TEST(VirtioQueueTest, HandleOverflow) {
   ASSERT_EQ(queue_fake->ring()->index, 0);
 }
 
+TEST(VirtioQueueTest, ReturnBatchEventIndex) {
+  VirtioDeviceFake device;
+  VirtioQueue* queue = device.queue();
+  VirtioQueueFake* queue_fake = device.queue_fake();
+  queue->set_use_event_index(true);
+
+  size_t interrupts = 0;
+  queue->set_interrupt([&interrupts](uint8_t actions) {
+    interrupts++;
+    return ZX_OK;
+  });
+
+  // Ask to be interrupted once the used ring reaches the third descriptor.
+  VirtioRing* ring = queue_fake->ring();
+  *const_cast<uint16_t*>(ring->used_event) = 2;
+
+  const VirtioUsedElem first[] = {{.index = 0, .len = 1}, {.index = 1, .len = 2}};
+  ASSERT_EQ(queue->ReturnBatch(first, countof(first)), ZX_OK);
+  EXPECT_EQ(ring->used->idx, 2u);
+  EXPECT_EQ(interrupts, 0u);
+
+  const VirtioUsedElem second[] = {{.index = 2, .len = 3}, {.index = 3, .len = 4}};
+  ASSERT_EQ(queue->ReturnBatch(second, countof(second)), ZX_OK);
+  EXPECT_EQ(ring->used->idx, 4u);
+  EXPECT_EQ(interrupts, 1u);
+
+  for (uint32_t i = 0; i < 4; i++) {
+    ASSERT_TRUE(queue_fake->HasUsed());
+    struct vring_used_elem elem = queue_fake->NextUsed();
+    EXPECT_EQ(elem.id, i);
+    EXPECT_EQ(elem.len, i + 1);
+  }
+  EXPECT_FALSE(queue_fake->HasUsed());
+}
+
 }  // namespace
 }  // namespace machina
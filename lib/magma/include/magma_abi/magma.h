@@ -37,6 +37,11 @@ magma_status_t magma_get_error(struct magma_connection_t* connection);
 // A context is required to submit command buffers.
 void magma_create_context(struct magma_connection_t* connection, uint32_t* context_id_out);
 
+// Creates a context as above, scheduled at the given |priority| (one of MAGMA_CONTEXT_PRIORITY_*).
+// magma_create_context is equivalent to passing MAGMA_CONTEXT_PRIORITY_MEDIUM.
+void magma_create_context_with_priority(struct magma_connection_t* connection, uint32_t priority,
+                                        uint32_t* context_id_out);
+
 // Releases the context associated with |context_id|.
 void magma_release_context(struct magma_connection_t* connection, uint32_t context_id);
 
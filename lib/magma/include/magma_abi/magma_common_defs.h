@@ -34,6 +34,12 @@ extern "C" {
 #define MAGMA_CACHE_POLICY_WRITE_COMBINING 1
 #define MAGMA_CACHE_POLICY_UNCACHED 2
 
+// possible values for the priority of a context; these match VkQueueGlobalPriorityEXT
+#define MAGMA_CONTEXT_PRIORITY_LOW 128
+#define MAGMA_CONTEXT_PRIORITY_MEDIUM 256
+#define MAGMA_CONTEXT_PRIORITY_HIGH 512
+#define MAGMA_CONTEXT_PRIORITY_REALTIME 1024
+
 #define MAGMA_DUMP_TYPE_NORMAL (1 << 0)
 // Dump current perf counters and disable them
 #define MAGMA_DUMP_TYPE_PERF_COUNTERS (1 << 1)
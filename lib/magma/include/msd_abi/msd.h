@@ -56,8 +56,10 @@ void msd_connection_set_notification_callback(struct msd_connection_t* connectio
                                               msd_connection_notification_callback_t callback,
                                               void* token);
 
-// Creates a context for the given connection. returns null on failure.
-struct msd_context_t* msd_connection_create_context(struct msd_connection_t* connection);
+// Creates a context for the given connection at the given MAGMA_CONTEXT_PRIORITY_*.
+// returns null on failure.
+struct msd_context_t* msd_connection_create_context(struct msd_connection_t* connection,
+                                                    uint32_t priority);
 
 // Destroys the given context.
 void msd_context_destroy(struct msd_context_t* ctx);
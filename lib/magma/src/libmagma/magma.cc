@@ -50,7 +50,13 @@ magma_status_t magma_query(int fd, uint64_t id, uint64_t* value_out)
 
 void magma_create_context(magma_connection_t* connection, uint32_t* context_id_out)
 {
-    magma::PlatformIpcConnection::cast(connection)->CreateContext(context_id_out);
+    magma_create_context_with_priority(connection, MAGMA_CONTEXT_PRIORITY_MEDIUM, context_id_out);
+}
+
+void magma_create_context_with_priority(magma_connection_t* connection, uint32_t priority,
+                                        uint32_t* context_id_out)
+{
+    magma::PlatformIpcConnection::cast(connection)->CreateContext(priority, context_id_out);
 }
 
 void magma_release_context(magma_connection_t* connection, uint32_t context_id)
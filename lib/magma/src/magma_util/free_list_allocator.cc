@@ -0,0 +1,178 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "free_list_allocator.h"
+#include "magma_util/dlog.h"
+#include "magma_util/macros.h"
+#include <iterator>
+#include <limits.h> // PAGE_SIZE
+
+#if PAGE_SIZE == 4096
+#define PAGE_SIZE_POW2 12
+#else
+#error Must define PAGE_SIZE_POW2
+#endif
+
+namespace magma {
+
+// When no region of the exact best-fit size can be aligned, at most this many of the smallest
+// candidate regions are tried before falling back to a region large enough for any alignment.
+// Without such a region, the remaining candidates are tried in turn.
+static constexpr uint32_t kMaxAlignmentProbes = 16;
+
+std::unique_ptr<FreeListAllocator> FreeListAllocator::Create(uint64_t base, size_t size)
+{
+    return std::unique_ptr<FreeListAllocator>(new FreeListAllocator(base, size));
+}
+
+FreeListAllocator::FreeListAllocator(uint64_t base, size_t size)
+    : AddressSpaceAllocator(base, size)
+{
+    InsertFreeRegion(base, size);
+}
+
+bool FreeListAllocator::Alloc(size_t size, uint8_t align_pow2, uint64_t* addr_out)
+{
+    DLOG("Alloc size 0x%zx align_pow2 0x%x", size, align_pow2);
+    DASSERT(addr_out);
+
+    if (size == 0)
+        return DRETF(false, "can't allocate size zero");
+
+    if (size > this->size())
+        return DRETF(false, "size 0x%zx exceeds address space", size);
+
+    size = magma::round_up(size, PAGE_SIZE);
+    DASSERT(magma::is_page_aligned(size));
+
+    if (align_pow2 < PAGE_SIZE_POW2)
+        align_pow2 = PAGE_SIZE_POW2;
+    if (align_pow2 >= 64)
+        return DRETF(false, "invalid alignment");
+
+    const uint64_t align = 1ULL << align_pow2;
+
+    // A free region this large can hold the allocation regardless of where it starts.
+    const uint64_t any_fit_size =
+        size <= UINT64_MAX - (align - 1) ? size + align - 1 : UINT64_MAX;
+
+    auto iter = free_by_size_.lower_bound(FreeRegionKey(size, 0));
+    uint32_t probes = 0;
+    while (iter != free_by_size_.end()) {
+        uint64_t region_size = iter->first;
+        uint64_t region_addr = iter->second;
+
+        uint64_t addr = (region_addr + align - 1) & ~(align - 1);
+        if (addr >= region_addr && addr - region_addr <= region_size - size) {
+            RemoveFreeRegion(free_by_addr_.find(region_addr));
+
+            if (addr > region_addr)
+                InsertFreeRegion(region_addr, addr - region_addr);
+
+            uint64_t region_end = region_addr + region_size;
+            if (addr + size < region_end)
+                InsertFreeRegion(addr + size, region_end - (addr + size));
+
+            allocations_.emplace(addr, size);
+
+            DLOG("allocated addr 0x%lx", addr);
+            *addr_out = addr;
+            return true;
+        }
+
+        ++iter;
+        if (++probes == kMaxAlignmentProbes && region_size < any_fit_size) {
+            auto any_fit = free_by_size_.lower_bound(FreeRegionKey(any_fit_size, 0));
+            if (any_fit != free_by_size_.end())
+                iter = any_fit;
+        }
+    }
+
+    return DRETF(false, "failed to alloc");
+}
+
+bool FreeListAllocator::Free(uint64_t addr)
+{
+    DLOG("Free addr 0x%lx", addr);
+
+    auto iter = FindAllocation(addr);
+    if (iter == allocations_.end())
+        return DRETF(false, "couldn't find region to free");
+
+    uint64_t start = iter->first;
+    uint64_t size = iter->second;
+    allocations_.erase(iter);
+
+    // Coalesce with the adjacent free regions.
+    auto next = free_by_addr_.lower_bound(start);
+    if (next != free_by_addr_.end() && next->first == start + size) {
+        size += next->second;
+        next = RemoveFreeRegion(next);
+    }
+
+    if (next != free_by_addr_.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == start) {
+            start = prev->first;
+            size += prev->second;
+            RemoveFreeRegion(prev);
+        }
+    }
+
+    InsertFreeRegion(start, size);
+
+    return true;
+}
+
+bool FreeListAllocator::GetSize(uint64_t addr, size_t* size_out)
+{
+    auto iter = FindAllocation(addr);
+    if (iter == allocations_.end())
+        return DRETF(false, "couldn't find region");
+
+    *size_out = iter->second;
+    return true;
+}
+
+FreeListAllocator::Stats FreeListAllocator::GetStats() const
+{
+    Stats stats;
+    stats.allocation_count = allocations_.size();
+    stats.free_region_count = free_by_addr_.size();
+    stats.free_bytes = free_bytes_;
+    stats.largest_free_region = free_by_size_.empty() ? 0 : free_by_size_.rbegin()->first;
+    return stats;
+}
+
+std::map<uint64_t, uint64_t>::iterator FreeListAllocator::FindAllocation(uint64_t addr)
+{
+    auto iter = allocations_.upper_bound(addr);
+    if (iter == allocations_.begin())
+        return allocations_.end();
+
+    --iter;
+    if (addr - iter->first >= iter->second)
+        return allocations_.end();
+
+    return iter;
+}
+
+void FreeListAllocator::InsertFreeRegion(uint64_t addr, uint64_t size)
+{
+    DASSERT(size > 0);
+    free_by_addr_.emplace(addr, size);
+    free_by_size_.emplace(size, addr);
+    free_bytes_ += size;
+}
+
+std::map<uint64_t, uint64_t>::iterator
+FreeListAllocator::RemoveFreeRegion(std::map<uint64_t, uint64_t>::iterator iter)
+{
+    DASSERT(iter != free_by_addr_.end());
+    free_by_size_.erase(FreeRegionKey(iter->second, iter->first));
+    free_bytes_ -= iter->second;
+    return free_by_addr_.erase(iter);
+}
+
+} // namespace magma
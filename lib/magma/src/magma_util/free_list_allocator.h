@@ -0,0 +1,72 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FREE_LIST_ALLOCATOR_H
+#define FREE_LIST_ALLOCATOR_H
+
+#include "address_space_allocator.h"
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+
+namespace magma {
+
+// An allocator that tracks the free regions of the address space in two trees, one ordered by
+// address and one ordered by size, so allocating and freeing take O(log n) time in the number of
+// regions. Allocations are placed in the smallest free region that can hold them once aligned,
+// preferring lower addresses among regions of the same size.
+class FreeListAllocator final : public AddressSpaceAllocator {
+public:
+    struct Stats {
+        size_t allocation_count;
+        size_t free_region_count;
+        uint64_t free_bytes;
+        uint64_t largest_free_region;
+
+        // Returns the fraction of free space that lies outside the largest free region, from 0
+        // (unfragmented) towards 1.
+        double fragmentation() const
+        {
+            return free_bytes == 0 ? 0.0
+                                   : 1.0 - static_cast<double>(largest_free_region) / free_bytes;
+        }
+    };
+
+    static std::unique_ptr<FreeListAllocator> Create(uint64_t base, size_t size);
+
+    bool Alloc(size_t size, uint8_t align_pow2, uint64_t* addr_out) override;
+    bool Free(uint64_t addr) override;
+    bool GetSize(uint64_t addr, size_t* size_out) override;
+
+    Stats GetStats() const;
+
+private:
+    FreeListAllocator(uint64_t base, size_t size);
+
+    // Returns the allocation containing the given address, or allocations_.end().
+    std::map<uint64_t, uint64_t>::iterator FindAllocation(uint64_t addr);
+
+    void InsertFreeRegion(uint64_t addr, uint64_t size);
+    // Returns the free region following the removed one.
+    std::map<uint64_t, uint64_t>::iterator
+    RemoveFreeRegion(std::map<uint64_t, uint64_t>::iterator iter);
+
+    // Orders free regions by size, then by address.
+    using FreeRegionKey = std::pair<uint64_t, uint64_t>;
+
+    // Allocated regions, from address to size.
+    std::map<uint64_t, uint64_t> allocations_;
+    // Free regions, from address to size.
+    std::map<uint64_t, uint64_t> free_by_addr_;
+    // Free regions as (size, address) pairs.
+    std::set<FreeRegionKey> free_by_size_;
+    uint64_t free_bytes_ = 0;
+
+    DISALLOW_COPY_AND_ASSIGN(FreeListAllocator);
+};
+
+} // namespace magma
+
+#endif // FREE_LIST_ALLOCATOR_H
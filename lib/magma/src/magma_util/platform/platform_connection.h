@@ -43,8 +43,8 @@ public:
     // Releases the connection's reference to the given object.
     virtual magma_status_t ReleaseObject(uint64_t object_id, PlatformObject::Type object_type) = 0;
 
-    // Creates a context and returns the context id
-    virtual void CreateContext(uint32_t* context_id_out) = 0;
+    // Creates a context with the given MAGMA_CONTEXT_PRIORITY_* and returns the context id
+    virtual void CreateContext(uint32_t priority, uint32_t* context_id_out) = 0;
     // Destroys a context for the given id
     virtual void DestroyContext(uint32_t context_id) = 0;
 
@@ -91,7 +91,7 @@ public:
         virtual bool ImportObject(uint32_t handle, PlatformObject::Type object_type) = 0;
         virtual bool ReleaseObject(uint64_t object_id, PlatformObject::Type object_type) = 0;
 
-        virtual bool CreateContext(uint32_t context_id) = 0;
+        virtual bool CreateContext(uint32_t context_id, uint32_t priority) = 0;
         virtual bool DestroyContext(uint32_t context_id) = 0;
 
         virtual magma::Status ExecuteCommandBuffer(uint32_t command_buffer_handle,
@@ -338,7 +338,7 @@ private:
         DLOG("Operation: CreateContext");
         if (!op)
             return DRETF(false, "malformed message");
-        if (!delegate_->CreateContext(op->context_id))
+        if (!delegate_->CreateContext(op->context_id, op->priority))
             SetError(MAGMA_STATUS_INTERNAL_ERROR);
         return true;
     }
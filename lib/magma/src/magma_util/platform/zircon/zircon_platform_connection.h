@@ -54,6 +54,7 @@ struct CreateContextOp {
     const OpCode opcode = CreateContext;
     static constexpr uint32_t kNumHandles = 0;
     uint32_t context_id;
+    uint32_t priority;
 } __attribute__((packed));
 
 struct DestroyContextOp {
@@ -80,13 +80,14 @@ public:
     }
 
     // Creates a context and returns the context id
-    void CreateContext(uint32_t* context_id_out) override
+    void CreateContext(uint32_t priority, uint32_t* context_id_out) override
     {
         auto context_id = next_context_id_++;
         *context_id_out = context_id;
 
         CreateContextOp op;
         op.context_id = context_id;
+        op.priority = priority;
         magma_status_t result = channel_write(&op, sizeof(op), nullptr, 0);
         if (result != MAGMA_STATUS_OK)
             SetError(result);
@@ -32,13 +32,13 @@ uint32_t MagmaSystemConnection::GetDeviceId()
     return device ? device->GetDeviceId() : 0;
 }
 
-bool MagmaSystemConnection::CreateContext(uint32_t context_id)
+bool MagmaSystemConnection::CreateContext(uint32_t context_id, uint32_t priority)
 {
     auto iter = context_map_.find(context_id);
     if (iter != context_map_.end())
         return DRETF(false, "Attempting to add context with duplicate id");
 
-    auto msd_ctx = msd_connection_create_context(msd_connection());
+    auto msd_ctx = msd_connection_create_context(msd_connection(), priority);
     if (!msd_ctx)
         return DRETF(false, "Failed to create msd context");
 
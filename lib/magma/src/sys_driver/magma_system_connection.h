@@ -53,7 +53,7 @@ public:
     magma::Status ExecuteCommandBuffer(uint32_t command_buffer_handle,
                                        uint32_t context_id) override;
 
-    bool CreateContext(uint32_t context_id) override;
+    bool CreateContext(uint32_t context_id, uint32_t priority) override;
     bool DestroyContext(uint32_t context_id) override;
     MagmaSystemContext* LookupContext(uint32_t context_id);
 
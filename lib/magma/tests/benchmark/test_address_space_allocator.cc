@@ -0,0 +1,73 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "magma_util/free_list_allocator.h"
+#include "magma_util/macros.h"
+#include "magma_util/simple_allocator.h"
+#include <perftest/perftest.h>
+#include <memory>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t kAddressSpaceSize = 64ULL * 1024 * 1024 * 1024;
+constexpr unsigned int kMaxPages = 16;
+
+uint64_t RandomSize() { return (rand() % kMaxPages + 1) * PAGE_SIZE; }
+
+// Allocates |num_regions| regions of 1 to 16 pages. Each run then frees a random region and
+// allocates a new one.
+template <typename Allocator>
+bool FreeAndAllocTest(perftest::RepeatState* state, unsigned int num_regions)
+{
+    std::unique_ptr<Allocator> allocator = Allocator::Create(0, kAddressSpaceSize);
+    std::vector<uint64_t> addrs;
+    uint64_t addr;
+
+    srand(1);
+
+    for (unsigned int n = 0; n < num_regions; n++) {
+        if (!allocator->Alloc(RandomSize(), 0, &addr))
+            return DRETF(false, "failed to allocate region %u", n);
+        addrs.push_back(addr);
+    }
+
+    while (state->KeepRunning()) {
+        unsigned int index = rand() % addrs.size();
+        if (!allocator->Free(addrs[index]))
+            return DRETF(false, "failed to free region");
+        if (!allocator->Alloc(RandomSize(), rand() % 4 == 0 ? 16 : 0, &addr))
+            return DRETF(false, "failed to allocate region");
+        addrs[index] = addr;
+    }
+
+    for (uint64_t addr : addrs) {
+        if (!allocator->Free(addr))
+            return DRETF(false, "failed to free region");
+    }
+    return true;
+}
+
+void RegisterTests()
+{
+    for (unsigned int num_regions : {1000, 10000, 100000}) {
+        perftest::RegisterTest(
+            ("Magma/FreeListAllocator/FreeAndAlloc/" + std::to_string(num_regions)).c_str(),
+            FreeAndAllocTest<magma::FreeListAllocator>, num_regions);
+    }
+
+    // SimpleAllocator scans all regions on every call, so it isn't run with 100k regions.
+    for (unsigned int num_regions : {1000, 10000}) {
+        perftest::RegisterTest(
+            ("Magma/SimpleAllocator/FreeAndAlloc/" + std::to_string(num_regions)).c_str(),
+            FreeAndAllocTest<magma::SimpleAllocator>, num_regions);
+    }
+}
+PERFTEST_CTOR(RegisterTests);
+
+} // namespace
+
+int main(int argc, char** argv) { return perftest::PerfTestMain(argc, argv, "fuchsia.magma"); }
@@ -34,7 +34,7 @@ public:
             new MagmaSystemConnection(dev, MsdConnectionUniquePtr(msd_connection_t)));
         if (!connection)
             return DRETP(nullptr, "failed to connect to msd device");
-        connection->CreateContext(ctx_id);
+        connection->CreateContext(ctx_id, MAGMA_CONTEXT_PRIORITY_MEDIUM);
         auto ctx = connection->LookupContext(ctx_id);
         if (!msd_dev)
             return DRETP(nullptr, "failed to create context");
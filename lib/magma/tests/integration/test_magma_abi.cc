@@ -55,7 +55,8 @@ public:
         magma_create_context(connection_, &context_id[0]);
         EXPECT_EQ(magma_get_error(connection_), 0);
 
-        magma_create_context(connection_, &context_id[1]);
+        magma_create_context_with_priority(connection_, MAGMA_CONTEXT_PRIORITY_HIGH,
+                                           &context_id[1]);
         EXPECT_EQ(magma_get_error(connection_), 0);
 
         magma_release_context(connection_, context_id[0]);
@@ -54,6 +54,12 @@ void magma_create_context(magma_connection_t* connection, uint32_t* context_id_o
     *context_id_out = static_cast<MockConnection*>(connection)->next_context_id();
 }
 
+void magma_create_context_with_priority(magma_connection_t* connection, uint32_t priority,
+                                        uint32_t* context_id_out)
+{
+    magma_create_context(connection, context_id_out);
+}
+
 void magma_release_context(magma_connection_t* connection, uint32_t context_id) {}
 
 magma_status_t magma_create_buffer(magma_connection_t* connection, uint64_t size,
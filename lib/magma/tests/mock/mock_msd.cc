@@ -51,9 +51,9 @@ magma_status_t msd_device_query(msd_device_t* device, uint64_t id, uint64_t* val
     }
 }
 
-msd_context_t* msd_connection_create_context(msd_connection_t* dev)
+msd_context_t* msd_connection_create_context(msd_connection_t* dev, uint32_t priority)
 {
-    return MsdMockConnection::cast(dev)->CreateContext();
+    return MsdMockConnection::cast(dev)->CreateContext(priority);
 }
 
 void msd_context_destroy(msd_context_t* ctx) { delete MsdMockContext::cast(ctx); }
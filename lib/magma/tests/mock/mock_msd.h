@@ -92,7 +92,7 @@ public:
     MsdMockConnection() { magic_ = kMagic; }
     virtual ~MsdMockConnection() {}
 
-    virtual MsdMockContext* CreateContext() { return new MsdMockContext(this); }
+    virtual MsdMockContext* CreateContext(uint32_t priority) { return new MsdMockContext(this); }
 
     virtual void DestroyContext(MsdMockContext* ctx) {}
 
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "magma_util/dlog.h"
+#include "magma_util/free_list_allocator.h"
 #include "magma_util/retry_allocator.h"
 #include "magma_util/simple_allocator.h"
 #include "gtest/gtest.h"
@@ -26,7 +27,7 @@ public:
 };
 } // namespace
 
-static void test_simple_allocator(magma::SimpleAllocator* allocator, uint8_t align_pow2)
+static void test_simple_allocator(magma::AddressSpaceAllocator* allocator, uint8_t align_pow2)
 {
     DLOG("test_simple_allocator align_pow2 0x%x\n", align_pow2);
 
@@ -216,6 +217,98 @@ TEST(AddressSpaceAllocator, SimpleAllocator)
                           16ULL * 1024 * 1024);
 }
 
+TEST(AddressSpaceAllocator, FreeListAllocator)
+{
+    test_simple_allocator(magma::FreeListAllocator::Create(0, 4 * PAGE_SIZE).get(), 0);
+
+    const size_t _4g = 4ULL * 1024 * 1024 * 1024;
+    test_simple_allocator(magma::FreeListAllocator::Create(0, _4g).get(), 0);
+    test_simple_allocator(magma::FreeListAllocator::Create(0, _4g).get(), 1);
+    test_simple_allocator(magma::FreeListAllocator::Create(0, _4g).get(), 12);
+    test_simple_allocator(magma::FreeListAllocator::Create(0, _4g).get(), 13);
+
+    stress_test_allocator(magma::FreeListAllocator::Create(0, _4g).get(), 0, 100000,
+                          16ULL * 1024 * 1024);
+    stress_test_allocator(magma::FreeListAllocator::Create(0, _4g).get(), 16, 100000,
+                          16ULL * 1024 * 1024);
+}
+
+TEST(AddressSpaceAllocator, FreeListAllocatorBestFit)
+{
+    auto allocator = magma::FreeListAllocator::Create(0, 64 * PAGE_SIZE);
+    uint64_t addr[4];
+    size_t size;
+
+    // Leave free regions of 3 pages at 1 and 1 page at 5.
+    EXPECT_TRUE(allocator->Alloc(PAGE_SIZE, 0, &addr[0]));
+    EXPECT_TRUE(allocator->Alloc(3 * PAGE_SIZE, 0, &addr[1]));
+    EXPECT_TRUE(allocator->Alloc(PAGE_SIZE, 0, &addr[2]));
+    EXPECT_TRUE(allocator->Alloc(PAGE_SIZE, 0, &addr[3]));
+    EXPECT_TRUE(allocator->Alloc(PAGE_SIZE, 0, &addr[0]));
+    EXPECT_EQ(6 * PAGE_SIZE, addr[0]);
+    EXPECT_TRUE(allocator->Free(addr[1]));
+    EXPECT_TRUE(allocator->Free(addr[3]));
+
+    auto stats = allocator->GetStats();
+    EXPECT_EQ(3u, stats.allocation_count);
+    EXPECT_EQ(3u, stats.free_region_count);
+    EXPECT_EQ(61 * PAGE_SIZE, stats.free_bytes);
+    EXPECT_EQ(57 * PAGE_SIZE, stats.largest_free_region);
+    EXPECT_GT(stats.fragmentation(), 0.0);
+
+    // A single page goes to the one page gap rather than the first gap.
+    EXPECT_TRUE(allocator->Alloc(PAGE_SIZE, 0, &addr[3]));
+    EXPECT_EQ(5 * PAGE_SIZE, addr[3]);
+
+    // A two page region aligned to two pages fits the three page gap only at page 2.
+    EXPECT_TRUE(allocator->Alloc(2 * PAGE_SIZE, 13, &addr[1]));
+    EXPECT_EQ(2 * PAGE_SIZE, addr[1]);
+    EXPECT_TRUE(allocator->GetSize(addr[1] + PAGE_SIZE, &size));
+    EXPECT_EQ(2 * PAGE_SIZE, size);
+
+    // Freeing everything coalesces the free regions.
+    EXPECT_TRUE(allocator->Free(addr[1]));
+    EXPECT_TRUE(allocator->Free(addr[3]));
+    EXPECT_TRUE(allocator->Free(4 * PAGE_SIZE));
+    EXPECT_TRUE(allocator->Free(0));
+    EXPECT_TRUE(allocator->Free(addr[0]));
+    EXPECT_FALSE(allocator->Free(addr[0]));
+
+    stats = allocator->GetStats();
+    EXPECT_EQ(0u, stats.allocation_count);
+    EXPECT_EQ(1u, stats.free_region_count);
+    EXPECT_EQ(64 * PAGE_SIZE, stats.largest_free_region);
+    EXPECT_EQ(0.0, stats.fragmentation());
+}
+
+TEST(AddressSpaceAllocator, FreeListAllocatorManyMisalignedRegions)
+{
+    constexpr uint32_t kPageCount = 128;
+    auto allocator = magma::FreeListAllocator::Create(0, kPageCount * PAGE_SIZE);
+    uint64_t addr;
+    for (uint32_t i = 0; i < kPageCount; i++) {
+        EXPECT_TRUE(allocator->Alloc(PAGE_SIZE, 0, &addr));
+        EXPECT_EQ(i * PAGE_SIZE, addr);
+    }
+
+    // Leave 20 free regions of 2 pages at odd pages, none of which can hold 2 pages aligned to
+    // 16 pages, then a 4 page region at page 95 which can at page 96.
+    for (uint32_t i = 0; i < 20; i++) {
+        EXPECT_TRUE(allocator->Free((1 + 4 * i) * PAGE_SIZE));
+        EXPECT_TRUE(allocator->Free((2 + 4 * i) * PAGE_SIZE));
+    }
+    for (uint32_t page = 95; page < 99; page++) {
+        EXPECT_TRUE(allocator->Free(page * PAGE_SIZE));
+    }
+    EXPECT_EQ(4 * PAGE_SIZE, allocator->GetStats().largest_free_region);
+
+    // No free region is large enough for any alignment, so every candidate is tried.
+    EXPECT_TRUE(allocator->Alloc(2 * PAGE_SIZE, 16, &addr));
+    EXPECT_EQ(96 * PAGE_SIZE, addr);
+
+    EXPECT_FALSE(allocator->Alloc(2 * PAGE_SIZE, 16, &addr));
+}
+
 TEST(AddressSpaceAllocator, RetryAllocator)
 {
     test_retry_allocator(magma::RetryAllocator::Create(0, 4 * PAGE_SIZE).get(), 0);
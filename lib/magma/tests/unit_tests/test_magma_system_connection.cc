@@ -34,10 +34,11 @@ class MsdMockConnection_ContextManagement : public MsdMockConnection {
 public:
     MsdMockConnection_ContextManagement() {}
 
-    MsdMockContext* CreateContext() override
+    MsdMockContext* CreateContext(uint32_t priority) override
     {
         active_context_count_++;
-        return MsdMockConnection::CreateContext();
+        last_context_priority_ = priority;
+        return MsdMockConnection::CreateContext(priority);
     }
 
     void DestroyContext(MsdMockContext* ctx) override
@@ -47,9 +48,11 @@ public:
     }
 
     uint32_t NumActiveContexts() { return active_context_count_; }
+    uint32_t LastContextPriority() { return last_context_priority_; }
 
 private:
     uint32_t active_context_count_ = 0;
+    uint32_t last_context_priority_ = 0;
 };
 
 TEST(MagmaSystemConnection, ContextManagement)
@@ -66,11 +69,13 @@ TEST(MagmaSystemConnection, ContextManagement)
     uint32_t context_id_0 = 0;
     uint32_t context_id_1 = 1;
 
-    EXPECT_TRUE(connection.CreateContext(context_id_0));
+    EXPECT_TRUE(connection.CreateContext(context_id_0, MAGMA_CONTEXT_PRIORITY_MEDIUM));
     EXPECT_EQ(msd_connection->NumActiveContexts(), 1u);
+    EXPECT_EQ(msd_connection->LastContextPriority(), MAGMA_CONTEXT_PRIORITY_MEDIUM);
 
-    EXPECT_TRUE(connection.CreateContext(context_id_1));
+    EXPECT_TRUE(connection.CreateContext(context_id_1, MAGMA_CONTEXT_PRIORITY_HIGH));
     EXPECT_EQ(msd_connection->NumActiveContexts(), 2u);
+    EXPECT_EQ(msd_connection->LastContextPriority(), MAGMA_CONTEXT_PRIORITY_HIGH);
 
     EXPECT_TRUE(connection.DestroyContext(context_id_0));
     EXPECT_EQ(msd_connection->NumActiveContexts(), 1u);
@@ -60,7 +60,7 @@ public:
         ASSERT_NE(connection, nullptr);
 
         uint32_t context_id = ++context_id_;
-        EXPECT_TRUE(connection->CreateContext(context_id));
+        EXPECT_TRUE(connection->CreateContext(context_id, MAGMA_CONTEXT_PRIORITY_MEDIUM));
         auto context = connection->LookupContext(context_id);
         ASSERT_NE(context, nullptr);
 
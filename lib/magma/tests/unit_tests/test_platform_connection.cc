@@ -70,9 +70,10 @@ public:
     void TestCreateContext()
     {
         uint32_t context_id;
-        ipc_connection_->CreateContext(&context_id);
+        ipc_connection_->CreateContext(MAGMA_CONTEXT_PRIORITY_HIGH, &context_id);
         EXPECT_EQ(ipc_connection_->GetError(), 0);
         EXPECT_EQ(test_context_id, context_id);
+        EXPECT_EQ(static_cast<uint32_t>(MAGMA_CONTEXT_PRIORITY_HIGH), test_context_priority);
     }
     void TestDestroyContext()
     {
@@ -151,6 +152,7 @@ public:
 
     static uint64_t test_buffer_id;
     static uint32_t test_context_id;
+    static uint32_t test_context_priority;
     static uint64_t test_semaphore_id;
     static magma_status_t test_error;
     static bool test_complete;
@@ -170,6 +172,7 @@ private:
 uint64_t TestPlatformConnection::test_buffer_id;
 uint64_t TestPlatformConnection::test_semaphore_id;
 uint32_t TestPlatformConnection::test_context_id;
+uint32_t TestPlatformConnection::test_context_priority;
 magma_status_t TestPlatformConnection::test_error;
 bool TestPlatformConnection::test_complete;
 std::unique_ptr<magma::PlatformSemaphore> TestPlatformConnection::test_semaphore;
@@ -204,9 +207,10 @@ public:
         return true;
     }
 
-    bool CreateContext(uint32_t context_id) override
+    bool CreateContext(uint32_t context_id, uint32_t priority) override
     {
         TestPlatformConnection::test_context_id = context_id;
+        TestPlatformConnection::test_context_priority = priority;
         TestPlatformConnection::test_complete = true;
         return true;
     }
@@ -296,6 +300,7 @@ std::unique_ptr<TestPlatformConnection> TestPlatformConnection::Create()
     test_buffer_id = 0xcafecafecafecafe;
     test_semaphore_id = ~0u;
     test_context_id = 0xdeadbeef;
+    test_context_priority = 0;
     test_error = 0x12345678;
     test_complete = false;
     auto delegate = std::make_unique<TestDelegate>();
@@ -31,19 +31,25 @@ public:
     bool Exec();
 
 private:
+    // Each priority gets its own device, because the global priority of a queue is fixed when the
+    // device is created. The driver creates a magma context per device at that priority.
+    struct PriorityDevice {
+        VkDevice vk_device;
+        VkQueue vk_queue;
+        VkCommandPool vk_command_pool;
+        VkCommandBuffer vk_command_buffer;
+    };
+
     bool InitVulkan();
-    bool InitCommandPool();
-    bool InitCommandBuffer(VkCommandBuffer* command_buffer, uint32_t executions);
+    bool InitDevice(VkQueueGlobalPriorityEXT global_priority, PriorityDevice* device);
+    bool InitCommandPool(PriorityDevice* device);
+    bool InitCommandBuffer(PriorityDevice* device, uint32_t executions);
 
     bool is_initialized_ = false;
     VkPhysicalDevice vk_physical_device_;
-    VkDevice vk_device_;
-    VkQueue low_prio_vk_queue_;
-    VkQueue high_prio_vk_queue_;
-
-    VkCommandPool vk_command_pool_;
-    VkCommandBuffer low_prio_vk_command_buffer_;
-    VkCommandBuffer high_prio_vk_command_buffer_;
+    uint32_t queue_family_index_;
+    PriorityDevice low_prio_;
+    PriorityDevice high_prio_;
 };
 
 bool VkPriorityTest::Initialize()
@@ -54,14 +60,20 @@ bool VkPriorityTest::Initialize()
     if (!InitVulkan())
         return DRETF(false, "failed to initialize Vulkan");
 
-    if (!InitCommandPool())
+    if (!InitDevice(VK_QUEUE_GLOBAL_PRIORITY_LOW_EXT, &low_prio_))
+        return DRETF(false, "InitDevice failed for low priority");
+
+    if (!InitDevice(VK_QUEUE_GLOBAL_PRIORITY_HIGH_EXT, &high_prio_))
+        return DRETF(false, "InitDevice failed for high priority");
+
+    if (!InitCommandPool(&low_prio_) || !InitCommandPool(&high_prio_))
         return DRETF(false, "InitCommandPool failed");
 
-    if (!InitCommandBuffer(&low_prio_vk_command_buffer_, 1000))
-        return DRETF(false, "InitImage failed");
+    if (!InitCommandBuffer(&low_prio_, 1000))
+        return DRETF(false, "InitCommandBuffer failed");
 
-    if (!InitCommandBuffer(&high_prio_vk_command_buffer_, 1))
-        return DRETF(false, "InitImage failed");
+    if (!InitCommandBuffer(&high_prio_, 1))
+        return DRETF(false, "InitCommandBuffer failed");
 
     is_initialized_ = true;
 
@@ -136,20 +148,49 @@ bool VkPriorityTest::InitVulkan()
     if (queue_family_index < 0)
         return DRETF(false, "couldn't find an appropriate queue");
 
-    if (queue_family_properties[queue_family_index].queueCount < 2)
-        return DRETF(false, "Need 2 queues to use priorities");
+    uint32_t extension_count;
+    if ((result = vkEnumerateDeviceExtensionProperties(physical_devices[0], nullptr,
+                                                       &extension_count, nullptr)) != VK_SUCCESS)
+        return DRETF(false, "vkEnumerateDeviceExtensionProperties failed %d", result);
+
+    std::vector<VkExtensionProperties> extensions(extension_count);
+    if ((result = vkEnumerateDeviceExtensionProperties(physical_devices[0], nullptr,
+                                                       &extension_count, extensions.data())) !=
+        VK_SUCCESS)
+        return DRETF(false, "vkEnumerateDeviceExtensionProperties failed %d", result);
+
+    bool found_global_priority = false;
+    for (auto& extension : extensions) {
+        if (strcmp(extension.extensionName, VK_EXT_GLOBAL_PRIORITY_EXTENSION_NAME) == 0)
+            found_global_priority = true;
+    }
+    if (!found_global_priority)
+        return DRETF(false, "%s not supported", VK_EXT_GLOBAL_PRIORITY_EXTENSION_NAME);
+
+    vk_physical_device_ = physical_devices[0];
+    queue_family_index_ = queue_family_index;
+
+    return true;
+}
+
+bool VkPriorityTest::InitDevice(VkQueueGlobalPriorityEXT global_priority, PriorityDevice* device)
+{
+    VkDeviceQueueGlobalPriorityCreateInfoEXT global_priority_info = {
+        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_GLOBAL_PRIORITY_CREATE_INFO_EXT,
+        .pNext = nullptr,
+        .globalPriority = global_priority};
 
-    float queue_priorities[2] = {0.0, 1.0};
+    float queue_priority = 1.0;
 
     VkDeviceQueueCreateInfo queue_create_info = {.sType =
                                                      VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-                                                 .pNext = nullptr,
+                                                 .pNext = &global_priority_info,
                                                  .flags = 0,
-                                                 .queueFamilyIndex = 0,
-                                                 .queueCount = 2,
-                                                 .pQueuePriorities = queue_priorities};
+                                                 .queueFamilyIndex = queue_family_index_,
+                                                 .queueCount = 1,
+                                                 .pQueuePriorities = &queue_priority};
 
-    std::vector<const char*> enabled_extension_names;
+    std::vector<const char*> enabled_extension_names{VK_EXT_GLOBAL_PRIORITY_EXTENSION_NAME};
 
     VkDeviceCreateInfo createInfo = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
                                      .pNext = nullptr,
@@ -162,47 +203,45 @@ bool VkPriorityTest::InitVulkan()
                                          static_cast<uint32_t>(enabled_extension_names.size()),
                                      .ppEnabledExtensionNames = enabled_extension_names.data(),
                                      .pEnabledFeatures = nullptr};
-    VkDevice vkdevice;
-
-    if ((result = vkCreateDevice(physical_devices[0], &createInfo,
-                                 nullptr /* allocationcallbacks */, &vkdevice)) != VK_SUCCESS)
+    VkResult result;
+    if ((result = vkCreateDevice(vk_physical_device_, &createInfo,
+                                 nullptr /* allocationcallbacks */, &device->vk_device)) !=
+        VK_SUCCESS)
         return DRETF(false, "vkCreateDevice failed: %d", result);
 
-    vk_physical_device_ = physical_devices[0];
-    vk_device_ = vkdevice;
-
-    vkGetDeviceQueue(vkdevice, queue_family_index, 0, &low_prio_vk_queue_);
-    vkGetDeviceQueue(vkdevice, queue_family_index, 1, &high_prio_vk_queue_);
+    vkGetDeviceQueue(device->vk_device, queue_family_index_, 0, &device->vk_queue);
 
     return true;
 }
 
-bool VkPriorityTest::InitCommandPool()
+bool VkPriorityTest::InitCommandPool(PriorityDevice* device)
 {
     VkCommandPoolCreateInfo command_pool_create_info = {
         .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
         .pNext = nullptr,
         .flags = 0,
-        .queueFamilyIndex = 0,
+        .queueFamilyIndex = queue_family_index_,
     };
     VkResult result;
-    if ((result = vkCreateCommandPool(vk_device_, &command_pool_create_info, nullptr,
-                                      &vk_command_pool_)) != VK_SUCCESS)
+    if ((result = vkCreateCommandPool(device->vk_device, &command_pool_create_info, nullptr,
+                                      &device->vk_command_pool)) != VK_SUCCESS)
         return DRETF(false, "vkCreateCommandPool failed: %d", result);
     DLOG("Created command buffer pool");
     return true;
 }
 
-bool VkPriorityTest::InitCommandBuffer(VkCommandBuffer* command_buffer, uint32_t executions)
+bool VkPriorityTest::InitCommandBuffer(PriorityDevice* device, uint32_t executions)
 {
+    VkDevice vk_device = device->vk_device;
+    VkCommandBuffer* command_buffer = &device->vk_command_buffer;
     VkCommandBufferAllocateInfo command_buffer_create_info = {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
         .pNext = nullptr,
-        .commandPool = vk_command_pool_,
+        .commandPool = device->vk_command_pool,
         .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
         .commandBufferCount = 1};
     VkResult result;
-    if ((result = vkAllocateCommandBuffers(vk_device_, &command_buffer_create_info,
+    if ((result = vkAllocateCommandBuffers(vk_device, &command_buffer_create_info,
                                            command_buffer)) != VK_SUCCESS)
         return DRETF(false, "vkAllocateCommandBuffers failed: %d", result);
 
@@ -226,7 +265,7 @@ bool VkPriorityTest::InitCommandBuffer(VkCommandBuffer* command_buffer, uint32_t
 #include "priority.comp.h"
     sh_info.codeSize = sizeof(priority_comp);
     sh_info.pCode = priority_comp;
-    if ((result = vkCreateShaderModule(vk_device_, &sh_info, NULL, &compute_shader_module_)) !=
+    if ((result = vkCreateShaderModule(vk_device, &sh_info, NULL, &compute_shader_module_)) !=
         VK_SUCCESS) {
         return DRETF(false, "vkCreateShaderModule failed: %d", result);
     }
@@ -242,7 +281,7 @@ bool VkPriorityTest::InitCommandBuffer(VkCommandBuffer* command_buffer, uint32_t
         .pushConstantRangeCount = 0,
         .pPushConstantRanges = nullptr};
 
-    if ((result = vkCreatePipelineLayout(vk_device_, &pipeline_create_info, nullptr, &layout)) !=
+    if ((result = vkCreatePipelineLayout(vk_device, &pipeline_create_info, nullptr, &layout)) !=
         VK_SUCCESS) {
         return DRETF(false, "vkCreatePipelineLayout failed: %d", result);
     }
@@ -264,7 +303,7 @@ bool VkPriorityTest::InitCommandBuffer(VkCommandBuffer* command_buffer, uint32_t
         .basePipelineHandle = VK_NULL_HANDLE,
         .basePipelineIndex = 0};
 
-    if ((result = vkCreateComputePipelines(vk_device_, VK_NULL_HANDLE, 1, &pipeline_info, nullptr,
+    if ((result = vkCreateComputePipelines(vk_device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr,
                                            &compute_pipeline)) != VK_SUCCESS) {
         return DRETF(false, "vkCreateComputePipelines failed: %d", result);
     }
@@ -283,10 +322,10 @@ bool VkPriorityTest::InitCommandBuffer(VkCommandBuffer* command_buffer, uint32_t
 bool VkPriorityTest::Exec()
 {
     VkResult result;
-    result = vkQueueWaitIdle(low_prio_vk_queue_);
+    result = vkQueueWaitIdle(low_prio_.vk_queue);
     if (result != VK_SUCCESS)
         return DRETF(false, "vkQueueWaitIdle failed with result %d", result);
-    result = vkQueueWaitIdle(high_prio_vk_queue_);
+    result = vkQueueWaitIdle(high_prio_.vk_queue);
     if (result != VK_SUCCESS)
         return DRETF(false, "vkQueueWaitIdle failed with result %d", result);
 
@@ -297,13 +336,13 @@ bool VkPriorityTest::Exec()
         .pWaitSemaphores = nullptr,
         .pWaitDstStageMask = nullptr,
         .commandBufferCount = 1,
-        .pCommandBuffers = &low_prio_vk_command_buffer_,
+        .pCommandBuffers = &low_prio_.vk_command_buffer,
         .signalSemaphoreCount = 0,
         .pSignalSemaphores = nullptr,
     };
 
     auto low_prio_start_time = std::chrono::steady_clock::now();
-    if ((result = vkQueueSubmit(low_prio_vk_queue_, 1, &submit_info, VK_NULL_HANDLE)) != VK_SUCCESS)
+    if ((result = vkQueueSubmit(low_prio_.vk_queue, 1, &submit_info, VK_NULL_HANDLE)) != VK_SUCCESS)
         return DRETF(false, "vkQueueSubmit failed: %d", result);
     // Should be enough time for the first queue to start executing.
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -314,16 +353,16 @@ bool VkPriorityTest::Exec()
         .pWaitSemaphores = nullptr,
         .pWaitDstStageMask = nullptr,
         .commandBufferCount = 1,
-        .pCommandBuffers = &high_prio_vk_command_buffer_,
+        .pCommandBuffers = &high_prio_.vk_command_buffer,
         .signalSemaphoreCount = 0,
         .pSignalSemaphores = nullptr,
     };
 
     auto high_prio_start_time = std::chrono::steady_clock::now();
-    if ((result = vkQueueSubmit(high_prio_vk_queue_, 1, &high_prio_submit_info, VK_NULL_HANDLE)) !=
+    if ((result = vkQueueSubmit(high_prio_.vk_queue, 1, &high_prio_submit_info, VK_NULL_HANDLE)) !=
         VK_SUCCESS)
         return DRETF(false, "vkQueueSubmit failed: %d", result);
-    if ((result = vkQueueWaitIdle(high_prio_vk_queue_)) != VK_SUCCESS) {
+    if ((result = vkQueueWaitIdle(high_prio_.vk_queue)) != VK_SUCCESS) {
         return DRETF(false, "vkQueueWaitIdle failed: %d", result);
     }
     auto high_prio_end_time = std::chrono::steady_clock::now();
@@ -331,7 +370,7 @@ bool VkPriorityTest::Exec()
     printf("first vkQueueWaitIdle finished duration: %lld\n",
            std::chrono::duration_cast<std::chrono::milliseconds>(high_prio_duration).count());
 
-    if ((result = vkQueueWaitIdle(low_prio_vk_queue_)) != VK_SUCCESS) {
+    if ((result = vkQueueWaitIdle(low_prio_.vk_queue)) != VK_SUCCESS) {
         return DRETF(false, "vkQueueWaitIdle failed: %d", result);
     }
     auto low_prio_end_time = std::chrono::steady_clock::now();
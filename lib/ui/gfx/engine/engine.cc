@@ -69,6 +69,7 @@ Engine::Engine(DisplayManager* display_manager,
           escher()->resource_recycler(), escher()->gpu_allocator())),
       rounded_rect_factory_(
           std::make_unique<escher::RoundedRectFactory>(escher_)),
+      staging_ring_(std::make_unique<escher::StagingRing>(escher_)),
       release_fence_signaller_(std::make_unique<escher::ReleaseFenceSignaller>(
           escher()->command_buffer_sequencer())),
       session_manager_(std::make_unique<SessionManager>()),
@@ -106,8 +107,8 @@ Engine::~Engine() = default;
 
 void Engine::InitializeFrameScheduler() {
   if (display_manager_->default_display()) {
-    frame_scheduler_ =
-        std::make_unique<FrameScheduler>(display_manager_->default_display());
+    frame_scheduler_ = std::make_unique<FrameScheduler>(
+        display_manager_->default_display(), SCENIC_FRAMES_IN_FLIGHT);
     frame_scheduler_->set_delegate(this);
   }
 }
@@ -145,14 +146,15 @@ bool Engine::RenderFrame(const FrameTimingsPtr& timings,
   if (display_manager_->default_display() &&
       display_manager_->default_display()->is_test_display()) {
     has_updates = session_manager_->ApplyScheduledSessionUpdates(
-        presentation_time, presentation_interval);
+        presentation_time, presentation_interval, timings.get());
   } else {
-    auto gpu_uploader = escher::BatchGpuUploader::New(escher_, trace_number);
+    auto gpu_uploader = escher::BatchGpuUploader::New(escher_, trace_number,
+                                                      staging_ring_.get());
     command_context_.batch_gpu_uploader = gpu_uploader.get();
     command_context_.MakeValid();
 
     has_updates = session_manager_->ApplyScheduledSessionUpdates(
-        presentation_time, presentation_interval);
+        presentation_time, presentation_interval, timings.get());
 
     // Submit regardless of whether or not there are updates to release the
     // underlying CommandBuffer so the pool and sequencer don't stall out.
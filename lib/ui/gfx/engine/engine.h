@@ -13,6 +13,7 @@
 #include "lib/escher/flib/release_fence_signaller.h"
 #include "lib/escher/impl/gpu_uploader.h"
 #include "lib/escher/renderer/batch_gpu_uploader.h"
+#include "lib/escher/renderer/staging_ring.h"
 #include "lib/escher/resources/resource_recycler.h"
 #include "lib/escher/shape/rounded_rect_factory.h"
 #include "lib/escher/vk/simple_image_factory.h"
@@ -142,6 +143,14 @@ class Engine : public UpdateScheduler, private FrameSchedulerDelegate {
     return &command_context_;
   }
 
+  // Returns the uploader of the current frame while session updates are being
+  // applied in RenderFrame(), and null otherwise or if there is no Escher.
+  escher::BatchGpuUploader* batch_gpu_uploader() {
+    return escher_ && command_context_.is_valid
+               ? command_context_.batch_gpu_uploader
+               : nullptr;
+  }
+
   // Invoke Escher::Cleanup().  If more work remains afterward, post a delayed
   // task to try again; this is typically because cleanup couldn't finish due to
   // unfinished GPU work.
@@ -188,6 +197,8 @@ class Engine : public UpdateScheduler, private FrameSchedulerDelegate {
   EventTimestamper event_timestamper_;
   std::unique_ptr<escher::SimpleImageFactory> image_factory_;
   std::unique_ptr<escher::RoundedRectFactory> rounded_rect_factory_;
+  // Staging memory shared by the BatchGpuUploaders of successive frames.
+  std::unique_ptr<escher::StagingRing> staging_ring_;
   std::unique_ptr<escher::ReleaseFenceSignaller> release_fence_signaller_;
   std::unique_ptr<SessionManager> session_manager_;
   std::unique_ptr<FrameScheduler> frame_scheduler_;
@@ -4,6 +4,8 @@
 
 #include "garnet/lib/ui/gfx/engine/frame_scheduler.h"
 
+#include <algorithm>
+
 #include <lib/async/cpp/task.h>
 #include <lib/async/default.h>
 #include <lib/async/time.h>
@@ -17,11 +19,32 @@
 namespace scenic_impl {
 namespace gfx {
 
-FrameScheduler::FrameScheduler(Display* display)
+namespace {
+
+// Number of recent frames that render time predictions are based on.
+constexpr size_t kRenderTimeWindowSize = 10;
+// Prediction used until the first frame is presented.
+constexpr zx_duration_t kInitialRenderTimePrediction = 8'000'000;  // 8ms
+// Added to the predicted render time, to absorb scheduling jitter.
+constexpr zx_duration_t kRenderTimeMargin = 1'000'000;  // 1ms
+
+}  // namespace
+
+constexpr size_t FrameScheduler::kMinFramesInFlight;
+constexpr size_t FrameScheduler::kMaxFramesInFlight;
+constexpr size_t FrameScheduler::kDefaultFramesInFlight;
+
+FrameScheduler::FrameScheduler(Display* display, size_t max_frames_in_flight)
     : dispatcher_(async_get_default_dispatcher()),
       display_(display),
+      max_frames_in_flight_(max_frames_in_flight),
+      render_time_predictor_(kRenderTimeWindowSize,
+                             kInitialRenderTimePrediction, kRenderTimeMargin),
       weak_factory_(this) {
-  outstanding_frames_.reserve(kMaxOutstandingFrames);
+  FXL_DCHECK(max_frames_in_flight_ >= kMinFramesInFlight &&
+             max_frames_in_flight_ <= kMaxFramesInFlight)
+      << max_frames_in_flight_;
+  outstanding_frames_.reserve(max_frames_in_flight_);
 }
 
 FrameScheduler::~FrameScheduler() {}
@@ -44,18 +67,24 @@ void FrameScheduler::SetRenderContinuously(bool render_continuously) {
 }
 
 zx_time_t FrameScheduler::PredictRequiredFrameRenderTime() const {
-  // TODO(MZ-400): more sophisticated prediction.  This might require more info,
-  // e.g. about how many compositors will be rendering scenes, at what
+  // TODO(MZ-400): The prediction only looks at recent frames; it could also
+  // take into account how many compositors will be rendering scenes, at what
   // resolutions, etc.
-  constexpr zx_time_t kHardcodedPrediction = 8'000'000;  // 8ms
-  return kHardcodedPrediction;
+  return render_time_predictor_.Predict();
 }
 
 std::pair<zx_time_t, zx_time_t>
 FrameScheduler::ComputeNextPresentationAndWakeupTimes() const {
   FXL_DCHECK(!requested_presentation_times_.empty());
-  return ComputeTargetPresentationAndWakeupTimes(
-      requested_presentation_times_.top());
+  zx_time_t requested_presentation_time = requested_presentation_times_.top();
+  // Each frame in flight is presented at its own Vsync, so the next frame must
+  // target a later one.
+  if (!outstanding_frames_.empty()) {
+    requested_presentation_time = std::max(
+        requested_presentation_time,
+        outstanding_frames_.back()->target_presentation_time() + 1);
+  }
+  return ComputeTargetPresentationAndWakeupTimes(requested_presentation_time);
 }
 
 std::pair<zx_time_t, zx_time_t>
@@ -166,6 +195,14 @@ void FrameScheduler::MaybeRenderFrame(zx_time_t presentation_time,
     return;
   }
 
+  if (!outstanding_frames_.empty() &&
+      presentation_time <=
+          outstanding_frames_.back()->target_presentation_time()) {
+    // This task was scheduled before a frame for the same Vsync was rendered,
+    // which scheduled another task for the remaining requests.
+    return;
+  }
+
   if (TooMuchBackPressure()) {
     // No need to request another frame; ScheduleFrame() will be called
     // when the back-pressure is relieved.
@@ -195,13 +232,19 @@ void FrameScheduler::MaybeRenderFrame(zx_time_t presentation_time,
 
   // Go render the frame.
   if (delegate_) {
-    FXL_DCHECK(outstanding_frames_.size() < kMaxOutstandingFrames);
+    FXL_DCHECK(outstanding_frames_.size() < max_frames_in_flight_);
     auto frame_timings = fxl::MakeRefCounted<FrameTimings>(
-        this, ++frame_number_, presentation_time);
+        this, ++frame_number_, presentation_time, async_now(dispatcher_));
     if (delegate_->RenderFrame(frame_timings, presentation_time,
                                display_->GetVsyncInterval(),
                                render_continuously_)) {
       outstanding_frames_.push_back(frame_timings);
+
+      // Keep the pipeline full; back-pressure stops this once
+      // |max_frames_in_flight_| frames are outstanding.
+      if (render_continuously_) {
+        requested_presentation_times_.push(0);
+      }
     }
   }
 
@@ -218,6 +261,8 @@ void FrameScheduler::OnFramePresented(FrameTimings* timings) {
   // receiving signals out-of-order and is therefore generating bogus data.
   FXL_DCHECK(outstanding_frames_[0].get() == timings) << "out-of-order.";
 
+  RecordFrameTimings(*timings);
+
   if (timings->frame_was_dropped()) {
     TRACE_INSTANT("gfx", "FrameDropped", TRACE_SCOPE_PROCESS, "frame_number",
                   timings->frame_number());
@@ -267,8 +312,39 @@ void FrameScheduler::OnFramePresented(FrameTimings* timings) {
   }
 }
 
+void FrameScheduler::RecordFrameTimings(const FrameTimings& timings) {
+  if (timings.frame_was_dropped()) {
+    ++metrics_.frames_dropped;
+    return;
+  }
+
+  render_time_predictor_.AddSample(timings.rendering_finished_time() -
+                                   timings.rendering_started_time());
+
+  // Presentation timestamps are taken a little after the Vsync, so only count
+  // a frame as missed if it was presented at a later Vsync than its target.
+  const zx_time_t miss_threshold =
+      timings.target_presentation_time() + display_->GetVsyncInterval() / 2;
+  const bool missed = timings.actual_presentation_time() > miss_threshold;
+  const zx_duration_t latency =
+      timings.actual_presentation_time() - timings.rendering_started_time();
+
+  ++metrics_.frames_presented;
+  if (missed) {
+    ++metrics_.frames_missed;
+  }
+  metrics_.total_latency += latency;
+  metrics_.max_latency = std::max(metrics_.max_latency, latency);
+
+  TRACE_COUNTER("gfx", "FrameScheduler", 0, "latency (usecs)",
+                latency / 1000, "predicted render time (usecs)",
+                render_time_predictor_.Predict() / 1000, "missed frames",
+                metrics_.frames_missed, "dropped frames",
+                metrics_.frames_dropped);
+}
+
 bool FrameScheduler::TooMuchBackPressure() {
-  if (outstanding_frames_.size() >= kMaxOutstandingFrames) {
+  if (outstanding_frames_.size() >= max_frames_in_flight_) {
     back_pressure_applied_ = true;
     return true;
   }
@@ -10,6 +10,7 @@
 #include <lib/async/dispatcher.h>
 #include <lib/zx/time.h>
 
+#include "garnet/lib/ui/gfx/engine/render_time_predictor.h"
 #include "lib/fxl/macros.h"
 #include "lib/fxl/memory/ref_ptr.h"
 #include "lib/fxl/memory/weak_ptr.h"
@@ -52,13 +53,50 @@ class FrameSchedulerDelegate {
 // example, if the requested time is earlier than the time that rendering would
 // finish, were it started immediately, then the frame will be scheduled for a
 // later Vsync.
+//
+// Up to |max_frames_in_flight| frames may be rendering or waiting to be
+// presented at once, so that rendering a frame can take longer than a Vsync
+// interval without lowering the frame rate.  Rendering starts as late as the
+// predicted render time allows, to minimize the latency between applying
+// session updates and presenting them.  Scenic sets |max_frames_in_flight|
+// from the scenic_frames_in_flight GN arg.
 class FrameScheduler {
  public:
-  explicit FrameScheduler(Display* display);
+  static constexpr size_t kMinFramesInFlight = 1;
+  static constexpr size_t kMaxFramesInFlight = 3;
+  static constexpr size_t kDefaultFramesInFlight = 2;
+
+  // Statistics about the presented frames, also exported as trace counters.
+  struct Metrics {
+    uint64_t frames_presented = 0;
+    // Presented frames that missed their target presentation time.
+    uint64_t frames_missed = 0;
+    uint64_t frames_dropped = 0;
+    // Time from starting to apply updates for a frame until it was presented,
+    // summed over all presented frames.  This bounds the input-to-photon
+    // latency of input that was handled before the frame started.
+    zx_duration_t total_latency = 0;
+    zx_duration_t max_latency = 0;
+
+    double miss_rate() const {
+      return frames_presented == 0
+                 ? 0.
+                 : static_cast<double>(frames_missed) / frames_presented;
+    }
+    zx_duration_t average_latency() const {
+      return frames_presented == 0 ? 0 : total_latency / frames_presented;
+    }
+  };
+
+  explicit FrameScheduler(
+      Display* display, size_t max_frames_in_flight = kDefaultFramesInFlight);
   ~FrameScheduler();
 
   void set_delegate(FrameSchedulerDelegate* delegate) { delegate_ = delegate; }
 
+  size_t max_frames_in_flight() const { return max_frames_in_flight_; }
+  const Metrics& metrics() const { return metrics_; }
+
   // Request a frame to be scheduled at or after |presentation_time|, which
   // may be in the past.
   void RequestFrame(zx_time_t presentation_time);
@@ -96,9 +134,13 @@ class FrameScheduler {
   // rendering in order to hit the target presentation time.
   std::pair<zx_time_t, zx_time_t> ComputeNextPresentationAndWakeupTimes() const;
 
-  // Return the predicted amount of time required to render a frame.
+  // Return the predicted amount of time required to render a frame, from
+  // waking up until the last swapchain has finished rendering.
   zx_time_t PredictRequiredFrameRenderTime() const;
 
+  // Update |metrics_| and the render time prediction with a finished frame.
+  void RecordFrameTimings(const FrameTimings& timings);
+
   // Called by the delegate when the frame drawn by RenderFrame() has been
   // presented to the display.
   friend class FrameTimings;
@@ -113,8 +155,10 @@ class FrameScheduler {
       requested_presentation_times_;
 
   uint64_t frame_number_ = 0;
-  constexpr static size_t kMaxOutstandingFrames = 2;
+  const size_t max_frames_in_flight_;
   std::vector<FrameTimingsPtr> outstanding_frames_;
+  RenderTimePredictor render_time_predictor_;
+  Metrics metrics_;
   bool back_pressure_applied_ = false;
   bool render_continuously_ = false;
 
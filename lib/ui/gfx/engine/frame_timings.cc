@@ -4,19 +4,23 @@
 
 #include "garnet/lib/ui/gfx/engine/frame_timings.h"
 
+#include <algorithm>
+
 #include "garnet/lib/ui/gfx/engine/frame_scheduler.h"
 
 namespace scenic_impl {
 namespace gfx {
 
-FrameTimings::FrameTimings() : FrameTimings(nullptr, 0, 0) {}
+FrameTimings::FrameTimings() : FrameTimings(nullptr, 0, 0, 0) {}
 
 FrameTimings::FrameTimings(FrameScheduler* frame_scheduler,
                            uint64_t frame_number,
-                           zx_time_t target_presentation_time)
+                           zx_time_t target_presentation_time,
+                           zx_time_t rendering_started_time)
     : frame_scheduler_(frame_scheduler),
       frame_number_(frame_number),
-      target_presentation_time_(target_presentation_time) {}
+      target_presentation_time_(target_presentation_time),
+      rendering_started_time_(rendering_started_time) {}
 
 size_t FrameTimings::AddSwapchain(Swapchain* swapchain) {
   // All swapchains that we are timing must be added before any of them finish.
@@ -97,6 +101,13 @@ void FrameTimings::Finalize() {
   FXL_DCHECK(!finalized());
   finalized_ = true;
 
+  if (!frame_was_dropped()) {
+    for (const Record& record : swapchain_records_) {
+      rendering_finished_time_ =
+          std::max(rendering_finished_time_, record.frame_rendered_time);
+    }
+  }
+
   if (frame_scheduler_) {
     frame_scheduler_->OnFramePresented(this);
   }
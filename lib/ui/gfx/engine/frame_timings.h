@@ -8,6 +8,7 @@
 #include <lib/zx/time.h>
 #include <vector>
 
+#include "garnet/lib/ui/gfx/id.h"
 #include "lib/escher/base/reffable.h"
 
 namespace scenic_impl {
@@ -24,9 +25,18 @@ using FrameTimingsPtr = fxl::RefPtr<FrameTimings>;
 // FrameScheduler is notified via OnFramePresented().
 class FrameTimings : public escher::Reffable {
  public:
+  // How long it took to apply the updates of one session for the frame.
+  struct SessionUpdateTiming {
+    SessionId session_id;
+    zx::duration apply_duration;
+    // True if the session's commands were applied on a worker thread.
+    bool applied_in_parallel;
+  };
+
   FrameTimings();
   FrameTimings(FrameScheduler* frame_scheduler, uint64_t frame_number,
-               zx_time_t target_presentation_time);
+               zx_time_t target_presentation_time,
+               zx_time_t rendering_started_time);
 
   // Add a swapchain that is used as a render target this frame.  Return an
   // index that can be used to indicate when rendering for that swapchain is
@@ -37,6 +47,14 @@ class FrameTimings : public escher::Reffable {
   void OnFramePresented(size_t swapchain_index, zx_time_t time);
   void OnFrameDropped(size_t swapchain_index);
 
+  // Records the time taken to apply a session's updates, before rendering.
+  void AddSessionUpdateTiming(SessionUpdateTiming timing) {
+    session_update_timings_.push_back(timing);
+  }
+  const std::vector<SessionUpdateTiming>& session_update_timings() const {
+    return session_update_timings_;
+  }
+
   // Returns true when the frame timing has been passed to the scheduler
   // and can be discarded.
   //
@@ -51,6 +69,15 @@ class FrameTimings : public escher::Reffable {
     return target_presentation_time_;
   }
 
+  // When the FrameScheduler woke up to apply updates and render the frame.
+  zx_time_t rendering_started_time() const { return rendering_started_time_; }
+  // When the last swapchain finished rendering.  Should only be called once
+  // finalized, and if frame_was_dropped returns false.
+  zx_time_t rendering_finished_time() const {
+    FXL_DCHECK(finalized_ && !frame_was_dropped());
+    return rendering_finished_time_;
+  }
+
   bool frame_was_dropped() const {
     return actual_presentation_time_ == ZX_TIME_INFINITE;
   }
@@ -76,9 +103,12 @@ class FrameTimings : public escher::Reffable {
     zx_time_t frame_presented_time = 0;
   };
   std::vector<Record> swapchain_records_;
+  std::vector<SessionUpdateTiming> session_update_timings_;
   FrameScheduler* const frame_scheduler_;
   const uint64_t frame_number_;
   const zx_time_t target_presentation_time_;
+  const zx_time_t rendering_started_time_;
+  zx_time_t rendering_finished_time_ = 0;
   zx_time_t actual_presentation_time_ = 0;
   size_t frame_rendered_count_ = 0;
   size_t frame_presented_count_ = 0;
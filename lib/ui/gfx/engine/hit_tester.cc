@@ -4,15 +4,26 @@
 
 #include "garnet/lib/ui/gfx/engine/hit_tester.h"
 
+#include <algorithm>
+
 #include "garnet/lib/ui/gfx/engine/session.h"
 #include "garnet/lib/ui/gfx/resources/nodes/traversal.h"
 #include "garnet/lib/ui/gfx/resources/view.h"
+#include "lib/escher/geometry/intersection.h"
 #include "lib/escher/geometry/types.h"
 #include "lib/fxl/logging.h"
 
 namespace scenic_impl {
 namespace gfx {
 
+namespace {
+
+// Bounds are padded by this fraction of their largest coordinate, so that
+// rounding never rejects a ray which grazes the edge of some content.
+constexpr float kHitBoundsPadding = 1e-4f;
+
+}  // namespace
+
 SessionHitTester::SessionHitTester(Session* session) : session_(session) {
   FXL_CHECK(session_);
 }
@@ -44,6 +55,10 @@ std::vector<Hit> HitTester::HitTest(Node* node, const escher::ray4& ray) {
 }
 
 void HitTester::AccumulateHitsOuter(Node* node) {
+  // Skip subtrees which the ray misses entirely.
+  if (!IsRayWithinHitBounds(node, ray_info_->ray))
+    return;
+
   // Take a fast path for identity transformations.
   if (node->transform().IsIdentity()) {
     AccumulateHitsLocal(node);
@@ -112,6 +127,9 @@ bool HitTester::IsRayWithinPartsInner(Node* node, const escher::ray4& ray) {
 
 bool HitTester::IsRayWithinClippedContentOuter(Node* node,
                                                const escher::ray4& ray) {
+  if (!IsRayWithinHitBounds(node, ray))
+    return false;
+
   if (node->transform().IsIdentity()) {
     return IsRayWithinClippedContentInner(node, ray);
   }
@@ -139,5 +157,29 @@ bool HitTester::IsRayWithinClippedContentInner(Node* node,
   });
 }
 
+bool HitTester::IsRayWithinHitBounds(Node* node, const escher::ray4& ray) {
+  const Node::HitBounds& bounds = node->GetHitBounds();
+  if (bounds.unbounded)
+    return true;
+  if (bounds.box.is_empty())
+    return false;
+
+  // Shapes treat the ray as homogeneous, with points (origin + t * direction)
+  // divided by the origin's w.
+  if (ray.origin.w <= 0.f)
+    return true;
+  escher::ray4 ray3{ray.origin / ray.origin.w, ray.direction / ray.origin.w};
+
+  const escher::vec3& min = bounds.box.min();
+  const escher::vec3& max = bounds.box.max();
+  escher::vec3 largest = glm::max(glm::abs(min), glm::abs(max));
+  escher::vec3 padding(kHitBoundsPadding *
+                       (1.f + std::max({largest.x, largest.y, largest.z})));
+  escher::BoundingBox padded_box(min - padding, max + padding);
+
+  float distance;
+  return escher::IntersectRayBox(ray3, padded_box, &distance);
+}
+
 }  // namespace gfx
 }  // namespace scenic_impl
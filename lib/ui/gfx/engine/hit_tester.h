@@ -91,6 +91,10 @@ class HitTester {
   static bool IsRayWithinClippedContentInner(Node* node,
                                              const escher::ray4& ray);
 
+  // Returns false if the ray can't hit anything in the node's subtree.
+  // |ray| must be in the parent's local coordinate system.
+  static bool IsRayWithinHitBounds(Node* node, const escher::ray4& ray);
+
   // The vector which accumulates hits.
   std::vector<Hit> hits_;
 
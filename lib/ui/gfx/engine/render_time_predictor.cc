@@ -0,0 +1,36 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/lib/ui/gfx/engine/render_time_predictor.h"
+
+#include <algorithm>
+
+#include "lib/fxl/logging.h"
+
+namespace scenic_impl {
+namespace gfx {
+
+RenderTimePredictor::RenderTimePredictor(size_t window_size,
+                                         zx_duration_t initial_prediction,
+                                         zx_duration_t margin)
+    : window_size_(window_size),
+      margin_(margin),
+      prediction_(initial_prediction) {
+  FXL_DCHECK(window_size_ > 0);
+  samples_.reserve(window_size_);
+}
+
+void RenderTimePredictor::AddSample(zx_duration_t render_time) {
+  FXL_DCHECK(render_time >= 0);
+  if (samples_.size() < window_size_) {
+    samples_.push_back(render_time);
+  } else {
+    samples_[next_sample_] = render_time;
+    next_sample_ = (next_sample_ + 1) % window_size_;
+  }
+  prediction_ = *std::max_element(samples_.begin(), samples_.end()) + margin_;
+}
+
+}  // namespace gfx
+}  // namespace scenic_impl
@@ -0,0 +1,55 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GARNET_LIB_UI_GFX_ENGINE_RENDER_TIME_PREDICTOR_H_
+#define GARNET_LIB_UI_GFX_ENGINE_RENDER_TIME_PREDICTOR_H_
+
+#include <vector>
+
+#include <zircon/types.h>
+
+#include "lib/fxl/macros.h"
+
+namespace scenic_impl {
+namespace gfx {
+
+// Predicts how long the next frame will take to render, from the time the
+// FrameScheduler wakes up to the time the last swapchain finishes rendering,
+// based on a moving window of the most recent frames.
+//
+// The prediction is the longest render time in the window plus a safety
+// margin: missing a Vsync costs a whole frame, whereas waking up a little too
+// early only costs a little latency.  Because the window is short, the
+// prediction recovers quickly after a single slow frame.
+class RenderTimePredictor {
+ public:
+  RenderTimePredictor(size_t window_size, zx_duration_t initial_prediction,
+                      zx_duration_t margin);
+
+  // Records the render time of a frame, evicting the oldest one if the window
+  // is full.
+  void AddSample(zx_duration_t render_time);
+
+  // Returns |initial_prediction| until a sample has been added.
+  zx_duration_t Predict() const { return prediction_; }
+
+  size_t sample_count() const { return samples_.size(); }
+
+ private:
+  const size_t window_size_;
+  const zx_duration_t margin_;
+
+  // Ring buffer of the most recent samples; |next_sample_| is the index of the
+  // oldest one once the window is full.
+  std::vector<zx_duration_t> samples_;
+  size_t next_sample_ = 0;
+  zx_duration_t prediction_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(RenderTimePredictor);
+};
+
+}  // namespace gfx
+}  // namespace scenic_impl
+
+#endif  // GARNET_LIB_UI_GFX_ENGINE_RENDER_TIME_PREDICTOR_H_
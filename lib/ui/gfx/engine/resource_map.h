@@ -22,6 +22,12 @@ class ResourceMap {
 
   void Clear();
 
+  // Changes where errors are reported, for example while the map's session is
+  // being updated on a worker thread.
+  void set_error_reporter(ErrorReporter* error_reporter) {
+    error_reporter_ = error_reporter;
+  }
+
   // Attempt to add the resource; return true if successful.  Return false if
   // the ID is already present in the map, which is left unchanged.
   bool AddResource(ResourceId id, ResourcePtr resource);
@@ -100,7 +106,7 @@ class ResourceMap {
 
  private:
   std::unordered_map<ResourceId, ResourcePtr> resources_;
-  ErrorReporter* const error_reporter_;
+  ErrorReporter* error_reporter_;
 };
 
 }  // namespace gfx
@@ -79,6 +79,62 @@ fidl::VectorPtr<::fuchsia::ui::gfx::Hit> WrapHits(
   }
   return wrapped_hits;
 }
+
+// Resource types which touch nothing outside of their session.  Sessions
+// which have only these can be updated concurrently with one another.
+constexpr ResourceTypeFlags kSessionLocalResourceTypes =
+    ResourceType::kShape | ResourceType::kRectangle | ResourceType::kCircle |
+    ResourceType::kMaterial | ResourceType::kNode | ResourceType::kClipNode |
+    ResourceType::kEntityNode | ResourceType::kOpacityNode |
+    ResourceType::kShapeNode | ResourceType::kVariable;
+
+bool IsSharedResourceType(const ResourceTypeInfo& type_info) {
+  return (type_info.flags & ~kSessionLocalResourceTypes) != 0;
+}
+
+// Returns true if |command| touches nothing outside of the session which
+// applies it, provided that the session has no shared resources.  Releasing
+// or detaching resources is then safe, because any resource that it destroys
+// is session-local too.
+bool IsSessionLocalCommand(const ::fuchsia::ui::gfx::Command& command) {
+  switch (command.Which()) {
+    case ::fuchsia::ui::gfx::Command::Tag::kCreateResource:
+      switch (command.create_resource().resource.Which()) {
+        case ::fuchsia::ui::gfx::ResourceArgs::Tag::kRectangle:
+        case ::fuchsia::ui::gfx::ResourceArgs::Tag::kCircle:
+        case ::fuchsia::ui::gfx::ResourceArgs::Tag::kMaterial:
+        case ::fuchsia::ui::gfx::ResourceArgs::Tag::kClipNode:
+        case ::fuchsia::ui::gfx::ResourceArgs::Tag::kEntityNode:
+        case ::fuchsia::ui::gfx::ResourceArgs::Tag::kOpacityNode:
+        case ::fuchsia::ui::gfx::ResourceArgs::Tag::kShapeNode:
+        case ::fuchsia::ui::gfx::ResourceArgs::Tag::kVariable:
+          return true;
+        default:
+          return false;
+      }
+    case ::fuchsia::ui::gfx::Command::Tag::kReleaseResource:
+    case ::fuchsia::ui::gfx::Command::Tag::kAddChild:
+    case ::fuchsia::ui::gfx::Command::Tag::kAddPart:
+    case ::fuchsia::ui::gfx::Command::Tag::kDetach:
+    case ::fuchsia::ui::gfx::Command::Tag::kDetachChildren:
+    case ::fuchsia::ui::gfx::Command::Tag::kSetTag:
+    case ::fuchsia::ui::gfx::Command::Tag::kSetTranslation:
+    case ::fuchsia::ui::gfx::Command::Tag::kSetScale:
+    case ::fuchsia::ui::gfx::Command::Tag::kSetRotation:
+    case ::fuchsia::ui::gfx::Command::Tag::kSetAnchor:
+    case ::fuchsia::ui::gfx::Command::Tag::kSetOpacity:
+    case ::fuchsia::ui::gfx::Command::Tag::kSetShape:
+    case ::fuchsia::ui::gfx::Command::Tag::kSetMaterial:
+    case ::fuchsia::ui::gfx::Command::Tag::kSetClip:
+    case ::fuchsia::ui::gfx::Command::Tag::kSetHitTestBehavior:
+    case ::fuchsia::ui::gfx::Command::Tag::kSetColor:
+    case ::fuchsia::ui::gfx::Command::Tag::kSetEventMask:
+    case ::fuchsia::ui::gfx::Command::Tag::kSetLabel:
+      return true;
+    default:
+      return false;
+  }
+}
 }  // anonymous namespace
 
 Session::Session(SessionId id, Engine* engine, EventReporter* event_reporter,
@@ -387,9 +443,22 @@ bool Session::ApplyTakeSnapshotCmdHACK(
           return;
         }
 
+        // Delta snapshots are relative to the previous delta snapshot of the
+        // same node.
+        std::shared_ptr<SnapshotCache> cache;
+        if (command.delta) {
+          auto& node_cache = weak->snapshot_caches_[command.node_id];
+          if (!node_cache) {
+            node_cache = std::make_shared<SnapshotCache>();
+          }
+          cache = node_cache;
+        } else {
+          weak->snapshot_caches_.erase(command.node_id);
+        }
+
         auto gpu_uploader =
             escher::BatchGpuUploader::New(engine->GetEscherWeakPtr());
-        Snapshotter snapshotter(gpu_uploader);
+        Snapshotter snapshotter(gpu_uploader, std::move(cache));
         // Take a snapshot and return the data in callback. The closure does
         // not need the snapshotter instance and is invoked after the instance
         // is destroyed.
@@ -1397,6 +1466,8 @@ void Session::TearDown() {
   // were not closed, we would have to invoke those callbacks before destroying
   // them.
   scheduled_updates_ = {};
+  preapplied_updates_.clear();
+  has_preapplied_updates_ = false;
   fences_to_release_on_next_update_.reset();
 
   if (resource_count_ != 0) {
@@ -1505,7 +1576,7 @@ bool Session::ScheduleUpdate(
             weak->engine_, requested_presentation_time, SessionPtr(weak.get()));
     });
 
-    scheduled_updates_.push(
+    scheduled_updates_.push_back(
         Update{requested_presentation_time, std::move(commands),
                std::move(acquire_fence_set), std::move(release_events),
                std::move(callback)});
@@ -1538,54 +1609,53 @@ bool Session::ApplyScheduledUpdates(uint64_t presentation_time,
     return false;
   }
 
+  std::vector<Update> applied_updates;
+  bool succeeded;
+  if (has_preapplied_updates_) {
+    deferred_error_reporter_.ReportTo(error_reporter_);
+    applied_updates = std::move(preapplied_updates_);
+    preapplied_updates_.clear();
+    succeeded = preapply_succeeded_;
+    has_preapplied_updates_ = false;
+  } else {
+    succeeded = ApplyReadyUpdates(presentation_time, &applied_updates);
+  }
+
   bool needs_render = false;
-  while (!scheduled_updates_.empty() &&
-         scheduled_updates_.front().presentation_time <= presentation_time) {
-    if (!scheduled_updates_.front().acquire_fences->ready()) {
-      TRACE_INSTANT("gfx", "Session missed frame", TRACE_SCOPE_PROCESS,
-                    "session_id", id(), "target presentation time (usecs)",
-                    presentation_time / 1000,
-                    "session target presentation time (usecs)",
-                    scheduled_updates_.front().presentation_time / 1000);
-      break;
+  for (auto& update : applied_updates) {
+    needs_render = true;
+    auto info = fuchsia::images::PresentationInfo();
+    info.presentation_time = presentation_time;
+    info.presentation_interval = presentation_interval;
+    update.present_callback(std::move(info));
+
+    FXL_DCHECK(last_applied_update_presentation_time_ <=
+               update.presentation_time);
+    last_applied_update_presentation_time_ = update.presentation_time;
+
+    for (size_t i = 0; i < fences_to_release_on_next_update_->size(); ++i) {
+      engine()->release_fence_signaller()->AddCPUReleaseFence(
+          std::move(fences_to_release_on_next_update_->at(i)));
     }
-    if (ApplyUpdate(std::move(scheduled_updates_.front().commands))) {
-      needs_render = true;
-      auto info = fuchsia::images::PresentationInfo();
-      info.presentation_time = presentation_time;
-      info.presentation_interval = presentation_interval;
-      scheduled_updates_.front().present_callback(std::move(info));
-
-      FXL_DCHECK(last_applied_update_presentation_time_ <=
-                 scheduled_updates_.front().presentation_time);
-      last_applied_update_presentation_time_ =
-          scheduled_updates_.front().presentation_time;
-
-      for (size_t i = 0; i < fences_to_release_on_next_update_->size(); ++i) {
-        engine()->release_fence_signaller()->AddCPUReleaseFence(
-            std::move(fences_to_release_on_next_update_->at(i)));
-      }
-      fences_to_release_on_next_update_ =
-          std::move(scheduled_updates_.front().release_fences);
+    fences_to_release_on_next_update_ = std::move(update.release_fences);
 
-      scheduled_updates_.pop();
+    // TODO: gather statistics about how close the actual
+    // presentation_time was to the requested time.
+  }
 
-      // TODO: gather statistics about how close the actual
-      // presentation_time was to the requested time.
-    } else {
-      // An error was encountered while applying the update.
-      FXL_LOG(WARNING) << "scenic_impl::gfx::Session::ApplyScheduledUpdates(): "
-                          "An error was encountered while applying the update. "
-                          "Initiating teardown.";
+  if (!succeeded) {
+    // An error was encountered while applying the update.
+    FXL_LOG(WARNING) << "scenic_impl::gfx::Session::ApplyScheduledUpdates(): "
+                        "An error was encountered while applying the update. "
+                        "Initiating teardown.";
 
-      scheduled_updates_ = {};
+    scheduled_updates_ = {};
 
-      BeginTearDown();
+    BeginTearDown();
 
-      // Tearing down a session will very probably result in changes to
-      // the global scene-graph.
-      return true;
-    }
+    // Tearing down a session will very probably result in changes to
+    // the global scene-graph.
+    return true;
   }
 
   // TODO: Unify with other session updates.
@@ -1602,6 +1672,46 @@ bool Session::ApplyScheduledUpdates(uint64_t presentation_time,
   return needs_render;
 }
 
+bool Session::CanApplyScheduledUpdatesInParallel(
+    uint64_t presentation_time) const {
+  if (!is_valid() || presentation_time < last_presentation_time_ ||
+      shared_resource_count_ > 0) {
+    return false;
+  }
+
+  // Check the same updates that ApplyReadyUpdates() would apply.
+  for (const Update& update : scheduled_updates_) {
+    if (update.presentation_time > presentation_time ||
+        !update.acquire_fences->ready()) {
+      break;
+    }
+    for (const auto& command : update.commands) {
+      if (!IsSessionLocalCommand(command)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void Session::PreapplyScheduledUpdates(uint64_t presentation_time) {
+  TRACE_DURATION("gfx", "Session::PreapplyScheduledUpdates", "id", id_,
+                 "time", presentation_time);
+  FXL_DCHECK(!has_preapplied_updates_);
+
+  // Nothing may report errors to the client from this thread.
+  ErrorReporter* error_reporter = error_reporter_;
+  error_reporter_ = &deferred_error_reporter_;
+  resources_.set_error_reporter(&deferred_error_reporter_);
+
+  preapply_succeeded_ =
+      ApplyReadyUpdates(presentation_time, &preapplied_updates_);
+  has_preapplied_updates_ = true;
+
+  error_reporter_ = error_reporter;
+  resources_.set_error_reporter(error_reporter);
+}
+
 void Session::EnqueueEvent(::fuchsia::ui::gfx::Event event) {
   if (!is_valid()) {
     return;
@@ -1633,6 +1743,76 @@ bool Session::ApplyUpdate(std::vector<::fuchsia::ui::gfx::Command> commands) {
   // consumed by the FrameScheduler.
 }
 
+bool Session::ApplyReadyUpdates(uint64_t presentation_time,
+                                std::vector<Update>* applied_updates) {
+  while (!scheduled_updates_.empty() &&
+         scheduled_updates_.front().presentation_time <= presentation_time) {
+    if (!scheduled_updates_.front().acquire_fences->ready()) {
+      TRACE_INSTANT("gfx", "Session missed frame", TRACE_SCOPE_PROCESS,
+                    "session_id", id(), "target presentation time (usecs)",
+                    presentation_time / 1000,
+                    "session target presentation time (usecs)",
+                    scheduled_updates_.front().presentation_time / 1000);
+      break;
+    }
+    if (!ApplyUpdate(std::move(scheduled_updates_.front().commands))) {
+      return false;
+    }
+    applied_updates->push_back(std::move(scheduled_updates_.front()));
+    scheduled_updates_.pop_front();
+  }
+  return true;
+}
+
+void Session::IncrementResourceCount(const ResourceTypeInfo& type_info) {
+  ++resource_count_;
+  if (IsSharedResourceType(type_info)) {
+    ++shared_resource_count_;
+  }
+}
+
+void Session::DecrementResourceCount(const ResourceTypeInfo& type_info) {
+  --resource_count_;
+  if (IsSharedResourceType(type_info)) {
+    FXL_DCHECK(shared_resource_count_ > 0);
+    --shared_resource_count_;
+  }
+}
+
+void Session::SetResourceExported(bool exported) {
+  if (exported) {
+    ++shared_resource_count_;
+  } else {
+    FXL_DCHECK(shared_resource_count_ > 0);
+    --shared_resource_count_;
+  }
+}
+
+void Session::DeferredErrorReporter::ReportTo(ErrorReporter* error_reporter) {
+  for (auto& error : errors_) {
+    switch (error.first) {
+      case fxl::LOG_INFO:
+        error_reporter->INFO() << error.second;
+        break;
+      case fxl::LOG_WARNING:
+        error_reporter->WARN() << error.second;
+        break;
+      case fxl::LOG_ERROR:
+        error_reporter->ERROR() << error.second;
+        break;
+      default:
+        error_reporter->FATAL() << error.second;
+        break;
+    }
+  }
+  errors_.clear();
+}
+
+void Session::DeferredErrorReporter::ReportError(fxl::LogSeverity severity,
+                                                 std::string error_string) {
+  errors_.emplace_back(severity, std::move(error_string));
+}
+
 void Session::HitTest(uint32_t node_id, ::fuchsia::ui::gfx::vec3 ray_origin,
                       ::fuchsia::ui::gfx::vec3 ray_direction,
                       fuchsia::ui::scenic::Session::HitTestCallback callback) {
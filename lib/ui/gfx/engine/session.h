@@ -5,6 +5,11 @@
 #ifndef GARNET_LIB_UI_GFX_ENGINE_SESSION_H_
 #define GARNET_LIB_UI_GFX_ENGINE_SESSION_H_
 
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <fuchsia/ui/gfx/cpp/fidl.h>
@@ -13,6 +18,7 @@
 #include "garnet/lib/ui/gfx/engine/resource_map.h"
 #include "garnet/lib/ui/gfx/id.h"
 #include "garnet/lib/ui/gfx/resources/memory.h"
+#include "garnet/lib/ui/gfx/resources/resource_type_info.h"
 #include "garnet/lib/ui/scenic/util/error_reporter.h"
 #include "garnet/lib/ui/scenic/util/print_command.h"
 #include "lib/escher/flib/fence_set_listener.h"
@@ -37,6 +43,7 @@ using SessionPtr = ::fxl::RefPtr<Session>;
 class Engine;
 class Resource;
 class SessionHandler;
+class SnapshotCache;
 
 // TODO: use unsafe ref-counting for better performance (our architecture
 // guarantees that this is safe).
@@ -92,6 +99,20 @@ class Session : public fxl::RefCountedThreadSafe<Session> {
   bool ApplyScheduledUpdates(uint64_t presentation_time,
                              uint64_t presentation_interval);
 
+  // Returns true if the updates which ApplyScheduledUpdates() would apply at
+  // |presentation_time| can be applied by PreapplyScheduledUpdates() on a
+  // worker thread, concurrently with other sessions.  This is the case when
+  // the session has no resources which are shared with other sessions or with
+  // the engine, and the updates create no such resources.
+  bool CanApplyScheduledUpdatesInParallel(uint64_t presentation_time) const;
+
+  // Applies the commands of the updates which ApplyScheduledUpdates() would
+  // apply at |presentation_time|, and touches nothing outside the session.
+  // Errors, present callbacks and release fences are deferred until the next
+  // call to ApplyScheduledUpdates(), which must follow on the main thread.
+  // Only valid if CanApplyScheduledUpdatesInParallel() returned true.
+  void PreapplyScheduledUpdates(uint64_t presentation_time);
+
   // Convenience.  Forwards an event to the EventReporter.
   void EnqueueEvent(::fuchsia::ui::gfx::Event event);
   void EnqueueEvent(::fuchsia::ui::input::InputEvent event);
@@ -294,8 +315,9 @@ class Session : public fxl::RefCountedThreadSafe<Session> {
   }
 
   friend class Resource;
-  void IncrementResourceCount() { ++resource_count_; }
-  void DecrementResourceCount() { --resource_count_; }
+  void IncrementResourceCount(const ResourceTypeInfo& type_info);
+  void DecrementResourceCount(const ResourceTypeInfo& type_info);
+  void SetResourceExported(bool exported);
 
   struct Update {
     uint64_t presentation_time;
@@ -309,7 +331,14 @@ class Session : public fxl::RefCountedThreadSafe<Session> {
     fuchsia::ui::scenic::Session::PresentCallback present_callback;
   };
   bool ApplyUpdate(std::vector<::fuchsia::ui::gfx::Command> commands);
-  std::queue<Update> scheduled_updates_;
+
+  // Applies the commands of each update which is due at |presentation_time|
+  // and whose acquire fences have been signalled, and moves the update to
+  // |applied_updates|.  Returns false if an update failed to apply.
+  bool ApplyReadyUpdates(uint64_t presentation_time,
+                         std::vector<Update>* applied_updates);
+
+  std::deque<Update> scheduled_updates_;
   ::fidl::VectorPtr<zx::event> fences_to_release_on_next_update_;
 
   uint64_t last_applied_update_presentation_time_ = 0;
@@ -335,9 +364,39 @@ class Session : public fxl::RefCountedThreadSafe<Session> {
 
   ResourceMap resources_;
 
+  // State kept between the delta snapshots of each node.
+  std::unordered_map<ResourceId, std::shared_ptr<SnapshotCache>>
+      snapshot_caches_;
+
   size_t resource_count_ = 0;
+  // The number of resources which are exported, or whose type may touch other
+  // sessions or the engine.  Updates are only applied in parallel when there
+  // are none.
+  size_t shared_resource_count_ = 0;
   bool is_valid_ = true;
 
+  // Collects the errors reported by PreapplyScheduledUpdates(), so they can be
+  // reported on the main thread.
+  class DeferredErrorReporter : public ErrorReporter {
+   public:
+    // Reports the collected errors to |error_reporter|, and forgets them.
+    void ReportTo(ErrorReporter* error_reporter);
+
+   private:
+    // |ErrorReporter|
+    void ReportError(fxl::LogSeverity severity,
+                     std::string error_string) override;
+
+    std::vector<std::pair<fxl::LogSeverity, std::string>> errors_;
+  };
+
+  // The results of PreapplyScheduledUpdates(), which ApplyScheduledUpdates()
+  // has yet to complete.
+  bool has_preapplied_updates_ = false;
+  bool preapply_succeeded_ = true;
+  std::vector<Update> preapplied_updates_;
+  DeferredErrorReporter deferred_error_reporter_;
+
   fxl::WeakPtrFactory<Session> weak_factory_;  // must be last
 };
 
@@ -4,10 +4,17 @@
 
 #include "garnet/lib/ui/gfx/engine/session_manager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+
 #include <lib/async/cpp/task.h>
 #include <lib/async/default.h>
 #include <trace/event.h>
 
+#include "garnet/lib/ui/gfx/engine/frame_timings.h"
 #include "garnet/lib/ui/gfx/engine/session.h"
 #include "garnet/lib/ui/gfx/engine/session_handler.h"
 #include "garnet/lib/ui/gfx/engine/update_scheduler.h"
@@ -55,10 +62,40 @@ void SessionManager::ScheduleUpdateForSession(UpdateScheduler* update_scheduler,
 }
 
 bool SessionManager::ApplyScheduledSessionUpdates(
-    uint64_t presentation_time, uint64_t presentation_interval) {
+    uint64_t presentation_time, uint64_t presentation_interval,
+    FrameTimings* timings) {
   TRACE_DURATION("gfx", "ApplyScheduledSessionUpdates", "time",
                  presentation_time, "interval", presentation_interval);
 
+  // First apply the commands of the sessions which can be applied in parallel.
+  // Their present callbacks, release fences and errors are completed along
+  // with every other session below.
+  std::unordered_map<Session*, zx::duration> preapply_durations;
+  if (update_loop_) {
+    std::vector<Session*> parallel_sessions;
+    for (const auto& entry : updatable_sessions_) {
+      if (entry.first > presentation_time)
+        break;
+      Session* session = entry.second.get();
+      if (session && !preapply_durations.count(session) &&
+          session->CanApplyScheduledUpdatesInParallel(presentation_time)) {
+        preapply_durations[session] = zx::duration();
+        parallel_sessions.push_back(session);
+      }
+    }
+
+    if (parallel_sessions.size() > 1) {
+      std::vector<zx::duration> durations = PreapplySessionUpdatesInParallel(
+          parallel_sessions, presentation_time);
+      for (size_t i = 0; i < parallel_sessions.size(); ++i) {
+        preapply_durations[parallel_sessions[i]] = durations[i];
+      }
+    } else {
+      // Not worth waking the update threads.
+      preapply_durations.clear();
+    }
+  }
+
   bool needs_render = false;
   while (!updatable_sessions_.empty()) {
     auto top = updatable_sessions_.begin();
@@ -67,8 +104,22 @@ bool SessionManager::ApplyScheduledSessionUpdates(
     auto session = std::move(top->second);
     updatable_sessions_.erase(top);
     if (session) {
+      zx::time start_time = zx::clock::get_monotonic();
       needs_render |= session->ApplyScheduledUpdates(presentation_time,
                                                      presentation_interval);
+      zx::duration apply_duration = zx::clock::get_monotonic() - start_time;
+
+      bool applied_in_parallel = false;
+      auto preapplied = preapply_durations.find(session.get());
+      if (preapplied != preapply_durations.end()) {
+        apply_duration += preapplied->second;
+        applied_in_parallel = true;
+        preapply_durations.erase(preapplied);
+      }
+      if (timings) {
+        timings->AddSessionUpdateTiming(
+            {session->id(), apply_duration, applied_in_parallel});
+      }
     } else {
       // Corresponds to a call to ScheduleUpdate(), which always triggers a
       // render.
@@ -78,6 +129,68 @@ bool SessionManager::ApplyScheduledSessionUpdates(
   return needs_render;
 }
 
+void SessionManager::SetUpdateThreadCount(uint32_t thread_count) {
+  if (update_loop_) {
+    update_loop_->Shutdown();
+    update_loop_.reset();
+  }
+
+  update_thread_count_ = thread_count;
+  if (update_thread_count_ > 0) {
+    update_loop_ =
+        std::make_unique<async::Loop>(&kAsyncLoopConfigNoAttachToThread);
+    for (uint32_t i = 0; i < update_thread_count_; ++i) {
+      update_loop_->StartThread("scenic-session-update");
+    }
+  }
+}
+
+std::vector<zx::duration> SessionManager::PreapplySessionUpdatesInParallel(
+    const std::vector<Session*>& sessions, uint64_t presentation_time) {
+  TRACE_DURATION("gfx", "PreapplySessionUpdatesInParallel", "sessions",
+                 sessions.size());
+  FXL_DCHECK(update_loop_);
+
+  std::vector<zx::duration> durations(sessions.size());
+  std::atomic<size_t> next_index(0);
+
+  // Each thread takes the next session until none remain.
+  auto apply_sessions = [&sessions, &durations, &next_index,
+                         presentation_time] {
+    for (size_t index = next_index++; index < sessions.size();
+         index = next_index++) {
+      zx::time start_time = zx::clock::get_monotonic();
+      sessions[index]->PreapplyScheduledUpdates(presentation_time);
+      durations[index] = zx::clock::get_monotonic() - start_time;
+    }
+  };
+
+  // The calling thread does its share of the work too.
+  size_t task_count =
+      std::min<size_t>(update_thread_count_, sessions.size() - 1);
+  std::mutex mutex;
+  std::condition_variable tasks_done;
+  size_t pending_task_count = task_count;
+  for (size_t i = 0; i < task_count; ++i) {
+    async::PostTask(update_loop_->dispatcher(), [&] {
+      apply_sessions();
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--pending_task_count == 0) {
+        tasks_done.notify_one();
+      }
+    });
+  }
+
+  apply_sessions();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  tasks_done.wait(lock, [&pending_task_count] {
+    return pending_task_count == 0;
+  });
+
+  return durations;
+}
+
 void SessionManager::TearDownSession(SessionId id) {
   auto it = session_manager_.find(id);
   FXL_DCHECK(it != session_manager_.end());
@@ -5,8 +5,13 @@
 #ifndef GARNET_LIB_UI_GFX_ENGINE_SESSION_MANAGER_H_
 #define GARNET_LIB_UI_GFX_ENGINE_SESSION_MANAGER_H_
 
+#include <memory>
 #include <set>
 #include <unordered_map>
+#include <vector>
+
+#include <lib/async-loop/cpp/loop.h>
+#include <lib/zx/time.h>
 
 #include "garnet/lib/ui/scenic/command_dispatcher.h"
 
@@ -23,6 +28,7 @@ using SessionId = ::scenic_impl::SessionId;
 class SessionHandler;
 class Session;
 class Engine;
+class FrameTimings;
 class UpdateScheduler;
 
 // Manages a collection of SessionHandlers.
@@ -51,9 +57,19 @@ class SessionManager {
                                 fxl::RefPtr<Session> session);
 
   // Executes updates that are schedule up to and including a given presentation
-  // time. Returns true if rendering is needed.
+  // time. Returns true if rendering is needed.  If |timings| isn't null, the
+  // time taken to apply each session's updates is recorded there.
   bool ApplyScheduledSessionUpdates(uint64_t presentation_time,
-                                    uint64_t presentation_interval);
+                                    uint64_t presentation_interval,
+                                    FrameTimings* timings = nullptr);
+
+  // Applies the commands of sessions which share no resources with other
+  // sessions on |thread_count| worker threads, concurrently with one another.
+  // Everything else, including all sessions with cross-session links such as
+  // imports, exports and views, is applied on the calling thread afterwards,
+  // so the resulting scene is the same as if every session were applied in
+  // turn.  Zero, the default, applies every session on the calling thread.
+  void SetUpdateThreadCount(uint32_t thread_count);
 
  private:
   friend class Session;
@@ -62,6 +78,12 @@ class SessionManager {
   // Destroys the session with the given id.
   void TearDownSession(SessionId id);
 
+  // Calls Session::PreapplyScheduledUpdates() on each of |sessions|, spread
+  // across the calling thread and the update threads, and returns the time
+  // taken for each session.
+  std::vector<zx::duration> PreapplySessionUpdatesInParallel(
+      const std::vector<Session*>& sessions, uint64_t presentation_time);
+
   virtual std::unique_ptr<SessionHandler> CreateSessionHandler(
       CommandDispatcherContext context, Engine* engine, SessionId session_id,
       EventReporter* event_reporter, ErrorReporter* error_reporter) const;
@@ -74,6 +96,10 @@ class SessionManager {
   // Lists all Session that have updates to apply, sorted by the earliest
   // requested presentation time of each update.
   std::set<std::pair<uint64_t, fxl::RefPtr<Session>>> updatable_sessions_;
+
+  // Runs the update threads, if there are any.
+  std::unique_ptr<async::Loop> update_loop_;
+  uint32_t update_thread_count_ = 0;
 };
 
 }  // namespace gfx
@@ -5,6 +5,7 @@
 #include "garnet/lib/ui/gfx/gfx_system.h"
 
 #include <fs/pseudo-file.h>
+#include <lib/zx/time.h>
 
 #include "garnet/lib/ui/gfx/engine/session_handler.h"
 #include "garnet/lib/ui/gfx/screenshotter.h"
@@ -13,12 +14,18 @@
 #include "lib/component/cpp/startup_context.h"
 #include "lib/escher/escher_process_init.h"
 #include "lib/escher/fs/hack_filesystem.h"
+#include "lib/escher/impl/spirv_cache.h"
 #include "lib/escher/util/check_vulkan_support.h"
+#include "lib/escher/vk/impl/persistent_pipeline_cache.h"
 #include "public/lib/syslog/cpp/logger.h"
 
 namespace scenic_impl {
 namespace gfx {
 
+// Compiled shaders and pipelines are kept here across restarts, so that
+// Scenic needn't rebuild them every time it starts.
+static constexpr char kShaderCacheDirectory[] = "/data/shader_cache";
+
 GfxSystem::GfxSystem(SystemContext context,
                      std::unique_ptr<DisplayManager> display_manager)
     : TempSystemDelegate(std::move(context), false),
@@ -51,8 +58,11 @@ std::unique_ptr<CommandDispatcher> GfxSystem::CreateCommandDispatcher(
 }
 
 std::unique_ptr<Engine> GfxSystem::InitializeEngine() {
-  return std::make_unique<Engine>(display_manager_.get(),
-                                  escher_->GetWeakPtr());
+  auto engine =
+      std::make_unique<Engine>(display_manager_.get(), escher_->GetWeakPtr());
+  engine->session_manager()->SetUpdateThreadCount(
+      SCENIC_SESSION_UPDATE_THREADS);
+  return engine;
 }
 
 std::unique_ptr<escher::Escher> GfxSystem::InitializeEscher() {
@@ -128,8 +138,10 @@ std::unique_ptr<escher::Escher> GfxSystem::InitializeEscher() {
 
   // Initialize Escher.
   escher::GlslangInitializeProcess();
-  return std::make_unique<escher::Escher>(vulkan_device_queues_,
-                                          std::move(shader_fs));
+  auto escher = std::make_unique<escher::Escher>(vulkan_device_queues_,
+                                                 std::move(shader_fs));
+  escher->EnablePersistentShaderCache(kShaderCacheDirectory);
+  return escher;
 }
 
 fit::closure GfxSystem::DelayedInitClosure() {
@@ -165,11 +177,24 @@ void GfxSystem::Initialize() {
     }
   }
 
+  zx::time start_time = zx::clock::get_monotonic();
   escher_ = InitializeEscher();
 
   // Initialize the Scenic engine.
   engine_ = InitializeEngine();
 
+  zx::duration startup_duration = zx::clock::get_monotonic() - start_time;
+  FXL_LOG(INFO) << "Initialized Escher and the engine in "
+                << startup_duration.to_msecs() << " ms";
+  if (auto spirv_cache = escher_ ? escher_->spirv_cache() : nullptr) {
+    FXL_LOG(INFO) << "SPIR-V cache: " << spirv_cache->hit_count()
+                  << " hits, " << spirv_cache->miss_count()
+                  << " misses; pipeline cache "
+                  << (escher_->persistent_pipeline_cache()->loaded_from_file()
+                          ? "loaded"
+                          : "empty");
+  }
+
   // Create a pseudo-file that dumps alls the Scenic scenes.
   context()->app_context()->outgoing().debug_dir()->AddEntry(
       "dump-scenes",
@@ -9,6 +9,7 @@
 #include "garnet/lib/ui/gfx/engine/session.h"
 #include "garnet/lib/ui/gfx/resources/memory.h"
 #include "garnet/lib/ui/gfx/util/image_formats.h"
+#include "lib/escher/util/hasher.h"
 #include "lib/images/cpp/images.h"
 
 namespace scenic_impl {
@@ -114,21 +115,46 @@ ImagePtr HostImage::New(Session* session, ResourceId id, MemoryPtr memory,
   auto host_image = fxl::AdoptRef(new HostImage(session, id, std::move(memory),
                                                 std::move(escher_image),
                                                 memory_offset, image_info));
+  if (session->engine()->batch_gpu_uploader()) {
+    host_image->UpdateEscherImageIfDirty();
+  }
   return host_image;
 }
 
 bool HostImage::UpdatePixels() {
   TRACE_DURATION("gfx", "UpdatePixels");
 
-  // TODO(SCN-844): Migrate this over to using the batch gpu uploader.
-  if (session()->engine()->escher_gpu_uploader()) {
-    escher::image_utils::WritePixelsToImage(
-        session()->engine()->escher_gpu_uploader(),
-        static_cast<uint8_t*>(memory_->host_ptr()) + memory_offset_, image_,
-        image_conversion_function_);
+  auto* engine = session()->engine();
+  auto* batch_gpu_uploader = engine->batch_gpu_uploader();
+  auto* gpu_uploader = engine->escher_gpu_uploader();
+  if (!batch_gpu_uploader && !gpu_uploader) {
+    return true;
+  }
+
+  uint8_t* pixels = static_cast<uint8_t*>(memory_->host_ptr()) + memory_offset_;
+  // Images are hashed on every upload, so this must be much cheaper than the
+  // conversion and copy that it can save.
+  escher::Hasher hasher;
+  hasher.bytes(pixels, images::ImageSize(image_format_));
+  escher::Hash pixels_hash = hasher.value();
+  if (pixels_hash == uploaded_pixels_hash_) {
+    TRACE_INSTANT("gfx", "UpdatePixels skipped", TRACE_SCOPE_THREAD);
     return false;
   }
-  return true;
+  uploaded_pixels_hash_ = pixels_hash;
+  ++content_version_;
+
+  // Outside of RenderFrame(), fall back to an upload of its own.
+  // TODO(SCN-844): Remove the fallback once all users of the engine's
+  // impl::GpuUploader are migrated to the batch gpu uploader.
+  if (batch_gpu_uploader) {
+    escher::image_utils::WritePixelsToImage(batch_gpu_uploader, pixels, image_,
+                                            image_conversion_function_);
+  } else {
+    escher::image_utils::WritePixelsToImage(gpu_uploader, pixels, image_,
+                                            image_conversion_function_);
+  }
+  return false;
 }
 
 }  // namespace gfx
@@ -8,6 +8,7 @@
 #include "garnet/lib/ui/gfx/resources/image.h"
 #include "garnet/lib/ui/gfx/resources/memory.h"
 #include "garnet/lib/ui/gfx/resources/resource.h"
+#include "lib/escher/util/hash.h"
 #include "lib/escher/util/image_utils.h"
 #include "lib/escher/vk/image.h"
 
@@ -43,10 +44,11 @@ class HostImage : public Image {
 
   void Accept(class ResourceVisitor* visitor) override;
 
-  // Re-upload host memory contents to GPU memory. Returns true if contents were
-  // updated.
+  uint64_t content_version() override { return content_version_; }
 
  protected:
+  // Re-upload host memory contents to GPU memory, unless they are unchanged
+  // since the last upload.  Returns true if the image is still dirty.
   bool UpdatePixels() override;
 
  private:
@@ -68,6 +70,11 @@ class HostImage : public Image {
   fuchsia::images::ImageInfo image_format_;
   escher::image_utils::ImageConversionFunction image_conversion_function_ =
       nullptr;
+  // Hash of the host memory contents that were last uploaded, or invalid if
+  // nothing has been uploaded yet.
+  escher::Hash uploaded_pixels_hash_ = {0};
+  // Incremented by each upload.
+  uint64_t content_version_ = 0;
 };
 
 }  // namespace gfx
@@ -37,8 +37,7 @@ ImagePtr Image::New(Session* session, ResourceId id, MemoryPtr memory,
 }
 
 const escher::ImagePtr& Image::GetEscherImage() {
-  if (dirty_)
-    dirty_ = UpdatePixels();
+  UpdateEscherImageIfDirty();
   static const escher::ImagePtr kNullEscherImage;
   return dirty_ ? kNullEscherImage : image_;
 }
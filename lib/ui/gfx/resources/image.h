@@ -36,6 +36,13 @@ class Image : public ImageBase {
 
   const escher::ImagePtr& GetEscherImage() override;
 
+  // Updates the pixels now if the image is dirty, rather than when it is next
+  // rendered, so that the upload is batched with the other uploads of a frame.
+  void UpdateEscherImageIfDirty() {
+    if (dirty_)
+      dirty_ = UpdatePixels();
+  }
+
   // TODO(SCN-1010): Determine proper signalling for marking images as dirty.
   void MarkAsDirty() { dirty_ = true; }
 
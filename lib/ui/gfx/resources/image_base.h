@@ -19,6 +19,10 @@ class ImageBase : public Resource {
   // Returns the image that should currently be presented. Can be null.
   virtual const escher::ImagePtr& GetEscherImage() = 0;
 
+  // Returns a number that changes whenever scenic writes new content to the
+  // escher image, or 0 if its content can change without scenic knowing.
+  virtual uint64_t content_version() { return 0; }
+
  protected:
   ImageBase(Session* session, ResourceId id, const ResourceTypeInfo& type_info);
 };
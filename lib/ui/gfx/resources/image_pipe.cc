@@ -215,6 +215,11 @@ bool ImagePipe::Update(uint64_t presentation_time,
     current_image_->MarkAsDirty();
   }
   current_image_ = std::move(next_image);
+  // Upload now, along with the frame's other uploads, rather than on demand
+  // during rendering.
+  if (session()->engine()->batch_gpu_uploader()) {
+    current_image_->UpdateEscherImageIfDirty();
+  }
 
   return true;
 }
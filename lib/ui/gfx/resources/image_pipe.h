@@ -56,6 +56,10 @@ class ImagePipe : public ImageBase {
   // null.
   const escher::ImagePtr& GetEscherImage() override;
 
+  uint64_t content_version() override {
+    return current_image_ ? current_image_->content_version() : 0;
+  }
+
   // Returns true if the connection to the ImagePipe has not closed.
   bool is_valid() { return is_valid_; };
 
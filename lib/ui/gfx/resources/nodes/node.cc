@@ -86,6 +86,7 @@ bool Node::AddChild(NodePtr child_node) {
   child_node->Detach();
   child_node->SetParent(this, ParentRelation::kChild);
   children_.push_back(std::move(child_node));
+  InvalidateHitBounds();
   return true;
 }
 
@@ -105,6 +106,7 @@ bool Node::AddPart(NodePtr part_node) {
   part_node->Detach();
   part_node->SetParent(this, ParentRelation::kPart);
   parts_.push_back(std::move(part_node));
+  InvalidateHitBounds();
   return true;
 }
 
@@ -187,6 +189,7 @@ bool Node::DetachChildren() {
     view_holder->Detach();
   }
   view_holders_.clear();
+  InvalidateHitBounds();
   return true;
 }
 
@@ -203,7 +206,7 @@ bool Node::SetTransform(const escher::Transform& transform) {
     return false;
   }
   transform_ = transform;
-  InvalidateGlobalTransform();
+  InvalidateTransform();
   return true;
 }
 
@@ -217,7 +220,7 @@ bool Node::SetTranslation(const escher::vec3& translation) {
   bound_variables_.erase(NodeProperty::kTranslation);
 
   transform_.translation = translation;
-  InvalidateGlobalTransform();
+  InvalidateTransform();
   return true;
 }
 
@@ -233,7 +236,7 @@ bool Node::SetTranslation(Vector3VariablePtr translation_variable) {
       std::make_unique<Vector3VariableBinding>(translation_variable,
                                                [this](escher::vec3 value) {
                                                  transform_.translation = value;
-                                                 InvalidateGlobalTransform();
+                                                 InvalidateTransform();
                                                });
   return true;
 }
@@ -246,7 +249,7 @@ bool Node::SetScale(const escher::vec3& scale) {
   }
   bound_variables_.erase(NodeProperty::kScale);
   transform_.scale = scale;
-  InvalidateGlobalTransform();
+  InvalidateTransform();
   return true;
 }
 
@@ -260,7 +263,7 @@ bool Node::SetScale(Vector3VariablePtr scale_variable) {
       std::make_unique<Vector3VariableBinding>(scale_variable,
                                                [this](escher::vec3 value) {
                                                  transform_.scale = value;
-                                                 InvalidateGlobalTransform();
+                                                 InvalidateTransform();
                                                });
   return true;
 }
@@ -276,7 +279,7 @@ bool Node::SetRotation(const escher::quat& rotation) {
   }
   bound_variables_.erase(NodeProperty::kRotation);
   transform_.rotation = rotation;
-  InvalidateGlobalTransform();
+  InvalidateTransform();
   return true;
 }
 
@@ -291,7 +294,7 @@ bool Node::SetRotation(QuaternionVariablePtr rotation_variable) {
       std::make_unique<QuaternionVariableBinding>(rotation_variable,
                                                   [this](escher::quat value) {
                                                     transform_.rotation = value;
-                                                    InvalidateGlobalTransform();
+                                                    InvalidateTransform();
                                                   });
   return true;
 }
@@ -304,7 +307,7 @@ bool Node::SetAnchor(const escher::vec3& anchor) {
   }
   bound_variables_.erase(NodeProperty::kAnchor);
   transform_.anchor = anchor;
-  InvalidateGlobalTransform();
+  InvalidateTransform();
   return true;
 }
 
@@ -318,7 +321,7 @@ bool Node::SetAnchor(Vector3VariablePtr anchor_variable) {
       std::make_unique<Vector3VariableBinding>(anchor_variable,
                                                [this](escher::vec3 value) {
                                                  transform_.anchor = value;
-                                                 InvalidateGlobalTransform();
+                                                 InvalidateTransform();
                                                });
   return true;
 }
@@ -367,6 +370,7 @@ void Node::AddImport(Import* import) {
   delegate->parent_relation_ = ParentRelation::kImportDelegate;
 
   delegate->InvalidateGlobalTransform();
+  InvalidateHitBounds();
 }
 
 void Node::RemoveImport(Import* import) {
@@ -378,12 +382,20 @@ void Node::RemoveImport(Import* import) {
   delegate->parent_ = nullptr;
 
   delegate->InvalidateGlobalTransform();
+  InvalidateHitBounds();
 }
 
 bool Node::GetIntersection(const escher::ray4& ray, float* out_distance) const {
   return false;
 }
 
+Node::HitBounds Node::GetContentHitBounds() const { return HitBounds(); }
+
+void Node::InvalidateTransform() {
+  InvalidateGlobalTransform();
+  InvalidateHitBounds();
+}
+
 void Node::InvalidateGlobalTransform() {
   if (!global_transform_dirty_) {
     global_transform_dirty_ = true;
@@ -401,12 +413,36 @@ void Node::ComputeGlobalTransform() const {
   }
 }
 
+void Node::InvalidateHitBounds() {
+  // The ancestors of a node with dirty bounds are always dirty too, so the
+  // walk can stop at the first dirty node.
+  for (Node* node = this; node && !node->hit_bounds_dirty_;
+       node = node->parent_) {
+    node->hit_bounds_dirty_ = true;
+  }
+}
+
+void Node::ComputeHitBounds() const {
+  HitBounds bounds = GetContentHitBounds();
+  ForEachDirectDescendantFrontToBack(*this, [&bounds](Node* node) {
+    const HitBounds& descendant_bounds = node->GetHitBounds();
+    bounds.box.Join(descendant_bounds.box);
+    bounds.unbounded |= descendant_bounds.unbounded;
+  });
+
+  if (!bounds.box.is_empty() && !transform_.IsIdentity()) {
+    bounds.box = static_cast<escher::mat4>(transform_) * bounds.box;
+  }
+  hit_bounds_ = bounds;
+}
+
 void Node::EraseChild(Node* child) {
   auto it =
       std::find_if(children_.begin(), children_.end(),
                    [child](const NodePtr& ptr) { return child == ptr.get(); });
   FXL_DCHECK(it != children_.end());
   children_.erase(it);
+  InvalidateHitBounds();
 }
 
 void Node::ErasePart(Node* part) {
@@ -415,6 +451,7 @@ void Node::ErasePart(Node* part) {
                    [part](const NodePtr& ptr) { return part == ptr.get(); });
   FXL_DCHECK(it != parts_.end());
   parts_.erase(it);
+  InvalidateHitBounds();
 }
 
 void Node::DetachInternal() {
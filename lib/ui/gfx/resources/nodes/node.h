@@ -12,6 +12,7 @@
 #include "garnet/lib/ui/gfx/resources/nodes/variable_binding.h"
 #include "garnet/lib/ui/gfx/resources/resource.h"
 #include "garnet/lib/ui/gfx/resources/variable.h"
+#include "lib/escher/geometry/bounding_box.h"
 #include "lib/escher/geometry/transform.h"
 #include "lib/fxl/memory/ref_ptr.h"
 
@@ -115,6 +116,21 @@ class Node : public Resource {
   virtual bool GetIntersection(const escher::ray4& ray,
                                float* out_distance) const;
 
+  // Bounds everything in a subtree that |GetIntersection()| can hit.
+  struct HitBounds {
+    escher::BoundingBox box;
+
+    // True if some content has no bounds, so rays can't be rejected using
+    // |box|.
+    bool unbounded = false;
+  };
+
+  // Returns the hit bounds of the node and its descendants, in the coordinate
+  // system of the node's parent.  The bounds are cached, and recomputed only
+  // after the node's transform or one of its descendants has changed, so hit
+  // tests can skip the subtrees a ray misses.
+  const HitBounds& GetHitBounds() const;
+
   // Walk up tree until we find the responsible View; otherwise return nullptr.
   // N.B. Typically the view and node are in the same session, but it's possible
   // to have them inhabit different sessions.
@@ -125,6 +141,14 @@ class Node : public Resource {
   // Protected so that Scene Node can set itself as a Scene.
   Scene* scene_ = nullptr;
 
+  // Returns the hit bounds of the node's own content, excluding its
+  // descendants, in the node's coordinate system.
+  virtual HitBounds GetContentHitBounds() const;
+
+  // Marks the hit bounds of the node and its ancestors as out of date.
+  // Subclasses call this when the bounds of their content change.
+  void InvalidateHitBounds();
+
  private:
   // Describes the manner in which a node is related to its parent.
   enum class ParentRelation { kNone, kChild, kPart, kImportDelegate };
@@ -135,6 +159,11 @@ class Node : public Resource {
   void InvalidateGlobalTransform();
   void ComputeGlobalTransform() const;
 
+  // Invalidates everything that depends on |transform_|.
+  void InvalidateTransform();
+
+  void ComputeHitBounds() const;
+
   void SetParent(Node* parent, ParentRelation relation);
   void EraseChild(Node* part);
   void ErasePart(Node* part);
@@ -169,6 +198,8 @@ class Node : public Resource {
   escher::Transform transform_;
   mutable escher::mat4 global_transform_;
   mutable bool global_transform_dirty_ = true;
+  mutable HitBounds hit_bounds_;
+  mutable bool hit_bounds_dirty_ = true;
   bool clip_to_self_ = false;
   ::fuchsia::ui::gfx::HitTestBehavior hit_test_behavior_ =
       ::fuchsia::ui::gfx::HitTestBehavior::kDefault;
@@ -190,6 +221,14 @@ inline const escher::mat4& Node::GetGlobalTransform() const {
   return global_transform_;
 }
 
+inline const Node::HitBounds& Node::GetHitBounds() const {
+  if (hit_bounds_dirty_) {
+    ComputeHitBounds();
+    hit_bounds_dirty_ = false;
+  }
+  return hit_bounds_;
+}
+
 }  // namespace gfx
 }  // namespace scenic_impl
 
@@ -19,12 +19,23 @@ void ShapeNode::SetMaterial(MaterialPtr material) {
   material_ = std::move(material);
 }
 
-void ShapeNode::SetShape(ShapePtr shape) { shape_ = std::move(shape); }
+void ShapeNode::SetShape(ShapePtr shape) {
+  shape_ = std::move(shape);
+  InvalidateHitBounds();
+}
 
 bool ShapeNode::GetIntersection(const escher::ray4& ray,
                                 float* out_distance) const {
   return shape_ && shape_->GetIntersection(ray, out_distance);
 }
 
+Node::HitBounds ShapeNode::GetContentHitBounds() const {
+  HitBounds bounds;
+  if (shape_ && !shape_->GetBoundingBox(&bounds.box)) {
+    bounds.unbounded = true;
+  }
+  return bounds;
+}
+
 }  // namespace gfx
 }  // namespace scenic_impl
@@ -30,6 +30,10 @@ class ShapeNode final : public Node {
   bool GetIntersection(const escher::ray4& ray,
                        float* out_distance) const override;
 
+ protected:
+  // |Node|.
+  HitBounds GetContentHitBounds() const override;
+
  private:
   MaterialPtr material_;
   ShapePtr shape_;
@@ -20,7 +20,7 @@ Resource::Resource(Session* session, ResourceId id,
     : session_(session), id_(id), type_info_(type_info) {
   FXL_DCHECK(session);
   FXL_DCHECK(type_info.IsKindOf(Resource::kTypeInfo));
-  session_->IncrementResourceCount();
+  session_->IncrementResourceCount(type_info_);
 }
 
 Resource::~Resource() {
@@ -30,7 +30,7 @@ Resource::~Resource() {
   if (exported_) {
     session_->engine()->resource_linker()->OnExportedResourceDestroyed(this);
   }
-  session_->DecrementResourceCount();
+  session_->DecrementResourceCount(type_info_);
 }
 
 GlobalId Resource::global_id() const { return {session_->id(), id()}; }
@@ -78,7 +78,12 @@ Resource* Resource::GetDelegate(const ResourceTypeInfo& type_info) {
   return type_info_.IsKindOf(type_info) ? this : nullptr;
 }
 
-void Resource::SetExported(bool exported) { exported_ = exported; }
+void Resource::SetExported(bool exported) {
+  if (exported_ != exported) {
+    exported_ = exported;
+    session_->SetResourceExported(exported);
+  }
+}
 
 }  // namespace gfx
 }  // namespace scenic_impl
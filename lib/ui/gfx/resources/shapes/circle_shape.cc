@@ -19,6 +19,11 @@ bool CircleShape::ContainsPoint(const escher::vec2& point) const {
   return point.x * point.x + point.y * point.y <= radius_ * radius_;
 }
 
+bool CircleShape::GetBoundingBox(escher::BoundingBox* out_box) const {
+  *out_box = CenteredBoundingBox(2.f * radius_, 2.f * radius_);
+  return true;
+}
+
 escher::Object CircleShape::GenerateRenderObject(
     const escher::mat4& transform, const escher::MaterialPtr& material) {
   return escher::Object::NewCircle(transform, radius_, material);
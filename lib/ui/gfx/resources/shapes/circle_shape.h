@@ -24,6 +24,9 @@ class CircleShape final : public PlanarShape {
   // |PlanarShape|.
   bool ContainsPoint(const escher::vec2& point) const override;
 
+  // |Shape|.
+  bool GetBoundingBox(escher::BoundingBox* out_box) const override;
+
   // |Shape|.
   escher::Object GenerateRenderObject(
       const escher::mat4& transform,
@@ -11,6 +11,13 @@ PlanarShape::PlanarShape(Session* session, ResourceId id,
                          const ResourceTypeInfo& type_info)
     : Shape(session, id, type_info) {}
 
+// static
+escher::BoundingBox PlanarShape::CenteredBoundingBox(float width,
+                                                     float height) {
+  const escher::vec3 extent(0.5f * width, 0.5f * height, 0.f);
+  return escher::BoundingBox::NewChecked(-extent, extent, 1);
+}
+
 bool PlanarShape::GetIntersection(const escher::ray4& ray,
                                   float* out_distance) const {
   // Reject if the ray origin is behind the Z=0 plane.
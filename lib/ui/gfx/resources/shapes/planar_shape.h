@@ -25,6 +25,10 @@ class PlanarShape : public Shape {
  protected:
   PlanarShape(Session* session, ResourceId id,
               const ResourceTypeInfo& type_info);
+
+  // Returns the bounds of a shape of the given size centered at the origin
+  // of the Z=0 plane.
+  static escher::BoundingBox CenteredBoundingBox(float width, float height);
 };
 
 }  // namespace gfx
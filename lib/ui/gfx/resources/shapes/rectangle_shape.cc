@@ -21,6 +21,11 @@ bool RectangleShape::ContainsPoint(const escher::vec2& point) const {
   return pt.x >= 0.f && pt.y >= 0.f && pt.x <= width_ && pt.y <= height_;
 }
 
+bool RectangleShape::GetBoundingBox(escher::BoundingBox* out_box) const {
+  *out_box = CenteredBoundingBox(width_, height_);
+  return true;
+}
+
 escher::Object RectangleShape::GenerateRenderObject(
     const escher::mat4& transform, const escher::MaterialPtr& material) {
   // Scale Escher's built-in rect mesh to have bounds (0,0),(width,height), then
@@ -25,6 +25,11 @@ bool RoundedRectangleShape::ContainsPoint(const escher::vec2& point) const {
   return spec_.ContainsPoint(point);
 }
 
+bool RoundedRectangleShape::GetBoundingBox(escher::BoundingBox* out_box) const {
+  *out_box = CenteredBoundingBox(spec_.width, spec_.height);
+  return true;
+}
+
 escher::Object RoundedRectangleShape::GenerateRenderObject(
     const escher::mat4& transform, const escher::MaterialPtr& material) {
   return escher::Object(transform, mesh_, material);
@@ -6,6 +6,7 @@
 #define GARNET_LIB_UI_GFX_RESOURCES_SHAPES_SHAPE_H_
 
 #include "garnet/lib/ui/gfx/resources/resource.h"
+#include "lib/escher/geometry/bounding_box.h"
 #include "lib/escher/geometry/types.h"
 #include "lib/escher/scene/object.h"
 
@@ -27,6 +28,15 @@ class Shape : public Resource {
   virtual bool GetIntersection(const escher::ray4& ray,
                                float* out_distance) const = 0;
 
+  // Sets |out_box| to a box which contains every intersection that
+  // |GetIntersection()| can report.
+  //
+  // Returns false if the shape has no such bounds, for example because its
+  // geometry can change after creation.
+  virtual bool GetBoundingBox(escher::BoundingBox* out_box) const {
+    return false;
+  }
+
   // Generate an object to add to an escher::Model.
   virtual escher::Object GenerateRenderObject(
       const escher::mat4& transform, const escher::MaterialPtr& material) = 0;
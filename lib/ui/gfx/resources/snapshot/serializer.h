@@ -6,6 +6,7 @@
 #define GARNET_LIB_UI_GFX_RESOURCES_SNAPSHOT_SERIALIZER_H_
 
 #include "garnet/lib/ui/gfx/resources/snapshot/snapshot_generated.h"
+#include "lib/escher/util/hasher.h"
 #include "lib/escher/vk/buffer.h"
 
 namespace scenic_impl {
@@ -28,6 +29,34 @@ class Serializer {
   virtual ~Serializer() = default;
 
   virtual Offset<T> serialize(FlatBufferBuilder& builder) = 0;
+
+  // Adds what |serialize| writes to |hasher|, with image and buffer data
+  // represented by their |Payload::hash|.  Used to find what is unchanged
+  // between snapshots.
+  virtual void hash(escher::Hasher& hasher) = 0;
+};
+
+// Image or buffer data read back from the GPU.
+struct Payload {
+  escher::BufferPtr buffer;
+  // Number of bytes read into |buffer|, which can be larger.
+  size_t size = 0;
+  // Hash of the data, if it was computed.
+  escher::Hash hash = {0};
+  // Set in delta snapshots whose base has data with the same hash.
+  bool omitted = false;
+
+  const uint8_t* data() const { return buffer->host_ptr() + buffer->offset(); }
+
+  Offset<Vector<uint8_t>> serialize(FlatBufferBuilder& builder) const {
+    if (!buffer || omitted) {
+      return 0;
+    }
+    uint8_t* bytes = nullptr;
+    auto fb_vector = builder.CreateUninitializedVector(size, &bytes);
+    memcpy(bytes, data(), size);
+    return fb_vector;
+  }
 };
 
 class ShapeSerializer : public Serializer<void> {
@@ -41,6 +70,7 @@ class MeshSerializer : public ShapeSerializer {
   virtual Offset<void> serialize(FlatBufferBuilder& builder) override {
     return snapshot::CreateMesh(builder).Union();
   }
+  virtual void hash(escher::Hasher& hasher) override { hasher.u32(type()); }
 };
 
 class CircleSerializer : public ShapeSerializer {
@@ -51,6 +81,10 @@ class CircleSerializer : public ShapeSerializer {
   virtual Offset<void> serialize(FlatBufferBuilder& builder) override {
     return snapshot::CreateCircle(builder, radius).Union();
   }
+  virtual void hash(escher::Hasher& hasher) override {
+    hasher.u32(type());
+    hasher.f32(radius);
+  }
 };
 
 class RectangleSerializer : public ShapeSerializer {
@@ -61,6 +95,11 @@ class RectangleSerializer : public ShapeSerializer {
   virtual Offset<void> serialize(FlatBufferBuilder& builder) override {
     return snapshot::CreateRectangle(builder, width, height).Union();
   }
+  virtual void hash(escher::Hasher& hasher) override {
+    hasher.u32(type());
+    hasher.f32(width);
+    hasher.f32(height);
+  }
 };
 
 class RoundedRectangleSerializer : public ShapeSerializer {
@@ -81,37 +120,50 @@ class RoundedRectangleSerializer : public ShapeSerializer {
                bottom_right_radius, bottom_left_radius)
         .Union();
   }
+  virtual void hash(escher::Hasher& hasher) override {
+    hasher.u32(type());
+    hasher.f32(width);
+    hasher.f32(height);
+    hasher.f32(top_left_radius);
+    hasher.f32(top_right_radius);
+    hasher.f32(bottom_right_radius);
+    hasher.f32(bottom_left_radius);
+  }
 };
 
 class AttributeBufferSerializer : public Serializer<snapshot::AttributeBuffer> {
  public:
   int vertex_count;
   int stride;
-  escher::BufferPtr buffer;
+  Payload payload;
 
   virtual Offset<snapshot::AttributeBuffer> serialize(
       FlatBufferBuilder& builder) override {
-    uint8_t* bytes = nullptr;
-    auto fb_buffer = builder.CreateUninitializedVector(buffer->size(), &bytes);
-    memcpy(bytes, buffer->host_ptr() + buffer->offset(), buffer->size());
-
+    auto fb_buffer = payload.serialize(builder);
     return snapshot::CreateAttributeBuffer(builder, fb_buffer, vertex_count,
-                                           stride);
+                                           stride, payload.hash.val);
+  }
+  virtual void hash(escher::Hasher& hasher) override {
+    hasher.i32(vertex_count);
+    hasher.i32(stride);
+    hasher.u64(payload.hash.val);
   }
 };
 
 class IndexBufferSerializer : public Serializer<snapshot::IndexBuffer> {
  public:
   int index_count;
-  escher::BufferPtr buffer;
+  Payload payload;
 
   virtual Offset<snapshot::IndexBuffer> serialize(
       FlatBufferBuilder& builder) override {
-    uint8_t* bytes = nullptr;
-    auto fb_buffer = builder.CreateUninitializedVector(buffer->size(), &bytes);
-    memcpy(bytes, buffer->host_ptr() + buffer->offset(), buffer->size());
-
-    return snapshot::CreateIndexBuffer(builder, fb_buffer, index_count);
+    auto fb_buffer = payload.serialize(builder);
+    return snapshot::CreateIndexBuffer(builder, fb_buffer, index_count,
+                                       payload.hash.val);
+  }
+  virtual void hash(escher::Hasher& hasher) override {
+    hasher.i32(index_count);
+    hasher.u64(payload.hash.val);
   }
 };
 
@@ -134,11 +186,28 @@ class GeometrySerializer : public Serializer<snapshot::Geometry> {
     return snapshot::CreateGeometry(builder, fb_attributes, fb_indices,
                                     &bbox_min, &bbox_max);
   }
+  virtual void hash(escher::Hasher& hasher) override {
+    indices->hash(hasher);
+    hasher.u32(attributes.size());
+    for (auto& attribute : attributes) {
+      attribute->hash(hasher);
+    }
+    hasher.struc(bbox_min);
+    hasher.struc(bbox_max);
+  }
+
+  void AppendPayloads(std::vector<Payload*>* payloads) {
+    payloads->push_back(&indices->payload);
+    for (auto& attribute : attributes) {
+      payloads->push_back(&attribute->payload);
+    }
+  }
 };
 
 class MaterialSerializer : public Serializer<void> {
  public:
   virtual snapshot::Material type() = 0;
+  virtual Payload* payload() { return nullptr; }
 };
 
 class ColorSerializer : public MaterialSerializer {
@@ -151,23 +220,37 @@ class ColorSerializer : public MaterialSerializer {
   virtual Offset<void> serialize(FlatBufferBuilder& builder) override {
     return snapshot::CreateColor(builder, red, green, blue, alpha).Union();
   }
+  virtual void hash(escher::Hasher& hasher) override {
+    hasher.u32(type());
+    hasher.f32(red);
+    hasher.f32(green);
+    hasher.f32(blue);
+    hasher.f32(alpha);
+  }
 };
 
 class ImageSerializer : public MaterialSerializer {
  public:
   int32_t format, width, height;
-  escher::BufferPtr buffer;
+  Payload image_payload;
 
   virtual snapshot::Material type() override {
     return snapshot::Material_Image;
   }
   virtual Offset<void> serialize(FlatBufferBuilder& builder) override {
-    uint8_t* bytes = nullptr;
-    auto data = builder.CreateUninitializedVector(buffer->size(), &bytes);
-    memcpy(bytes, buffer->host_ptr() + buffer->offset(), buffer->size());
-
-    return snapshot::CreateImage(builder, format, width, height, data).Union();
+    auto data = image_payload.serialize(builder);
+    return snapshot::CreateImage(builder, format, width, height, data,
+                                 image_payload.hash.val)
+        .Union();
+  }
+  virtual void hash(escher::Hasher& hasher) override {
+    hasher.u32(type());
+    hasher.i32(format);
+    hasher.i32(width);
+    hasher.i32(height);
+    hasher.u64(image_payload.hash.val);
   }
+  virtual Payload* payload() override { return &image_payload; }
 };
 
 class TransformSerializer : public Serializer<snapshot::Transform> {
@@ -182,6 +265,12 @@ class TransformSerializer : public Serializer<snapshot::Transform> {
     return snapshot::CreateTransform(builder, &translation, &scale, &rotation,
                                      &anchor);
   }
+  virtual void hash(escher::Hasher& hasher) override {
+    hasher.struc(translation);
+    hasher.struc(scale);
+    hasher.struc(rotation);
+    hasher.struc(anchor);
+  }
 };
 
 class NodeSerializer : public Serializer<snapshot::Node> {
@@ -195,8 +284,17 @@ class NodeSerializer : public Serializer<snapshot::Node> {
 
   std::vector<std::shared_ptr<NodeSerializer>> children;
 
+  // Identifies the node across snapshots.
+  uint64_t id = 0;
+  // Set by |SnapshotCache| for delta snapshots.
+  snapshot::NodeDelta delta = snapshot::NodeDelta_Full;
+
   virtual Offset<snapshot::Node> serialize(
       FlatBufferBuilder& builder) override {
+    if (delta != snapshot::NodeDelta_Full) {
+      return SerializeDelta(builder);
+    }
+
     auto fb_name = name.length() ? builder.CreateString(name) : 0;
     auto fb_transform = transform ? transform->serialize(builder) : 0;
 
@@ -219,7 +317,56 @@ class NodeSerializer : public Serializer<snapshot::Node> {
 
     return snapshot::CreateNode(builder, fb_name, fb_transform, fb_shape_type,
                                 fb_shape, fb_mesh, fb_material_type,
-                                fb_material, fb_children);
+                                fb_material, fb_children, id);
+  }
+
+  // Hashes the content of the node, but not its children.
+  virtual void hash(escher::Hasher& hasher) override {
+    hasher.string(name);
+    hasher.u32(transform != nullptr);
+    if (transform) {
+      transform->hash(hasher);
+    }
+    hasher.u32(shape != nullptr);
+    if (shape) {
+      shape->hash(hasher);
+    }
+    hasher.u32(mesh != nullptr);
+    if (mesh) {
+      mesh->hash(hasher);
+    }
+    hasher.u32(material != nullptr);
+    if (material) {
+      material->hash(hasher);
+    }
+  }
+
+  // Appends the image and buffer data of the node, but not of its children.
+  void AppendPayloads(std::vector<Payload*>* payloads) {
+    if (mesh) {
+      mesh->AppendPayloads(payloads);
+    }
+    if (material && material->payload()) {
+      payloads->push_back(material->payload());
+    }
+  }
+
+ private:
+  Offset<snapshot::Node> SerializeDelta(FlatBufferBuilder& builder) {
+    Offset<Vector<Offset<snapshot::Node>>> fb_children = 0;
+    if (delta == snapshot::NodeDelta_SameContent && !children.empty()) {
+      std::vector<Offset<snapshot::Node>> child_vector;
+      for (auto& child : children) {
+        child_vector.push_back(child->serialize(builder));
+      }
+      fb_children = builder.CreateVector(child_vector);
+    }
+
+    snapshot::NodeBuilder node_builder(builder);
+    node_builder.add_children(fb_children);
+    node_builder.add_id(id);
+    node_builder.add_delta(delta);
+    return node_builder.Finish();
   }
 };
 
@@ -237,6 +384,12 @@ class SceneSerializer : public Serializer<snapshot::Scene> {
     return snapshot::CreateScene(builder, &camera,
                                  builder.CreateVector(nodes_vector));
   }
+  virtual void hash(escher::Hasher& hasher) override {
+    hasher.struc(camera);
+    for (auto& node : nodes) {
+      node->hash(hasher);
+    }
+  }
 };
 
 class ScenesSerializer : public Serializer<snapshot::Scenes> {
@@ -251,6 +404,11 @@ class ScenesSerializer : public Serializer<snapshot::Scenes> {
     }
     return snapshot::CreateScenes(builder, builder.CreateVector(scenes_vector));
   }
+  virtual void hash(escher::Hasher& hasher) override {
+    for (auto& scene : scenes) {
+      scene->hash(hasher);
+    }
+  }
 };
 
 }  // namespace gfx
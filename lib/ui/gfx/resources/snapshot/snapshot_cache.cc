@@ -0,0 +1,117 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/lib/ui/gfx/resources/snapshot/snapshot_cache.h"
+
+#include "lib/escher/util/trace_macros.h"
+#include "lib/fxl/logging.h"
+
+namespace scenic_impl {
+namespace gfx {
+
+SnapshotCache::SnapshotCache() = default;
+
+SnapshotCache::~SnapshotCache() = default;
+
+const Payload* SnapshotCache::FindPayload(uint64_t uid,
+                                          uint64_t content_version) {
+  if (content_version == 0) {
+    return nullptr;
+  }
+  auto it = payloads_.find(uid);
+  if (it == payloads_.end() ||
+      it->second.content_version != content_version) {
+    return nullptr;
+  }
+  it->second.used = true;
+  return &it->second.payload;
+}
+
+void SnapshotCache::AddPayload(uint64_t uid, uint64_t content_version,
+                               Payload payload) {
+  if (content_version == 0) {
+    return;
+  }
+  FXL_DCHECK(payload.hash.IsValid());
+  payload.omitted = false;
+  payloads_[uid] = {content_version, std::move(payload), true};
+}
+
+bool SnapshotCache::MarkUnchanged(NodeSerializer* root) {
+  TRACE_DURATION("gfx", "SnapshotCache::MarkUnchanged");
+  FXL_DCHECK(root);
+
+  pending_nodes_.clear();
+  pending_payloads_.clear();
+  MarkNode(root, &pending_nodes_, &pending_payloads_);
+  return has_base_;
+}
+
+void SnapshotCache::CommitBase() {
+  has_base_ = true;
+  base_nodes_ = std::move(pending_nodes_);
+  base_payloads_ = std::move(pending_payloads_);
+  pending_nodes_.clear();
+  pending_payloads_.clear();
+
+  // Drop the readbacks that this snapshot didn't use.
+  for (auto it = payloads_.begin(); it != payloads_.end();) {
+    if (it->second.used) {
+      it->second.used = false;
+      ++it;
+    } else {
+      it = payloads_.erase(it);
+    }
+  }
+}
+
+void SnapshotCache::Reset() {
+  has_base_ = false;
+  base_nodes_.clear();
+  base_payloads_.clear();
+  pending_nodes_.clear();
+  pending_payloads_.clear();
+  payloads_.clear();
+}
+
+escher::Hash SnapshotCache::MarkNode(
+    NodeSerializer* node, std::unordered_map<uint64_t, NodeHashes>* nodes,
+    std::unordered_set<uint64_t>* payloads) {
+  escher::Hasher content_hasher;
+  node->hash(content_hasher);
+  const escher::Hash content = content_hasher.value();
+
+  escher::Hasher subtree_hasher(content);
+  for (auto& child : node->children) {
+    subtree_hasher.u64(child->id);
+    subtree_hasher.u64(MarkNode(child.get(), nodes, payloads).val);
+  }
+  const escher::Hash subtree = subtree_hasher.value();
+  nodes->insert({node->id, {content, subtree}});
+
+  std::vector<Payload*> node_payloads;
+  node->AppendPayloads(&node_payloads);
+  for (Payload* payload : node_payloads) {
+    payloads->insert(payload->hash.val);
+  }
+
+  if (!has_base_) {
+    return subtree;
+  }
+  auto it = base_nodes_.find(node->id);
+  if (it != base_nodes_.end() && it->second.subtree == subtree) {
+    node->delta = snapshot::NodeDelta_SameSubtree;
+  } else if (it != base_nodes_.end() && it->second.content == content) {
+    node->delta = snapshot::NodeDelta_SameContent;
+  } else {
+    // The reader can take the data from the base instead.
+    for (Payload* payload : node_payloads) {
+      payload->omitted = base_payloads_.count(payload->hash.val) > 0;
+    }
+  }
+  return subtree;
+}
+
+}  // namespace gfx
+}  // namespace scenic_impl
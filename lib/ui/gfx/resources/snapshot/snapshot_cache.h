@@ -0,0 +1,82 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GARNET_LIB_UI_GFX_RESOURCES_SNAPSHOT_SNAPSHOT_CACHE_H_
+#define GARNET_LIB_UI_GFX_RESOURCES_SNAPSHOT_SNAPSHOT_CACHE_H_
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "garnet/lib/ui/gfx/resources/snapshot/serializer.h"
+#include "lib/fxl/macros.h"
+
+namespace scenic_impl {
+namespace gfx {
+
+// Carries state from one snapshot of a branch of the scene graph to the next,
+// so that each snapshot after the first can be a delta of the previous one
+// (see snapshot.fbs).  GPU content that is known to be unchanged is not read
+// back again, and nodes and data that are unchanged are left out of the delta.
+// |SnapshotReader| rebuilds full snapshots from the deltas.
+class SnapshotCache {
+ public:
+  SnapshotCache();
+  ~SnapshotCache();
+
+  // Returns the data read back from the GPU resource with |uid| for the
+  // previous snapshot, if its |content_version| is the same.  Resources whose
+  // content can change without scenic knowing have a |content_version| of 0,
+  // and are always read back.
+  const Payload* FindPayload(uint64_t uid, uint64_t content_version);
+  void AddPayload(uint64_t uid, uint64_t content_version, Payload payload);
+
+  // Marks what is unchanged in the hierarchy of |root| since the base
+  // snapshot.  Returns false if there is no base, and the snapshot is full.
+  // Call CommitBase() once the snapshot has been delivered, to make |root| the
+  // base of the next one, or Reset() if it couldn't be.
+  bool MarkUnchanged(NodeSerializer* root);
+  void CommitBase();
+
+  // Forgets the base and all readbacks, so that the next snapshot is full.
+  // Called when a snapshot is lost, since the reader couldn't apply deltas of
+  // it.
+  void Reset();
+
+ private:
+  struct NodeHashes {
+    escher::Hash content;
+    // Covers the content of the node and of all of its descendants.
+    escher::Hash subtree;
+  };
+
+  struct CachedPayload {
+    uint64_t content_version;
+    Payload payload;
+    // Whether the payload was used by the snapshot being taken.
+    bool used;
+  };
+
+  // Returns the subtree hash of |node|.  Adds the hashes of |node| and its
+  // descendants to |nodes|, and their payload hashes to |payloads|.
+  escher::Hash MarkNode(NodeSerializer* node,
+                        std::unordered_map<uint64_t, NodeHashes>* nodes,
+                        std::unordered_set<uint64_t>* payloads);
+
+  bool has_base_ = false;
+  std::unordered_map<uint64_t, NodeHashes> base_nodes_;
+  std::unordered_set<uint64_t> base_payloads_;
+  // Set by MarkUnchanged(), and made the base by CommitBase().
+  std::unordered_map<uint64_t, NodeHashes> pending_nodes_;
+  std::unordered_set<uint64_t> pending_payloads_;
+  // Keyed by the uid of the escher resource that was read back.
+  std::unordered_map<uint64_t, CachedPayload> payloads_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(SnapshotCache);
+};
+
+}  // namespace gfx
+}  // namespace scenic_impl
+
+#endif  // GARNET_LIB_UI_GFX_RESOURCES_SNAPSHOT_SNAPSHOT_CACHE_H_
@@ -0,0 +1,267 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/lib/ui/gfx/resources/snapshot/snapshot_reader.h"
+
+#include <cstddef>
+
+#include "garnet/lib/ui/gfx/resources/snapshot/version.h"
+#include "lib/escher/util/trace_macros.h"
+#include "lib/fxl/logging.h"
+
+namespace scenic_impl {
+namespace gfx {
+
+using flatbuffers::Offset;
+
+SnapshotReader::SnapshotReader() = default;
+
+SnapshotReader::~SnapshotReader() = default;
+
+bool SnapshotReader::Apply(const uint8_t* bytes, size_t size) {
+  TRACE_DURATION("gfx", "SnapshotReader::Apply");
+  const size_t header_size = offsetof(SnapshotData, data);
+  if (size <= header_size) {
+    FXL_LOG(WARNING) << "Snapshot is too small: " << size;
+    return false;
+  }
+  auto snapshot = reinterpret_cast<const SnapshotData*>(bytes);
+  if (snapshot->version != SnapshotData::SnapshotVersion::v1_0) {
+    FXL_LOG(WARNING) << "Unsupported snapshot version: " << snapshot->version;
+    return false;
+  }
+  if (snapshot->type != SnapshotData::SnapshotType::kFlatBuffer &&
+      snapshot->type != SnapshotData::SnapshotType::kFlatBufferDelta) {
+    FXL_LOG(WARNING) << "Unsupported snapshot type: " << snapshot->type;
+    return false;
+  }
+
+  const uint8_t* data = snapshot->data;
+  size -= header_size;
+  flatbuffers::Verifier verifier(data, size);
+  if (!verifier.VerifyBuffer<snapshot::Node>(nullptr)) {
+    FXL_LOG(WARNING) << "Snapshot is not a valid flatbuffer.";
+    return false;
+  }
+
+  if (snapshot->type == SnapshotData::SnapshotType::kFlatBuffer) {
+    SetFlatbuffer(std::vector<uint8_t>(data, data + size));
+    return true;
+  }
+
+  if (!root()) {
+    FXL_LOG(WARNING) << "Delta snapshot has no base.";
+    return false;
+  }
+  Builder builder;
+  missing_ = false;
+  auto fb_root = BuildNode(builder, flatbuffers::GetRoot<snapshot::Node>(data));
+  if (missing_) {
+    FXL_LOG(WARNING) << "Delta snapshot doesn't match its base.";
+    return false;
+  }
+  builder.Finish(fb_root);
+  SetFlatbuffer(std::vector<uint8_t>(
+      builder.GetBufferPointer(),
+      builder.GetBufferPointer() + builder.GetSize()));
+  return true;
+}
+
+const snapshot::Node* SnapshotReader::root() const {
+  return flatbuffer_.empty()
+             ? nullptr
+             : flatbuffers::GetRoot<snapshot::Node>(flatbuffer_.data());
+}
+
+Offset<snapshot::Node> SnapshotReader::BuildNode(Builder& builder,
+                                                 const snapshot::Node* node) {
+  const snapshot::Node* base = nullptr;
+  if (node->delta() != snapshot::NodeDelta_Full) {
+    auto it = nodes_.find(node->id());
+    if (it == nodes_.end()) {
+      missing_ = true;
+      return 0;
+    }
+    base = it->second;
+  }
+  if (node->delta() == snapshot::NodeDelta_SameSubtree) {
+    return CopySubtree(builder, base);
+  }
+
+  std::vector<Offset<snapshot::Node>> children;
+  if (node->children()) {
+    for (auto child : *node->children()) {
+      children.push_back(BuildNode(builder, child));
+    }
+  }
+  return CopyNode(builder, base ? base : node, children);
+}
+
+Offset<snapshot::Node> SnapshotReader::CopyNode(
+    Builder& builder, const snapshot::Node* content,
+    const std::vector<Offset<snapshot::Node>>& children) {
+  auto fb_name =
+      content->name() ? builder.CreateString(content->name()->str()) : 0;
+
+  Offset<snapshot::Transform> fb_transform = 0;
+  if (auto transform = content->transform()) {
+    fb_transform = snapshot::CreateTransform(
+        builder, transform->translation(), transform->scale(),
+        transform->rotation(), transform->anchor());
+  }
+
+  auto fb_shape = CopyShape(builder, content);
+  auto fb_mesh = content->mesh() ? CopyGeometry(builder, content->mesh()) : 0;
+  auto fb_material = CopyMaterial(builder, content);
+  auto fb_children = children.size() ? builder.CreateVector(children) : 0;
+
+  return snapshot::CreateNode(builder, fb_name, fb_transform,
+                              content->shape_type(), fb_shape, fb_mesh,
+                              content->material_type(), fb_material,
+                              fb_children, content->id());
+}
+
+Offset<snapshot::Node> SnapshotReader::CopySubtree(Builder& builder,
+                                                   const snapshot::Node* node) {
+  std::vector<Offset<snapshot::Node>> children;
+  if (node->children()) {
+    for (auto child : *node->children()) {
+      children.push_back(CopySubtree(builder, child));
+    }
+  }
+  return CopyNode(builder, node, children);
+}
+
+Offset<snapshot::Geometry> SnapshotReader::CopyGeometry(
+    Builder& builder, const snapshot::Geometry* geometry) {
+  Offset<snapshot::IndexBuffer> fb_indices = 0;
+  if (auto indices = geometry->indices()) {
+    auto fb_buffer = CopyData(builder, indices->buffer(), indices->hash());
+    fb_indices = snapshot::CreateIndexBuffer(
+        builder, fb_buffer, indices->index_count(), indices->hash());
+  }
+
+  std::vector<Offset<snapshot::AttributeBuffer>> attributes;
+  if (geometry->attributes()) {
+    for (auto attribute : *geometry->attributes()) {
+      auto fb_buffer =
+          CopyData(builder, attribute->buffer(), attribute->hash());
+      attributes.push_back(snapshot::CreateAttributeBuffer(
+          builder, fb_buffer, attribute->vertex_count(), attribute->stride(),
+          attribute->hash()));
+    }
+  }
+  auto fb_attributes = builder.CreateVector(attributes);
+
+  return snapshot::CreateGeometry(builder, fb_attributes, fb_indices,
+                                  geometry->bbox_min(), geometry->bbox_max());
+}
+
+Offset<void> SnapshotReader::CopyShape(Builder& builder,
+                                       const snapshot::Node* node) {
+  switch (node->shape_type()) {
+    case snapshot::Shape_NONE:
+      return 0;
+    case snapshot::Shape_Mesh:
+      return snapshot::CreateMesh(builder).Union();
+    case snapshot::Shape_Circle: {
+      auto shape = static_cast<const snapshot::Circle*>(node->shape());
+      return snapshot::CreateCircle(builder, shape->radius()).Union();
+    }
+    case snapshot::Shape_Rectangle: {
+      auto shape = static_cast<const snapshot::Rectangle*>(node->shape());
+      return snapshot::CreateRectangle(builder, shape->width(),
+                                       shape->height())
+          .Union();
+    }
+    case snapshot::Shape_RoundedRectangle: {
+      auto shape =
+          static_cast<const snapshot::RoundedRectangle*>(node->shape());
+      return snapshot::CreateRoundedRectangle(
+                 builder, shape->width(), shape->height(),
+                 shape->top_left_radius(), shape->top_right_radius(),
+                 shape->bottom_right_radius(), shape->bottom_left_radius())
+          .Union();
+    }
+  }
+  return 0;
+}
+
+Offset<void> SnapshotReader::CopyMaterial(Builder& builder,
+                                          const snapshot::Node* node) {
+  switch (node->material_type()) {
+    case snapshot::Material_NONE:
+      return 0;
+    case snapshot::Material_Color: {
+      auto color = static_cast<const snapshot::Color*>(node->material());
+      return snapshot::CreateColor(builder, color->red(), color->green(),
+                                   color->blue(), color->alpha())
+          .Union();
+    }
+    case snapshot::Material_Image: {
+      auto image = static_cast<const snapshot::Image*>(node->material());
+      auto fb_data = CopyData(builder, image->data(), image->hash());
+      return snapshot::CreateImage(builder, image->format(), image->width(),
+                                   image->height(), fb_data, image->hash())
+          .Union();
+    }
+  }
+  return 0;
+}
+
+Offset<flatbuffers::Vector<uint8_t>> SnapshotReader::CopyData(
+    Builder& builder, const flatbuffers::Vector<uint8_t>* data,
+    uint64_t hash) {
+  if (!data && hash) {
+    auto it = data_.find(hash);
+    if (it == data_.end()) {
+      missing_ = true;
+      return 0;
+    }
+    data = it->second;
+  }
+  return data ? builder.CreateVector(data->data(), data->size()) : 0;
+}
+
+void SnapshotReader::SetFlatbuffer(std::vector<uint8_t> flatbuffer) {
+  flatbuffer_ = std::move(flatbuffer);
+  nodes_.clear();
+  data_.clear();
+  IndexNode(root());
+}
+
+void SnapshotReader::IndexNode(const snapshot::Node* node) {
+  nodes_[node->id()] = node;
+
+  if (auto mesh = node->mesh()) {
+    if (auto indices = mesh->indices()) {
+      IndexData(indices->buffer(), indices->hash());
+    }
+    if (mesh->attributes()) {
+      for (auto attribute : *mesh->attributes()) {
+        IndexData(attribute->buffer(), attribute->hash());
+      }
+    }
+  }
+  if (node->material_type() == snapshot::Material_Image) {
+    auto image = static_cast<const snapshot::Image*>(node->material());
+    IndexData(image->data(), image->hash());
+  }
+
+  if (node->children()) {
+    for (auto child : *node->children()) {
+      IndexNode(child);
+    }
+  }
+}
+
+void SnapshotReader::IndexData(const flatbuffers::Vector<uint8_t>* data,
+                               uint64_t hash) {
+  if (data && hash) {
+    data_[hash] = data;
+  }
+}
+
+}  // namespace gfx
+}  // namespace scenic_impl
@@ -0,0 +1,81 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GARNET_LIB_UI_GFX_RESOURCES_SNAPSHOT_SNAPSHOT_READER_H_
+#define GARNET_LIB_UI_GFX_RESOURCES_SNAPSHOT_SNAPSHOT_READER_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "garnet/lib/ui/gfx/resources/snapshot/snapshot_generated.h"
+#include "lib/fxl/macros.h"
+
+namespace scenic_impl {
+namespace gfx {
+
+// Rebuilds full snapshots from a sequence of snapshots taken with a
+// |SnapshotCache|: the first is full, and each of the others is a delta of the
+// one before it.  The rebuilt snapshot has the same layout as a full one.
+class SnapshotReader {
+ public:
+  SnapshotReader();
+  ~SnapshotReader();
+
+  // Applies a snapshot in the format of |SnapshotData|, either replacing the
+  // current snapshot or updating it with a delta.  Returns false, leaving the
+  // current snapshot unchanged, if the snapshot is invalid or refers to
+  // something that the current snapshot doesn't have.
+  bool Apply(const uint8_t* bytes, size_t size);
+
+  // Returns the root node of the current snapshot, or null if there is none.
+  const snapshot::Node* root() const;
+
+  // The flatbuffer of the current snapshot.
+  const std::vector<uint8_t>& flatbuffer() const { return flatbuffer_; }
+
+ private:
+  using Builder = flatbuffers::FlatBufferBuilder;
+
+  // Builds |node| of a delta, using the current snapshot for what it omits.
+  // Returns 0 if something is missing.
+  flatbuffers::Offset<snapshot::Node> BuildNode(Builder& builder,
+                                                const snapshot::Node* node);
+  // Copies the content of |content| with the given |children|.
+  flatbuffers::Offset<snapshot::Node> CopyNode(
+      Builder& builder, const snapshot::Node* content,
+      const std::vector<flatbuffers::Offset<snapshot::Node>>& children);
+  // Copies |node| and all of its descendants.
+  flatbuffers::Offset<snapshot::Node> CopySubtree(Builder& builder,
+                                                  const snapshot::Node* node);
+  flatbuffers::Offset<snapshot::Geometry> CopyGeometry(
+      Builder& builder, const snapshot::Geometry* geometry);
+  flatbuffers::Offset<void> CopyShape(Builder& builder,
+                                      const snapshot::Node* node);
+  flatbuffers::Offset<void> CopyMaterial(Builder& builder,
+                                         const snapshot::Node* node);
+  // Copies |data|, or the data with |hash| in the current snapshot if |data|
+  // was omitted.
+  flatbuffers::Offset<flatbuffers::Vector<uint8_t>> CopyData(
+      Builder& builder, const flatbuffers::Vector<uint8_t>* data,
+      uint64_t hash);
+
+  // Replaces the current snapshot and indexes its nodes and data.
+  void SetFlatbuffer(std::vector<uint8_t> flatbuffer);
+  void IndexNode(const snapshot::Node* node);
+  void IndexData(const flatbuffers::Vector<uint8_t>* data, uint64_t hash);
+
+  std::vector<uint8_t> flatbuffer_;
+  // Point into |flatbuffer_|.
+  std::unordered_map<uint64_t, const snapshot::Node*> nodes_;
+  std::unordered_map<uint64_t, const flatbuffers::Vector<uint8_t>*> data_;
+  // Set when the delta being applied refers to something missing.
+  bool missing_ = false;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(SnapshotReader);
+};
+
+}  // namespace gfx
+}  // namespace scenic_impl
+
+#endif  // GARNET_LIB_UI_GFX_RESOURCES_SNAPSHOT_SNAPSHOT_READER_H_
@@ -76,8 +76,16 @@ bool VmoFromBytes(const uint8_t* bytes, size_t num_bytes, uint32_t type,
   return true;
 }
 
-Snapshotter::Snapshotter(escher::BatchGpuUploaderPtr gpu_uploader)
-    : gpu_uploader_(gpu_uploader) {}
+namespace {
+
+// Content version of GPU resources that are never modified after creation.
+constexpr uint64_t kImmutableContentVersion = 1;
+
+}  // namespace
+
+Snapshotter::Snapshotter(escher::BatchGpuUploaderPtr gpu_uploader,
+                         std::shared_ptr<SnapshotCache> cache)
+    : gpu_uploader_(gpu_uploader), cache_(std::move(cache)) {}
 
 void Snapshotter::TakeSnapshot(Resource* resource,
                                TakeSnapshotCallback callback) {
@@ -90,17 +98,28 @@ void Snapshotter::TakeSnapshot(Resource* resource,
   gpu_uploader_->Submit(
       escher::SemaphorePtr(),
       fxl::MakeCopyable([node_serializer = current_node_serializer_,
-                         callback = std::move(callback)]() {
+                         cache = cache_, callback = std::move(callback)]() {
         TRACE_DURATION("gfx", "Snapshotter::Serialize");
+        const bool is_delta =
+            cache && cache->MarkUnchanged(node_serializer.get());
         auto builder = std::make_shared<flatbuffers::FlatBufferBuilder>();
         builder->Finish(node_serializer->serialize(*builder));
 
         fsl::SizedVmo sized_vmo;
         if (!VmoFromBytes(builder->GetBufferPointer(), builder->GetSize(),
-                          SnapshotData::SnapshotType::kFlatBuffer,
+                          is_delta
+                              ? SnapshotData::SnapshotType::kFlatBufferDelta
+                              : SnapshotData::SnapshotType::kFlatBuffer,
                           SnapshotData::SnapshotVersion::v1_0, &sized_vmo)) {
+          // The next snapshot can't be a delta of one that was never sent.
+          if (cache) {
+            cache->Reset();
+          }
           return callback(fuchsia::mem::Buffer{});
         } else {
+          if (cache) {
+            cache->CommitBase();
+          }
           return callback(std::move(sized_vmo).ToTransport());
         }
       }));
@@ -150,7 +169,8 @@ void Snapshotter::Visit(RoundedRectangleShape* r) {
 
   current_node_serializer_->shape = shape;
 
-  VisitMesh(r->escher_mesh());
+  // Rounded rectangle meshes are uploaded once, when they are created.
+  VisitMesh(r->escher_mesh(), kImmutableContentVersion);
 }
 
 void Snapshotter::Visit(MeshShape* r) {
@@ -158,7 +178,8 @@ void Snapshotter::Visit(MeshShape* r) {
 
   current_node_serializer_->shape = std::make_shared<MeshSerializer>();
 
-  VisitMesh(r->escher_mesh());
+  // The client can write to the mesh's buffers at any time.
+  VisitMesh(r->escher_mesh(), 0);
 }
 
 void Snapshotter::Visit(Material* r) {
@@ -181,14 +202,14 @@ void Snapshotter::Visit(Memory* r) { VisitResource(r); }
 
 void Snapshotter::Visit(Image* r) {
   if (r->GetEscherImage()) {
-    VisitImage(r->GetEscherImage());
+    VisitImage(r->GetEscherImage(), r->content_version());
   }
   VisitResource(r);
 }
 
 void Snapshotter::Snapshotter::Visit(ImagePipe* r) {
   if (r->GetEscherImage()) {
-    VisitImage(r->GetEscherImage());
+    VisitImage(r->GetEscherImage(), r->content_version());
   }
   VisitResource(r);
 }
@@ -222,6 +243,8 @@ void Snapshotter::VisitNode(Node* r) {
 
   // Name.
   node_serializer->name = r->label();
+  node_serializer->id = static_cast<uint64_t>(r->global_id().session_id) << 32 |
+                        r->global_id().resource_id;
 
   // Transform.
   if (!r->transform().IsIdentity()) {
@@ -272,16 +295,17 @@ void Snapshotter::VisitResource(Resource* r) {
   current_node_serializer_ = node_serializer;
 }
 
-void Snapshotter::VisitImage(escher::ImagePtr image) {
+void Snapshotter::VisitImage(escher::ImagePtr image,
+                             uint64_t content_version) {
   auto format = (int32_t)image->format();
   auto width = image->width();
   auto height = image->height();
 
-  ReadImage(image,
+  ReadImage(image, content_version,
             [format, width, height, node_serializer = current_node_serializer_](
-                escher::BufferPtr buffer) {
+                const Payload& payload) {
               auto image = std::make_shared<ImageSerializer>();
-              image->buffer = buffer;
+              image->image_payload = payload;
               image->format = format;
               image->width = width;
               image->height = height;
@@ -290,7 +314,7 @@ void Snapshotter::VisitImage(escher::ImagePtr image) {
             });
 }
 
-void Snapshotter::VisitMesh(escher::MeshPtr mesh) {
+void Snapshotter::VisitMesh(escher::MeshPtr mesh, uint64_t content_version) {
   FXL_DCHECK(current_node_serializer_);
 
   auto geometry = std::make_shared<GeometrySerializer>();
@@ -312,29 +336,40 @@ void Snapshotter::VisitMesh(escher::MeshPtr mesh) {
       continue;
     }
 
-    ReadBuffer(src_buffer, [geometry, is_index_buffer,
-                            mesh](escher::BufferPtr buffer) {
-      if (is_index_buffer) {
-        auto indices = std::make_shared<IndexBufferSerializer>();
-        indices->buffer = buffer;
-        indices->index_count = mesh->num_indices();
-
-        geometry->indices = indices;
-      } else {
-        auto attribute = std::make_shared<AttributeBufferSerializer>();
-        attribute->buffer = buffer;
-        attribute->vertex_count = mesh->num_vertices();
-        attribute->stride = mesh->spec().stride(0);
-
-        geometry->attributes.push_back(attribute);
-      }
-    });
+    // Create the serializers in order, since reused readbacks are available
+    // before the others.
+    if (is_index_buffer) {
+      auto indices = std::make_shared<IndexBufferSerializer>();
+      indices->index_count = mesh->num_indices();
+      geometry->indices = indices;
+
+      ReadBuffer(src_buffer, content_version,
+                 [indices](const Payload& payload) {
+                   indices->payload = payload;
+                 });
+    } else {
+      auto attribute = std::make_shared<AttributeBufferSerializer>();
+      attribute->vertex_count = mesh->num_vertices();
+      attribute->stride = mesh->spec().stride(0);
+      geometry->attributes.push_back(attribute);
+
+      ReadBuffer(src_buffer, content_version,
+                 [attribute](const Payload& payload) {
+                   attribute->payload = payload;
+                 });
+    }
   }
 }
 
-void Snapshotter::ReadImage(
-    escher::ImagePtr image,
-    std::function<void(escher::BufferPtr buffer)> callback) {
+void Snapshotter::ReadImage(escher::ImagePtr image, uint64_t content_version,
+                            ReadCallback callback) {
+  if (cache_) {
+    if (auto payload = cache_->FindPayload(image->uid(), content_version)) {
+      callback(*payload);
+      return;
+    }
+  }
+
   vk::BufferImageCopy region;
   region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
   region.imageSubresource.mipLevel = 0;
@@ -345,17 +380,48 @@ void Snapshotter::ReadImage(
   region.imageExtent.depth = 1;
   region.bufferOffset = image->memory_offset();
 
-  auto reader = gpu_uploader_->AcquireReader(image->memory()->size());
+  const size_t size = image->memory()->size();
+  auto reader = gpu_uploader_->AcquireReader(size);
   reader->ReadImage(image, region, escher::SemaphorePtr());
-  gpu_uploader_->PostReader(std::move(reader), std::move(callback));
+  gpu_uploader_->PostReader(
+      std::move(reader), NewReaderCallback(image->uid(), content_version, size,
+                                           std::move(callback)));
 }
 
-void Snapshotter::ReadBuffer(
-    escher::BufferPtr buffer,
-    std::function<void(escher::BufferPtr buffer)> callback) {
-  auto reader = gpu_uploader_->AcquireReader(buffer->size());
-  reader->ReadBuffer(buffer, {0, 0, buffer->size()}, escher::SemaphorePtr());
-  gpu_uploader_->PostReader(std::move(reader), std::move(callback));
+void Snapshotter::ReadBuffer(escher::BufferPtr buffer,
+                             uint64_t content_version, ReadCallback callback) {
+  if (cache_) {
+    if (auto payload = cache_->FindPayload(buffer->uid(), content_version)) {
+      callback(*payload);
+      return;
+    }
+  }
+
+  const size_t size = buffer->size();
+  auto reader = gpu_uploader_->AcquireReader(size);
+  reader->ReadBuffer(buffer, {0, 0, size}, escher::SemaphorePtr());
+  gpu_uploader_->PostReader(
+      std::move(reader), NewReaderCallback(buffer->uid(), content_version, size,
+                                           std::move(callback)));
+}
+
+std::function<void(escher::BufferPtr buffer)> Snapshotter::NewReaderCallback(
+    uint64_t uid, uint64_t content_version, size_t size,
+    ReadCallback callback) {
+  return [cache = cache_, uid, content_version, size,
+          callback = std::move(callback)](escher::BufferPtr buffer) {
+    Payload payload;
+    payload.buffer = std::move(buffer);
+    payload.size = size;
+    // Hashes are only needed to compare snapshots.
+    if (cache) {
+      escher::Hasher hasher;
+      hasher.bytes(payload.data(), size);
+      payload.hash = hasher.value();
+      cache->AddPayload(uid, content_version, payload);
+    }
+    callback(payload);
+  };
 }
 
 }  // namespace gfx
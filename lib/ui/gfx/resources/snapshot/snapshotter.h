@@ -7,6 +7,7 @@
 
 #include "garnet/lib/ui/gfx/resources/resource_visitor.h"
 #include "garnet/lib/ui/gfx/resources/snapshot/serializer.h"
+#include "garnet/lib/ui/gfx/resources/snapshot/snapshot_cache.h"
 #include "garnet/lib/ui/scenic/scenic.h"
 #include "lib/escher/renderer/batch_gpu_uploader.h"
 
@@ -23,9 +24,13 @@ using TakeSnapshotCallback = fit::function<void(::fuchsia::mem::Buffer)>;
 // It uses |Serializer| set of classes to recreate the node hierarchy while
 // visiting every entity of the scenic node. After the visit, the serializer
 // generates the flatbuffer in |TakeSnapshot|.
+//
+// With a |SnapshotCache|, every snapshot after the first one taken with the
+// cache is a delta of the previous one, of type |kFlatBufferDelta|.
 class Snapshotter : public ResourceVisitor {
  public:
-  Snapshotter(escher::BatchGpuUploaderPtr gpu_uploader);
+  Snapshotter(escher::BatchGpuUploaderPtr gpu_uploader,
+              std::shared_ptr<SnapshotCache> cache = nullptr);
   virtual ~Snapshotter() = default;
 
   // Takes the snapshot of the |node| and calls the |callback| with a
@@ -62,15 +67,24 @@ class Snapshotter : public ResourceVisitor {
  private:
   void VisitNode(Node* r);
   void VisitResource(Resource* r);
-  void VisitMesh(escher::MeshPtr mesh);
-  void VisitImage(escher::ImagePtr i);
+  // |content_version| is as described by |SnapshotCache::FindPayload|.
+  void VisitMesh(escher::MeshPtr mesh, uint64_t content_version);
+  void VisitImage(escher::ImagePtr i, uint64_t content_version);
 
-  void ReadImage(escher::ImagePtr image,
-                 std::function<void(escher::BufferPtr buffer)> callback);
-  void ReadBuffer(escher::BufferPtr buffer,
-                  std::function<void(escher::BufferPtr buffer)> callback);
+  // Reads back the contents of |image| or |buffer|, or reuses those of the
+  // previous snapshot if they are unchanged, in which case |callback| is
+  // called right away.
+  using ReadCallback = std::function<void(const Payload& payload)>;
+  void ReadImage(escher::ImagePtr image, uint64_t content_version,
+                 ReadCallback callback);
+  void ReadBuffer(escher::BufferPtr buffer, uint64_t content_version,
+                  ReadCallback callback);
+  std::function<void(escher::BufferPtr buffer)> NewReaderCallback(
+      uint64_t uid, uint64_t content_version, size_t size,
+      ReadCallback callback);
 
   escher::BatchGpuUploaderPtr gpu_uploader_;
+  std::shared_ptr<SnapshotCache> cache_;
 
   // Holds the current serializer for the scenic node being serialized. This is
   // needed when visiting node's content like mesh, material and images.
@@ -10,7 +10,7 @@ namespace gfx {
 
 // Defines the structure of a snapshot buffer.
 typedef struct {
-  enum SnapshotType { kFlatBuffer, kGLTF } type;
+  enum SnapshotType { kFlatBuffer, kGLTF, kFlatBufferDelta } type;
   enum SnapshotVersion { v1_0 = 1 } version;
   uint8_t data[];
 } SnapshotData;
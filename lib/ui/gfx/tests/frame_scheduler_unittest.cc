@@ -0,0 +1,167 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/lib/ui/gfx/engine/frame_scheduler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <lib/async/cpp/task.h>
+#include <lib/async/time.h>
+
+#include "garnet/lib/ui/gfx/displays/display.h"
+#include "garnet/lib/ui/gfx/engine/frame_timings.h"
+#include "garnet/lib/ui/gfx/engine/render_time_predictor.h"
+#include "gtest/gtest.h"
+#include "lib/gtest/test_loop_fixture.h"
+
+namespace scenic_impl {
+namespace gfx {
+namespace test {
+
+using FrameSchedulerTest = ::gtest::TestLoopFixture;
+
+constexpr zx_duration_t kMillisecond = 1'000'000;
+
+// A display whose Vsyncs follow the fake clock of the test loop.
+class FakeDisplay : public Display {
+ public:
+  FakeDisplay() : Display(0, 1024, 768) {}
+
+  bool is_test_display() const override { return true; }
+
+  // Returns the first Vsync at or after |time|, which must not be in the
+  // future.
+  zx_time_t NextVsync(zx_time_t time) {
+    const zx_time_t last_vsync_time = GetLastVsyncTime();
+    return last_vsync_time == time ? time
+                                   : last_vsync_time + GetVsyncInterval();
+  }
+};
+
+// Renders each frame in a fixed amount of time, after which |display|
+// presents it at the next Vsync.  Any number of frames can be rendered at
+// once.
+class FakeRenderer : public FrameSchedulerDelegate {
+ public:
+  struct Frame {
+    zx_time_t rendering_started_time;
+    zx_time_t target_presentation_time;
+  };
+
+  FakeRenderer(async_dispatcher_t* dispatcher, FakeDisplay* display,
+               zx_duration_t render_time)
+      : dispatcher_(dispatcher), display_(display), render_time_(render_time) {}
+
+  const std::vector<Frame>& frames() const { return frames_; }
+
+  // |FrameSchedulerDelegate|
+  bool RenderFrame(const FrameTimingsPtr& frame_timings,
+                   uint64_t presentation_time, uint64_t presentation_interval,
+                   bool force_render) override {
+    const zx_time_t now = async_now(dispatcher_);
+    frames_.push_back({now, static_cast<zx_time_t>(presentation_time)});
+
+    const size_t swapchain_index = frame_timings->AddSwapchain(nullptr);
+    async::PostTaskForTime(
+        dispatcher_,
+        [this, frame_timings, swapchain_index] {
+          const zx_time_t rendered_time = async_now(dispatcher_);
+          frame_timings->OnFrameRendered(swapchain_index, rendered_time);
+          // Frames are presented in order, possibly several at one Vsync.
+          last_presentation_time_ = std::max(
+              last_presentation_time_, display_->NextVsync(rendered_time));
+          async::PostTaskForTime(
+              dispatcher_,
+              [this, frame_timings, swapchain_index] {
+                frame_timings->OnFramePresented(swapchain_index,
+                                                async_now(dispatcher_));
+              },
+              zx::time(last_presentation_time_));
+        },
+        zx::time(now + render_time_));
+    return true;
+  }
+
+ private:
+  async_dispatcher_t* const dispatcher_;
+  FakeDisplay* const display_;
+  const zx_duration_t render_time_;
+  zx_time_t last_presentation_time_ = 0;
+  std::vector<Frame> frames_;
+};
+
+TEST(RenderTimePredictorTest, PredictsLongestRecentRenderTimePlusMargin) {
+  RenderTimePredictor predictor(3, 8 * kMillisecond, kMillisecond);
+  EXPECT_EQ(8 * kMillisecond, predictor.Predict());
+
+  predictor.AddSample(5 * kMillisecond);
+  EXPECT_EQ(6 * kMillisecond, predictor.Predict());
+  predictor.AddSample(3 * kMillisecond);
+  predictor.AddSample(2 * kMillisecond);
+  EXPECT_EQ(6 * kMillisecond, predictor.Predict());
+
+  // The slow frame leaves the window.
+  predictor.AddSample(4 * kMillisecond);
+  EXPECT_EQ(5 * kMillisecond, predictor.Predict());
+  EXPECT_EQ(3u, predictor.sample_count());
+}
+
+TEST_F(FrameSchedulerTest, WakesUpAsLateAsPredictionAllows) {
+  constexpr zx_duration_t kRenderTime = 5 * kMillisecond;
+  FakeDisplay display;
+  FakeRenderer renderer(dispatcher(), &display, kRenderTime);
+  FrameScheduler scheduler(&display);
+  scheduler.set_delegate(&renderer);
+
+  scheduler.SetRenderContinuously(true);
+  RunLoopFor(zx::sec(1));
+
+  const auto& metrics = scheduler.metrics();
+  EXPECT_GE(metrics.frames_presented, 55u);
+  EXPECT_EQ(0u, metrics.frames_missed);
+  EXPECT_EQ(0u, metrics.frames_dropped);
+
+  // Once the render time is known, rendering starts just early enough, with
+  // 1ms to spare.
+  const auto& frame = renderer.frames().back();
+  EXPECT_EQ(kRenderTime + kMillisecond,
+            frame.target_presentation_time - frame.rendering_started_time);
+  EXPECT_LE(metrics.average_latency(), 8 * kMillisecond);
+}
+
+TEST_F(FrameSchedulerTest, PipeliningKeepsFrameRateWithLongRenderTimes) {
+  // Rendering takes longer than a Vsync interval.
+  constexpr zx_duration_t kRenderTime = 25 * kMillisecond;
+
+  FrameScheduler::Metrics metrics[FrameScheduler::kMaxFramesInFlight + 1];
+  for (size_t frames_in_flight : {1u, 3u}) {
+    FakeDisplay display;
+    FakeRenderer renderer(dispatcher(), &display, kRenderTime);
+    auto scheduler =
+        std::make_unique<FrameScheduler>(&display, frames_in_flight);
+    scheduler->set_delegate(&renderer);
+
+    scheduler->SetRenderContinuously(true);
+    RunLoopFor(zx::sec(1));
+    metrics[frames_in_flight] = scheduler->metrics();
+
+    // Let the frames in flight finish before the scheduler goes away.
+    scheduler->SetRenderContinuously(false);
+    RunLoopFor(zx::msec(200));
+    scheduler.reset();
+  }
+
+  // A single frame in flight can be presented at most every other Vsync.
+  EXPECT_LE(metrics[1].frames_presented, 31u);
+
+  // With three, every Vsync gets a frame once the render time is known.
+  EXPECT_GE(metrics[3].frames_presented, 55u);
+  EXPECT_LE(metrics[3].frames_missed, 5u);
+  EXPECT_LT(metrics[3].miss_rate(), 0.1);
+}
+
+}  // namespace test
+}  // namespace gfx
+}  // namespace scenic_impl
@@ -4,6 +4,9 @@
 
 #include <math.h>
 
+#include <chrono>
+
+#include "garnet/lib/ui/gfx/engine/hit_tester.h"
 #include "garnet/lib/ui/gfx/tests/session_test.h"
 #include "garnet/lib/ui/gfx/util/unwrap.h"
 #include "lib/ui/scenic/cpp/commands.h"
@@ -296,6 +299,127 @@ TEST_F(HitTestTest, Clipping) {
               {.tag = 100, .tx = 0.f, .ty = 0.f, .tz = 0.f, .d = 8.f}});
 }
 
+TEST_F(HitTestTest, MoveNodeAwayAndBack) {
+  // Move 30 away from the ray, then back.
+  Apply(scenic::NewSetTranslationCmd(7, (float[3]){110.f, 0.f, 1.f}));
+  ExpectHits(1, vec3(12.f, 6.f, 10.f), kDownVector,
+             {{.tag = 20, .tx = -9.f, .ty = -9.f, .tz = -1.f, .d = 9.f},
+              {.tag = 25, .tx = -4.f, .ty = -4.f, .tz = 0.f, .d = 9.f},
+              {.tag = 100, .tx = 0.f, .ty = 0.f, .tz = 0.f, .d = 9.f}});
+
+  Apply(scenic::NewSetTranslationCmd(7, (float[3]){10.f, 0.f, 1.f}));
+  ExpectHits(1, vec3(12.f, 6.f, 10.f), kDownVector,
+             {{.tag = 30, .tx = -14.f, .ty = -4.f, .tz = -1.f, .d = 9.f},
+              {.tag = 35, .tx = -10.f, .ty = 0.f, .tz = -1.f, .d = 9.f},
+              {.tag = 20, .tx = -9.f, .ty = -9.f, .tz = -1.f, .d = 9.f},
+              {.tag = 25, .tx = -4.f, .ty = -4.f, .tz = 0.f, .d = 9.f},
+              {.tag = 100, .tx = 0.f, .ty = 0.f, .tz = 0.f, .d = 9.f}});
+}
+
+TEST_F(HitTestTest, GrowShape) {
+  ExpectHits(1, vec3(25.f, 25.f, 10.f), kDownVector, {});
+
+  // Give 20 a 40x40 rectangle, which reaches the ray.
+  Apply(scenic::NewCreateRectangleCmd(21, 40.f, 40.f));
+  Apply(scenic::NewSetShapeCmd(6, 21));
+  ExpectHits(1, vec3(25.f, 25.f, 10.f), kDownVector,
+             {{.tag = 20, .tx = -9.f, .ty = -9.f, .tz = -1.f, .d = 9.f},
+              {.tag = 25, .tx = -4.f, .ty = -4.f, .tz = 0.f, .d = 9.f},
+              {.tag = 100, .tx = 0.f, .ty = 0.f, .tz = 0.f, .d = 9.f}});
+}
+
+TEST_F(HitTestTest, AddChildUnderRay) {
+  ExpectHits(1, vec3(30.f, 30.f, 10.f), kDownVector, {});
+
+  Apply(scenic::NewCreateShapeNodeCmd(10));
+  Apply(scenic::NewSetTagCmd(10, 40));
+  Apply(scenic::NewSetShapeCmd(10, 20));
+  Apply(scenic::NewSetTranslationCmd(10, (float[3]){30.f, 30.f, 0.f}));
+  Apply(scenic::NewAddChildCmd(9, 10));
+  ExpectHits(1, vec3(30.f, 30.f, 10.f), kDownVector,
+             {{.tag = 40, .tx = -30.f, .ty = -30.f, .tz = 0.f, .d = 10.f},
+              {.tag = 1, .tx = 0.f, .ty = 0.f, .tz = 0.f, .d = 10.f}});
+
+  Apply(scenic::NewDetachCmd(10));
+  ExpectHits(1, vec3(30.f, 30.f, 10.f), kDownVector, {});
+}
+
+// Hit tests a scene of 10k tagged rectangles, laid out in 100 rows of 100, as
+// a pointer moves over it.  Reports the cost of each hit test, both when the
+// scene is static and when a node moves before each hit test.
+TEST_F(SessionTest, HitTestBenchmark) {
+  constexpr uint32_t kRowCount = 100;
+  constexpr uint32_t kColumnCount = 100;
+  constexpr float kSpacing = 10.f;
+  constexpr uint32_t kHitTestCount = 1000;
+  constexpr ResourceId kShapeId = 1;
+  constexpr ResourceId kRootId = 2;
+
+  Apply(scenic::NewCreateRectangleCmd(kShapeId, 8.f, 8.f));
+  Apply(scenic::NewCreateEntityNodeCmd(kRootId));
+
+  ResourceId next_id = kRootId + 1;
+  for (uint32_t row = 0; row < kRowCount; ++row) {
+    ResourceId row_id = next_id++;
+    Apply(scenic::NewCreateEntityNodeCmd(row_id));
+    Apply(scenic::NewSetTranslationCmd(row_id,
+                                       (float[3]){0.f, row * kSpacing, 0.f}));
+    Apply(scenic::NewAddChildCmd(kRootId, row_id));
+
+    for (uint32_t column = 0; column < kColumnCount; ++column) {
+      ResourceId shape_node_id = next_id++;
+      Apply(scenic::NewCreateShapeNodeCmd(shape_node_id));
+      Apply(scenic::NewSetTagCmd(shape_node_id, shape_node_id));
+      Apply(scenic::NewSetShapeCmd(shape_node_id, kShapeId));
+      Apply(scenic::NewSetTranslationCmd(
+          shape_node_id, (float[3]){column * kSpacing, 0.f, 0.f}));
+      Apply(scenic::NewAddChildCmd(row_id, shape_node_id));
+    }
+  }
+
+  auto root = FindResource<Node>(kRootId);
+  ASSERT_TRUE(root);
+
+  // Hit tests the center of a rectangle, chosen by |index|.
+  auto hit_test = [this, &root](uint32_t index) {
+    float x = (index % kColumnCount) * kSpacing;
+    float y = (index * 7 % kRowCount) * kSpacing;
+    SessionHitTester hit_tester(session_.get());
+    escher::ray4 ray{escher::vec4(x, y, 10.f, 1.f),
+                     escher::vec4(kDownVector, 0.f)};
+    return hit_tester.HitTest(root.get(), ray);
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < kHitTestCount; ++i) {
+    EXPECT_EQ(1u, hit_test(i).size());
+  }
+  auto static_duration = std::chrono::steady_clock::now() - start;
+
+  // Move a rectangle in the middle of the scene back and forth, which
+  // invalidates the bounds of its row and the root.
+  const ResourceId moving_id =
+      kRootId + 1 + (kRowCount / 2) * (kColumnCount + 1) + 1;
+  start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < kHitTestCount; ++i) {
+    Apply(scenic::NewSetTranslationCmd(
+        moving_id, (float[3]){0.f, (i % 2) * 1.f, 0.f}));
+    EXPECT_EQ(1u, hit_test(i).size());
+  }
+  auto moving_duration = std::chrono::steady_clock::now() - start;
+
+  using std::chrono::nanoseconds;
+  FXL_LOG(INFO) << "Hit test of " << kRowCount * kColumnCount << " nodes: "
+                << std::chrono::duration_cast<nanoseconds>(static_duration)
+                           .count() /
+                       kHitTestCount
+                << " ns static, "
+                << std::chrono::duration_cast<nanoseconds>(moving_duration)
+                           .count() /
+                       kHitTestCount
+                << " ns with a moving node";
+}
+
 }  // namespace test
 }  // namespace gfx
 }  // namespace scenic_impl
@@ -0,0 +1,163 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/lib/ui/gfx/engine/session_manager.h"
+
+#include "garnet/lib/ui/gfx/engine/frame_timings.h"
+#include "garnet/lib/ui/gfx/engine/update_scheduler.h"
+#include "garnet/lib/ui/gfx/resources/nodes/entity_node.h"
+#include "garnet/lib/ui/gfx/resources/nodes/shape_node.h"
+#include "garnet/lib/ui/gfx/tests/session_test.h"
+#include "lib/ui/scenic/cpp/commands.h"
+
+#include "gtest/gtest.h"
+
+namespace scenic_impl {
+namespace gfx {
+namespace test {
+namespace {
+
+constexpr uint32_t kUpdateThreadCount = 4;
+constexpr size_t kSessionCount = 16;
+constexpr ResourceId kNodesPerSession = 64;
+
+// Records the updates which SessionManager schedules, without rendering.
+class FakeUpdateScheduler : public UpdateScheduler {
+ public:
+  void ScheduleUpdate(uint64_t presentation_time) override {
+    ++schedule_count_;
+  }
+
+  uint32_t schedule_count() const { return schedule_count_; }
+
+ private:
+  uint32_t schedule_count_ = 0;
+};
+
+class SessionManagerTest : public SessionTest {
+ protected:
+  void SetUp() override {
+    SessionTest::SetUp();
+    session_manager()->SetUpdateThreadCount(kUpdateThreadCount);
+    for (size_t i = 0; i < kSessionCount; ++i) {
+      sessions_.push_back(fxl::MakeRefCounted<SessionForTest>(
+          i + 2, engine_.get(), this, error_reporter()));
+    }
+  }
+
+  void TearDown() override {
+    for (auto& session : sessions_) {
+      session->TearDown();
+    }
+    sessions_.clear();
+    session_manager()->SetUpdateThreadCount(0);
+    SessionTest::TearDown();
+  }
+
+  SessionManager* session_manager() { return engine_->session_manager(); }
+
+  // Schedules an update of |session| at |presentation_time| which builds a
+  // tree of shape nodes under an entity node, each translated by |offset|
+  // plus its id. Increments |*present_count| when the update is presented.
+  void ScheduleTreeUpdate(Session* session, uint64_t presentation_time,
+                          float offset, uint32_t* present_count) {
+    std::vector<::fuchsia::ui::gfx::Command> commands;
+    commands.push_back(scenic::NewCreateEntityNodeCmd(1));
+    for (ResourceId id = 2; id < kNodesPerSession + 2; ++id) {
+      const float translation[3] = {offset + id, 0.f, 0.f};
+      commands.push_back(scenic::NewCreateShapeNodeCmd(id));
+      commands.push_back(scenic::NewSetTranslationCmd(id, translation));
+      commands.push_back(scenic::NewAddChildCmd(1, id));
+    }
+    EXPECT_TRUE(session->ScheduleUpdate(
+        presentation_time, std::move(commands), ::fidl::VectorPtr<zx::event>(),
+        ::fidl::VectorPtr<zx::event>(),
+        [present_count](auto) { ++*present_count; }));
+    session_manager()->ScheduleUpdateForSession(&update_scheduler_,
+                                                presentation_time,
+                                                SessionPtr(session));
+  }
+
+  // Checks the tree built by ScheduleTreeUpdate() in |session|.
+  void ExpectTree(Session* session, float offset) {
+    auto root = session->resources()->FindResource<EntityNode>(1);
+    ASSERT_TRUE(root);
+    EXPECT_EQ(kNodesPerSession, root->children().size());
+    for (ResourceId id = 2; id < kNodesPerSession + 2; ++id) {
+      auto node = session->resources()->FindResource<ShapeNode>(id);
+      ASSERT_TRUE(node);
+      EXPECT_EQ(root.get(), node->parent());
+      EXPECT_EQ(offset + id, node->translation().x);
+    }
+  }
+
+  FakeUpdateScheduler update_scheduler_;
+  std::vector<fxl::RefPtr<SessionForTest>> sessions_;
+};
+
+// Sessions without shared resources are applied on the update threads, with
+// the same result as applying them in turn.
+TEST_F(SessionManagerTest, ApplyUpdatesInParallel) {
+  uint32_t present_count = 0;
+  for (size_t i = 0; i < sessions_.size(); ++i) {
+    ScheduleTreeUpdate(sessions_[i].get(), 1, i * 1000.f, &present_count);
+  }
+  EXPECT_EQ(kSessionCount, update_scheduler_.schedule_count());
+
+  auto timings = fxl::MakeRefCounted<FrameTimings>();
+  EXPECT_TRUE(session_manager()->ApplyScheduledSessionUpdates(1, 1,
+                                                              timings.get()));
+  EXPECT_EQ(kSessionCount, present_count);
+  ExpectLastReportedError(nullptr);
+
+  for (size_t i = 0; i < sessions_.size(); ++i) {
+    ExpectTree(sessions_[i].get(), i * 1000.f);
+  }
+
+  ASSERT_EQ(kSessionCount, timings->session_update_timings().size());
+  for (auto& timing : timings->session_update_timings()) {
+    EXPECT_TRUE(timing.applied_in_parallel);
+  }
+}
+
+// Sessions with shared resources are applied on the main thread, alongside
+// sessions applied in parallel. Updates which aren't due yet stay scheduled.
+TEST_F(SessionManagerTest, ApplySharedSessionsInTurn) {
+  EXPECT_TRUE(Apply(scenic::NewCreateSceneCmd(100)));
+
+  uint32_t present_count = 0;
+  ScheduleTreeUpdate(session_.get(), 1, 0.f, &present_count);
+  for (size_t i = 0; i < sessions_.size(); ++i) {
+    ScheduleTreeUpdate(sessions_[i].get(), 1, i * 1000.f, &present_count);
+  }
+  bool late_presented = false;
+  EXPECT_TRUE(sessions_[0]->ScheduleUpdate(
+      2, std::vector<::fuchsia::ui::gfx::Command>(),
+      ::fidl::VectorPtr<zx::event>(), ::fidl::VectorPtr<zx::event>(),
+      [&late_presented](auto) { late_presented = true; }));
+  session_manager()->ScheduleUpdateForSession(&update_scheduler_, 2,
+                                              sessions_[0]);
+
+  auto timings = fxl::MakeRefCounted<FrameTimings>();
+  EXPECT_TRUE(session_manager()->ApplyScheduledSessionUpdates(1, 1,
+                                                              timings.get()));
+  EXPECT_EQ(kSessionCount + 1, present_count);
+  EXPECT_FALSE(late_presented);
+  ExpectLastReportedError(nullptr);
+
+  ExpectTree(session_.get(), 0.f);
+  for (size_t i = 0; i < sessions_.size(); ++i) {
+    ExpectTree(sessions_[i].get(), i * 1000.f);
+  }
+
+  ASSERT_EQ(kSessionCount + 1, timings->session_update_timings().size());
+  for (auto& timing : timings->session_update_timings()) {
+    EXPECT_EQ(timing.session_id != session_->id(), timing.applied_in_parallel);
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace gfx
+}  // namespace scenic_impl
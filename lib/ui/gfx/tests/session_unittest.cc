@@ -103,6 +103,64 @@ TEST_F(SessionTest, Labeling) {
             shape_node->label());
 }
 
+TEST_F(SessionTest, CanApplyScheduledUpdatesInParallel) {
+  // Nothing is scheduled yet.
+  EXPECT_TRUE(session_->CanApplyScheduledUpdatesInParallel(1));
+
+  std::vector<::fuchsia::ui::gfx::Command> commands;
+  commands.push_back(scenic::NewCreateEntityNodeCmd(1));
+  commands.push_back(scenic::NewCreateShapeNodeCmd(2));
+  commands.push_back(scenic::NewAddChildCmd(1, 2));
+  EXPECT_TRUE(session_->ScheduleUpdate(1, std::move(commands),
+                                       ::fidl::VectorPtr<zx::event>(),
+                                       ::fidl::VectorPtr<zx::event>(),
+                                       [](auto) {}));
+  EXPECT_TRUE(session_->CanApplyScheduledUpdatesInParallel(1));
+
+  // A scene is shared with the engine, so updates which create one can't be
+  // applied in parallel, unless they aren't due yet.
+  commands.clear();
+  commands.push_back(scenic::NewCreateSceneCmd(3));
+  EXPECT_TRUE(session_->ScheduleUpdate(2, std::move(commands),
+                                       ::fidl::VectorPtr<zx::event>(),
+                                       ::fidl::VectorPtr<zx::event>(),
+                                       [](auto) {}));
+  EXPECT_TRUE(session_->CanApplyScheduledUpdatesInParallel(1));
+  EXPECT_FALSE(session_->CanApplyScheduledUpdatesInParallel(2));
+
+  // Nor can any updates once the session has a shared resource.
+  EXPECT_TRUE(session_->ApplyScheduledUpdates(2, 1));
+  EXPECT_FALSE(session_->CanApplyScheduledUpdatesInParallel(3));
+  EXPECT_TRUE(Apply(scenic::NewReleaseResourceCmd(3)));
+  EXPECT_TRUE(session_->CanApplyScheduledUpdatesInParallel(3));
+}
+
+TEST_F(SessionTest, PreapplyScheduledUpdates) {
+  std::vector<::fuchsia::ui::gfx::Command> commands;
+  commands.push_back(scenic::NewCreateEntityNodeCmd(1));
+  commands.push_back(scenic::NewCreateShapeNodeCmd(2));
+  commands.push_back(scenic::NewAddChildCmd(1, 2));
+  bool presented = false;
+  EXPECT_TRUE(session_->ScheduleUpdate(
+      1, std::move(commands), ::fidl::VectorPtr<zx::event>(),
+      ::fidl::VectorPtr<zx::event>(),
+      [&presented](auto) { presented = true; }));
+  ASSERT_TRUE(session_->CanApplyScheduledUpdatesInParallel(1));
+
+  // The commands are applied, but the update isn't completed until
+  // ApplyScheduledUpdates() is called.
+  session_->PreapplyScheduledUpdates(1);
+  auto node = FindResource<ShapeNode>(2);
+  ASSERT_TRUE(node);
+  EXPECT_EQ(1U, node->parent()->id());
+  EXPECT_FALSE(presented);
+
+  EXPECT_TRUE(session_->ApplyScheduledUpdates(1, 1));
+  EXPECT_TRUE(presented);
+  EXPECT_FALSE(session_->ApplyScheduledUpdates(1, 1));
+  ExpectLastReportedError(nullptr);
+}
+
 // TODO:
 // - test that FindResource() cannot return resources that have the wrong type.
 
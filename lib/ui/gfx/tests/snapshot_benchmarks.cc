@@ -0,0 +1,100 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include <fbl/string_printf.h>
+#include <perftest/perftest.h>
+
+#include "garnet/lib/ui/gfx/resources/snapshot/serializer.h"
+#include "garnet/lib/ui/gfx/resources/snapshot/snapshot_cache.h"
+
+namespace {
+
+using namespace scenic_impl::gfx;
+
+// Returns the serializers of a node with |child_count| labeled rectangle
+// children, as the Snapshotter builds them.  The child with index
+// |changed_child| is green instead of white.
+std::shared_ptr<NodeSerializer> NewTree(size_t child_count,
+                                        size_t changed_child) {
+  auto root = std::make_shared<NodeSerializer>();
+  root->name = "Parent";
+  root->id = 1;
+  for (size_t i = 0; i < child_count; ++i) {
+    auto shape = std::make_shared<RectangleSerializer>();
+    shape->width = 20.f;
+    shape->height = 10.f;
+
+    auto color = std::make_shared<ColorSerializer>();
+    color->red = i == changed_child ? 0.f : 1.f;
+    color->green = 1.f;
+    color->blue = i == changed_child ? 0.f : 1.f;
+    color->alpha = 1.f;
+
+    auto child = std::make_shared<NodeSerializer>();
+    child->name = "Child";
+    child->id = 2 + i;
+    child->shape = shape;
+    child->material = color;
+    root->children.push_back(child);
+  }
+  return root;
+}
+
+// Measures the CPU cost of serializing a snapshot of |child_count| nodes in
+// which one node changes every time.  If |delta| is set, each snapshot is a
+// delta of the previous one.  GPU readbacks are not included.
+bool SnapshotTest(perftest::RepeatState* state, size_t child_count,
+                  bool delta) {
+  state->DeclareStep("build");
+  if (delta) {
+    state->DeclareStep("mark_unchanged");
+  }
+  state->DeclareStep("serialize");
+
+  SnapshotCache cache;
+  if (delta) {
+    cache.MarkUnchanged(NewTree(child_count, child_count).get());
+    cache.CommitBase();
+  }
+
+  size_t changed_child = 0;
+  while (state->KeepRunning()) {
+    auto root = NewTree(child_count, changed_child);
+    changed_child = (changed_child + 1) % child_count;
+    state->NextStep();
+
+    if (delta) {
+      if (!cache.MarkUnchanged(root.get())) {
+        return false;
+      }
+      state->NextStep();
+    }
+
+    FlatBufferBuilder builder;
+    builder.Finish(root->serialize(builder));
+    if (delta) {
+      cache.CommitBase();
+    }
+  }
+  return true;
+}
+
+void RegisterTests() {
+  for (size_t child_count : {10, 200, 2000}) {
+    for (bool delta : {false, true}) {
+      auto name = fbl::StringPrintf("Scenic/Snapshot/%s/%zunodes",
+                                    delta ? "Delta" : "Full", child_count);
+      perftest::RegisterTest(name.c_str(), SnapshotTest, child_count, delta);
+    }
+  }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  return perftest::PerfTestMain(argc, argv, "fuchsia.scenic_benchmarks");
+}
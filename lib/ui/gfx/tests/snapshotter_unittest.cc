@@ -6,6 +6,8 @@
 #include "garnet/lib/ui/gfx/resources/nodes/entity_node.h"
 #include "garnet/lib/ui/gfx/resources/nodes/shape_node.h"
 #include "garnet/lib/ui/gfx/resources/snapshot/serializer.h"
+#include "garnet/lib/ui/gfx/resources/snapshot/snapshot_cache.h"
+#include "garnet/lib/ui/gfx/resources/snapshot/snapshot_reader.h"
 #include "garnet/lib/ui/gfx/resources/snapshot/version.h"
 #include "garnet/lib/ui/gfx/tests/vk_session_test.h"
 #include "garnet/public/lib/escher/test/gtest_escher.h"
@@ -45,6 +47,30 @@ class SnapshotterTest : public SessionTest {
     EXPECT_TRUE(Apply(scenic::NewCreateCircleCmd(kShapeId, 50.f)));
     EXPECT_TRUE(Apply(scenic::NewSetShapeCmd(kChildId, kShapeId)));
   }
+
+  // Takes a snapshot of |resource|, which is a delta if |cache| is set and
+  // has seen a snapshot before.
+  std::vector<uint8_t> TakeSnapshot(Resource* resource,
+                                    std::shared_ptr<SnapshotCache> cache) {
+    auto escher = escher::test::GetEscher()->GetWeakPtr();
+    std::vector<uint8_t> data;
+    {
+      Snapshotter snapshotter(escher::BatchGpuUploader::New(escher),
+                              std::move(cache));
+      snapshotter.TakeSnapshot(resource,
+                               [&data](::fuchsia::mem::Buffer buffer) {
+                                 EXPECT_TRUE(fsl::VectorFromVmo(buffer, &data));
+                               });
+    }
+    escher->vk_device().waitIdle();
+    EXPECT_TRUE(escher->Cleanup());
+    return data;
+  }
+
+  static const snapshot::Node* GetRootNode(const std::vector<uint8_t>& data) {
+    auto snapshot = (const SnapshotData *)data.data();
+    return flatbuffers::GetRoot<snapshot::Node>(snapshot->data);
+  }
 };
 
 VK_TEST_F(SnapshotterTest, Creation) {
@@ -89,6 +115,97 @@ VK_TEST_F(SnapshotterTest, Creation) {
   EXPECT_TRUE(size > 0);
 }
 
+VK_TEST_F(SnapshotterTest, DeltaSnapshots) {
+  auto entity = FindResource<EntityNode>(kParentId);
+  ASSERT_NE(nullptr, entity.get());
+
+  auto cache = std::make_shared<SnapshotCache>();
+  SnapshotReader reader;
+
+  // The first snapshot is full.
+  auto base = TakeSnapshot(entity.get(), cache);
+  ASSERT_FALSE(base.empty());
+  EXPECT_EQ(SnapshotData::SnapshotType::kFlatBuffer,
+            ((const SnapshotData *)base.data())->type);
+  EXPECT_TRUE(reader.Apply(base.data(), base.size()));
+
+  // Nothing has changed.
+  auto unchanged = TakeSnapshot(entity.get(), cache);
+  ASSERT_FALSE(unchanged.empty());
+  EXPECT_EQ(SnapshotData::SnapshotType::kFlatBufferDelta,
+            ((const SnapshotData *)unchanged.data())->type);
+  EXPECT_EQ(snapshot::NodeDelta_SameSubtree, GetRootNode(unchanged)->delta());
+  EXPECT_LT(unchanged.size(), base.size());
+  EXPECT_TRUE(reader.Apply(unchanged.data(), unchanged.size()));
+  ASSERT_NE(nullptr, reader.root());
+  EXPECT_EQ("Parent", reader.root()->name()->str());
+  ASSERT_EQ(1u, reader.root()->children()->size());
+  auto child = reader.root()->children()->Get(0);
+  EXPECT_EQ(snapshot::Shape_Circle, child->shape_type());
+  EXPECT_EQ(50.f, static_cast<const snapshot::Circle *>(child->shape())
+                      ->radius());
+
+  // Change the material of the child only.
+  const ResourceId kMaterialId = 100;
+  EXPECT_TRUE(Apply(scenic::NewCreateMaterialCmd(kMaterialId)));
+  EXPECT_TRUE(Apply(scenic::NewSetColorCmd(kMaterialId, 0, 255, 0, 255)));
+  EXPECT_TRUE(Apply(scenic::NewSetMaterialCmd(kParentId + 1, kMaterialId)));
+
+  auto changed = TakeSnapshot(entity.get(), cache);
+  ASSERT_FALSE(changed.empty());
+  auto node = GetRootNode(changed);
+  EXPECT_EQ(snapshot::NodeDelta_SameContent, node->delta());
+  EXPECT_EQ(nullptr, node->name());
+  ASSERT_EQ(1u, node->children()->size());
+  EXPECT_EQ(snapshot::NodeDelta_Full, node->children()->Get(0)->delta());
+  EXPECT_TRUE(reader.Apply(changed.data(), changed.size()));
+
+  // The rebuilt snapshot matches a full one.
+  auto full = TakeSnapshot(entity.get(), nullptr);
+  ASSERT_FALSE(full.empty());
+  EXPECT_EQ(SnapshotData::SnapshotType::kFlatBuffer,
+            ((const SnapshotData *)full.data())->type);
+  for (auto root : {GetRootNode(full), reader.root()}) {
+    EXPECT_EQ("Parent", root->name()->str());
+    ASSERT_EQ(1u, root->children()->size());
+    auto child = root->children()->Get(0);
+    EXPECT_EQ(snapshot::Shape_Circle, child->shape_type());
+    EXPECT_EQ(snapshot::Material_Color, child->material_type());
+    auto color = static_cast<const snapshot::Color *>(child->material());
+    EXPECT_EQ(0.f, color->red());
+    EXPECT_EQ(1.f, color->green());
+  }
+}
+
+// Tests that a snapshot only becomes the base of the next one once it has
+// been committed, and that resetting the cache makes the next snapshot full.
+TEST(SnapshotCacheTest, CommitAndReset) {
+  auto new_root = [] {
+    auto root = std::make_shared<NodeSerializer>();
+    root->name = "Parent";
+    root->id = 1;
+    return root;
+  };
+  SnapshotCache cache;
+
+  auto root = new_root();
+  EXPECT_FALSE(cache.MarkUnchanged(root.get()));
+  // The first snapshot was lost, so the next one is full too.
+  root = new_root();
+  EXPECT_FALSE(cache.MarkUnchanged(root.get()));
+  EXPECT_EQ(snapshot::NodeDelta_Full, root->delta);
+  cache.CommitBase();
+
+  root = new_root();
+  EXPECT_TRUE(cache.MarkUnchanged(root.get()));
+  EXPECT_EQ(snapshot::NodeDelta_SameSubtree, root->delta);
+
+  cache.Reset();
+  root = new_root();
+  EXPECT_FALSE(cache.MarkUnchanged(root.get()));
+  EXPECT_EQ(snapshot::NodeDelta_Full, root->delta);
+}
+
 }  // namespace test
 }  // namespace gfx
 }  // namespace scenic_impl
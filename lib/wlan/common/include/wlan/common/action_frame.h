@@ -135,10 +135,10 @@ struct DelBaFrame {
     static constexpr size_t max_len() { return sizeof(DelBaFrame); }
 
     BlockAckDelBaParameters params;
-    uint16_t reason_code;         // TODO(porce): Refactor mac_frame.h and use ReasonCode type
-    GcrGroupAddressElement addr;  // Info Element with ID kGcrGroupAddress
+    uint16_t reason_code;  // TODO(porce): Refactor mac_frame.h and use ReasonCode type
 
     // TODO(porce): Evaluate the use cases and support optional fields.
+    // GCR Group Address element
     // Multi-band
     // TCLAS
 
@@ -697,6 +697,32 @@ struct PsPollFrame {
     constexpr size_t len() const { return sizeof(*this); }
 } __PACKED;
 
+// IEEE Std 802.11-2016, 9.3.1.8.1, Figure 9-26
+class BlockAckReqControl : public common::BitField<uint16_t> {
+   public:
+    WLAN_BIT_FIELD(bar_ack_policy, 0, 1);
+    WLAN_BIT_FIELD(multi_tid, 1, 1);
+    WLAN_BIT_FIELD(compressed_bitmap, 2, 1);
+    WLAN_BIT_FIELD(gcr, 3, 1);
+    // 8 bit reserved
+    WLAN_BIT_FIELD(tid_info, 12, 4);
+};
+
+// IEEE Std 802.11-2016, 9.3.1.8
+// Only the Basic and Compressed BlockAckReq variants are supported.
+struct BlockAckReqFrame {
+    static constexpr ControlSubtype Subtype() { return ControlSubtype::kBlockAckRequest; }
+    static constexpr size_t max_len() { return sizeof(BlockAckReqFrame); }
+
+    uint16_t duration;
+    common::MacAddr ra;
+    common::MacAddr ta;
+    BlockAckReqControl bar_ctrl;
+    BlockAckStartingSequenceControl ssc;
+
+    constexpr size_t len() const { return sizeof(*this); }
+} __PACKED;
+
 // IEEE Std 802.2, 1998 Edition, 3.2
 // IETF RFC 1042
 struct LlcHeader {
@@ -719,6 +745,7 @@ struct AmsduSubframeHeader {
     uint16_t msdu_len_be;  // Stored in network byte order. Use accessors.
 
     uint16_t msdu_len() const { return be16toh(msdu_len_be); }
+    void set_msdu_len(uint16_t len) { msdu_len_be = htobe16(len); }
 
     constexpr size_t len() const { return sizeof(*this); }
     static constexpr size_t max_len() { return sizeof(AmsduSubframeHeader); }
@@ -117,6 +117,67 @@ struct RssiStats {
     mutable std::mutex lock;
 };
 
+// Block Ack receive reordering. IEEE Std 802.11-2016, 10.24.7.6
+struct ReorderStats {
+    // MPDUs which arrived in order and were passed up immediately.
+    Counter in_order;
+    // MPDUs which arrived ahead of a gap and were held back.
+    Counter buffered;
+    // MPDUs dropped as duplicates or because their sequence number lay behind the window.
+    Counter duplicate;
+    // Sequence numbers given up on after a BlockAckReq, a timeout or a window move.
+    Counter lost;
+    Counter bar_flush;
+    Counter timeout_flush;
+    ::fuchsia::wlan::stats::ReorderStats ToFidl() const {
+        return ::fuchsia::wlan::stats::ReorderStats{.in_order = in_order.ToFidl(),
+                                                    .buffered = buffered.ToFidl(),
+                                                    .duplicate = duplicate.ToFidl(),
+                                                    .lost = lost.ToFidl(),
+                                                    .bar_flush = bar_flush.ToFidl(),
+                                                    .timeout_flush = timeout_flush.ToFidl()};
+    };
+    void Reset() {
+        in_order.Reset();
+        buffered.Reset();
+        duplicate.Reset();
+        lost.Reset();
+        bar_flush.Reset();
+        timeout_flush.Reset();
+    }
+};
+
+// Occupancy of a pool of equally sized packet buffers. Updated from any thread without locks.
+struct BufferPoolStats {
+    // Buffers currently held by packets.
+    std::atomic_uint64_t in_use{0};
+    // Most buffers held by packets at once since the last reset.
+    std::atomic_uint64_t max_in_use{0};
+    // Released buffers kept in per-thread caches for reuse.
+    std::atomic_uint64_t cached{0};
+    // Allocations which failed because the pool was exhausted.
+    Counter exhausted;
+    ::fuchsia::wlan::stats::BufferPoolStats ToFidl() const {
+        return ::fuchsia::wlan::stats::BufferPoolStats{
+            .in_use = in_use.load(std::memory_order_relaxed),
+            .max_in_use = max_in_use.load(std::memory_order_relaxed),
+            .cached = cached.load(std::memory_order_relaxed),
+            .exhausted = exhausted.ToFidl()};
+    };
+    // Buffers in use and cached describe the pool's current state and are not reset.
+    void Reset() {
+        max_in_use = in_use.load(std::memory_order_relaxed);
+        exhausted.Reset();
+    }
+    void Acquire() {
+        uint64_t now = in_use.fetch_add(1, std::memory_order_relaxed) + 1;
+        uint64_t max = max_in_use.load(std::memory_order_relaxed);
+        while (now > max &&
+               !max_in_use.compare_exchange_weak(max, now, std::memory_order_relaxed)) {}
+    }
+    void Release() { in_use.fetch_sub(1, std::memory_order_relaxed); }
+};
+
 struct ClientMlmeStats {
     PacketCounter svc_msg;
     PacketCounter data_frame;
@@ -125,6 +186,7 @@ struct ClientMlmeStats {
     PacketCounter rx_frame;
     RssiStats assoc_data_rssi;
     RssiStats beacon_rssi;
+    ReorderStats reorder;
     ::fuchsia::wlan::stats::ClientMlmeStats ToFidl() const {
         return ::fuchsia::wlan::stats::ClientMlmeStats{.svc_msg = svc_msg.ToFidl(),
                                                        .data_frame = data_frame.ToFidl(),
@@ -132,7 +194,8 @@ struct ClientMlmeStats {
                                                        .tx_frame = tx_frame.ToFidl(),
                                                        .rx_frame = rx_frame.ToFidl(),
                                                        .assoc_data_rssi = assoc_data_rssi.ToFidl(),
-                                                       .beacon_rssi = beacon_rssi.ToFidl()};
+                                                       .beacon_rssi = beacon_rssi.ToFidl(),
+                                                       .reorder = reorder.ToFidl()};
     };
     void Reset() {
         svc_msg.Reset();
@@ -142,6 +205,7 @@ struct ClientMlmeStats {
         rx_frame.Reset();
         assoc_data_rssi.Reset();
         beacon_rssi.Reset();
+        reorder.Reset();
     }
 };
 // LINT.ThenChange(//garnet/public/lib/wlan/fidl/wlan_stats.fidl)
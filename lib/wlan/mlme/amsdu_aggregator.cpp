@@ -0,0 +1,111 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <wlan/mlme/amsdu_aggregator.h>
+
+#include <fbl/algorithm.h>
+#include <zircon/assert.h>
+
+#include <cstring>
+
+namespace wlan {
+
+// Subframes other than the last one are padded to a multiple of four octets.
+static constexpr size_t kSubframeAlignment = 4;
+
+size_t AmsduAggregator::MaxAmsduLen(const HtCapabilities& ht_cap) {
+    if (ht_cap.ht_cap_info.max_amsdu_len() == HtCapabilityInfo::OCTETS_7935) {
+        return kMaxAmsduLen7935;
+    }
+    return kMaxAmsduLen3839;
+}
+
+size_t AmsduAggregator::SubframeLen(const EthFrame& frame) {
+    return AmsduSubframeHeader::max_len() + LlcHeader::max_len() + frame.body_len();
+}
+
+size_t AmsduAggregator::AmsduLen(const std::vector<EthFrame>& frames) {
+    size_t len = 0;
+    for (auto& frame : frames) {
+        if (len > 0) { len = fbl::round_up(len, kSubframeAlignment); }
+        len += SubframeLen(frame);
+    }
+    return len;
+}
+
+void AmsduAggregator::WriteSubframes(BufferWriter* w, const std::vector<EthFrame>& frames) {
+    ZX_DEBUG_ASSERT(w != nullptr);
+
+    for (size_t i = 0; i < frames.size(); i++) {
+        auto eth_hdr = frames[i].hdr();
+        size_t payload_len = frames[i].body_len();
+
+        auto subframe_hdr = w->Write<AmsduSubframeHeader>();
+        subframe_hdr->da = eth_hdr->dest;
+        subframe_hdr->sa = eth_hdr->src;
+        subframe_hdr->set_msdu_len(static_cast<uint16_t>(LlcHeader::max_len() + payload_len));
+
+        auto llc_hdr = w->Write<LlcHeader>();
+        llc_hdr->dsap = kLlcSnapExtension;
+        llc_hdr->ssap = kLlcSnapExtension;
+        llc_hdr->control = kLlcUnnumberedInformation;
+        std::memcpy(llc_hdr->oui, kLlcOui, sizeof(llc_hdr->oui));
+        llc_hdr->protocol_id = eth_hdr->ether_type;
+        w->Write({eth_hdr->payload, payload_len});
+
+        if (i + 1 < frames.size()) {
+            size_t len = SubframeLen(frames[i]);
+            for (size_t pad = fbl::round_up(len, kSubframeAlignment) - len; pad > 0; pad--) {
+                w->WriteByte(0);
+            }
+        }
+    }
+}
+
+bool AmsduAggregator::CanAppend(uint8_t tid, const EthFrame& frame) const {
+    ZX_DEBUG_ASSERT(tid < kNumTids);
+    if (!enabled()) { return false; }
+
+    auto& pending = pending_[tid];
+    size_t offset = pending.frames.empty() ? 0 : fbl::round_up(pending.len, kSubframeAlignment);
+    return offset + SubframeLen(frame) <= max_len_;
+}
+
+bool AmsduAggregator::Append(uint8_t tid, EthFrame&& frame) {
+    ZX_DEBUG_ASSERT(CanAppend(tid, frame));
+
+    auto& pending = pending_[tid];
+    size_t subframe_len = SubframeLen(frame);
+    if (!pending.frames.empty()) { pending.len = fbl::round_up(pending.len, kSubframeAlignment); }
+    pending.len += subframe_len;
+    pending.frames.emplace_back(std::move(frame));
+
+    return fbl::round_up(pending.len, kSubframeAlignment) + subframe_len > max_len_;
+}
+
+std::vector<EthFrame> AmsduAggregator::Take(uint8_t tid) {
+    ZX_DEBUG_ASSERT(tid < kNumTids);
+
+    auto& pending = pending_[tid];
+    std::vector<EthFrame> frames;
+    frames.swap(pending.frames);
+    pending.len = 0;
+    return frames;
+}
+
+bool AmsduAggregator::IsEmpty() const {
+    for (auto& pending : pending_) {
+        if (!pending.frames.empty()) { return false; }
+    }
+    return true;
+}
+
+void AmsduAggregator::Clear() {
+    for (auto& pending : pending_) {
+        pending.frames.clear();
+        pending.len = 0;
+    }
+}
+
+}  // namespace wlan
@@ -11,6 +11,7 @@
 namespace wlan {
 
 namespace wlan_mlme = ::fuchsia::wlan::mlme;
+namespace wlan_stats = ::fuchsia::wlan::stats;
 
 ApMlme::ApMlme(DeviceInterface* device) : device_(device) {}
 
@@ -106,4 +107,16 @@ void ApMlme::HwIndication(uint32_t ind) {
     }
 }
 
+wlan_stats::MlmeStats ApMlme::GetMlmeStats() const {
+    wlan_stats::ApMlmeStats ap_stats{};
+    ap_stats.buffers = GetBufferPoolStats();
+    wlan_stats::MlmeStats mlme_stats{};
+    mlme_stats.set_ap_mlme_stats(std::move(ap_stats));
+    return mlme_stats;
+}
+
+void ApMlme::ResetMlmeStats() {
+    ResetBufferPoolStats();
+}
+
 }  // namespace wlan
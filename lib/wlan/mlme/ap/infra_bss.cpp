@@ -5,6 +5,7 @@
 #include <wlan/mlme/ap/infra_bss.h>
 
 #include <wlan/common/channel.h>
+#include <wlan/mlme/amsdu_aggregator.h>
 #include <wlan/mlme/debug.h>
 #include <wlan/mlme/device_caps.h>
 #include <wlan/mlme/key.h>
@@ -479,6 +480,48 @@ std::optional<DataFrame<LlcHeader>> InfraBss::EthToDataFrame(const EthFrame& eth
     return std::make_optional(fbl::move(data_frame));
 }
 
+std::optional<DataFrame<>> InfraBss::EthToAmsduFrame(const std::vector<EthFrame>& frames,
+                                                     const common::MacAddr& dest, uint8_t tid,
+                                                     bool needs_protection) {
+    ZX_DEBUG_ASSERT(!frames.empty());
+
+    size_t max_frame_len = DataFrameHeader::max_len() + AmsduAggregator::AmsduLen(frames);
+    auto packet = GetWlanPacket(max_frame_len);
+    if (packet == nullptr) {
+        debugf("[infra-bss] [%s] cannot build A-MSDU: out of packets (%zu)\n",
+               bssid_.ToString().c_str(), max_frame_len);
+        return std::nullopt;
+    }
+
+    BufferWriter w(*packet);
+    auto data_hdr = w.Write<DataFrameHeader>();
+    data_hdr->fc.set_type(FrameType::kData);
+    data_hdr->fc.set_subtype(DataSubtype::kQosdata);
+    data_hdr->fc.set_from_ds(1);
+    data_hdr->fc.set_protected_frame(needs_protection ? 1 : 0);
+    // IEEE Std 802.11-2016, Table 9-26: Address 3 carries the BSSID when an A-MSDU is sent from
+    // the DS. The SA and DA of each MSDU are in its subframe header.
+    data_hdr->addr1 = dest;
+    data_hdr->addr2 = bssid_;
+    data_hdr->addr3 = bssid_;
+
+    auto qos_ctrl = w.Write<QosControl>();
+    qos_ctrl->set_tid(tid);
+    qos_ctrl->set_ack_policy(ack_policy::kNormalAck);
+    qos_ctrl->set_amsdu_present(1);
+    data_hdr->sc.set_seq(NextSeq(*data_hdr));
+
+    AmsduAggregator::WriteSubframes(&w, frames);
+    packet->set_len(w.WrittenBytes());
+
+    finspect("Outbound A-MSDU: len %zu, %zu subframes\n", w.WrittenBytes(), frames.size());
+    finspect("  wlan hdr: %s\n", debug::Describe(*data_hdr).c_str());
+
+    DataFrame<> data_frame(fbl::move(packet));
+    data_frame.FillTxInfo(Ht().cbw_40_tx_ready ? CBW40 : CBW20, WLAN_PHY_HT);
+    return std::make_optional(fbl::move(data_frame));
+}
+
 void InfraBss::OnPreTbtt() {
     bcn_sender_->UpdateBeacon(ps_cfg_);
     ps_cfg_.NextDtimCount();
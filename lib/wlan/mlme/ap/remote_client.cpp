@@ -210,6 +210,13 @@ AssociatingState::AssociatingState(RemoteClient* client, MgmtFrame<AssociationRe
         case element_id::kRsn:
             rsn_element = reader.read<RsnElement>();
             break;
+        case element_id::kHtCapabilities:
+            if (auto ie = reader.read<HtCapabilitiesElement>()) {
+                ht_cap_ = ie->body;
+            } else {
+                reader.skip(*header);
+            }
+            break;
         default:
             reader.skip(*header);
             break;
@@ -266,7 +273,7 @@ zx_status_t AssociatingState::FinalizeAssociationAttempt(status_code::StatusCode
     bool assoc_success = st_code == status_code::kSuccess;
     auto status = client_->SendAssociationResponse(aid_, st_code);
     if (assoc_success && status == ZX_OK) {
-        MoveToState<AssociatedState>(aid_);
+        MoveToState<AssociatedState>(aid_, ht_cap_);
     } else {
         service::SendDisassociateIndication(client_->device(), client_->addr(),
                                             reason_code::ReasonCode::kUnspecifiedReason);
@@ -277,8 +284,14 @@ zx_status_t AssociatingState::FinalizeAssociationAttempt(status_code::StatusCode
 
 // AssociatedState implementation.
 
-AssociatedState::AssociatedState(RemoteClient* client, uint16_t aid)
-    : BaseState(client), aid_(aid) {}
+AssociatedState::AssociatedState(RemoteClient* client, uint16_t aid,
+                                 const std::optional<HtCapabilities>& ht_cap)
+    : BaseState(client), aid_(aid) {
+    // A-MSDUs are carried in QoS data frames which only HT clients are sent.
+    if (client_->bss()->Ht().ready && ht_cap.has_value()) {
+        amsdu_agg_.set_max_len(AmsduAggregator::MaxAmsduLen(ht_cap.value()));
+    }
+}
 
 void AssociatedState::HandleAnyDataFrame(DataFrame<>&& frame) {
     UpdatePowerSaveMode(frame.hdr()->fc);
@@ -373,13 +386,62 @@ void AssociatedState::HandleEthFrame(EthFrame&& eth_frame) {
     }
 
     // If the client is awake and not in power saving mode, convert and send frame
-    // immediately.
+    // immediately unless it can share an A-MSDU with frames following shortly.
+    uint8_t tid = client_->GetTid(eth_frame);
+    bool is_eapol = be16toh(eth_frame.hdr()->ether_type) == kEapolProtocolId;
+    if (!amsdu_agg_.enabled() || is_eapol) {
+        // Frames of the same TID must not overtake the ones still waiting for aggregation.
+        SendAmsdu(tid);
+        SendDataFrame(eth_frame);
+        return;
+    }
+
+    if (!amsdu_agg_.CanAppend(tid, eth_frame)) { SendAmsdu(tid); }
+    if (amsdu_agg_.Append(tid, fbl::move(eth_frame))) {
+        SendAmsdu(tid);
+        return;
+    }
+
+    if (!amsdu_flush_timeout_.IsActive()) {
+        auto deadline = client_->DeadlineAfterTus(kAmsduFlushTimeoutTu);
+        client_->ScheduleTimer(deadline, &amsdu_flush_timeout_);
+    }
+}
+
+zx_status_t AssociatedState::SendDataFrame(const EthFrame& eth_frame) {
     auto data_frame = EthToDataFrame(eth_frame);
     if (!data_frame) {
         errorf("[client] couldn't convert ethernet frame\n");
-        return;
+        return ZX_ERR_NO_RESOURCES;
+    }
+    return client_->bss()->SendDataFrame(data_frame->Generalize());
+}
+
+zx_status_t AssociatedState::SendAmsdu(uint8_t tid) {
+    if (!amsdu_agg_.HasPending(tid)) { return ZX_OK; }
+
+    auto frames = amsdu_agg_.Take(tid);
+    // A lone MSDU gains nothing from the A-MSDU framing.
+    if (frames.size() == 1) { return SendDataFrame(frames[0]); }
+
+    auto amsdu_frame =
+        client_->bss()->EthToAmsduFrame(frames, client_->addr(), tid, NeedsProtection());
+    if (!amsdu_frame) {
+        // Fall back to sending each MSDU in its own data frame.
+        zx_status_t status = ZX_OK;
+        for (auto& frame : frames) {
+            status = SendDataFrame(frame);
+        }
+        return status;
+    }
+    return client_->bss()->SendDataFrame(fbl::move(amsdu_frame.value()));
+}
+
+void AssociatedState::FlushAmsdus() {
+    amsdu_flush_timeout_.Cancel();
+    for (uint8_t tid = 0; tid < AmsduAggregator::kNumTids; tid++) {
+        SendAmsdu(tid);
     }
-    client_->bss()->SendDataFrame(data_frame->Generalize());
 }
 
 void AssociatedState::OpenControlledPort() {
@@ -438,13 +500,17 @@ void AssociatedState::HandlePsPollFrame(CtrlFrame<PsPollFrame>&& frame) {
 }
 
 std::optional<DataFrame<LlcHeader>> AssociatedState::EthToDataFrame(const EthFrame& eth_frame) {
-    bool needs_protection =
-        client_->bss()->IsRsn() && eapol_controlled_port_ == eapol::PortState::kOpen;
-    return client_->bss()->EthToDataFrame(eth_frame, needs_protection);
+    return client_->bss()->EthToDataFrame(eth_frame, NeedsProtection());
+}
+
+bool AssociatedState::NeedsProtection() const {
+    return client_->bss()->IsRsn() && eapol_controlled_port_ == eapol::PortState::kOpen;
 }
 
 void AssociatedState::OnExit() {
     inactive_timeout_.Cancel();
+    amsdu_flush_timeout_.Cancel();
+    amsdu_agg_.Clear();
 
     client_->ReportDisassociation(aid_);
     debugbss("[client] [%s] reported disassociation, AID: %u\n", client_->addr().ToString().c_str(),
@@ -511,6 +577,8 @@ zx_status_t AssociatedState::HandleMlmeMsg(const BaseMlmeMsg& msg) {
 }
 
 void AssociatedState::HandleTimeout(zx::time now) {
+    if (amsdu_flush_timeout_.Triggered(now)) { FlushAmsdus(); }
+
     if (!inactive_timeout_.Triggered(now)) { return; }
     inactive_timeout_.Cancel();
 
@@ -543,6 +611,14 @@ void AssociatedState::UpdatePowerSaveMode(const FrameControl& fc) {
 
         if (dozing_) {
             debugps("[client] [%s] client is now dozing\n", client_->addr().ToString().c_str());
+
+            // Frames held back for aggregation are buffered like any other frame from now on.
+            amsdu_flush_timeout_.Cancel();
+            for (uint8_t tid = 0; tid < AmsduAggregator::kNumTids; tid++) {
+                for (auto& frame : amsdu_agg_.Take(tid)) {
+                    EnqueueEthernetFrame(fbl::move(frame));
+                }
+            }
         } else {
             debugps("[client] [%s] client woke up\n", client_->addr().ToString().c_str());
 
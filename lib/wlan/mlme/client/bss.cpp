@@ -9,6 +9,7 @@
 
 #include <fuchsia/wlan/mlme/cpp/fidl.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -18,26 +19,40 @@ namespace wlan_mlme = ::fuchsia::wlan::mlme;
 
 // TODO(NET-500): This file needs some clean-up.
 
+// FNV-1a. Collisions only delay the refresh of an element until its content changes again.
+static uint32_t HashElement(const ElementHeader& hdr) {
+    constexpr uint32_t kFnvPrime = 16777619;
+    uint32_t hash = 2166136261;
+    auto bytes = reinterpret_cast<const uint8_t*>(&hdr);
+    for (size_t idx = 0; idx < sizeof(ElementHeader) + hdr.len; idx++) {
+        hash = (hash ^ bytes[idx]) * kFnvPrime;
+    }
+    return hash;
+}
+
 zx_status_t Bss::ProcessBeacon(const Beacon& beacon, size_t frame_len,
                                const wlan_rx_info_t* rx_info) {
     if (!IsBeaconValid(beacon)) { return ZX_ERR_INTERNAL; }
 
     Renew(beacon, rx_info);
 
-    if (!HasBeaconChanged(beacon, frame_len)) {
+    auto ie_chains = beacon.elements;
+    size_t ie_chains_len = frame_len - beacon.len();
+    IndexElements(ie_chains, ie_chains_len);
+
+    if (!HasBeaconChanged(beacon)) {
         // If unchanged, it is sufficient to renew the BSS. Bail out.
         return ZX_OK;
     }
 
-    if (bcn_len_ != 0) {
-        // TODO(porce): Identify varying IE, and do IE-by-IE comparison.
+    if (has_bcn_) {
         // BSS had been discovered, but the beacon changed.
         // Suspicious situation. Consider Deauth if in assoc.
-        debugbcn("BSSID %s beacon change detected. (len %zu -> %zu)\n", bssid_.ToString().c_str(),
-                 bcn_len_, frame_len);
+        debugbcn("BSSID %s beacon change detected. (IE count %zu -> %zu)\n",
+                 bssid_.ToString().c_str(), ie_digests_.size(), next_ie_digests_.size());
     }
 
-    auto status = Update(beacon, frame_len);
+    auto status = Update(beacon, ie_chains, ie_chains_len);
     if (status != ZX_OK) {
         debugbcn("BSSID %s failed to update its BSS object: (%d)\n", bssid_.ToString().c_str(),
                  status);
@@ -98,32 +113,51 @@ void Bss::Renew(const Beacon& beacon, const wlan_rx_info_t* rx_info) {
         (rx_info->valid_fields & WLAN_RX_INFO_VALID_SNR) ? rx_info->snr_dbh : WLAN_RSNI_DBH_INVALID;
 }
 
-bool Bss::HasBeaconChanged(const Beacon& beacon, size_t frame_len) const {
-    // Test changes in beacon, except for the timestamp field.
-    if (frame_len != bcn_len_) { return true; }
-    auto sig = GetBeaconSignature(beacon, frame_len);
-    if (sig != bcn_hash_) { return true; }
-    return false;
+void Bss::IndexElements(const uint8_t* ie_chains, size_t ie_chains_len) {
+    next_ie_digests_.clear();
+
+    ElementReader reader(ie_chains, ie_chains_len);
+    while (const ElementHeader* hdr = reader.peek()) {
+        if (hdr->id == element_id::kTim) {
+            // Allocation-free fast path for the DTIM fields.
+            if (hdr->len >= sizeof(TimHeader)) {
+                auto tim_hdr = reinterpret_cast<const TimHeader*>(hdr + 1);
+                dtim_count_ = tim_hdr->dtim_count;
+                bss_desc_.dtim_period = tim_hdr->dtim_period;
+            }
+        } else {
+            next_ie_digests_.push_back({.id = hdr->id, .hash = HashElement(*hdr)});
+        }
+        reader.skip(*hdr);
+    }
 }
 
-zx_status_t Bss::Update(const Beacon& beacon, size_t frame_len) {
-    // To be used to detect a change in Beacon.
-    bcn_len_ = frame_len;
-    bcn_hash_ = GetBeaconSignature(beacon, frame_len);
+bool Bss::HasBeaconChanged(const Beacon& beacon) const {
+    // Test changes in beacon, except for the timestamp field and the TIM.
+    if (!has_bcn_) { return true; }
+    if (beacon.beacon_interval != bss_desc_.beacon_period) { return true; }
+    if (beacon.cap.val() != bcn_cap_.val()) { return true; }
+    return next_ie_digests_ != ie_digests_;
+}
 
+zx_status_t Bss::Update(const Beacon& beacon, const uint8_t* ie_chains, size_t ie_chains_len) {
     // Fields that are always present.
     bssid_.CopyTo(bss_desc_.bssid.mutable_data());
 
     bss_desc_.beacon_period = beacon.beacon_interval;  // name mismatch is spec-compliant.
     ParseCapabilityInfo(beacon.cap);
     bss_desc_.bss_type = GetBssType(beacon.cap);
+    bcn_cap_ = beacon.cap;
+    has_bcn_ = true;
 
     // IE's.
-    auto ie_chains = beacon.elements;
-    size_t ie_chains_len = frame_len - beacon.len();
-
-    auto status = ParseIE(ie_chains, ie_chains_len);
-    if (status != ZX_OK) { return status; }
+    auto status = ParseChangedElements(ie_chains, ie_chains_len);
+    if (status != ZX_OK) {
+        // Parse all elements again with the next beacon.
+        ie_digests_.clear();
+        return status;
+    }
+    ie_digests_.swap(next_ie_digests_);
 
     // Post processing after IE parsing
 
@@ -161,190 +195,241 @@ void Bss::ParseCapabilityInfo(const CapabilityInfo& cap) {
     c.immediate_block_ack = (cap.immediate_block_ack() == 1);
 }
 
-zx_status_t Bss::ParseIE(const uint8_t* ie_chains, size_t ie_chains_len) {
+zx_status_t Bss::ParseChangedElements(const uint8_t* ie_chains, size_t ie_chains_len) {
+    debugbcn("Parsing IEs for BSSID %s\n", bssid_.ToString().c_str());
+
+    auto is_known = [](const std::vector<ElementDigest>& digests, const ElementDigest& digest) {
+        return std::find(digests.begin(), digests.end(), digest) != digests.end();
+    };
+    auto has_id = [](const std::vector<ElementDigest>& digests, uint8_t id) {
+        return std::any_of(digests.begin(), digests.end(),
+                           [id](const ElementDigest& digest) { return digest.id == id; });
+    };
+
+    for (auto& digest : ie_digests_) {
+        if (!has_id(next_ie_digests_, digest.id)) { ClearElement(digest.id); }
+    }
+
+    // |next_ie_digests_| lists all elements but the TIM in order of appearance.
     ElementReader reader(ie_chains, ie_chains_len);
+    size_t idx = 0;
+    uint8_t ie_parsed_cnt = 0;
+    while (const ElementHeader* hdr = reader.peek()) {
+        if (hdr->id == element_id::kTim) {
+            reader.skip(*hdr);
+            continue;
+        }
 
-    debugbcn("Parsing IEs for BSSID %s\n", bssid_.ToString().c_str());
-    uint8_t ie_cnt = 0;
-    uint8_t ie_unparsed_cnt = 0;
+        ZX_DEBUG_ASSERT(idx < next_ie_digests_.size());
+        if (is_known(ie_digests_, next_ie_digests_[idx++])) {
+            reader.skip(*hdr);
+            continue;
+        }
 
-    has_dsss_param_set_chan_ = false;
+        ie_parsed_cnt++;
+        auto status = ParseElement(&reader);
+        if (status != ZX_OK) { return status; }
+    }
 
-    char dbgmsghdr[128];
-    while (reader.is_valid()) {
-        ie_cnt++;
+    debugbcn("  IE Summary: parsed %u / all %zu\n", ie_parsed_cnt, next_ie_digests_.size());
+    return ZX_OK;
+}
 
-        const ElementHeader* hdr = reader.peek();
-        if (hdr == nullptr) break;
+zx_status_t Bss::ParseElement(ElementReader* reader) {
+    const ElementHeader* hdr = reader->peek();
+    ZX_DEBUG_ASSERT(hdr != nullptr);
+    elements_parsed_++;
 
-        // TODO(porce): Process HT Capabilities IE's HT Capabilities Info to get CBW announcement.
+    // TODO(porce): Process HT Capabilities IE's HT Capabilities Info to get CBW announcement.
 
-        snprintf(dbgmsghdr, sizeof(dbgmsghdr), "  IE %3u (Len %3u): ", hdr->id, hdr->len);
-        switch (hdr->id) {
-        case element_id::kSsid: {
-            auto ie = reader.read<SsidElement>();
-            if (ie == nullptr) {
-                debugbcn("%s Failed to parse\n", dbgmsghdr);
-                return ZX_ERR_INTERNAL;
-            }
-            std::vector<uint8_t> ssid(ie->ssid, ie->ssid + ie->hdr.len);
-            bss_desc_.ssid.reset(std::move(ssid));
-            debugbcn("%s SSID: [%s]\n", dbgmsghdr, debug::ToAsciiOrHexStr(*bss_desc_.ssid).c_str());
-            break;
+    char dbgmsghdr[128];
+    snprintf(dbgmsghdr, sizeof(dbgmsghdr), "  IE %3u (Len %3u): ", hdr->id, hdr->len);
+    switch (hdr->id) {
+    case element_id::kSsid: {
+        auto ie = reader->read<SsidElement>();
+        if (ie == nullptr) {
+            debugbcn("%s Failed to parse\n", dbgmsghdr);
+            return ZX_ERR_INTERNAL;
+        }
+        std::vector<uint8_t> ssid(ie->ssid, ie->ssid + ie->hdr.len);
+        bss_desc_.ssid.reset(std::move(ssid));
+        debugbcn("%s SSID: [%s]\n", dbgmsghdr, debug::ToAsciiOrHexStr(*bss_desc_.ssid).c_str());
+        break;
+    }
+    case element_id::kSuppRates: {
+        auto ie = reader->read<SupportedRatesElement>();
+        if (ie == nullptr) {
+            debugbcn("%s Failed to parse\n", dbgmsghdr);
+            return ZX_ERR_INTERNAL;
         }
-        case element_id::kSuppRates: {
-            auto ie = reader.read<SupportedRatesElement>();
-            if (ie == nullptr) {
-                debugbcn("%s Failed to parse\n", dbgmsghdr);
-                return ZX_ERR_INTERNAL;
-            }
 
-            if (!supported_rates_.empty()) { supported_rates_.clear(); }
-            for (uint8_t idx = 0; idx < ie->hdr.len; idx++) {
-                supported_rates_.push_back(ie->rates[idx]);
-            }
-            ZX_DEBUG_ASSERT(supported_rates_.size() <= SupportedRatesElement::kMaxLen);
-            debugbcn("%s Supported rates: %s\n", dbgmsghdr,
-                     RatesToString(supported_rates_).c_str());
-            break;
+        if (!supported_rates_.empty()) { supported_rates_.clear(); }
+        for (uint8_t idx = 0; idx < ie->hdr.len; idx++) {
+            supported_rates_.push_back(ie->rates[idx]);
+        }
+        ZX_DEBUG_ASSERT(supported_rates_.size() <= SupportedRatesElement::kMaxLen);
+        debugbcn("%s Supported rates: %s\n", dbgmsghdr,
+                 RatesToString(supported_rates_).c_str());
+        break;
+    }
+    case element_id::kExtSuppRates: {
+        auto ie = reader->read<ExtendedSupportedRatesElement>();
+        if (ie == nullptr) {
+            debugbcn("%s Failed to parse\n", dbgmsghdr);
+            return ZX_ERR_INTERNAL;
         }
-        case element_id::kExtSuppRates: {
-            auto ie = reader.read<ExtendedSupportedRatesElement>();
-            if (ie == nullptr) {
-                debugbcn("%s Failed to parse\n", dbgmsghdr);
-                return ZX_ERR_INTERNAL;
-            }
 
-            if (!ext_supp_rates_.empty()) { ext_supp_rates_.clear(); }
-            for (uint8_t idx = 0; idx < ie->hdr.len; idx++) {
-                ext_supp_rates_.push_back(ie->rates[idx]);
-            }
-            ZX_DEBUG_ASSERT(ext_supp_rates_.size() <= ExtendedSupportedRatesElement::kMaxLen);
-            debugbcn("%s Ext supp rates: %s\n", dbgmsghdr, RatesToString(ext_supp_rates_).c_str());
-            break;
+        if (!ext_supp_rates_.empty()) { ext_supp_rates_.clear(); }
+        for (uint8_t idx = 0; idx < ie->hdr.len; idx++) {
+            ext_supp_rates_.push_back(ie->rates[idx]);
+        }
+        ZX_DEBUG_ASSERT(ext_supp_rates_.size() <= ExtendedSupportedRatesElement::kMaxLen);
+        debugbcn("%s Ext supp rates: %s\n", dbgmsghdr, RatesToString(ext_supp_rates_).c_str());
+        break;
+    }
+    case element_id::kDsssParamSet: {
+        auto ie = reader->read<DsssParamSetElement>();
+        if (ie == nullptr) {
+            debugbcn("%s Failed to parse\n", dbgmsghdr);
+            return ZX_ERR_INTERNAL;
         }
-        case element_id::kDsssParamSet: {
-            auto ie = reader.read<DsssParamSetElement>();
-            if (ie == nullptr) {
-                debugbcn("%s Failed to parse\n", dbgmsghdr);
-                return ZX_ERR_INTERNAL;
-            }
 
-            has_dsss_param_set_chan_ = true;
-            dsss_param_set_chan_ = ie->current_chan;
-            debugbcn("%s Current channel: %u\n", dbgmsghdr, ie->current_chan);
-            break;
+        has_dsss_param_set_chan_ = true;
+        dsss_param_set_chan_ = ie->current_chan;
+        debugbcn("%s Current channel: %u\n", dbgmsghdr, ie->current_chan);
+        break;
+    }
+    case element_id::kCountry: {
+        // TODO(porce): Handle Subband Triplet Sequence field.
+        auto ie = reader->read<CountryElement>();
+        if (ie == nullptr) {
+            debugbcn("%s Failed to parse\n", dbgmsghdr);
+            return ZX_ERR_INTERNAL;
         }
-        case element_id::kCountry: {
-            // TODO(porce): Handle Subband Triplet Sequence field.
-            auto ie = reader.read<CountryElement>();
-            if (ie == nullptr) {
-                debugbcn("%s Failed to parse\n", dbgmsghdr);
-                return ZX_ERR_INTERNAL;
-            }
 
-            bss_desc_.country.resize(0);
-            bss_desc_.country->assign(ie->country.data, ie->country.data + Country::kCountryLen);
+        bss_desc_.country.resize(0);
+        bss_desc_.country->assign(ie->country.data, ie->country.data + Country::kCountryLen);
 
-            debugbcn("%s Country: %3s\n", dbgmsghdr, bss_desc_.country->data());
-            break;
+        debugbcn("%s Country: %3s\n", dbgmsghdr, bss_desc_.country->data());
+        break;
+    }
+    case element_id::kRsn: {
+        auto ie = reader->read<RsnElement>();
+        if (ie == nullptr) {
+            debugbcn("%s Failed to parse\n", dbgmsghdr);
+            return ZX_ERR_INTERNAL;
         }
-        case element_id::kRsn: {
-            auto ie = reader.read<RsnElement>();
-            if (ie == nullptr) {
-                debugbcn("%s Failed to parse\n", dbgmsghdr);
-                return ZX_ERR_INTERNAL;
-            }
 
-            // TODO(porce): Consider pre-allocate max memory and recycle it.
-            // Don't use a unique_ptr
-            // if (rsne_) delete[] rsne_;
-            size_t ie_len = sizeof(ElementHeader) + ie->hdr.len;
-            rsne_.reset(new uint8_t[ie_len]);
-            memcpy(rsne_.get(), ie, ie_len);
-            rsne_len_ = ie_len;
-
-            bss_desc_.rsn.reset();
-            if (rsne_len_ > 0) {
-                bss_desc_.rsn = fidl::VectorPtr<uint8_t>::New(rsne_len_);
-                memcpy(bss_desc_.rsn->data(), rsne_.get(), rsne_len_);
-            }
+        // TODO(porce): Consider pre-allocate max memory and recycle it.
+        // Don't use a unique_ptr
+        // if (rsne_) delete[] rsne_;
+        size_t ie_len = sizeof(ElementHeader) + ie->hdr.len;
+        rsne_.reset(new uint8_t[ie_len]);
+        memcpy(rsne_.get(), ie, ie_len);
+        rsne_len_ = ie_len;
+
+        bss_desc_.rsn.reset();
+        if (rsne_len_ > 0) {
+            bss_desc_.rsn = fidl::VectorPtr<uint8_t>::New(rsne_len_);
+            memcpy(bss_desc_.rsn->data(), rsne_.get(), rsne_len_);
+        }
 
-            debugbcn("%s RSN\n", dbgmsghdr);
-            break;
+        debugbcn("%s RSN\n", dbgmsghdr);
+        break;
+    }
+    case element_id::kHtCapabilities: {
+        auto ie = reader->read<HtCapabilitiesElement>();
+        if (ie == nullptr) {
+            debugbcn("%s Failed to parse\n", dbgmsghdr);
+            return ZX_ERR_INTERNAL;
         }
-        case element_id::kHtCapabilities: {
-            auto ie = reader.read<HtCapabilitiesElement>();
-            if (ie == nullptr) {
-                debugbcn("%s Failed to parse\n", dbgmsghdr);
-                return ZX_ERR_INTERNAL;
-            }
 
-            bss_desc_.ht_cap = std::make_unique<wlan_mlme::HtCapabilities>(ie->body.ToFidl());
+        bss_desc_.ht_cap = std::make_unique<wlan_mlme::HtCapabilities>(ie->body.ToFidl());
 
-            debugbcn("%s HtCapabilities parsed\n", dbgmsghdr);
-            debugbcn("%s\n", debug::Describe(ie->body).c_str());
-            break;
+        debugbcn("%s HtCapabilities parsed\n", dbgmsghdr);
+        debugbcn("%s\n", debug::Describe(ie->body).c_str());
+        break;
+    }
+    case element_id::kHtOperation: {
+        auto ie = reader->read<HtOperationElement>();
+        if (ie == nullptr) {
+            debugbcn("%s Failed to parse\n", dbgmsghdr);
+            return ZX_ERR_INTERNAL;
         }
-        case element_id::kHtOperation: {
-            auto ie = reader.read<HtOperationElement>();
-            if (ie == nullptr) {
-                debugbcn("%s Failed to parse\n", dbgmsghdr);
-                return ZX_ERR_INTERNAL;
-            }
 
-            bss_desc_.ht_op = std::make_unique<wlan_mlme::HtOperation>(ie->body.ToFidl());
-            debugbcn("%s HtOperation parsed\n", dbgmsghdr);
-            break;
+        bss_desc_.ht_op = std::make_unique<wlan_mlme::HtOperation>(ie->body.ToFidl());
+        debugbcn("%s HtOperation parsed\n", dbgmsghdr);
+        break;
+    }
+    case element_id::kVhtCapabilities: {
+        auto ie = reader->read<VhtCapabilitiesElement>();
+        if (ie == nullptr) {
+            debugbcn("%s Failed to parse\n", dbgmsghdr);
+            return ZX_ERR_INTERNAL;
         }
-        case element_id::kVhtCapabilities: {
-            auto ie = reader.read<VhtCapabilitiesElement>();
-            if (ie == nullptr) {
-                debugbcn("%s Failed to parse\n", dbgmsghdr);
-                return ZX_ERR_INTERNAL;
-            }
 
-            bss_desc_.vht_cap = std::make_unique<wlan_mlme::VhtCapabilities>(ie->body.ToFidl());
-            debugbcn("%s VhtCapabilities parsed\n", dbgmsghdr);
-            break;
+        bss_desc_.vht_cap = std::make_unique<wlan_mlme::VhtCapabilities>(ie->body.ToFidl());
+        debugbcn("%s VhtCapabilities parsed\n", dbgmsghdr);
+        break;
+    }
+    case element_id::kVhtOperation: {
+        auto ie = reader->read<VhtOperationElement>();
+        if (ie == nullptr) {
+            debugbcn("%s Failed to parse\n", dbgmsghdr);
+            return ZX_ERR_INTERNAL;
         }
-        case element_id::kVhtOperation: {
-            auto ie = reader.read<VhtOperationElement>();
-            if (ie == nullptr) {
-                debugbcn("%s Failed to parse\n", dbgmsghdr);
-                return ZX_ERR_INTERNAL;
-            }
 
-            bss_desc_.vht_op = std::make_unique<wlan_mlme::VhtOperation>(ie->body.ToFidl());
-            debugbcn("%s VhtOperation parsed\n", dbgmsghdr);
-            break;
-        }
+        bss_desc_.vht_op = std::make_unique<wlan_mlme::VhtOperation>(ie->body.ToFidl());
+        debugbcn("%s VhtOperation parsed\n", dbgmsghdr);
+        break;
+    }
 
-        default:
-            ie_unparsed_cnt++;
-            debugbcn("%s Unparsed\n", dbgmsghdr);
-            reader.skip(sizeof(ElementHeader) + hdr->len);
-            break;
-        }
+    default:
+        debugbcn("%s Unparsed\n", dbgmsghdr);
+        reader->skip(*hdr);
+        break;
     }
 
-    debugbcn("  IE Summary: parsed %u / all %u\n", (ie_cnt - ie_unparsed_cnt), ie_cnt);
     return ZX_OK;
 }
 
-BeaconHash Bss::GetBeaconSignature(const Beacon& beacon, size_t frame_len) const {
-    auto arr = reinterpret_cast<const uint8_t*>(&beacon);
-
-    // Get a hash of the beacon except for its first field: timestamp.
-    arr += sizeof(beacon.timestamp);
-    frame_len -= sizeof(beacon.timestamp);
-
-    BeaconHash hash = 0;
-    // TODO(porce): Change to a less humble version.
-    for (size_t idx = 0; idx < frame_len; idx++) {
-        hash += *(arr + idx);
+void Bss::ClearElement(uint8_t id) {
+    switch (id) {
+    case element_id::kSsid:
+        bss_desc_.ssid.resize(0);
+        break;
+    case element_id::kSuppRates:
+        supported_rates_.clear();
+        break;
+    case element_id::kExtSuppRates:
+        ext_supp_rates_.clear();
+        break;
+    case element_id::kDsssParamSet:
+        has_dsss_param_set_chan_ = false;
+        break;
+    case element_id::kCountry:
+        bss_desc_.country.reset();
+        break;
+    case element_id::kRsn:
+        rsne_.reset();
+        rsne_len_ = 0;
+        bss_desc_.rsn.reset();
+        break;
+    case element_id::kHtCapabilities:
+        bss_desc_.ht_cap.reset();
+        break;
+    case element_id::kHtOperation:
+        bss_desc_.ht_op.reset();
+        break;
+    case element_id::kVhtCapabilities:
+        bss_desc_.vht_cap.reset();
+        break;
+    case element_id::kVhtOperation:
+        bss_desc_.vht_op.reset();
+        break;
+    default:
+        break;
     }
-    return hash;
 }
 
 std::string Bss::RatesToString(const std::vector<uint8_t>& rates) const {
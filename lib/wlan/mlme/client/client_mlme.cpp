@@ -277,13 +277,18 @@ void ClientMlme::OnChannelHandlerImpl::ReturnedOnChannel() {
 }
 
 wlan_stats::MlmeStats ClientMlme::GetMlmeStats() const {
+    // Packet buffers are in use whether or not the client has joined a BSS.
+    wlan_stats::ClientMlmeStats client_stats{};
+    if (sta_ != nullptr) { client_stats = sta_->stats(); }
+    client_stats.buffers = GetBufferPoolStats();
     wlan_stats::MlmeStats mlme_stats{};
-    if (sta_ != nullptr) { mlme_stats.set_client_mlme_stats(sta_->stats()); }
+    mlme_stats.set_client_mlme_stats(std::move(client_stats));
     return mlme_stats;
 }
 
 void ClientMlme::ResetMlmeStats() {
     if (sta_ != nullptr) { sta_->ResetStats(); }
+    ResetBufferPoolStats();
 }
 
 void ClientMlme::Unjoin() {
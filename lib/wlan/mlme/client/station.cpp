@@ -54,6 +54,8 @@ void Station::Reset() {
     assoc_timeout_.Cancel();
     signal_report_timeout_.Cancel();
     bu_queue_.clear();
+    amsdu_agg_.Clear();
+    ResetReorderBuffers();
 }
 
 zx_status_t Station::HandleAnyMlmeMsg(const BaseMlmeMsg& mlme_msg) {
@@ -88,6 +90,11 @@ zx_status_t Station::HandleAnyWlanFrame(fbl::unique_ptr<Packet> pkt) {
         if (!data_frame) { return ZX_ERR_BUFFER_TOO_SMALL; }
 
         HandleAnyDataFrame(data_frame.IntoOwned(fbl::move(pkt)));
+    } else if (auto possible_ctrl_frame = CtrlFrameView<>::CheckType(pkt.get())) {
+        auto ctrl_frame = possible_ctrl_frame.CheckLength();
+        if (!ctrl_frame) { return ZX_ERR_BUFFER_TOO_SMALL; }
+
+        HandleAnyCtrlFrame(ctrl_frame.IntoOwned(fbl::move(pkt)));
     }
 
     return ZX_OK;
@@ -142,6 +149,22 @@ zx_status_t Station::HandleAnyDataFrame(DataFrame<>&& frame) {
     auto rssi_dbm = frame.View().rx_info()->rssi_dbm;
     WLAN_RSSI_HIST_INC(assoc_data_rssi, rssi_dbm);
 
+    // MPDUs of a Block Ack session can arrive out of order and are passed up once their
+    // predecessors arrived or were given up on.
+    if (auto reorder_buf = FindReorderBuffer(data_frame)) {
+        uint8_t tid = data_frame.hdr()->qos_ctrl()->tid();
+        uint16_t seq = data_frame.hdr()->sc.seq();
+        uint16_t prev_win_start = reorder_buf->win_start();
+        reorder_buf->Insert(seq, frame.Take());
+        UpdateReorderFlushTimeout(tid, prev_win_start);
+        return ZX_OK;
+    }
+
+    return HandleInOrderDataFrame(fbl::move(frame));
+}
+
+zx_status_t Station::HandleInOrderDataFrame(DataFrame<>&& frame) {
+    auto data_frame = frame.View();
     if (auto amsdu_frame = data_frame.CheckBodyType<AmsduSubframeHeader>().CheckLength()) {
         HandleAmsduFrame(amsdu_frame.IntoOwned(frame.Take()));
     } else if (auto llc_frame = data_frame.CheckBodyType<LlcHeader>().CheckLength()) {
@@ -153,6 +176,79 @@ zx_status_t Station::HandleAnyDataFrame(DataFrame<>&& frame) {
     return ZX_OK;
 }
 
+zx_status_t Station::HandleAnyCtrlFrame(CtrlFrame<>&& frame) {
+    if (state_ != WlanState::kAssociated) { return ZX_ERR_NOT_SUPPORTED; }
+
+    if (auto bar_frame = frame.View().CheckBodyType<BlockAckReqFrame>().CheckLength()) {
+        return HandleBlockAckReq(*bar_frame.body());
+    }
+
+    return ZX_OK;
+}
+
+zx_status_t Station::HandleBlockAckReq(const BlockAckReqFrame& bar) {
+    debugfn();
+
+    if (bar.ta != join_ctx_->bssid() || bar.ra != self_addr()) { return ZX_ERR_NOT_SUPPORTED; }
+    // Multi-TID and GCR BlockAckReqs are only used with sessions this STA never accepts.
+    if (bar.bar_ctrl.multi_tid() || bar.bar_ctrl.gcr()) { return ZX_ERR_NOT_SUPPORTED; }
+
+    uint8_t tid = bar.bar_ctrl.tid_info();
+    auto& reorder_buf = reorder_bufs_[tid];
+    if (reorder_buf == nullptr) { return ZX_OK; }
+
+    finspect("Inbound BlockAckReq: tid %u, ssn %u\n", tid, bar.ssc.starting_seq());
+    uint16_t prev_win_start = reorder_buf->win_start();
+    reorder_buf->HandleBlockAckReq(bar.ssc.starting_seq());
+    UpdateReorderFlushTimeout(tid, prev_win_start);
+    return ZX_OK;
+}
+
+ReorderBuffer* Station::FindReorderBuffer(const DataFrameView<>& frame) {
+    auto data_hdr = frame.hdr();
+    if (data_hdr->fc.subtype() != DataSubtype::kQosdata || !data_hdr->addr1.IsUcast()) {
+        return nullptr;
+    }
+
+    auto qos_ctrl = data_hdr->qos_ctrl();
+    if (qos_ctrl->ack_policy() == ack_policy::kNoAck) { return nullptr; }
+    return reorder_bufs_[qos_ctrl->tid()].get();
+}
+
+void Station::UpdateReorderFlushTimeout(uint8_t tid, uint16_t prev_win_start) {
+    auto& reorder_buf = reorder_bufs_[tid];
+    auto& timeout = reorder_flush_timeouts_[tid];
+    if (reorder_buf == nullptr || reorder_buf->IsEmpty()) {
+        timeout.Cancel();
+        return;
+    }
+
+    // Either nothing was buffered before, or the window moved on to a gap which just opened.
+    if (!timeout.IsActive() || reorder_buf->win_start() != prev_win_start) {
+        timer_mgr_.Schedule(timer_mgr_.Now() + kReorderFlushTimeout, &timeout);
+    }
+}
+
+void Station::FlushReorderBuffer(uint8_t tid) {
+    auto& reorder_buf = reorder_bufs_[tid];
+    reorder_flush_timeouts_[tid].Cancel();
+    if (reorder_buf == nullptr) { return; }
+
+    // Further gaps get their own grace period.
+    uint16_t prev_win_start = reorder_buf->win_start();
+    reorder_buf->FlushOnTimeout();
+    UpdateReorderFlushTimeout(tid, prev_win_start);
+}
+
+void Station::ResetReorderBuffers() {
+    for (auto& timeout : reorder_flush_timeouts_) {
+        timeout.Cancel();
+    }
+    for (auto& reorder_buf : reorder_bufs_) {
+        reorder_buf.reset();
+    }
+}
+
 zx_status_t Station::HandleMlmeAuthReq(const MlmeMsg<wlan_mlme::AuthenticateRequest>& req) {
     debugfn();
 
@@ -237,6 +333,8 @@ zx_status_t Station::HandleMlmeDeauthReq(const MlmeMsg<wlan_mlme::Deauthenticate
     device_->SetStatus(0);
     controlled_port_ = eapol::PortState::kBlocked;
     bu_queue_.clear();
+    amsdu_agg_.Clear();
+    ResetReorderBuffers();
     service::SendDeauthConfirm(device_, join_ctx_->bssid());
 
     return ZX_OK;
@@ -444,6 +542,8 @@ zx_status_t Station::HandleDeauthentication(MgmtFrame<Deauthentication>&& frame)
     device_->SetStatus(0);
     controlled_port_ = eapol::PortState::kBlocked;
     bu_queue_.clear();
+    amsdu_agg_.Clear();
+    ResetReorderBuffers();
 
     return service::SendDeauthIndication(device_, join_ctx_->bssid(),
                                          static_cast<wlan_mlme::ReasonCode>(deauth->reason_code));
@@ -479,6 +579,13 @@ zx_status_t Station::HandleAssociationResponse(MgmtFrame<AssociationResponse>&&
         return ZX_ERR_BAD_STATE;
     }
 
+    // An HT STA can receive A-MSDUs at least up to the size advertised in its HT Capabilities.
+    // IEEE Std 802.11-2016, 10.12
+    amsdu_agg_.Clear();
+    ResetReorderBuffers();
+    amsdu_agg_.set_max_len(assoc_ctx_.ht_cap ? AmsduAggregator::MaxAmsduLen(*assoc_ctx_.ht_cap)
+                                             : 0);
+
     // TODO(porce): Move into |assoc_ctx_|
     state_ = WlanState::kAssociated;
     assoc_ctx_.set_aid(assoc->aid);
@@ -540,6 +647,8 @@ zx_status_t Station::HandleDisassociation(MgmtFrame<Disassociation>&& frame) {
     controlled_port_ = eapol::PortState::kBlocked;
     signal_report_timeout_.Cancel();
     bu_queue_.clear();
+    amsdu_agg_.Clear();
+    ResetReorderBuffers();
 
     return service::SendDisassociateIndication(device_, join_ctx_->bssid(), disassoc->reason_code);
 }
@@ -561,6 +670,10 @@ zx_status_t Station::HandleActionFrame(MgmtFrame<ActionFrame>&& frame) {
             finspect("  addba req: %s\n", debug::Describe(*add_ba_req_frame.body()).c_str());
 
             return HandleAddBaRequest(*add_ba_req_frame.body());
+        } else if (auto del_ba_frame = ba_frame.CheckBodyType<DelBaFrame>().CheckLength()) {
+            finspect("Inbound DELBA frame: len %zu\n", del_ba_frame.body_len());
+
+            return HandleDelBa(*del_ba_frame.body());
         }
     }
 
@@ -603,10 +716,12 @@ zx_status_t Station::HandleAddBaRequest(const AddBaRequestFrame& addbareq) {
     // TODO(NET-500): Is this Ralink specific?
     // TODO(porce): Once chipset capability is ready, refactor below buffer_size
     // calculation.
+    // A Buffer Size of zero leaves the choice to the recipient. IEEE Std 802.11-2016, 9.4.1.14
     size_t buffer_size_ap = addbareq.params.buffer_size();
-    constexpr size_t buffer_size_ralink = 64;
-    size_t buffer_size =
-        (buffer_size_ap <= buffer_size_ralink) ? buffer_size_ap : buffer_size_ralink;
+    constexpr size_t buffer_size_ralink = ReorderBuffer::kMaxWindowSize;
+    size_t buffer_size = (buffer_size_ap > 0 && buffer_size_ap <= buffer_size_ralink)
+                             ? buffer_size_ap
+                             : buffer_size_ralink;
     addbaresp_hdr->params.set_buffer_size(buffer_size);
     addbaresp_hdr->timeout = addbareq.timeout;
 
@@ -617,8 +732,38 @@ zx_status_t Station::HandleAddBaRequest(const AddBaRequestFrame& addbareq) {
     finspect("Outbound Mgmt Frame(ADDBA Resp): %s\n", debug::Describe(*addbaresp_hdr).c_str());
 
     auto status = SendNonData(fbl::move(packet));
-    if (status != ZX_OK) { errorf("could not send AddBaResponse: %d\n", status); }
-    return status;
+    if (status != ZX_OK) {
+        errorf("could not send AddBaResponse: %d\n", status);
+        return status;
+    }
+
+    // The session only exists once the AP was told it was accepted. A repeated ADDBA Request
+    // replaces the session and drops whatever was still buffered.
+    uint8_t tid = addbareq.params.tid();
+    reorder_flush_timeouts_[tid].Cancel();
+    reorder_bufs_[tid] = fbl::make_unique<ReorderBuffer>(
+        addbareq.seq_ctrl.starting_seq(), buffer_size, &stats_.stats.reorder,
+        [this](fbl::unique_ptr<Packet> pkt) {
+            HandleInOrderDataFrame(DataFrame<>(fbl::move(pkt)));
+        });
+    return ZX_OK;
+}
+
+zx_status_t Station::HandleDelBa(const DelBaFrame& delba) {
+    debugfn();
+
+    // Only the session the AP originated has a reorder buffer on this side.
+    if (!delba.params.initiator()) { return ZX_OK; }
+
+    uint8_t tid = delba.params.tid();
+    auto& reorder_buf = reorder_bufs_[tid];
+    if (reorder_buf == nullptr) { return ZX_OK; }
+
+    finspect("Inbound DELBA: tid %u, reason %u\n", tid, delba.reason_code);
+    reorder_flush_timeouts_[tid].Cancel();
+    reorder_buf->ReleaseAll();
+    reorder_buf.reset();
+    return ZX_OK;
 }
 
 bool Station::ShouldDropDataFrame(const DataFrameView<>& frame) {
@@ -745,17 +890,104 @@ zx_status_t Station::HandleEthFrame(EthFrame&& eth_frame) {
         return ZX_OK;
     }
 
+    uint8_t tid = GetTid(eth_frame);
+    if (!ShouldAggregate(eth_frame)) {
+        // Frames of the same TID must not overtake the ones still waiting for aggregation.
+        SendAmsdu(tid);
+        return SendDataFrame(eth_frame, tid);
+    }
+
+    if (!amsdu_agg_.CanAppend(tid, eth_frame)) { SendAmsdu(tid); }
+    if (amsdu_agg_.Append(tid, fbl::move(eth_frame))) { return SendAmsdu(tid); }
+
+    if (!amsdu_flush_timeout_.IsActive()) {
+        timer_mgr_.Schedule(timer_mgr_.Now() + kAmsduFlushTimeout, &amsdu_flush_timeout_);
+    }
+    return ZX_OK;
+}
+
+zx_status_t Station::SendDataFrame(const EthFrame& eth_frame, uint8_t tid) {
     auto eth_hdr = eth_frame.hdr();
     const size_t frame_len =
         DataFrameHeader::max_len() + LlcHeader::max_len() + eth_frame.body_len();
     auto packet = GetWlanPacket(frame_len);
     if (packet == nullptr) { return ZX_ERR_NO_RESOURCES; }
 
+    BufferWriter w(*packet);
+    auto data_hdr = WriteDataFrameHeader(&w, eth_hdr->src, eth_hdr->dest, tid, false);
+
+    auto llc_hdr = w.Write<LlcHeader>();
+    llc_hdr->dsap = kLlcSnapExtension;
+    llc_hdr->ssap = kLlcSnapExtension;
+    llc_hdr->control = kLlcUnnumberedInformation;
+    std::memcpy(llc_hdr->oui, kLlcOui, sizeof(llc_hdr->oui));
+    llc_hdr->protocol_id = eth_hdr->ether_type;
+    w.Write({eth_hdr->payload, eth_frame.body_len()});
+
+    SetDataFrameTxInfo(packet.get(), *data_hdr);
+    packet->set_len(w.WrittenBytes());
+
+    finspect("Outbound data frame: len %zu\n", w.WrittenBytes());
+    finspect("  wlan hdr: %s\n", debug::Describe(*data_hdr).c_str());
+    finspect("  llc  hdr: %s\n", debug::Describe(*llc_hdr).c_str());
+    finspect("  frame   : %s\n", debug::HexDump(packet->data(), packet->len()).c_str());
+
+    auto status = SendWlan(fbl::move(packet));
+    if (status != ZX_OK) { errorf("could not send wlan data: %d\n", status); }
+    return status;
+}
+
+zx_status_t Station::SendAmsdu(uint8_t tid) {
+    if (!amsdu_agg_.HasPending(tid)) { return ZX_OK; }
+
+    auto frames = amsdu_agg_.Take(tid);
+    // A lone MSDU gains nothing from the A-MSDU framing.
+    if (frames.size() == 1) { return SendDataFrame(frames[0], tid); }
+
+    const size_t frame_len = DataFrameHeader::max_len() + AmsduAggregator::AmsduLen(frames);
+
+    auto packet = GetWlanPacket(frame_len);
+    if (packet == nullptr) {
+        debugf("no buffer for A-MSDU of %zu bytes; sending %zu MSDUs individually\n", frame_len,
+               frames.size());
+        zx_status_t status = ZX_OK;
+        for (auto& frame : frames) {
+            status = SendDataFrame(frame, tid);
+        }
+        return status;
+    }
+
+    // IEEE Std 802.11-2016, Table 9-26: Address 3 carries the BSSID when an A-MSDU is sent to
+    // the DS. The SA and DA of each MSDU are in its subframe header.
+    BufferWriter w(*packet);
+    auto data_hdr = WriteDataFrameHeader(&w, self_addr(), join_ctx_->bssid(), tid, true);
+    AmsduAggregator::WriteSubframes(&w, frames);
+
+    SetDataFrameTxInfo(packet.get(), *data_hdr);
+    packet->set_len(w.WrittenBytes());
+
+    finspect("Outbound A-MSDU: len %zu, %zu subframes\n", w.WrittenBytes(), frames.size());
+    finspect("  wlan hdr: %s\n", debug::Describe(*data_hdr).c_str());
+
+    auto status = SendWlan(fbl::move(packet));
+    if (status != ZX_OK) { errorf("could not send A-MSDU: %d\n", status); }
+    return status;
+}
+
+void Station::FlushAmsdus() {
+    amsdu_flush_timeout_.Cancel();
+    for (uint8_t tid = 0; tid < AmsduAggregator::kNumTids; tid++) {
+        SendAmsdu(tid);
+    }
+}
+
+DataFrameHeader* Station::WriteDataFrameHeader(BufferWriter* w, const common::MacAddr& src,
+                                               const common::MacAddr& dest, uint8_t tid,
+                                               bool amsdu) {
     bool needs_protection =
         !join_ctx_->bss()->rsn.is_null() && controlled_port_ == eapol::PortState::kOpen;
-    BufferWriter w(*packet);
 
-    auto data_hdr = w.Write<DataFrameHeader>();
+    auto data_hdr = w->Write<DataFrameHeader>();
     bool has_ht_ctrl = false;
     data_hdr->fc.set_type(FrameType::kData);
     data_hdr->fc.set_subtype(IsQosReady() ? DataSubtype::kQosdata : DataSubtype::kDataSubtype);
@@ -764,55 +996,44 @@ zx_status_t Station::HandleEthFrame(EthFrame&& eth_frame) {
     data_hdr->fc.set_htc_order(has_ht_ctrl ? 1 : 0);
     data_hdr->fc.set_protected_frame(needs_protection);
     data_hdr->addr1 = join_ctx_->bssid();
-    data_hdr->addr2 = eth_hdr->src;
-    data_hdr->addr3 = eth_hdr->dest;
-    SetSeqNo(data_hdr, &seq_);
+    data_hdr->addr2 = src;
+    data_hdr->addr3 = dest;
 
     // TODO(porce): Construct addr4 field
 
     if (IsQosReady()) {  // QoS Control field
-        auto qos_ctrl = w.Write<QosControl>();
-        qos_ctrl->set_tid(GetTid(eth_frame));
+        auto qos_ctrl = w->Write<QosControl>();
+        qos_ctrl->set_tid(tid);
         qos_ctrl->set_eosp(0);
         qos_ctrl->set_ack_policy(ack_policy::kNormalAck);
 
         // AMSDU: set_amsdu_present(1) requires dot11HighthroughputOptionImplemented should be true.
-        qos_ctrl->set_amsdu_present(0);
+        qos_ctrl->set_amsdu_present(amsdu ? 1 : 0);
         qos_ctrl->set_byte(0);
+    } else {
+        ZX_DEBUG_ASSERT(!amsdu);
     }
+    // The sequence number space depends on the TID carried in the QoS Control field.
+    SetSeqNo(data_hdr, &seq_);
 
     // TODO(porce): Construct htc_order field
 
-    auto llc_hdr = w.Write<LlcHeader>();
-    llc_hdr->dsap = kLlcSnapExtension;
-    llc_hdr->ssap = kLlcSnapExtension;
-    llc_hdr->control = kLlcUnnumberedInformation;
-    std::memcpy(llc_hdr->oui, kLlcOui, sizeof(llc_hdr->oui));
-    llc_hdr->protocol_id = eth_hdr->ether_type;
-    w.Write({eth_hdr->payload, eth_frame.body_len()});
+    return data_hdr;
+}
 
+void Station::SetDataFrameTxInfo(Packet* packet, const DataFrameHeader& data_hdr) {
     if (assoc_ctx_.is_ht) {
-        if (assoc_ctx_.is_cbw40_tx && data_hdr->addr3.IsUcast()) {
+        if (assoc_ctx_.is_cbw40_tx && data_hdr.addr3.IsUcast()) {
             // 40 MHz direction does not matter here.
             // Radio uses the operational channel setting. This indicates the bandwidth without
             // direction.
-            packet->CopyCtrlFrom(MakeTxInfo(data_hdr->fc, CBW40, WLAN_PHY_HT));
+            packet->CopyCtrlFrom(MakeTxInfo(data_hdr.fc, CBW40, WLAN_PHY_HT));
         } else {
-            packet->CopyCtrlFrom(MakeTxInfo(data_hdr->fc, CBW20, WLAN_PHY_HT));
+            packet->CopyCtrlFrom(MakeTxInfo(data_hdr.fc, CBW20, WLAN_PHY_HT));
         }
     } else {
-        packet->CopyCtrlFrom(MakeTxInfo(data_hdr->fc, CBW20, WLAN_PHY_OFDM));
+        packet->CopyCtrlFrom(MakeTxInfo(data_hdr.fc, CBW20, WLAN_PHY_OFDM));
     }
-    packet->set_len(w.WrittenBytes());
-
-    finspect("Outbound data frame: len %zu\n", w.WrittenBytes());
-    finspect("  wlan hdr: %s\n", debug::Describe(*data_hdr).c_str());
-    finspect("  llc  hdr: %s\n", debug::Describe(*llc_hdr).c_str());
-    finspect("  frame   : %s\n", debug::HexDump(packet->data(), packet->len()).c_str());
-
-    auto status = SendWlan(fbl::move(packet));
-    if (status != ZX_OK) { errorf("could not send wlan data: %d\n", status); }
-    return status;
 }
 
 zx_status_t Station::HandleTimeout() {
@@ -843,6 +1064,12 @@ zx_status_t Station::HandleTimeout() {
         }
     }
 
+    if (amsdu_flush_timeout_.Triggered(now)) { FlushAmsdus(); }
+
+    for (uint8_t tid = 0; tid < reorder_flush_timeouts_.size(); tid++) {
+        if (reorder_flush_timeouts_[tid].Triggered(now)) { FlushReorderBuffer(tid); }
+    }
+
     if (auto_deauth_timeout_.Triggered(now)) {
         auto_deauth_timeout_.Cancel();
 
@@ -863,6 +1090,8 @@ zx_status_t Station::HandleTimeout() {
             device_->ClearAssoc(join_ctx_->bssid());
             device_->SetStatus(0);
             controlled_port_ = eapol::PortState::kBlocked;
+            amsdu_agg_.Clear();
+            ResetReorderBuffers();
 
             auto reason_code = wlan_mlme::ReasonCode::LEAVING_NETWORK_DEAUTH;
             service::SendDeauthIndication(device_, join_ctx_->bssid(), reason_code);
@@ -1038,6 +1267,8 @@ zx_status_t Station::HandleMlmeSetKeysReq(const MlmeMsg<wlan_mlme::SetKeysReques
 void Station::PreSwitchOffChannel() {
     debugfn();
     if (state_ == WlanState::kAssociated) {
+        // Frames held back for aggregation must not wait for the return to the main channel.
+        FlushAmsdus();
         SetPowerManagementMode(true);
 
         auto_deauth_timeout_.Cancel();
@@ -1270,6 +1501,14 @@ bool Station::IsQosReady() const {
     return assoc_ctx_.is_ht;
 }
 
+bool Station::ShouldAggregate(const EthFrame& frame) const {
+    // A-MSDUs are carried in QoS data frames only. IEEE Std 802.11-2016, 9.2.4.5.9
+    if (!amsdu_agg_.enabled() || !IsQosReady()) { return false; }
+
+    // EAPOL frames go out on their own so the handshake is not delayed by the flush timer.
+    return be16toh(frame.hdr()->ether_type) != kEapolProtocolId;
+}
+
 CapabilityInfo Station::OverrideCapability(CapabilityInfo cap) const {
     // parameter is of 2 bytes
     cap.set_ess(1);            // reserved in client role. 1 for better interop.
@@ -311,7 +311,7 @@ wlan_mlme::StatsQueryResponse Dispatcher::GetStatsToFidl() const {
     auto mlme_stats = mlme_->GetMlmeStats();
     if (!mlme_stats.has_invalid_tag()) {
         stats_response.stats.mlme_stats =
-            std::make_unique<wlan_stats::MlmeStats>(mlme_->GetMlmeStats());
+            std::make_unique<wlan_stats::MlmeStats>(std::move(mlme_stats));
     }
     return stats_response;
 }
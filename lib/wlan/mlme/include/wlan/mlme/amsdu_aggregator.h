@@ -0,0 +1,68 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GARNET_LIB_WLAN_MLME_INCLUDE_WLAN_MLME_AMSDU_AGGREGATOR_H_
+#define GARNET_LIB_WLAN_MLME_INCLUDE_WLAN_MLME_AMSDU_AGGREGATOR_H_
+
+#include <wlan/common/buffer_writer.h>
+#include <wlan/common/element.h>
+#include <wlan/mlme/mac_frame.h>
+
+#include <array>
+#include <vector>
+
+namespace wlan {
+
+// Collects outbound MSDUs destined to a single receiver and packs those of the same TID into
+// A-MSDUs. The aggregator only tracks what is pending; building the MPDU header, sending and
+// scheduling a flush are left to the owner.
+// IEEE Std 802.11-2016, 9.3.2.2
+class AmsduAggregator {
+   public:
+    // IEEE Std 802.11-2016, 9.4.2.56.2, Maximum A-MSDU Length subfield.
+    static constexpr size_t kMaxAmsduLen3839 = 3839;
+    static constexpr size_t kMaxAmsduLen7935 = 7935;
+    // IEEE Std 802.11-2016, 9.2.4.5.2: TID is 4 bit long.
+    static constexpr size_t kNumTids = 16;
+
+    // Returns the largest A-MSDU the peer with the given HT capabilities accepts.
+    static size_t MaxAmsduLen(const HtCapabilities& ht_cap);
+    // Returns the length of the A-MSDU subframe carrying |frame|, excluding padding.
+    static size_t SubframeLen(const EthFrame& frame);
+    // Returns the length of an A-MSDU carrying |frames|.
+    static size_t AmsduLen(const std::vector<EthFrame>& frames);
+    // Writes |frames| as A-MSDU subframes. All but the last subframe are padded to a multiple of
+    // four octets. IEEE Std 802.11-2016, 9.3.2.2.2
+    static void WriteSubframes(BufferWriter* w, const std::vector<EthFrame>& frames);
+
+    // A maximum length of zero disables aggregation. Pending frames are not affected.
+    void set_max_len(size_t max_len) { max_len_ = max_len; }
+    size_t max_len() const { return max_len_; }
+    bool enabled() const { return max_len_ > 0; }
+
+    // Returns `true` if |frame| fits into the A-MSDU pending for |tid|.
+    bool CanAppend(uint8_t tid, const EthFrame& frame) const;
+    // Appends |frame| to the A-MSDU pending for |tid|. The caller must have checked
+    // `CanAppend()` before. Returns `true` if another subframe of the same size would no longer
+    // fit and the A-MSDU should be sent right away.
+    bool Append(uint8_t tid, EthFrame&& frame);
+    // Removes and returns all frames pending for |tid| in the order they were appended.
+    std::vector<EthFrame> Take(uint8_t tid);
+    bool HasPending(uint8_t tid) const { return !pending_[tid].frames.empty(); }
+    bool IsEmpty() const;
+    void Clear();
+
+   private:
+    struct PendingAmsdu {
+        std::vector<EthFrame> frames;
+        size_t len = 0;
+    };
+
+    size_t max_len_ = 0;
+    std::array<PendingAmsdu, kNumTids> pending_;
+};
+
+}  // namespace wlan
+
+#endif  // GARNET_LIB_WLAN_MLME_INCLUDE_WLAN_MLME_AMSDU_AGGREGATOR_H_
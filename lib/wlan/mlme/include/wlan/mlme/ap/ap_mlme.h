@@ -30,6 +30,8 @@ class ApMlme : public Mlme {
     zx_status_t HandleFramePacket(fbl::unique_ptr<Packet> pkt) override;
     zx_status_t HandleTimeout(const ObjectId id) override;
     void HwIndication(uint32_t ind) override;
+    ::fuchsia::wlan::stats::MlmeStats GetMlmeStats() const override final;
+    void ResetMlmeStats() override final;
 
    private:
     zx_status_t HandleMlmeStartReq(const MlmeMsg<::fuchsia::wlan::mlme::StartRequest>& req);
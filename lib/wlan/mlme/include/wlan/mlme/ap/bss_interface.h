@@ -17,6 +17,7 @@
 
 #include <chrono>
 #include <optional>
+#include <vector>
 
 namespace wlan {
 
@@ -35,6 +36,10 @@ class BssInterface {
 
     virtual std::optional<DataFrame<LlcHeader>> EthToDataFrame(const EthFrame& eth_frame,
                                                                bool needs_protection) = 0;
+    // Packs |frames| into a single QoS data frame carrying an A-MSDU addressed to |dest|.
+    virtual std::optional<DataFrame<>> EthToAmsduFrame(const std::vector<EthFrame>& frames,
+                                                       const common::MacAddr& dest, uint8_t tid,
+                                                       bool needs_protection) = 0;
 
     virtual bool IsRsn() const = 0;
     virtual HtConfig Ht() const = 0;
@@ -60,6 +60,9 @@ class InfraBss : public BssInterface, public RemoteClient::Listener {
 
     std::optional<DataFrame<LlcHeader>> EthToDataFrame(const EthFrame& eth_frame,
                                                        bool needs_protection) override;
+    std::optional<DataFrame<>> EthToAmsduFrame(const std::vector<EthFrame>& frames,
+                                               const common::MacAddr& dest, uint8_t tid,
+                                               bool needs_protection) override;
     void OnPreTbtt() override;
     void OnBcnTxComplete() override;
 
@@ -7,6 +7,7 @@
 
 #include <fuchsia/wlan/mlme/cpp/fidl.h>
 #include <wlan/common/buffer_writer.h>
+#include <wlan/mlme/amsdu_aggregator.h>
 #include <wlan/mlme/ap/bss_interface.h>
 #include <wlan/mlme/ap/remote_client_interface.h>
 #include <wlan/mlme/device_interface.h>
@@ -197,11 +198,14 @@ class AssociatingState : public BaseState {
 
     uint16_t aid_;
     TimedEvent assoc_timeout_;
+    // HT Capabilities the client advertised in its Association Request, if any.
+    std::optional<HtCapabilities> ht_cap_;
 };
 
 class AssociatedState : public BaseState {
    public:
-    AssociatedState(RemoteClient* client, uint16_t aid);
+    AssociatedState(RemoteClient* client, uint16_t aid,
+                    const std::optional<HtCapabilities>& ht_cap);
 
     void OnEnter() override;
     void OnExit() override;
@@ -223,6 +227,8 @@ class AssociatedState : public BaseState {
     // mode.
     // TODO(NET-687): Find good BU limit.
     static constexpr size_t kMaxPowerSavingQueueSize = 30;
+    // Longest time an outbound MSDU is held back waiting for others to share its A-MSDU.
+    static constexpr wlan_tu_t kAmsduFlushTimeoutTu = 1;
 
     zx_status_t HandleMlmeEapolReq(const MlmeMsg<::fuchsia::wlan::mlme::EapolRequest>& req);
     zx_status_t HandleMlmeSetKeysReq(const MlmeMsg<::fuchsia::wlan::mlme::SetKeysRequest>& req);
@@ -241,6 +247,10 @@ class AssociatedState : public BaseState {
     void HandlePsPollFrame(CtrlFrame<PsPollFrame>&&);
 
     std::optional<DataFrame<LlcHeader>> EthToDataFrame(const EthFrame& eth_frame);
+    zx_status_t SendDataFrame(const EthFrame& eth_frame);
+    zx_status_t SendAmsdu(uint8_t tid);
+    void FlushAmsdus();
+    bool NeedsProtection() const;
 
     // Enqueues an ethernet frame which can be sent at a later point in time.
     zx_status_t EnqueueEthernetFrame(EthFrame&& frame);
@@ -249,6 +259,7 @@ class AssociatedState : public BaseState {
 
     const uint16_t aid_;
     TimedEvent inactive_timeout_;
+    TimedEvent amsdu_flush_timeout_;
     // `true` if the client was active during the last inactivity timeout.
     bool active_ = false;
     // `true` if the client entered Power Saving mode's doze state.
@@ -256,6 +267,8 @@ class AssociatedState : public BaseState {
     eapol::PortState eapol_controlled_port_ = eapol::PortState::kBlocked;
     // Queue which holds buffered ethernet frames while the client is dozing.
     std::queue<EthFrame> bu_queue_;
+    // Outbound ethernet frames waiting to be sent as part of an A-MSDU.
+    AmsduAggregator amsdu_agg_;
 };
 
 }  // namespace wlan
@@ -23,10 +23,6 @@
 
 namespace wlan {
 
-// BeaconHash is a signature to compare consecutive beacons without memcmp().
-// TODO(porce): Revamp to exclude varying IEs.
-typedef uint32_t BeaconHash;
-
 class Bss : public fbl::RefCounted<Bss> {
    public:
     Bss(const common::MacAddr& bssid) : bssid_(bssid) {
@@ -44,29 +40,53 @@ class Bss : public fbl::RefCounted<Bss> {
     const common::MacAddr& bssid() { return bssid_; }
     zx::time_utc ts_refreshed() { return ts_refreshed_; }
     const ::fuchsia::wlan::mlme::BSSDescription& bss_desc() const { return bss_desc_; }
+    uint8_t dtim_count() const { return dtim_count_; }
+    // Number of elements parsed so far. Elements which did not change since the previous
+    // beacon are not parsed again.
+    size_t elements_parsed() const { return elements_parsed_; }
 
    private:
+    // Identifies the content of an element without keeping a copy of it.
+    struct ElementDigest {
+        uint8_t id;
+        uint32_t hash;
+
+        bool operator==(const ElementDigest& other) const {
+            return id == other.id && hash == other.hash;
+        }
+    };
+
     bool IsBeaconValid(const Beacon& beacon) const;
 
     // Refreshes timestamp and signal strength.
     void Renew(const Beacon& beacon, const wlan_rx_info_t* rx_info);
-    bool HasBeaconChanged(const Beacon& beacon, size_t len) const;
+    // Digests all elements into |next_ie_digests_|. The TIM changes with almost every beacon
+    // and is therefore not digested but read right away.
+    void IndexElements(const uint8_t* ie_chains, size_t ie_chains_len);
+    bool HasBeaconChanged(const Beacon& beacon) const;
 
     // Update content such as IEs.
-    zx_status_t Update(const Beacon& beacon, size_t len);
+    zx_status_t Update(const Beacon& beacon, const uint8_t* ie_chains, size_t ie_chains_len);
     void ParseCapabilityInfo(const CapabilityInfo& cap);
 
-    zx_status_t ParseIE(const uint8_t* ie_chains, size_t ie_chains_len);
-
-    // TODO(porce): Move Beacon method into Beacon class.
-    uint32_t GetBeaconSignature(const Beacon& beacon, size_t len) const;
+    // Parses only the elements which were added or changed since the previous beacon.
+    zx_status_t ParseChangedElements(const uint8_t* ie_chains, size_t ie_chains_len);
+    zx_status_t ParseElement(ElementReader* reader);
+    // Forgets an element which the previous beacon carried but the current one does not.
+    void ClearElement(uint8_t id);
 
     common::MacAddr bssid_;      // From Addr3 of Mgmt Header.
     zx::time_utc ts_refreshed_;  // Last time of Bss object update.
 
     // TODO(porce): Separate into class BeaconTracker.
-    BeaconHash bcn_hash_{0};
-    size_t bcn_len_{0};
+    bool has_bcn_ = false;
+    CapabilityInfo bcn_cap_;
+    // Digests of the previous beacon's elements and the current one's, in order of appearance.
+    // Both are reused from beacon to beacon.
+    std::vector<ElementDigest> ie_digests_;
+    std::vector<ElementDigest> next_ie_digests_;
+    size_t elements_parsed_ = 0;
+    uint8_t dtim_count_ = 0;
     wlan_channel_t bcn_rx_chan_;
 
     // TODO(porce): Add ProbeResponse.
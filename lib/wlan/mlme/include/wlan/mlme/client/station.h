@@ -5,12 +5,14 @@
 #ifndef GARNET_LIB_WLAN_MLME_INCLUDE_WLAN_MLME_CLIENT_STATION_H_
 #define GARNET_LIB_WLAN_MLME_INCLUDE_WLAN_MLME_CLIENT_STATION_H_
 
+#include <wlan/mlme/amsdu_aggregator.h>
 #include <wlan/mlme/client/channel_scheduler.h>
 #include <wlan/mlme/client/join_context.h>
 #include <wlan/mlme/device_interface.h>
 #include <wlan/mlme/eapol.h>
 #include <wlan/mlme/mac_frame.h>
 #include <wlan/mlme/packet.h>
+#include <wlan/mlme/reorder_buffer.h>
 #include <wlan/mlme/sequence.h>
 #include <wlan/mlme/service.h>
 #include <wlan/mlme/timer_manager.h>
@@ -25,6 +27,7 @@
 #include <wlan/protocol/mac.h>
 #include <zircon/types.h>
 
+#include <array>
 #include <optional>
 #include <vector>
 
@@ -105,12 +108,18 @@ class Station {
     static constexpr size_t kSignalReportBcnCountTimeout = 10;
     static constexpr size_t kAutoDeauthBcnCountTimeout = 100;
     static constexpr zx::duration kOnChannelTimeAfterSend = zx::msec(500);
+    // Longest time an outbound MSDU is held back waiting for others to share its A-MSDU.
+    static constexpr zx::duration kAmsduFlushTimeout = zx::msec(1);
+    // Longest time a gap in a Block Ack session holds back the MPDUs received after it.
+    static constexpr zx::duration kReorderFlushTimeout = zx::msec(100);
     // Maximum number of packets buffered while station is in power saving mode.
     // TODO(NET-687): Find good BU limit.
     static constexpr size_t kMaxPowerSavingQueueSize = 30;
 
     zx_status_t HandleAnyMgmtFrame(MgmtFrame<>&&);
     zx_status_t HandleAnyDataFrame(DataFrame<>&&);
+    zx_status_t HandleInOrderDataFrame(DataFrame<>&&);
+    zx_status_t HandleAnyCtrlFrame(CtrlFrame<>&&);
     bool ShouldDropMgmtFrame(const MgmtFrameView<>&);
     zx_status_t HandleBeacon(MgmtFrame<Beacon>&&);
     zx_status_t HandleAuthentication(MgmtFrame<Authentication>&&);
@@ -125,6 +134,16 @@ class Station {
                                const common::MacAddr& src, const common::MacAddr& dest);
     zx_status_t HandleAmsduFrame(DataFrame<AmsduSubframeHeader>&&);
     zx_status_t HandleAddBaRequest(const AddBaRequestFrame&);
+    zx_status_t HandleDelBa(const DelBaFrame&);
+    zx_status_t HandleBlockAckReq(const BlockAckReqFrame&);
+    // Returns the reorder buffer of the Block Ack session |frame| belongs to, if any.
+    ReorderBuffer* FindReorderBuffer(const DataFrameView<>& frame);
+    // Gives the gap at the start of |tid|'s reorder window kReorderFlushTimeout from the time
+    // it opened. |prev_win_start| is where the window started before the buffer was last
+    // changed; a different start means the previous gap was closed or given up on.
+    void UpdateReorderFlushTimeout(uint8_t tid, uint16_t prev_win_start);
+    void FlushReorderBuffer(uint8_t tid);
+    void ResetReorderBuffers();
 
     zx_status_t HandleMlmeJoinReq(const MlmeMsg<::fuchsia::wlan::mlme::JoinRequest>& req);
     zx_status_t HandleMlmeAuthReq(const MlmeMsg<::fuchsia::wlan::mlme::AuthenticateRequest>& req);
@@ -142,6 +161,12 @@ class Station {
     zx_status_t SendPsPoll();
     zx_status_t SendDeauthFrame(::fuchsia::wlan::mlme::ReasonCode reason_code);
     void SendBufferedUnits();
+    zx_status_t SendDataFrame(const EthFrame& eth_frame, uint8_t tid);
+    zx_status_t SendAmsdu(uint8_t tid);
+    void FlushAmsdus();
+    DataFrameHeader* WriteDataFrameHeader(BufferWriter* w, const common::MacAddr& src,
+                                          const common::MacAddr& dest, uint8_t tid, bool amsdu);
+    void SetDataFrameTxInfo(Packet* packet, const DataFrameHeader& data_hdr);
     zx_status_t SendWlan(fbl::unique_ptr<Packet> packet);
     void DumpDataFrame(const DataFrameView<>&);
 
@@ -153,6 +178,7 @@ class Station {
 
     bool IsCbw40Rx() const;
     bool IsQosReady() const;
+    bool ShouldAggregate(const EthFrame& frame) const;
     std::string GetPhyStr() const;
 
     CapabilityInfo OverrideCapability(CapabilityInfo cap) const;
@@ -173,6 +199,9 @@ class Station {
     TimedEvent assoc_timeout_;
     TimedEvent signal_report_timeout_;
     TimedEvent auto_deauth_timeout_;
+    TimedEvent amsdu_flush_timeout_;
+    // Expiry of the gap at the start of each TID's reorder window
+    std::array<TimedEvent, AmsduAggregator::kNumTids> reorder_flush_timeouts_;
     // The remaining time we'll wait for a beacon before deauthenticating (while we are on channel)
     // Note: Off-channel time does not count against `remaining_auto_deauth_timeout_`
     zx::duration remaining_auto_deauth_timeout_ = zx::duration::infinite();
@@ -190,6 +219,10 @@ class Station {
 
     // Queue holding buffered, outbound Ethernet frames
     PacketQueue bu_queue_;
+    // Outbound Ethernet frames waiting to be sent as part of an A-MSDU
+    AmsduAggregator amsdu_agg_;
+    // Inbound MPDUs of the Block Ack session of each TID, if one was established
+    std::array<fbl::unique_ptr<ReorderBuffer>, AmsduAggregator::kNumTids> reorder_bufs_;
 };
 
 const wlan_band_info_t* FindBand(const wlan_info_t& ifc_info, bool is_5ghz);
@@ -12,12 +12,16 @@
 #include <fbl/slab_allocator.h>
 #include <fbl/unique_ptr.h>
 #include <wlan/common/logging.h>
+#include <wlan/common/stats.h>
 #include <wlan/protocol/mac.h>
 #include <zircon/types.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <new>
 #include <string>
 
 typedef struct ethmac_netbuf ethmac_netbuf_t;
@@ -35,18 +39,23 @@ class Buffer {
     virtual void clear(size_t len) = 0;
 };
 
+// kXxxSlabs is the default number of slabs a buffer size may grow to, kMaxXxxSlabs the most any
+// BufferPoolConfig can allow. Slabs are only allocated once they are needed.
 // Huge buffers are used for sending lots of data between drivers and the wlanstack.
 constexpr size_t kHugeSlabs = 2;
+constexpr size_t kMaxHugeSlabs = 8;
 constexpr size_t kHugeBuffers = 8;
 constexpr size_t kHugeBufferSize = 16384;
 // Large buffers can hold the largest 802.11 MSDU, standard Ethernet MTU,
 // or HT A-MSDU of size 3,839 bytes.
 constexpr size_t kLargeSlabs = 20;
+constexpr size_t kMaxLargeSlabs = 80;
 constexpr size_t kLargeBuffers = 32;
 constexpr size_t kLargeBufferSize = 4096;
 // Small buffers are for smaller control packets within the driver stack itself and
 // for transfering small 802.11 frames as well.
 constexpr size_t kSmallSlabs = 40;
+constexpr size_t kMaxSmallSlabs = 80;
 constexpr size_t kSmallBuffers = 512;
 constexpr size_t kSmallBufferSize = 256;
 
@@ -69,11 +78,11 @@ class BufferDebugger<SmallSlabAllocator, LargeSlabAllocator, HugeSlabAllocator,
         // current allocator capacity / maximum allocator capacity
         debugbuf("usage: Small: %zu/%zu/%zu/%zu, Large: %zu/%zu/%zu/%zu, Huge: %zu/%zu/%zu/%zu\n",
                  SmallSlabAllocator::obj_count(), SmallSlabAllocator::max_obj_count(),
-                 SmallSlabAllocator::slab_count() * kSmallBuffers, kSmallSlabs * kSmallBuffers,
+                 SmallSlabAllocator::slab_count() * kSmallBuffers, kMaxSmallSlabs * kSmallBuffers,
                  LargeSlabAllocator::obj_count(), LargeSlabAllocator::max_obj_count(),
-                 LargeSlabAllocator::slab_count() * kLargeBuffers, kLargeSlabs * kLargeBuffers,
+                 LargeSlabAllocator::slab_count() * kLargeBuffers, kMaxLargeSlabs * kLargeBuffers,
                  HugeSlabAllocator::obj_count(), HugeSlabAllocator::max_obj_count(),
-                 HugeSlabAllocator::slab_count() * kHugeBuffers, kHugeSlabs * kHugeBuffers);
+                 HugeSlabAllocator::slab_count() * kHugeBuffers, kMaxHugeSlabs * kHugeBuffers);
     }
 
    private:
@@ -127,7 +136,147 @@ using SlabBufferTraits =
 // so the SlabBuffer itself is also templated on these parameters.
 template <size_t NumBuffers, size_t BufferSize>
 class SlabBuffer final : public internal::FixedBuffer<BufferSize>,
-                         public fbl::SlabAllocated<SlabBufferTraits<NumBuffers, BufferSize>> {};
+                         public fbl::SlabAllocated<SlabBufferTraits<NumBuffers, BufferSize>> {
+   public:
+    // Hands the released buffer to its BufferPool rather than to its slab.
+    static void operator delete(void* ptr);
+};
+
+// A BufferPool sits in front of the slab allocator of one buffer size. Every thread keeps a small
+// cache of released buffers, so most allocations and releases neither take the allocator's lock
+// nor touch memory shared with other threads. A thread's cache goes back to the slabs, where any
+// thread can allocate from, when the thread exits, or when another thread ran out of buffers while
+// some were cached. Occupancy is tracked with atomic counters.
+template <size_t NumBuffers, size_t BufferSize> class BufferPool {
+   public:
+    using BufferType = SlabBuffer<NumBuffers, BufferSize>;
+    using Allocator = fbl::SlabAllocator<SlabBufferTraits<NumBuffers, BufferSize>>;
+    using Allocated = fbl::SlabAllocated<SlabBufferTraits<NumBuffers, BufferSize>>;
+
+    // Number of released buffers each thread keeps for reuse.
+    static constexpr size_t kCacheSize = std::min<size_t>(NumBuffers / 4, 32);
+
+    static fbl::unique_ptr<BufferType> New() {
+        ThreadCache* cache = LocalCache();
+        if (cache != nullptr && cache->len > 0) {
+            stats_.cached.fetch_sub(1, std::memory_order_relaxed);
+            stats_.Acquire();
+            return fbl::unique_ptr<BufferType>(new (cache->buffers[--cache->len]) BufferType());
+        }
+
+        // Cached buffers count towards the limit too, so that the slabs never grow beyond it.
+        // Concurrent allocations may overshoot the limit slightly; the slabs' own capacity is never
+        // exceeded.
+        size_t cached = stats_.cached.load(std::memory_order_relaxed);
+        if (stats_.in_use.load(std::memory_order_relaxed) + cached >=
+            limit_.load(std::memory_order_relaxed)) {
+            // Have the other threads hand their cached buffers back.
+            if (cached > 0) { under_pressure_.store(true, std::memory_order_relaxed); }
+            stats_.exhausted.Inc(1);
+            return nullptr;
+        }
+
+        auto buffer = Allocator::New();
+        if (buffer == nullptr) {
+            stats_.exhausted.Inc(1);
+            return nullptr;
+        }
+        stats_.Acquire();
+        return buffer;
+    }
+
+    // Invoked once the buffer at |ptr| was destroyed.
+    static void Release(void* ptr) {
+        stats_.Release();
+        ThreadCache* cache = LocalCache();
+        if (cache != nullptr && under_pressure_.load(std::memory_order_relaxed)) {
+            Flush(cache);
+        } else if (cache != nullptr && cache->len < kCacheSize) {
+            cache->buffers[cache->len++] = ptr;
+            stats_.cached.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        Allocated::operator delete(ptr);
+    }
+
+    // Caps the number of buffers taken from the slabs, in use or cached, at |limit|.
+    static void set_limit(size_t limit) { limit_.store(limit, std::memory_order_relaxed); }
+    // Raises the cap to |limit| unless it is higher already.
+    static void raise_limit(size_t limit) {
+        size_t current = limit_.load(std::memory_order_relaxed);
+        while (current < limit &&
+               !limit_.compare_exchange_weak(current, limit, std::memory_order_relaxed)) {}
+    }
+    static size_t limit() { return limit_.load(std::memory_order_relaxed); }
+    static common::BufferPoolStats& stats() { return stats_; }
+
+   private:
+    enum class CacheState : uint8_t {
+        kUnused,
+        kActive,
+        // The thread is exiting and its cache was flushed.
+        kFlushed,
+    };
+
+    // Trivially destructible, so that it stays usable while the thread's other thread_local
+    // objects are destroyed. Their destructors may still release buffers.
+    struct ThreadCache {
+        size_t len = 0;
+        void* buffers[kCacheSize] = {};
+        CacheState state = CacheState::kUnused;
+    };
+
+    // Returns the buffers of |cache| to their slabs.
+    static void Flush(ThreadCache* cache) {
+        for (; cache->len > 0; cache->len--) {
+            stats_.cached.fetch_sub(1, std::memory_order_relaxed);
+            Allocated::operator delete(cache->buffers[cache->len - 1]);
+        }
+        if (stats_.cached.load(std::memory_order_relaxed) == 0) {
+            under_pressure_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    // Flushes the thread's cache when the thread exits.
+    struct CacheFlusher {
+        ~CacheFlusher() {
+            Flush(&thread_cache_);
+            thread_cache_.state = CacheState::kFlushed;
+        }
+    };
+
+    // Returns the calling thread's cache, or nullptr once the thread's cache was flushed.
+    static ThreadCache* LocalCache() {
+        auto& cache = thread_cache_;
+        if (cache.state == CacheState::kUnused) {
+            static thread_local CacheFlusher flusher;
+            cache.state = CacheState::kActive;
+        }
+        return cache.state == CacheState::kActive ? &cache : nullptr;
+    }
+
+    static thread_local ThreadCache thread_cache_;
+    static std::atomic<size_t> limit_;
+    // Set while an allocation failed although some threads held cached buffers. Threads then
+    // flush their caches and stop caching until none are cached anymore.
+    static std::atomic<bool> under_pressure_;
+    static common::BufferPoolStats stats_;
+};
+
+template <size_t NumBuffers, size_t BufferSize>
+thread_local typename BufferPool<NumBuffers, BufferSize>::ThreadCache
+    BufferPool<NumBuffers, BufferSize>::thread_cache_;
+template <size_t NumBuffers, size_t BufferSize>
+std::atomic<size_t> BufferPool<NumBuffers, BufferSize>::limit_{std::numeric_limits<size_t>::max()};
+template <size_t NumBuffers, size_t BufferSize>
+std::atomic<bool> BufferPool<NumBuffers, BufferSize>::under_pressure_{false};
+template <size_t NumBuffers, size_t BufferSize>
+common::BufferPoolStats BufferPool<NumBuffers, BufferSize>::stats_;
+
+template <size_t NumBuffers, size_t BufferSize>
+void SlabBuffer<NumBuffers, BufferSize>::operator delete(void* ptr) {
+    BufferPool<NumBuffers, BufferSize>::Release(ptr);
+}
 
 using HugeBufferTraits = SlabBufferTraits<kHugeBuffers, kHugeBufferSize>;
 using LargeBufferTraits = SlabBufferTraits<kLargeBuffers, kLargeBufferSize>;
@@ -135,6 +284,29 @@ using SmallBufferTraits = SlabBufferTraits<kSmallBuffers, kSmallBufferSize>;
 using HugeBufferAllocator = fbl::SlabAllocator<HugeBufferTraits>;
 using LargeBufferAllocator = fbl::SlabAllocator<LargeBufferTraits>;
 using SmallBufferAllocator = fbl::SlabAllocator<SmallBufferTraits>;
+using HugeBufferPool = BufferPool<kHugeBuffers, kHugeBufferSize>;
+using LargeBufferPool = BufferPool<kLargeBuffers, kLargeBufferSize>;
+using SmallBufferPool = BufferPool<kSmallBuffers, kSmallBufferSize>;
+
+// Each pool is capped at the default BufferPoolConfig until it is configured; see packet.cpp.
+template <> std::atomic<size_t> HugeBufferPool::limit_;
+template <> std::atomic<size_t> LargeBufferPool::limit_;
+template <> std::atomic<size_t> SmallBufferPool::limit_;
+
+// Runtime caps on the number of slabs each buffer size may grow to. Caps beyond the compile-time
+// maximum, e.g., kMaxSmallSlabs, are clamped.
+struct BufferPoolConfig {
+    size_t small_slabs = kSmallSlabs;
+    size_t large_slabs = kLargeSlabs;
+    size_t huge_slabs = kHugeSlabs;
+};
+
+void SetBufferPoolConfig(const BufferPoolConfig& config);
+// Raises the caps of the pools to at least those of |config|. The pools are shared by all
+// interfaces of a driver host, so each interface asks for what it needs when it is bound.
+void RaiseBufferPoolConfig(const BufferPoolConfig& config);
+::fuchsia::wlan::stats::PacketBufferStats GetBufferPoolStats();
+void ResetBufferPoolStats();
 
 // Gets a (slab allocated) Buffer with at least |len| bytes capacity.
 fbl::unique_ptr<Buffer> GetBuffer(size_t len);
@@ -0,0 +1,74 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GARNET_LIB_WLAN_MLME_INCLUDE_WLAN_MLME_REORDER_BUFFER_H_
+#define GARNET_LIB_WLAN_MLME_INCLUDE_WLAN_MLME_REORDER_BUFFER_H_
+
+#include <wlan/mlme/packet.h>
+
+#include <fbl/unique_ptr.h>
+#include <wlan/common/stats.h>
+
+#include <array>
+#include <functional>
+
+namespace wlan {
+
+// Restores the order of MPDUs received within a Block Ack session of a single TID.
+// MPDUs are held in a fixed ring indexed by their sequence number and handed to the release
+// callback once all MPDUs preceding them were either received or given up on.
+// IEEE Std 802.11-2016, 10.24.7.6
+class ReorderBuffer {
+   public:
+    // Largest Buffer Size a Block Ack session is accepted with.
+    static constexpr size_t kMaxWindowSize = 64;
+
+    using ReleaseCallback = std::function<void(fbl::unique_ptr<Packet>)>;
+
+    // |win_size| is the Buffer Size negotiated for the session and is clamped to
+    // [1, kMaxWindowSize]. |stats| must outlive the buffer.
+    ReorderBuffer(uint16_t win_start, size_t win_size, common::ReorderStats* stats,
+                  ReleaseCallback release);
+
+    // Accepts the MPDU |pkt| carrying the sequence number |seq|. Every MPDU which is now in
+    // order, possibly including |pkt| itself, is released before this method returns.
+    void Insert(uint16_t seq, fbl::unique_ptr<Packet> pkt);
+    // Releases all MPDUs preceding |ssn| and moves the window to start at |ssn|.
+    // Invoked upon receiving a BlockAckReq frame. IEEE Std 802.11-2016, 10.24.7.7
+    void HandleBlockAckReq(uint16_t ssn);
+    // Gives up on the gap preceding the oldest buffered MPDU and releases everything which
+    // is in order afterwards. Invoked when MPDUs were buffered for too long.
+    void FlushOnTimeout();
+    // Gives up on every gap and releases all buffered MPDUs in order. Invoked when the Block
+    // Ack session is torn down. IEEE Std 802.11-2016, 10.24.5
+    void ReleaseAll();
+    // Drops all buffered MPDUs without releasing them.
+    void Clear();
+
+    bool IsEmpty() const { return buffered_ == 0; }
+    size_t buffered() const { return buffered_; }
+    uint16_t win_start() const { return win_start_; }
+    size_t win_size() const { return win_size_; }
+
+   private:
+    // Returns the slot of the ring holding the MPDU with sequence number |seq|.
+    fbl::unique_ptr<Packet>& Slot(uint16_t seq);
+    // Releases the MPDUs starting at the window's start until the first gap.
+    void ReleaseInOrder();
+    // Moves the window to start at |new_start|, releasing all MPDUs passed on the way.
+    void MoveWindowTo(uint16_t new_start);
+
+    uint16_t win_start_;
+    size_t win_size_;
+    size_t buffered_ = 0;
+    common::ReorderStats* stats_;
+    ReleaseCallback release_;
+    // kMaxWindowSize divides the sequence number space, so sequence numbers within the window
+    // never share a slot.
+    std::array<fbl::unique_ptr<Packet>, kMaxWindowSize> ring_;
+};
+
+}  // namespace wlan
+
+#endif  // GARNET_LIB_WLAN_MLME_INCLUDE_WLAN_MLME_REORDER_BUFFER_H_
@@ -48,7 +48,7 @@ fbl::unique_ptr<Buffer> GetBuffer(size_t len) {
     fbl::unique_ptr<Buffer> buffer;
 
     if (len <= kSmallBufferSize) {
-        buffer = SmallBufferAllocator::New();
+        buffer = SmallBufferPool::New();
         if (buffer != nullptr) {
             return buffer;
         } else {
@@ -57,7 +57,7 @@ fbl::unique_ptr<Buffer> GetBuffer(size_t len) {
     }
 
     if (len <= kLargeBufferSize) {
-        buffer = LargeBufferAllocator::New();
+        buffer = LargeBufferPool::New();
         if (buffer != nullptr) {
             return buffer;
         } else {
@@ -66,7 +66,7 @@ fbl::unique_ptr<Buffer> GetBuffer(size_t len) {
     }
 
     if (len <= kHugeBufferSize) {
-        buffer = HugeBufferAllocator::New();
+        buffer = HugeBufferPool::New();
         if (buffer != nullptr) {
             return buffer;
         } else {
@@ -77,6 +77,42 @@ fbl::unique_ptr<Buffer> GetBuffer(size_t len) {
     return nullptr;
 }
 
+template <> std::atomic<size_t> HugeBufferPool::limit_{kHugeSlabs * kHugeBuffers};
+template <> std::atomic<size_t> LargeBufferPool::limit_{kLargeSlabs * kLargeBuffers};
+template <> std::atomic<size_t> SmallBufferPool::limit_{kSmallSlabs * kSmallBuffers};
+
+void SetBufferPoolConfig(const BufferPoolConfig& config) {
+    SmallBufferPool::set_limit(std::min(config.small_slabs, kMaxSmallSlabs) * kSmallBuffers);
+    LargeBufferPool::set_limit(std::min(config.large_slabs, kMaxLargeSlabs) * kLargeBuffers);
+    HugeBufferPool::set_limit(std::min(config.huge_slabs, kMaxHugeSlabs) * kHugeBuffers);
+}
+
+void RaiseBufferPoolConfig(const BufferPoolConfig& config) {
+    SmallBufferPool::raise_limit(std::min(config.small_slabs, kMaxSmallSlabs) * kSmallBuffers);
+    LargeBufferPool::raise_limit(std::min(config.large_slabs, kMaxLargeSlabs) * kLargeBuffers);
+    HugeBufferPool::raise_limit(std::min(config.huge_slabs, kMaxHugeSlabs) * kHugeBuffers);
+}
+
+template <typename Pool>
+static ::fuchsia::wlan::stats::BufferPoolStats GetPoolStats(size_t max_buffers) {
+    auto stats = Pool::stats().ToFidl();
+    stats.capacity = std::min(Pool::limit(), max_buffers);
+    return stats;
+}
+
+::fuchsia::wlan::stats::PacketBufferStats GetBufferPoolStats() {
+    return ::fuchsia::wlan::stats::PacketBufferStats{
+        .small_buffers = GetPoolStats<SmallBufferPool>(kMaxSmallSlabs * kSmallBuffers),
+        .large_buffers = GetPoolStats<LargeBufferPool>(kMaxLargeSlabs * kLargeBuffers),
+        .huge_buffers = GetPoolStats<HugeBufferPool>(kMaxHugeSlabs * kHugeBuffers)};
+}
+
+void ResetBufferPoolStats() {
+    SmallBufferPool::stats().Reset();
+    LargeBufferPool::stats().Reset();
+    HugeBufferPool::stats().Reset();
+}
+
 fbl::unique_ptr<Packet> GetPacket(size_t len, Packet::Peer peer) {
     auto buffer = GetBuffer(len);
     if (buffer == nullptr) { return nullptr; }
@@ -99,9 +135,8 @@ fbl::unique_ptr<Packet> GetSvcPacket(size_t len) {
 
 }  // namespace wlan
 
-// Definition of static slab allocators.
-// TODO(tkilbourn): tune how many slabs we are willing to grow up to. Reasonably large limits chosen
-// for now.
-DECLARE_STATIC_SLAB_ALLOCATOR_STORAGE(::wlan::HugeBufferTraits, ::wlan::kHugeSlabs, true);
-DECLARE_STATIC_SLAB_ALLOCATOR_STORAGE(::wlan::LargeBufferTraits, ::wlan::kLargeSlabs, true);
-DECLARE_STATIC_SLAB_ALLOCATOR_STORAGE(::wlan::SmallBufferTraits, ::wlan::kSmallSlabs, true);
+// Definition of static slab allocators. They may grow to the most slabs any BufferPoolConfig
+// allows; the pools' limits keep them at the configured number.
+DECLARE_STATIC_SLAB_ALLOCATOR_STORAGE(::wlan::HugeBufferTraits, ::wlan::kMaxHugeSlabs, true);
+DECLARE_STATIC_SLAB_ALLOCATOR_STORAGE(::wlan::LargeBufferTraits, ::wlan::kMaxLargeSlabs, true);
+DECLARE_STATIC_SLAB_ALLOCATOR_STORAGE(::wlan::SmallBufferTraits, ::wlan::kMaxSmallSlabs, true);
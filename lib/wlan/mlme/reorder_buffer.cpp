@@ -0,0 +1,153 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <wlan/mlme/reorder_buffer.h>
+
+#include <wlan/common/mac_frame.h>
+#include <zircon/assert.h>
+
+#include <algorithm>
+
+namespace wlan {
+
+static_assert((kMaxSequenceNumber + 1) % ReorderBuffer::kMaxWindowSize == 0,
+              "window size must divide the sequence number space");
+
+// IEEE Std 802.11-2016, 10.3.2.11.1: sequence numbers are compared modulo 4096. Sequence
+// numbers at most half the space ahead of the window's start are considered newer.
+static constexpr uint16_t kSeqHalfSpace = (kMaxSequenceNumber + 1) / 2;
+
+static uint16_t SeqAdd(uint16_t seq, size_t n) {
+    return static_cast<uint16_t>((seq + n) & kMaxSequenceNumber);
+}
+
+// Returns how far |seq| is ahead of |start|.
+static uint16_t SeqDelta(uint16_t start, uint16_t seq) {
+    return static_cast<uint16_t>((seq - start) & kMaxSequenceNumber);
+}
+
+ReorderBuffer::ReorderBuffer(uint16_t win_start, size_t win_size, common::ReorderStats* stats,
+                             ReleaseCallback release)
+    : win_start_(win_start & kMaxSequenceNumber),
+      win_size_(std::clamp<size_t>(win_size, 1, kMaxWindowSize)),
+      stats_(stats),
+      release_(std::move(release)) {
+    ZX_DEBUG_ASSERT(stats_ != nullptr);
+    ZX_DEBUG_ASSERT(release_);
+}
+
+fbl::unique_ptr<Packet>& ReorderBuffer::Slot(uint16_t seq) {
+    return ring_[seq % kMaxWindowSize];
+}
+
+void ReorderBuffer::Insert(uint16_t seq, fbl::unique_ptr<Packet> pkt) {
+    ZX_DEBUG_ASSERT(pkt != nullptr);
+
+    seq &= kMaxSequenceNumber;
+    uint16_t delta = SeqDelta(win_start_, seq);
+    if (delta >= kSeqHalfSpace) {
+        // Already released or given up on.
+        stats_->duplicate.Inc(1);
+        return;
+    }
+
+    // A sequence number beyond the window's end moves the window such that it becomes the
+    // window's last one.
+    if (delta >= win_size_) {
+        MoveWindowTo(SeqAdd(seq, kMaxSequenceNumber + 1 - (win_size_ - 1)));
+        delta = SeqDelta(win_start_, seq);
+    }
+
+    auto& slot = Slot(seq);
+    if (slot != nullptr) {
+        stats_->duplicate.Inc(1);
+        return;
+    }
+
+    if (delta == 0) {
+        stats_->in_order.Inc(1);
+        win_start_ = SeqAdd(win_start_, 1);
+        release_(std::move(pkt));
+    } else {
+        stats_->buffered.Inc(1);
+        slot = std::move(pkt);
+        buffered_++;
+    }
+    ReleaseInOrder();
+}
+
+void ReorderBuffer::HandleBlockAckReq(uint16_t ssn) {
+    stats_->bar_flush.Inc(1);
+
+    ssn &= kMaxSequenceNumber;
+    uint16_t delta = SeqDelta(win_start_, ssn);
+    // A BlockAckReq which does not move the window forward has no effect.
+    if (delta == 0 || delta >= kSeqHalfSpace) { return; }
+
+    MoveWindowTo(ssn);
+    ReleaseInOrder();
+}
+
+void ReorderBuffer::FlushOnTimeout() {
+    if (IsEmpty()) { return; }
+    stats_->timeout_flush.Inc(1);
+
+    while (Slot(win_start_) == nullptr) {
+        stats_->lost.Inc(1);
+        win_start_ = SeqAdd(win_start_, 1);
+    }
+    ReleaseInOrder();
+}
+
+void ReorderBuffer::ReleaseAll() {
+    while (buffered_ > 0) {
+        if (Slot(win_start_) == nullptr) {
+            stats_->lost.Inc(1);
+            win_start_ = SeqAdd(win_start_, 1);
+            continue;
+        }
+        ReleaseInOrder();
+    }
+}
+
+void ReorderBuffer::Clear() {
+    for (auto& slot : ring_) {
+        slot.reset();
+    }
+    buffered_ = 0;
+}
+
+void ReorderBuffer::ReleaseInOrder() {
+    while (buffered_ > 0) {
+        auto& slot = Slot(win_start_);
+        if (slot == nullptr) { return; }
+
+        auto pkt = std::move(slot);
+        buffered_--;
+        win_start_ = SeqAdd(win_start_, 1);
+        release_(std::move(pkt));
+    }
+}
+
+void ReorderBuffer::MoveWindowTo(uint16_t new_start) {
+    uint16_t delta = SeqDelta(win_start_, new_start);
+    for (; delta > 0 && buffered_ > 0; delta--) {
+        auto& slot = Slot(win_start_);
+        win_start_ = SeqAdd(win_start_, 1);
+        if (slot == nullptr) {
+            stats_->lost.Inc(1);
+            continue;
+        }
+
+        auto pkt = std::move(slot);
+        buffered_--;
+        release_(std::move(pkt));
+    }
+
+    // Nothing is buffered past this point. The remaining sequence numbers were never received.
+    if (delta > 0) { stats_->lost.Inc(delta); }
+    win_start_ = new_start;
+}
+
+}  // namespace wlan
@@ -79,6 +79,10 @@ struct ApInfraBssTest : public ::testing::Test {
         return HandleFrame([](auto pkt) { return CreateAssocReqFrame(pkt); });
     }
 
+    zx_status_t SendClientHtAssocReqFrame() {
+        return HandleFrame([](auto pkt) { return CreateHtAssocReqFrame(pkt, HtCapabilities{}); });
+    }
+
     zx_status_t SendClientDisassocFrame() {
         return HandleFrame([](auto pkt) { return CreateDisassocFrame(pkt); });
     }
@@ -175,6 +179,13 @@ struct ApInfraBssTest : public ::testing::Test {
         device.wlan_queue.clear();
     }
 
+    void AssociateHtClient() {
+        SendClientHtAssocReqFrame();
+        SendAssocResponseMsg(wlan_mlme::AssociateResultCodes::SUCCESS);
+        device.svc_queue.clear();
+        device.wlan_queue.clear();
+    }
+
     void AuthenticateAndAssociateClient() {
         AuthenticateClient();
         AssociateClient();
@@ -553,6 +564,40 @@ TEST_F(ApInfraBssTest, SendFrameAfterAssociation) {
     AssertDataFrameSentToClient(fbl::move(pkt), kTestPayload);
 }
 
+TEST_F(ApInfraBssTest, AggregateFramesToHtClient) {
+    StartAp();
+    AuthenticateClient();
+    AssociateHtClient();
+
+    // Frames are held back for a short moment in case more frames follow.
+    for (size_t i = 0; i < 3; i++) {
+        SendEthFrame(kTestPayload);
+    }
+    EXPECT_TRUE(device.wlan_queue.empty());
+
+    SetTimeInTuPeriods(1);
+    bss.HandleTimeout(common::MacAddr(kClientAddress));
+    ASSERT_EQ(device.wlan_queue.size(), static_cast<size_t>(1));
+
+    auto pkt = std::move(*device.wlan_queue.begin());
+    auto frame = TypeCheckWlanFrame<DataFrameView<AmsduSubframeHeader>>(pkt.get());
+    ASSERT_TRUE(frame);
+    EXPECT_EQ(frame.hdr()->fc.from_ds(), 1);
+    EXPECT_EQ(frame.hdr()->fc.to_ds(), 0);
+    EXPECT_EQ(frame.hdr()->qos_ctrl()->amsdu_present(), 1);
+    EXPECT_EQ(std::memcmp(frame.hdr()->addr1.byte, kClientAddress, 6), 0);
+    EXPECT_EQ(std::memcmp(frame.hdr()->addr2.byte, kBssid1, 6), 0);
+    EXPECT_EQ(std::memcmp(frame.hdr()->addr3.byte, kBssid1, 6), 0);
+
+    size_t msdu_count = 0;
+    DeaggregateAmsdu(frame, [&](FrameView<LlcHeader> llc_frame, size_t payload_len) {
+        msdu_count++;
+        EXPECT_EQ(payload_len, kTestPayload.size());
+        EXPECT_EQ(std::memcmp(llc_frame.hdr()->payload, kTestPayload.data(), payload_len), 0);
+    });
+    EXPECT_EQ(msdu_count, static_cast<size_t>(3));
+}
+
 TEST_F(ApInfraBssTest, UnprotectedApReceiveFramesAfterAssociation) {
     StartAp(false);
 
@@ -0,0 +1,99 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+
+#include <wlan/mlme/client/bss.h>
+
+#include "test_data.h"
+
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace wlan {
+namespace {
+
+constexpr size_t kBssCount = 128;
+constexpr size_t kElementChangeInterval = 100;
+
+// Returns the offset of the first element with the given |id| within the beacon |body|.
+size_t FindElement(const std::vector<uint8_t>& body, uint8_t id) {
+    ElementReader reader(body.data() + Beacon::max_len(), body.size() - Beacon::max_len());
+    while (const ElementHeader* hdr = reader.peek()) {
+        if (hdr->id == id) { return Beacon::max_len() + reader.offset(); }
+        reader.skip(*hdr);
+    }
+    ZX_ASSERT_MSG(false, "no element with id %u", static_cast<unsigned>(id));
+    return 0;
+}
+
+// The captured beacon, as sent by one AP.
+struct BeaconReplay {
+    BeaconReplay() {
+        auto& frame = test_data::kBeaconFrame;
+        auto hdr_len = reinterpret_cast<const MgmtFrameHeader*>(frame.data())->len();
+        body.assign(frame.begin() + hdr_len, frame.end());
+        tim_offset = FindElement(body, element_id::kTim);
+        body[tim_offset + sizeof(ElementHeader) + 1] = 3;  // DTIM period
+        rx_info.chan.primary = 48;
+    }
+
+    zx_status_t Replay(Bss* bss) {
+        auto bcn = reinterpret_cast<Beacon*>(body.data());
+        bcn->timestamp++;
+        return bss->ProcessBeacon(*bcn, body.size(), &rx_info);
+    }
+
+    // Advances the DTIM count like an AP does with every beacon.
+    void NextTim() {
+        auto tim_hdr = reinterpret_cast<TimHeader*>(&body[tim_offset + sizeof(ElementHeader)]);
+        tim_hdr->dtim_count = (tim_hdr->dtim_count + 1) % tim_hdr->dtim_period;
+        tim_hdr->bmp_ctrl.set_group_traffic_ind(tim_hdr->dtim_count == 0);
+    }
+
+    std::vector<uint8_t> body;
+    size_t tim_offset;
+    wlan_rx_info_t rx_info{};
+};
+
+// Replays the captured beacon as if it was sent by |kBssCount| APs. Each run processes one beacon
+// from every AP. Besides the TIM, each AP changes one of its elements every
+// |kElementChangeInterval| beacons.
+bool ReplayCapturedBeaconsTest(perftest::RepeatState* state) {
+    std::unordered_map<size_t, Bss> bss_map;
+    std::vector<BeaconReplay> replays(kBssCount);
+    for (size_t i = 0; i < kBssCount; i++) {
+        uint8_t bssid[6] = {0x40, 0xe3, 0xd6, 0xbf, 0x00, static_cast<uint8_t>(i)};
+        bss_map.emplace(std::piecewise_construct, std::forward_as_tuple(i),
+                        std::forward_as_tuple(common::MacAddr(bssid)));
+    }
+
+    size_t bss_load_offset = FindElement(replays[0].body, element_id::kBssLoad);
+    for (size_t n = 0; state->KeepRunning(); n++) {
+        for (size_t i = 0; i < kBssCount; i++) {
+            auto& replay = replays[i];
+            replay.NextTim();
+            if (n > 0 && n % kElementChangeInterval == 0) {
+                // Station count of the BSS Load element.
+                replay.body[bss_load_offset + sizeof(ElementHeader)]++;
+            }
+            ZX_ASSERT(replay.Replay(&bss_map.at(i)) == ZX_OK);
+        }
+    }
+    return true;
+}
+
+void RegisterTests() {
+    perftest::RegisterTest("Wlan/Bss/ReplayCapturedBeacons", ReplayCapturedBeaconsTest);
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
+}  // namespace wlan
+
+int main(int argc, char** argv) {
+    return perftest::PerfTestMain(argc, argv, "fuchsia.wlan");
+}
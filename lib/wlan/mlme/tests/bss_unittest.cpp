@@ -7,11 +7,127 @@
 #include <wlan/common/channel.h>
 #include <wlan/mlme/client/bss.h>
 
+#include "test_data.h"
+
+#include <vector>
+
 namespace wlan {
 namespace {
 
 namespace wlan_mlme = ::fuchsia::wlan::mlme;
 
+// Number of elements in the captured beacon, including the TIM.
+constexpr size_t kCapturedBeaconElementCount = 17;
+constexpr uint8_t kBeaconFrameBssid[] = {0x40, 0xe3, 0xd6, 0xbf, 0xf1, 0x71};
+
+// Returns the body of the captured beacon, i.e., the frame without its MAC header.
+std::vector<uint8_t> CapturedBeaconBody() {
+    auto& frame = test_data::kBeaconFrame;
+    auto hdr_len = reinterpret_cast<const MgmtFrameHeader*>(frame.data())->len();
+    return std::vector<uint8_t>(frame.begin() + hdr_len, frame.end());
+}
+
+// Returns the offset of the first element with the given |id| within the beacon |body|.
+size_t FindElement(const std::vector<uint8_t>& body, uint8_t id) {
+    ElementReader reader(body.data() + Beacon::max_len(), body.size() - Beacon::max_len());
+    while (const ElementHeader* hdr = reader.peek()) {
+        if (hdr->id == id) { return Beacon::max_len() + reader.offset(); }
+        reader.skip(*hdr);
+    }
+    ADD_FAILURE() << "no element with id " << static_cast<int>(id);
+    return 0;
+}
+
+struct BeaconReplay {
+    BeaconReplay() : body(CapturedBeaconBody()), tim_offset(FindElement(body, element_id::kTim)) {
+        rx_info.chan.primary = 48;
+    }
+
+    zx_status_t Replay(Bss* bss) {
+        auto bcn = reinterpret_cast<Beacon*>(body.data());
+        bcn->timestamp++;
+        return bss->ProcessBeacon(*bcn, body.size(), &rx_info);
+    }
+
+    // Advances the DTIM count like an AP does with every beacon.
+    void NextTim() {
+        auto tim_hdr = reinterpret_cast<TimHeader*>(&body[tim_offset + sizeof(ElementHeader)]);
+        tim_hdr->dtim_count = (tim_hdr->dtim_count + 1) % tim_hdr->dtim_period;
+        tim_hdr->bmp_ctrl.set_group_traffic_ind(tim_hdr->dtim_count == 0);
+    }
+
+    std::vector<uint8_t> body;
+    size_t tim_offset;
+    wlan_rx_info_t rx_info{};
+};
+
+TEST(BssTest, ParseCapturedBeacon) {
+    Bss bss(common::MacAddr(kBeaconFrameBssid));
+    BeaconReplay replay;
+    ASSERT_EQ(replay.Replay(&bss), ZX_OK);
+
+    auto& desc = bss.bss_desc();
+    EXPECT_EQ(std::string(desc.ssid->begin(), desc.ssid->end()), "GoogleGuest");
+    EXPECT_EQ(desc.beacon_period, 100);
+    EXPECT_EQ(desc.dtim_period, 1);
+    EXPECT_NE(desc.ht_cap, nullptr);
+    EXPECT_NE(desc.ht_op, nullptr);
+    EXPECT_NE(desc.vht_cap, nullptr);
+    EXPECT_NE(desc.vht_op, nullptr);
+    EXPECT_EQ(bss.elements_parsed(), kCapturedBeaconElementCount - 1);
+}
+
+TEST(BssTest, SkipElementsOfUnchangedBeacon) {
+    Bss bss(common::MacAddr(kBeaconFrameBssid));
+    BeaconReplay replay;
+    replay.body[replay.tim_offset + sizeof(ElementHeader) + 1] = 3;  // DTIM period
+    ASSERT_EQ(replay.Replay(&bss), ZX_OK);
+    size_t parsed = bss.elements_parsed();
+
+    // Only the timestamp and the TIM change from beacon to beacon.
+    for (uint8_t want_dtim_count : {1, 2, 0, 1}) {
+        replay.NextTim();
+        ASSERT_EQ(replay.Replay(&bss), ZX_OK);
+        EXPECT_EQ(bss.dtim_count(), want_dtim_count);
+        EXPECT_EQ(bss.bss_desc().dtim_period, 3);
+    }
+    EXPECT_EQ(bss.elements_parsed(), parsed);
+}
+
+TEST(BssTest, ParseChangedElementOnly) {
+    Bss bss(common::MacAddr(kBeaconFrameBssid));
+    BeaconReplay replay;
+    ASSERT_EQ(replay.Replay(&bss), ZX_OK);
+    size_t parsed = bss.elements_parsed();
+
+    // Rename the SSID from "GoogleGuest" to "GoogleGuesT".
+    size_t ssid_offset = FindElement(replay.body, element_id::kSsid);
+    replay.body[ssid_offset + sizeof(ElementHeader) + 10] = 'T';
+    ASSERT_EQ(replay.Replay(&bss), ZX_OK);
+
+    auto& ssid = *bss.bss_desc().ssid;
+    EXPECT_EQ(std::string(ssid.begin(), ssid.end()), "GoogleGuesT");
+    EXPECT_EQ(bss.elements_parsed(), parsed + 1);
+}
+
+TEST(BssTest, ForgetRemovedElement) {
+    Bss bss(common::MacAddr(kBeaconFrameBssid));
+    BeaconReplay replay;
+    ASSERT_EQ(replay.Replay(&bss), ZX_OK);
+    ASSERT_NE(bss.bss_desc().vht_op, nullptr);
+    size_t parsed = bss.elements_parsed();
+
+    // Drop the VHT Operation element.
+    size_t offset = FindElement(replay.body, element_id::kVhtOperation);
+    size_t len = sizeof(ElementHeader) + replay.body[offset + 1];
+    replay.body.erase(replay.body.begin() + offset, replay.body.begin() + offset + len);
+    ASSERT_EQ(replay.Replay(&bss), ZX_OK);
+
+    EXPECT_EQ(bss.bss_desc().vht_op, nullptr);
+    EXPECT_NE(bss.bss_desc().vht_cap, nullptr);
+    EXPECT_EQ(bss.elements_parsed(), parsed);
+}
+
 TEST(BssTest, DeriveChannel) {
     wlan_mlme::BSSDescription desc;
     uint8_t bcn_chan = 0;
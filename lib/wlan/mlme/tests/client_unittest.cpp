@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <lib/timekeeper/clock.h>
+#include <wlan/mlme/amsdu_aggregator.h>
 #include <wlan/mlme/client/channel_scheduler.h>
 #include <wlan/mlme/client/station.h>
 #include <wlan/mlme/mac_frame.h>
@@ -88,8 +89,45 @@ struct ClientTest : public ::testing::Test {
         return ZX_OK;
     }
 
-    zx_status_t SendEthFrame() {
-        auto eth_frame = CreateEthFrame(kTestPayload, sizeof(kTestPayload));
+    // The single payload octet carries the sequence number to identify the MSDU once passed up.
+    zx_status_t SendQosDataFrame(uint8_t tid, uint16_t seq) {
+        uint8_t payload = static_cast<uint8_t>(seq);
+        auto frame = CreateQosDataFrame(&payload, sizeof(payload), tid, seq);
+        if (frame.IsEmpty()) { return ZX_ERR_NO_RESOURCES; }
+        station.HandleAnyWlanFrame(frame.Take());
+        return ZX_OK;
+    }
+
+    zx_status_t SendBlockAckReq(uint8_t tid, uint16_t ssn) {
+        fbl::unique_ptr<Packet> pkt;
+        auto status = CreateBlockAckReqFrame(&pkt, tid, ssn);
+        if (status != ZX_OK) { return status; }
+        station.HandleAnyWlanFrame(fbl::move(pkt));
+        return ZX_OK;
+    }
+
+    void EstablishBlockAckSession(uint8_t tid, uint16_t ssn, size_t buffer_size) {
+        fbl::unique_ptr<Packet> pkt;
+        ASSERT_EQ(CreateAddBaReqFrame(&pkt, tid, ssn, buffer_size), ZX_OK);
+        station.HandleAnyWlanFrame(fbl::move(pkt));
+        // Drop the ADDBA Response.
+        device.wlan_queue.clear();
+    }
+
+    std::vector<uint8_t> GetReceivedPayloads() {
+        std::vector<uint8_t> payloads;
+        for (auto& pkt : device.GetEthPackets()) {
+            EthFrameView frame(pkt.get());
+            EXPECT_EQ(frame.body_len(), static_cast<size_t>(1));
+            payloads.push_back(frame.body()->data[0]);
+        }
+        return payloads;
+    }
+
+    zx_status_t SendEthFrame() { return SendEthFrame(kTestPayload, sizeof(kTestPayload)); }
+
+    zx_status_t SendEthFrame(const uint8_t* payload, size_t len) {
+        auto eth_frame = CreateEthFrame(payload, len);
         if (eth_frame.IsEmpty()) { return ZX_ERR_NO_RESOURCES; }
         station.HandleEthFrame(EthFrame(eth_frame.Take()));
         return ZX_OK;
@@ -127,6 +165,32 @@ struct ClientTest : public ::testing::Test {
         station.HandleTimeout();
     }
 
+    void AssociateHt(const HtCapabilities& ap_ht_cap = HtCapabilities{}) {
+        // Both the client and the AP advertise HT which makes the link use QoS data frames.
+        device.wlanmac_info.ifc_info.supported_phys |= WLAN_PHY_HT;
+        device.wlanmac_info.ifc_info.bands[0].ht_supported = true;
+
+        SendMlmeMsg<wlan_mlme::AssociateRequest>();
+        fbl::unique_ptr<Packet> pkt;
+        ASSERT_EQ(CreateHtAssocRespFrame(&pkt, ap_ht_cap), ZX_OK);
+        station.HandleAnyWlanFrame(fbl::move(pkt));
+        device.svc_queue.clear();
+        device.wlan_queue.clear();
+        station.HandleTimeout();
+        chan_sched.HandleTimeout();
+    }
+
+    void ConnectHt() {
+        Authenticate();
+        AssociateHt();
+        station.HandleTimeout();
+    }
+
+    void TriggerAmsduFlushTimeout() {
+        device.SetTime(device.GetTime() + zx::msec(1));
+        station.HandleTimeout();
+    }
+
     zx::duration BeaconPeriodsToDuration(size_t periods) {
         return zx::usec(1024) * (periods * kBeaconPeriodTu);
     }
@@ -606,6 +670,354 @@ TEST_F(ClientTest, BufferFramesWhileOffChannelAndSendWhenOnChannel) {
     ASSERT_EQ(std::memcmp(llc_hdr->payload, kTestPayload, sizeof(kTestPayload)), 0);
 }
 
+// Returns the payloads of all MSDUs carried in the given A-MSDU.
+std::vector<std::vector<uint8_t>> DeaggregateOutboundAmsdu(Packet* pkt) {
+    std::vector<std::vector<uint8_t>> msdus;
+    auto frame = DataFrameView<AmsduSubframeHeader>::CheckType(pkt).CheckLength();
+    EXPECT_TRUE(frame);
+    if (!frame) { return msdus; }
+
+    DeaggregateAmsdu(frame, [&](FrameView<LlcHeader> llc_frame, size_t payload_len) {
+        auto payload = llc_frame.hdr()->payload;
+        msdus.emplace_back(payload, payload + payload_len);
+    });
+    return msdus;
+}
+
+TEST_F(ClientTest, AggregateOutboundMsdusOnHtLink) {
+    ConnectHt();
+
+    // Frames are held back for a short moment in case more frames follow.
+    for (size_t i = 0; i < 3; i++) {
+        SendEthFrame();
+    }
+    ASSERT_TRUE(device.wlan_queue.empty());
+
+    TriggerAmsduFlushTimeout();
+    ASSERT_EQ(device.wlan_queue.size(), static_cast<size_t>(1));
+
+    auto pkt = std::move(*device.wlan_queue.begin());
+    ASSERT_EQ(pkt->peer(), Packet::Peer::kWlan);
+    auto frame = DataFrameView<AmsduSubframeHeader>::CheckType(pkt.get()).CheckLength();
+    ASSERT_TRUE(frame);
+    EXPECT_EQ(frame.hdr()->fc.subtype(), DataSubtype::kQosdata);
+    EXPECT_EQ(frame.hdr()->fc.to_ds(), 1);
+    EXPECT_EQ(frame.hdr()->fc.from_ds(), 0);
+    EXPECT_EQ(frame.hdr()->qos_ctrl()->amsdu_present(), 1);
+    EXPECT_EQ(std::memcmp(frame.hdr()->addr1.byte, kBssid1, 6), 0);
+    EXPECT_EQ(std::memcmp(frame.hdr()->addr2.byte, kClientAddress, 6), 0);
+    EXPECT_EQ(std::memcmp(frame.hdr()->addr3.byte, kBssid1, 6), 0);
+
+    auto subframe = frame.SkipHeader();
+    ASSERT_TRUE(subframe);
+    EXPECT_EQ(std::memcmp(subframe.hdr()->da.byte, kBssid1, 6), 0);
+    EXPECT_EQ(std::memcmp(subframe.hdr()->sa.byte, kClientAddress, 6), 0);
+
+    auto msdus = DeaggregateOutboundAmsdu(pkt.get());
+    ASSERT_EQ(msdus.size(), static_cast<size_t>(3));
+    for (auto& msdu : msdus) {
+        ASSERT_EQ(msdu.size(), sizeof(kTestPayload));
+        EXPECT_EQ(std::memcmp(msdu.data(), kTestPayload, sizeof(kTestPayload)), 0);
+    }
+
+    // Nothing is left to be sent.
+    TriggerAmsduFlushTimeout();
+    ASSERT_TRUE(device.wlan_queue.empty());
+}
+
+TEST_F(ClientTest, SendLoneMsduWithoutAmsduFraming) {
+    ConnectHt();
+
+    SendEthFrame();
+    TriggerAmsduFlushTimeout();
+    ASSERT_EQ(device.wlan_queue.size(), static_cast<size_t>(1));
+
+    auto pkt = std::move(*device.wlan_queue.begin());
+    auto frame = DataFrameView<LlcHeader>::CheckType(pkt.get()).CheckLength();
+    ASSERT_TRUE(frame);
+    EXPECT_EQ(frame.hdr()->fc.subtype(), DataSubtype::kQosdata);
+    EXPECT_EQ(frame.hdr()->qos_ctrl()->amsdu_present(), 0);
+
+    auto llc_hdr = frame.body();
+    ASSERT_EQ(frame.body_len() - llc_hdr->len(), sizeof(kTestPayload));
+    EXPECT_EQ(std::memcmp(llc_hdr->payload, kTestPayload, sizeof(kTestPayload)), 0);
+}
+
+TEST_F(ClientTest, AmsduRespectsPeerMaxLength) {
+    ConnectHt();
+
+    // Two MTU sized frames fill an A-MSDU of 3839 octets, the smallest every HT STA supports.
+    std::vector<uint8_t> payload(1500, 0xAB);
+    for (size_t i = 0; i < 5; i++) {
+        SendEthFrame(payload.data(), payload.size());
+    }
+
+    // Full A-MSDUs are sent right away, the remaining frame waits for the flush timeout.
+    auto pkts = device.GetWlanPackets();
+    ASSERT_EQ(pkts.size(), static_cast<size_t>(2));
+    for (auto& pkt : pkts) {
+        auto frame = DataFrameView<AmsduSubframeHeader>::CheckType(pkt.get()).CheckLength();
+        ASSERT_TRUE(frame);
+        EXPECT_LE(frame.body_len(), AmsduAggregator::kMaxAmsduLen3839);
+
+        auto msdus = DeaggregateOutboundAmsdu(pkt.get());
+        ASSERT_EQ(msdus.size(), static_cast<size_t>(2));
+        for (auto& msdu : msdus) {
+            EXPECT_EQ(msdu, payload);
+        }
+    }
+
+    TriggerAmsduFlushTimeout();
+    pkts = device.GetWlanPackets();
+    ASSERT_EQ(pkts.size(), static_cast<size_t>(1));
+    EXPECT_TRUE(DataFrameView<LlcHeader>::CheckType(pkts[0].get()).CheckLength());
+}
+
+TEST_F(ClientTest, AmsduUsesLargerPeerMaxLength) {
+    // Both ends are capable of receiving 7935 octet A-MSDUs.
+    device.wlanmac_info.ifc_info.bands[0].ht_caps.ht_capability_info |= (1 << 11);
+    HtCapabilities ap_ht_cap{};
+    ap_ht_cap.ht_cap_info.set_max_amsdu_len(HtCapabilityInfo::OCTETS_7935);
+
+    Authenticate();
+    AssociateHt(ap_ht_cap);
+
+    std::vector<uint8_t> payload(1500, 0xAB);
+    for (size_t i = 0; i < 5; i++) {
+        SendEthFrame(payload.data(), payload.size());
+    }
+    auto pkts = device.GetWlanPackets();
+    ASSERT_EQ(pkts.size(), static_cast<size_t>(1));
+    auto frame = DataFrameView<AmsduSubframeHeader>::CheckType(pkts[0].get()).CheckLength();
+    ASSERT_TRUE(frame);
+    EXPECT_GT(frame.body_len(), AmsduAggregator::kMaxAmsduLen3839);
+    EXPECT_LE(frame.body_len(), AmsduAggregator::kMaxAmsduLen7935);
+    EXPECT_EQ(DeaggregateOutboundAmsdu(pkts[0].get()).size(), static_cast<size_t>(5));
+}
+
+TEST_F(ClientTest, NoAggregationOnNonHtLink) {
+    Connect();
+
+    for (size_t i = 0; i < 3; i++) {
+        SendEthFrame();
+    }
+    auto pkts = device.GetWlanPackets();
+    ASSERT_EQ(pkts.size(), static_cast<size_t>(3));
+    for (auto& pkt : pkts) {
+        auto frame = DataFrameView<LlcHeader>::CheckType(pkt.get()).CheckLength();
+        ASSERT_TRUE(frame);
+        EXPECT_EQ(frame.hdr()->fc.subtype(), DataSubtype::kDataSubtype);
+    }
+}
+
+// Rough airtime of a single frame exchange at HT MCS 7 on a 20 MHz channel. Contention, PHY
+// preamble, SIFS and the acknowledgement are charged once per MPDU.
+zx::duration EstimateAirtime(size_t mpdu_len) {
+    constexpr zx::duration kPerMpduOverhead = zx::usec(34 + 36 + 16 + 44);
+    constexpr uint64_t kMbps = 65;
+    return kPerMpduOverhead + zx::nsec(mpdu_len * 8 * 1000 / kMbps);
+}
+
+TEST_F(ClientTest, AmsduThroughputAndAirtime) {
+    ConnectHt();
+
+    constexpr size_t kMsduCount = 64;
+    constexpr size_t kPayloadLen = 200;
+    std::vector<uint8_t> payload(kPayloadLen, 0x42);
+    for (size_t i = 0; i < kMsduCount; i++) {
+        SendEthFrame(payload.data(), payload.size());
+    }
+    TriggerAmsduFlushTimeout();
+
+    size_t msdu_count = 0;
+    size_t mpdu_count = 0;
+    zx::duration airtime;
+    for (auto& pkt : device.GetWlanPackets()) {
+        mpdu_count++;
+        airtime += EstimateAirtime(pkt->len());
+        if (DataFrameView<AmsduSubframeHeader>::CheckType(pkt.get())) {
+            msdu_count += DeaggregateOutboundAmsdu(pkt.get()).size();
+        } else {
+            ASSERT_TRUE(DataFrameView<LlcHeader>::CheckType(pkt.get()).CheckLength());
+            msdu_count++;
+        }
+    }
+
+    // Every MSDU was delivered, 17 of them sharing each MPDU.
+    EXPECT_EQ(msdu_count, kMsduCount);
+    EXPECT_EQ(mpdu_count, static_cast<size_t>(4));
+
+    // Sending each MSDU in its own QoS data frame costs a full frame exchange every time.
+    size_t qos_data_len = sizeof(DataFrameHeader) + kQosCtrlLen;
+    zx::duration unaggregated_airtime =
+        EstimateAirtime(qos_data_len + LlcHeader::max_len() + kPayloadLen) * kMsduCount;
+    EXPECT_LT(airtime * 3, unaggregated_airtime);
+}
+
+TEST_F(ClientTest, ReorderMpdusOfBlockAckSession) {
+    Connect();
+    EstablishBlockAckSession(5, 100, 64);
+
+    ASSERT_EQ(SendQosDataFrame(5, 102), ZX_OK);
+    ASSERT_EQ(SendQosDataFrame(5, 101), ZX_OK);
+    ASSERT_TRUE(device.eth_queue.empty());
+
+    ASSERT_EQ(SendQosDataFrame(5, 100), ZX_OK);
+    EXPECT_EQ(GetReceivedPayloads(), std::vector<uint8_t>({100, 101, 102}));
+
+    // A duplicate of an MPDU which was passed up already is dropped.
+    ASSERT_EQ(SendQosDataFrame(5, 101), ZX_OK);
+    ASSERT_TRUE(device.eth_queue.empty());
+
+    auto stats = station.stats();
+    EXPECT_EQ(stats.reorder.in_order.count, 1u);
+    EXPECT_EQ(stats.reorder.buffered.count, 2u);
+    EXPECT_EQ(stats.reorder.duplicate.count, 1u);
+}
+
+TEST_F(ClientTest, BlockAckReqReleasesBufferedMpdus) {
+    Connect();
+    EstablishBlockAckSession(0, 0, 64);
+
+    ASSERT_EQ(SendQosDataFrame(0, 1), ZX_OK);
+    ASSERT_EQ(SendQosDataFrame(0, 2), ZX_OK);
+    ASSERT_EQ(SendQosDataFrame(0, 4), ZX_OK);
+    ASSERT_TRUE(device.eth_queue.empty());
+
+    // A BlockAckReq for a different TID has no effect.
+    ASSERT_EQ(SendBlockAckReq(1, 3), ZX_OK);
+    ASSERT_TRUE(device.eth_queue.empty());
+
+    ASSERT_EQ(SendBlockAckReq(0, 3), ZX_OK);
+    EXPECT_EQ(GetReceivedPayloads(), std::vector<uint8_t>({1, 2}));
+
+    ASSERT_EQ(SendQosDataFrame(0, 3), ZX_OK);
+    EXPECT_EQ(GetReceivedPayloads(), std::vector<uint8_t>({3, 4}));
+
+    auto stats = station.stats();
+    EXPECT_EQ(stats.reorder.lost.count, 1u);
+    EXPECT_EQ(stats.reorder.bar_flush.count, 1u);
+}
+
+TEST_F(ClientTest, ReorderTimeoutReleasesBufferedMpdus) {
+    Connect();
+    EstablishBlockAckSession(0, 0, 64);
+
+    ASSERT_EQ(SendQosDataFrame(0, 1), ZX_OK);
+    ASSERT_EQ(SendQosDataFrame(0, 3), ZX_OK);
+
+    device.SetTime(device.GetTime() + zx::msec(99));
+    station.HandleTimeout();
+    ASSERT_TRUE(device.eth_queue.empty());
+
+    // Each gap is given up on after its own timeout.
+    device.SetTime(device.GetTime() + zx::msec(1));
+    station.HandleTimeout();
+    EXPECT_EQ(GetReceivedPayloads(), std::vector<uint8_t>({1}));
+
+    device.SetTime(device.GetTime() + zx::msec(100));
+    station.HandleTimeout();
+    EXPECT_EQ(GetReceivedPayloads(), std::vector<uint8_t>({3}));
+
+    auto stats = station.stats();
+    EXPECT_EQ(stats.reorder.lost.count, 2u);
+    EXPECT_EQ(stats.reorder.timeout_flush.count, 2u);
+}
+
+TEST_F(ClientTest, ReorderTimeoutIsPerGap) {
+    Connect();
+    EstablishBlockAckSession(0, 0, 64);
+    EstablishBlockAckSession(1, 0, 64);
+
+    // A gap opens on TID 0, and another one on TID 1 95 ms later.
+    ASSERT_EQ(SendQosDataFrame(0, 1), ZX_OK);
+    device.SetTime(device.GetTime() + zx::msec(95));
+    station.HandleTimeout();
+    ASSERT_EQ(SendQosDataFrame(1, 2), ZX_OK);
+
+    // Only TID 0's gap expired.
+    device.SetTime(device.GetTime() + zx::msec(5));
+    station.HandleTimeout();
+    EXPECT_EQ(GetReceivedPayloads(), std::vector<uint8_t>({1}));
+    EXPECT_EQ(station.stats().reorder.lost.count, 1u);
+
+    // The retransmissions closing TID 1's gap are still passed up.
+    ASSERT_EQ(SendQosDataFrame(1, 0), ZX_OK);
+    ASSERT_EQ(SendQosDataFrame(1, 1), ZX_OK);
+    EXPECT_EQ(GetReceivedPayloads(), std::vector<uint8_t>({0, 1, 2}));
+    EXPECT_EQ(station.stats().reorder.lost.count, 1u);
+}
+
+TEST_F(ClientTest, ReorderTimeoutRestartsWhenGapCloses) {
+    Connect();
+    EstablishBlockAckSession(0, 0, 64);
+
+    ASSERT_EQ(SendQosDataFrame(0, 1), ZX_OK);
+    ASSERT_EQ(SendQosDataFrame(0, 3), ZX_OK);
+
+    // Closing the first gap leaves the one at 2, which gets a full timeout of its own.
+    device.SetTime(device.GetTime() + zx::msec(90));
+    station.HandleTimeout();
+    ASSERT_EQ(SendQosDataFrame(0, 0), ZX_OK);
+    EXPECT_EQ(GetReceivedPayloads(), std::vector<uint8_t>({0, 1}));
+
+    device.SetTime(device.GetTime() + zx::msec(99));
+    station.HandleTimeout();
+    ASSERT_TRUE(device.eth_queue.empty());
+
+    device.SetTime(device.GetTime() + zx::msec(1));
+    station.HandleTimeout();
+    EXPECT_EQ(GetReceivedPayloads(), std::vector<uint8_t>({3}));
+}
+
+TEST_F(ClientTest, DelBaEndsBlockAckSession) {
+    Connect();
+    EstablishBlockAckSession(0, 0, 64);
+    ASSERT_EQ(SendQosDataFrame(0, 2), ZX_OK);
+    ASSERT_TRUE(device.eth_queue.empty());
+
+    // A DELBA for the session this STA originated leaves the AP's session alone.
+    fbl::unique_ptr<Packet> pkt;
+    ASSERT_EQ(CreateDelBaFrame(&pkt, 0, false), ZX_OK);
+    station.HandleAnyWlanFrame(fbl::move(pkt));
+    ASSERT_TRUE(device.eth_queue.empty());
+
+    // Buffered MPDUs are passed up once the AP ends the session.
+    ASSERT_EQ(CreateDelBaFrame(&pkt, 0, true), ZX_OK);
+    station.HandleAnyWlanFrame(fbl::move(pkt));
+    EXPECT_EQ(GetReceivedPayloads(), std::vector<uint8_t>({2}));
+
+    // MPDUs are no longer reordered.
+    ASSERT_EQ(SendQosDataFrame(0, 5), ZX_OK);
+    ASSERT_EQ(SendQosDataFrame(0, 4), ZX_OK);
+    EXPECT_EQ(GetReceivedPayloads(), std::vector<uint8_t>({5, 4}));
+}
+
+TEST_F(ClientTest, PassUpMpdusWithoutBlockAckSession) {
+    Connect();
+    EstablishBlockAckSession(0, 0, 64);
+
+    // Only TID 0 reorders.
+    ASSERT_EQ(SendQosDataFrame(6, 2), ZX_OK);
+    ASSERT_EQ(SendQosDataFrame(6, 1), ZX_OK);
+    EXPECT_EQ(GetReceivedPayloads(), std::vector<uint8_t>({2, 1}));
+}
+
+TEST_F(ClientTest, DropBufferedMpdusWhenDeauthenticated) {
+    Connect();
+    EstablishBlockAckSession(0, 0, 64);
+    ASSERT_EQ(SendQosDataFrame(0, 1), ZX_OK);
+
+    fbl::unique_ptr<Packet> pkt;
+    ASSERT_EQ(CreateDeauthFrame(&pkt), ZX_OK);
+    station.HandleAnyWlanFrame(fbl::move(pkt));
+    device.svc_queue.clear();
+
+    Connect();
+    ASSERT_EQ(SendQosDataFrame(0, 0), ZX_OK);
+    EXPECT_EQ(GetReceivedPayloads(), std::vector<uint8_t>({0}));
+}
+
 TEST_F(ClientTest, InvalidAuthenticationResponse) {
     // Send AUTHENTICATION.request. Verify that no confirmation was sent yet.
     ASSERT_EQ(SendMlmeMsg<wlan_mlme::AuthenticateRequest>(), ZX_OK);
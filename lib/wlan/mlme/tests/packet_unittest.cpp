@@ -6,8 +6,12 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <memory>
+#include <random>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace wlan {
 namespace {
@@ -79,5 +83,215 @@ TEST_F(PacketTest, BufferFallback) {
     EXPECT_EQ(buffers[buffer_cnt_max]->capacity(), kLargeBufferSize);
 }
 
+TEST_F(PacketTest, ReuseBufferFromThreadCache) {
+    // A new thread starts with an empty cache.
+    std::thread([] {
+        auto& stats = LargeBufferPool::stats();
+        uint64_t cached = stats.cached.load();
+
+        auto buffer = GetBuffer(kLargeBufferSize);
+        ASSERT_NE(buffer, nullptr);
+        Buffer* released = buffer.get();
+        buffer.reset();
+        EXPECT_EQ(stats.cached.load(), cached + 1);
+
+        buffer = GetBuffer(kLargeBufferSize);
+        EXPECT_EQ(buffer.get(), released);
+        EXPECT_EQ(stats.cached.load(), cached);
+
+        // Buffers released beyond the cache's size go back to their slab.
+        std::vector<fbl::unique_ptr<Buffer>> buffers;
+        for (size_t i = 0; i < LargeBufferPool::kCacheSize + 2; i++) {
+            buffers.push_back(GetBuffer(kLargeBufferSize));
+            ASSERT_NE(buffers.back(), nullptr);
+        }
+        buffers.clear();
+        EXPECT_EQ(stats.cached.load(), cached + LargeBufferPool::kCacheSize);
+    }).join();
+}
+
+TEST_F(PacketTest, TrackBufferOccupancy) {
+    auto& stats = SmallBufferPool::stats();
+    ResetBufferPoolStats();
+    uint64_t in_use = stats.in_use.load();
+
+    std::vector<fbl::unique_ptr<Buffer>> buffers;
+    for (size_t i = 0; i < 10; i++) {
+        buffers.push_back(GetBuffer(kSmallBufferSize));
+    }
+    EXPECT_EQ(stats.in_use.load(), in_use + 10);
+    EXPECT_EQ(stats.max_in_use.load(), in_use + 10);
+
+    buffers.resize(4);
+    EXPECT_EQ(stats.in_use.load(), in_use + 4);
+    EXPECT_EQ(stats.max_in_use.load(), in_use + 10);
+
+    auto fidl_stats = GetBufferPoolStats();
+    EXPECT_EQ(fidl_stats.small_buffers.in_use, in_use + 4);
+    EXPECT_EQ(fidl_stats.small_buffers.max_in_use, in_use + 10);
+    EXPECT_EQ(fidl_stats.small_buffers.capacity, kSmallSlabs * kSmallBuffers);
+
+    // The high watermark restarts from the current occupancy.
+    ResetBufferPoolStats();
+    EXPECT_EQ(stats.max_in_use.load(), in_use + 4);
+}
+
+TEST_F(PacketTest, LimitSlabsAtRuntime) {
+    auto& stats = HugeBufferPool::stats();
+    uint64_t exhausted = stats.exhausted.count.load();
+
+    BufferPoolConfig config;
+    config.huge_slabs = 1;
+    SetBufferPoolConfig(config);
+    EXPECT_EQ(GetBufferPoolStats().huge_buffers.capacity, kHugeBuffers);
+
+    std::vector<fbl::unique_ptr<Buffer>> buffers;
+    for (size_t i = 0; i < kHugeBuffers; i++) {
+        buffers.push_back(GetBuffer(kHugeBufferSize));
+        ASSERT_NE(buffers.back(), nullptr);
+    }
+    EXPECT_EQ(GetBuffer(kHugeBufferSize), nullptr);
+    EXPECT_EQ(stats.exhausted.count.load(), exhausted + 1);
+
+    // Caps beyond the compile-time maximum are clamped.
+    config.huge_slabs = kMaxHugeSlabs + 1;
+    SetBufferPoolConfig(config);
+    EXPECT_EQ(GetBufferPoolStats().huge_buffers.capacity, kMaxHugeSlabs * kHugeBuffers);
+    EXPECT_NE(GetBuffer(kHugeBufferSize), nullptr);
+
+    SetBufferPoolConfig(BufferPoolConfig{});
+}
+
+TEST_F(PacketTest, RaiseLimitsOnly) {
+    BufferPoolConfig config;
+    config.huge_slabs = 1;
+    RaiseBufferPoolConfig(config);
+    EXPECT_EQ(GetBufferPoolStats().huge_buffers.capacity, kHugeSlabs * kHugeBuffers);
+
+    config.huge_slabs = kHugeSlabs + 1;
+    RaiseBufferPoolConfig(config);
+    EXPECT_EQ(GetBufferPoolStats().huge_buffers.capacity, (kHugeSlabs + 1) * kHugeBuffers);
+
+    SetBufferPoolConfig(BufferPoolConfig{});
+}
+
+TEST_F(PacketTest, CachesFlushUnderPressure) {
+    auto& stats = HugeBufferPool::stats();
+    BufferPoolConfig config;
+    config.huge_slabs = 1;
+    SetBufferPoolConfig(config);
+
+    // This thread holds one buffer and caches two more, which count towards the limit.
+    auto held = GetBuffer(kHugeBufferSize);
+    ASSERT_NE(held, nullptr);
+    {
+        auto first = GetBuffer(kHugeBufferSize);
+        auto second = GetBuffer(kHugeBufferSize);
+        ASSERT_NE(first, nullptr);
+        ASSERT_NE(second, nullptr);
+    }
+    ASSERT_EQ(HugeBufferPool::kCacheSize, 2u);
+    EXPECT_EQ(stats.cached.load(), 2u);
+
+    // Another thread runs out of buffers while they are cached here.
+    std::vector<fbl::unique_ptr<Buffer>> others;
+    std::thread([&others] {
+        for (auto buffer = GetBuffer(kHugeBufferSize); buffer != nullptr;
+             buffer = GetBuffer(kHugeBufferSize)) {
+            others.push_back(std::move(buffer));
+        }
+    }).join();
+    EXPECT_EQ(others.size(), kHugeBuffers - 3);
+
+    // The next release here hands the cached buffers back, so other threads can use them.
+    held.reset();
+    EXPECT_EQ(stats.cached.load(), 0u);
+    others.push_back(GetBuffer(kHugeBufferSize));
+    EXPECT_NE(others.back(), nullptr);
+
+    // Once no buffers are cached anymore, released buffers are cached again.
+    others.pop_back();
+    EXPECT_EQ(stats.cached.load(), 1u);
+
+    others.clear();
+    SetBufferPoolConfig(BufferPoolConfig{});
+}
+
+TEST_F(PacketTest, ReleaseAfterThreadCacheFlushed) {
+    struct BufferHolder {
+        fbl::unique_ptr<Buffer> buffer;
+    };
+
+    auto& stats = LargeBufferPool::stats();
+    uint64_t in_use = stats.in_use.load();
+    uint64_t cached = stats.cached.load();
+
+    std::thread([] {
+        // |holder| is constructed before the thread's buffer cache is first used, so it is
+        // destroyed after the cache was flushed.
+        thread_local BufferHolder holder;
+        holder.buffer = GetBuffer(kLargeBufferSize);
+        ASSERT_NE(holder.buffer, nullptr);
+    }).join();
+
+    // The buffer went straight back to its slab.
+    EXPECT_EQ(stats.in_use.load(), in_use);
+    EXPECT_EQ(stats.cached.load(), cached);
+}
+
+// Allocates and releases buffers from several threads at once. Buffers are filled with a tag of
+// their owner which must be intact when they are released.
+TEST_F(PacketTest, AllocateFromManyThreads) {
+    constexpr size_t kThreads = 8;
+    constexpr size_t kIterations = 5000;
+    constexpr size_t kMaxHeld = 24;
+
+    auto& small_stats = SmallBufferPool::stats();
+    auto& large_stats = LargeBufferPool::stats();
+    uint64_t small_in_use = small_stats.in_use.load();
+    uint64_t large_in_use = large_stats.in_use.load();
+    uint64_t cached = small_stats.cached.load() + large_stats.cached.load();
+    uint64_t exhausted = small_stats.exhausted.count.load() + large_stats.exhausted.count.load();
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; t++) {
+        threads.emplace_back([t] {
+            std::mt19937 rng(t);
+            std::uniform_int_distribution<size_t> len_dist(1, kLargeBufferSize);
+            const uint8_t tag = static_cast<uint8_t>(t + 1);
+
+            std::vector<std::pair<fbl::unique_ptr<Buffer>, size_t>> held;
+            for (size_t i = 0; i < kIterations; i++) {
+                if (held.size() == kMaxHeld || (!held.empty() && rng() % 2 == 0)) {
+                    auto& victim = held[rng() % held.size()];
+                    for (size_t idx = 0; idx < victim.second; idx++) {
+                        ASSERT_EQ(victim.first->data()[idx], tag);
+                    }
+                    std::swap(victim, held.back());
+                    held.pop_back();
+                    continue;
+                }
+
+                size_t len = len_dist(rng);
+                auto buffer = GetBuffer(len);
+                ASSERT_NE(buffer, nullptr);
+                std::memset(buffer->data(), tag, len);
+                held.emplace_back(std::move(buffer), len);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(small_stats.in_use.load(), small_in_use);
+    EXPECT_EQ(large_stats.in_use.load(), large_in_use);
+    EXPECT_LE(small_stats.max_in_use.load(), kSmallSlabs * kSmallBuffers);
+    EXPECT_LE(large_stats.max_in_use.load(), kLargeSlabs * kLargeBuffers);
+    // Caches of exited threads were returned to the slabs.
+    EXPECT_EQ(small_stats.cached.load() + large_stats.cached.load(), cached);
+    EXPECT_EQ(small_stats.exhausted.count.load() + large_stats.exhausted.count.load(), exhausted);
+}
+
 }  // namespace
 }  // namespace wlan
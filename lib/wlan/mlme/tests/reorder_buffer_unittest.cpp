@@ -0,0 +1,281 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <wlan/common/mac_frame.h>
+#include <wlan/common/stats.h>
+#include <wlan/mlme/packet.h>
+#include <wlan/mlme/reorder_buffer.h>
+
+#include <fbl/unique_ptr.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace wlan {
+namespace {
+
+struct ReorderBufferTest : public ::testing::Test {
+    ReorderBufferTest() : buf(0, 8, &stats, MakeReleaseCallback()) {}
+
+    ReorderBuffer::ReleaseCallback MakeReleaseCallback() {
+        return [this](fbl::unique_ptr<Packet> pkt) {
+            uint16_t seq;
+            std::memcpy(&seq, pkt->data(), sizeof(seq));
+            released.push_back(seq);
+        };
+    }
+
+    // Returns a packet which carries its own sequence number as payload.
+    fbl::unique_ptr<Packet> CreateMpdu(uint16_t seq) {
+        auto pkt = GetWlanPacket(sizeof(seq));
+        EXPECT_NE(pkt, nullptr);
+        pkt->set_len(sizeof(seq));
+        std::memcpy(pkt->data(), &seq, sizeof(seq));
+        return pkt;
+    }
+
+    void Insert(uint16_t seq) { buf.Insert(seq, CreateMpdu(seq)); }
+
+    void Insert(std::initializer_list<uint16_t> seqs) {
+        for (auto seq : seqs) {
+            Insert(seq);
+        }
+    }
+
+    common::ReorderStats stats;
+    std::vector<uint16_t> released;
+    ReorderBuffer buf;
+};
+
+TEST_F(ReorderBufferTest, InOrderMpdusPassThrough) {
+    Insert({0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+    EXPECT_EQ(released, std::vector<uint16_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    EXPECT_TRUE(buf.IsEmpty());
+    EXPECT_EQ(buf.win_start(), 10);
+    EXPECT_EQ(stats.in_order.count, 10u);
+    EXPECT_EQ(stats.buffered.count, 0u);
+}
+
+TEST_F(ReorderBufferTest, ReleaseReorderedMpdusInOrder) {
+    Insert({1, 3});
+    EXPECT_TRUE(released.empty());
+    EXPECT_EQ(buf.buffered(), 2u);
+
+    Insert(0);
+    EXPECT_EQ(released, std::vector<uint16_t>({0, 1}));
+
+    Insert(2);
+    EXPECT_EQ(released, std::vector<uint16_t>({0, 1, 2, 3}));
+    EXPECT_TRUE(buf.IsEmpty());
+    EXPECT_EQ(stats.in_order.count, 2u);
+    EXPECT_EQ(stats.buffered.count, 2u);
+    EXPECT_EQ(stats.lost.count, 0u);
+}
+
+TEST_F(ReorderBufferTest, DropDuplicates) {
+    Insert({0, 0, 2, 2});
+
+    EXPECT_EQ(released, std::vector<uint16_t>({0}));
+    EXPECT_EQ(buf.buffered(), 1u);
+    EXPECT_EQ(stats.duplicate.count, 2u);
+}
+
+TEST_F(ReorderBufferTest, BlockAckReqGivesUpOnGap) {
+    Insert({1, 2, 4});
+    EXPECT_TRUE(released.empty());
+
+    // The originator stopped retransmitting sequence number 0.
+    buf.HandleBlockAckReq(1);
+    EXPECT_EQ(released, std::vector<uint16_t>({1, 2}));
+    EXPECT_EQ(buf.win_start(), 3);
+    EXPECT_EQ(stats.lost.count, 1u);
+
+    buf.HandleBlockAckReq(5);
+    EXPECT_EQ(released, std::vector<uint16_t>({1, 2, 4}));
+    EXPECT_EQ(buf.win_start(), 5);
+    EXPECT_EQ(stats.lost.count, 2u);
+    EXPECT_EQ(stats.bar_flush.count, 2u);
+    EXPECT_TRUE(buf.IsEmpty());
+}
+
+TEST_F(ReorderBufferTest, IgnoreOutdatedBlockAckReq) {
+    Insert({0, 1, 2, 4});
+
+    buf.HandleBlockAckReq(1);
+    EXPECT_EQ(released, std::vector<uint16_t>({0, 1, 2}));
+    EXPECT_EQ(buf.win_start(), 3);
+    EXPECT_EQ(buf.buffered(), 1u);
+    EXPECT_EQ(stats.lost.count, 0u);
+}
+
+TEST_F(ReorderBufferTest, TimeoutGivesUpOnOldestGapOnly) {
+    Insert({2, 3, 5});
+
+    buf.FlushOnTimeout();
+    EXPECT_EQ(released, std::vector<uint16_t>({2, 3}));
+    EXPECT_EQ(stats.lost.count, 2u);
+    EXPECT_FALSE(buf.IsEmpty());
+
+    buf.FlushOnTimeout();
+    EXPECT_EQ(released, std::vector<uint16_t>({2, 3, 5}));
+    EXPECT_EQ(stats.lost.count, 3u);
+    EXPECT_EQ(stats.timeout_flush.count, 2u);
+    EXPECT_TRUE(buf.IsEmpty());
+
+    // Nothing is buffered and thus nothing to flush.
+    buf.FlushOnTimeout();
+    EXPECT_EQ(stats.timeout_flush.count, 2u);
+}
+
+TEST_F(ReorderBufferTest, ReleaseAllGivesUpOnEveryGap) {
+    Insert({2, 3, 5});
+
+    buf.ReleaseAll();
+    EXPECT_EQ(released, std::vector<uint16_t>({2, 3, 5}));
+    EXPECT_EQ(stats.lost.count, 3u);
+    EXPECT_EQ(buf.win_start(), 6u);
+    EXPECT_TRUE(buf.IsEmpty());
+}
+
+TEST_F(ReorderBufferTest, MpduBeyondWindowMovesWindow) {
+    ReorderBuffer small_buf(0, 4, &stats, MakeReleaseCallback());
+
+    small_buf.Insert(1, CreateMpdu(1));
+    small_buf.Insert(6, CreateMpdu(6));
+    // The window now spans [3, 6]. Sequence numbers 0 and 2 were given up on.
+    EXPECT_EQ(released, std::vector<uint16_t>({1}));
+    EXPECT_EQ(small_buf.win_start(), 3);
+    EXPECT_EQ(stats.lost.count, 2u);
+
+    for (uint16_t seq : {3, 4, 5}) {
+        small_buf.Insert(seq, CreateMpdu(seq));
+    }
+    EXPECT_EQ(released, std::vector<uint16_t>({1, 3, 4, 5, 6}));
+    EXPECT_TRUE(small_buf.IsEmpty());
+}
+
+TEST_F(ReorderBufferTest, SequenceNumberWrapAround) {
+    ReorderBuffer wrap_buf(kMaxSequenceNumber - 1, 8, &stats, MakeReleaseCallback());
+
+    std::vector<uint16_t> seqs = {kMaxSequenceNumber, 0, kMaxSequenceNumber - 1, 1};
+    for (auto seq : seqs) {
+        wrap_buf.Insert(seq, CreateMpdu(seq));
+    }
+    EXPECT_EQ(released, std::vector<uint16_t>({kMaxSequenceNumber - 1, kMaxSequenceNumber, 0, 1}));
+    EXPECT_EQ(wrap_buf.win_start(), 2);
+
+    // Sequence numbers just before the wrap are now outdated.
+    wrap_buf.Insert(kMaxSequenceNumber, CreateMpdu(kMaxSequenceNumber));
+    EXPECT_EQ(released.size(), 4u);
+    EXPECT_EQ(stats.duplicate.count, 1u);
+}
+
+TEST_F(ReorderBufferTest, ClampWindowSize) {
+    EXPECT_EQ(ReorderBuffer(0, 0, &stats, MakeReleaseCallback()).win_size(), 1u);
+    EXPECT_EQ(ReorderBuffer(0, 1024, &stats, MakeReleaseCallback()).win_size(),
+              ReorderBuffer::kMaxWindowSize);
+}
+
+TEST_F(ReorderBufferTest, ClearDropsBufferedMpdus) {
+    Insert({1, 2});
+    buf.Clear();
+    EXPECT_TRUE(buf.IsEmpty());
+
+    Insert(0);
+    EXPECT_EQ(released, std::vector<uint16_t>({0}));
+}
+
+// Simulates A-MPDUs which arrive shuffled and lose some of their MPDUs. Every A-MPDU is followed
+// by a BlockAckReq from the originator which gave up on the lost MPDUs.
+TEST_F(ReorderBufferTest, SimulateLossAndReordering) {
+    constexpr size_t kAmpduLen = 32;
+    constexpr size_t kNumAmpdus = 300;
+    constexpr double kLossRate = 0.1;
+
+    std::mt19937 rng(42);
+    std::bernoulli_distribution lose(kLossRate);
+    ReorderBuffer sim_buf(0, ReorderBuffer::kMaxWindowSize, &stats, MakeReleaseCallback());
+
+    size_t delivered = 0;
+    size_t lost = 0;
+    uint16_t next_seq = 0;
+    for (size_t i = 0; i < kNumAmpdus; i++) {
+        std::vector<uint16_t> ampdu;
+        for (size_t j = 0; j < kAmpduLen; j++) {
+            ampdu.push_back(next_seq);
+            next_seq = (next_seq + 1) & kMaxSequenceNumber;
+        }
+        std::shuffle(ampdu.begin(), ampdu.end(), rng);
+
+        for (auto seq : ampdu) {
+            if (lose(rng)) {
+                lost++;
+                continue;
+            }
+            sim_buf.Insert(seq, CreateMpdu(seq));
+            delivered++;
+            EXPECT_LE(sim_buf.buffered(), sim_buf.win_size());
+        }
+        sim_buf.HandleBlockAckReq(next_seq);
+        EXPECT_TRUE(sim_buf.IsEmpty());
+    }
+
+    // Everything received was passed up exactly once and in order, even across the wrap of the
+    // sequence number space.
+    ASSERT_EQ(released.size(), delivered);
+    size_t advanced = released.front();
+    for (size_t i = 1; i < released.size(); i++) {
+        uint16_t delta = (released[i] - released[i - 1]) & kMaxSequenceNumber;
+        EXPECT_GT(delta, 0);
+        EXPECT_LT(delta, (kMaxSequenceNumber + 1) / 2);
+        advanced += delta;
+    }
+    EXPECT_LT(advanced, kAmpduLen * kNumAmpdus);
+    EXPECT_EQ(stats.lost.count, lost);
+    EXPECT_EQ(stats.duplicate.count, 0u);
+    EXPECT_EQ(stats.in_order.count + stats.buffered.count, delivered);
+}
+
+// Simulates retransmissions: every lost MPDU is resent after the remainder of its A-MPDU and
+// must not be given up on.
+TEST_F(ReorderBufferTest, SimulateRetransmissions) {
+    constexpr size_t kAmpduLen = 16;
+    constexpr size_t kNumAmpdus = 100;
+
+    std::mt19937 rng(7);
+    std::bernoulli_distribution lose(0.2);
+    ReorderBuffer retx_buf(0, ReorderBuffer::kMaxWindowSize, &stats, MakeReleaseCallback());
+    auto insert = [&](uint16_t seq) { retx_buf.Insert(seq, CreateMpdu(seq)); };
+
+    uint16_t next_seq = 0;
+    for (size_t i = 0; i < kNumAmpdus; i++) {
+        std::vector<uint16_t> retransmissions;
+        for (size_t j = 0; j < kAmpduLen; j++, next_seq++) {
+            if (lose(rng)) {
+                retransmissions.push_back(next_seq);
+            } else {
+                insert(next_seq);
+            }
+        }
+        // Some retransmitted MPDUs arrive twice.
+        for (auto seq : retransmissions) {
+            insert(seq);
+            if (lose(rng)) { insert(seq); }
+        }
+        EXPECT_TRUE(retx_buf.IsEmpty());
+    }
+
+    ASSERT_EQ(released.size(), kAmpduLen * kNumAmpdus);
+    for (size_t i = 0; i < released.size(); i++) {
+        EXPECT_EQ(released[i], i);
+    }
+    EXPECT_EQ(stats.lost.count, 0u);
+}
+
+}  // namespace
+}  // namespace wlan
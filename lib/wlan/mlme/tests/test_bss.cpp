@@ -320,6 +320,16 @@ zx_status_t CreateDeauthFrame(fbl::unique_ptr<Packet>* out_packet) {
 }
 
 zx_status_t CreateAssocReqFrame(fbl::unique_ptr<Packet>* out_packet) {
+    return CreateAssocReqFrame(out_packet, nullptr);
+}
+
+zx_status_t CreateHtAssocReqFrame(fbl::unique_ptr<Packet>* out_packet,
+                                  const HtCapabilities& ht_cap) {
+    return CreateAssocReqFrame(out_packet, &ht_cap);
+}
+
+zx_status_t CreateAssocReqFrame(fbl::unique_ptr<Packet>* out_packet,
+                                const HtCapabilities* ht_cap) {
     common::MacAddr bssid(kBssid1);
     common::MacAddr client(kClientAddress);
 
@@ -342,9 +352,11 @@ zx_status_t CreateAssocReqFrame(fbl::unique_ptr<Packet>* out_packet) {
     assoc->listen_interval = kListenInterval;
 
     size_t elems_len = sizeof(SsidElement) + sizeof(kSsid) + sizeof(kRsne);
+    if (ht_cap != nullptr) { elems_len += sizeof(HtCapabilitiesElement); }
     BufferWriter w({assoc->elements, elems_len});
     common::WriteSsid(&w, kSsid);
     w.Write(kRsne);
+    if (ht_cap != nullptr) { common::WriteHtCapabilities(&w, *ht_cap); }
 
     frame.set_body_len(sizeof(AssociationRequest) + elems_len);
     auto pkt = frame.Take();
@@ -357,11 +369,22 @@ zx_status_t CreateAssocReqFrame(fbl::unique_ptr<Packet>* out_packet) {
 }
 
 zx_status_t CreateAssocRespFrame(fbl::unique_ptr<Packet>* out_packet) {
+    return CreateAssocRespFrame(out_packet, nullptr);
+}
+
+zx_status_t CreateHtAssocRespFrame(fbl::unique_ptr<Packet>* out_packet,
+                                   const HtCapabilities& ht_cap) {
+    return CreateAssocRespFrame(out_packet, &ht_cap);
+}
+
+zx_status_t CreateAssocRespFrame(fbl::unique_ptr<Packet>* out_packet,
+                                 const HtCapabilities* ht_cap) {
     common::MacAddr bssid(kBssid1);
     common::MacAddr client(kClientAddress);
 
+    size_t elems_len = ht_cap != nullptr ? sizeof(HtCapabilitiesElement) : 0;
     MgmtFrame<AssociationResponse> frame;
-    auto status = CreateMgmtFrame(&frame);
+    auto status = CreateMgmtFrame(&frame, elems_len);
     if (status != ZX_OK) { return status; }
 
     auto hdr = frame.hdr();
@@ -376,6 +399,11 @@ zx_status_t CreateAssocRespFrame(fbl::unique_ptr<Packet>* out_packet) {
     cap.set_ess(1);
     assoc->cap = cap;
     assoc->status_code = status_code::kSuccess;
+    if (ht_cap != nullptr) {
+        BufferWriter w({assoc->elements, elems_len});
+        common::WriteHtCapabilities(&w, *ht_cap);
+        frame.set_body_len(sizeof(AssociationResponse) + elems_len);
+    }
 
     auto pkt = frame.Take();
     wlan_rx_info_t rx_info{.rx_flags = 0};
@@ -411,6 +439,104 @@ zx_status_t CreateDisassocFrame(fbl::unique_ptr<Packet>* out_packet) {
     return ZX_OK;
 }
 
+zx_status_t CreateAddBaReqFrame(fbl::unique_ptr<Packet>* out_packet, uint8_t tid, uint16_t ssn,
+                                size_t buffer_size) {
+    common::MacAddr bssid(kBssid1);
+    common::MacAddr client(kClientAddress);
+
+    constexpr size_t max_frame_len = MgmtFrameHeader::max_len() + ActionFrame::max_len() +
+                                     ActionFrameBlockAck::max_len() + AddBaRequestFrame::max_len();
+    auto packet = GetWlanPacket(max_frame_len);
+    if (packet == nullptr) { return ZX_ERR_NO_RESOURCES; }
+
+    BufferWriter w(*packet);
+    auto mgmt_hdr = w.Write<MgmtFrameHeader>();
+    mgmt_hdr->fc.set_type(FrameType::kManagement);
+    mgmt_hdr->fc.set_subtype(ManagementSubtype::kAction);
+    mgmt_hdr->addr1 = client;
+    mgmt_hdr->addr2 = bssid;
+    mgmt_hdr->addr3 = bssid;
+
+    w.Write<ActionFrame>()->category = ActionFrameBlockAck::ActionCategory();
+    w.Write<ActionFrameBlockAck>()->action = AddBaRequestFrame::BlockAckAction();
+
+    auto addbareq = w.Write<AddBaRequestFrame>();
+    addbareq->dialog_token = 1;
+    addbareq->params.set_policy(BlockAckParameters::kImmediate);
+    addbareq->params.set_tid(tid);
+    addbareq->params.set_buffer_size(buffer_size);
+    addbareq->timeout = 0;
+    addbareq->seq_ctrl.set_starting_seq(ssn);
+
+    packet->set_len(w.WrittenBytes());
+    wlan_rx_info_t rx_info{.rx_flags = 0};
+    packet->CopyCtrlFrom(rx_info);
+
+    *out_packet = fbl::move(packet);
+    return ZX_OK;
+}
+
+zx_status_t CreateDelBaFrame(fbl::unique_ptr<Packet>* out_packet, uint8_t tid, bool initiator) {
+    common::MacAddr bssid(kBssid1);
+    common::MacAddr client(kClientAddress);
+
+    constexpr size_t max_frame_len = MgmtFrameHeader::max_len() + ActionFrame::max_len() +
+                                     ActionFrameBlockAck::max_len() + DelBaFrame::max_len();
+    auto packet = GetWlanPacket(max_frame_len);
+    if (packet == nullptr) { return ZX_ERR_NO_RESOURCES; }
+
+    BufferWriter w(*packet);
+    auto mgmt_hdr = w.Write<MgmtFrameHeader>();
+    mgmt_hdr->fc.set_type(FrameType::kManagement);
+    mgmt_hdr->fc.set_subtype(ManagementSubtype::kAction);
+    mgmt_hdr->addr1 = client;
+    mgmt_hdr->addr2 = bssid;
+    mgmt_hdr->addr3 = bssid;
+
+    w.Write<ActionFrame>()->category = ActionFrameBlockAck::ActionCategory();
+    w.Write<ActionFrameBlockAck>()->action = DelBaFrame::BlockAckAction();
+
+    auto delba = w.Write<DelBaFrame>();
+    delba->params.set_initiator(initiator ? 1 : 0);
+    delba->params.set_tid(tid);
+    delba->reason_code = 0;
+
+    packet->set_len(w.WrittenBytes());
+    wlan_rx_info_t rx_info{.rx_flags = 0};
+    packet->CopyCtrlFrom(rx_info);
+
+    *out_packet = fbl::move(packet);
+    return ZX_OK;
+}
+
+zx_status_t CreateBlockAckReqFrame(fbl::unique_ptr<Packet>* out_packet, uint8_t tid,
+                                   uint16_t ssn) {
+    common::MacAddr bssid(kBssid1);
+    common::MacAddr client(kClientAddress);
+
+    auto packet = GetWlanPacket(CtrlFrameHdr::max_len() + BlockAckReqFrame::max_len());
+    if (packet == nullptr) { return ZX_ERR_NO_RESOURCES; }
+
+    BufferWriter w(*packet);
+    auto ctrl_hdr = w.Write<CtrlFrameHdr>();
+    ctrl_hdr->fc.set_type(FrameType::kControl);
+    ctrl_hdr->fc.set_subtype(ControlSubtype::kBlockAckRequest);
+
+    auto bar = w.Write<BlockAckReqFrame>();
+    bar->ra = client;
+    bar->ta = bssid;
+    bar->bar_ctrl.set_compressed_bitmap(1);
+    bar->bar_ctrl.set_tid_info(tid);
+    bar->ssc.set_starting_seq(ssn);
+
+    packet->set_len(w.WrittenBytes());
+    wlan_rx_info_t rx_info{.rx_flags = 0};
+    packet->CopyCtrlFrom(rx_info);
+
+    *out_packet = fbl::move(packet);
+    return ZX_OK;
+}
+
 DataFrame<LlcHeader> CreateDataFrame(const uint8_t* payload, size_t len) {
     common::MacAddr bssid(kBssid1);
     common::MacAddr client(kClientAddress);
@@ -448,6 +574,46 @@ DataFrame<LlcHeader> CreateDataFrame(const uint8_t* payload, size_t len) {
     return data_frame;
 }
 
+DataFrame<LlcHeader> CreateQosDataFrame(const uint8_t* payload, size_t len, uint8_t tid,
+                                        uint16_t seq) {
+    common::MacAddr bssid(kBssid1);
+    common::MacAddr client(kClientAddress);
+
+    const size_t buf_len = DataFrameHeader::max_len() + LlcHeader::max_len() + len;
+    auto packet = GetWlanPacket(buf_len);
+    if (packet == nullptr) { return {}; }
+
+    wlan_rx_info_t rx_info{.rx_flags = 0};
+    packet->CopyCtrlFrom(rx_info);
+
+    DataFrame<LlcHeader> data_frame(fbl::move(packet));
+    auto data_hdr = data_frame.hdr();
+    std::memset(data_hdr, 0, DataFrameHeader::max_len());
+    data_hdr->fc.set_type(FrameType::kData);
+    data_hdr->fc.set_subtype(DataSubtype::kQosdata);
+    data_hdr->fc.set_from_ds(1);
+    data_hdr->addr1 = client;
+    data_hdr->addr2 = bssid;
+    data_hdr->addr3 = bssid;
+    data_hdr->sc.set_seq(seq);
+    data_hdr->qos_ctrl()->set_tid(tid);
+    data_hdr->qos_ctrl()->set_ack_policy(ack_policy::kNormalAck);
+
+    auto llc_hdr = data_frame.body();
+    llc_hdr->dsap = kLlcSnapExtension;
+    llc_hdr->ssap = kLlcSnapExtension;
+    llc_hdr->control = kLlcUnnumberedInformation;
+    std::memcpy(llc_hdr->oui, kLlcOui, sizeof(llc_hdr->oui));
+    llc_hdr->protocol_id = 42;
+    if (len > 0) { std::memcpy(llc_hdr->payload, payload, len); }
+
+    size_t actual_body_len = llc_hdr->len() + len;
+    auto status = data_frame.set_body_len(actual_body_len);
+    if (status != ZX_OK) { return {}; }
+
+    return data_frame;
+}
+
 DataFrame<> CreateNullDataFrame() {
     common::MacAddr bssid(kBssid1);
     common::MacAddr client(kClientAddress);
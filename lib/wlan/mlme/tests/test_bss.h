@@ -76,9 +76,19 @@ zx_status_t CreateDeauthFrame(fbl::unique_ptr<Packet>*);
 zx_status_t CreateBeaconFrame(fbl::unique_ptr<Packet>*);
 zx_status_t CreateBeaconFrameWithBssid(fbl::unique_ptr<Packet>*, common::MacAddr);
 zx_status_t CreateAssocReqFrame(fbl::unique_ptr<Packet>*);
+zx_status_t CreateAssocReqFrame(fbl::unique_ptr<Packet>*, const HtCapabilities* ht_cap);
+zx_status_t CreateHtAssocReqFrame(fbl::unique_ptr<Packet>*, const HtCapabilities& ht_cap);
 zx_status_t CreateAssocRespFrame(fbl::unique_ptr<Packet>*);
+zx_status_t CreateAssocRespFrame(fbl::unique_ptr<Packet>*, const HtCapabilities* ht_cap);
+zx_status_t CreateHtAssocRespFrame(fbl::unique_ptr<Packet>*, const HtCapabilities& ht_cap);
 zx_status_t CreateDisassocFrame(fbl::unique_ptr<Packet>*);
+zx_status_t CreateAddBaReqFrame(fbl::unique_ptr<Packet>*, uint8_t tid, uint16_t ssn,
+                                size_t buffer_size);
+zx_status_t CreateDelBaFrame(fbl::unique_ptr<Packet>*, uint8_t tid, bool initiator);
+zx_status_t CreateBlockAckReqFrame(fbl::unique_ptr<Packet>*, uint8_t tid, uint16_t ssn);
 DataFrame<LlcHeader> CreateDataFrame(const uint8_t* payload, size_t len);
+DataFrame<LlcHeader> CreateQosDataFrame(const uint8_t* payload, size_t len, uint8_t tid,
+                                        uint16_t seq);
 DataFrame<> CreateNullDataFrame();
 EthFrame CreateEthFrame(const uint8_t* payload, size_t len);
 
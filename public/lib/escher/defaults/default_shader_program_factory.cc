@@ -87,7 +87,7 @@ ShaderModuleTemplatePtr DefaultShaderProgramFactory::ObtainShaderModuleTemplate(
 
   auto t = fxl::MakeRefCounted<ShaderModuleTemplate>(
       escher_->vk_device(), escher_->shaderc_compiler(), stage, source_path,
-      filesystem_);
+      filesystem_, escher_->spirv_cache());
   templates_[source_path] = t;
   return t;
 }
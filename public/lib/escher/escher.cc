@@ -9,6 +9,7 @@
 #include "lib/escher/impl/glsl_compiler.h"
 #include "lib/escher/impl/image_cache.h"
 #include "lib/escher/impl/mesh_manager.h"
+#include "lib/escher/impl/spirv_cache.h"
 #include "lib/escher/impl/vk/pipeline_cache.h"
 #include "lib/escher/profiling/timestamp_profiler.h"
 #include "lib/escher/renderer/buffer_cache.h"
@@ -20,6 +21,7 @@
 #include "lib/escher/vk/gpu_allocator.h"
 #include "lib/escher/vk/impl/descriptor_set_allocator.h"
 #include "lib/escher/vk/impl/framebuffer_allocator.h"
+#include "lib/escher/vk/impl/persistent_pipeline_cache.h"
 #include "lib/escher/vk/impl/pipeline_layout_cache.h"
 #include "lib/escher/vk/impl/render_pass_cache.h"
 #include "lib/escher/vk/naive_gpu_allocator.h"
@@ -135,6 +137,7 @@ Escher::~Escher() {
 
   // Everything that refers to a ResourceRecycler must be released before their
   // ResourceRecycler is.
+  frame_manager_.reset();
   framebuffer_allocator_.reset();
   render_pass_cache_.reset();
   pipeline_layout_cache_.reset();
@@ -153,9 +156,24 @@ bool Escher::Cleanup() {
   if (auto pool = transfer_command_buffer_pool()) {
     finished = pool->Cleanup() && finished;
   }
+  if (persistent_pipeline_cache_) {
+    persistent_pipeline_cache_->MaybeSave();
+  }
   return finished;
 }
 
+void Escher::EnablePersistentShaderCache(const std::string& directory) {
+  TRACE_DURATION("gfx", "Escher::EnablePersistentShaderCache");
+  FXL_DCHECK(!spirv_cache_);
+  FXL_DCHECK(renderer_count_ == 0);
+
+  spirv_cache_ = std::make_unique<impl::SpirvCache>(directory);
+  glsl_compiler_->set_spirv_cache(spirv_cache_.get());
+  persistent_pipeline_cache_ = std::make_unique<impl::PersistentPipelineCache>(
+      vk_device(), vk_physical_device().getProperties(),
+      directory + "/pipeline_cache");
+}
+
 MeshBuilderPtr Escher::NewMeshBuilder(const MeshSpec& spec,
                                       size_t max_vertex_count,
                                       size_t max_index_count) {
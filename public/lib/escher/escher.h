@@ -99,6 +99,12 @@ class Escher : public MeshBuilderFactory, public ShaderProgramFactory {
 
   uint64_t GetNumGpuBytesAllocated();
 
+  // Store compiled SPIR-V and Vulkan pipeline data in |directory|, so that
+  // later instances of Escher can reuse them instead of compiling shaders and
+  // building pipelines from scratch.  Must be called before any renderers are
+  // created or shaders compiled.
+  void EnablePersistentShaderCache(const std::string& directory);
+
   impl::DescriptorSetAllocator* GetDescriptorSetAllocator(
       const impl::DescriptorSetLayout& layout);
 
@@ -125,6 +131,11 @@ class Escher : public MeshBuilderFactory, public ShaderProgramFactory {
     return command_buffer_sequencer_.get();
   }
   impl::GlslToSpirvCompiler* glsl_compiler() { return glsl_compiler_.get(); }
+  // Null unless EnablePersistentShaderCache() was called.
+  impl::SpirvCache* spirv_cache() { return spirv_cache_.get(); }
+  impl::PersistentPipelineCache* persistent_pipeline_cache() {
+    return persistent_pipeline_cache_.get();
+  }
   shaderc::Compiler* shaderc_compiler() { return shaderc_compiler_.get(); }
   impl::ImageCache* image_cache() { return image_cache_.get(); }
   BufferCache* buffer_cache() { return buffer_cache_.get(); }
@@ -179,6 +190,8 @@ class Escher : public MeshBuilderFactory, public ShaderProgramFactory {
   std::unique_ptr<impl::GlslToSpirvCompiler> glsl_compiler_;
   std::unique_ptr<shaderc::Compiler> shaderc_compiler_;
   std::unique_ptr<impl::PipelineCache> pipeline_cache_;
+  std::unique_ptr<impl::SpirvCache> spirv_cache_;
+  std::unique_ptr<impl::PersistentPipelineCache> persistent_pipeline_cache_;
   // Everything below this point requires |weak_factory_| to be initialized
   // before they can be constructed.
 
@@ -20,6 +20,7 @@ class CommandBuffer;
 class DefaultShaderProgramFactory;
 class Escher;
 class Frame;
+class FrameArena;
 class Framebuffer;
 class GpuAllocator;
 class GpuMem;
@@ -107,6 +108,7 @@ class ModelRenderer;
 class ModelRenderPass;
 class Pipeline;
 class PipelineCache;
+class SpirvCache;
 class SsdoAccelerator;
 class SsdoSampler;
 class UniformBufferPool;
@@ -123,6 +125,7 @@ typedef fxl::WeakPtr<UniformBufferPool> UniformBufferPoolWeakPtr;
 class DescriptorSetAllocator;
 class Framebuffer;
 class FramebufferAllocator;
+class PersistentPipelineCache;
 class PipelineLayoutCache;
 class RenderPass;
 class RenderPassCache;
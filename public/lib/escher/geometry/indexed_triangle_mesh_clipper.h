@@ -0,0 +1,391 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LIB_ESCHER_GEOMETRY_INDEXED_TRIANGLE_MESH_CLIPPER_H_
+#define LIB_ESCHER_GEOMETRY_INDEXED_TRIANGLE_MESH_CLIPPER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "lib/escher/geometry/indexed_triangle_mesh_clip.h"
+
+namespace escher {
+
+// Helpers that return the Z-coordinate of a mesh position.  2D positions lie
+// on the Z == 0 plane, which is also how PlaneDistanceToPoint() promotes them
+// when they are tested against a plane3.
+inline float IndexedTriangleMeshClipperPositionZ(const vec2& position) {
+  return 0.f;
+}
+inline float IndexedTriangleMeshClipperPositionZ(const vec3& position) {
+  return position.z;
+}
+
+// IndexedTriangleMeshClipper produces exactly the same meshes as
+// IndexedTriangleMeshClip(), but is cheaper when clipping many meshes:
+// - the vertex positions are copied into separate X/Y/Z arrays, and each
+//   vertex is classified against up to 32 planes at once, in tight loops that
+//   the compiler can vectorize.  This yields a bitmask per vertex; vertices
+//   generated while clipping inherit or compute their own mask, so the mesh
+//   is only reclassified once every 32 planes.
+// - input vertices are remapped via a flat array instead of a hash map, and
+//   split edges are deduplicated with a flat open-addressed table.
+// - the scratch arrays, tables and intermediate mesh are kept between calls,
+//   so clipping a stream of similarly-sized meshes doesn't allocate.
+//
+// Not thread-safe; use one clipper per thread.
+template <typename MeshT, typename PlaneT>
+class IndexedTriangleMeshClipper {
+ public:
+  using Edge = typename MeshT::EdgeType;
+  using Index = typename MeshT::IndexType;
+  using Position = typename MeshT::PositionType;
+
+  // Same contract as IndexedTriangleMeshClip().
+  std::pair<MeshT, std::vector<PlaneT>> Clip(MeshT input_mesh,
+                                             const PlaneT* planes,
+                                             size_t num_planes);
+  std::pair<MeshT, std::vector<PlaneT>> Clip(
+      MeshT input_mesh, const std::vector<PlaneT>& planes) {
+    return Clip(std::move(input_mesh), planes.data(), planes.size());
+  }
+
+ private:
+  static_assert(sizeof(Index) <= sizeof(uint32_t),
+                "split edge keys pack two indices into 64 bits");
+
+  // Number of planes that a vertex is classified against at once; one bit of
+  // the vertex mask per plane.
+  static constexpr size_t kMaxPlanesPerBatch = 32;
+  static constexpr Index kUnmappedIndex = std::numeric_limits<Index>::max();
+
+  // An entry of the split edge table.  Entries whose |generation| doesn't
+  // match |split_edge_generation_| are empty, so the table doesn't need to be
+  // cleared between clipping passes.
+  struct SplitEdge {
+    uint64_t key = 0;
+    uint32_t generation = 0;
+    Index index = 0;
+  };
+
+  // Fills |vertex_masks_| by classifying each of |positions| against each of
+  // |planes|; bit N of a mask is set if the vertex is clipped by planes[N].
+  // Returns the bitwise-OR of all masks.
+  uint32_t ClassifyVertices(const std::vector<Position>& positions,
+                            const PlaneT* planes, size_t num_planes);
+
+  // Classifies a single point, as above.
+  static uint32_t ClassifyPoint(const Position& position, const PlaneT* planes,
+                                size_t num_planes) {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < num_planes; ++i) {
+      mask |= PlaneClipsPoint(planes[i], position) ? (1u << i) : 0u;
+    }
+    return mask;
+  }
+
+  // Prepares the split edge table to hold up to |max_split_edges| edges.
+  void BeginSplitEdgePass(size_t max_split_edges);
+
+  // Returns the table entry for |edge|, which must be in canonical order.  If
+  // |*found| is false, the entry is empty and the caller must fill it in.
+  SplitEdge* FindSplitEdge(const Edge& edge, bool* found);
+
+  std::vector<float> xs_;
+  std::vector<float> ys_;
+  std::vector<float> zs_;
+  std::vector<uint32_t> vertex_masks_;
+  std::vector<uint32_t> output_vertex_masks_;
+  std::vector<Index> remapped_indices_;
+  std::vector<SplitEdge> split_edges_;
+  uint32_t split_edge_generation_ = 0;
+  // Holds the capacity of the intermediate mesh between calls.
+  MeshT scratch_mesh_;
+};
+
+template <typename MeshT, typename PlaneT>
+uint32_t IndexedTriangleMeshClipper<MeshT, PlaneT>::ClassifyVertices(
+    const std::vector<Position>& positions, const PlaneT* planes,
+    size_t num_planes) {
+  TRACE_DURATION("gfx", "escher::IndexedTriangleMeshClipper::ClassifyVertices",
+                 "vertices", positions.size(), "num_planes", num_planes);
+  FXL_DCHECK(num_planes <= kMaxPlanesPerBatch);
+
+  const size_t num_vertices = positions.size();
+  xs_.resize(num_vertices);
+  ys_.resize(num_vertices);
+  zs_.resize(num_vertices);
+  for (size_t i = 0; i < num_vertices; ++i) {
+    xs_[i] = positions[i].x;
+    ys_[i] = positions[i].y;
+    zs_[i] = IndexedTriangleMeshClipperPositionZ(positions[i]);
+  }
+
+  vertex_masks_.assign(num_vertices, 0);
+  const float* xs = xs_.data();
+  const float* ys = ys_.data();
+  const float* zs = zs_.data();
+  uint32_t* masks = vertex_masks_.data();
+  for (size_t plane_index = 0; plane_index < num_planes; ++plane_index) {
+    // PlaneClipsPoint() demotes the point again for 2D planes, so that the
+    // arithmetic matches IndexedTriangleMeshClip() exactly.
+    const PlaneT plane = planes[plane_index];
+    const uint32_t bit = 1u << plane_index;
+    for (size_t i = 0; i < num_vertices; ++i) {
+      masks[i] |= PlaneClipsPoint(plane, vec3(xs[i], ys[i], zs[i])) ? bit : 0u;
+    }
+  }
+
+  uint32_t clipped_planes = 0;
+  for (size_t i = 0; i < num_vertices; ++i) {
+    clipped_planes |= masks[i];
+  }
+  return clipped_planes;
+}
+
+template <typename MeshT, typename PlaneT>
+void IndexedTriangleMeshClipper<MeshT, PlaneT>::BeginSplitEdgePass(
+    size_t max_split_edges) {
+  // Keep the load factor at or below 1/2.
+  size_t capacity = 16;
+  while (capacity < 2 * max_split_edges) {
+    capacity *= 2;
+  }
+  if (capacity > split_edges_.size()) {
+    split_edges_.assign(capacity, SplitEdge());
+    split_edge_generation_ = 0;
+  }
+  if (++split_edge_generation_ == 0) {
+    for (auto& split_edge : split_edges_) {
+      split_edge.generation = 0;
+    }
+    split_edge_generation_ = 1;
+  }
+}
+
+template <typename MeshT, typename PlaneT>
+auto IndexedTriangleMeshClipper<MeshT, PlaneT>::FindSplitEdge(const Edge& edge,
+                                                              bool* found)
+    -> SplitEdge* {
+  const uint64_t key = (static_cast<uint64_t>(edge.first) << 32) | edge.second;
+  const size_t mask = split_edges_.size() - 1;
+  size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32);
+  while (true) {
+    slot &= mask;
+    SplitEdge* split_edge = &split_edges_[slot];
+    if (split_edge->generation != split_edge_generation_) {
+      split_edge->key = key;
+      split_edge->generation = split_edge_generation_;
+      *found = false;
+      return split_edge;
+    }
+    if (split_edge->key == key) {
+      *found = true;
+      return split_edge;
+    }
+    ++slot;
+  }
+}
+
+// See IndexedTriangleMeshClip() for an explanation of the algorithm; the order
+// in which triangles and vertices are emitted is identical.
+template <typename MeshT, typename PlaneT>
+auto IndexedTriangleMeshClipper<MeshT, PlaneT>::Clip(MeshT input_mesh,
+                                                     const PlaneT* planes,
+                                                     size_t num_planes)
+    -> std::pair<MeshT, std::vector<PlaneT>> {
+  TRACE_DURATION("gfx", "escher::IndexedTriangleMeshClipper::Clip",
+                 "triangles", input_mesh.triangle_count(), "vertices",
+                 input_mesh.vertex_count(), "num_planes", num_planes);
+  FXL_DCHECK(input_mesh.IsValid());
+
+  std::pair<MeshT, std::vector<PlaneT>> result;
+  auto& output_planes = result.second;
+
+  MeshT output_mesh = std::move(scratch_mesh_);
+  output_mesh.clear();
+
+  // Planes [batch_begin, batch_end) are those that |vertex_masks_| refers to.
+  size_t batch_begin = 0;
+  size_t batch_end = 0;
+  // Bit N is set if planes[batch_begin + N] clips any vertex of |input_mesh|.
+  uint32_t clipped_planes = 0;
+
+  for (size_t plane_index = 0; plane_index < num_planes; ++plane_index) {
+    if (plane_index == batch_end) {
+      batch_begin = plane_index;
+      batch_end = std::min(num_planes, batch_begin + kMaxPlanesPerBatch);
+      clipped_planes = ClassifyVertices(
+          input_mesh.positions, planes + batch_begin, batch_end - batch_begin);
+    }
+    const uint32_t plane_bit = 1u << (plane_index - batch_begin);
+    if (!(clipped_planes & plane_bit)) {
+      // No vertices are clipped by the current plane, so the mesh is
+      // unchanged.
+      continue;
+    }
+
+    TRACE_DURATION("gfx", "escher::IndexedTriangleMeshClipper::Clip[loop]",
+                   "plane_index", plane_index);
+    auto& plane = planes[plane_index];
+    output_planes.push_back(plane);
+
+    const size_t input_index_count = input_mesh.index_count();
+    FXL_DCHECK(input_index_count % 3 == 0);
+    remapped_indices_.assign(input_mesh.vertex_count(), kUnmappedIndex);
+    // Only triangles with one or two clipped vertices split edges, two each.
+    BeginSplitEdgePass(2 * input_mesh.triangle_count());
+    output_vertex_masks_.clear();
+    uint32_t output_clipped_planes = 0;
+
+    const uint32_t* input_masks = vertex_masks_.data();
+    auto remapped_index_for_unclipped_vertex =
+        [this, &input_mesh, &output_mesh, input_masks,
+         &output_clipped_planes](Index original_index) -> Index {
+      FXL_DCHECK(original_index < input_mesh.vertex_count());
+      Index& remapped_index = remapped_indices_[original_index];
+      if (remapped_index != kUnmappedIndex) {
+        return remapped_index;
+      }
+      remapped_index = output_mesh.vertex_count();
+      IndexedTriangleMeshPushCopiedAttributes(&output_mesh, &input_mesh,
+                                              original_index);
+      const uint32_t mask = input_masks[original_index];
+      output_vertex_masks_.push_back(mask);
+      output_clipped_planes |= mask;
+      return remapped_index;
+    };
+
+    const PlaneT* batch_planes = planes + batch_begin;
+    const size_t batch_size = batch_end - batch_begin;
+    auto get_index_for_split_edge_vertex =
+        [this, &plane, &input_mesh, &output_mesh, batch_planes, batch_size,
+         &output_clipped_planes](Edge edge) -> Index {
+      if (edge.first > edge.second) {
+        std::swap(edge.first, edge.second);
+      }
+
+      bool found;
+      SplitEdge* split_edge = FindSplitEdge(edge, &found);
+      if (found) {
+        return split_edge->index;
+      }
+
+      const Position edge_origin = input_mesh.positions[edge.first];
+      const Position edge_vector =
+          input_mesh.positions[edge.second] - edge_origin;
+      float t = IntersectLinePlane(edge_origin, edge_vector, plane);
+      if (t == FLT_MAX) {
+        // See IndexedTriangleMeshClip().
+        t = 0.5f;
+
+        const char* error_msg = "plane doesn't intersect triangle edge: ";
+        FXL_DCHECK(false) << error_msg << plane << "  origin: " << edge_origin
+                          << "  vector: " << edge_vector;
+        FXL_LOG(ERROR) << error_msg << plane << "  origin: " << edge_origin
+                       << "  vector: " << edge_vector;
+      }
+      const Index new_index = output_mesh.vertex_count();
+      IndexedTriangleMeshPushLerpedAttributes(&output_mesh, &input_mesh,
+                                              edge.first, edge.second, t);
+      const uint32_t mask = ClassifyPoint(output_mesh.positions.back(),
+                                          batch_planes, batch_size);
+      output_vertex_masks_.push_back(mask);
+      output_clipped_planes |= mask;
+
+      split_edge->index = new_index;
+      return new_index;
+    };
+
+    for (size_t i = 0; i + 2 < input_index_count; i += 3) {
+      Index* tri = input_mesh.indices.data() + i;
+
+      const bool v0_clipped = input_masks[tri[0]] & plane_bit;
+      const bool v1_clipped = input_masks[tri[1]] & plane_bit;
+      const bool v2_clipped = input_masks[tri[2]] & plane_bit;
+      const int clipped_count =
+          (v0_clipped ? 1 : 0) + (v1_clipped ? 1 : 0) + (v2_clipped ? 1 : 0);
+      switch (clipped_count) {
+        case 0: {
+          output_mesh.indices.push_back(
+              remapped_index_for_unclipped_vertex(tri[0]));
+          output_mesh.indices.push_back(
+              remapped_index_for_unclipped_vertex(tri[1]));
+          output_mesh.indices.push_back(
+              remapped_index_for_unclipped_vertex(tri[2]));
+        } break;
+        case 1: {
+          Index clipped_tip = v0_clipped ? 0 : (v1_clipped ? 1 : 2);
+
+          Index edge_index_1 = get_index_for_split_edge_vertex(
+              {tri[clipped_tip], tri[(clipped_tip + 2) % 3]});
+          Index edge_index_2 = get_index_for_split_edge_vertex(
+              {tri[clipped_tip], tri[(clipped_tip + 1) % 3]});
+          output_mesh.indices.push_back(edge_index_1);
+          output_mesh.indices.push_back(edge_index_2);
+
+          // Split the quad along the shorter diagonal.
+          Position vector_from_edge_index_1 =
+              input_mesh.positions[tri[(clipped_tip + 1) % 3]] -
+              output_mesh.positions[edge_index_1];
+          Position vector_from_edge_index_2 =
+              input_mesh.positions[tri[(clipped_tip + 2) % 3]] -
+              output_mesh.positions[edge_index_2];
+
+          if (glm::dot(vector_from_edge_index_1, vector_from_edge_index_1) <
+              glm::dot(vector_from_edge_index_2, vector_from_edge_index_2)) {
+            Index diagonal_index =
+                remapped_index_for_unclipped_vertex(tri[(clipped_tip + 1) % 3]);
+            output_mesh.indices.push_back(diagonal_index);
+
+            output_mesh.indices.push_back(edge_index_1);
+            output_mesh.indices.push_back(diagonal_index);
+            output_mesh.indices.push_back(remapped_index_for_unclipped_vertex(
+                tri[(clipped_tip + 2) % 3]));
+          } else {
+            Index diagonal_index =
+                remapped_index_for_unclipped_vertex(tri[(clipped_tip + 2) % 3]);
+            output_mesh.indices.push_back(diagonal_index);
+
+            output_mesh.indices.push_back(edge_index_2);
+            output_mesh.indices.push_back(remapped_index_for_unclipped_vertex(
+                tri[(clipped_tip + 1) % 3]));
+            output_mesh.indices.push_back(diagonal_index);
+          }
+        } break;
+        case 2: {
+          Index unclipped_tip = v0_clipped ? (v1_clipped ? 2 : 1) : 0;
+
+          output_mesh.indices.push_back(
+              remapped_index_for_unclipped_vertex(tri[unclipped_tip]));
+          output_mesh.indices.push_back(get_index_for_split_edge_vertex(
+              {tri[unclipped_tip], tri[(unclipped_tip + 1) % 3]}));
+          output_mesh.indices.push_back(get_index_for_split_edge_vertex(
+              {tri[unclipped_tip], tri[(unclipped_tip + 2) % 3]}));
+        } break;
+        default:
+          FXL_DCHECK(clipped_count == 3);
+      }
+    }
+
+    // The output of this pass is the input to the next.  Its vertex masks are
+    // still valid for the remaining planes of the batch.
+    std::swap(input_mesh, output_mesh);
+    std::swap(vertex_masks_, output_vertex_masks_);
+    output_mesh.clear();
+    clipped_planes = output_clipped_planes;
+  }
+
+  result.first = std::move(input_mesh);
+  scratch_mesh_ = std::move(output_mesh);
+  FXL_DCHECK(result.first.index_count() % 3 == 0);
+  return result;
+}
+
+}  // namespace escher
+
+#endif  // LIB_ESCHER_GEOMETRY_INDEXED_TRIANGLE_MESH_CLIPPER_H_
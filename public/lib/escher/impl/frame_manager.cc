@@ -11,17 +11,7 @@ namespace escher {
 namespace impl {
 
 FrameManager::FrameManager(EscherWeakPtr escher)
-    : ResourceManager(escher),
-      // TODO(ES-103): the intention here was to use UniformBufferPool's
-      // recently-added ring-based recycling to manage resource reclamation.
-      // However, this would conflict with upcoming GpuUploader changes; see
-      // SCN-842.
-      // For now, clients must use an approach like ModelDisplayListBuilder's,
-      // which takes additional steps to retain uniform buffers to prevent them
-      // from being returned to the pool too early, resulting in the current
-      // frame's data being stomped by the next frame's while it is still in
-      // use.
-      uniform_buffer_pool_(std::move(escher), 1) {
+    : ResourceManager(std::move(escher)) {
   // Escher apps will at least double-buffer, so avoid expensive allocations in
   // the initial few frames.
   constexpr int kInitialBlockAllocatorCount = 2;
@@ -36,10 +26,9 @@ FramePtr FrameManager::NewFrame(const char* trace_literal,
                                 uint64_t frame_number, bool enable_gpu_logging,
                                 escher::CommandBuffer::Type requested_type) {
   TRACE_DURATION("gfx", "escher::FrameManager::NewFrame");
-  uniform_buffer_pool_.BeginFrame();
   FramePtr frame = fxl::AdoptRef<Frame>(
       new Frame(this, requested_type, std::move(*GetBlockAllocator().get()),
-                uniform_buffer_pool_.GetWeakPtr(), frame_number, trace_literal,
+                GetFrameArena(), frame_number, trace_literal,
                 enable_gpu_logging));
   frame->BeginFrame();
   return frame;
@@ -50,6 +39,7 @@ void FrameManager::OnReceiveOwnable(std::unique_ptr<Resource> resource) {
   auto frame = static_cast<Frame*>(resource.get());
   block_allocators_.push(
       std::make_unique<BlockAllocator>(frame->TakeBlockAllocator()));
+  frame_arenas_.push(frame->TakeArena());
 }
 
 std::unique_ptr<BlockAllocator> FrameManager::GetBlockAllocator() {
@@ -62,5 +52,15 @@ std::unique_ptr<BlockAllocator> FrameManager::GetBlockAllocator() {
   return alloc;
 }
 
+std::unique_ptr<FrameArena> FrameManager::GetFrameArena() {
+  if (frame_arenas_.empty()) {
+    return std::make_unique<FrameArena>(escher()->GetWeakPtr());
+  }
+
+  std::unique_ptr<FrameArena> arena(std::move(frame_arenas_.front()));
+  frame_arenas_.pop();
+  return arena;
+}
+
 }  // namespace impl
 }  // namespace escher
@@ -8,7 +8,7 @@
 #include <queue>
 
 #include "lib/escher/forward_declarations.h"
-#include "lib/escher/impl/uniform_buffer_pool.h"
+#include "lib/escher/renderer/frame_arena.h"
 #include "lib/escher/resources/resource_manager.h"
 #include "lib/escher/vk/command_buffer.h"
 
@@ -46,10 +46,15 @@ class FrameManager : public ResourceManager {
   // are free.
   std::unique_ptr<BlockAllocator> GetBlockAllocator();
 
+  // Return a FrameArena from |frame_arenas_|, or a new one if none are free.
+  // Arenas are returned along with the frame's BlockAllocator, after they
+  // have been reset.
+  std::unique_ptr<FrameArena> GetFrameArena();
+
   std::queue<std::unique_ptr<BlockAllocator>> block_allocators_;
+  std::queue<std::unique_ptr<FrameArena>> frame_arenas_;
 
   uint32_t num_outstanding_frames_ = 0;
-  UniformBufferPool uniform_buffer_pool_;
 };
 
 }  // namespace impl
@@ -47,11 +47,25 @@ SpirvData GlslToSpirvCompiler::SynchronousCompile(
     std::string preamble, std::string entry_point) {
   TRACE_DURATION("gfx", "escher::GlslToSpirvCompiler::SynchronousCompile");
 
+  SpirvData result;
+  Hash key = {};
+  if (spirv_cache_) {
+    key = SpirvCache::KeyForGlsl(stage, source_code, preamble, entry_point);
+    if (spirv_cache_->Load(key, &result)) {
+      // Count was already incremented by Compile().
+      --active_compile_count_;
+      return result;
+    }
+  }
+
   // SynchronousCompileImpl has many return points; wrap it so that we don't
   // forget to --active_compile_count_ at one of them.
-  auto result =
+  result =
       SynchronousCompileImpl(stage, std::move(source_code), std::move(preamble),
                              std::move(entry_point));
+  if (spirv_cache_ && !result.empty()) {
+    spirv_cache_->Store(key, result);
+  }
   // Count was already incremented by Compile().
   --active_compile_count_;
   return result;
@@ -9,11 +9,11 @@
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
+#include "lib/escher/impl/spirv_cache.h"
+
 namespace escher {
 namespace impl {
 
-typedef std::vector<uint32_t> SpirvData;
-
 // Wraps the reference GLSL compiler provided by Khronos.
 // TODO: GLSL standard library functions are currently not available.
 class GlslToSpirvCompiler {
@@ -29,6 +29,11 @@ class GlslToSpirvCompiler {
                                  std::vector<std::string> glsl_source_code,
                                  std::string preamble, std::string entry_point);
 
+  // If set, compiled SPIR-V is looked up in and added to |cache|, which must
+  // outlive this compiler.
+  void set_spirv_cache(SpirvCache* cache) { spirv_cache_ = cache; }
+  SpirvCache* spirv_cache() const { return spirv_cache_; }
+
  private:
   // Same as Compile(), but completes synchronously.
   SpirvData SynchronousCompile(vk::ShaderStageFlagBits stage,
@@ -42,6 +47,7 @@ class GlslToSpirvCompiler {
                                    std::string entry_point);
 
   std::atomic<uint32_t> active_compile_count_;
+  SpirvCache* spirv_cache_ = nullptr;
 };
 
 }  // namespace impl
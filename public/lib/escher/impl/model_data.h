@@ -116,12 +116,6 @@ class ModelData : public fxl::RefCountedThreadSafe<ModelData> {
 
   const MeshShaderBinding& GetMeshShaderBinding(MeshSpec spec);
 
- private:
-  // If no allocator is provided, Escher's default one will be used.
-  explicit ModelData(EscherWeakPtr escher, GpuAllocator* allocator = nullptr);
-
-  ~ModelData();
-
   // Provide access to statically-allocated layout info for per-model and
   // per-object descriptor-sets.
   static const vk::DescriptorSetLayoutCreateInfo&
@@ -129,6 +123,12 @@ class ModelData : public fxl::RefCountedThreadSafe<ModelData> {
   static const vk::DescriptorSetLayoutCreateInfo&
   GetPerObjectDescriptorSetLayoutCreateInfo();
 
+ private:
+  // If no allocator is provided, Escher's default one will be used.
+  explicit ModelData(EscherWeakPtr escher, GpuAllocator* allocator = nullptr);
+
+  ~ModelData();
+
   vk::Device device_;
   UniformBufferPool uniform_buffer_pool_;
   DescriptorSetPool per_model_descriptor_set_pool_;
@@ -11,6 +11,7 @@
 #include "lib/escher/impl/model_render_pass.h"
 #include "lib/escher/impl/model_renderer.h"
 #include "lib/escher/impl/z_sort.h"
+#include "lib/escher/renderer/frame_arena.h"
 #include "lib/escher/renderer/shadow_map.h"
 #include "lib/escher/scene/camera.h"
 #include "lib/escher/util/align.h"
@@ -45,7 +46,8 @@ ModelDisplayListBuilder::ModelDisplayListBuilder(
     const TexturePtr& shadow_texture, const mat4& shadow_matrix,
     vec3 ambient_light_intensity, vec3 direct_light_intensity,
     ModelData* model_data, ModelRenderer* renderer,
-    ModelRenderPassPtr render_pass, ModelDisplayListFlags flags)
+    ModelRenderPassPtr render_pass, ModelDisplayListFlags flags,
+    FrameArena* frame_arena)
     : device_(device),
       volume_(stage.viewing_volume()),
       view_transform_(camera.transform()),
@@ -58,6 +60,8 @@ ModelDisplayListBuilder::ModelDisplayListBuilder(
       renderer_(renderer),
       render_pass_(std::move(render_pass)),
       pipeline_cache_(render_pass_->pipeline_cache()),
+      model_data_(model_data),
+      frame_arena_(frame_arena),
       uniform_buffer_pool_(model_data->uniform_buffer_pool()),
       per_model_descriptor_set_pool_(
           model_data->per_model_descriptor_set_pool()),
@@ -83,15 +87,12 @@ ModelDisplayListBuilder::ModelDisplayListBuilder(
   }
 
   // Obtain the single per-Model descriptor set.
-  DescriptorSetAllocationPtr per_model_descriptor_set_allocation =
-      per_model_descriptor_set_pool_->Allocate(1, nullptr);
   {
     // It would be inconvenient to set this in the initializer, so we briefly
     // cast it to set its permanent value.
     auto& unconst = const_cast<vk::DescriptorSet&>(per_model_descriptor_set_);
-    unconst = per_model_descriptor_set_allocation->get(0);
+    unconst = ObtainPerModelDescriptorSet();
   }
-  resources_.push_back(std::move(per_model_descriptor_set_allocation));
 
   // Update each descriptor in the PerModel descriptor set.
   vk::WriteDescriptorSet writes[ModelData::PerModel::kDescriptorCount];
@@ -122,12 +123,12 @@ ModelDisplayListBuilder::ModelDisplayListBuilder(
 
   uniform_buffer_write_index_ += sizeof(ModelData::PerModel);
 
-  BufferPtr vp_uniform_buffer;
+  vk::Buffer vp_uniform_buffer;
   uint32_t vp_uniform_buffer_offset = 0;
   if (camera.pose_buffer()) {
     // If the camera has a pose buffer bind the output of the late latching
     // shader to the VP uniform.
-    vp_uniform_buffer = camera.latched_pose_buffer();
+    vp_uniform_buffer = camera.latched_pose_buffer()->vk();
     // Pose buffer latching shader writes the latched pose before the VP matrix
     // so we need to offset past it.
     vp_uniform_buffer_offset = sizeof(hmd::Pose);
@@ -141,7 +142,7 @@ ModelDisplayListBuilder::ModelDisplayListBuilder(
     auto view_projection = reinterpret_cast<ModelData::ViewProjection*>(
         &(uniform_buffer_->host_ptr()[uniform_buffer_write_index_]));
     view_projection->vp_matrix = projection_transform_ * view_transform_;
-    vp_uniform_buffer = uniform_buffer_;
+    vp_uniform_buffer = uniform_buffer_->vk();
     vp_uniform_buffer_offset = uniform_buffer_write_index_;
   }
 
@@ -153,7 +154,7 @@ ModelDisplayListBuilder::ModelDisplayListBuilder(
   vp_buffer_write.descriptorCount = 1;
   vp_buffer_write.descriptorType = vk::DescriptorType::eUniformBuffer;
   vk::DescriptorBufferInfo vp_buffer_info;
-  vp_buffer_info.buffer = vp_uniform_buffer->vk();
+  vp_buffer_info.buffer = vp_uniform_buffer;
   vp_buffer_info.range = sizeof(ModelData::ViewProjection);
   vp_buffer_info.offset = vp_uniform_buffer_offset;
   vp_buffer_write.pBufferInfo = &vp_buffer_info;
@@ -402,14 +403,12 @@ ModelDisplayListPtr ModelDisplayListBuilder::Build(
 
     // The display list still needs to retain the buffer, and since it no
     // longer needs special treatment, add it in with the other resources.
-    //
-    // NOTE: see comment in ModelData constructor... at some point there will
-    // probably be an Escher-wide UniformBufferPool that will use a per-Frame
-    // resource management strategy.  ModelDisplayListBuilder will not be around
-    // for long enough to make updating it worthwhile.
     resources_.push_back(std::move(uniform_buffer));
   }
   uniform_buffers_.clear();
+  // The blocks of |frame_arena_| are host-coherent, and host writes are made
+  // visible to the device when the frame's command buffer is submitted, so
+  // they need no barrier.  The arena retains them until the frame is done.
 
   auto display_list = fxl::MakeRefCounted<ModelDisplayList>(
       renderer_->resource_recycler(), per_model_descriptor_set_,
@@ -418,7 +417,33 @@ ModelDisplayListPtr ModelDisplayListBuilder::Build(
   return display_list;
 }
 
+vk::DescriptorSet ModelDisplayListBuilder::ObtainPerModelDescriptorSet() {
+  if (frame_arena_) {
+    vk::DescriptorSet ds = frame_arena_->AllocateDescriptorSet(
+        model_data_->per_model_layout(),
+        ModelData::GetPerModelDescriptorSetLayoutCreateInfo());
+    if (ds) {
+      return ds;
+    }
+  }
+
+  DescriptorSetAllocationPtr allocation =
+      per_model_descriptor_set_pool_->Allocate(1, nullptr);
+  vk::DescriptorSet ds = allocation->get(0);
+  resources_.push_back(std::move(allocation));
+  return ds;
+}
+
 vk::DescriptorSet ModelDisplayListBuilder::ObtainPerObjectDescriptorSet() {
+  if (frame_arena_) {
+    vk::DescriptorSet ds = frame_arena_->AllocateDescriptorSet(
+        model_data_->per_object_layout(),
+        ModelData::GetPerObjectDescriptorSetLayoutCreateInfo());
+    if (ds) {
+      return ds;
+    }
+  }
+
   if (!per_object_descriptor_set_allocation_ ||
       per_object_descriptor_set_index_ >=
           per_object_descriptor_set_allocation_->size()) {
@@ -440,14 +465,22 @@ vk::DescriptorSet ModelDisplayListBuilder::ObtainPerObjectDescriptorSet() {
 
 void ModelDisplayListBuilder::PrepareUniformBufferForWriteOfSize(
     size_t size, size_t alignment) {
+  if (frame_arena_) {
+    UniformAllocation allocation =
+        frame_arena_->AllocateUniform(size, alignment);
+    uniform_buffer_ = allocation.buffer;
+    uniform_buffer_write_index_ = static_cast<uint32_t>(allocation.offset);
+    return;
+  }
+
   uniform_buffer_write_index_ =
       AlignedToNext(uniform_buffer_write_index_, alignment);
 
   if (!uniform_buffer_ ||
       uniform_buffer_write_index_ + size > uniform_buffer_->size()) {
-    uniform_buffer_ = uniform_buffer_pool_->Allocate();
+    uniform_buffers_.push_back(uniform_buffer_pool_->Allocate());
+    uniform_buffer_ = uniform_buffers_.back().get();
     uniform_buffer_write_index_ = 0;
-    uniform_buffers_.push_back(uniform_buffer_);
   }
 }
 
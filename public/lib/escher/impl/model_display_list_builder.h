@@ -21,14 +21,17 @@ namespace impl {
 class ModelDisplayListBuilder {
  public:
   // OK to pass null |shadow_texture|; in that case, |white_texture| will
-  // be used instead.
+  // be used instead.  If |frame_arena| is not null, uniforms and descriptor
+  // sets are allocated from it, and the display list must not outlive the
+  // frame; otherwise they come from |model_data|'s pools.
   ModelDisplayListBuilder(
       vk::Device device, const Stage& stage, const Model& model,
       const Camera& camera, float scale, const TexturePtr& white_texture,
       const TexturePtr& shadow_texture, const mat4& shadow_matrix,
       vec3 ambient_light_intensity, vec3 direct_light_intensity,
       ModelData* model_data, ModelRenderer* renderer,
-      ModelRenderPassPtr render_pass, ModelDisplayListFlags flags);
+      ModelRenderPassPtr render_pass, ModelDisplayListFlags flags,
+      FrameArena* frame_arena);
 
   ~ModelDisplayListBuilder();
 
@@ -52,6 +55,7 @@ class ModelDisplayListBuilder {
   void AddNonClipperObject(const Object& object);
 
   void PrepareUniformBufferForWriteOfSize(size_t size, size_t alignment);
+  vk::DescriptorSet ObtainPerModelDescriptorSet();
   vk::DescriptorSet ObtainPerObjectDescriptorSet();
   void UpdateDescriptorSetForObject(const Object& object,
                                     vk::DescriptorSet descriptor_set);
@@ -89,8 +93,9 @@ class ModelDisplayListBuilder {
   // have a semaphore that must be waited upon.
   std::vector<TexturePtr> textures_;
 
-  // Uniform buffers are handled differently from other resources, because they
-  // must be flushed before they can be used by a display list.
+  // Uniform buffers from |uniform_buffer_pool_| are handled differently from
+  // other resources, because they must be flushed before they can be used by a
+  // display list.
   std::vector<BufferPtr> uniform_buffers_;
 
   // A list of resources that must be retained until the display list is no
@@ -101,13 +106,16 @@ class ModelDisplayListBuilder {
   ModelRenderPassPtr render_pass_;
   ModelPipelineCache* const pipeline_cache_;
 
+  ModelData* const model_data_;
+  FrameArena* const frame_arena_;
   UniformBufferPool* const uniform_buffer_pool_;
   DescriptorSetPool* const per_model_descriptor_set_pool_;
   DescriptorSetPool* const per_object_descriptor_set_pool_;
 
   DescriptorSetAllocationPtr per_object_descriptor_set_allocation_;
 
-  BufferPtr uniform_buffer_;
+  // Either a block of |frame_arena_|, or the last of |uniform_buffers_|.
+  Buffer* uniform_buffer_ = nullptr;
   uint32_t uniform_buffer_write_index_ = 0;
   uint32_t per_object_descriptor_set_index_ = 0;
 
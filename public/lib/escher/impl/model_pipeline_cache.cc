@@ -4,6 +4,7 @@
 
 #include "lib/escher/impl/model_pipeline_cache.h"
 
+#include "lib/escher/escher.h"
 #include "lib/escher/geometry/types.h"
 #include "lib/escher/impl/glsl_compiler.h"
 #include "lib/escher/impl/mesh_shader_binding.h"
@@ -13,6 +14,7 @@
 #include "lib/escher/impl/vulkan_utils.h"
 #include "lib/escher/resources/resource_recycler.h"
 #include "lib/escher/util/trace_macros.h"
+#include "lib/escher/vk/impl/persistent_pipeline_cache.h"
 
 namespace escher {
 namespace impl {
@@ -30,6 +32,9 @@ ModelPipelineCache::ModelPipelineCache(ResourceRecycler* recycler,
       compiler_(std::make_unique<GlslToSpirvCompiler>()) {
   FXL_DCHECK(model_data_);
   FXL_DCHECK(render_pass_);
+  if (escher()) {
+    compiler_->set_spirv_cache(escher()->spirv_cache());
+  }
 }
 
 ModelPipelineCache::~ModelPipelineCache() { pipelines_.clear(); }
@@ -54,7 +59,8 @@ std::pair<vk::Pipeline, vk::PipelineLayout> NewPipelineHelper(
     bool enable_depth_write, bool enable_blending,
     vk::CompareOp depth_compare_op, vk::RenderPass render_pass,
     std::vector<vk::DescriptorSetLayout> descriptor_set_layouts,
-    const ModelPipelineSpec& spec, vk::SampleCountFlagBits sample_count) {
+    const ModelPipelineSpec& spec, vk::SampleCountFlagBits sample_count,
+    vk::PipelineCache pipeline_cache) {
   vk::Device device = model_data->device();
 
   // Depending on configuration, more dynamic states may be added later.
@@ -262,7 +268,7 @@ std::pair<vk::Pipeline, vk::PipelineLayout> NewPipelineHelper(
   pipeline_info.basePipelineHandle = vk::Pipeline();
 
   vk::Pipeline pipeline = ESCHER_CHECKED_VK_RESULT(
-      device.createGraphicsPipeline(nullptr, pipeline_info));
+      device.createGraphicsPipeline(pipeline_cache, pipeline_info));
 
   return {pipeline, pipeline_layout};
 }
@@ -322,11 +328,17 @@ std::unique_ptr<ModelPipeline> ModelPipelineCache::NewPipeline(
         ESCHER_CHECKED_VK_RESULT(device.createShaderModule(module_info));
   }
 
+  PersistentPipelineCache* persistent_cache =
+      escher() ? escher()->persistent_pipeline_cache() : nullptr;
   auto pipeline_and_layout = NewPipelineHelper(
       model_data_.get(), vertex_module, fragment_module, enable_depth_test,
       enable_depth_write, enable_blending, depth_compare_op, render_pass_->vk(),
       {model_data_->per_model_layout(), model_data_->per_object_layout()}, spec,
-      SampleCountFlagBitsFromInt(render_pass_->sample_count()));
+      SampleCountFlagBitsFromInt(render_pass_->sample_count()),
+      persistent_cache ? persistent_cache->vk() : vk::PipelineCache());
+  if (persistent_cache) {
+    persistent_cache->MarkDirty();
+  }
 
   device.destroyShaderModule(vertex_module);
   if (fragment_module) {
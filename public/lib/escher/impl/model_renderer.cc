@@ -52,7 +52,7 @@ ModelDisplayListPtr ModelRenderer::CreateDisplayList(
     const ModelRenderPassPtr& render_pass, ModelDisplayListFlags flags,
     float scale, const TexturePtr& shadow_texture, const mat4& shadow_matrix,
     vec3 ambient_light_color, vec3 direct_light_color,
-    CommandBuffer* command_buffer) {
+    CommandBuffer* command_buffer, FrameArena* frame_arena) {
   TRACE_DURATION("gfx", "escher::ModelRenderer::CreateDisplayList",
                  "object_count", model.objects().size());
 
@@ -119,7 +119,8 @@ ModelDisplayListPtr ModelRenderer::CreateDisplayList(
   ModelDisplayListBuilder builder(device_, stage, model, camera, scale,
                                   white_texture_, shadow_texture, shadow_matrix,
                                   ambient_light_color, direct_light_color,
-                                  model_data_.get(), this, render_pass, flags);
+                                  model_data_.get(), this, render_pass, flags,
+                                  frame_arena);
   for (uint32_t object_index : opaque_objects_) {
     builder.AddObject(objects[object_index]);
   }
@@ -32,12 +32,14 @@ class ModelRenderer final : public fxl::RefCountedThreadSafe<ModelRenderer> {
 
   ResourceRecycler* resource_recycler() const { return resource_recycler_; }
 
+  // Uniforms and descriptor sets are allocated from |frame_arena|, if it is
+  // not null; the display list must then not outlive the frame.
   ModelDisplayListPtr CreateDisplayList(
       const Stage& stage, const Model& model, const Camera& camera,
       const ModelRenderPassPtr& render_pass, ModelDisplayListFlags flags,
       float scale, const TexturePtr& shadow_texture, const mat4& shadow_matrix,
       vec3 ambient_light_color, vec3 direct_light_color,
-      CommandBuffer* command_buffer);
+      CommandBuffer* command_buffer, FrameArena* frame_arena);
 
   const MeshPtr& GetMeshForShape(const Shape& shape) const;
 
@@ -0,0 +1,164 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "lib/escher/impl/spirv_cache.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include "lib/escher/util/hasher.h"
+#include "lib/fxl/files/directory.h"
+#include "lib/fxl/files/file.h"
+#include "lib/fxl/logging.h"
+
+namespace escher {
+namespace impl {
+
+namespace {
+
+constexpr uint32_t kEntryMagic = 0x56505345;  // "ESPV"
+
+// Bump this whenever the compilers or their options change in a way that
+// affects the generated code, to invalidate existing entries.
+constexpr uint32_t kEntryVersion = 1;
+
+// Distinguishes the keys of the two kinds of compilation, which use different
+// compilers.
+constexpr uint32_t kGlslKeyTag = 1;
+constexpr uint32_t kShaderVariantKeyTag = 2;
+
+struct EntryHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  uint64_t checksum;
+  uint32_t word_count;
+  uint32_t reserved;
+};
+
+Hash ComputeChecksum(const uint32_t* words, size_t word_count) {
+  Hasher h;
+  h.u32(static_cast<uint32_t>(word_count));
+  h.data(words, word_count);
+  return h.value();
+}
+
+}  // anonymous namespace
+
+SpirvCache::SpirvCache(std::string directory)
+    : directory_(std::move(directory)), hit_count_(0), miss_count_(0) {
+  if (!files::IsDirectory(directory_) &&
+      !files::CreateDirectory(directory_)) {
+    FXL_LOG(WARNING) << "SpirvCache: failed to create directory "
+                     << directory_;
+  }
+}
+
+SpirvCache::~SpirvCache() = default;
+
+Hash SpirvCache::KeyForGlsl(vk::ShaderStageFlagBits stage,
+                            const std::vector<std::string>& source_code,
+                            const std::string& preamble,
+                            const std::string& entry_point) {
+  Hasher h;
+  h.u32(kEntryVersion);
+  h.u32(kGlslKeyTag);
+  h.u32(static_cast<uint32_t>(stage));
+  h.u32(static_cast<uint32_t>(source_code.size()));
+  for (auto& source : source_code) {
+    h.string(source);
+  }
+  h.string(preamble);
+  h.string(entry_point);
+  return h.value();
+}
+
+Hash SpirvCache::KeyForShaderVariant(ShaderStage stage,
+                                     const std::string& preprocessed_source,
+                                     const ShaderVariantArgs& args) {
+  Hasher h;
+  h.u32(kEntryVersion);
+  h.u32(kShaderVariantKeyTag);
+  h.u32(static_cast<uint32_t>(stage));
+  h.string(preprocessed_source);
+  // The definitions have already been applied to |preprocessed_source|, but
+  // hashing them too keeps variants that differ only in unused definitions
+  // apart.
+  h.u32(static_cast<uint32_t>(args.definitions().size()));
+  for (auto& definition : args.definitions()) {
+    h.string(definition.first);
+    h.string(definition.second);
+  }
+  return h.value();
+}
+
+bool SpirvCache::Load(const Hash& key, SpirvData* spirv_out) {
+  FXL_DCHECK(spirv_out);
+
+  std::string contents;
+  if (!files::ReadFileToString(GetEntryPath(key), &contents) ||
+      contents.size() < sizeof(EntryHeader)) {
+    ++miss_count_;
+    return false;
+  }
+
+  EntryHeader header;
+  memcpy(&header, contents.data(), sizeof(header));
+  const size_t code_size = contents.size() - sizeof(header);
+  if (header.magic != kEntryMagic || header.version != kEntryVersion ||
+      header.key != key.val || header.word_count == 0 ||
+      code_size != header.word_count * sizeof(uint32_t)) {
+    FXL_LOG(WARNING) << "SpirvCache: discarding invalid entry "
+                     << GetEntryPath(key);
+    ++miss_count_;
+    return false;
+  }
+
+  SpirvData spirv(header.word_count);
+  memcpy(spirv.data(), contents.data() + sizeof(header), code_size);
+  if (ComputeChecksum(spirv.data(), spirv.size()).val != header.checksum) {
+    FXL_LOG(WARNING) << "SpirvCache: discarding corrupted entry "
+                     << GetEntryPath(key);
+    ++miss_count_;
+    return false;
+  }
+
+  *spirv_out = std::move(spirv);
+  ++hit_count_;
+  return true;
+}
+
+bool SpirvCache::Store(const Hash& key, const SpirvData& spirv) {
+  if (spirv.empty()) {
+    return false;
+  }
+
+  EntryHeader header = {};
+  header.magic = kEntryMagic;
+  header.version = kEntryVersion;
+  header.key = key.val;
+  header.checksum = ComputeChecksum(spirv.data(), spirv.size()).val;
+  header.word_count = static_cast<uint32_t>(spirv.size());
+
+  std::string contents(sizeof(header) + spirv.size() * sizeof(uint32_t), '\0');
+  memcpy(&contents[0], &header, sizeof(header));
+  memcpy(&contents[sizeof(header)], spirv.data(),
+         spirv.size() * sizeof(uint32_t));
+
+  if (!files::WriteFileInTwoPhases(GetEntryPath(key), contents, directory_)) {
+    FXL_LOG(WARNING) << "SpirvCache: failed to write " << GetEntryPath(key);
+    return false;
+  }
+  return true;
+}
+
+std::string SpirvCache::GetEntryPath(const Hash& key) const {
+  char name[32];
+  snprintf(name, sizeof(name), "%016" PRIx64 ".spv", key.val);
+  return directory_ + "/" + name;
+}
+
+}  // namespace impl
+}  // namespace escher
@@ -0,0 +1,75 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LIB_ESCHER_IMPL_SPIRV_CACHE_H_
+#define LIB_ESCHER_IMPL_SPIRV_CACHE_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "lib/escher/util/hash.h"
+#include "lib/escher/vk/shader_stage.h"
+#include "lib/escher/vk/shader_variant_args.h"
+#include "lib/fxl/macros.h"
+
+namespace escher {
+namespace impl {
+
+typedef std::vector<uint32_t> SpirvData;
+
+// Stores compiled SPIR-V in a directory, so that shaders whose source hasn't
+// changed needn't be recompiled when the process restarts.  Each entry is
+// named by a content hash of everything that affects its compilation.  The
+// entry also records that key and a checksum of its code, so a stale,
+// truncated or corrupted file is treated as a miss instead of being handed to
+// Vulkan.
+//
+// SpirvCache is thread-safe, because GlslToSpirvCompiler uses it from its
+// compilation threads.
+class SpirvCache {
+ public:
+  // |directory| is created if it doesn't already exist.
+  explicit SpirvCache(std::string directory);
+  ~SpirvCache();
+
+  // Return the key for the GLSL compiled by GlslToSpirvCompiler::Compile().
+  static Hash KeyForGlsl(vk::ShaderStageFlagBits stage,
+                         const std::vector<std::string>& source_code,
+                         const std::string& preamble,
+                         const std::string& entry_point);
+
+  // Return the key for a ShaderModuleTemplate variant.  |preprocessed_source|
+  // must have all #includes resolved, so that a change to any included file
+  // also changes the key.
+  static Hash KeyForShaderVariant(ShaderStage stage,
+                                  const std::string& preprocessed_source,
+                                  const ShaderVariantArgs& args);
+
+  // Return true and fill in |spirv_out| if a valid entry exists for |key|.
+  bool Load(const Hash& key, SpirvData* spirv_out);
+
+  // Write |spirv| as the entry for |key|, replacing any existing entry.  The
+  // file is written atomically, so concurrent readers never see a partial
+  // entry.
+  bool Store(const Hash& key, const SpirvData& spirv);
+
+  const std::string& directory() const { return directory_; }
+  uint32_t hit_count() const { return hit_count_; }
+  uint32_t miss_count() const { return miss_count_; }
+
+ private:
+  std::string GetEntryPath(const Hash& key) const;
+
+  const std::string directory_;
+  std::atomic<uint32_t> hit_count_;
+  std::atomic<uint32_t> miss_count_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(SpirvCache);
+};
+
+}  // namespace impl
+}  // namespace escher
+
+#endif  // LIB_ESCHER_IMPL_SPIRV_CACHE_H_
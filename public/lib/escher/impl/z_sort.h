@@ -10,6 +10,7 @@
 
 #include "lib/escher/scene/camera.h"
 #include "lib/escher/scene/object.h"
+#include "lib/escher/util/radix_sort.h"
 
 namespace escher {
 namespace impl {
@@ -33,13 +34,34 @@ bool ZCompare(const CameraDesc& camera_desc, const Object& a, const Object& b) {
          EstimateZTranslation(camera_desc, b.transform());
 }
 
+// Returns a radix-sortable key that orders objects back-to-front, i.e. in the
+// same order as ZCompare().
+inline uint64_t ZSortKey(float z_translation) {
+  return ~FloatToSortableBits(z_translation);
+}
+
+// Sorts |indices| so that the objects they refer to are ordered back-to-front.
+// Each object's depth is estimated once, and the resulting keys are radix
+// sorted; objects at the same depth retain their relative order.
 template <class Index, class CameraDesc>
 void ZSort(std::vector<Index>* indices, const std::vector<Object>& objects,
            const CameraDesc& camera_desc) {
-  std::sort(indices->begin(), indices->end(),
-            [&objects, &camera_desc](Index a, Index b) {
-              return ZCompare(camera_desc, objects[a], objects[b]);
-            });
+  std::vector<uint64_t> keys;
+  keys.reserve(indices->size());
+  for (Index index : *indices) {
+    keys.push_back(ZSortKey(
+        EstimateZTranslation(camera_desc, objects[index].transform())));
+  }
+
+  std::vector<uint32_t> order;
+  RadixSorter().Sort(&keys, &order);
+
+  std::vector<Index> sorted_indices;
+  sorted_indices.reserve(indices->size());
+  for (uint32_t i : order) {
+    sorted_indices.push_back((*indices)[i]);
+  }
+  indices->swap(sorted_indices);
 }
 
 }  // namespace impl
@@ -8,7 +8,7 @@
 
 #include "lib/escher/escher.h"
 #include "lib/escher/geometry/bounding_box.h"
-#include "lib/escher/geometry/indexed_triangle_mesh_clip.h"
+#include "lib/escher/geometry/indexed_triangle_mesh_clipper.h"
 #include "lib/escher/geometry/indexed_triangle_mesh_upload.h"
 #include "lib/escher/geometry/tessellation.h"
 #include "lib/escher/renderer/batch_gpu_uploader.h"
@@ -35,7 +35,8 @@ PaperShapeCacheEntry ProcessTriangleMesh2d(
     IndexedTriangleMesh2d<vec2> mesh, const MeshSpec& mesh_spec,
     const plane3* clip_planes3, size_t num_clip_planes,
     const BoundingBox& bounding_box, PaperRendererShadowType shadow_type,
-    Escher* escher, BatchGpuUploader* uploader) {
+    Escher* escher, BatchGpuUploader* uploader,
+    IndexedTriangleMeshClipper<IndexedTriangleMesh2d<vec2>, plane2>* clipper) {
   TRACE_DURATION("gfx", "PaperShapeCache::ProcessTriangleMesh2d");
   FXL_DCHECK((mesh_spec ==
               MeshSpec{{MeshAttribute::kPosition2D, MeshAttribute::kUV}}));
@@ -53,7 +54,7 @@ PaperShapeCacheEntry ProcessTriangleMesh2d(
 
   IndexedTriangleMesh2d<vec2> tri_mesh;
   std::tie(tri_mesh, std::ignore) =
-      IndexedTriangleMeshClip(std::move(mesh), clip_planes, num_clip_planes);
+      clipper->Clip(std::move(mesh), clip_planes, num_clip_planes);
 
   switch (shadow_type) {
     case PaperRendererShadowType::kShadowVolume: {
@@ -176,9 +177,16 @@ PaperShapeCacheEntry ProcessTriangleMesh2d(
 
 }  // namespace
 
+// Kept between cache misses so that clipping reuses its scratch memory.
+class PaperShapeCache::MeshClipper final
+    : public IndexedTriangleMeshClipper<IndexedTriangleMesh2d<vec2>, plane2> {
+};
+
 PaperShapeCache::PaperShapeCache(EscherWeakPtr escher,
                                  const PaperRendererConfig& config)
-    : escher_(std::move(escher)), shadow_type_(config.shadow_type) {}
+    : escher_(std::move(escher)),
+      mesh_clipper_(std::make_unique<MeshClipper>()),
+      shadow_type_(config.shadow_type) {}
 
 PaperShapeCache::~PaperShapeCache() { FXL_DCHECK(!uploader_); }
 
@@ -261,7 +269,8 @@ const PaperShapeCacheEntry& PaperShapeCache::GetRoundedRectMesh(
         return ProcessTriangleMesh2d(std::move(mesh), mesh_spec,
                                      unculled_clip_planes,
                                      num_unculled_clip_planes, bounding_box,
-                                     shadow_type_, escher_.get(), uploader_);
+                                     shadow_type_, escher_.get(), uploader_,
+                                     mesh_clipper_.get());
       });
 }
 
@@ -296,7 +305,8 @@ const PaperShapeCacheEntry& PaperShapeCache::GetCircleMesh(
         return ProcessTriangleMesh2d(std::move(mesh), mesh_spec,
                                      unculled_clip_planes,
                                      num_unculled_clip_planes, bounding_box,
-                                     shadow_type_, escher_.get(), uploader_);
+                                     shadow_type_, escher_.get(), uploader_,
+                                     mesh_clipper_.get());
       });
 }
 
@@ -339,7 +349,8 @@ const PaperShapeCacheEntry& PaperShapeCache::GetRectMesh(
         return ProcessTriangleMesh2d(std::move(mesh), mesh_spec,
                                      unculled_clip_planes,
                                      num_unculled_clip_planes, bounding_box,
-                                     shadow_type_, escher_.get(), uploader_);
+                                     shadow_type_, escher_.get(), uploader_,
+                                     mesh_clipper_.get());
       });
 }
 
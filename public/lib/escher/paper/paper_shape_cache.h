@@ -6,6 +6,7 @@
 #define LIB_ESCHER_PAPER_PAPER_SHAPE_CACHE_H_
 
 #include <functional>
+#include <memory>
 #include <vector>
 
 #include "lib/escher/forward_declarations.h"
@@ -75,6 +76,8 @@ class PaperShapeCache {
  private:
   enum class ShapeType { kRect, kRoundedRect, kCircle };
 
+  class MeshClipper;
+
   // Args: array of planes to clip the generated mesh, and size of the array.
   using CacheMissMeshGenerator = std::function<PaperShapeCacheEntry(
       const plane3* planes, size_t num_planes)>;
@@ -126,6 +129,7 @@ class PaperShapeCache {
   void AddEntry(const Hash& hash, PaperShapeCacheEntry entry);
 
   const EscherWeakPtr escher_;
+  const std::unique_ptr<MeshClipper> mesh_clipper_;
   HashMap<Hash, PaperShapeCacheEntry> cache_;
   BatchGpuUploader* uploader_ = nullptr;
   uint64_t frame_number_ = 0;
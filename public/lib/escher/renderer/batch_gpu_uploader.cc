@@ -12,21 +12,27 @@ namespace escher {
 
 /* static */
 BatchGpuUploaderPtr BatchGpuUploader::New(EscherWeakPtr weak_escher,
-                                          int64_t frame_trace_number) {
+                                          int64_t frame_trace_number,
+                                          StagingRing* staging_ring) {
   if (!weak_escher) {
     // Allow creation without an escher for tests. This class is not functional
     // without a valid escher.
     FXL_LOG(WARNING) << "Error, creating a BatchGpuUploader without an escher.";
     return fxl::AdoptRef(new BatchGpuUploader());
   }
-  return fxl::AdoptRef(
-      new BatchGpuUploader(std::move(weak_escher), frame_trace_number));
+  return fxl::AdoptRef(new BatchGpuUploader(
+      std::move(weak_escher), frame_trace_number, staging_ring));
 }
 
 BatchGpuUploader::Writer::Writer(CommandBufferPtr command_buffer,
-                                 BufferPtr buffer)
-    : command_buffer_(std::move(command_buffer)), buffer_(std::move(buffer)) {
+                                 BufferPtr buffer, vk::DeviceSize offset,
+                                 vk::DeviceSize size)
+    : command_buffer_(std::move(command_buffer)),
+      buffer_(std::move(buffer)),
+      offset_(offset),
+      size_(size) {
   FXL_DCHECK(command_buffer_ && buffer_);
+  FXL_DCHECK(offset_ + size_ <= buffer_->size());
 }
 
 BatchGpuUploader::Writer::~Writer() {
@@ -44,7 +50,9 @@ void BatchGpuUploader::Writer::WriteBuffer(const BufferPtr& target,
     command_buffer_->impl()->AddSignalSemaphore(std::move(semaphore));
   }
   command_buffer_->impl()->KeepAlive(target);
+  region.srcOffset += offset_;
   command_buffer_->vk().copyBuffer(buffer_->vk(), target->vk(), 1, &region);
+  ++copy_count_;
 }
 
 void BatchGpuUploader::Writer::WriteImage(const ImagePtr& target,
@@ -54,9 +62,11 @@ void BatchGpuUploader::Writer::WriteImage(const ImagePtr& target,
   command_buffer_->impl()->TransitionImageLayout(
       target, vk::ImageLayout::eUndefined,
       vk::ImageLayout::eTransferDstOptimal);
+  region.bufferOffset += offset_;
   command_buffer_->vk().copyBufferToImage(buffer_->vk(), target->vk(),
                                           vk::ImageLayout::eTransferDstOptimal,
                                           1, &region);
+  ++copy_count_;
   command_buffer_->impl()->TransitionImageLayout(
       target, vk::ImageLayout::eTransferDstOptimal,
       vk::ImageLayout::eShaderReadOnlyOptimal);
@@ -103,6 +113,7 @@ void BatchGpuUploader::Reader::ReadBuffer(const BufferPtr& source,
   }
   command_buffer_->vk().copyBuffer(source->vk(), buffer_->vk(), 1, &region);
   command_buffer_->impl()->KeepAlive(source);
+  ++copy_count_;
 }
 
 void BatchGpuUploader::Reader::ReadImage(const ImagePtr& source,
@@ -115,6 +126,7 @@ void BatchGpuUploader::Reader::ReadImage(const ImagePtr& source,
   command_buffer_->vk().copyImageToBuffer(source->vk(),
                                           vk::ImageLayout::eTransferSrcOptimal,
                                           buffer_->vk(), 1, &region);
+  ++copy_count_;
   command_buffer_->impl()->TransitionImageLayout(
       source, vk::ImageLayout::eUndefined,
       vk::ImageLayout::eShaderReadOnlyOptimal);
@@ -140,9 +152,13 @@ CommandBufferPtr BatchGpuUploader::Reader::TakeCommandsAndShutdown() {
 }
 
 BatchGpuUploader::BatchGpuUploader(EscherWeakPtr weak_escher,
-                                   int64_t frame_trace_number)
+                                   int64_t frame_trace_number,
+                                   StagingRing* staging_ring)
     : escher_(std::move(weak_escher)), frame_trace_number_(frame_trace_number) {
   FXL_DCHECK(escher_);
+  if (staging_ring) {
+    staging_ring_ = staging_ring->GetWeakPtr();
+  }
 }
 
 BatchGpuUploader::~BatchGpuUploader() { FXL_CHECK(!frame_); }
@@ -161,6 +177,9 @@ void BatchGpuUploader::Initialize() {
     buffer_cache_ = escher_->buffer_cache()->GetWeakPtr();
   }
   FXL_DCHECK(buffer_cache_);
+  if (staging_ring_) {
+    staging_ring_frame_index_ = staging_ring_->BeginFrame();
+  }
 
   is_initialized_ = true;
 }
@@ -180,15 +199,28 @@ std::unique_ptr<BatchGpuUploader::Writer> BatchGpuUploader::AcquireWriter(
   TRACE_DURATION("gfx", "escher::BatchGpuUploader::AcquireWriter");
 
   vk::DeviceSize vk_size = size;
-  BufferPtr buffer = buffer_cache_->NewHostBuffer(vk_size);
-  FXL_DCHECK(buffer) << "Error allocating buffer";
+  StagingRing::Range range;
+  if (staging_ring_) {
+    range = staging_ring_->Allocate(vk_size, staging_ring_frame_index_);
+  }
+  if (range.buffer) {
+    uses_staging_ring_ = true;
+    stats_.staging_ring_bytes += vk_size;
+  } else {
+    // Too large for the ring, or there is no ring.
+    range.buffer = buffer_cache_->NewHostBuffer(vk_size);
+    range.offset = 0;
+    FXL_DCHECK(range.buffer) << "Error allocating buffer";
+  }
+  stats_.staging_bytes += vk_size;
 
   CommandBufferPtr command_buffer = frame_->TakeCommandBuffer();
   FXL_DCHECK(command_buffer) << "Error getting the frame's command buffer.";
 
   ++writer_count_;
-  return std::make_unique<BatchGpuUploader::Writer>(std::move(command_buffer),
-                                                    std::move(buffer));
+  return std::make_unique<BatchGpuUploader::Writer>(
+      std::move(command_buffer), std::move(range.buffer), range.offset,
+      vk_size);
 }
 
 std::unique_ptr<BatchGpuUploader::Reader> BatchGpuUploader::AcquireReader(
@@ -228,6 +260,7 @@ void BatchGpuUploader::PostWriter(
   // Writer.
   FXL_DCHECK(writer_count_ == 1);
 
+  stats_.copy_count += writer->copy_count_;
   auto command_buffer = writer->TakeCommandsAndShutdown();
   frame_->PutCommandBuffer(std::move(command_buffer));
   --writer_count_;
@@ -249,6 +282,7 @@ void BatchGpuUploader::PostReader(
   // Reader.
   FXL_DCHECK(reader_count_ == 1);
 
+  stats_.copy_count += reader->copy_count_;
   auto command_buffer = reader->TakeCommandsAndShutdown();
   frame_->PutCommandBuffer(std::move(command_buffer));
   --reader_count_;
@@ -273,9 +307,20 @@ void BatchGpuUploader::Submit(const escher::SemaphorePtr& upload_done_semaphore,
   }
   FXL_DCHECK(frame_);
 
-  TRACE_DURATION("gfx", "BatchGpuUploader::SubmitBatch");
+  TRACE_DURATION("gfx", "BatchGpuUploader::SubmitBatch", "staging_bytes",
+                 stats_.staging_bytes, "copy_count", stats_.copy_count);
+  fxl::WeakPtr<StagingRing> staging_ring;
+  if (uses_staging_ring_) {
+    staging_ring = staging_ring_;
+  }
   frame_->EndFrame(upload_done_semaphore,
-                   [callback, read_callbacks = std::move(read_callbacks_)]() {
+                   [callback, read_callbacks = std::move(read_callbacks_),
+                    staging_ring = std::move(staging_ring),
+                    frame_index = staging_ring_frame_index_]() {
+                     // The GPU is done with this frame's staging memory.
+                     if (staging_ring) {
+                       staging_ring->ReleaseFrame(frame_index);
+                     }
                      for (auto& pair : read_callbacks) {
                        auto buffer = pair.first;
                        auto read_callback = pair.second;
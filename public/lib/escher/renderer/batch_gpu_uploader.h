@@ -12,6 +12,7 @@
 #include "lib/escher/forward_declarations.h"
 #include "lib/escher/renderer/buffer_cache.h"
 #include "lib/escher/renderer/frame.h"
+#include "lib/escher/renderer/staging_ring.h"
 #include "lib/escher/vk/buffer.h"
 #include "lib/escher/vk/command_buffer.h"
 
@@ -22,12 +23,25 @@ using BatchGpuUploaderPtr = fxl::RefPtr<BatchGpuUploader>;
 
 // Provides host-accessible GPU memory for clients to upload Images and Buffers
 // to the GPU. Offers the ability to batch uploads into consolidated submissions
-// to the GPU driver.
+// to the GPU driver.  All copies are recorded into the command buffer of a
+// single frame.  If a StagingRing is provided, Writers share its persistent
+// buffer instead of each obtaining a buffer from the BufferCache.
 // TODO(SCN-844) Migrate users of impl::GpuUploader to this class.
 class BatchGpuUploader : public Reffable {
  public:
+  // Counts of the work batched by an uploader, for tests and tracing.
+  struct Stats {
+    // Bytes of host memory written by Writers.
+    vk::DeviceSize staging_bytes = 0;
+    // Bytes of |staging_bytes| that were provided by the StagingRing.
+    vk::DeviceSize staging_ring_bytes = 0;
+    // Copy commands recorded by Writers and Readers.
+    uint32_t copy_count = 0;
+  };
+
   static BatchGpuUploaderPtr New(EscherWeakPtr weak_escher,
-                                 int64_t frame_trace_number = 0);
+                                 int64_t frame_trace_number = 0,
+                                 StagingRing* staging_ring = nullptr);
 
   ~BatchGpuUploader();
 
@@ -35,23 +49,27 @@ class BatchGpuUploader : public Reffable {
   // memory into optimally-formatted Images and Buffers.
   class Writer {
    public:
-    Writer(CommandBufferPtr command_buffer, BufferPtr buffer);
+    // Writes go to |size| bytes of |buffer|, starting at |offset|.
+    Writer(CommandBufferPtr command_buffer, BufferPtr buffer,
+           vk::DeviceSize offset, vk::DeviceSize size);
     ~Writer();
 
     // Schedule a buffer-to-buffer copy that will be submitted when Submit()
     // is called.  Retains a reference to the target until the submission's
-    // CommandBuffer is retired.
+    // CommandBuffer is retired.  The source offset of |region| is relative to
+    // host_ptr().
     void WriteBuffer(const BufferPtr& target, vk::BufferCopy region,
                      SemaphorePtr semaphore);
 
     // Schedule a buffer-to-image copy that will be submitted when Submit()
     // is called.  Retains a reference to the target until the submission's
-    // CommandBuffer is retired.
+    // CommandBuffer is retired.  The buffer offset of |region| is relative to
+    // host_ptr().
     void WriteImage(const ImagePtr& target, vk::BufferImageCopy region,
                     SemaphorePtr semaphore);
 
-    uint8_t* host_ptr() const { return buffer_->host_ptr(); }
-    vk::DeviceSize size() const { return buffer_->size(); }
+    uint8_t* host_ptr() const { return buffer_->host_ptr() + offset_; }
+    vk::DeviceSize size() const { return size_; }
 
    private:
     friend class BatchGpuUploader;
@@ -61,6 +79,9 @@ class BatchGpuUploader : public Reffable {
 
     CommandBufferPtr command_buffer_;
     BufferPtr buffer_;
+    const vk::DeviceSize offset_;
+    const vk::DeviceSize size_;
+    uint32_t copy_count_ = 0;
 
     FXL_DISALLOW_COPY_AND_ASSIGN(Writer);
   };
@@ -94,6 +115,7 @@ class BatchGpuUploader : public Reffable {
 
     CommandBufferPtr command_buffer_;
     BufferPtr buffer_;
+    uint32_t copy_count_ = 0;
 
     FXL_DISALLOW_COPY_AND_ASSIGN(Reader);
   };
@@ -123,8 +145,12 @@ class BatchGpuUploader : public Reffable {
   void Submit(const escher::SemaphorePtr& upload_done_semaphore,
               const std::function<void()>& callback = [] {});
 
+  // Work posted so far.
+  const Stats& stats() const { return stats_; }
+
  private:
-  BatchGpuUploader(EscherWeakPtr weak_escher, int64_t frame_trace_number);
+  BatchGpuUploader(EscherWeakPtr weak_escher, int64_t frame_trace_number,
+                   StagingRing* staging_ring);
   BatchGpuUploader() : frame_trace_number_(0) { dummy_for_tests_ = true; }
 
   void Initialize();
@@ -139,6 +165,12 @@ class BatchGpuUploader : public Reffable {
   // Lazily created when the first Reader or Writer is acquired.
   BufferCacheWeakPtr buffer_cache_;
   FramePtr frame_;
+  // Optional source of staging memory for Writers.  Ranges are tagged with
+  // |staging_ring_frame_index_|, and released when the frame is retired.
+  fxl::WeakPtr<StagingRing> staging_ring_;
+  uint64_t staging_ring_frame_index_ = 0;
+  bool uses_staging_ring_ = false;
+  Stats stats_;
 
   // Temporary flag for tests that need to build and run with a null escher.
   // Allows the uploader to be created and skips submit without crashing, but
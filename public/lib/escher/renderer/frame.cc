@@ -12,6 +12,7 @@
 #include "lib/escher/impl/frame_manager.h"
 #include "lib/escher/util/trace_macros.h"
 #include "lib/escher/vk/command_buffer.h"
+#include "lib/fxl/compiler_specific.h"
 #include "lib/fxl/macros.h"
 
 namespace escher {
@@ -31,8 +32,7 @@ const ResourceTypeInfo Frame::kTypeInfo("Frame", ResourceType::kResource,
 
 Frame::Frame(impl::FrameManager* manager,
              escher::CommandBuffer::Type requested_type,
-             BlockAllocator allocator,
-             impl::UniformBufferPoolWeakPtr uniform_buffer_pool,
+             BlockAllocator allocator, std::unique_ptr<FrameArena> arena,
              uint64_t frame_number, const char* trace_literal,
              bool enable_gpu_logging)
     : Resource(manager),
@@ -43,12 +43,13 @@ Frame::Frame(impl::FrameManager* manager,
       queue_(escher()->device()->vk_main_queue()),
       command_buffer_type_(requested_type),
       block_allocator_(std::move(allocator)),
-      uniform_block_allocator_(std::move(uniform_buffer_pool)),
+      arena_(std::move(arena)),
       profiler_(escher()->supports_timer_queries()
                     ? fxl::MakeRefCounted<TimestampProfiler>(
                           escher()->vk_device(), escher()->timestamp_period())
                     : TimestampProfilerPtr()) {
   FXL_DCHECK(queue_);
+  FXL_DCHECK(arena_);
 }
 
 Frame::~Frame() {
@@ -114,9 +115,15 @@ void Frame::EndFrame(const SemaphorePtr& frame_done,
   FXL_DCHECK(command_buffer_);
 
   ++submission_count_;
+  const FrameArena::Stats arena_stats = arena_->stats();
+  FXL_ALLOW_UNUSED_LOCAL(arena_stats);
   TRACE_DURATION("gfx", "escher::Frame::EndFrame", "frame_number",
                  frame_number_, "escher_frame_number", escher_frame_number_,
-                 "submission_index", submission_count_);
+                 "submission_index", submission_count_, "uniform_allocations",
+                 arena_stats.uniform_allocation_count, "uniform_bytes",
+                 arena_stats.uniform_bytes, "descriptor_sets",
+                 arena_stats.descriptor_set_count, "new_uniform_blocks",
+                 arena_stats.new_block_count);
   FXL_DCHECK(state_ == State::kInProgress);
   state_ = State::kFinishing;
 
@@ -162,6 +169,9 @@ void Frame::EndFrame(const SemaphorePtr& frame_done,
         // therefore keeps alive everything in |keep_alive_|.
         this_frame->keep_alive_.clear();
 
+        // The GPU is done with the frame's uniforms and descriptor sets.
+        this_frame->arena_->Reset();
+
         // The frame is now ready for reuse or destruction.
         this_frame->state_ = State::kReadyToBegin;
       });
@@ -169,14 +179,6 @@ void Frame::EndFrame(const SemaphorePtr& frame_done,
   command_buffer_ = nullptr;
   command_buffer_sequence_number_ = 0;
 
-  // Keep per-frame uniform buffers alive until frame is finished rendering.
-  for (auto& buf : uniform_block_allocator_.TakeBuffers()) {
-    // TODO(ES-103): reconsider this keep-alive scheme.
-    // TODO(ES-106): test that blocks make it back to the pool but only after
-    // the frame is finished rendering.
-    KeepAlive(std::move(buf));
-  }
-
   // Immediately release per-frame CPU memory; it is no longer needed now that
   // all work has been submitted to the GPU.
   block_allocator_.Reset();
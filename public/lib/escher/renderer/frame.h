@@ -7,13 +7,14 @@
 
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <vulkan/vulkan.hpp>
 
 #include "lib/escher/base/reffable.h"
 #include "lib/escher/forward_declarations.h"
 #include "lib/escher/impl/command_buffer.h"
 #include "lib/escher/profiling/timestamp_profiler.h"
-#include "lib/escher/renderer/uniform_block_allocator.h"
+#include "lib/escher/renderer/frame_arena.h"
 #include "lib/escher/util/block_allocator.h"
 #include "lib/escher/vk/command_buffer.h"
 
@@ -73,9 +74,13 @@ class Frame : public Resource {
   // Allocate temporary GPU uniform buffer memory that is value until the frame
   // is finished rendering (after EndFrame() is called).
   UniformAllocation AllocateUniform(size_t size, size_t alignment) {
-    return uniform_block_allocator_.Allocate(size, alignment);
+    return arena_->AllocateUniform(size, alignment);
   }
 
+  // Allocates the frame's uniform data and descriptor sets; everything in it
+  // is valid until the frame is finished rendering.
+  FrameArena* arena() const { return arena_.get(); }
+
  private:
   // These resources will be retained until the current frame is finished
   // running on the GPU.
@@ -86,8 +91,7 @@ class Frame : public Resource {
   // unique_ptr) avoids an extra pointer indirection on each allocation.
   friend class impl::FrameManager;
   Frame(impl::FrameManager* manager, CommandBuffer::Type requested_type,
-        BlockAllocator allocator,
-        impl::UniformBufferPoolWeakPtr uniform_buffer_pool,
+        BlockAllocator allocator, std::unique_ptr<FrameArena> arena,
         uint64_t frame_number, const char* trace_literal,
         bool enable_gpu_logging);
   void BeginFrame();
@@ -98,6 +102,7 @@ class Frame : public Resource {
   // Called by impl::FrameManager when the Frame is returned to the pool, so
   // that it can be reused in newly constructed frames.
   BlockAllocator TakeBlockAllocator() { return std::move(block_allocator_); }
+  std::unique_ptr<FrameArena> TakeArena() { return std::move(arena_); }
 
   // Called by BatchGpuUploader to write to the new_command_buffer_ and gather
   // work to post to the GPU.
@@ -144,7 +149,8 @@ class Frame : public Resource {
 
   BlockAllocator block_allocator_;
 
-  UniformBlockAllocator uniform_block_allocator_;
+  // Reset once the frame is finished rendering.
+  std::unique_ptr<FrameArena> arena_;
 
   TimestampProfilerPtr profiler_;
   uint32_t submission_count_ = 0;
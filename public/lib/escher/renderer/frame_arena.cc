@@ -0,0 +1,179 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "lib/escher/renderer/frame_arena.h"
+
+#include "lib/escher/escher.h"
+#include "lib/escher/impl/vulkan_utils.h"
+#include "lib/escher/resources/resource_recycler.h"
+#include "lib/escher/util/align.h"
+#include "lib/escher/util/trace_macros.h"
+#include "lib/escher/vk/buffer.h"
+
+namespace escher {
+
+namespace {
+
+constexpr vk::DescriptorType kDescriptorTypes[] = {
+    vk::DescriptorType::eUniformBuffer,
+    vk::DescriptorType::eUniformBufferDynamic,
+    vk::DescriptorType::eCombinedImageSampler,
+    vk::DescriptorType::eUniformTexelBuffer,
+    vk::DescriptorType::eStorageImage,
+    vk::DescriptorType::eStorageBuffer,
+    vk::DescriptorType::eInputAttachment,
+};
+static_assert(FrameArena::kDescriptorTypeCount ==
+                  sizeof(kDescriptorTypes) / sizeof(kDescriptorTypes[0]),
+              "kDescriptorTypeCount must match kDescriptorTypes");
+
+// Returns the index of |type| in |kDescriptorTypes|, or kDescriptorTypeCount
+// if it isn't there.
+size_t DescriptorTypeIndex(vk::DescriptorType type) {
+  for (size_t i = 0; i < FrameArena::kDescriptorTypeCount; ++i) {
+    if (kDescriptorTypes[i] == type) {
+      return i;
+    }
+  }
+  return FrameArena::kDescriptorTypeCount;
+}
+
+}  // namespace
+
+constexpr vk::DeviceSize FrameArena::kBlockSize;
+constexpr uint32_t FrameArena::kDescriptorSetsPerPool;
+constexpr uint32_t FrameArena::kDescriptorsPerType;
+constexpr size_t FrameArena::kDescriptorTypeCount;
+
+FrameArena::FrameArena(EscherWeakPtr escher)
+    : escher_(std::move(escher)), device_(escher_->vk_device()) {}
+
+FrameArena::~FrameArena() {
+  for (auto pool : descriptor_pools_) {
+    device_.destroyDescriptorPool(pool);
+  }
+}
+
+BufferPtr FrameArena::NewBlock() {
+  TRACE_DURATION("gfx", "escher::FrameArena::NewBlock");
+  FXL_DCHECK(escher_);
+  return Buffer::New(escher_->resource_recycler(), escher_->gpu_allocator(),
+                     kBlockSize, vk::BufferUsageFlagBits::eUniformBuffer,
+                     vk::MemoryPropertyFlagBits::eHostVisible |
+                         vk::MemoryPropertyFlagBits::eHostCoherent);
+}
+
+vk::DescriptorPool FrameArena::NewDescriptorPool() {
+  TRACE_DURATION("gfx", "escher::FrameArena::NewDescriptorPool");
+  std::vector<vk::DescriptorPoolSize> pool_sizes;
+  for (auto type : kDescriptorTypes) {
+    pool_sizes.push_back({type, kDescriptorsPerType});
+  }
+
+  vk::DescriptorPoolCreateInfo info;
+  info.maxSets = kDescriptorSetsPerPool;
+  info.poolSizeCount = pool_sizes.size();
+  info.pPoolSizes = pool_sizes.data();
+  return ESCHER_CHECKED_VK_RESULT(device_.createDescriptorPool(info));
+}
+
+UniformAllocation FrameArena::AllocateUniform(size_t size, size_t alignment) {
+  FXL_DCHECK(size <= kBlockSize);
+  write_offset_ = AlignedToNext(write_offset_, alignment);
+  if (!current_block_ || write_offset_ + size > kBlockSize) {
+    // Move on to the next block, creating it if no frame has needed this many
+    // blocks so far.
+    if (block_index_ == blocks_.size()) {
+      blocks_.push_back(NewBlock());
+      FXL_DCHECK(blocks_.back()->host_ptr());
+      ++stats_.new_block_count;
+    }
+    current_block_ = blocks_[block_index_++].get();
+    write_offset_ = 0;
+  }
+
+  UniformAllocation allocation = {
+      .buffer = current_block_,
+      .offset = write_offset_,
+      .size = size,
+      .host_ptr = current_block_->host_ptr() + write_offset_};
+  write_offset_ += size;
+  ++stats_.uniform_allocation_count;
+  stats_.uniform_bytes += size;
+  return allocation;
+}
+
+vk::DescriptorSet FrameArena::AllocateDescriptorSet(
+    vk::DescriptorSetLayout layout,
+    const vk::DescriptorSetLayoutCreateInfo& layout_info) {
+  // Count the descriptors of each type in the layout, as DescriptorSetPool
+  // does.
+  std::array<uint32_t, kDescriptorTypeCount> descriptor_counts = {};
+  for (uint32_t i = 0; i < layout_info.bindingCount; ++i) {
+    const auto& binding = layout_info.pBindings[i];
+    size_t index = DescriptorTypeIndex(binding.descriptorType);
+    if (index == kDescriptorTypeCount ||
+        binding.descriptorCount >
+            kDescriptorsPerType - descriptor_counts[index]) {
+      FXL_LOG(WARNING) << "FrameArena can't allocate "
+                       << binding.descriptorCount << " descriptors of type "
+                       << vk::to_string(binding.descriptorType);
+      return vk::DescriptorSet();
+    }
+    descriptor_counts[index] += binding.descriptorCount;
+  }
+
+  // Move on to the next pool if the set doesn't fit in the current one.
+  if (pool_index_ < descriptor_pools_.size()) {
+    bool fits = pool_set_count_ < kDescriptorSetsPerPool;
+    for (size_t i = 0; fits && i < kDescriptorTypeCount; ++i) {
+      fits = pool_descriptor_counts_[i] + descriptor_counts[i] <=
+             kDescriptorsPerType;
+    }
+    if (!fits) {
+      ++pool_index_;
+      pool_set_count_ = 0;
+      pool_descriptor_counts_.fill(0);
+    }
+  }
+  if (pool_index_ == descriptor_pools_.size()) {
+    descriptor_pools_.push_back(NewDescriptorPool());
+    ++stats_.new_descriptor_pool_count;
+  }
+
+  vk::DescriptorSetAllocateInfo info;
+  info.descriptorPool = descriptor_pools_[pool_index_];
+  info.descriptorSetCount = 1;
+  info.pSetLayouts = &layout;
+  vk::DescriptorSet descriptor_set;
+  vk::Result result = device_.allocateDescriptorSets(&info, &descriptor_set);
+  if (result != vk::Result::eSuccess) {
+    FXL_LOG(WARNING) << "FrameArena failed to allocate descriptor set: "
+                     << vk::to_string(result);
+    return vk::DescriptorSet();
+  }
+
+  ++pool_set_count_;
+  for (size_t i = 0; i < kDescriptorTypeCount; ++i) {
+    pool_descriptor_counts_[i] += descriptor_counts[i];
+  }
+  ++stats_.descriptor_set_count;
+  return descriptor_set;
+}
+
+void FrameArena::Reset() {
+  TRACE_DURATION("gfx", "escher::FrameArena::Reset");
+  for (size_t i = 0; i < descriptor_pools_.size() && i <= pool_index_; ++i) {
+    device_.resetDescriptorPool(descriptor_pools_[i]);
+  }
+  block_index_ = 0;
+  current_block_ = nullptr;
+  write_offset_ = 0;
+  pool_index_ = 0;
+  pool_set_count_ = 0;
+  pool_descriptor_counts_.fill(0);
+  stats_ = Stats();
+}
+
+}  // namespace escher
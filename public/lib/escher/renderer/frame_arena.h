@@ -0,0 +1,95 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LIB_ESCHER_RENDERER_FRAME_ARENA_H_
+#define LIB_ESCHER_RENDERER_FRAME_ARENA_H_
+
+#include <array>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "lib/escher/forward_declarations.h"
+#include "lib/escher/renderer/uniform_allocation.h"
+#include "lib/escher/vk/buffer.h"
+#include "lib/fxl/logging.h"
+#include "lib/fxl/macros.h"
+
+namespace escher {
+
+// Linear allocator for the uniform data and descriptor sets of a single frame.
+// Allocations bump an offset into host-visible uniform buffers, and descriptor
+// sets are allocated from descriptor pools that are never freed individually.
+// Everything is released at once by Reset(), once the frame has finished
+// rendering.  The buffers and pools are kept for the next frame, so after the
+// first few frames nothing is created at all.
+//
+// Not thread-safe; the frame's commands are recorded on a single thread.
+class FrameArena {
+ public:
+  // The size of each uniform buffer; no allocation can be larger.  Typical
+  // max-size of a Vulkan uniform buffer range.
+  static constexpr vk::DeviceSize kBlockSize = 65536;
+
+  // Each descriptor pool has room for this many sets, and this many descriptors
+  // of each type that Escher uses.
+  static constexpr uint32_t kDescriptorSetsPerPool = 256;
+  static constexpr uint32_t kDescriptorsPerType = 256;
+  static constexpr size_t kDescriptorTypeCount = 7;
+
+  struct Stats {
+    uint32_t uniform_allocation_count = 0;
+    vk::DeviceSize uniform_bytes = 0;
+    uint32_t descriptor_set_count = 0;
+    // Buffers and pools that had to be created for this frame.
+    uint32_t new_block_count = 0;
+    uint32_t new_descriptor_pool_count = 0;
+  };
+
+  explicit FrameArena(EscherWeakPtr escher);
+  ~FrameArena();
+
+  UniformAllocation AllocateUniform(size_t size, size_t alignment);
+
+  // Returns a descriptor set with |layout|, which was created from
+  // |layout_info|, or a null set if the device is out of memory or the layout
+  // needs more descriptors of a type than a pool has.
+  vk::DescriptorSet AllocateDescriptorSet(
+      vk::DescriptorSetLayout layout,
+      const vk::DescriptorSetLayoutCreateInfo& layout_info);
+
+  // Invalidates all allocations.  Call once the GPU has finished with them.
+  void Reset();
+
+  // Totals since the last Reset().
+  const Stats& stats() const { return stats_; }
+
+ private:
+  BufferPtr NewBlock();
+  vk::DescriptorPool NewDescriptorPool();
+
+  const EscherWeakPtr escher_;
+  const vk::Device device_;
+
+  // |blocks_| before |block_index_| have been used since the last Reset().
+  std::vector<BufferPtr> blocks_;
+  size_t block_index_ = 0;
+  Buffer* current_block_ = nullptr;
+  vk::DeviceSize write_offset_ = 0;
+  // |descriptor_pools_| before |pool_index_| are full.
+  std::vector<vk::DescriptorPool> descriptor_pools_;
+  size_t pool_index_ = 0;
+  // Sets and descriptors of each type allocated from the current pool, so that
+  // the next pool is used before the current one runs out, rather than relying
+  // on the driver to report eErrorOutOfPoolMemory.
+  uint32_t pool_set_count_ = 0;
+  std::array<uint32_t, kDescriptorTypeCount> pool_descriptor_counts_ = {};
+  Stats stats_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(FrameArena);
+};
+
+}  // namespace escher
+
+#endif  // LIB_ESCHER_RENDERER_FRAME_ARENA_H_
@@ -71,8 +71,7 @@ ShadowMapPtr MomentShadowMapRenderer::GenerateDirectionalShadowMap(
   auto height = static_cast<uint32_t>(shadow_stage.height());
   auto color_image = GetTransitionedColorImage(command_buffer, width, height);
   auto depth_image = GetTransitionedDepthImage(command_buffer, width, height);
-  DrawShadowPass(command_buffer, shadow_stage, model, camera, color_image,
-                 depth_image);
+  DrawShadowPass(frame, shadow_stage, model, camera, color_image, depth_image);
   frame->AddTimestamp("generated moment shadow map");
 
   command_buffer->TransitionImageLayout(
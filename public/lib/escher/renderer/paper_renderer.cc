@@ -106,7 +106,8 @@ void PaperRenderer::DrawDepthPrePass(const FramePtr& frame,
 
   ModelDisplayListPtr display_list = model_renderer_->CreateDisplayList(
       stage, model, camera, depth_pass_, display_list_flags, scale,
-      TexturePtr(), mat4(1.f), vec3(1.f), vec3(1.f), command_buffer);
+      TexturePtr(), mat4(1.f), vec3(1.f), vec3(1.f), command_buffer,
+      frame->arena());
 
   command_buffer->KeepAlive(framebuffer);
   command_buffer->KeepAlive(display_list);
@@ -271,7 +272,7 @@ void PaperRenderer::DrawLightingPass(
   ModelDisplayListPtr display_list = model_renderer_->CreateDisplayList(
       stage, model, camera, render_pass, display_list_flags, 1.f,
       shadow_texture, shadow_matrix, ambient_light_color, direct_light_color,
-      command_buffer);
+      command_buffer, frame->arena());
   command_buffer->KeepAlive(display_list);
 
   // Update the clear color from the stage
@@ -290,7 +291,7 @@ void PaperRenderer::DrawLightingPass(
     overlay_display_list = model_renderer_->CreateDisplayList(
         overlay_stage, *overlay_model, overlay_camera, no_shadow_lighting_pass_,
         display_list_flags, 1.f, TexturePtr(), mat4(1.f), ambient_light_color,
-        direct_light_color, command_buffer);
+        direct_light_color, command_buffer, frame->arena());
     command_buffer->KeepAlive(overlay_display_list);
   }
 
@@ -4,18 +4,48 @@
 
 #include "lib/escher/renderer/render_queue.h"
 
+#include <algorithm>
+
 #include "lib/escher/renderer/render_queue_context.h"
+#include "lib/escher/util/trace_macros.h"
 
 namespace escher {
 
+namespace {
+
+// Below this size, the fixed cost of building radix histograms outweighs the
+// cost of comparison sorting.
+constexpr size_t kMinRadixSortSize = 64;
+
+}  // anonymous namespace
+
 RenderQueue::RenderQueue() = default;
+RenderQueue::RenderQueue(RenderQueue&& other) = default;
 RenderQueue::~RenderQueue() = default;
 
 void RenderQueue::Sort() {
-  std::stable_sort(items_.begin(), items_.end(),
-                   [](const RenderQueueItem& a, const RenderQueueItem& b) {
-                     return a.sort_key < b.sort_key;
-                   });
+  TRACE_DURATION("gfx", "RenderQueue::Sort", "size", items_.size());
+  FXL_DCHECK(sort_keys_.size() == items_.size());
+
+  if (items_.size() < kMinRadixSortSize) {
+    std::stable_sort(items_.begin(), items_.end(),
+                     [](const RenderQueueItem& a, const RenderQueueItem& b) {
+                       return a.sort_key < b.sort_key;
+                     });
+    for (size_t i = 0; i < items_.size(); ++i) {
+      sort_keys_[i] = items_[i].sort_key;
+    }
+    return;
+  }
+
+  // Sort the keys, then move each item to its sorted position in one pass.
+  sorter_.Sort(&sort_keys_, &sort_order_);
+  sorted_items_.clear();
+  sorted_items_.reserve(items_.size());
+  for (uint32_t index : sort_order_) {
+    sorted_items_.push_back(items_[index]);
+  }
+  items_.swap(sorted_items_);
 }
 
 void RenderQueue::GenerateCommands(CommandBuffer* cmd_buf,
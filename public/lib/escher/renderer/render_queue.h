@@ -6,6 +6,7 @@
 #define LIB_ESCHER_RENDERER_RENDER_QUEUE_H_
 
 #include "lib/escher/renderer/render_queue_item.h"
+#include "lib/escher/util/radix_sort.h"
 #include "lib/escher/vk/command_buffer.h"
 
 namespace escher {
@@ -42,6 +43,9 @@ class RenderQueue final {
   // degree of flexibility in defining sort criteria.  For example, translucent
   // objects must be sorted back-to-front after all opaque objects, whereas
   // opaque objects are more efficiently rendered front-to-back.
+  //
+  // Large queues are radix-sorted, which takes time linear in the number of
+  // items; the result is identical to that of std::stable_sort().
   void Sort();
 
   // Generate Vulkan commands for items in the queue, by iterating over the
@@ -65,11 +69,24 @@ class RenderQueue final {
                         const RenderQueueContext* context, size_t start_index,
                         size_t count) const;
 
-  void clear() { items_.clear(); }
+  void clear() {
+    items_.clear();
+    sort_keys_.clear();
+  }
   size_t size() const { return items_.size(); }
 
  protected:
   std::vector<RenderQueueItem> items_;
+
+ private:
+  // The sort key of each item in |items_|, stored separately so that Sort()
+  // needn't move whole items around on each pass.
+  std::vector<uint64_t> sort_keys_;
+
+  // Scratch memory for Sort(), kept to avoid allocating every frame.
+  RadixSorter sorter_;
+  std::vector<uint32_t> sort_order_;
+  std::vector<RenderQueueItem> sorted_items_;
 };
 
 // Inline function definitions.
@@ -78,10 +95,12 @@ inline void RenderQueue::Push(uint64_t sort_key, const void* object_data,
                               const void* instance_data,
                               const RenderQueueItem::Funcs& funcs) {
   items_.push_back({sort_key, object_data, instance_data, funcs});
+  sort_keys_.push_back(sort_key);
 }
 
 inline void RenderQueue::Push(const RenderQueueItem& item) {
   items_.push_back(item);
+  sort_keys_.push_back(item.sort_key);
 }
 
 }  // namespace escher
@@ -65,8 +65,7 @@ ShadowMapPtr ShadowMapRenderer::GenerateDirectionalShadowMap(
   auto height = static_cast<uint32_t>(shadow_stage.height());
   auto color_image = GetTransitionedColorImage(command_buffer, width, height);
   auto depth_image = GetTransitionedDepthImage(command_buffer, width, height);
-  DrawShadowPass(command_buffer, shadow_stage, model, camera, color_image,
-                 depth_image);
+  DrawShadowPass(frame, shadow_stage, model, camera, color_image, depth_image);
   frame->AddTimestamp("generated shadow map");
   return SubmitPartialFrameAndBuildShadowMap<ShadowMap>(
       frame, camera, color_image, light_color);
@@ -101,17 +100,18 @@ ImagePtr ShadowMapRenderer::GetTransitionedDepthImage(
   return depth_image;
 }
 
-void ShadowMapRenderer::DrawShadowPass(impl::CommandBuffer* command_buffer,
+void ShadowMapRenderer::DrawShadowPass(const FramePtr& frame,
                                        const Stage& shadow_stage,
                                        const Model& model, const Camera& camera,
                                        ImagePtr& color_image,
                                        ImagePtr& depth_image) {
+  auto command_buffer = frame->command_buffer();
   auto fb = fxl::MakeRefCounted<Framebuffer>(escher(), color_image, depth_image,
                                              shadow_map_pass_->vk());
   auto display_list = model_renderer_->CreateDisplayList(
       shadow_stage, model, camera, shadow_map_pass_,
       impl::ModelDisplayListFlag::kNull, 1.f, TexturePtr(), mat4(1.f),
-      vec3(0.f), vec3(0.f), command_buffer);
+      vec3(0.f), vec3(0.f), command_buffer, frame->arena());
 
   command_buffer->KeepAlive(fb);
   command_buffer->KeepAlive(display_list);
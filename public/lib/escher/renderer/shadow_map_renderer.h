@@ -47,10 +47,9 @@ class ShadowMapRenderer : public Renderer {
                                      uint32_t width, uint32_t height);
   ImagePtr GetTransitionedDepthImage(impl::CommandBuffer* command_buffer,
                                      uint32_t width, uint32_t height);
-  void DrawShadowPass(impl::CommandBuffer* command_buffer,
-                      const Stage& shadow_stage, const Model& model,
-                      const Camera& camera, ImagePtr& color_image,
-                      ImagePtr& depth_image);
+  void DrawShadowPass(const FramePtr& frame, const Stage& shadow_stage,
+                      const Model& model, const Camera& camera,
+                      ImagePtr& color_image, ImagePtr& depth_image);
 
   template <typename ShadowMapT>
   fxl::RefPtr<ShadowMapT> SubmitPartialFrameAndBuildShadowMap(
@@ -0,0 +1,104 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "lib/escher/renderer/staging_ring.h"
+
+#include <algorithm>
+
+#include "lib/escher/util/align.h"
+#include "lib/escher/util/trace_macros.h"
+#include "lib/escher/vk/gpu_allocator.h"
+
+namespace escher {
+
+constexpr vk::DeviceSize StagingRing::kDefaultInitialCapacity;
+constexpr vk::DeviceSize StagingRing::kMaxCapacity;
+constexpr vk::DeviceSize StagingRing::kAlignment;
+constexpr uint32_t StagingRing::kShrinkAfterFrames;
+
+StagingRing::StagingRing(EscherWeakPtr escher,
+                         vk::DeviceSize initial_capacity)
+    : escher_(std::move(escher)),
+      initial_capacity_(std::min(initial_capacity, kMaxCapacity)),
+      next_capacity_(initial_capacity_),
+      weak_factory_(this) {
+  FXL_DCHECK(escher_);
+  FXL_DCHECK(next_capacity_ > 0);
+}
+
+StagingRing::~StagingRing() = default;
+
+uint64_t StagingRing::BeginFrame() {
+  if (allocator_ && allocator_->capacity() > initial_capacity_) {
+    if (peak_bytes_in_use_ > allocator_->capacity() / 4) {
+      low_use_frames_ = 0;
+    } else if (++low_use_frames_ >= kShrinkAfterFrames) {
+      // Command buffers that still copy from the buffer keep it alive.
+      TRACE_DURATION("gfx", "escher::StagingRing::Shrink", "capacity",
+                     allocator_->capacity());
+      next_capacity_ = std::max<vk::DeviceSize>(allocator_->capacity() / 2,
+                                                initial_capacity_);
+      buffer_ = nullptr;
+      allocator_.reset();
+      low_use_frames_ = 0;
+    }
+  }
+  peak_bytes_in_use_ = bytes_in_use();
+  return next_frame_index_++;
+}
+
+StagingRing::Range StagingRing::Allocate(vk::DeviceSize size,
+                                         uint64_t frame_index) {
+  FXL_DCHECK(size > 0);
+  if (size > kMaxCapacity) {
+    return Range();
+  }
+
+  size_t offset = allocator_
+                      ? allocator_->Allocate(size, kAlignment, frame_index)
+                      : RingAllocator::kInvalidOffset;
+  if (offset == RingAllocator::kInvalidOffset) {
+    if (allocator_ && allocator_->capacity() == kMaxCapacity) {
+      return Range();
+    }
+    // Grow until the allocation fits, rather than waiting for the GPU to
+    // retire frames that still use the current buffer.
+    while (next_capacity_ < size) {
+      next_capacity_ = std::min(next_capacity_ * 2, kMaxCapacity);
+    }
+    NewBuffer(next_capacity_);
+    next_capacity_ = std::min(next_capacity_ * 2, kMaxCapacity);
+    offset = allocator_->Allocate(size, kAlignment, frame_index);
+    FXL_DCHECK(offset != RingAllocator::kInvalidOffset);
+  }
+  peak_bytes_in_use_ = std::max(peak_bytes_in_use_, bytes_in_use());
+
+  Range range;
+  range.buffer = buffer_;
+  range.offset = offset;
+  range.size = size;
+  return range;
+}
+
+void StagingRing::ReleaseFrame(uint64_t frame_index) {
+  // Frames that used a replaced buffer are unknown to the current allocator;
+  // the command buffers that use the old buffer keep it alive.
+  if (allocator_) {
+    allocator_->ReleaseFrame(frame_index);
+  }
+}
+
+void StagingRing::NewBuffer(vk::DeviceSize capacity) {
+  TRACE_DURATION("gfx", "escher::StagingRing::NewBuffer", "capacity",
+                 capacity);
+  FXL_DCHECK(escher_);
+  buffer_ = Buffer::New(escher_->resource_recycler(), escher_->gpu_allocator(),
+                        capacity, vk::BufferUsageFlagBits::eTransferSrc,
+                        vk::MemoryPropertyFlagBits::eHostVisible |
+                            vk::MemoryPropertyFlagBits::eHostCoherent);
+  allocator_ = std::make_unique<RingAllocator>(capacity);
+  low_use_frames_ = 0;
+}
+
+}  // namespace escher
@@ -0,0 +1,93 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LIB_ESCHER_RENDERER_STAGING_RING_H_
+#define LIB_ESCHER_RENDERER_STAGING_RING_H_
+
+#include <memory>
+
+#include <vulkan/vulkan.hpp>
+
+#include "lib/escher/escher.h"
+#include "lib/escher/forward_declarations.h"
+#include "lib/escher/util/ring_allocator.h"
+#include "lib/escher/vk/buffer.h"
+#include "lib/fxl/memory/weak_ptr.h"
+
+namespace escher {
+
+// Provides host-visible staging memory for uploads from a single persistent
+// buffer, instead of a separate buffer for each upload.  Ranges of the buffer
+// are tagged with the frame that copies from them, and are reused once that
+// frame's command buffer has been retired.  When the buffer is full, it is
+// replaced by one twice as large; command buffers that still copy from the
+// old buffer keep it alive until they are retired.  Once no frame has used more
+// than a quarter of the buffer for kShrinkAfterFrames frames in a row, the
+// buffer is released, and replaced by one half as large on the next
+// allocation.
+class StagingRing {
+ public:
+  static constexpr vk::DeviceSize kDefaultInitialCapacity = 1024 * 1024;
+  static constexpr vk::DeviceSize kMaxCapacity = 64 * 1024 * 1024;
+  static constexpr uint32_t kShrinkAfterFrames = 60;
+  // Suitable for the buffer offset of any buffer-to-image copy.
+  static constexpr vk::DeviceSize kAlignment = 64;
+
+  struct Range {
+    BufferPtr buffer;
+    vk::DeviceSize offset = 0;
+    vk::DeviceSize size = 0;
+
+    uint8_t* host_ptr() const { return buffer->host_ptr() + offset; }
+  };
+
+  explicit StagingRing(EscherWeakPtr escher, vk::DeviceSize initial_capacity =
+                                                 kDefaultInitialCapacity);
+  ~StagingRing();
+
+  // Returns a new frame index, to tag the ranges of one batch of uploads.
+  uint64_t BeginFrame();
+
+  // Returns |size| bytes of staging memory for the frame with |frame_index|.
+  // The returned range has a null buffer if |size| exceeds kMaxCapacity, or if
+  // a buffer of kMaxCapacity is full.
+  Range Allocate(vk::DeviceSize size, uint64_t frame_index);
+
+  // Call once the command buffer of the frame with |frame_index| has been
+  // retired, so that its ranges can be reused.
+  void ReleaseFrame(uint64_t frame_index);
+
+  fxl::WeakPtr<StagingRing> GetWeakPtr() { return weak_factory_.GetWeakPtr(); }
+
+  // Capacity of the current buffer, or zero if there is none.
+  vk::DeviceSize capacity() const {
+    return allocator_ ? allocator_->capacity() : 0;
+  }
+  vk::DeviceSize bytes_in_use() const {
+    return allocator_ ? allocator_->bytes_in_use() : 0;
+  }
+
+ private:
+  // Replaces the current buffer with one of |capacity| bytes.
+  void NewBuffer(vk::DeviceSize capacity);
+
+  const EscherWeakPtr escher_;
+  const vk::DeviceSize initial_capacity_;
+  vk::DeviceSize next_capacity_;
+  uint64_t next_frame_index_ = 1;
+  // The most bytes in use since the last BeginFrame(), and the number of
+  // frames in a row in which that was at most a quarter of the capacity.
+  vk::DeviceSize peak_bytes_in_use_ = 0;
+  uint32_t low_use_frames_ = 0;
+  BufferPtr buffer_;
+  std::unique_ptr<RingAllocator> allocator_;
+
+  fxl::WeakPtrFactory<StagingRing> weak_factory_;  // must be last
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(StagingRing);
+};
+
+}  // namespace escher
+
+#endif  // LIB_ESCHER_RENDERER_STAGING_RING_H_
@@ -0,0 +1,139 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include <fbl/string_printf.h>
+#include <perftest/perftest.h>
+
+#include "garnet/public/lib/escher/escher.h"
+#include "garnet/public/lib/escher/escher_process_init.h"
+#include "garnet/public/lib/escher/impl/descriptor_set_pool.h"
+#include "garnet/public/lib/escher/impl/uniform_buffer_pool.h"
+#include "garnet/public/lib/escher/impl/vulkan_utils.h"
+#include "garnet/public/lib/escher/renderer/frame_arena.h"
+#include "garnet/public/lib/escher/renderer/uniform_block_allocator.h"
+#include "lib/fxl/logging.h"
+
+namespace {
+
+using namespace escher;
+
+constexpr size_t kUniformSize = 128;
+constexpr size_t kUniformAlignment = 256;
+
+std::unique_ptr<Escher> g_escher;
+
+// A descriptor set layout with a single uniform buffer, as most draw calls
+// use.
+class UniformLayout {
+ public:
+  UniformLayout() {
+    binding_.binding = 0;
+    binding_.descriptorType = vk::DescriptorType::eUniformBuffer;
+    binding_.descriptorCount = 1;
+    binding_.stageFlags = vk::ShaderStageFlagBits::eVertex;
+    info_.bindingCount = 1;
+    info_.pBindings = &binding_;
+    layout_ = ESCHER_CHECKED_VK_RESULT(
+        g_escher->vk_device().createDescriptorSetLayout(info_));
+  }
+  ~UniformLayout() {
+    g_escher->vk_device().destroyDescriptorSetLayout(layout_);
+  }
+
+  vk::DescriptorSetLayout layout() const { return layout_; }
+  const vk::DescriptorSetLayoutCreateInfo& info() const { return info_; }
+
+ private:
+  vk::DescriptorSetLayoutBinding binding_;
+  vk::DescriptorSetLayoutCreateInfo info_;
+  vk::DescriptorSetLayout layout_;
+};
+
+// Waits for the device, and releases the resources that it has finished with.
+void Cleanup() {
+  g_escher->vk_device().waitIdle();
+  g_escher->Cleanup();
+}
+
+// Measures the CPU time of allocating the uniform data and descriptor sets of
+// a frame with |draw_count| draw calls from a FrameArena.  After the first
+// frame, the arena's buffers and pools are reused.
+bool FrameArenaTest(perftest::RepeatState* state, uint32_t draw_count) {
+  UniformLayout layout;
+  {
+    FrameArena arena(g_escher->GetWeakPtr());
+    while (state->KeepRunning()) {
+      for (uint32_t i = 0; i < draw_count; ++i) {
+        arena.AllocateUniform(kUniformSize, kUniformAlignment);
+        if (!arena.AllocateDescriptorSet(layout.layout(), layout.info())) {
+          return false;
+        }
+      }
+      arena.Reset();
+    }
+  }
+  Cleanup();
+  return true;
+}
+
+// Same as FrameArenaTest(), with the pools that FrameArena replaces.
+bool PoolsTest(perftest::RepeatState* state, uint32_t draw_count) {
+  UniformLayout layout;
+  {
+    impl::UniformBufferPool uniform_buffer_pool(g_escher->GetWeakPtr(), 1);
+    impl::DescriptorSetPool descriptor_set_pool(g_escher->GetWeakPtr(),
+                                                layout.info());
+    std::vector<impl::DescriptorSetAllocationPtr> sets;
+    while (state->KeepRunning()) {
+      UniformBlockAllocator allocator(uniform_buffer_pool.GetWeakPtr());
+      for (uint32_t i = 0; i < draw_count; ++i) {
+        allocator.Allocate(kUniformSize, kUniformAlignment);
+        sets.push_back(descriptor_set_pool.Allocate(1, nullptr));
+      }
+      allocator.TakeBuffers();
+      sets.clear();
+    }
+  }
+  Cleanup();
+  return true;
+}
+
+void RegisterTests() {
+  for (uint32_t draw_count : {100, 2000}) {
+    auto name = fbl::StringPrintf("Escher/FrameArena/%udraws", draw_count);
+    perftest::RegisterTest(name.c_str(), FrameArenaTest, draw_count);
+    name = fbl::StringPrintf("Escher/Pools/%udraws", draw_count);
+    perftest::RegisterTest(name.c_str(), PoolsTest, draw_count);
+  }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  // Without validation layers, which would dominate the measurements.
+  auto vulkan_instance = escher::VulkanInstance::New({{}, {}, false});
+  if (!vulkan_instance) {
+    FXL_LOG(ERROR) << "Vulkan is not available.";
+    return 1;
+  }
+  escher::VulkanDeviceQueues::Params device_params({{}, vk::SurfaceKHR()});
+#ifdef OS_FUCHSIA
+  device_params.extension_names.insert(
+      VK_KHR_EXTERNAL_SEMAPHORE_FUCHSIA_EXTENSION_NAME);
+#endif
+  auto vulkan_device =
+      escher::VulkanDeviceQueues::New(vulkan_instance, device_params);
+  escher::GlslangInitializeProcess();
+  g_escher = std::make_unique<escher::Escher>(vulkan_device);
+
+  int result = perftest::PerfTestMain(argc, argv, "fuchsia.escher");
+
+  g_escher = nullptr;
+  escher::GlslangFinalizeProcess();
+  return result;
+}
@@ -0,0 +1,173 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "lib/escher/geometry/indexed_triangle_mesh_clipper.h"
+
+#include <cmath>
+#include <random>
+
+#include "lib/escher/util/stopwatch.h"
+#include "lib/fxl/logging.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace escher;
+
+// Returns a mesh covering the square from (-1,-1) to (1,1), made of
+// |cells_per_side|^2 quads, each split into two triangles.  Attribute 1 holds
+// the UV coordinates of each vertex.
+IndexedTriangleMesh2d<vec2> NewGridMesh2d(uint32_t cells_per_side) {
+  IndexedTriangleMesh2d<vec2> mesh;
+  const uint32_t verts_per_side = cells_per_side + 1;
+  for (uint32_t y = 0; y < verts_per_side; ++y) {
+    for (uint32_t x = 0; x < verts_per_side; ++x) {
+      vec2 uv(float(x) / cells_per_side, float(y) / cells_per_side);
+      mesh.positions.push_back(uv * 2.f - vec2(1.f, 1.f));
+      mesh.attributes1.push_back(uv);
+    }
+  }
+  for (uint32_t y = 0; y < cells_per_side; ++y) {
+    for (uint32_t x = 0; x < cells_per_side; ++x) {
+      const uint32_t i = y * verts_per_side + x;
+      mesh.indices.insert(mesh.indices.end(),
+                          {i, i + 1, i + verts_per_side, i + 1,
+                           i + verts_per_side + 1, i + verts_per_side});
+    }
+  }
+  return mesh;
+}
+
+// Same as above, but the grid is warped along the Z-axis.
+IndexedTriangleMesh3d<vec2> NewGridMesh3d(uint32_t cells_per_side) {
+  auto mesh2d = NewGridMesh2d(cells_per_side);
+
+  IndexedTriangleMesh3d<vec2> mesh3d;
+  mesh3d.indices = mesh2d.indices;
+  mesh3d.attributes1 = mesh2d.attributes1;
+  for (const vec2& pos : mesh2d.positions) {
+    mesh3d.positions.push_back(vec3(pos, pos.x * pos.y));
+  }
+  return mesh3d;
+}
+
+// Returns planes that keep only the inside of a regular polygon with
+// |num_sides| sides, whose edges are |radius| from the origin.
+std::vector<plane2> NewPolygonPlanes(uint32_t num_sides, float radius) {
+  std::vector<plane2> planes;
+  for (uint32_t i = 0; i < num_sides; ++i) {
+    const float angle = 2.f * 3.14159265f * i / num_sides;
+    planes.push_back(plane2(-vec2(std::cos(angle), std::sin(angle)), -radius));
+  }
+  return planes;
+}
+
+std::vector<plane2> NewRandomPlanes2d(std::mt19937* random, size_t count) {
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  std::vector<plane2> planes;
+  while (planes.size() < count) {
+    vec2 dir(distribution(*random), distribution(*random));
+    if (glm::dot(dir, dir) > 0.01f) {
+      planes.push_back(plane2(glm::normalize(dir), distribution(*random)));
+    }
+  }
+  return planes;
+}
+
+std::vector<plane3> NewRandomPlanes3d(std::mt19937* random, size_t count) {
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  std::vector<plane3> planes;
+  while (planes.size() < count) {
+    vec3 dir(distribution(*random), distribution(*random),
+             distribution(*random));
+    if (glm::dot(dir, dir) > 0.01f) {
+      planes.push_back(plane3(glm::normalize(dir), distribution(*random)));
+    }
+  }
+  return planes;
+}
+
+// Clips |mesh| by each list of planes in |plane_lists| with both
+// IndexedTriangleMeshClip() and a single IndexedTriangleMeshClipper, and
+// verifies that the results are identical.
+template <typename MeshT, typename PlaneT>
+void TestClipperMatchesClip(
+    const MeshT& mesh, const std::vector<std::vector<PlaneT>>& plane_lists) {
+  IndexedTriangleMeshClipper<MeshT, PlaneT> clipper;
+  for (auto& planes : plane_lists) {
+    auto expected = IndexedTriangleMeshClip(mesh, planes);
+    auto result = clipper.Clip(mesh, planes);
+    EXPECT_EQ(expected.first, result.first);
+    EXPECT_EQ(expected.second, result.second);
+  }
+}
+
+TEST(IndexedTriangleMeshClipper, MatchesIndexedTriangleMeshClip2d) {
+  std::mt19937 random(1);
+  std::vector<std::vector<plane2>> plane_lists = {
+      {},
+      NewPolygonPlanes(6, 0.8f),
+      // More planes than are classified in a single batch.
+      NewPolygonPlanes(45, 0.9f),
+      // Clips everything.
+      {plane2(vec2(1, 0), 2.f)},
+      // Clips nothing.
+      {plane2(vec2(1, 0), -2.f)}};
+  for (size_t count : {1, 3, 8, 33, 70}) {
+    plane_lists.push_back(NewRandomPlanes2d(&random, count));
+  }
+
+  TestClipperMatchesClip(NewGridMesh2d(16), plane_lists);
+  TestClipperMatchesClip(NewGridMesh2d(40), plane_lists);
+}
+
+TEST(IndexedTriangleMeshClipper, MatchesIndexedTriangleMeshClip3d) {
+  std::mt19937 random(2);
+  std::vector<std::vector<plane3>> plane_lists;
+  for (size_t count : {0, 1, 3, 8, 33, 70}) {
+    plane_lists.push_back(NewRandomPlanes3d(&random, count));
+  }
+  plane_lists.emplace_back();
+  for (auto& plane : NewPolygonPlanes(40, 0.7f)) {
+    plane_lists.back().push_back(plane3(plane));
+  }
+
+  TestClipperMatchesClip(NewGridMesh3d(16), plane_lists);
+  TestClipperMatchesClip(NewGridMesh3d(40), plane_lists);
+}
+
+TEST(IndexedTriangleMeshClipper, Benchmark) {
+  constexpr size_t kIterations = 10;
+  for (uint32_t cells_per_side : {16, 64, 128}) {
+    const auto mesh = NewGridMesh2d(cells_per_side);
+    for (uint32_t num_planes : {4, 8, 32}) {
+      const auto planes = NewPolygonPlanes(num_planes, 0.9f);
+
+      Stopwatch stopwatch;
+      for (size_t i = 0; i < kIterations; ++i) {
+        IndexedTriangleMeshClip(mesh, planes);
+      }
+      stopwatch.Stop();
+      const uint64_t clip_microseconds = stopwatch.GetElapsedMicroseconds();
+
+      IndexedTriangleMeshClipper<IndexedTriangleMesh2d<vec2>, plane2> clipper;
+      stopwatch.Reset();
+      stopwatch.Start();
+      for (size_t i = 0; i < kIterations; ++i) {
+        clipper.Clip(mesh, planes);
+      }
+      stopwatch.Stop();
+      const uint64_t clipper_microseconds = stopwatch.GetElapsedMicroseconds();
+
+      FXL_LOG(INFO) << "Clipped " << mesh.triangle_count()
+                    << " triangles by " << num_planes << " planes in "
+                    << clipper_microseconds / kIterations
+                    << " us (IndexedTriangleMeshClip: "
+                    << clip_microseconds / kIterations << " us)";
+    }
+  }
+}
+
+}  // namespace
@@ -0,0 +1,109 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "lib/escher/impl/spirv_cache.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+#include "gtest/gtest.h"
+#include "lib/fxl/files/file.h"
+#include "lib/fxl/files/scoped_temp_dir.h"
+
+namespace escher {
+namespace impl {
+namespace {
+
+const SpirvData kSpirv = {0x07230203, 0x00010000, 0x00080001, 42, 0};
+
+TEST(SpirvCache, StoreAndLoad) {
+  files::ScopedTempDir temp_dir;
+  SpirvCache cache(temp_dir.path() + "/spirv");
+
+  Hash key = SpirvCache::KeyForGlsl(vk::ShaderStageFlagBits::eVertex,
+                                    {"void main() {}"}, "", "main");
+  SpirvData spirv;
+  EXPECT_FALSE(cache.Load(key, &spirv));
+  EXPECT_EQ(1U, cache.miss_count());
+
+  EXPECT_TRUE(cache.Store(key, kSpirv));
+  EXPECT_TRUE(cache.Load(key, &spirv));
+  EXPECT_EQ(kSpirv, spirv);
+  EXPECT_EQ(1U, cache.hit_count());
+
+  // A new cache in the same directory, as after a restart, sees the entry.
+  SpirvCache cache2(temp_dir.path() + "/spirv");
+  spirv.clear();
+  EXPECT_TRUE(cache2.Load(key, &spirv));
+  EXPECT_EQ(kSpirv, spirv);
+}
+
+TEST(SpirvCache, GlslKeysDependOnAllInputs) {
+  const Hash key = SpirvCache::KeyForGlsl(vk::ShaderStageFlagBits::eVertex,
+                                          {"a", "b"}, "preamble", "main");
+  EXPECT_EQ(key,
+            SpirvCache::KeyForGlsl(vk::ShaderStageFlagBits::eVertex,
+                                   {"a", "b"}, "preamble", "main"));
+  EXPECT_NE(key,
+            SpirvCache::KeyForGlsl(vk::ShaderStageFlagBits::eFragment,
+                                   {"a", "b"}, "preamble", "main"));
+  EXPECT_NE(key, SpirvCache::KeyForGlsl(vk::ShaderStageFlagBits::eVertex,
+                                        {"ab"}, "preamble", "main"));
+  EXPECT_NE(key, SpirvCache::KeyForGlsl(vk::ShaderStageFlagBits::eVertex,
+                                        {"a", "b"}, "", "main"));
+  EXPECT_NE(key, SpirvCache::KeyForGlsl(vk::ShaderStageFlagBits::eVertex,
+                                        {"a", "b"}, "preamble", "other"));
+}
+
+TEST(SpirvCache, ShaderVariantKeysDependOnAllInputs) {
+  ShaderVariantArgs args({{"USE_ATTRIBUTE_UV", "1"}});
+  const Hash key = SpirvCache::KeyForShaderVariant(ShaderStage::kVertex,
+                                                   "source", args);
+  EXPECT_EQ(key, SpirvCache::KeyForShaderVariant(ShaderStage::kVertex,
+                                                 "source", args));
+  EXPECT_NE(key, SpirvCache::KeyForShaderVariant(ShaderStage::kFragment,
+                                                 "source", args));
+  EXPECT_NE(key, SpirvCache::KeyForShaderVariant(ShaderStage::kVertex,
+                                                 "source2", args));
+  EXPECT_NE(key, SpirvCache::KeyForShaderVariant(
+                     ShaderStage::kVertex, "source",
+                     ShaderVariantArgs({{"USE_ATTRIBUTE_UV", "0"}})));
+  EXPECT_NE(key, SpirvCache::KeyForGlsl(vk::ShaderStageFlagBits::eVertex,
+                                        {"source"}, "", "main"));
+}
+
+TEST(SpirvCache, CorruptEntriesAreMisses) {
+  files::ScopedTempDir temp_dir;
+  SpirvCache cache(temp_dir.path());
+
+  Hash key = SpirvCache::KeyForGlsl(vk::ShaderStageFlagBits::eVertex,
+                                    {"void main() {}"}, "", "main");
+  ASSERT_TRUE(cache.Store(key, kSpirv));
+
+  char name[32];
+  snprintf(name, sizeof(name), "%016" PRIx64 ".spv", key.val);
+  const std::string path = temp_dir.path() + "/" + name;
+
+  // Flip a bit of the code.
+  std::string contents;
+  ASSERT_TRUE(files::ReadFileToString(path, &contents));
+  contents[contents.size() - 1] ^= 1;
+  ASSERT_TRUE(files::WriteFile(path, contents.data(), contents.size()));
+  SpirvData spirv;
+  EXPECT_FALSE(cache.Load(key, &spirv));
+
+  // Truncate the entry.
+  ASSERT_TRUE(files::WriteFile(path, "ESPV", 4));
+  EXPECT_FALSE(cache.Load(key, &spirv));
+  EXPECT_TRUE(spirv.empty());
+
+  // Storing again repairs the entry.
+  ASSERT_TRUE(cache.Store(key, kSpirv));
+  EXPECT_TRUE(cache.Load(key, &spirv));
+  EXPECT_EQ(kSpirv, spirv);
+}
+
+}  // namespace
+}  // namespace impl
+}  // namespace escher
@@ -145,6 +145,50 @@ VK_TEST(BatchGpuUploader, WriteBuffer) {
   EXPECT_TRUE(escher->Cleanup());
 }
 
+VK_TEST(BatchGpuUploader, WritersShareStagingRing) {
+  auto escher = test::GetEscher()->GetWeakPtr();
+  StagingRing staging_ring(escher);
+  const size_t buffer_size = 3 * sizeof(vec3);
+  BufferFactory buffer_factory(escher);
+  BufferPtr vertex_buffer =
+      buffer_factory.NewBuffer(buffer_size,
+                               vk::BufferUsageFlagBits::eVertexBuffer |
+                                   vk::BufferUsageFlagBits::eTransferDst,
+                               vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+  constexpr uint32_t kFrameCount = 3;
+  constexpr uint32_t kWritesPerFrame = 4;
+  for (uint32_t i = 0; i < kFrameCount; ++i) {
+    BatchGpuUploaderPtr uploader =
+        BatchGpuUploader::New(escher, i, &staging_ring);
+    for (uint32_t j = 0; j < kWritesPerFrame; ++j) {
+      auto writer = uploader->AcquireWriter(buffer_size);
+      EXPECT_EQ(buffer_size, writer->size());
+      vec3* const verts = reinterpret_cast<vec3*>(writer->host_ptr());
+      verts[0] = vec3(0.f, 0.f, 0.f);
+      verts[1] = vec3(0.f, 1.f, 0.f);
+      verts[2] = vec3(1.f, 0.f, 0.f);
+      writer->WriteBuffer(vertex_buffer, {0, 0, buffer_size}, SemaphorePtr());
+      uploader->PostWriter(std::move(writer));
+    }
+    EXPECT_EQ(kWritesPerFrame * buffer_size, uploader->stats().staging_bytes);
+    EXPECT_EQ(uploader->stats().staging_bytes,
+              uploader->stats().staging_ring_bytes);
+    EXPECT_EQ(kWritesPerFrame, uploader->stats().copy_count);
+    EXPECT_LT(0u, staging_ring.bytes_in_use());
+
+    bool retired = false;
+    uploader->Submit(SemaphorePtr(), [&retired] { retired = true; });
+    escher->vk_device().waitIdle();
+    EXPECT_TRUE(escher->Cleanup());
+    EXPECT_TRUE(retired);
+
+    // The frame's staging memory is reused by the next frame.
+    EXPECT_EQ(0u, staging_ring.bytes_in_use());
+    EXPECT_EQ(StagingRing::kDefaultInitialCapacity, staging_ring.capacity());
+  }
+}
+
 VK_TEST(BatchGpuUploader, DISABLED_WriterNotPostedFails) {
   // This successfully tests death. However, when unsupported, death kills the
   // test process. Disabled until EXPECT_DEATH_IF_SUPPORTED can graduate to
@@ -0,0 +1,141 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/public/lib/escher/renderer/frame_arena.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "garnet/public/lib/escher/impl/vulkan_utils.h"
+#include "garnet/public/lib/escher/test/gtest_escher.h"
+#include "gtest/gtest.h"
+
+namespace escher {
+namespace {
+
+constexpr size_t kUniformAlignment = 256;
+
+vk::DescriptorSetLayoutCreateInfo NewUniformLayoutInfo(
+    vk::DescriptorSetLayoutBinding* binding, uint32_t descriptor_count = 1) {
+  binding->binding = 0;
+  binding->descriptorType = vk::DescriptorType::eUniformBuffer;
+  binding->descriptorCount = descriptor_count;
+  binding->stageFlags = vk::ShaderStageFlagBits::eVertex;
+
+  vk::DescriptorSetLayoutCreateInfo info;
+  info.bindingCount = 1;
+  info.pBindings = binding;
+  return info;
+}
+
+VK_TEST(FrameArena, UniformsShareBlocks) {
+  auto escher = test::GetEscher()->GetWeakPtr();
+  {
+    FrameArena arena(escher);
+
+    auto allocation1 = arena.AllocateUniform(100, kUniformAlignment);
+    auto allocation2 = arena.AllocateUniform(100, kUniformAlignment);
+    ASSERT_NE(nullptr, allocation1.buffer);
+    EXPECT_EQ(allocation1.buffer, allocation2.buffer);
+    EXPECT_EQ(0u, allocation1.offset);
+    EXPECT_EQ(kUniformAlignment, allocation2.offset);
+    EXPECT_EQ(static_cast<uint8_t*>(allocation1.host_ptr) + kUniformAlignment,
+              allocation2.host_ptr);
+
+    // Doesn't fit in the rest of the block.
+    auto allocation3 =
+        arena.AllocateUniform(FrameArena::kBlockSize, kUniformAlignment);
+    EXPECT_NE(allocation1.buffer, allocation3.buffer);
+    EXPECT_EQ(0u, allocation3.offset);
+
+    auto stats = arena.stats();
+    EXPECT_EQ(3u, stats.uniform_allocation_count);
+    EXPECT_EQ(200u + FrameArena::kBlockSize, stats.uniform_bytes);
+    EXPECT_EQ(2u, stats.new_block_count);
+
+    // After a reset, the same blocks are used again.
+    arena.Reset();
+    EXPECT_EQ(0u, arena.stats().uniform_allocation_count);
+    auto allocation4 = arena.AllocateUniform(100, kUniformAlignment);
+    auto allocation5 =
+        arena.AllocateUniform(FrameArena::kBlockSize, kUniformAlignment);
+    EXPECT_EQ(allocation1.buffer, allocation4.buffer);
+    EXPECT_EQ(0u, allocation4.offset);
+    EXPECT_EQ(allocation3.buffer, allocation5.buffer);
+    EXPECT_EQ(0u, arena.stats().new_block_count);
+  }
+  escher->vk_device().waitIdle();
+  EXPECT_TRUE(escher->Cleanup());
+}
+
+VK_TEST(FrameArena, DescriptorSets) {
+  auto escher = test::GetEscher()->GetWeakPtr();
+  vk::DescriptorSetLayoutBinding binding;
+  auto layout_info = NewUniformLayoutInfo(&binding);
+  vk::DescriptorSetLayout layout = ESCHER_CHECKED_VK_RESULT(
+      escher->vk_device().createDescriptorSetLayout(layout_info));
+  {
+    FrameArena arena(escher);
+
+    // More than fit in a single descriptor pool.
+    constexpr uint32_t kSetCount = 1000;
+    for (int frame = 0; frame < 2; ++frame) {
+      std::vector<vk::DescriptorSet> sets;
+      for (uint32_t i = 0; i < kSetCount; ++i) {
+        sets.push_back(arena.AllocateDescriptorSet(layout, layout_info));
+        EXPECT_TRUE(sets.back());
+      }
+      std::sort(sets.begin(), sets.end());
+      EXPECT_EQ(sets.end(), std::unique(sets.begin(), sets.end()));
+
+      auto stats = arena.stats();
+      EXPECT_EQ(kSetCount, stats.descriptor_set_count);
+      if (frame == 0) {
+        // Pools are used up to their number of sets.
+        EXPECT_EQ((kSetCount - 1) / FrameArena::kDescriptorSetsPerPool + 1,
+                  stats.new_descriptor_pool_count);
+      } else {
+        // The pools are reused.
+        EXPECT_EQ(0u, stats.new_descriptor_pool_count);
+      }
+      arena.Reset();
+    }
+  }
+  escher->vk_device().destroyDescriptorSetLayout(layout);
+  escher->vk_device().waitIdle();
+  EXPECT_TRUE(escher->Cleanup());
+}
+
+// Tests that the next pool is used once the current one has too few
+// descriptors left for a set, even though it has room for more sets.
+VK_TEST(FrameArena, DescriptorPoolsRollOver) {
+  auto escher = test::GetEscher()->GetWeakPtr();
+  // Two sets don't fit in one pool.
+  vk::DescriptorSetLayoutBinding binding;
+  auto layout_info =
+      NewUniformLayoutInfo(&binding, FrameArena::kDescriptorsPerType / 2 + 1);
+  vk::DescriptorSetLayout layout = ESCHER_CHECKED_VK_RESULT(
+      escher->vk_device().createDescriptorSetLayout(layout_info));
+  {
+    FrameArena arena(escher);
+    for (uint32_t i = 0; i < 3; ++i) {
+      EXPECT_TRUE(arena.AllocateDescriptorSet(layout, layout_info));
+      EXPECT_EQ(i + 1, arena.stats().new_descriptor_pool_count);
+    }
+
+    // Sets that need more descriptors than a pool has aren't allocated.
+    vk::DescriptorSetLayoutBinding too_many_binding;
+    auto too_many_info = NewUniformLayoutInfo(
+        &too_many_binding, FrameArena::kDescriptorsPerType + 1);
+    EXPECT_FALSE(
+        arena.AllocateDescriptorSet(vk::DescriptorSetLayout(), too_many_info));
+    EXPECT_EQ(3u, arena.stats().descriptor_set_count);
+  }
+  escher->vk_device().destroyDescriptorSetLayout(layout);
+  escher->vk_device().waitIdle();
+  EXPECT_TRUE(escher->Cleanup());
+}
+
+}  // namespace
+}  // namespace escher
@@ -67,4 +67,24 @@ VK_TEST(Frame, SubmitPartialFrameCreatesCleanCommandBuffer) {
   frame->EndFrame(SemaphorePtr(), [] {});
 }
 
+VK_TEST(Frame, UniformBuffersAreReusedAfterFramesRetire) {
+  auto escher = test::GetEscher()->GetWeakPtr();
+
+  // Frames recycle the arenas of retired frames, so after the first few
+  // frames, no uniform buffers are created.
+  uint32_t new_block_count = 0;
+  for (uint64_t frame_number = 0; frame_number < 20; ++frame_number) {
+    auto frame = escher->NewFrame("test_frame", frame_number, false);
+    auto allocation = frame->AllocateUniform(100, 256);
+    EXPECT_NE(nullptr, allocation.buffer);
+    new_block_count = frame->arena()->stats().new_block_count;
+    frame->EndFrame(SemaphorePtr(), [] {});
+    frame = nullptr;
+
+    escher->vk_device().waitIdle();
+    EXPECT_TRUE(escher->Cleanup());
+  }
+  EXPECT_EQ(0u, new_block_count);
+}
+
 }  // namespace escher
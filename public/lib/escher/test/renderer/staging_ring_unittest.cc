@@ -0,0 +1,110 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "garnet/public/lib/escher/renderer/staging_ring.h"
+
+#include "garnet/public/lib/escher/test/gtest_escher.h"
+#include "garnet/public/lib/escher/test/vk/vulkan_tester.h"
+#include "gtest/gtest.h"
+
+namespace escher {
+
+VK_TEST(StagingRing, RangesShareOneBuffer) {
+  auto escher = test::GetEscher()->GetWeakPtr();
+  {
+    StagingRing ring(escher, 4096);
+    EXPECT_EQ(0u, ring.capacity());
+
+    uint64_t frame = ring.BeginFrame();
+    auto range1 = ring.Allocate(100, frame);
+    auto range2 = ring.Allocate(100, frame);
+    ASSERT_TRUE(range1.buffer && range2.buffer);
+    EXPECT_EQ(range1.buffer, range2.buffer);
+    EXPECT_EQ(0u, range1.offset);
+    EXPECT_EQ(StagingRing::kAlignment, range2.offset);
+    EXPECT_EQ(range1.host_ptr() + StagingRing::kAlignment, range2.host_ptr());
+    EXPECT_EQ(4096u, ring.capacity());
+
+    // Once the frame is released, its space is reused.
+    ring.ReleaseFrame(frame);
+    EXPECT_EQ(0u, ring.bytes_in_use());
+    auto range3 = ring.Allocate(100, ring.BeginFrame());
+    EXPECT_EQ(range1.buffer, range3.buffer);
+    EXPECT_EQ(0u, range3.offset);
+  }
+  escher->vk_device().waitIdle();
+  EXPECT_TRUE(escher->Cleanup());
+}
+
+VK_TEST(StagingRing, GrowsWhenFull) {
+  auto escher = test::GetEscher()->GetWeakPtr();
+  {
+    StagingRing ring(escher, 4096);
+    auto range1 = ring.Allocate(3000, ring.BeginFrame());
+    // Frames that are still in flight keep using the old buffer.
+    auto range2 = ring.Allocate(3000, ring.BeginFrame());
+    ASSERT_TRUE(range1.buffer && range2.buffer);
+    EXPECT_NE(range1.buffer, range2.buffer);
+    EXPECT_EQ(8192u, ring.capacity());
+
+    // Larger than the next capacity.
+    auto range3 = ring.Allocate(20000, ring.BeginFrame());
+    ASSERT_TRUE(range3.buffer);
+    EXPECT_LE(20000u, ring.capacity());
+
+    auto range4 = ring.Allocate(StagingRing::kMaxCapacity + 1,
+                                ring.BeginFrame());
+    EXPECT_FALSE(range4.buffer);
+  }
+  escher->vk_device().waitIdle();
+  EXPECT_TRUE(escher->Cleanup());
+}
+
+VK_TEST(StagingRing, ShrinksAfterLowUse) {
+  auto escher = test::GetEscher()->GetWeakPtr();
+  {
+    StagingRing ring(escher, 4096);
+    uint64_t frame1 = ring.BeginFrame();
+    ring.Allocate(3000, frame1);
+    uint64_t frame2 = ring.BeginFrame();
+    ring.Allocate(3000, frame2);
+    EXPECT_EQ(8192u, ring.capacity());
+    ring.ReleaseFrame(frame1);
+    ring.ReleaseFrame(frame2);
+
+    // A frame using more than a quarter of the buffer restarts the count.
+    uint64_t frame = ring.BeginFrame();
+    ring.Allocate(3000, frame);
+    ring.ReleaseFrame(frame);
+
+    for (uint32_t i = 0; i < StagingRing::kShrinkAfterFrames; ++i) {
+      frame = ring.BeginFrame();
+      ASSERT_TRUE(ring.Allocate(100, frame).buffer);
+      EXPECT_EQ(8192u, ring.capacity());
+      ring.ReleaseFrame(frame);
+    }
+    frame = ring.BeginFrame();
+    EXPECT_EQ(0u, ring.capacity());
+    ASSERT_TRUE(ring.Allocate(100, frame).buffer);
+    EXPECT_EQ(4096u, ring.capacity());
+    ring.ReleaseFrame(frame);
+
+    // The buffer doesn't shrink below the initial capacity.
+    for (uint32_t i = 0; i <= StagingRing::kShrinkAfterFrames; ++i) {
+      frame = ring.BeginFrame();
+      ASSERT_TRUE(ring.Allocate(100, frame).buffer);
+      EXPECT_EQ(4096u, ring.capacity());
+      ring.ReleaseFrame(frame);
+    }
+
+    // Outgrowing the smaller buffer doubles it again.
+    ring.Allocate(3000, ring.BeginFrame());
+    ring.Allocate(3000, ring.BeginFrame());
+    EXPECT_EQ(8192u, ring.capacity());
+  }
+  escher->vk_device().waitIdle();
+  EXPECT_TRUE(escher->Cleanup());
+}
+
+}  // namespace escher
@@ -4,6 +4,7 @@
 
 #include "lib/escher/impl/model_pipeline_spec.h"
 #include "lib/escher/util/hash_map.h"
+#include "lib/escher/util/hasher.h"
 #include "lib/escher/vk/image.h"
 
 #include "gtest/gtest.h"
@@ -79,4 +80,30 @@ TEST(Hash, AllHashedTypes) {
   }
 }
 
+// Hashing bytes covers every byte, including the ones past the last whole
+// word, and doesn't depend on the alignment of the data.
+TEST(Hasher, Bytes) {
+  auto hash_bytes = [](const uint8_t* bytes, size_t size) {
+    Hasher hasher;
+    hasher.bytes(bytes, size);
+    return hasher.value();
+  };
+
+  uint8_t bytes[20];
+  for (size_t i = 0; i < sizeof(bytes); ++i) {
+    bytes[i] = static_cast<uint8_t>(i);
+  }
+  uint8_t unaligned[sizeof(bytes) + 1];
+  std::memcpy(unaligned + 1, bytes, sizeof(bytes));
+
+  const Hash hash = hash_bytes(bytes, sizeof(bytes));
+  EXPECT_EQ(hash, hash_bytes(unaligned + 1, sizeof(bytes)));
+  EXPECT_NE(hash, hash_bytes(bytes, sizeof(bytes) - 1));
+  for (size_t i : {0u, 7u, 8u, 19u}) {
+    bytes[i] ^= 1;
+    EXPECT_NE(hash, hash_bytes(bytes, sizeof(bytes))) << "byte " << i;
+    bytes[i] ^= 1;
+  }
+}
+
 }  // namespace
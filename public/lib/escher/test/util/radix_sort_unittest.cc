@@ -0,0 +1,92 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "lib/escher/util/radix_sort.h"
+
+#include <algorithm>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace {
+using namespace escher;
+
+// Sort |keys| with RadixSorter, and verify that the result matches that of
+// std::stable_sort().
+void ExpectMatchesStableSort(const std::vector<uint64_t>& keys) {
+  std::vector<uint32_t> expected_order(keys.size());
+  for (uint32_t i = 0; i < keys.size(); ++i) {
+    expected_order[i] = i;
+  }
+  std::stable_sort(
+      expected_order.begin(), expected_order.end(),
+      [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+  std::vector<uint64_t> sorted_keys = keys;
+  std::vector<uint32_t> order;
+  RadixSorter().Sort(&sorted_keys, &order);
+
+  EXPECT_EQ(expected_order, order);
+  for (uint32_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(keys[expected_order[i]], sorted_keys[i]);
+  }
+}
+
+TEST(RadixSort, EmptyAndSingle) {
+  ExpectMatchesStableSort({});
+  ExpectMatchesStableSort({42});
+}
+
+TEST(RadixSort, AllEqual) { ExpectMatchesStableSort({7, 7, 7, 7, 7}); }
+
+TEST(RadixSort, IsStable) {
+  ExpectMatchesStableSort({3, 1, 2, 1, 3, 0xffffffffffffffff, 2, 1, 0});
+}
+
+TEST(RadixSort, RandomKeys) {
+  std::mt19937_64 random(1234);
+  std::vector<uint64_t> keys(5000);
+
+  // Keys that vary in every digit.
+  for (auto& key : keys) {
+    key = random();
+  }
+  ExpectMatchesStableSort(keys);
+
+  // Keys with many duplicates, that only vary in an odd number of digits.
+  for (auto& key : keys) {
+    key = (random() & 0xff00ff) | 0x1200000000000000;
+  }
+  ExpectMatchesStableSort(keys);
+}
+
+TEST(RadixSort, ReusesSorter) {
+  RadixSorter sorter;
+  std::vector<uint32_t> order;
+
+  std::vector<uint64_t> keys = {5, 3, 0x300, 1};
+  sorter.Sort(&keys, &order);
+  EXPECT_EQ(std::vector<uint64_t>({1, 3, 5, 0x300}), keys);
+  EXPECT_EQ(std::vector<uint32_t>({3, 1, 0, 2}), order);
+
+  keys = {2, 1};
+  sorter.Sort(&keys, &order);
+  EXPECT_EQ(std::vector<uint64_t>({1, 2}), keys);
+  EXPECT_EQ(std::vector<uint32_t>({1, 0}), order);
+}
+
+TEST(RadixSort, FloatToSortableBits) {
+  const std::vector<float> values = {-1e30f, -2.5f, -1.f, -0.f, 0.f,
+                                     1e-30f, 1.f,   2.5f, 1e30f};
+  for (size_t i = 1; i < values.size(); ++i) {
+    EXPECT_LE(FloatToSortableBits(values[i - 1]),
+              FloatToSortableBits(values[i]));
+    if (values[i - 1] < values[i]) {
+      EXPECT_LT(FloatToSortableBits(values[i - 1]),
+                FloatToSortableBits(values[i]));
+    }
+  }
+}
+
+}  // namespace
@@ -0,0 +1,76 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "lib/escher/util/ring_allocator.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+using namespace escher;
+
+constexpr size_t kInvalid = RingAllocator::kInvalidOffset;
+
+TEST(RingAllocator, AllocationsAreAligned) {
+  RingAllocator allocator(1024);
+  EXPECT_EQ(0u, allocator.Allocate(10, 64, 1));
+  EXPECT_EQ(64u, allocator.Allocate(10, 64, 1));
+  EXPECT_EQ(76u, allocator.Allocate(10, 4, 1));
+  EXPECT_EQ(86u, allocator.bytes_in_use());
+}
+
+TEST(RingAllocator, FailsWhenFull) {
+  RingAllocator allocator(256);
+  EXPECT_EQ(kInvalid, allocator.Allocate(257, 1, 1));
+  EXPECT_EQ(0u, allocator.Allocate(200, 1, 1));
+  EXPECT_EQ(kInvalid, allocator.Allocate(100, 1, 2));
+  EXPECT_EQ(200u, allocator.Allocate(56, 1, 2));
+  EXPECT_EQ(256u, allocator.bytes_in_use());
+  EXPECT_EQ(kInvalid, allocator.Allocate(1, 1, 2));
+}
+
+TEST(RingAllocator, ReleasedFramesAreReused) {
+  RingAllocator allocator(256);
+  EXPECT_EQ(0u, allocator.Allocate(100, 1, 1));
+  EXPECT_EQ(100u, allocator.Allocate(100, 1, 2));
+  allocator.ReleaseFrame(1);
+  EXPECT_EQ(100u, allocator.bytes_in_use());
+
+  // Doesn't fit at the end, so wraps around to the space of frame 1.
+  EXPECT_EQ(0u, allocator.Allocate(80, 1, 3));
+  EXPECT_EQ(kInvalid, allocator.Allocate(30, 1, 3));
+  EXPECT_EQ(80u, allocator.Allocate(20, 1, 3));
+  EXPECT_EQ(256u, allocator.bytes_in_use());
+
+  // The end of the ring, skipped by frame 3, is reclaimed along with frame 3.
+  allocator.ReleaseFrame(2);
+  EXPECT_EQ(156u, allocator.bytes_in_use());
+  EXPECT_EQ(kInvalid, allocator.Allocate(101, 1, 4));
+  EXPECT_EQ(100u, allocator.Allocate(100, 1, 4));
+  allocator.ReleaseFrame(3);
+  EXPECT_EQ(100u, allocator.bytes_in_use());
+}
+
+TEST(RingAllocator, FramesAreReclaimedInOrder) {
+  RingAllocator allocator(300);
+  EXPECT_EQ(0u, allocator.Allocate(100, 1, 1));
+  EXPECT_EQ(100u, allocator.Allocate(100, 1, 2));
+  EXPECT_EQ(200u, allocator.Allocate(100, 1, 3));
+
+  // Frame 2 can't be reclaimed while frame 1 is still in use.
+  allocator.ReleaseFrame(2);
+  EXPECT_EQ(300u, allocator.bytes_in_use());
+  EXPECT_EQ(kInvalid, allocator.Allocate(1, 1, 4));
+
+  allocator.ReleaseFrame(1);
+  EXPECT_EQ(100u, allocator.bytes_in_use());
+  EXPECT_EQ(0u, allocator.Allocate(200, 1, 4));
+
+  // Releasing every frame starts over at the beginning.
+  allocator.ReleaseFrame(3);
+  allocator.ReleaseFrame(4);
+  EXPECT_EQ(0u, allocator.bytes_in_use());
+  EXPECT_EQ(0u, allocator.Allocate(300, 1, 5));
+}
+
+}  // namespace
@@ -0,0 +1,146 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "lib/escher/vk/impl/persistent_pipeline_cache.h"
+
+#include <cstring>
+
+#include "garnet/public/lib/escher/test/gtest_escher.h"
+#include "gtest/gtest.h"
+#include "lib/fxl/files/file.h"
+#include "lib/fxl/files/path.h"
+#include "lib/fxl/files/scoped_temp_dir.h"
+
+namespace escher {
+namespace impl {
+namespace {
+
+vk::PhysicalDeviceProperties MakeProperties() {
+  vk::PhysicalDeviceProperties properties;
+  properties.vendorID = 0x8086;
+  properties.deviceID = 0x5916;
+  properties.driverVersion = 7;
+  for (uint32_t i = 0; i < VK_UUID_SIZE; ++i) {
+    properties.pipelineCacheUUID[i] = static_cast<uint8_t>(i);
+  }
+  return properties;
+}
+
+// Return data with a VK_PIPELINE_CACHE_HEADER_VERSION_ONE header, as returned
+// by vkGetPipelineCacheData(), followed by some driver-specific bytes.
+std::vector<uint8_t> MakeCacheData(
+    const vk::PhysicalDeviceProperties& properties) {
+  uint32_t header[4] = {16 + VK_UUID_SIZE, VK_PIPELINE_CACHE_HEADER_VERSION_ONE,
+                        properties.vendorID, properties.deviceID};
+  std::vector<uint8_t> data(sizeof(header) + VK_UUID_SIZE + 8, 0xab);
+  memcpy(data.data(), header, sizeof(header));
+  memcpy(data.data() + sizeof(header), properties.pipelineCacheUUID,
+         VK_UUID_SIZE);
+  return data;
+}
+
+TEST(PersistentPipelineCache, EncodeAndDecode) {
+  auto properties = MakeProperties();
+  auto data = MakeCacheData(properties);
+
+  std::vector<uint8_t> decoded;
+  EXPECT_TRUE(PersistentPipelineCache::DecodeFile(
+      PersistentPipelineCache::EncodeFile(data, properties), properties,
+      &decoded));
+  EXPECT_EQ(data, decoded);
+}
+
+TEST(PersistentPipelineCache, RejectsOtherDevicesAndDrivers) {
+  auto properties = MakeProperties();
+  auto contents = PersistentPipelineCache::EncodeFile(MakeCacheData(properties),
+                                                      properties);
+  std::vector<uint8_t> decoded;
+
+  auto other = properties;
+  other.driverVersion++;
+  EXPECT_FALSE(PersistentPipelineCache::DecodeFile(contents, other, &decoded));
+
+  other = properties;
+  other.vendorID++;
+  EXPECT_FALSE(PersistentPipelineCache::DecodeFile(contents, other, &decoded));
+
+  other = properties;
+  other.deviceID++;
+  EXPECT_FALSE(PersistentPipelineCache::DecodeFile(contents, other, &decoded));
+
+  other = properties;
+  other.pipelineCacheUUID[3]++;
+  EXPECT_FALSE(PersistentPipelineCache::DecodeFile(contents, other, &decoded));
+
+  EXPECT_TRUE(decoded.empty());
+}
+
+TEST(PersistentPipelineCache, RejectsCorruptFiles) {
+  auto properties = MakeProperties();
+  auto contents = PersistentPipelineCache::EncodeFile(MakeCacheData(properties),
+                                                      properties);
+  std::vector<uint8_t> decoded;
+
+  EXPECT_FALSE(PersistentPipelineCache::DecodeFile("", properties, &decoded));
+  EXPECT_FALSE(PersistentPipelineCache::DecodeFile(
+      contents.substr(0, contents.size() - 1), properties, &decoded));
+
+  auto corrupted = contents;
+  corrupted[corrupted.size() - 1] ^= 1;
+  EXPECT_FALSE(
+      PersistentPipelineCache::DecodeFile(corrupted, properties, &decoded));
+
+  // Data too short to hold a Vulkan pipeline cache header.
+  EXPECT_FALSE(PersistentPipelineCache::DecodeFile(
+      PersistentPipelineCache::EncodeFile({1, 2, 3}, properties), properties,
+      &decoded));
+
+  EXPECT_TRUE(decoded.empty());
+}
+
+// Tests that MaybeSave() waits for pipeline creation to settle, so that the
+// file isn't rewritten on every frame.
+VK_TEST(PersistentPipelineCache, DebouncesSaves) {
+  auto escher = test::GetEscher();
+  files::ScopedTempDir temp_dir;
+  std::string path = temp_dir.path() + "/pipeline_cache";
+
+  PersistentPipelineCache cache(escher->vk_device(),
+                                escher->vk_physical_device().getProperties(),
+                                path);
+  EXPECT_FALSE(cache.loaded_from_file());
+  EXPECT_FALSE(cache.dirty());
+
+  auto start = fxl::TimePoint::Now();
+  const auto delay = PersistentPipelineCache::kSaveDelay;
+  EXPECT_TRUE(cache.MaybeSave(start));
+  EXPECT_FALSE(files::IsFile(path));
+
+  cache.MarkDirty();
+  EXPECT_TRUE(cache.MaybeSave(start));
+  EXPECT_TRUE(cache.MaybeSave(start + delay / 2));
+  EXPECT_FALSE(files::IsFile(path));
+
+  // More pipelines restart the wait.
+  cache.MarkDirty();
+  EXPECT_TRUE(cache.MaybeSave(start + delay));
+  EXPECT_TRUE(cache.MaybeSave(start + delay * 3 / 2));
+  EXPECT_FALSE(files::IsFile(path));
+  EXPECT_TRUE(cache.dirty());
+
+  EXPECT_TRUE(cache.MaybeSave(start + delay * 2));
+  EXPECT_TRUE(files::IsFile(path));
+  EXPECT_FALSE(cache.dirty());
+
+  // SaveIfDirty() doesn't wait.
+  ASSERT_TRUE(files::DeletePath(path, false));
+  cache.MarkDirty();
+  EXPECT_TRUE(cache.SaveIfDirty());
+  EXPECT_TRUE(files::IsFile(path));
+  EXPECT_FALSE(cache.dirty());
+}
+
+}  // namespace
+}  // namespace impl
+}  // namespace escher
@@ -6,6 +6,7 @@
 #define LIB_ESCHER_UTIL_HASHER_H_
 
 #include <cstdint>
+#include <cstring>
 
 #include "lib/escher/util/hash.h"
 #include "lib/escher/util/hash_fnv_1a.h"
@@ -38,6 +39,18 @@ class Hasher {
     }
   }
 
+  // Hash |size| bytes, 8 at a time.  Much faster than data() for large,
+  // unaligned buffers such as image pixels.
+  inline void bytes(const void* ptr, size_t size) {
+    auto bytes = static_cast<const uint8_t*>(ptr);
+    uint64_t word;
+    for (; size >= sizeof(word); size -= sizeof(word), bytes += sizeof(word)) {
+      std::memcpy(&word, bytes, sizeof(word));
+      data(&word, 1);
+    }
+    data(bytes, size);
+  }
+
   // Treat the structure as if it were an array of uint32_t.  Caller must be
   // careful not to have any padding bits.  The current implementation is
   // limited to structure that are multiples of 4 bytes, because that's what
@@ -8,6 +8,7 @@
 
 #include "lib/escher/impl/gpu_uploader.h"
 #include "lib/escher/impl/vulkan_utils.h"
+#include "lib/escher/renderer/batch_gpu_uploader.h"
 #include "lib/escher/vk/gpu_mem.h"
 #include "lib/escher/vk/image_factory.h"
 
@@ -197,6 +198,39 @@ void WritePixelsToImage(impl::GpuUploader* gpu_uploader, uint8_t* pixels,
   writer.Submit();
 }
 
+void WritePixelsToImage(BatchGpuUploader* batch_gpu_uploader,
+                        uint8_t* pixels, ImagePtr image,
+                        const ImageConversionFunction& conversion_func) {
+  FXL_DCHECK(batch_gpu_uploader);
+  FXL_DCHECK(image);
+  FXL_DCHECK(pixels);
+
+  size_t bytes_per_pixel = BytesPerPixel(image->info().format);
+  size_t width = image->info().width;
+  size_t height = image->info().height;
+
+  auto writer =
+      batch_gpu_uploader->AcquireWriter(width * height * bytes_per_pixel);
+  if (!conversion_func) {
+    std::memcpy(writer->host_ptr(), pixels, width * height * bytes_per_pixel);
+  } else {
+    conversion_func(writer->host_ptr(), pixels, width, height);
+  }
+
+  vk::BufferImageCopy region;
+  region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+  region.imageSubresource.mipLevel = 0;
+  region.imageSubresource.baseArrayLayer = 0;
+  region.imageSubresource.layerCount = 1;
+  region.imageExtent.width = width;
+  region.imageExtent.height = height;
+  region.imageExtent.depth = 1;
+  region.bufferOffset = 0;
+
+  writer->WriteImage(image, region, Semaphore::New(image->vk_device()));
+  batch_gpu_uploader->PostWriter(std::move(writer));
+}
+
 ImagePtr NewRgbaImage(ImageFactory* image_factory,
                       impl::GpuUploader* gpu_uploader, uint32_t width,
                       uint32_t height, uint8_t* pixels) {
@@ -92,6 +92,13 @@ void WritePixelsToImage(impl::GpuUploader* gpu_uploader, uint8_t* pixels,
                         const escher::image_utils::ImageConversionFunction&
                             convertion_func = nullptr);
 
+// Same as above, except that the copy is batched with the other uploads of
+// |batch_gpu_uploader|, and is submitted along with them.
+void WritePixelsToImage(BatchGpuUploader* batch_gpu_uploader,
+                        uint8_t* pixels, ImagePtr gpu_image,
+                        const escher::image_utils::ImageConversionFunction&
+                            convertion_func = nullptr);
+
 // Return new Image containing the provided pixels.  Uses transfer queue to
 // efficiently transfer image data to GPU.  If bytes is null, don't bother
 // transferring.
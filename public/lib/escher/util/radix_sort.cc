@@ -0,0 +1,89 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "lib/escher/util/radix_sort.h"
+
+#include <limits>
+#include <utility>
+
+#include "lib/fxl/logging.h"
+
+namespace escher {
+
+namespace {
+
+constexpr uint32_t kDigitBits = 8;
+constexpr uint32_t kBucketCount = 1U << kDigitBits;
+constexpr uint32_t kDigitMask = kBucketCount - 1;
+constexpr uint32_t kDigitCount = 64 / kDigitBits;
+
+}  // anonymous namespace
+
+void RadixSorter::Sort(std::vector<uint64_t>* keys,
+                       std::vector<uint32_t>* order) {
+  FXL_DCHECK(keys);
+  FXL_DCHECK(order);
+  FXL_DCHECK(keys->size() <= std::numeric_limits<uint32_t>::max());
+
+  const size_t count = keys->size();
+  order->resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    (*order)[i] = static_cast<uint32_t>(i);
+  }
+  if (count < 2) {
+    return;
+  }
+
+  // Build the histograms of all digits in a single pass over the keys.
+  uint32_t histograms[kDigitCount][kBucketCount] = {};
+  for (uint64_t key : *keys) {
+    for (uint32_t digit = 0; digit < kDigitCount; ++digit) {
+      ++histograms[digit][(key >> (digit * kDigitBits)) & kDigitMask];
+    }
+  }
+
+  key_scratch_.resize(count);
+  order_scratch_.resize(count);
+  uint64_t* src_keys = keys->data();
+  uint32_t* src_order = order->data();
+  uint64_t* dst_keys = key_scratch_.data();
+  uint32_t* dst_order = order_scratch_.data();
+
+  for (uint32_t digit = 0; digit < kDigitCount; ++digit) {
+    const uint32_t shift = digit * kDigitBits;
+    uint32_t* offsets = histograms[digit];
+
+    // If every key has the same value for this digit, the pass would leave
+    // the keys in the same order.
+    if (offsets[(src_keys[0] >> shift) & kDigitMask] == count) {
+      continue;
+    }
+
+    // Turn the histogram into the index at which each bucket starts.
+    uint32_t offset = 0;
+    for (uint32_t bucket = 0; bucket < kBucketCount; ++bucket) {
+      uint32_t bucket_size = offsets[bucket];
+      offsets[bucket] = offset;
+      offset += bucket_size;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      const uint64_t key = src_keys[i];
+      const uint32_t index = offsets[(key >> shift) & kDigitMask]++;
+      dst_keys[index] = key;
+      dst_order[index] = src_order[i];
+    }
+
+    std::swap(src_keys, dst_keys);
+    std::swap(src_order, dst_order);
+  }
+
+  // After an odd number of passes, the results are in the scratch arrays.
+  if (src_keys != keys->data()) {
+    keys->swap(key_scratch_);
+    order->swap(order_scratch_);
+  }
+}
+
+}  // namespace escher
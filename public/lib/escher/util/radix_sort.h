@@ -0,0 +1,53 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LIB_ESCHER_UTIL_RADIX_SORT_H_
+#define LIB_ESCHER_UTIL_RADIX_SORT_H_
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace escher {
+
+// Stably sorts 64-bit keys with a least-significant-digit radix sort, which
+// takes linear time instead of the O(n log n) comparisons of std::stable_sort.
+// The keys are sorted together with an array of their original indices, which
+// clients use to reorder their own data once the sort is complete; keeping the
+// keys and indices in separate arrays means that each pass only moves 12 bytes
+// per item, regardless of the size of the items themselves.
+//
+// Digits that are the same in every key are skipped, so sorting keys that
+// only use their low bits is proportionally cheaper.
+//
+// RadixSorter keeps its scratch memory between calls, so that sorting every
+// frame doesn't allocate once the sorter has warmed up.
+class RadixSorter {
+ public:
+  RadixSorter() = default;
+
+  // Sort |keys| in ascending order.  Upon return, |order| contains the original
+  // index of each key: the i-th key was originally at index |order[i]|.  Keys
+  // that are equal retain their relative order.
+  void Sort(std::vector<uint64_t>* keys, std::vector<uint32_t>* order);
+
+ private:
+  std::vector<uint64_t> key_scratch_;
+  std::vector<uint32_t> order_scratch_;
+};
+
+// Return the bits of |value|, transformed so that comparing them as unsigned
+// integers gives the same result as comparing the floats (for non-NaN values).
+// This allows depths to be packed into radix-sortable keys.
+inline uint32_t FloatToSortableBits(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  // Negative values are ordered backward, so flip all of their bits.  Flipping
+  // the sign bit of positive values moves them above the negative ones.
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+}  // namespace escher
+
+#endif  // LIB_ESCHER_UTIL_RADIX_SORT_H_
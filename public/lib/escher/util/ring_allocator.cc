@@ -0,0 +1,71 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "lib/escher/util/ring_allocator.h"
+
+#include "lib/escher/util/align.h"
+#include "lib/fxl/logging.h"
+
+namespace escher {
+
+RingAllocator::RingAllocator(size_t capacity) : capacity_(capacity) {
+  FXL_DCHECK(capacity_ > 0);
+}
+
+size_t RingAllocator::Allocate(size_t size, size_t alignment,
+                               uint64_t frame_number) {
+  FXL_DCHECK(size > 0);
+  if (size > capacity_) {
+    return kInvalidOffset;
+  }
+
+  size_t offset = AlignedToNext(head_, alignment);
+  if (frames_.empty() || head_ > tail_) {
+    // The free space is [head_, capacity_) followed by [0, tail_).
+    if (offset + size > capacity_) {
+      offset = 0;
+      if (!frames_.empty() && size > tail_) {
+        return kInvalidOffset;
+      }
+    }
+  } else if (offset + size > tail_) {
+    // The free space is [head_, tail_).
+    return kInvalidOffset;
+  }
+
+  head_ = offset + size;
+  if (!frames_.empty() && frames_.back().frame_number == frame_number) {
+    FXL_DCHECK(!frames_.back().released);
+    frames_.back().end = head_;
+  } else {
+    frames_.push_back({frame_number, head_, false});
+  }
+  return offset;
+}
+
+void RingAllocator::ReleaseFrame(uint64_t frame_number) {
+  for (auto& frame : frames_) {
+    if (frame.frame_number == frame_number) {
+      frame.released = true;
+    }
+  }
+  while (!frames_.empty() && frames_.front().released) {
+    tail_ = frames_.front().end;
+    frames_.pop_front();
+  }
+  if (frames_.empty()) {
+    // Start over at the beginning, where the most contiguous space is.
+    head_ = 0;
+    tail_ = 0;
+  }
+}
+
+size_t RingAllocator::bytes_in_use() const {
+  if (frames_.empty()) {
+    return 0;
+  }
+  return head_ > tail_ ? head_ - tail_ : capacity_ - tail_ + head_;
+}
+
+}  // namespace escher
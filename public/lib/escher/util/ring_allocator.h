@@ -0,0 +1,63 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LIB_ESCHER_UTIL_RING_ALLOCATOR_H_
+#define LIB_ESCHER_UTIL_RING_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+
+#include "lib/fxl/macros.h"
+
+namespace escher {
+
+// A RingAllocator hands out offsets into a circular region of |capacity|
+// bytes.  Each allocation is tagged with the number of the frame that uses it,
+// and allocations are freed a frame at a time.  Space is reclaimed in the
+// order that frames first allocated it, so the free space is always a single
+// range (which may wrap around the end of the region).  RingAllocator only
+// does the bookkeeping; the memory itself is owned by the caller.
+class RingAllocator {
+ public:
+  static constexpr size_t kInvalidOffset = std::numeric_limits<size_t>::max();
+
+  explicit RingAllocator(size_t capacity);
+
+  // Returns the offset of |size| contiguous bytes aligned to |alignment|, or
+  // kInvalidOffset if there is not enough contiguous free space.
+  size_t Allocate(size_t size, size_t alignment, uint64_t frame_number);
+
+  // Frees all allocations of |frame_number|.  Their space becomes available
+  // once every frame that allocated before them has been released too.
+  void ReleaseFrame(uint64_t frame_number);
+
+  size_t capacity() const { return capacity_; }
+
+  // Bytes that are allocated or waiting to be reclaimed, including alignment
+  // padding.
+  size_t bytes_in_use() const;
+
+ private:
+  struct FrameRange {
+    uint64_t frame_number;
+    // Offset just past the frame's last allocation.
+    size_t end;
+    bool released;
+  };
+
+  const size_t capacity_;
+  // Allocations start at |head_|, and the oldest unreclaimed frame starts at
+  // |tail_|.  Both are zero when |frames_| is empty.
+  size_t head_ = 0;
+  size_t tail_ = 0;
+  std::deque<FrameRange> frames_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(RingAllocator);
+};
+
+}  // namespace escher
+
+#endif  // LIB_ESCHER_UTIL_RING_ALLOCATOR_H_
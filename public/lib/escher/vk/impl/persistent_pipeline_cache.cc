@@ -0,0 +1,198 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "lib/escher/vk/impl/persistent_pipeline_cache.h"
+
+#include <cstring>
+
+#include "lib/escher/impl/vulkan_utils.h"
+#include "lib/escher/util/hasher.h"
+#include "lib/escher/util/trace_macros.h"
+#include "lib/fxl/files/file.h"
+#include "lib/fxl/files/path.h"
+#include "lib/fxl/logging.h"
+
+namespace escher {
+namespace impl {
+
+namespace {
+
+constexpr uint32_t kFileMagic = 0x43505345;  // "ESPC"
+constexpr uint32_t kFileVersion = 1;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  // Vulkan requires drivers to change |pipelineCacheUUID| whenever their cache
+  // format changes, but not all of them do; also reject data from a different
+  // driver version.
+  uint32_t driver_version;
+  uint32_t data_size;
+  uint64_t checksum;
+};
+
+// The layout of VK_PIPELINE_CACHE_HEADER_VERSION_ONE, which the Vulkan spec
+// requires at the start of all pipeline cache data.
+struct VulkanCacheHeader {
+  uint32_t header_size;
+  uint32_t header_version;
+  uint32_t vendor_id;
+  uint32_t device_id;
+  uint8_t pipeline_cache_uuid[VK_UUID_SIZE];
+};
+
+uint64_t ComputeChecksum(const uint8_t* data, size_t size) {
+  Hasher h;
+  h.u32(static_cast<uint32_t>(size));
+  h.data(data, size);
+  return h.value().val;
+}
+
+}  // anonymous namespace
+
+constexpr fxl::TimeDelta PersistentPipelineCache::kSaveDelay;
+
+PersistentPipelineCache::PersistentPipelineCache(
+    vk::Device device, const vk::PhysicalDeviceProperties& properties,
+    std::string path)
+    : device_(device),
+      properties_(properties),
+      path_(std::move(path)),
+      generation_(0) {
+  TRACE_DURATION("gfx", "escher::PersistentPipelineCache::Load");
+
+  std::string contents;
+  std::vector<uint8_t> data;
+  if (files::ReadFileToString(path_, &contents)) {
+    if (DecodeFile(contents, properties_, &data)) {
+      loaded_from_file_ = true;
+    } else {
+      FXL_LOG(WARNING) << "PersistentPipelineCache: ignoring incompatible "
+                       << "cache file " << path_;
+    }
+  }
+
+  vk::PipelineCacheCreateInfo info;
+  info.initialDataSize = data.size();
+  info.pInitialData = data.empty() ? nullptr : data.data();
+  auto result = device_.createPipelineCache(info);
+  if (result.result != vk::Result::eSuccess && loaded_from_file_) {
+    // The driver rejected the data despite its header; start afresh.
+    FXL_LOG(WARNING) << "PersistentPipelineCache: driver rejected " << path_;
+    loaded_from_file_ = false;
+    info.initialDataSize = 0;
+    info.pInitialData = nullptr;
+    result = device_.createPipelineCache(info);
+  }
+  cache_ = ESCHER_CHECKED_VK_RESULT(result);
+}
+
+PersistentPipelineCache::~PersistentPipelineCache() {
+  SaveIfDirty();
+  device_.destroyPipelineCache(cache_);
+}
+
+bool PersistentPipelineCache::MaybeSave(fxl::TimePoint now) {
+  uint64_t generation = generation_;
+  if (generation == saved_generation_) {
+    return true;
+  }
+  if (generation != pending_generation_) {
+    // New pipelines were added since the last call; wait for them to settle.
+    pending_generation_ = generation;
+    pending_since_ = now;
+    return true;
+  }
+  if (now - pending_since_ < kSaveDelay) {
+    return true;
+  }
+  return SaveIfDirty();
+}
+
+bool PersistentPipelineCache::SaveIfDirty() {
+  uint64_t generation = generation_;
+  if (generation == saved_generation_) {
+    return true;
+  }
+  // Pipelines added while saving are picked up by the next save.
+  saved_generation_ = generation;
+  TRACE_DURATION("gfx", "escher::PersistentPipelineCache::SaveIfDirty");
+
+  auto result = device_.getPipelineCacheData(cache_);
+  if (result.result != vk::Result::eSuccess) {
+    FXL_LOG(WARNING) << "PersistentPipelineCache: failed to get cache data.";
+    return false;
+  }
+
+  std::string contents = EncodeFile(result.value, properties_);
+  if (!files::WriteFileInTwoPhases(path_, contents,
+                                   files::GetDirectoryName(path_))) {
+    FXL_LOG(WARNING) << "PersistentPipelineCache: failed to write " << path_;
+    return false;
+  }
+  return true;
+}
+
+std::string PersistentPipelineCache::EncodeFile(
+    const std::vector<uint8_t>& data,
+    const vk::PhysicalDeviceProperties& properties) {
+  FileHeader header = {};
+  header.magic = kFileMagic;
+  header.version = kFileVersion;
+  header.driver_version = properties.driverVersion;
+  header.data_size = static_cast<uint32_t>(data.size());
+  header.checksum = ComputeChecksum(data.data(), data.size());
+
+  std::string contents(sizeof(header) + data.size(), '\0');
+  memcpy(&contents[0], &header, sizeof(header));
+  if (!data.empty()) {
+    memcpy(&contents[sizeof(header)], data.data(), data.size());
+  }
+  return contents;
+}
+
+bool PersistentPipelineCache::DecodeFile(
+    const std::string& contents,
+    const vk::PhysicalDeviceProperties& properties,
+    std::vector<uint8_t>* data_out) {
+  FXL_DCHECK(data_out);
+
+  FileHeader header;
+  if (contents.size() < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, contents.data(), sizeof(header));
+  if (header.magic != kFileMagic || header.version != kFileVersion ||
+      header.driver_version != properties.driverVersion ||
+      header.data_size != contents.size() - sizeof(header)) {
+    return false;
+  }
+
+  auto data = reinterpret_cast<const uint8_t*>(contents.data()) +
+              sizeof(header);
+  if (ComputeChecksum(data, header.data_size) != header.checksum) {
+    return false;
+  }
+
+  VulkanCacheHeader vk_header;
+  if (header.data_size < sizeof(vk_header)) {
+    return false;
+  }
+  memcpy(&vk_header, data, sizeof(vk_header));
+  if (vk_header.header_size < sizeof(vk_header) ||
+      vk_header.header_size > header.data_size ||
+      vk_header.header_version != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+      vk_header.vendor_id != properties.vendorID ||
+      vk_header.device_id != properties.deviceID ||
+      memcmp(vk_header.pipeline_cache_uuid, properties.pipelineCacheUUID,
+             VK_UUID_SIZE) != 0) {
+    return false;
+  }
+
+  data_out->assign(data, data + header.data_size);
+  return true;
+}
+
+}  // namespace impl
+}  // namespace escher
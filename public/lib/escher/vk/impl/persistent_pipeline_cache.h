@@ -0,0 +1,89 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LIB_ESCHER_VK_IMPL_PERSISTENT_PIPELINE_CACHE_H_
+#define LIB_ESCHER_VK_IMPL_PERSISTENT_PIPELINE_CACHE_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_point.h"
+
+namespace escher {
+namespace impl {
+
+// Wraps a vk::PipelineCache whose contents are saved to a file, so that
+// pipelines built by one process can be reused by the next instead of being
+// recreated from scratch.  Cache data is only loaded if it was saved by the
+// same driver for the same device; anything else is ignored, and the cache
+// starts out empty.
+class PersistentPipelineCache {
+ public:
+  // How long the cache must go without new pipelines before MaybeSave() writes
+  // it out, so that a burst of pipeline creation is saved once.
+  static constexpr fxl::TimeDelta kSaveDelay = fxl::TimeDelta::FromSeconds(5);
+
+  PersistentPipelineCache(vk::Device device,
+                          const vk::PhysicalDeviceProperties& properties,
+                          std::string path);
+  // Saves the cache if it has changed.
+  ~PersistentPipelineCache();
+
+  vk::PipelineCache vk() const { return cache_; }
+
+  // Called after pipelines have been created using vk(), so that they are
+  // written out by a later MaybeSave() or SaveIfDirty().
+  void MarkDirty() { ++generation_; }
+
+  // Called once per frame.  Write the cache contents to the file once
+  // MarkDirty() has not been called for |kSaveDelay|, as of |now|.  Return
+  // false if the cache couldn't be written.
+  bool MaybeSave(fxl::TimePoint now = fxl::TimePoint::Now());
+
+  // Write the cache contents to the file if MarkDirty() was called since the
+  // last save.  Return false if the cache couldn't be written.
+  bool SaveIfDirty();
+
+  // Return true if MarkDirty() was called since the last save.
+  bool dirty() const { return generation_ != saved_generation_; }
+
+  // Return true if the cache was seeded with data from the file.
+  bool loaded_from_file() const { return loaded_from_file_; }
+
+  // Wrap the data obtained from vkGetPipelineCacheData() with a header that
+  // allows DecodeFile() to validate it.
+  static std::string EncodeFile(const std::vector<uint8_t>& data,
+                                const vk::PhysicalDeviceProperties& properties);
+
+  // Return true and fill in |data_out| if |contents| was produced by
+  // EncodeFile() with properties compatible with |properties|, and the Vulkan
+  // header of the data matches the device.
+  static bool DecodeFile(const std::string& contents,
+                         const vk::PhysicalDeviceProperties& properties,
+                         std::vector<uint8_t>* data_out);
+
+ private:
+  const vk::Device device_;
+  const vk::PhysicalDeviceProperties properties_;
+  const std::string path_;
+  vk::PipelineCache cache_;
+  // Incremented by MarkDirty(), which may be called from any thread.
+  std::atomic<uint64_t> generation_;
+  uint64_t saved_generation_ = 0;
+  // The generation that MaybeSave() last observed, and when it did so.
+  uint64_t pending_generation_ = 0;
+  fxl::TimePoint pending_since_;
+  bool loaded_from_file_ = false;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(PersistentPipelineCache);
+};
+
+}  // namespace impl
+}  // namespace escher
+
+#endif  // LIB_ESCHER_VK_IMPL_PERSISTENT_PIPELINE_CACHE_H_
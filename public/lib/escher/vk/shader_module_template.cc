@@ -4,7 +4,9 @@
 
 #include "lib/escher/vk/shader_module_template.h"
 
+#include "lib/escher/impl/spirv_cache.h"
 #include "lib/escher/util/hasher.h"
+#include "lib/escher/util/trace_macros.h"
 #include "third_party/shaderc/libshaderc/include/shaderc/shaderc.hpp"
 
 namespace escher {
@@ -97,12 +99,14 @@ ShaderModuleTemplate::ShaderModuleTemplate(vk::Device device,
                                            shaderc::Compiler* compiler,
                                            ShaderStage shader_stage,
                                            HackFilePath path,
-                                           HackFilesystemPtr filesystem)
+                                           HackFilesystemPtr filesystem,
+                                           impl::SpirvCache* spirv_cache)
     : device_(device),
       compiler_(compiler),
       shader_stage_(shader_stage),
       path_(std::move(path)),
-      filesystem_(std::move(filesystem)) {}
+      filesystem_(std::move(filesystem)),
+      spirv_cache_(spirv_cache) {}
 
 ShaderModuleTemplate::~ShaderModuleTemplate() { FXL_DCHECK(variants_.empty()); }
 
@@ -169,6 +173,8 @@ void ShaderModuleTemplate::Variant::ScheduleCompilation() {
 }
 
 void ShaderModuleTemplate::Variant::Compile() {
+  TRACE_DURATION("gfx", "escher::ShaderModuleTemplate::Variant::Compile");
+
   // Clear watcher paths; we'll gather new ones during compilation.
   filesystem_watcher_->ClearPaths();
 
@@ -187,13 +193,37 @@ void ShaderModuleTemplate::Variant::Compile() {
   // Compile GLSL to SPIR-V, keeping track of paths as we go.
   auto main_file = filesystem_watcher_->ReadFile(template_->path_);
 
+  // Preprocessing is cheap compared to compilation, and it resolves all of the
+  // #includes, so the preprocessed source identifies the variant's SPIR-V.
+  impl::SpirvCache* const spirv_cache = template_->spirv_cache_;
+  Hash cache_key = {};
+  if (spirv_cache) {
+    auto preprocessed = template_->compiler_->PreprocessGlsl(
+        main_file.data(), main_file.size(), ShaderStageToKind(shader_stage()),
+        template_->path_.c_str(), options);
+    if (preprocessed.GetCompilationStatus() ==
+        shaderc_compilation_status_success) {
+      cache_key = impl::SpirvCache::KeyForShaderVariant(
+          shader_stage(), {preprocessed.cbegin(), preprocessed.cend()}, args_);
+      impl::SpirvData spirv;
+      if (spirv_cache->Load(cache_key, &spirv)) {
+        RecreateModuleFromSpirvAndNotifyListeners(std::move(spirv));
+        return;
+      }
+    }
+  }
+
   auto result = template_->compiler_->CompileGlslToSpv(
       main_file.data(), main_file.size(), ShaderStageToKind(shader_stage()),
       template_->path_.c_str(), "main", options);
 
   auto status = result.GetCompilationStatus();
   if (status == shaderc_compilation_status_success) {
-    RecreateModuleFromSpirvAndNotifyListeners({result.cbegin(), result.cend()});
+    impl::SpirvData spirv(result.cbegin(), result.cend());
+    if (cache_key.IsValid()) {
+      spirv_cache->Store(cache_key, spirv);
+    }
+    RecreateModuleFromSpirvAndNotifyListeners(std::move(spirv));
   } else {
     FXL_LOG(ERROR) << "Shader compilation failed with status: " << status
                    << " msg: " << result.GetErrorMessage();
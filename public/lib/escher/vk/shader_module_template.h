@@ -32,9 +32,12 @@ using ShaderModuleTemplatePtr = fxl::RefPtr<ShaderModuleTemplate>;
 class ShaderModuleTemplate
     : public fxl::RefCountedThreadSafe<ShaderModuleTemplate> {
  public:
+  // If |spirv_cache| is not null, variants are looked up in it before being
+  // compiled, and added to it afterward.  It must outlive the template.
   ShaderModuleTemplate(vk::Device device, shaderc::Compiler* compiler,
                        ShaderStage shader_stage, HackFilePath path,
-                       HackFilesystemPtr filesystem);
+                       HackFilesystemPtr filesystem,
+                       impl::SpirvCache* spirv_cache = nullptr);
 
   ~ShaderModuleTemplate();
 
@@ -98,6 +101,7 @@ class ShaderModuleTemplate
   ShaderStage shader_stage_;
   HackFilePath path_;
   HackFilesystemPtr filesystem_;
+  impl::SpirvCache* const spirv_cache_;
   HashMap<ShaderVariantArgs, Variant*> variants_;
 };
 
@@ -779,10 +779,12 @@ fuchsia::ui::gfx::Command NewSetTagCmd(uint32_t node_id, uint32_t tag_value) {
 }
 
 fuchsia::ui::gfx::Command NewTakeSnapshotCmdHACK(
-    uint32_t node_id, fuchsia::ui::gfx::SnapshotCallbackHACKPtr callback) {
+    uint32_t node_id, fuchsia::ui::gfx::SnapshotCallbackHACKPtr callback,
+    bool delta) {
   fuchsia::ui::gfx::TakeSnapshotCmdHACK snapshot_cmd;
   snapshot_cmd.node_id = node_id;
   snapshot_cmd.callback = std::move(callback);
+  snapshot_cmd.delta = delta;
 
   fuchsia::ui::gfx::Command command;
   command.set_take_snapshot_cmd(std::move(snapshot_cmd));
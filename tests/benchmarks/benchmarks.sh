@@ -29,6 +29,46 @@ runbench_exec "${OUT_DIR}/zircon_benchmarks.json" \
     /pkgfs/packages/zircon_benchmarks/0/test/zircon_benchmarks \
     -p --out="${OUT_DIR}/zircon_benchmarks.json"
 
+# Stroke fitting and tessellation of the sketchy service, on the CPU.
+runbench_exec "${OUT_DIR}/sketchy_benchmarks.json" \
+    /pkgfs/packages/sketchy_benchmarks/0/test/sketchy_benchmarks \
+    -p --out="${OUT_DIR}/sketchy_benchmarks.json"
+
+# Full and delta serialization of scene snapshots, on the CPU.
+runbench_exec "${OUT_DIR}/scenic_benchmarks.json" \
+    /pkgfs/packages/scenic_benchmarks/0/test/snapshot_benchmarks \
+    -p --out="${OUT_DIR}/scenic_benchmarks.json"
+
+# Per-frame uniform and descriptor set allocation in Escher, on the CPU.
+runbench_exec "${OUT_DIR}/escher_benchmarks.json" \
+    /pkgfs/packages/escher_benchmarks/0/test/frame_arena_benchmarks \
+    -p --out="${OUT_DIR}/escher_benchmarks.json"
+
+# Data structures and data paths of the Bluetooth host stack.
+runbench_exec "${OUT_DIR}/bluetooth_benchmarks.json" \
+    /pkgfs/packages/bluetooth_benchmarks/0/test/bt-host-benchmarks \
+    -p --out="${OUT_DIR}/bluetooth_benchmarks.json"
+
+# Packet loopback through the virtio-net device of the guest VMM.
+runbench_exec "${OUT_DIR}/machina_benchmarks.json" \
+    /pkgfs/packages/machina_benchmarks/0/test/machina_benchmarks \
+    -p --out="${OUT_DIR}/machina_benchmarks.json"
+
+# GPU address space allocators of magma.
+runbench_exec "${OUT_DIR}/magma_allocator_benchmarks.json" \
+    /pkgfs/packages/magma_allocator_benchmarks/0/test/magma_address_space_allocator_benchmarks \
+    -p --out="${OUT_DIR}/magma_allocator_benchmarks.json"
+
+# Beacon processing of the WLAN MLME.
+runbench_exec "${OUT_DIR}/wlan_mlme_benchmarks.json" \
+    /pkgfs/packages/wlan_mlme_benchmarks/0/test/wlan_mlme_benchmarks \
+    -p --out="${OUT_DIR}/wlan_mlme_benchmarks.json"
+
+# Routing of received responses to the agents of the mDNS service.
+runbench_exec "${OUT_DIR}/mdns_benchmarks.json" \
+    /pkgfs/packages/mdns_benchmarks/0/test/mdns_benchmarks \
+    -p --out="${OUT_DIR}/mdns_benchmarks.json"
+
 if `run vulkan_is_supported`; then
   # Run the gfx benchmarks in the current shell environment, because they write
   # to (hidden) global state used by runbench_finish.